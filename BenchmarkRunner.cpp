@@ -0,0 +1,409 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmarkrunner.cpp
+// ============
+// run repeatable offscreen benchmarks of the scene - camera path, results
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "BenchmarkRunner.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <string>
+
+// declaration of global variables and defines
+namespace
+{
+	// point in the scene the camera path circles around
+	const glm::vec3 g_PathCenter = glm::vec3(3.0f, 2.0f, 0.0f);
+	// distance of the camera path from the center
+	const float g_PathRadius = 14.0f;
+	// height of the camera path and how far it rises and falls
+	const float g_PathHeight = 6.0f;
+	const float g_PathHeightRange = 3.0f;
+}
+
+/***********************************************************
+ *  BenchmarkRunner()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+BenchmarkRunner::BenchmarkRunner(
+	SceneManager* pSceneManager,
+	ViewManager* pViewManager,
+	UniformCache* pUniformCache,
+	FrameProfiler* pFrameProfiler)
+{
+	m_pSceneManager = pSceneManager;
+	m_pViewManager = pViewManager;
+	m_pUniformCache = pUniformCache;
+	m_pFrameProfiler = pFrameProfiler;
+	m_framebuffer = 0;
+	m_colorBuffer = 0;
+	m_depthBuffer = 0;
+	m_width = 0;
+	m_height = 0;
+	m_frameCount = 0;
+	m_frameUniformUpdates = 0;
+}
+
+/***********************************************************
+ *  ~BenchmarkRunner()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+BenchmarkRunner::~BenchmarkRunner()
+{
+	DestroyFramebuffer();
+
+	m_pSceneManager = NULL;
+	m_pViewManager = NULL;
+	m_pUniformCache = NULL;
+	m_pFrameProfiler = NULL;
+}
+
+/***********************************************************
+ *  CreateFramebuffer()
+ *
+ *  This method is used for creating the offscreen frame
+ *  buffer that the benchmark frames are rendered into, so
+ *  the results do not depend on the window being visible.
+ ***********************************************************/
+bool BenchmarkRunner::CreateFramebuffer(int width, int height)
+{
+	DestroyFramebuffer();
+
+	glGenRenderbuffers(1, &m_colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+	glGenRenderbuffers(1, &m_depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (GL_FRAMEBUFFER_COMPLETE != status)
+	{
+		std::cout << "Benchmark frame buffer is not complete:" << status << std::endl;
+		DestroyFramebuffer();
+		return(false);
+	}
+
+	m_width = width;
+	m_height = height;
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyFramebuffer()
+ *
+ *  This method is used for freeing the offscreen frame
+ *  buffer and its attachments.
+ ***********************************************************/
+void BenchmarkRunner::DestroyFramebuffer()
+{
+	if (0 != m_framebuffer)
+	{
+		glDeleteFramebuffers(1, &m_framebuffer);
+		m_framebuffer = 0;
+	}
+	if (0 != m_colorBuffer)
+	{
+		glDeleteRenderbuffers(1, &m_colorBuffer);
+		m_colorBuffer = 0;
+	}
+	if (0 != m_depthBuffer)
+	{
+		glDeleteRenderbuffers(1, &m_depthBuffer);
+		m_depthBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  GetCameraPose()
+ *
+ *  This method is used for getting the camera pose at a
+ *  frame of the camera path.  The camera circles the scene
+ *  once over the run while rising and falling twice, always
+ *  looking at the center of the scene.  The pose depends
+ *  only on the frame number, never on the elapsed time, so
+ *  every run renders the same frames.
+ ***********************************************************/
+void BenchmarkRunner::GetCameraPose(int frame, int frameCount, glm::vec3& position, glm::vec3& front)
+{
+	float angle = 0.0f;
+
+	if (frameCount > 0)
+	{
+		angle = glm::radians(360.0f) * ((float)frame / (float)frameCount);
+	}
+
+	position = g_PathCenter + glm::vec3(
+		std::sin(angle) * g_PathRadius,
+		g_PathHeight + std::sin(angle * 2.0f) * g_PathHeightRange,
+		std::cos(angle) * g_PathRadius);
+	front = glm::normalize(g_PathCenter - position);
+}
+
+/***********************************************************
+ *  BeginRun()
+ *
+ *  This method is used for starting to record a run of the
+ *  passed in number of frames.  The GPU is drained first so
+ *  the work of the warm up frames is not timed.
+ ***********************************************************/
+void BenchmarkRunner::BeginRun(int frameCount)
+{
+	m_frameCount = frameCount;
+	m_samples.clear();
+	m_samples.reserve(frameCount);
+
+	glFinish();
+	m_lastFrameTime = std::chrono::steady_clock::now();
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for placing the camera at the pose of
+ *  the passed in frame and binding the offscreen frame
+ *  buffer before the frame is rendered.
+ ***********************************************************/
+void BenchmarkRunner::BeginFrame(int frame)
+{
+	glm::vec3 position;
+	glm::vec3 front;
+
+	GetCameraPose(frame, m_frameCount, position, front);
+	m_pViewManager->SetScriptedCamera(position, front);
+
+	if (0 != m_framebuffer)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+		glViewport(0, 0, m_width, m_height);
+	}
+
+	m_frameUniformUpdates = m_pUniformCache->GetUpdateCount();
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for recording the frame after it has
+ *  been rendered.  The frame time is the time between the
+ *  ends of two frames, so the time the driver blocks while
+ *  the GPU catches up is added to the frame that caused it.
+ ***********************************************************/
+void BenchmarkRunner::EndFrame()
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	const SceneManager::RENDER_STATISTICS& statistics = m_pSceneManager->GetRenderStatistics();
+	FRAME_SAMPLE sample;
+
+	sample.frameTime = std::chrono::duration<double, std::milli>(now - m_lastFrameTime).count();
+	sample.drawCalls = statistics.drawCalls;
+	sample.batches = statistics.batches;
+	sample.textureChanges = statistics.textureChanges;
+	sample.textureBinds = statistics.textureBinds;
+	sample.materialChanges = statistics.materialChanges;
+	sample.uniformUpdates = m_pUniformCache->GetUpdateCount() - m_frameUniformUpdates;
+	sample.culledObjects = statistics.culledObjects;
+	sample.detailCulledObjects = statistics.detailCulledObjects;
+	sample.indirectCommands = statistics.indirectCommands;
+	m_samples.push_back(sample);
+
+	m_lastFrameTime = now;
+
+	if (0 != m_framebuffer)
+	{
+		glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	}
+}
+
+/***********************************************************
+ *  WriteResults()
+ *
+ *  This method is used for writing the recorded frames to
+ *  <baseName>.csv and the summary to <baseName>.json.
+ ***********************************************************/
+bool BenchmarkRunner::WriteResults(const char* baseName) const
+{
+	std::string name = baseName;
+	bool bWritten = true;
+
+	if (m_samples.size() == 0)
+	{
+		std::cout << "No benchmark frames were recorded" << std::endl;
+		return(false);
+	}
+
+	bWritten = WriteFrameCSV((name + ".csv").c_str()) && bWritten;
+	bWritten = WriteSummaryJSON((name + ".json").c_str()) && bWritten;
+
+	return(bWritten);
+}
+
+/***********************************************************
+ *  WriteFrameCSV()
+ *
+ *  This method is used for writing one line per recorded
+ *  frame to a CSV file.
+ ***********************************************************/
+bool BenchmarkRunner::WriteFrameCSV(const char* filename) const
+{
+	FILE* file = fopen(filename, "w");
+
+	if (NULL == file)
+	{
+		std::cout << "Could not write benchmark file:" << filename << std::endl;
+		return(false);
+	}
+
+	fprintf(file, "frame,frame_ms,draw_calls,batches,texture_changes,texture_binds,material_changes,uniform_updates,culled_objects,detail_culled_objects,indirect_commands\n");
+	for (int i = 0; i < m_samples.size(); i++)
+	{
+		const FRAME_SAMPLE& sample = m_samples[i];
+		fprintf(file, "%d,%.4f,%d,%d,%d,%d,%d,%d,%d,%d,%d\n",
+			i,
+			sample.frameTime,
+			sample.drawCalls,
+			sample.batches,
+			sample.textureChanges,
+			sample.textureBinds,
+			sample.materialChanges,
+			sample.uniformUpdates,
+			sample.culledObjects,
+			sample.detailCulledObjects,
+			sample.indirectCommands);
+	}
+
+	fclose(file);
+	std::cout << "Wrote benchmark frames:" << filename << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  WriteSummaryJSON()
+ *
+ *  This method is used for writing the frame time summary,
+ *  the frame time histogram, the mean counts per frame and
+ *  the profiler scope statistics to a JSON file.
+ ***********************************************************/
+bool BenchmarkRunner::WriteSummaryJSON(const char* filename) const
+{
+	std::vector<double> frameTimes;
+	std::vector<FrameProfiler::SCOPE_STATISTICS> scopes;
+	int histogram[HISTOGRAM_BINS] = { 0 };
+	double totalTime = 0.0;
+	double drawCalls = 0.0;
+	double batches = 0.0;
+	double textureChanges = 0.0;
+	double textureBinds = 0.0;
+	double materialChanges = 0.0;
+	double uniformUpdates = 0.0;
+	double culledObjects = 0.0;
+	double detailCulledObjects = 0.0;
+	double indirectCommands = 0.0;
+
+	FILE* file = fopen(filename, "w");
+	if (NULL == file)
+	{
+		std::cout << "Could not write benchmark file:" << filename << std::endl;
+		return(false);
+	}
+
+	for (int i = 0; i < m_samples.size(); i++)
+	{
+		const FRAME_SAMPLE& sample = m_samples[i];
+		int bin = std::min((int)(sample.frameTime / HISTOGRAM_BIN_MS), HISTOGRAM_BINS - 1);
+
+		frameTimes.push_back(sample.frameTime);
+		totalTime += sample.frameTime;
+		histogram[bin]++;
+
+		drawCalls += sample.drawCalls;
+		batches += sample.batches;
+		textureChanges += sample.textureChanges;
+		textureBinds += sample.textureBinds;
+		materialChanges += sample.materialChanges;
+		uniformUpdates += sample.uniformUpdates;
+		culledObjects += sample.culledObjects;
+		detailCulledObjects += sample.detailCulledObjects;
+		indirectCommands += sample.indirectCommands;
+	}
+
+	double count = (double)m_samples.size();
+	std::sort(frameTimes.begin(), frameTimes.end());
+
+	fprintf(file, "{\n");
+	fprintf(file, "\t\"frames\": %d,\n", (int)m_samples.size());
+	fprintf(file, "\t\"width\": %d,\n", m_width);
+	fprintf(file, "\t\"height\": %d,\n", m_height);
+	fprintf(file, "\t\"frameTimeMs\": {\n");
+	fprintf(file, "\t\t\"mean\": %.4f,\n", totalTime / count);
+	fprintf(file, "\t\t\"min\": %.4f,\n", frameTimes.front());
+	fprintf(file, "\t\t\"p50\": %.4f,\n", frameTimes[(size_t)(0.50 * (count - 1))]);
+	fprintf(file, "\t\t\"p95\": %.4f,\n", frameTimes[(size_t)(0.95 * (count - 1))]);
+	fprintf(file, "\t\t\"p99\": %.4f,\n", frameTimes[(size_t)(0.99 * (count - 1))]);
+	fprintf(file, "\t\t\"max\": %.4f\n", frameTimes.back());
+	fprintf(file, "\t},\n");
+
+	fprintf(file, "\t\"histogram\": {\n");
+	fprintf(file, "\t\t\"binWidthMs\": %.2f,\n", HISTOGRAM_BIN_MS);
+	fprintf(file, "\t\t\"counts\": [");
+	for (int i = 0; i < HISTOGRAM_BINS; i++)
+	{
+		fprintf(file, "%s%d", (i > 0) ? ", " : "", histogram[i]);
+	}
+	fprintf(file, "]\n");
+	fprintf(file, "\t},\n");
+
+	fprintf(file, "\t\"perFrame\": {\n");
+	fprintf(file, "\t\t\"drawCalls\": %.2f,\n", drawCalls / count);
+	fprintf(file, "\t\t\"batches\": %.2f,\n", batches / count);
+	fprintf(file, "\t\t\"textureChanges\": %.2f,\n", textureChanges / count);
+	fprintf(file, "\t\t\"textureBinds\": %.2f,\n", textureBinds / count);
+	fprintf(file, "\t\t\"materialChanges\": %.2f,\n", materialChanges / count);
+	fprintf(file, "\t\t\"uniformUpdates\": %.2f,\n", uniformUpdates / count);
+	fprintf(file, "\t\t\"culledObjects\": %.2f,\n", culledObjects / count);
+	fprintf(file, "\t\t\"detailCulledObjects\": %.2f,\n", detailCulledObjects / count);
+	fprintf(file, "\t\t\"indirectCommands\": %.2f\n", indirectCommands / count);
+	fprintf(file, "\t},\n");
+
+	// the profiler scopes hold the CPU and GPU time of each phase
+	// over the last frames of the run
+	fprintf(file, "\t\"scopes\": [");
+	if (NULL != m_pFrameProfiler)
+	{
+		m_pFrameProfiler->GetStatistics(scopes);
+	}
+	for (int i = 0; i < scopes.size(); i++)
+	{
+		const FrameProfiler::SCOPE_STATISTICS& scope = scopes[i];
+		fprintf(file, "%s\n\t\t{ \"name\": \"%s\", \"cpuMean\": %.4f, \"cpuP95\": %.4f, \"cpuP99\": %.4f, \"gpuMean\": %.4f, \"gpuP95\": %.4f, \"gpuP99\": %.4f }",
+			(i > 0) ? "," : "",
+			scope.name.c_str(),
+			scope.cpuMean, scope.cpuP95, scope.cpuP99,
+			scope.gpuMean, scope.gpuP95, scope.gpuP99);
+	}
+	fprintf(file, "\n\t]\n");
+	fprintf(file, "}\n");
+
+	fclose(file);
+	std::cout << "Wrote benchmark summary:" << filename << std::endl;
+
+	return(true);
+}
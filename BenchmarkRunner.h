@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+// benchmarkrunner.h
+// ============
+// run repeatable offscreen benchmarks of the scene - camera path, results
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "UniformCache.h"
+#include "FrameProfiler.h"
+
+#include <chrono>
+#include <vector>
+
+/***********************************************************
+ *  BenchmarkRunner
+ *
+ *  This class renders the scene into an offscreen frame
+ *  buffer while moving the camera along a fixed path, so
+ *  every run renders exactly the same frames.  The frame
+ *  times, draw calls and state changes of every frame are
+ *  recorded and written to CSV and JSON files.
+ ***********************************************************/
+class BenchmarkRunner
+{
+public:
+	// constructor
+	BenchmarkRunner(
+		SceneManager* pSceneManager,
+		ViewManager* pViewManager,
+		UniformCache* pUniformCache,
+		FrameProfiler* pFrameProfiler);
+	// destructor
+	~BenchmarkRunner();
+
+	// the values recorded for one benchmark frame
+	struct FRAME_SAMPLE
+	{
+		double frameTime;
+		int drawCalls;
+		int batches;
+		int textureChanges;
+		int textureBinds;
+		int materialChanges;
+		int uniformUpdates;
+		int culledObjects;
+		int detailCulledObjects;
+		int indirectCommands;
+	};
+
+private:
+	// width of one frame time histogram bin, in milliseconds
+	static constexpr double HISTOGRAM_BIN_MS = 0.5;
+	// number of histogram bins, the last bin holds all slower frames
+	static const int HISTOGRAM_BINS = 100;
+
+	// pointer to the scene manager object
+	SceneManager* m_pSceneManager;
+	// pointer to the view manager object
+	ViewManager* m_pViewManager;
+	// pointer to cached shader uniform locations
+	UniformCache* m_pUniformCache;
+	// pointer to the frame profiler object
+	FrameProfiler* m_pFrameProfiler;
+	// offscreen frame buffer and its attachments
+	GLuint m_framebuffer;
+	GLuint m_colorBuffer;
+	GLuint m_depthBuffer;
+	int m_width;
+	int m_height;
+	// number of frames on the camera path
+	int m_frameCount;
+	// time the previous frame finished
+	std::chrono::steady_clock::time_point m_lastFrameTime;
+	// uniform update count when the current frame started
+	int m_frameUniformUpdates;
+	// recorded benchmark frames
+	std::vector<FRAME_SAMPLE> m_samples;
+
+	// write the recorded frames to a CSV file
+	bool WriteFrameCSV(const char* filename) const;
+	// write the summary and histogram to a JSON file
+	bool WriteSummaryJSON(const char* filename) const;
+
+public:
+	// create the offscreen frame buffer that is rendered into
+	bool CreateFramebuffer(int width, int height);
+	// free the offscreen frame buffer
+	void DestroyFramebuffer();
+
+	// get the camera pose at a frame of the camera path
+	static void GetCameraPose(int frame, int frameCount, glm::vec3& position, glm::vec3& front);
+
+	// start recording a run of the passed in number of frames
+	void BeginRun(int frameCount);
+	// place the camera and frame buffer before the frame is rendered
+	void BeginFrame(int frame);
+	// record the frame after it has been rendered
+	void EndFrame();
+
+	// write the recorded frames to <baseName>.csv and <baseName>.json
+	bool WriteResults(const char* baseName) const;
+};
@@ -0,0 +1,324 @@
+///////////////////////////////////////////////////////////////////////////////
+// dynamicbuffer.cpp
+// ============
+// persistently mapped ring of frame regions for the data uploaded every frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "DynamicBuffer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+/***********************************************************
+ *  DynamicBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+DynamicBuffer::DynamicBuffer()
+{
+	m_buffer = 0;
+	m_pMemory = NULL;
+	m_regionSize = 0;
+	for (int i = 0; i < FRAME_REGIONS; i++)
+	{
+		m_fences[i] = NULL;
+	}
+	m_region = 0;
+	m_offset = 0;
+	m_neededSize = 0;
+	m_bindingAlignment = 256;
+}
+
+/***********************************************************
+ *  ~DynamicBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+DynamicBuffer::~DynamicBuffer()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Create()
+ *
+ *  This method is used for creating the mapped buffer with
+ *  the passed in size for each frame region.  False is
+ *  returned when persistent mapping is not supported, and
+ *  the data of each frame then has to be uploaded the way
+ *  it was before.
+ ***********************************************************/
+bool DynamicBuffer::Create(GLsizeiptr regionSize)
+{
+	GLint storageAlignment = 0;
+	GLint uniformAlignment = 0;
+
+	Destroy();
+
+	if (!GLEW_ARB_buffer_storage)
+	{
+		return(false);
+	}
+
+	// one alignment that suits both kinds of binding ranges
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &uniformAlignment);
+	if (GLEW_ARB_shader_storage_buffer_object)
+	{
+		glGetIntegerv(GL_SHADER_STORAGE_BUFFER_OFFSET_ALIGNMENT, &storageAlignment);
+	}
+	m_bindingAlignment = std::max((GLsizeiptr)std::max(storageAlignment, uniformAlignment), (GLsizeiptr)16);
+
+	if (!CreateStorage(regionSize))
+	{
+		return(false);
+	}
+
+	std::cout << "Using persistently mapped dynamic buffer, region size:" << m_regionSize << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreateStorage()
+ *
+ *  This method is used for creating the buffer object with
+ *  immutable storage for every frame region, and mapping it
+ *  for writing until it is destroyed.  The mapping is
+ *  coherent, so the writes are seen by the GPU without
+ *  being flushed.
+ ***********************************************************/
+bool DynamicBuffer::CreateStorage(GLsizeiptr regionSize)
+{
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	// the regions start on a binding boundary
+	regionSize = ((regionSize + m_bindingAlignment - 1) / m_bindingAlignment) * m_bindingAlignment;
+
+	glGenBuffers(1, &m_buffer);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+	glBufferStorage(GL_COPY_WRITE_BUFFER, regionSize * FRAME_REGIONS, NULL, flags);
+	m_pMemory = (unsigned char*)glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, regionSize * FRAME_REGIONS, flags);
+	glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+	if (NULL == m_pMemory)
+	{
+		std::cout << "Could not map the dynamic buffer" << std::endl;
+		DestroyStorage();
+		return(false);
+	}
+
+	m_regionSize = regionSize;
+	m_region = 0;
+	m_offset = 0;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for waiting until the GPU is done
+ *  with every region, and freeing the buffer.
+ ***********************************************************/
+void DynamicBuffer::Destroy()
+{
+	for (int i = 0; i < FRAME_REGIONS; i++)
+	{
+		WaitForRegion(i);
+	}
+
+	DestroyStorage();
+	m_neededSize = 0;
+}
+
+/***********************************************************
+ *  DestroyStorage()
+ *
+ *  This method is used for unmapping and freeing the buffer
+ *  object.  The fences have to be waited on first.
+ ***********************************************************/
+void DynamicBuffer::DestroyStorage()
+{
+	if (0 != m_buffer)
+	{
+		glBindBuffer(GL_COPY_WRITE_BUFFER, m_buffer);
+		if (NULL != m_pMemory)
+		{
+			glUnmapBuffer(GL_COPY_WRITE_BUFFER);
+		}
+		glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+		glDeleteBuffers(1, &m_buffer);
+		m_buffer = 0;
+	}
+
+	m_pMemory = NULL;
+	m_regionSize = 0;
+	m_offset = 0;
+}
+
+/***********************************************************
+ *  IsReady()
+ *
+ *  This method is used for checking whether the buffer is
+ *  mapped and can be allocated from.
+ ***********************************************************/
+bool DynamicBuffer::IsReady() const
+{
+	return(NULL != m_pMemory);
+}
+
+/***********************************************************
+ *  WaitForRegion()
+ *
+ *  This method is used for waiting until the GPU has passed
+ *  the last frame that read from a region.
+ ***********************************************************/
+void DynamicBuffer::WaitForRegion(int region)
+{
+	if (NULL == m_fences[region])
+	{
+		return;
+	}
+
+	GLenum waitResult = GL_TIMEOUT_EXPIRED;
+	while ((waitResult != GL_ALREADY_SIGNALED) && (waitResult != GL_CONDITION_SATISFIED) && (waitResult != GL_WAIT_FAILED))
+	{
+		waitResult = glClientWaitSync(m_fences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	}
+
+	glDeleteSync(m_fences[region]);
+	m_fences[region] = NULL;
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for moving on to the next region and
+ *  starting it empty, once the GPU is done with the frame
+ *  that last used it.  With three regions this only waits
+ *  when the GPU is more than two frames behind.  When the
+ *  last frame did not fit, the regions are grown first.
+ ***********************************************************/
+void DynamicBuffer::BeginFrame()
+{
+	if (NULL == m_pMemory)
+	{
+		return;
+	}
+
+	if (m_neededSize > m_regionSize)
+	{
+		GLsizeiptr regionSize = std::max(m_neededSize + (m_neededSize / 2), m_regionSize * 2);
+
+		for (int i = 0; i < FRAME_REGIONS; i++)
+		{
+			WaitForRegion(i);
+		}
+		DestroyStorage();
+		if (!CreateStorage(regionSize))
+		{
+			return;
+		}
+		std::cout << "Grew the dynamic buffer, region size:" << m_regionSize << std::endl;
+	}
+
+	m_region = (m_region + 1) % FRAME_REGIONS;
+	WaitForRegion(m_region);
+	m_offset = 0;
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for placing the fence of the region
+ *  after the last command that reads from it.  Nothing is
+ *  fenced when the frame did not allocate anything.
+ ***********************************************************/
+void DynamicBuffer::EndFrame()
+{
+	if ((NULL == m_pMemory) || (0 == m_offset))
+	{
+		return;
+	}
+
+	m_fences[m_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+/***********************************************************
+ *  Allocate()
+ *
+ *  This method is used for allocating space at the next
+ *  free offset of the frame's region, aligned to the passed
+ *  in alignment.  The offset into the buffer is returned in
+ *  offset, along with a pointer to write the data to.  NULL
+ *  is returned when the region is full, and the size the
+ *  frame asked for is kept so the regions grow to fit it.
+ ***********************************************************/
+unsigned char* DynamicBuffer::Allocate(GLsizeiptr size, GLsizeiptr alignment, GLintptr& offset)
+{
+	if (NULL == m_pMemory)
+	{
+		return(NULL);
+	}
+
+	alignment = std::max(alignment, (GLsizeiptr)1);
+	GLsizeiptr first = ((m_offset + alignment - 1) / alignment) * alignment;
+
+	if (first + size > m_regionSize)
+	{
+		m_neededSize = std::max(m_neededSize, first + size);
+		return(NULL);
+	}
+
+	m_offset = first + size;
+	m_neededSize = std::max(m_neededSize, m_offset);
+	offset = (m_region * m_regionSize) + first;
+
+	return(m_pMemory + offset);
+}
+
+/***********************************************************
+ *  Upload()
+ *
+ *  This method is used for allocating space in the frame's
+ *  region and copying the passed in data into it.  False is
+ *  returned when the region is full.
+ ***********************************************************/
+bool DynamicBuffer::Upload(const void* data, GLsizeiptr size, GLsizeiptr alignment, GLintptr& offset)
+{
+	unsigned char* pMemory = Allocate(size, alignment, offset);
+
+	if (NULL == pMemory)
+	{
+		return(false);
+	}
+
+	memcpy(pMemory, data, size);
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetBuffer()
+ *
+ *  This method is used for getting the buffer object that
+ *  the allocations are bound from.
+ ***********************************************************/
+GLuint DynamicBuffer::GetBuffer() const
+{
+	return(m_buffer);
+}
+
+/***********************************************************
+ *  GetBindingAlignment()
+ *
+ *  This method is used for getting the alignment that the
+ *  offset of a storage or uniform buffer binding range needs.
+ ***********************************************************/
+GLsizeiptr DynamicBuffer::GetBindingAlignment() const
+{
+	return(m_bindingAlignment);
+}
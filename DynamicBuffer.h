@@ -0,0 +1,84 @@
+///////////////////////////////////////////////////////////////////////////////
+// dynamicbuffer.h
+// ============
+// persistently mapped ring of frame regions for the data uploaded every frame
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  DynamicBuffer
+ *
+ *  This class keeps one buffer object that stays mapped for
+ *  its whole lifetime, split into a region for each frame
+ *  that can be in flight.  The data of a frame is written
+ *  straight into the mapped memory at the next free offset
+ *  of its region, and bound by that offset, so it is never
+ *  copied by the driver and the buffer is never orphaned.
+ *
+ *  A fence is placed after the last draw of a frame, and the
+ *  region is only written again once the GPU has passed it.
+ *  When a frame needs more than a region holds, the caller
+ *  falls back to its own upload and the regions are grown
+ *  before the next frame.
+ ***********************************************************/
+class DynamicBuffer
+{
+public:
+	// constructor
+	DynamicBuffer();
+	// destructor
+	~DynamicBuffer();
+
+	// the number of frame regions that can be in flight at once
+	static const int FRAME_REGIONS = 3;
+
+private:
+	// the mapped buffer and the size of each region
+	GLuint m_buffer;
+	unsigned char* m_pMemory;
+	GLsizeiptr m_regionSize;
+	// fences placed after each region was last drawn from
+	GLsync m_fences[FRAME_REGIONS];
+	// the region of the frame and its next free offset
+	int m_region;
+	GLsizeiptr m_offset;
+	// the most a frame asked for, the regions grow to fit it
+	GLsizeiptr m_neededSize;
+	// offset alignment of the storage and uniform buffer bindings
+	GLsizeiptr m_bindingAlignment;
+
+	// wait until the GPU has passed the last frame of a region
+	void WaitForRegion(int region);
+	// create the mapped buffer with the passed in region size
+	bool CreateStorage(GLsizeiptr regionSize);
+	// unmap and free the buffer
+	void DestroyStorage();
+
+public:
+	// create the mapped buffer, false when persistent mapping is not supported
+	bool Create(GLsizeiptr regionSize);
+	// wait for the GPU and free the buffer
+	void Destroy();
+	// check whether the buffer is mapped
+	bool IsReady() const;
+
+	// start writing the region of a new frame
+	void BeginFrame();
+	// fence the region after the last draw that reads it
+	void EndFrame();
+
+	// allocate space in the region of the frame, NULL when it is full
+	unsigned char* Allocate(GLsizeiptr size, GLsizeiptr alignment, GLintptr& offset);
+	// copy data into space allocated in the region of the frame
+	bool Upload(const void* data, GLsizeiptr size, GLsizeiptr alignment, GLintptr& offset);
+
+	// get the buffer object to bind
+	GLuint GetBuffer() const;
+	// get the offset alignment that a buffer binding range needs
+	GLsizeiptr GetBindingAlignment() const;
+};
@@ -0,0 +1,175 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepacer.cpp
+// ============
+// pace the frames with vsync and a frame cap, and sleep while nothing changes
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FramePacer.h"
+
+#include <iostream>
+
+// GLFW library
+#include "GLFW/glfw3.h"
+
+/***********************************************************
+ *  FramePacer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FramePacer::FramePacer()
+{
+	m_vsyncMode = VSYNC_ON;
+	m_bRenderOnDemand = true;
+	m_frameInterval = 0.0;
+	m_nextFrameTime = 0.0;
+	m_idleTimeout = 0.5;
+}
+
+/***********************************************************
+ *  ~FramePacer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FramePacer::~FramePacer()
+{
+}
+
+/***********************************************************
+ *  SetVsyncMode()
+ *
+ *  This method is used for setting how the buffer swaps of
+ *  the window of the current context wait for the display
+ *  refresh.  Adaptive vsync needs the swap control tear
+ *  extension, without it the swaps always wait.
+ ***********************************************************/
+void FramePacer::SetVsyncMode(VSYNC_MODE vsyncMode)
+{
+	if ((VSYNC_ADAPTIVE == vsyncMode) &&
+		(!glfwExtensionSupported("WGL_EXT_swap_control_tear")) &&
+		(!glfwExtensionSupported("GLX_EXT_swap_control_tear")))
+	{
+		std::cout << "Adaptive vsync is not supported, using vsync" << std::endl;
+		vsyncMode = VSYNC_ON;
+	}
+
+	m_vsyncMode = vsyncMode;
+
+	switch (m_vsyncMode)
+	{
+	case VSYNC_OFF:
+		glfwSwapInterval(0);
+		break;
+	case VSYNC_ADAPTIVE:
+		// a negative interval lets a late frame swap right away
+		glfwSwapInterval(-1);
+		break;
+	default:
+		glfwSwapInterval(1);
+		break;
+	}
+}
+
+/***********************************************************
+ *  GetVsyncMode()
+ *
+ *  This method is used for getting the vsync mode that the
+ *  buffers are swapped with, after any fallback from an
+ *  unsupported mode.
+ ***********************************************************/
+FramePacer::VSYNC_MODE FramePacer::GetVsyncMode() const
+{
+	return(m_vsyncMode);
+}
+
+/***********************************************************
+ *  SetRenderOnDemand()
+ *
+ *  This method is used for rendering the frames only when
+ *  something changed, or rendering every frame.
+ ***********************************************************/
+void FramePacer::SetRenderOnDemand(bool bRenderOnDemand)
+{
+	m_bRenderOnDemand = bRenderOnDemand;
+}
+
+/***********************************************************
+ *  IsRenderOnDemand()
+ *
+ *  This method is used for checking whether the frames are
+ *  only rendered when something changed.
+ ***********************************************************/
+bool FramePacer::IsRenderOnDemand() const
+{
+	return(m_bRenderOnDemand);
+}
+
+/***********************************************************
+ *  SetFrameCap()
+ *
+ *  This method is used for setting the most frames that are
+ *  rendered per second, or 0 for rendering as fast as the
+ *  vsync mode allows.
+ ***********************************************************/
+void FramePacer::SetFrameCap(double framesPerSecond)
+{
+	m_frameInterval = (framesPerSecond > 0.0) ? (1.0 / framesPerSecond) : 0.0;
+	m_nextFrameTime = 0.0;
+}
+
+/***********************************************************
+ *  SetIdleTimeout()
+ *
+ *  This method is used for setting the longest time that
+ *  the loop sleeps while nothing changes, so the work that
+ *  is checked on a timer, like watching the shader files,
+ *  still gets done.
+ ***********************************************************/
+void FramePacer::SetIdleTimeout(double seconds)
+{
+	m_idleTimeout = (seconds > 0.0) ? seconds : 0.5;
+}
+
+/***********************************************************
+ *  WaitForNextFrame()
+ *
+ *  This method is used for receiving the events of the next
+ *  frame.  When the frames are rendered on demand and the
+ *  passed in flag says nothing is changing, the thread
+ *  sleeps until an event arrives or the idle timeout
+ *  passes.  With a frame cap, the events are then waited
+ *  for until the next frame is due.  The frames are due at
+ *  a steady interval, and a frame that comes after a pause
+ *  starts the interval again, so the frames after a pause
+ *  are not rushed to catch up.
+ ***********************************************************/
+void FramePacer::WaitForNextFrame(bool bChanging)
+{
+	if (m_bRenderOnDemand && (!bChanging))
+	{
+		glfwWaitEventsTimeout(m_idleTimeout);
+	}
+	else
+	{
+		glfwPollEvents();
+	}
+
+	if (m_frameInterval <= 0.0)
+	{
+		return;
+	}
+
+	double currentTime = glfwGetTime();
+	if (currentTime > m_nextFrameTime + m_frameInterval)
+	{
+		m_nextFrameTime = currentTime;
+	}
+
+	while (currentTime < m_nextFrameTime)
+	{
+		glfwWaitEventsTimeout(m_nextFrameTime - currentTime);
+		currentTime = glfwGetTime();
+	}
+	m_nextFrameTime += m_frameInterval;
+}
@@ -0,0 +1,67 @@
+///////////////////////////////////////////////////////////////////////////////
+// framepacer.h
+// ============
+// pace the frames with vsync and a frame cap, and sleep while nothing changes
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/***********************************************************
+ *  FramePacer
+ *
+ *  This class decides how long the main loop waits before
+ *  the next frame.  When the frames are rendered on demand
+ *  and nothing is changing, the loop sleeps in GLFW until
+ *  an event arrives or a timeout passes, instead of drawing
+ *  the same frame again.  Otherwise the events are polled,
+ *  and a frame cap holds the frames back to a steady rate
+ *  by waiting for events until the next frame is due, so
+ *  the input is received while waiting.  The swap interval
+ *  of the window is picked from the vsync mode.
+ ***********************************************************/
+class FramePacer
+{
+public:
+	// constructor
+	FramePacer();
+	// destructor
+	~FramePacer();
+
+	// how the buffer swaps wait for the display refresh
+	enum VSYNC_MODE
+	{
+		VSYNC_OFF = 0,
+		VSYNC_ON,
+		// waits for the refresh, unless the frame is late
+		VSYNC_ADAPTIVE
+	};
+
+private:
+	// vsync mode that was set on the window
+	VSYNC_MODE m_vsyncMode;
+	// true when frames are only rendered when something changed
+	bool m_bRenderOnDemand;
+	// seconds between capped frames, or 0 when not capped
+	double m_frameInterval;
+	// time the next capped frame is due
+	double m_nextFrameTime;
+	// longest time to sleep while nothing changes
+	double m_idleTimeout;
+
+public:
+	// set the vsync mode on the window of the current context
+	void SetVsyncMode(VSYNC_MODE vsyncMode);
+	VSYNC_MODE GetVsyncMode() const;
+	// render the frames only when something changed, or every frame
+	void SetRenderOnDemand(bool bRenderOnDemand);
+	bool IsRenderOnDemand() const;
+	// set the most frames rendered per second, or 0 for no cap
+	void SetFrameCap(double framesPerSecond);
+	// set the longest time to sleep while nothing changes
+	void SetIdleTimeout(double seconds);
+
+	// wait for the events of the next frame, sleeping when nothing is changing
+	void WaitForNextFrame(bool bChanging);
+};
@@ -0,0 +1,675 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameprofiler.cpp
+// ============
+// measure CPU and GPU time of named scopes in the frame - statistics, overlay
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "FrameProfiler.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+// declaration of global variables and defines
+namespace
+{
+	// name of the scope that covers the whole frame
+	const char* g_FrameScopeName = "Frame";
+	// frame time the overlay bars are scaled to, 60 frames per second
+	const double g_OverlayBudgetMs = 1000.0 / 60.0;
+	// screen pixels per font pixel of the overlay text, and the most
+	// characters of a scope name that are drawn
+	const int g_OverlayTextScale = 2;
+	const int g_OverlayNameLength = 16;
+
+	// the 3x5 pixel font of the overlay, each glyph is its five rows
+	// from the top, three pixels each from the left
+	struct OVERLAY_GLYPH
+	{
+		char character;
+		const char* pixels;
+	};
+	const OVERLAY_GLYPH g_OverlayFont[] =
+	{
+		{ '0', "111101101101111" }, { '1', "010110010010111" },
+		{ '2', "111001111100111" }, { '3', "111001111001111" },
+		{ '4', "101101111001001" }, { '5', "111100111001111" },
+		{ '6', "111100111101111" }, { '7', "111001001001001" },
+		{ '8', "111101111101111" }, { '9', "111101111001111" },
+		{ 'A', "010101111101101" }, { 'B', "110101110101110" },
+		{ 'C', "011100100100011" }, { 'D', "110101101101110" },
+		{ 'E', "111100110100111" }, { 'F', "111100110100100" },
+		{ 'G', "011100101101011" }, { 'H', "101101111101101" },
+		{ 'I', "111010010010111" }, { 'J', "001001001101010" },
+		{ 'K', "101101110101101" }, { 'L', "100100100100111" },
+		{ 'M', "101111111101101" }, { 'N', "110101101101101" },
+		{ 'O', "010101101101010" }, { 'P', "110101110100100" },
+		{ 'Q', "010101101110011" }, { 'R', "110101110101101" },
+		{ 'S', "011100010001110" }, { 'T', "111010010010010" },
+		{ 'U', "101101101101111" }, { 'V', "101101101101010" },
+		{ 'W', "101101111111101" }, { 'X', "101101010101101" },
+		{ 'Y', "101101010010010" }, { 'Z', "111001010100111" },
+		{ '.', "000000000000010" }, { '-', "000000111000000" },
+		{ '/', "001001010100100" }, { ':', "000010000010000" }
+	};
+	const int g_OverlayGlyphCount = sizeof(g_OverlayFont) / sizeof(g_OverlayFont[0]);
+
+	/***********************************************************
+	 *  DrawOverlayText()
+	 *
+	 *  This function is used for drawing a line of text with
+	 *  the overlay font in the current clear color, at the
+	 *  passed in bottom left corner in pixels.  The lit pixels
+	 *  of each glyph row are cleared as one scissor box, so no
+	 *  shader or font texture is needed.  Lower case letters are
+	 *  drawn as capitals and unknown characters as spaces.  The
+	 *  x position after the text is returned.
+	 ***********************************************************/
+	int DrawOverlayText(const char* text, int x, int y)
+	{
+		const int scale = g_OverlayTextScale;
+
+		for (const char* character = text; *character != '\0'; character++)
+		{
+			char upper = (char)toupper((unsigned char)*character);
+			const char* pixels = NULL;
+
+			for (int i = 0; (i < g_OverlayGlyphCount) && (NULL == pixels); i++)
+			{
+				if (g_OverlayFont[i].character == upper)
+				{
+					pixels = g_OverlayFont[i].pixels;
+				}
+			}
+
+			for (int row = 0; (NULL != pixels) && (row < 5); row++)
+			{
+				int column = 0;
+				while (column < 3)
+				{
+					int runStart = column;
+					while ((column < 3) && (pixels[row * 3 + column] == '1'))
+					{
+						column++;
+					}
+					if (column > runStart)
+					{
+						glScissor(x + runStart * scale, y + (4 - row) * scale, (column - runStart) * scale, scale);
+						glClear(GL_COLOR_BUFFER_BIT);
+					}
+					else
+					{
+						column++;
+					}
+				}
+			}
+
+			// one pixel of space after every glyph
+			x += 4 * scale;
+		}
+
+		return(x);
+	}
+}
+
+/***********************************************************
+ *  FrameProfiler()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+FrameProfiler::FrameProfiler()
+{
+	m_bInitialized = false;
+	m_bShowOverlay = false;
+	m_startTime = std::chrono::steady_clock::now();
+	m_gpuClockOffset = 0.0;
+	for (int i = 0; i < QUERY_FRAMES; i++)
+	{
+		for (int j = 0; j < MAX_SCOPES * 2; j++)
+		{
+			m_frames[i].queries[j] = 0;
+		}
+		m_frames[i].bPending = false;
+	}
+	m_currentFrame = 0;
+	m_openScopes = 0;
+	m_nextTraceFrame = 0;
+	m_bGpuResolved = false;
+}
+
+/***********************************************************
+ *  ~FrameProfiler()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+FrameProfiler::~FrameProfiler()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating the timestamp queries
+ *  and lining up the GPU clock with the CPU clock.  It must
+ *  be called after the OpenGL context has been created.
+ ***********************************************************/
+void FrameProfiler::Initialize()
+{
+	GLint64 gpuTime = 0;
+
+	for (int i = 0; i < QUERY_FRAMES; i++)
+	{
+		glGenQueries(MAX_SCOPES * 2, m_frames[i].queries);
+		m_frames[i].bPending = false;
+	}
+
+	glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+	m_gpuClockOffset = CpuTime() - (gpuTime / 1000000.0);
+
+	m_bInitialized = true;
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the timestamp queries.
+ ***********************************************************/
+void FrameProfiler::Destroy()
+{
+	if (m_bInitialized)
+	{
+		for (int i = 0; i < QUERY_FRAMES; i++)
+		{
+			glDeleteQueries(MAX_SCOPES * 2, m_frames[i].queries);
+		}
+		m_bInitialized = false;
+	}
+}
+
+/***********************************************************
+ *  CpuTime()
+ *
+ *  This method is used for getting the CPU time since the
+ *  profiler was created, in milliseconds.
+ ***********************************************************/
+double FrameProfiler::CpuTime() const
+{
+	return(std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_startTime).count());
+}
+
+/***********************************************************
+ *  BeginFrame()
+ *
+ *  This method is used for starting to measure a frame.  The
+ *  query slot of the frame is reused, so the frame measured
+ *  in it before is read back first.
+ ***********************************************************/
+void FrameProfiler::BeginFrame()
+{
+	if (!m_bInitialized)
+	{
+		return;
+	}
+
+	m_currentFrame = (m_currentFrame + 1) % QUERY_FRAMES;
+
+	FRAME_RECORD& frame = m_frames[m_currentFrame];
+	m_bGpuResolved = false;
+	if (frame.bPending)
+	{
+		ResolveFrame(frame);
+	}
+	frame.scopes.clear();
+	frame.bPending = false;
+	m_openScopes = 0;
+
+	BeginScope(g_FrameScopeName);
+}
+
+/***********************************************************
+ *  EndFrame()
+ *
+ *  This method is used for finishing measuring a frame.
+ ***********************************************************/
+void FrameProfiler::EndFrame()
+{
+	if (!m_bInitialized)
+	{
+		return;
+	}
+
+	EndScope(0);
+	m_frames[m_currentFrame].bPending = true;
+}
+
+/***********************************************************
+ *  BeginScope()
+ *
+ *  This method is used for starting to measure a named
+ *  scope.  The index of the scope is returned, or -1 when
+ *  the frame already has the maximum number of scopes.
+ ***********************************************************/
+int FrameProfiler::BeginScope(const char* name)
+{
+	if (!m_bInitialized)
+	{
+		return(-1);
+	}
+
+	FRAME_RECORD& frame = m_frames[m_currentFrame];
+	int scope = frame.scopes.size();
+
+	if (scope >= MAX_SCOPES)
+	{
+		return(-1);
+	}
+
+	SCOPE_RECORD record;
+	record.name = name;
+	record.depth = m_openScopes;
+	record.cpuStart = CpuTime();
+	record.cpuEnd = record.cpuStart;
+	record.gpuStart = -1.0;
+	record.gpuEnd = -1.0;
+	frame.scopes.push_back(record);
+
+	glQueryCounter(frame.queries[scope * 2], GL_TIMESTAMP);
+	m_openScopes++;
+
+	return(scope);
+}
+
+/***********************************************************
+ *  EndScope()
+ *
+ *  This method is used for finishing measuring a scope.
+ ***********************************************************/
+void FrameProfiler::EndScope(int scope)
+{
+	if ((!m_bInitialized) || (scope < 0))
+	{
+		return;
+	}
+
+	FRAME_RECORD& frame = m_frames[m_currentFrame];
+
+	glQueryCounter(frame.queries[scope * 2 + 1], GL_TIMESTAMP);
+	frame.scopes[scope].cpuEnd = CpuTime();
+	m_openScopes--;
+}
+
+/***********************************************************
+ *  ResolveFrame()
+ *
+ *  This method is used for reading back the timestamp queries
+ *  of a finished frame and adding its scopes to the history.
+ *  When the GPU has not finished the frame yet, only the CPU
+ *  times are kept instead of waiting for the results.
+ ***********************************************************/
+void FrameProfiler::ResolveFrame(FRAME_RECORD& frame)
+{
+	GLint available = 0;
+
+	if (frame.scopes.size() == 0)
+	{
+		return;
+	}
+
+	// the end of the frame scope is the last query issued in the frame
+	glGetQueryObjectiv(frame.queries[1], GL_QUERY_RESULT_AVAILABLE, &available);
+
+	for (int i = 0; i < frame.scopes.size(); i++)
+	{
+		SCOPE_RECORD& record = frame.scopes[i];
+		double gpuTime = -1.0;
+
+		if (available)
+		{
+			GLuint64 gpuStart = 0;
+			GLuint64 gpuEnd = 0;
+
+			glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &gpuStart);
+			glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &gpuEnd);
+
+			record.gpuStart = (gpuStart / 1000000.0) + m_gpuClockOffset;
+			record.gpuEnd = (gpuEnd / 1000000.0) + m_gpuClockOffset;
+			gpuTime = record.gpuEnd - record.gpuStart;
+			m_bGpuResolved = true;
+		}
+
+		AddSample(record.name, record.cpuEnd - record.cpuStart, gpuTime);
+	}
+
+	// keep the resolved frame for the trace export
+	if (m_traceFrames.size() < HISTORY_FRAMES)
+	{
+		m_traceFrames.push_back(frame.scopes);
+	}
+	else
+	{
+		m_traceFrames[m_nextTraceFrame] = frame.scopes;
+	}
+	m_nextTraceFrame = (m_nextTraceFrame + 1) % HISTORY_FRAMES;
+}
+
+/***********************************************************
+ *  AddSample()
+ *
+ *  This method is used for adding one sample to the history
+ *  of a scope name.  A negative GPU time means the GPU time
+ *  was not available for the sample.
+ ***********************************************************/
+void FrameProfiler::AddSample(const char* name, double cpuTime, double gpuTime)
+{
+	SCOPE_HISTORY* pHistory = NULL;
+
+	for (int i = 0; (i < m_history.size()) && (NULL == pHistory); i++)
+	{
+		if (m_history[i].name.compare(name) == 0)
+		{
+			pHistory = &m_history[i];
+		}
+	}
+
+	if (NULL == pHistory)
+	{
+		SCOPE_HISTORY history;
+		history.name = name;
+		m_history.push_back(history);
+		pHistory = &m_history.back();
+	}
+
+	pHistory->cpuTimes.push_back(cpuTime);
+	if (pHistory->cpuTimes.size() > HISTORY_FRAMES)
+	{
+		pHistory->cpuTimes.erase(pHistory->cpuTimes.begin());
+	}
+
+	if (gpuTime >= 0.0)
+	{
+		pHistory->gpuTimes.push_back(gpuTime);
+		if (pHistory->gpuTimes.size() > HISTORY_FRAMES)
+		{
+			pHistory->gpuTimes.erase(pHistory->gpuTimes.begin());
+		}
+	}
+}
+
+/***********************************************************
+ *  Percentile()
+ *
+ *  This method is used for getting a percentile, from 0 to
+ *  100, of a list of samples.
+ ***********************************************************/
+double FrameProfiler::Percentile(std::vector<double> samples, double percentile)
+{
+	if (samples.size() == 0)
+	{
+		return(0.0);
+	}
+
+	size_t index = (size_t)((percentile / 100.0) * (samples.size() - 1) + 0.5);
+	std::nth_element(samples.begin(), samples.begin() + index, samples.end());
+
+	return(samples[index]);
+}
+
+/***********************************************************
+ *  GetStatistics()
+ *
+ *  This method is used for getting the mean, 95th and 99th
+ *  percentile of every scope name over the history.
+ ***********************************************************/
+void FrameProfiler::GetStatistics(std::vector<SCOPE_STATISTICS>& statistics) const
+{
+	statistics.clear();
+
+	for (int i = 0; i < m_history.size(); i++)
+	{
+		const SCOPE_HISTORY& history = m_history[i];
+		SCOPE_STATISTICS scope;
+		double cpuTotal = 0.0;
+		double gpuTotal = 0.0;
+
+		for (int j = 0; j < history.cpuTimes.size(); j++)
+		{
+			cpuTotal += history.cpuTimes[j];
+		}
+		for (int j = 0; j < history.gpuTimes.size(); j++)
+		{
+			gpuTotal += history.gpuTimes[j];
+		}
+
+		scope.name = history.name;
+		scope.cpuMean = (history.cpuTimes.size() > 0) ? cpuTotal / history.cpuTimes.size() : 0.0;
+		scope.cpuP95 = Percentile(history.cpuTimes, 95.0);
+		scope.cpuP99 = Percentile(history.cpuTimes, 99.0);
+		scope.gpuMean = (history.gpuTimes.size() > 0) ? gpuTotal / history.gpuTimes.size() : 0.0;
+		scope.gpuP95 = Percentile(history.gpuTimes, 95.0);
+		scope.gpuP99 = Percentile(history.gpuTimes, 99.0);
+
+		statistics.push_back(scope);
+	}
+}
+
+/***********************************************************
+ *  GetSummary()
+ *
+ *  This method is used for getting a one line summary of
+ *  the mean CPU and GPU times of the scopes.
+ ***********************************************************/
+std::string FrameProfiler::GetSummary() const
+{
+	std::vector<SCOPE_STATISTICS> statistics;
+	std::string summary;
+	char text[128];
+
+	GetStatistics(statistics);
+
+	for (int i = 0; i < statistics.size(); i++)
+	{
+		snprintf(text, sizeof(text), "%s%s cpu %.2f gpu %.2f ms",
+			(i > 0) ? " | " : "",
+			statistics[i].name.c_str(),
+			statistics[i].cpuMean,
+			statistics[i].gpuMean);
+		summary += text;
+	}
+
+	return(summary);
+}
+
+/***********************************************************
+ *  GetResolvedGpuTime()
+ *
+ *  This method is used for getting the GPU time of a scope,
+ *  in milliseconds, in the frame whose queries were read
+ *  back by the last BeginFrame().  False is returned when
+ *  no GPU times were read back then, so the same frame is
+ *  never returned twice, or when the frame has no such scope.
+ ***********************************************************/
+bool FrameProfiler::GetResolvedGpuTime(const char* name, double& gpuTime) const
+{
+	if ((!m_bGpuResolved) || (m_traceFrames.empty()))
+	{
+		return(false);
+	}
+
+	// the frame resolved last was kept right before the next trace frame
+	const std::vector<SCOPE_RECORD>& scopes =
+		m_traceFrames[(m_nextTraceFrame + HISTORY_FRAMES - 1) % HISTORY_FRAMES];
+
+	for (int i = 0; i < scopes.size(); i++)
+	{
+		if (strcmp(scopes[i].name, name) == 0)
+		{
+			gpuTime = scopes[i].gpuEnd - scopes[i].gpuStart;
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  ToggleOverlay()
+ *
+ *  This method is used for showing or hiding the overlay.
+ ***********************************************************/
+void FrameProfiler::ToggleOverlay()
+{
+	m_bShowOverlay = !m_bShowOverlay;
+}
+
+/***********************************************************
+ *  DrawOverlay()
+ *
+ *  This method is used for drawing a row for every scope in
+ *  the top left corner of the framebuffer, with the scope
+ *  name, the mean CPU time (green) and GPU time (orange) as
+ *  bars, and the mean, 95th and 99th percentile as numbers.
+ *  The bars are scaled so the full width of the bar column
+ *  is one 60 fps frame.  The 95th percentile is drawn as a
+ *  thin marker after each bar in its color, and the 99th
+ *  percentile as a white marker.  A header row names the
+ *  columns, its CPU and GPU labels in the bar colors.
+ ***********************************************************/
+void FrameProfiler::DrawOverlay(int width, int height) const
+{
+	const int charWidth = 4 * g_OverlayTextScale;
+	const int rowHeight = 6 * g_OverlayTextScale;
+	const int barHeight = rowHeight / 2 - 1;
+	const int barX = (g_OverlayNameLength + 1) * charWidth;
+	const int barWidth = width / 4;
+	const int readoutX = barX + barWidth + charWidth;
+	// three columns of seven characters for each of the CPU and GPU
+	const int readoutWidth = 44 * charWidth;
+	std::vector<SCOPE_STATISTICS> statistics;
+	GLfloat clearColor[4];
+	char text[64];
+
+	if (!m_bShowOverlay)
+	{
+		return;
+	}
+
+	GetStatistics(statistics);
+
+	// the bars and text are drawn with scissored clears, so no shader is needed
+	glGetFloatv(GL_COLOR_CLEAR_VALUE, clearColor);
+	glEnable(GL_SCISSOR_TEST);
+
+	// panel background
+	int panelHeight = ((int)statistics.size() + 1) * rowHeight + 4;
+	glScissor(0, height - panelHeight, readoutX + readoutWidth, panelHeight);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT);
+
+	// header row, which doubles as the legend of the bar colors
+	int headerY = height - rowHeight;
+	glClearColor(0.2f, 0.8f, 0.2f, 1.0f);
+	int x = DrawOverlayText("CPU ", 0, headerY);
+	DrawOverlayText("   MEAN    P95    P99", readoutX, headerY);
+	glClearColor(1.0f, 0.55f, 0.1f, 1.0f);
+	x = DrawOverlayText("GPU ", x, headerY);
+	DrawOverlayText("   MEAN    P95    P99", readoutX + 23 * charWidth, headerY);
+	glClearColor(0.9f, 0.9f, 0.9f, 1.0f);
+	DrawOverlayText("MS", x, headerY);
+
+	for (int i = 0; i < statistics.size(); i++)
+	{
+		const SCOPE_STATISTICS& scope = statistics[i];
+		int y = height - ((i + 2) * rowHeight);
+		int cpuWidth = (int)(barWidth * std::min(scope.cpuMean / g_OverlayBudgetMs, 1.0));
+		int gpuWidth = (int)(barWidth * std::min(scope.gpuMean / g_OverlayBudgetMs, 1.0));
+		int cpuP95 = (int)(barWidth * std::min(scope.cpuP95 / g_OverlayBudgetMs, 1.0));
+		int gpuP95 = (int)(barWidth * std::min(scope.gpuP95 / g_OverlayBudgetMs, 1.0));
+		int cpuP99 = (int)(barWidth * std::min(scope.cpuP99 / g_OverlayBudgetMs, 1.0));
+		int gpuP99 = (int)(barWidth * std::min(scope.gpuP99 / g_OverlayBudgetMs, 1.0));
+
+		// the scope name, cut to the width of the name column
+		glClearColor(0.9f, 0.9f, 0.9f, 1.0f);
+		snprintf(text, sizeof(text), "%.*s", g_OverlayNameLength, scope.name.c_str());
+		DrawOverlayText(text, 0, y);
+
+		glClearColor(0.2f, 0.8f, 0.2f, 1.0f);
+		glScissor(barX, y + barHeight + 1, std::max(cpuWidth, 1), barHeight);
+		glClear(GL_COLOR_BUFFER_BIT);
+		glScissor(barX + cpuP95, y + barHeight + 1, 1, barHeight);
+		glClear(GL_COLOR_BUFFER_BIT);
+		snprintf(text, sizeof(text), "%7.2f%7.2f%7.2f", scope.cpuMean, scope.cpuP95, scope.cpuP99);
+		x = DrawOverlayText(text, readoutX, y);
+
+		glClearColor(1.0f, 0.55f, 0.1f, 1.0f);
+		glScissor(barX, y, std::max(gpuWidth, 1), barHeight);
+		glClear(GL_COLOR_BUFFER_BIT);
+		glScissor(barX + gpuP95, y, 1, barHeight);
+		glClear(GL_COLOR_BUFFER_BIT);
+		snprintf(text, sizeof(text), "  %7.2f%7.2f%7.2f", scope.gpuMean, scope.gpuP95, scope.gpuP99);
+		DrawOverlayText(text, x, y);
+
+		glClearColor(1.0f, 1.0f, 1.0f, 1.0f);
+		glScissor(barX + cpuP99, y + barHeight + 1, 1, barHeight);
+		glClear(GL_COLOR_BUFFER_BIT);
+		glScissor(barX + gpuP99, y, 1, barHeight);
+		glClear(GL_COLOR_BUFFER_BIT);
+	}
+
+	glDisable(GL_SCISSOR_TEST);
+	glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+}
+
+/***********************************************************
+ *  ExportChromeTrace()
+ *
+ *  This method is used for writing the recorded frames as a
+ *  Chrome trace JSON file, which can be opened in a trace
+ *  viewer like chrome://tracing or Perfetto.  The CPU scopes
+ *  are written on thread 1 and the GPU scopes on thread 2.
+ ***********************************************************/
+bool FrameProfiler::ExportChromeTrace(const char* filename) const
+{
+	FILE* file = fopen(filename, "w");
+
+	if (NULL == file)
+	{
+		std::cout << "Could not write trace file:" << filename << std::endl;
+		return(false);
+	}
+
+	fprintf(file, "{\"traceEvents\":[\n");
+	fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":1,\"args\":{\"name\":\"CPU\"}},\n");
+	fprintf(file, "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":2,\"args\":{\"name\":\"GPU\"}}");
+
+	for (int i = 0; i < m_traceFrames.size(); i++)
+	{
+		// start with the oldest frame once the history has wrapped around
+		const std::vector<SCOPE_RECORD>& scopes = m_traceFrames[(m_nextTraceFrame + i) % m_traceFrames.size()];
+
+		for (int j = 0; j < scopes.size(); j++)
+		{
+			const SCOPE_RECORD& record = scopes[j];
+
+			fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":1,\"ts\":%.3f,\"dur\":%.3f}",
+				record.name, record.cpuStart * 1000.0, (record.cpuEnd - record.cpuStart) * 1000.0);
+
+			if (record.gpuStart >= 0.0)
+			{
+				fprintf(file, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":2,\"ts\":%.3f,\"dur\":%.3f}",
+					record.name, record.gpuStart * 1000.0, (record.gpuEnd - record.gpuStart) * 1000.0);
+			}
+		}
+	}
+
+	fprintf(file, "\n]}\n");
+	fclose(file);
+
+	std::cout << "Wrote frame trace:" << filename << std::endl;
+
+	return(true);
+}
@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////
+// frameprofiler.h
+// ============
+// measure CPU and GPU time of named scopes in the frame - statistics, overlay
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  FrameProfiler
+ *
+ *  This class measures named scopes of every frame on the
+ *  CPU with a steady clock and on the GPU with timestamp
+ *  queries.  The queries of a frame are only read back a
+ *  few frames later, once the GPU has finished them, so
+ *  measuring never stalls the pipeline.  Rolling statistics
+ *  are kept per scope name, can be drawn as an overlay, and
+ *  can be exported as a Chrome trace.
+ ***********************************************************/
+class FrameProfiler
+{
+public:
+	// constructor
+	FrameProfiler();
+	// destructor
+	~FrameProfiler();
+
+	// rolling statistics of one scope name, in milliseconds
+	struct SCOPE_STATISTICS
+	{
+		std::string name;
+		double cpuMean;
+		double cpuP95;
+		double cpuP99;
+		double gpuMean;
+		double gpuP95;
+		double gpuP99;
+	};
+
+private:
+	// the number of frames of queries that can be in flight
+	static const int QUERY_FRAMES = 4;
+	// the maximum number of scopes measured in one frame
+	static const int MAX_SCOPES = 64;
+	// the number of frames the statistics and trace are kept for
+	static const int HISTORY_FRAMES = 300;
+
+	// one measured scope in a frame
+	struct SCOPE_RECORD
+	{
+		const char* name;
+		int depth;
+		double cpuStart;
+		double cpuEnd;
+		double gpuStart;
+		double gpuEnd;
+	};
+
+	// the scopes and timestamp queries of one frame
+	struct FRAME_RECORD
+	{
+		std::vector<SCOPE_RECORD> scopes;
+		GLuint queries[MAX_SCOPES * 2];
+		bool bPending;
+	};
+
+	// the samples of one scope name over the history
+	struct SCOPE_HISTORY
+	{
+		std::string name;
+		std::vector<double> cpuTimes;
+		std::vector<double> gpuTimes;
+	};
+
+	bool m_bInitialized;
+	bool m_bShowOverlay;
+	std::chrono::steady_clock::time_point m_startTime;
+	// offset between the GPU clock and the CPU clock, in milliseconds
+	double m_gpuClockOffset;
+	FRAME_RECORD m_frames[QUERY_FRAMES];
+	int m_currentFrame;
+	int m_openScopes;
+	std::vector<SCOPE_HISTORY> m_history;
+	// resolved frames kept for the Chrome trace export
+	std::vector<std::vector<SCOPE_RECORD>> m_traceFrames;
+	int m_nextTraceFrame;
+	// true when the last BeginFrame() read back the GPU times of a frame
+	bool m_bGpuResolved;
+
+	// get the CPU time since the profiler started, in milliseconds
+	double CpuTime() const;
+	// read back the queries of a finished frame into the history
+	void ResolveFrame(FRAME_RECORD& frame);
+	// add one sample to the history of a scope name
+	void AddSample(const char* name, double cpuTime, double gpuTime);
+	// get a percentile of a list of samples
+	static double Percentile(std::vector<double> samples, double percentile);
+
+public:
+	// create the timestamp queries
+	void Initialize();
+	// free the timestamp queries
+	void Destroy();
+
+	// start and finish measuring a frame
+	void BeginFrame();
+	void EndFrame();
+	// start and finish measuring a named scope, the returned index is
+	// passed to EndScope() and the name must stay valid until exported
+	int BeginScope(const char* name);
+	void EndScope(int scope);
+
+	// get the rolling statistics of every scope name
+	void GetStatistics(std::vector<SCOPE_STATISTICS>& statistics) const;
+	// get a one line summary of the frame scopes
+	std::string GetSummary() const;
+	// get the GPU time of a scope of the frame read back by the last BeginFrame()
+	bool GetResolvedGpuTime(const char* name, double& gpuTime) const;
+
+	// show or hide the overlay
+	void ToggleOverlay();
+	// draw the named scope times as bars and numbers over the framebuffer
+	void DrawOverlay(int width, int height) const;
+	// write the recorded frames as a Chrome trace JSON file
+	bool ExportChromeTrace(const char* filename) const;
+};
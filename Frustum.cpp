@@ -0,0 +1,181 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustum.cpp
+// ============
+// test bounding volumes against the view frustum - culling
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "Frustum.h"
+
+#include <cmath>
+
+/***********************************************************
+ *  Frustum()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+Frustum::Frustum()
+{
+	// until the planes are set, every box is inside
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		m_planes[i] = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+/***********************************************************
+ *  SetViewProjection()
+ *
+ *  This method is used for taking the frustum planes out of
+ *  a combined view-projection matrix.  Each plane is the
+ *  sum or difference of the fourth row and one of the other
+ *  rows of the matrix, which works for perspective and
+ *  orthographic projections alike.
+ ***********************************************************/
+void Frustum::SetViewProjection(const glm::mat4& viewProjection)
+{
+	glm::vec4 rows[4];
+
+	// glm matrices are stored by column
+	for (int i = 0; i < 4; i++)
+	{
+		rows[i] = glm::vec4(
+			viewProjection[0][i],
+			viewProjection[1][i],
+			viewProjection[2][i],
+			viewProjection[3][i]);
+	}
+
+	m_planes[PLANE_LEFT] = rows[3] + rows[0];
+	m_planes[PLANE_RIGHT] = rows[3] - rows[0];
+	m_planes[PLANE_BOTTOM] = rows[3] + rows[1];
+	m_planes[PLANE_TOP] = rows[3] - rows[1];
+	m_planes[PLANE_NEAR] = rows[3] + rows[2];
+	m_planes[PLANE_FAR] = rows[3] - rows[2];
+
+	// normalize the planes so the distances are in world units
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		float length = glm::length(glm::vec3(m_planes[i]));
+		if (length > 0.0f)
+		{
+			m_planes[i] = m_planes[i] / length;
+		}
+	}
+}
+
+/***********************************************************
+ *  GetPlane()
+ *
+ *  This method is used for getting one of the frustum
+ *  planes, with the normal pointing inside in xyz and the
+ *  distance from the origin in w.
+ ***********************************************************/
+const glm::vec4& Frustum::GetPlane(int plane) const
+{
+	return(m_planes[plane]);
+}
+
+/***********************************************************
+ *  IsBoxVisible()
+ *
+ *  This method is used for checking whether any part of a
+ *  bounding box may be inside the frustum.  For every plane
+ *  only the corner of the box farthest along the plane
+ *  normal is tested, and the box is outside as soon as that
+ *  corner is behind one of the planes.  Boxes that cross a
+ *  corner of the frustum can be reported visible, which
+ *  only costs a draw that the GPU clips away.
+ ***********************************************************/
+bool Frustum::IsBoxVisible(const BOUNDING_BOX& box) const
+{
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		const glm::vec4& plane = m_planes[i];
+		glm::vec3 corner;
+
+		corner.x = (plane.x >= 0.0f) ? box.max.x : box.min.x;
+		corner.y = (plane.y >= 0.0f) ? box.max.y : box.min.y;
+		corner.z = (plane.z >= 0.0f) ? box.max.z : box.min.z;
+
+		if (glm::dot(glm::vec3(plane), corner) + plane.w < 0.0f)
+		{
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  ClassifyBox()
+ *
+ *  This method is used for checking whether a bounding box
+ *  is outside, crossing or fully inside the frustum.  Along
+ *  with the farthest corner of the box, the nearest corner
+ *  is tested too, and the box is only fully inside when its
+ *  nearest corner is in front of every plane.  Everything
+ *  inside a box that is fully inside is visible without
+ *  testing it again.
+ ***********************************************************/
+Frustum::BOX_CLASS Frustum::ClassifyBox(const BOUNDING_BOX& box) const
+{
+	BOX_CLASS result = BOX_INSIDE;
+
+	for (int i = 0; i < PLANE_COUNT; i++)
+	{
+		const glm::vec4& plane = m_planes[i];
+		glm::vec3 farCorner;
+		glm::vec3 nearCorner;
+
+		farCorner.x = (plane.x >= 0.0f) ? box.max.x : box.min.x;
+		farCorner.y = (plane.y >= 0.0f) ? box.max.y : box.min.y;
+		farCorner.z = (plane.z >= 0.0f) ? box.max.z : box.min.z;
+		nearCorner.x = (plane.x >= 0.0f) ? box.min.x : box.max.x;
+		nearCorner.y = (plane.y >= 0.0f) ? box.min.y : box.max.y;
+		nearCorner.z = (plane.z >= 0.0f) ? box.min.z : box.max.z;
+
+		if (glm::dot(glm::vec3(plane), farCorner) + plane.w < 0.0f)
+		{
+			return(BOX_OUTSIDE);
+		}
+		if (glm::dot(glm::vec3(plane), nearCorner) + plane.w < 0.0f)
+		{
+			result = BOX_INTERSECTING;
+		}
+	}
+
+	return(result);
+}
+
+/***********************************************************
+ *  TransformBox()
+ *
+ *  This method is used for getting the axis aligned box that
+ *  holds a box after it has been moved, rotated and scaled
+ *  by the passed in transform.  The center is transformed
+ *  and the half sizes are spread over the axes by the
+ *  absolute values of the rotation and scale.
+ ***********************************************************/
+Frustum::BOUNDING_BOX Frustum::TransformBox(const BOUNDING_BOX& box, const glm::mat4& transform)
+{
+	BOUNDING_BOX result;
+	glm::vec3 center = (box.min + box.max) * 0.5f;
+	glm::vec3 extent = (box.max - box.min) * 0.5f;
+	glm::vec3 newCenter = glm::vec3(transform * glm::vec4(center, 1.0f));
+	glm::vec3 newExtent = glm::vec3(0.0f);
+
+	for (int column = 0; column < 3; column++)
+	{
+		for (int row = 0; row < 3; row++)
+		{
+			newExtent[row] += std::fabs(transform[column][row]) * extent[column];
+		}
+	}
+
+	result.min = newCenter - newExtent;
+	result.max = newCenter + newExtent;
+
+	return(result);
+}
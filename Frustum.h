@@ -0,0 +1,71 @@
+///////////////////////////////////////////////////////////////////////////////
+// frustum.h
+// ============
+// test bounding volumes against the view frustum - culling
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <glm/glm.hpp>
+
+/***********************************************************
+ *  Frustum
+ *
+ *  This class holds the six planes of a view frustum, taken
+ *  from a view-projection matrix, and tests axis aligned
+ *  bounding boxes against them.
+ ***********************************************************/
+class Frustum
+{
+public:
+	// constructor
+	Frustum();
+
+	// axis aligned bounding box
+	struct BOUNDING_BOX
+	{
+		glm::vec3 min;
+		glm::vec3 max;
+	};
+
+	// where a box is found relative to the frustum
+	enum BOX_CLASS
+	{
+		BOX_OUTSIDE = 0,
+		BOX_INTERSECTING,
+		BOX_INSIDE
+	};
+
+	// the planes of the frustum
+	enum FRUSTUM_PLANE
+	{
+		PLANE_LEFT = 0,
+		PLANE_RIGHT,
+		PLANE_BOTTOM,
+		PLANE_TOP,
+		PLANE_NEAR,
+		PLANE_FAR,
+		PLANE_COUNT
+	};
+
+private:
+	// plane normals in xyz and distances in w, normals point inside
+	glm::vec4 m_planes[PLANE_COUNT];
+
+public:
+	// set the planes from a combined view-projection matrix
+	void SetViewProjection(const glm::mat4& viewProjection);
+
+	// get one of the planes, normal in xyz and distance in w
+	const glm::vec4& GetPlane(int plane) const;
+
+	// check whether any part of the box may be inside the frustum
+	bool IsBoxVisible(const BOUNDING_BOX& box) const;
+	// check whether the box is outside, crossing or fully inside the frustum
+	BOX_CLASS ClassifyBox(const BOUNDING_BOX& box) const;
+
+	// get the bounding box of a box after it is transformed
+	static BOUNDING_BOX TransformBox(const BOUNDING_BOX& box, const glm::mat4& transform);
+};
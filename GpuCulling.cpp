@@ -0,0 +1,469 @@
+///////////////////////////////////////////////////////////////////////////////
+// gpuculling.cpp
+// ============
+// cull instances and fill indirect draw commands with a compute shader
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "GpuCulling.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cstddef>
+#include <iostream>
+
+// declaration of global variables and defines
+namespace
+{
+	// tests every instance against the frustum planes and the
+	// smallest screen size, and appends the visible instances
+	// to the range reserved for the command of their level of
+	// detail, instances with no command are streamed out and
+	// always skipped, lodScreenRadii has one radius for every
+	// coarser level of MeshBuffer::LOD_COUNT
+	const char* g_CullComputeShader =
+		"#version 430 core\n"
+		"layout (local_size_x = 64) in;\n"
+		"struct CullInstance\n"
+		"{\n"
+		"	mat4 model;\n"
+		"	vec4 color;\n"
+		"	vec2 uvScale;\n"
+		"	int materialIndex;\n"
+		"	int textureLayer;\n"
+		"	float lodFade;\n"
+		"	vec4 boundsMin;\n"
+		"	vec4 boundsMax;\n"
+		"	ivec4 command;\n"
+		"};\n"
+		"struct Instance\n"
+		"{\n"
+		"	mat4 model;\n"
+		"	vec4 color;\n"
+		"	vec2 uvScale;\n"
+		"	int materialIndex;\n"
+		"	int textureLayer;\n"
+		"	float lodFade;\n"
+		"};\n"
+		"struct Command\n"
+		"{\n"
+		"	uint count;\n"
+		"	uint instanceCount;\n"
+		"	uint firstIndex;\n"
+		"	int baseVertex;\n"
+		"	uint baseInstance;\n"
+		"};\n"
+		"layout (std430) readonly buffer CullInstanceBlock { CullInstance cullInstances[]; };\n"
+		"layout (std430) writeonly buffer InstanceBlock { Instance instances[]; };\n"
+		"layout (std430) buffer CommandBlock { Command commands[]; };\n"
+		"uniform vec4 frustumPlanes[6];\n"
+		"uniform uint instanceCount;\n"
+		"uniform bool bFrustumCulling;\n"
+		"uniform vec4 viewDepthRow;\n"
+		"uniform float pixelScale;\n"
+		"uniform bool bPerspective;\n"
+		"uniform float minScreenRadius;\n"
+		"uniform float lodScreenRadii[2];\n"
+		"uniform float lodFadeBand;\n"
+		"void AppendInstance(uint id, int command, float lodFade)\n"
+		"{\n"
+		"	uint slot = atomicAdd(commands[command].instanceCount, 1u);\n"
+		"	uint index = commands[command].baseInstance + slot;\n"
+		"	instances[index].model = cullInstances[id].model;\n"
+		"	instances[index].color = cullInstances[id].color;\n"
+		"	instances[index].uvScale = cullInstances[id].uvScale;\n"
+		"	instances[index].materialIndex = cullInstances[id].materialIndex;\n"
+		"	instances[index].textureLayer = cullInstances[id].textureLayer;\n"
+		"	instances[index].lodFade = lodFade;\n"
+		"}\n"
+		"void main()\n"
+		"{\n"
+		"	uint id = gl_GlobalInvocationID.x;\n"
+		"	if ((id >= instanceCount) || (cullInstances[id].command.x < 0))\n"
+		"		return;\n"
+		"	vec3 boundsMin = cullInstances[id].boundsMin.xyz;\n"
+		"	vec3 boundsMax = cullInstances[id].boundsMax.xyz;\n"
+		"	if (bFrustumCulling)\n"
+		"	{\n"
+		"		for (int i = 0; i < 6; i++)\n"
+		"		{\n"
+		"			vec3 corner = mix(boundsMin, boundsMax, step(0.0, frustumPlanes[i].xyz));\n"
+		"			if (dot(frustumPlanes[i].xyz, corner) + frustumPlanes[i].w < 0.0)\n"
+		"				return;\n"
+		"		}\n"
+		"	}\n"
+		"	float radius = length(boundsMax - boundsMin) * 0.5;\n"
+		"	float screenRadius = radius * pixelScale;\n"
+		"	float viewDepth = -dot(viewDepthRow, cullInstances[id].model[3]);\n"
+		"	if (bPerspective)\n"
+		"		screenRadius = (viewDepth > radius) ? (screenRadius / viewDepth) : 1.0e30;\n"
+		"	if ((minScreenRadius > 0.0) && (screenRadius < minScreenRadius))\n"
+		"		return;\n"
+		"	int lod = 0;\n"
+		"	float blend = 0.0;\n"
+		"	for (int level = 0; (level < 2) && (level + 1 < cullInstances[id].command.y); level++)\n"
+		"	{\n"
+		"		float upper = lodScreenRadii[level] * (1.0 + lodFadeBand);\n"
+		"		float lower = lodScreenRadii[level] * (1.0 - lodFadeBand);\n"
+		"		if (screenRadius >= upper)\n"
+		"			break;\n"
+		"		if (screenRadius > lower)\n"
+		"		{\n"
+		"			blend = (upper - screenRadius) / (upper - lower);\n"
+		"			break;\n"
+		"		}\n"
+		"		lod = level + 1;\n"
+		"	}\n"
+		"	int command = cullInstances[id].command.x + lod;\n"
+		"	AppendInstance(id, command, -blend);\n"
+		"	if (blend > 0.0)\n"
+		"		AppendInstance(id, command + 1, blend);\n"
+		"}\n";
+}
+
+/***********************************************************
+ *  GpuCulling()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+GpuCulling::GpuCulling()
+{
+	m_cullProgram = 0;
+	m_frustumPlanesLocation = -1;
+	m_instanceCountLocation = -1;
+	m_frustumCullingLocation = -1;
+	m_viewDepthRowLocation = -1;
+	m_pixelScaleLocation = -1;
+	m_perspectiveLocation = -1;
+	m_minScreenRadiusLocation = -1;
+	m_lodScreenRadiiLocation = -1;
+	m_lodFadeBandLocation = -1;
+	m_instanceBinding = 0;
+	m_cullInstanceBuffer = 0;
+	m_instanceBuffer = 0;
+	m_commandBuffer = 0;
+	m_instanceCount = 0;
+}
+
+/***********************************************************
+ *  ~GpuCulling()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+GpuCulling::~GpuCulling()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking whether the driver can
+ *  run the culling compute shader.  The OpenGL 3.3 context
+ *  created on macOS has no compute shaders, so the instances
+ *  are culled on the CPU there.
+ ***********************************************************/
+bool GpuCulling::IsSupported()
+{
+	return((GLEW_ARB_compute_shader) && (GLEW_ARB_shader_storage_buffer_object));
+}
+
+/***********************************************************
+ *  CreateCullProgram()
+ *
+ *  This method is used for compiling and linking the
+ *  culling compute program.
+ ***********************************************************/
+GLuint GpuCulling::CreateCullProgram()
+{
+	GLuint shader = glCreateShader(GL_COMPUTE_SHADER);
+	GLuint program = 0;
+	GLint success = 0;
+
+	glShaderSource(shader, 1, &g_CullComputeShader, NULL);
+	glCompileShader(shader);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		std::cout << "Could not compile the culling compute shader" << std::endl;
+		glDeleteShader(shader);
+		return(0);
+	}
+
+	program = glCreateProgram();
+	glAttachShader(program, shader);
+	glLinkProgram(program);
+	glDeleteShader(shader);
+
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		std::cout << "Could not link the culling compute shader" << std::endl;
+		glDeleteProgram(program);
+		return(0);
+	}
+
+	return(program);
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating the culling compute
+ *  program and attaching its storage blocks.  The culled
+ *  instances are written to the buffer bound to the passed
+ *  in binding point, which is where the scene shader reads
+ *  the instances of the indirect draws.
+ ***********************************************************/
+bool GpuCulling::Initialize(GLuint instanceBinding)
+{
+	Destroy();
+
+	m_cullProgram = CreateCullProgram();
+	if (0 == m_cullProgram)
+	{
+		return(false);
+	}
+
+	m_instanceBinding = instanceBinding;
+	glShaderStorageBlockBinding(m_cullProgram,
+		glGetProgramResourceIndex(m_cullProgram, GL_SHADER_STORAGE_BLOCK, "CullInstanceBlock"),
+		CULL_INSTANCE_BLOCK_BINDING);
+	glShaderStorageBlockBinding(m_cullProgram,
+		glGetProgramResourceIndex(m_cullProgram, GL_SHADER_STORAGE_BLOCK, "InstanceBlock"),
+		m_instanceBinding);
+	glShaderStorageBlockBinding(m_cullProgram,
+		glGetProgramResourceIndex(m_cullProgram, GL_SHADER_STORAGE_BLOCK, "CommandBlock"),
+		COMMAND_BLOCK_BINDING);
+
+	m_frustumPlanesLocation = glGetUniformLocation(m_cullProgram, "frustumPlanes");
+	m_instanceCountLocation = glGetUniformLocation(m_cullProgram, "instanceCount");
+	m_frustumCullingLocation = glGetUniformLocation(m_cullProgram, "bFrustumCulling");
+	m_viewDepthRowLocation = glGetUniformLocation(m_cullProgram, "viewDepthRow");
+	m_pixelScaleLocation = glGetUniformLocation(m_cullProgram, "pixelScale");
+	m_perspectiveLocation = glGetUniformLocation(m_cullProgram, "bPerspective");
+	m_minScreenRadiusLocation = glGetUniformLocation(m_cullProgram, "minScreenRadius");
+	m_lodScreenRadiiLocation = glGetUniformLocation(m_cullProgram, "lodScreenRadii");
+	m_lodFadeBandLocation = glGetUniformLocation(m_cullProgram, "lodFadeBand");
+
+	glGenBuffers(1, &m_cullInstanceBuffer);
+	glGenBuffers(1, &m_instanceBuffer);
+	glGenBuffers(1, &m_commandBuffer);
+
+	std::cout << "Culling the scene instances on the GPU" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the compute program and
+ *  the buffers.
+ ***********************************************************/
+void GpuCulling::Destroy()
+{
+	if (0 != m_cullProgram)
+	{
+		glDeleteProgram(m_cullProgram);
+		m_cullProgram = 0;
+	}
+	if (0 != m_cullInstanceBuffer)
+	{
+		glDeleteBuffers(1, &m_cullInstanceBuffer);
+		m_cullInstanceBuffer = 0;
+	}
+	if (0 != m_instanceBuffer)
+	{
+		glDeleteBuffers(1, &m_instanceBuffer);
+		m_instanceBuffer = 0;
+	}
+	if (0 != m_commandBuffer)
+	{
+		glDeleteBuffers(1, &m_commandBuffer);
+		m_commandBuffer = 0;
+	}
+
+	m_commandTemplates.clear();
+	m_instanceCount = 0;
+}
+
+/***********************************************************
+ *  SetInstances()
+ *
+ *  This method is used for setting the instances to cull
+ *  and the commands they are drawn by.  The base instance of
+ *  every command is the start of the range reserved for its
+ *  instances, and the instance buffer is sized to hold the
+ *  reserved range of every command at once.
+ ***********************************************************/
+void GpuCulling::SetInstances(
+	const std::vector<CULL_INSTANCE>& instances,
+	const std::vector<MeshBuffer::DRAW_COMMAND>& commands)
+{
+	size_t reservedCount = instances.size();
+
+	m_instanceCount = instances.size();
+	m_commandTemplates = commands;
+
+	for (int i = 0; i < m_commandTemplates.size(); i++)
+	{
+		reservedCount = std::max(reservedCount, (size_t)(m_commandTemplates[i].baseInstance + m_commandTemplates[i].instanceCount));
+		m_commandTemplates[i].instanceCount = 0;
+	}
+
+	if (m_instanceCount == 0)
+	{
+		return;
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_cullInstanceBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, instances.size() * sizeof(CULL_INSTANCE), instances.data(), GL_DYNAMIC_DRAW);
+
+	// the culled instances leave out the bounds, which come last
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_instanceBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, reservedCount * offsetof(CULL_INSTANCE, boundsMin), NULL, GL_DYNAMIC_COPY);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glBufferData(GL_DRAW_INDIRECT_BUFFER, m_commandTemplates.size() * sizeof(MeshBuffer::DRAW_COMMAND), m_commandTemplates.data(), GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+/***********************************************************
+ *  UpdateInstances()
+ *
+ *  This method is used for updating the values and bounds
+ *  of the instances after some of them have moved.  The
+ *  instances have to be in the same order and use the same
+ *  commands as when they were set.
+ ***********************************************************/
+void GpuCulling::UpdateInstances(const std::vector<CULL_INSTANCE>& instances)
+{
+	if ((m_instanceCount == 0) || (instances.size() != m_instanceCount))
+	{
+		return;
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_cullInstanceBuffer);
+	glBufferSubData(GL_SHADER_STORAGE_BUFFER, 0, instances.size() * sizeof(CULL_INSTANCE), instances.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/***********************************************************
+ *  UpdateInstanceRange()
+ *
+ *  This method is used for updating the values and bounds
+ *  of the instances starting at the passed in index, so
+ *  only the moved part of the buffer is uploaded.
+ ***********************************************************/
+void GpuCulling::UpdateInstanceRange(int first, const std::vector<CULL_INSTANCE>& instances)
+{
+	if ((first < 0) || (instances.empty()) || (first + instances.size() > m_instanceCount))
+	{
+		return;
+	}
+
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_cullInstanceBuffer);
+	glBufferSubData(
+		GL_SHADER_STORAGE_BUFFER,
+		first * sizeof(CULL_INSTANCE),
+		instances.size() * sizeof(CULL_INSTANCE),
+		instances.data());
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+}
+
+/***********************************************************
+ *  Dispatch()
+ *
+ *  This method is used for culling the instances of the
+ *  frame.  The instance counts of the commands are reset,
+ *  one compute thread tests every instance, and the barrier
+ *  makes the written instances and commands visible to the
+ *  indirect draws that follow.
+ ***********************************************************/
+void GpuCulling::Dispatch(const CULL_PARAMETERS& parameters)
+{
+	GLint previousProgram = 0;
+	glm::vec4 planes[Frustum::PLANE_COUNT];
+	// the row of the view matrix that gives the view depth
+	glm::vec4 viewDepthRow(
+		parameters.view[0][2],
+		parameters.view[1][2],
+		parameters.view[2][2],
+		parameters.view[3][2]);
+
+	if (m_instanceCount == 0)
+	{
+		return;
+	}
+
+	for (int i = 0; i < Frustum::PLANE_COUNT; i++)
+	{
+		planes[i] = parameters.pFrustum->GetPlane(i);
+	}
+
+	// every command starts the frame with no instances
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+	glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0, m_commandTemplates.size() * sizeof(MeshBuffer::DRAW_COMMAND), m_commandTemplates.data());
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &previousProgram);
+	glUseProgram(m_cullProgram);
+
+	glUniform4fv(m_frustumPlanesLocation, Frustum::PLANE_COUNT, glm::value_ptr(planes[0]));
+	glUniform1ui(m_instanceCountLocation, m_instanceCount);
+	glUniform1i(m_frustumCullingLocation, parameters.bFrustumCulling);
+	glUniform4fv(m_viewDepthRowLocation, 1, glm::value_ptr(viewDepthRow));
+	glUniform1f(m_pixelScaleLocation, parameters.pixelScale);
+	glUniform1i(m_perspectiveLocation, parameters.bPerspective);
+	glUniform1f(m_minScreenRadiusLocation, parameters.minScreenRadius);
+	glUniform1fv(m_lodScreenRadiiLocation, MeshBuffer::LOD_COUNT - 1, parameters.lodScreenRadii);
+	glUniform1f(m_lodFadeBandLocation, parameters.lodFadeBand);
+
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CULL_INSTANCE_BLOCK_BINDING, m_cullInstanceBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_instanceBinding, m_instanceBuffer);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, COMMAND_BLOCK_BINDING, m_commandBuffer);
+
+	glDispatchCompute((m_instanceCount + WORK_GROUP_SIZE - 1) / WORK_GROUP_SIZE, 1, 1);
+	glMemoryBarrier(GL_COMMAND_BARRIER_BIT | GL_SHADER_STORAGE_BARRIER_BIT);
+
+	glUseProgram(previousProgram);
+}
+
+/***********************************************************
+ *  BindForDrawing()
+ *
+ *  This method is used for binding the culled instances for
+ *  the scene shader and the commands as the indirect draw
+ *  buffer.
+ ***********************************************************/
+void GpuCulling::BindForDrawing() const
+{
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, m_instanceBinding, m_instanceBuffer);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+}
+
+/***********************************************************
+ *  IsReady()
+ *
+ *  This method is used for checking whether the compute
+ *  program was created and there are instances to cull.
+ ***********************************************************/
+bool GpuCulling::IsReady() const
+{
+	return((0 != m_cullProgram) && (m_instanceCount > 0));
+}
+
+/***********************************************************
+ *  GetCommandCount()
+ *
+ *  This method is used for getting the number of commands
+ *  the culled instances are drawn by.
+ ***********************************************************/
+int GpuCulling::GetCommandCount() const
+{
+	return(m_commandTemplates.size());
+}
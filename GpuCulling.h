@@ -0,0 +1,144 @@
+///////////////////////////////////////////////////////////////////////////////
+// gpuculling.h
+// ============
+// cull instances and fill indirect draw commands with a compute shader
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Frustum.h"
+#include "MeshBuffer.h"
+
+#include <GL/glew.h>
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  GpuCulling
+ *
+ *  This class culls instances on the GPU.  The values and
+ *  bounds of every instance are kept in a storage buffer,
+ *  and every frame a compute shader tests them against the
+ *  view frustum and the smallest screen size, copies the
+ *  visible ones into the instance buffer the scene shader
+ *  reads, and counts them into the instance counts of the
+ *  indirect draw commands.  Each command has a range of the
+ *  instance buffer reserved for all of its instances, so the
+ *  commands never need to be read back by the CPU.
+ *
+ *  A mesh with levels of detail has one command for every
+ *  level, next to each other, and the screen size picks the
+ *  command an instance is counted into.  In the crossfade
+ *  band of a level it is counted into the next one as well.
+ ***********************************************************/
+class GpuCulling
+{
+public:
+	// constructor
+	GpuCulling();
+	// destructor
+	~GpuCulling();
+
+	// number of instances tested by each compute work group
+	static const int WORK_GROUP_SIZE = 64;
+	// storage block binding points of the culled instances and the commands
+	static const GLuint CULL_INSTANCE_BLOCK_BINDING = 4;
+	static const GLuint COMMAND_BLOCK_BINDING = 5;
+
+	// values and bounds of one instance, laid out to match the
+	// std430 CullInstanceBlock storage buffer
+	struct CULL_INSTANCE
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+		glm::vec2 uvScale;
+		int materialIndex;
+		int textureLayer;
+		// written by the compute shader for a crossfade
+		float lodFade;
+		int instancePadding[3];
+		glm::vec4 boundsMin;
+		glm::vec4 boundsMax;
+		// command of the first level of detail the instance is
+		// drawn by, or -1 to skip it
+		int commandIndex;
+		// levels of detail, their commands follow the first one
+		int levelCount;
+		int padding[2];
+	};
+
+	// the frame values the instances are culled with
+	struct CULL_PARAMETERS
+	{
+		const Frustum* pFrustum;
+		bool bFrustumCulling;
+		glm::mat4 view;
+		// projection scale from world units to pixels
+		float pixelScale;
+		bool bPerspective;
+		// smallest projected radius kept, in pixels, or 0 for all
+		float minScreenRadius;
+		// projected radius in pixels below which each coarser level
+		// of detail is drawn, and the part of it that is crossfaded
+		float lodScreenRadii[MeshBuffer::LOD_COUNT - 1];
+		float lodFadeBand;
+	};
+
+private:
+	// the compute program and its uniform locations
+	GLuint m_cullProgram;
+	GLint m_frustumPlanesLocation;
+	GLint m_instanceCountLocation;
+	GLint m_frustumCullingLocation;
+	GLint m_viewDepthRowLocation;
+	GLint m_pixelScaleLocation;
+	GLint m_perspectiveLocation;
+	GLint m_minScreenRadiusLocation;
+	GLint m_lodScreenRadiiLocation;
+	GLint m_lodFadeBandLocation;
+	// binding point of the instance buffer the scene shader reads
+	GLuint m_instanceBinding;
+	// instances to cull, culled instances and commands
+	GLuint m_cullInstanceBuffer;
+	GLuint m_instanceBuffer;
+	GLuint m_commandBuffer;
+	// the commands with no instances, copied in before culling
+	std::vector<MeshBuffer::DRAW_COMMAND> m_commandTemplates;
+	int m_instanceCount;
+
+	// compile and link the culling compute program
+	GLuint CreateCullProgram();
+
+public:
+	// check whether the driver can run the culling compute shader
+	static bool IsSupported();
+
+	// create the compute program, the culled instances go to the binding point
+	bool Initialize(GLuint instanceBinding);
+	// free the program and the buffers
+	void Destroy();
+
+	// set the instances and the commands they are drawn by
+	void SetInstances(
+		const std::vector<CULL_INSTANCE>& instances,
+		const std::vector<MeshBuffer::DRAW_COMMAND>& commands);
+	// update the values and bounds of the instances
+	void UpdateInstances(const std::vector<CULL_INSTANCE>& instances);
+	// update the values and bounds of a range of the instances
+	void UpdateInstanceRange(int first, const std::vector<CULL_INSTANCE>& instances);
+
+	// cull the instances and fill the commands of the frame
+	void Dispatch(const CULL_PARAMETERS& parameters);
+	// bind the culled instances and the commands for drawing
+	void BindForDrawing() const;
+
+	// check whether there are instances to cull
+	bool IsReady() const;
+	// get the number of commands
+	int GetCommandCount() const;
+};
@@ -0,0 +1,207 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputqueue.cpp
+// ============
+// queue the keyboard and mouse events received from GLFW between frames
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "InputQueue.h"
+
+#include <cstring>
+
+// declaration of global variables and defines
+namespace
+{
+	// events that fit in the queue before it grows, enough for
+	// the events of a frame when the mouse moves are merged
+	const int g_ReservedEvents = 64;
+}
+
+/***********************************************************
+ *  InputQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+InputQueue::InputQueue()
+{
+	m_events.reserve(g_ReservedEvents);
+	memset(m_keysDown, 0, sizeof(m_keysDown));
+}
+
+/***********************************************************
+ *  ~InputQueue()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+InputQueue::~InputQueue()
+{
+	m_events.clear();
+}
+
+/***********************************************************
+ *  PushKey()
+ *
+ *  This method is used for queueing a key event, and for
+ *  tracking whether the key is held down.  Keys that GLFW
+ *  does not know are ignored.
+ ***********************************************************/
+void InputQueue::PushKey(int key, int action, int mods)
+{
+	if ((key < 0) || (key > GLFW_KEY_LAST))
+	{
+		return;
+	}
+
+	if (GLFW_PRESS == action)
+	{
+		m_keysDown[key] = true;
+	}
+	else if (GLFW_RELEASE == action)
+	{
+		m_keysDown[key] = false;
+	}
+
+	INPUT_EVENT event = {};
+	event.type = INPUT_KEY;
+	event.key = key;
+	event.action = action;
+	event.mods = mods;
+	m_events.push_back(event);
+}
+
+/***********************************************************
+ *  PushMouseMove()
+ *
+ *  This method is used for queueing a mouse move to the
+ *  passed in cursor position.  A move that follows another
+ *  move replaces its position, so the queue does not grow
+ *  with the rate the mouse reports at.
+ ***********************************************************/
+void InputQueue::PushMouseMove(double xPosition, double yPosition)
+{
+	if ((!m_events.empty()) && (INPUT_MOUSE_MOVE == m_events.back().type))
+	{
+		m_events.back().x = xPosition;
+		m_events.back().y = yPosition;
+		return;
+	}
+
+	INPUT_EVENT event = {};
+	event.type = INPUT_MOUSE_MOVE;
+	event.x = xPosition;
+	event.y = yPosition;
+	m_events.push_back(event);
+}
+
+/***********************************************************
+ *  PushMouseButton()
+ *
+ *  This method is used for queueing a mouse button event.
+ ***********************************************************/
+void InputQueue::PushMouseButton(int button, int action, int mods)
+{
+	INPUT_EVENT event = {};
+	event.type = INPUT_MOUSE_BUTTON;
+	event.key = button;
+	event.action = action;
+	event.mods = mods;
+	m_events.push_back(event);
+}
+
+/***********************************************************
+ *  PushScroll()
+ *
+ *  This method is used for queueing a mouse wheel event.
+ ***********************************************************/
+void InputQueue::PushScroll(double xOffset, double yOffset)
+{
+	INPUT_EVENT event = {};
+	event.type = INPUT_SCROLL;
+	event.x = xOffset;
+	event.y = yOffset;
+	m_events.push_back(event);
+}
+
+/***********************************************************
+ *  PushRefresh()
+ *
+ *  This method is used for queueing a request to draw the
+ *  window again, when it was resized or uncovered and its
+ *  contents have to be drawn even though nothing changed.
+ ***********************************************************/
+void InputQueue::PushRefresh()
+{
+	INPUT_EVENT event = {};
+	event.type = INPUT_REFRESH;
+	m_events.push_back(event);
+}
+
+/***********************************************************
+ *  GetEvent()
+ *  GetEventCount()
+ *
+ *  These methods are used for getting the events that were
+ *  queued since the queue was last cleared, in the order
+ *  they were received.
+ ***********************************************************/
+const InputQueue::INPUT_EVENT& InputQueue::GetEvent(int index) const
+{
+	return(m_events[index]);
+}
+
+int InputQueue::GetEventCount() const
+{
+	return((int)m_events.size());
+}
+
+/***********************************************************
+ *  WasKeyPressed()
+ *
+ *  This method is used for checking whether the passed in
+ *  key was pressed since the queue was last cleared.  The
+ *  repeats of a key that is held down are not counted, so a
+ *  key acts once for every press.
+ ***********************************************************/
+bool InputQueue::WasKeyPressed(int key) const
+{
+	for (int i = 0; i < m_events.size(); i++)
+	{
+		if ((INPUT_KEY == m_events[i].type) &&
+			(key == m_events[i].key) &&
+			(GLFW_PRESS == m_events[i].action))
+		{
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  IsKeyDown()
+ *
+ *  This method is used for checking whether the passed in
+ *  key is held down, as of the last event received for it.
+ ***********************************************************/
+bool InputQueue::IsKeyDown(int key) const
+{
+	if ((key < 0) || (key > GLFW_KEY_LAST))
+	{
+		return(false);
+	}
+
+	return(m_keysDown[key]);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing the events the frame
+ *  has handled.  The keys that are held down stay down
+ *  until their release events are received.
+ ***********************************************************/
+void InputQueue::Clear()
+{
+	m_events.clear();
+}
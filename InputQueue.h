@@ -0,0 +1,87 @@
+///////////////////////////////////////////////////////////////////////////////
+// inputqueue.h
+// ============
+// queue the keyboard and mouse events received from GLFW between frames
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <vector>
+
+// GLFW library
+#include "GLFW/glfw3.h"
+
+/***********************************************************
+ *  InputQueue
+ *
+ *  This class collects the events that the GLFW callbacks
+ *  receive while the events are polled or waited for, so
+ *  the frame can handle them in the order they happened
+ *  instead of asking GLFW for the state of every key each
+ *  frame.  The keys that are held down are tracked from the
+ *  press and release events, and a run of mouse moves is
+ *  kept as the last position only, since the camera only
+ *  needs how far the mouse went.  The queue is cleared once
+ *  the frame has handled its events.
+ ***********************************************************/
+class InputQueue
+{
+public:
+	// constructor
+	InputQueue();
+	// destructor
+	~InputQueue();
+
+	// the kinds of events that are queued
+	enum INPUT_EVENT_TYPE
+	{
+		INPUT_KEY = 0,
+		INPUT_MOUSE_MOVE,
+		INPUT_MOUSE_BUTTON,
+		INPUT_SCROLL,
+		INPUT_REFRESH
+	};
+
+	struct INPUT_EVENT
+	{
+		INPUT_EVENT_TYPE type;
+		// key or mouse button, and whether it was pressed,
+		// repeated or released
+		int key;
+		int action;
+		int mods;
+		// mouse position, or scroll offsets
+		double x;
+		double y;
+	};
+
+private:
+	// events received since the queue was last cleared
+	std::vector<INPUT_EVENT> m_events;
+	// true for every key that is held down
+	bool m_keysDown[GLFW_KEY_LAST + 1];
+
+public:
+	// queue a key event, and track whether the key is held down
+	void PushKey(int key, int action, int mods);
+	// queue a mouse move to the passed in cursor position
+	void PushMouseMove(double xPosition, double yPosition);
+	// queue a mouse button event
+	void PushMouseButton(int button, int action, int mods);
+	// queue a mouse wheel event
+	void PushScroll(double xOffset, double yOffset);
+	// queue a request to draw the window again, after it was resized or uncovered
+	void PushRefresh();
+
+	// get the queued events and the number of queued events
+	const INPUT_EVENT& GetEvent(int index) const;
+	int GetEventCount() const;
+	// check whether the passed in key was pressed since the queue was cleared
+	bool WasKeyPressed(int key) const;
+	// check whether the passed in key is held down
+	bool IsKeyDown(int key) const;
+	// remove the handled events, the held keys stay down
+	void Clear();
+};
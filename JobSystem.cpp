@@ -0,0 +1,316 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.cpp
+// ============
+// run the jobs of a frame across the cores with work stealing worker threads
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "JobSystem.h"
+
+#include <algorithm>
+
+// declaration of global variables and defines
+namespace
+{
+	// the job system and queue of a worker thread, so a worker
+	// adds its jobs to its own queue
+	thread_local const JobSystem* g_pWorkerJobSystem = NULL;
+	thread_local int g_WorkerQueueIndex = -1;
+
+	// parts a range is split into for every thread, so the
+	// threads that finish early can steal the rest
+	const int g_RangePartsPerThread = 4;
+}
+
+/***********************************************************
+ *  JobSystem()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+JobSystem::JobSystem()
+{
+	m_queuedJobs = 0;
+	m_bStopWorkers = false;
+}
+
+/***********************************************************
+ *  ~JobSystem()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+JobSystem::~JobSystem()
+{
+	StopWorkers();
+}
+
+/***********************************************************
+ *  StartWorkers()
+ *
+ *  This method is used for starting the worker threads, each
+ *  with its own job queue.  The queue shared by the threads
+ *  that are not workers is created after the worker queues.
+ ***********************************************************/
+void JobSystem::StartWorkers(int threadCount)
+{
+	if ((!m_workers.empty()) || (threadCount <= 0))
+	{
+		return;
+	}
+
+	m_bStopWorkers = false;
+	for (int i = 0; i <= threadCount; i++)
+	{
+		m_queues.push_back(new JOB_QUEUE());
+	}
+	for (int i = 0; i < threadCount; i++)
+	{
+		m_workers.push_back(std::thread(&JobSystem::WorkerLoop, this, i));
+	}
+}
+
+/***********************************************************
+ *  StopWorkers()
+ *
+ *  This method is used for stopping the worker threads once
+ *  they have run every queued job, and for freeing the job
+ *  queues.
+ ***********************************************************/
+void JobSystem::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+		m_bStopWorkers = true;
+	}
+	m_workAvailable.notify_all();
+
+	for (int i = 0; i < m_workers.size(); i++)
+	{
+		if (m_workers[i].joinable())
+		{
+			m_workers[i].join();
+		}
+	}
+	m_workers.clear();
+
+	for (int i = 0; i < m_queues.size(); i++)
+	{
+		delete m_queues[i];
+	}
+	m_queues.clear();
+	m_queuedJobs = 0;
+}
+
+/***********************************************************
+ *  GetThreadCount()
+ *
+ *  This method is used for getting the number of threads the
+ *  jobs are run on, which is the workers and the thread that
+ *  waits on them.
+ ***********************************************************/
+int JobSystem::GetThreadCount() const
+{
+	return(m_workers.size() + 1);
+}
+
+/***********************************************************
+ *  GetQueueIndex()
+ *
+ *  This method is used for getting the queue of the calling
+ *  thread, which is its own for a worker and the shared one
+ *  for any other thread.
+ ***********************************************************/
+int JobSystem::GetQueueIndex() const
+{
+	if (g_pWorkerJobSystem == this)
+	{
+		return(g_WorkerQueueIndex);
+	}
+
+	return(m_workers.size());
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method is used for running jobs on a worker thread,
+ *  sleeping while there are none, until the workers are
+ *  stopped and the queues are empty.
+ ***********************************************************/
+void JobSystem::WorkerLoop(int queueIndex)
+{
+	g_pWorkerJobSystem = this;
+	g_WorkerQueueIndex = queueIndex;
+
+	while (true)
+	{
+		JOB job;
+
+		if (PopJob(queueIndex, job))
+		{
+			RunJob(job);
+			continue;
+		}
+
+		std::unique_lock<std::mutex> lock(m_sleepMutex);
+		m_workAvailable.wait(lock, [this] { return(m_bStopWorkers || (m_queuedJobs > 0)); });
+		if (m_bStopWorkers && (m_queuedJobs == 0))
+		{
+			break;
+		}
+	}
+}
+
+/***********************************************************
+ *  PopJob()
+ *
+ *  This method is used for taking the newest job of the
+ *  passed in queue, or when it is empty the oldest job of the
+ *  next queue that has one.  False is returned when every
+ *  queue is empty.
+ ***********************************************************/
+bool JobSystem::PopJob(int queueIndex, JOB& job)
+{
+	JOB_QUEUE* pQueue = m_queues[queueIndex];
+
+	{
+		std::lock_guard<std::mutex> lock(pQueue->mutex);
+		if (!pQueue->jobs.empty())
+		{
+			job = pQueue->jobs.back();
+			pQueue->jobs.pop_back();
+			m_queuedJobs--;
+			return(true);
+		}
+	}
+
+	for (int i = 1; i < m_queues.size(); i++)
+	{
+		pQueue = m_queues[(queueIndex + i) % m_queues.size()];
+
+		std::lock_guard<std::mutex> lock(pQueue->mutex);
+		if (!pQueue->jobs.empty())
+		{
+			job = pQueue->jobs.front();
+			pQueue->jobs.pop_front();
+			m_queuedJobs--;
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  RunJob()
+ *
+ *  This method is used for running a job and counting it as
+ *  done in its group.
+ ***********************************************************/
+void JobSystem::RunJob(JOB& job)
+{
+	job.function();
+	job.pGroup->pending--;
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for adding a job to a group, on the
+ *  queue of the calling thread.  One sleeping worker is woken
+ *  up to take it.
+ ***********************************************************/
+void JobSystem::Run(JOB_GROUP& group, const JOB_FUNCTION& function)
+{
+	if (m_workers.empty())
+	{
+		function();
+		return;
+	}
+
+	JOB job;
+	JOB_QUEUE* pQueue = m_queues[GetQueueIndex()];
+
+	job.function = function;
+	job.pGroup = &group;
+	group.pending++;
+
+	{
+		std::lock_guard<std::mutex> lock(pQueue->mutex);
+		pQueue->jobs.push_back(job);
+		m_queuedJobs++;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock(m_sleepMutex);
+	}
+	m_workAvailable.notify_one();
+}
+
+/***********************************************************
+ *  ParallelFor()
+ *
+ *  This method is used for splitting a range of items into
+ *  parts of at least minRangeSize items, a few for every
+ *  thread, and adding a job to the group for each part.
+ ***********************************************************/
+void JobSystem::ParallelFor(JOB_GROUP& group, int count, int minRangeSize, const RANGE_FUNCTION& function)
+{
+	if (count <= 0)
+	{
+		return;
+	}
+
+	int parts = std::min(count / std::max(minRangeSize, 1), GetThreadCount() * g_RangePartsPerThread);
+	parts = std::max(parts, 1);
+	int rangeSize = (count + parts - 1) / parts;
+
+	for (int first = 0; first < count; first += rangeSize)
+	{
+		int rangeCount = std::min(rangeSize, count - first);
+		Run(group, [function, first, rangeCount] { function(first, rangeCount); });
+	}
+}
+
+/***********************************************************
+ *  Wait()
+ *
+ *  This method is used for waiting until every job of the
+ *  group is done.  The calling thread runs queued jobs while
+ *  it waits, which may belong to other groups.
+ ***********************************************************/
+void JobSystem::Wait(JOB_GROUP& group)
+{
+	// without workers every job already ran when it was added
+	if (m_workers.empty())
+	{
+		return;
+	}
+
+	int queueIndex = GetQueueIndex();
+
+	while (group.pending > 0)
+	{
+		JOB job;
+
+		if (PopJob(queueIndex, job))
+		{
+			RunJob(job);
+		}
+		else
+		{
+			std::this_thread::yield();
+		}
+	}
+}
+
+/***********************************************************
+ *  IsDone()
+ *
+ *  This method is used for checking whether every job of the
+ *  group is done, without waiting.
+ ***********************************************************/
+bool JobSystem::IsDone(const JOB_GROUP& group) const
+{
+	return(group.pending == 0);
+}
@@ -0,0 +1,107 @@
+///////////////////////////////////////////////////////////////////////////////
+// jobsystem.h
+// ============
+// run the jobs of a frame across the cores with work stealing worker threads
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  JobSystem
+ *
+ *  This class runs small jobs on a pool of worker threads.
+ *  Every worker has its own queue, runs its newest job first
+ *  and steals the oldest job of another queue once its own
+ *  is empty, so a job that splits itself into more jobs keeps
+ *  them on the same core until another core runs out of work.
+ *  Threads that are not workers, such as the one that owns
+ *  the OpenGL context, share one more queue.
+ *
+ *  Jobs are added to a job group, and waiting on the group
+ *  runs queued jobs until every job of the group is done, so
+ *  a job can wait on the jobs it added without blocking a
+ *  worker.  Without any workers, every job runs right away
+ *  on the thread that adds it.
+ ***********************************************************/
+class JobSystem
+{
+public:
+	// constructor
+	JobSystem();
+	// destructor
+	~JobSystem();
+
+	// jobs that are waited on together, it has to outlive its jobs
+	struct JOB_GROUP
+	{
+		std::atomic<int> pending;
+
+		JOB_GROUP() : pending(0) {}
+	};
+
+	// a job, and a job over a range of items
+	typedef std::function<void()> JOB_FUNCTION;
+	typedef std::function<void(int first, int count)> RANGE_FUNCTION;
+
+private:
+	// a queued job and the group it is counted in
+	struct JOB
+	{
+		JOB_FUNCTION function;
+		JOB_GROUP* pGroup;
+	};
+
+	// the jobs queued by one thread
+	struct JOB_QUEUE
+	{
+		std::mutex mutex;
+		std::deque<JOB> jobs;
+	};
+
+	// worker threads, and one queue for each worker followed
+	// by the queue shared by the other threads
+	std::vector<std::thread> m_workers;
+	std::vector<JOB_QUEUE*> m_queues;
+	// number of queued jobs that no thread has taken yet
+	std::atomic<int> m_queuedJobs;
+	// idle workers sleep until a job is queued or they are stopped
+	bool m_bStopWorkers;
+	std::mutex m_sleepMutex;
+	std::condition_variable m_workAvailable;
+
+	// run jobs until the workers are stopped
+	void WorkerLoop(int queueIndex);
+	// get the queue of the calling thread
+	int GetQueueIndex() const;
+	// take the newest job of a queue, or steal the oldest of another
+	bool PopJob(int queueIndex, JOB& job);
+	// run a job and count it as done in its group
+	void RunJob(JOB& job);
+
+public:
+	// start the passed in number of worker threads
+	void StartWorkers(int threadCount);
+	// finish the queued jobs, then stop and join all of the worker threads
+	void StopWorkers();
+	// get the number of threads that run jobs, the workers and the caller
+	int GetThreadCount() const;
+
+	// add a job to a group
+	void Run(JOB_GROUP& group, const JOB_FUNCTION& function);
+	// split a range of items into one job per part, none smaller than minRangeSize
+	void ParallelFor(JOB_GROUP& group, int count, int minRangeSize, const RANGE_FUNCTION& function);
+	// run queued jobs until every job of the group is done
+	void Wait(JOB_GROUP& group);
+	// check whether every job of the group is done
+	bool IsDone(const JOB_GROUP& group) const;
+};
@@ -0,0 +1,473 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightclusters.cpp
+// ============
+// bin the point lights into view space clusters for forward shading
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "LightClusters.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+// declaration of global variables and defines
+namespace
+{
+	// the depth slices never start closer than this, since they are logarithmic
+	const float g_MinSliceDepth = 0.01f;
+	// words of the cluster block taken by the header
+	const int g_HeaderWords = sizeof(LightClusters::CLUSTER_HEADER) / sizeof(uint32_t);
+
+	// the fragment shader code of the storage blocks and the cluster
+	// lookup, left out by drivers without storage buffers so the rest
+	// of the shader still compiles there
+	const char* const g_ClusterShaderSource = R"(
+#if __VERSION__ >= 430
+#define SCENE_CLUSTERED_LIGHTS 1
+
+struct ClusterLight
+{
+	vec4 positionRange;
+	vec4 ambient;
+	vec4 diffuse;
+	vec4 specular;
+};
+
+layout(std430) readonly buffer ClusterBlock
+{
+	uvec4 gridSize;
+	vec4 depthParameters;
+	vec4 tileParameters;
+	uvec2 clusters[];
+};
+
+layout(std430) readonly buffer LightIndexBlock
+{
+	uint lightIndices[];
+};
+
+layout(std430) readonly buffer ClusterLightBlock
+{
+	ClusterLight clusterLights[];
+};
+
+// light the fragment with the point lights binned into its cluster,
+// viewDepth is the positive distance in front of the camera
+vec3 CalcClusteredLights(
+	vec3 normal,
+	vec3 fragmentPosition,
+	vec3 viewDirection,
+	float viewDepth,
+	vec3 diffuseColor,
+	vec3 specularColor,
+	float shininess)
+{
+	vec2 tile = floor((gl_FragCoord.xy - tileParameters.zw) / tileParameters.xy);
+	tile = clamp(tile, vec2(0.0), vec2(gridSize.xy) - 1.0);
+	float slice = floor(log(max(viewDepth, depthParameters.z)) * depthParameters.x + depthParameters.y);
+	slice = clamp(slice, 0.0, float(gridSize.z) - 1.0);
+
+	uint cluster = uint(tile.x) + (uint(tile.y) + uint(slice) * gridSize.y) * gridSize.x;
+	uvec2 range = clusters[cluster];
+	vec3 result = vec3(0.0);
+
+	for (uint i = 0u; i < range.y; i++)
+	{
+		ClusterLight light = clusterLights[lightIndices[range.x + i]];
+		vec3 toLight = light.positionRange.xyz - fragmentPosition;
+		float lightDistance = length(toLight);
+
+		if (lightDistance >= light.positionRange.w)
+		{
+			continue;
+		}
+
+		// fade to nothing at the range, so the clusters past it can leave the light out
+		float fade = 1.0 - (lightDistance / light.positionRange.w);
+		vec3 lightDirection = toLight / max(lightDistance, 0.0001);
+		float diffuse = max(dot(normal, lightDirection), 0.0);
+		float specular = pow(max(dot(viewDirection, reflect(-lightDirection, normal)), 0.0), shininess);
+
+		result += (fade * fade) * (
+			(light.ambient.rgb * diffuseColor) +
+			(light.diffuse.rgb * diffuse * diffuseColor) +
+			(light.specular.rgb * specular * specularColor));
+	}
+
+	return(result);
+}
+#endif
+)";
+}
+
+/***********************************************************
+ *  LightClusters()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+LightClusters::LightClusters()
+{
+	m_clusterBuffer = 0;
+	m_lightIndexBuffer = 0;
+	m_lightBuffer = 0;
+	m_bLightsDirty = false;
+	m_lightReferences = 0;
+}
+
+/***********************************************************
+ *  ~LightClusters()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+LightClusters::~LightClusters()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating the storage buffers of
+ *  the clusters, the light indices and the lights.
+ ***********************************************************/
+void LightClusters::Initialize()
+{
+	Destroy();
+
+	glGenBuffers(1, &m_clusterBuffer);
+	glGenBuffers(1, &m_lightIndexBuffer);
+	glGenBuffers(1, &m_lightBuffer);
+
+	m_clusterData.assign(g_HeaderWords + (CLUSTER_COUNT * 2), 0);
+	m_bLightsDirty = true;
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the storage buffers.
+ ***********************************************************/
+void LightClusters::Destroy()
+{
+	if (0 != m_clusterBuffer)
+	{
+		glDeleteBuffers(1, &m_clusterBuffer);
+		m_clusterBuffer = 0;
+	}
+	if (0 != m_lightIndexBuffer)
+	{
+		glDeleteBuffers(1, &m_lightIndexBuffer);
+		m_lightIndexBuffer = 0;
+	}
+	if (0 != m_lightBuffer)
+	{
+		glDeleteBuffers(1, &m_lightBuffer);
+		m_lightBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  SetLights()
+ *
+ *  This method is used for setting the point lights that are
+ *  binned every frame.  They are uploaded with the next call
+ *  to Update().
+ ***********************************************************/
+void LightClusters::SetLights(const std::vector<CLUSTER_LIGHT>& lights)
+{
+	m_lights = lights;
+	m_bLightsDirty = true;
+}
+
+/***********************************************************
+ *  FindLightBins()
+ *
+ *  This method is used for finding the tiles and slices that
+ *  the range of a light reaches, as the first and last tile
+ *  across, down and in depth.  The tiles come from the eight
+ *  corners of the box around the range, projected onto the
+ *  screen, and a range that crosses the near plane of a
+ *  perspective view covers every tile.  False is returned
+ *  when the range is outside of the view.
+ ***********************************************************/
+bool LightClusters::FindLightBins(
+	const CLUSTER_LIGHT& light,
+	const CLUSTER_VIEW& view,
+	float nearPlane,
+	float sliceScale,
+	float sliceBias,
+	int bins[6]) const
+{
+	glm::vec3 center = glm::vec3(view.view * glm::vec4(glm::vec3(light.positionRange), 1.0f));
+	float radius = light.positionRange.w;
+	float minDepth = -center.z - radius;
+	float maxDepth = -center.z + radius;
+	float farPlane = expf((DEPTH_SLICES - sliceBias) / sliceScale);
+	bool bPerspective = (view.projection[3][3] == 0.0f);
+
+	if ((radius <= 0.0f) || (maxDepth < nearPlane) || (minDepth > farPlane))
+	{
+		return(false);
+	}
+
+	bins[4] = (int)floorf((logf(std::max(minDepth, nearPlane)) * sliceScale) + sliceBias);
+	bins[5] = (int)floorf((logf(std::min(maxDepth, farPlane)) * sliceScale) + sliceBias);
+	bins[4] = std::min(std::max(bins[4], 0), DEPTH_SLICES - 1);
+	bins[5] = std::min(std::max(bins[5], 0), DEPTH_SLICES - 1);
+
+	if (bPerspective && (minDepth <= nearPlane))
+	{
+		bins[0] = 0;
+		bins[1] = TILES_X - 1;
+		bins[2] = 0;
+		bins[3] = TILES_Y - 1;
+		return(true);
+	}
+
+	glm::vec2 screenMin = glm::vec2(1.0f);
+	glm::vec2 screenMax = glm::vec2(-1.0f);
+
+	for (int i = 0; i < 8; i++)
+	{
+		glm::vec3 corner = center + glm::vec3(
+			(i & 1) ? radius : -radius,
+			(i & 2) ? radius : -radius,
+			(i & 4) ? radius : -radius);
+		glm::vec4 clip = view.projection * glm::vec4(corner, 1.0f);
+		// every corner is in front of the near plane here
+		glm::vec2 screen = glm::vec2(clip.x / clip.w, clip.y / clip.w);
+
+		if (i == 0)
+		{
+			screenMin = screen;
+			screenMax = screen;
+		}
+		screenMin = glm::vec2(std::min(screenMin.x, screen.x), std::min(screenMin.y, screen.y));
+		screenMax = glm::vec2(std::max(screenMax.x, screen.x), std::max(screenMax.y, screen.y));
+	}
+
+	if ((screenMax.x < -1.0f) || (screenMin.x > 1.0f) || (screenMax.y < -1.0f) || (screenMin.y > 1.0f))
+	{
+		return(false);
+	}
+
+	bins[0] = (int)floorf((screenMin.x * 0.5f + 0.5f) * TILES_X);
+	bins[1] = (int)floorf((screenMax.x * 0.5f + 0.5f) * TILES_X);
+	bins[2] = (int)floorf((screenMin.y * 0.5f + 0.5f) * TILES_Y);
+	bins[3] = (int)floorf((screenMax.y * 0.5f + 0.5f) * TILES_Y);
+	bins[0] = std::min(std::max(bins[0], 0), TILES_X - 1);
+	bins[1] = std::min(std::max(bins[1], 0), TILES_X - 1);
+	bins[2] = std::min(std::max(bins[2], 0), TILES_Y - 1);
+	bins[3] = std::min(std::max(bins[3], 0), TILES_Y - 1);
+
+	return(true);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for binning the lights into the
+ *  clusters of the view and uploading the clusters.  The
+ *  lights are visited nearest first, and the clusters are
+ *  counted before they are filled, so the light indices of
+ *  every cluster are packed next to each other.  The cost
+ *  grows with the number of clusters each light reaches,
+ *  not with the number of lights times the pixels.  The
+ *  clusters are written into the frame's region of the
+ *  passed in dynamic buffer and bound by their offsets, so
+ *  the storage buffers are not reallocated every frame.
+ ***********************************************************/
+void LightClusters::Update(const CLUSTER_VIEW& view, DynamicBuffer* pDynamicBuffer)
+{
+	std::vector<std::pair<float, int>> order;
+	uint32_t* pClusters = NULL;
+	CLUSTER_HEADER header;
+	float nearPlane = 0.0f;
+	float farPlane = 0.0f;
+
+	if (!IsReady())
+	{
+		return;
+	}
+
+	// the depth range of the projection, either perspective or orthographic
+	if (view.projection[3][3] == 0.0f)
+	{
+		nearPlane = view.projection[3][2] / (view.projection[2][2] - 1.0f);
+		farPlane = view.projection[3][2] / (view.projection[2][2] + 1.0f);
+	}
+	else
+	{
+		nearPlane = (view.projection[3][2] + 1.0f) / view.projection[2][2];
+		farPlane = (view.projection[3][2] - 1.0f) / view.projection[2][2];
+	}
+	nearPlane = std::max(nearPlane, g_MinSliceDepth);
+	farPlane = std::max(farPlane, nearPlane * 2.0f);
+
+	float sliceScale = DEPTH_SLICES / logf(farPlane / nearPlane);
+	float sliceBias = -logf(nearPlane) * sliceScale;
+
+	m_lightBins.assign(m_lights.size() * 6, -1);
+	for (int i = 0; i < m_lights.size(); i++)
+	{
+		if (FindLightBins(m_lights[i], view, nearPlane, sliceScale, sliceBias, &m_lightBins[i * 6]))
+		{
+			glm::vec4 center = view.view * glm::vec4(glm::vec3(m_lights[i].positionRange), 1.0f);
+			order.push_back(std::make_pair(glm::length(glm::vec3(center)), i));
+		}
+	}
+	std::sort(order.begin(), order.end());
+
+	// count the lights of every cluster, then turn the counts
+	// into the first index of each cluster
+	std::fill(m_clusterData.begin(), m_clusterData.end(), 0);
+	pClusters = &m_clusterData[g_HeaderWords];
+
+	for (int pass = 0; pass < 2; pass++)
+	{
+		if (pass == 1)
+		{
+			uint32_t offset = 0;
+			for (int i = 0; i < CLUSTER_COUNT; i++)
+			{
+				pClusters[i * 2] = offset;
+				offset += pClusters[(i * 2) + 1];
+				pClusters[(i * 2) + 1] = 0;
+			}
+			m_lightIndices.assign(std::max(offset, 1u), 0);
+			m_lightReferences = offset;
+		}
+
+		for (int i = 0; i < order.size(); i++)
+		{
+			int lightIndex = order[i].second;
+			const int* pBins = &m_lightBins[lightIndex * 6];
+
+			for (int z = pBins[4]; z <= pBins[5]; z++)
+			{
+				for (int y = pBins[2]; y <= pBins[3]; y++)
+				{
+					for (int x = pBins[0]; x <= pBins[1]; x++)
+					{
+						uint32_t* pCluster = &pClusters[(x + ((y + (z * TILES_Y)) * TILES_X)) * 2];
+
+						if (pCluster[1] >= MAX_LIGHTS_PER_CLUSTER)
+						{
+							continue;
+						}
+						if (pass == 1)
+						{
+							m_lightIndices[pCluster[0] + pCluster[1]] = lightIndex;
+						}
+						pCluster[1]++;
+					}
+				}
+			}
+		}
+	}
+
+	header.gridSize[0] = TILES_X;
+	header.gridSize[1] = TILES_Y;
+	header.gridSize[2] = DEPTH_SLICES;
+	header.gridSize[3] = m_lights.size();
+	header.depthParameters[0] = sliceScale;
+	header.depthParameters[1] = sliceBias;
+	header.depthParameters[2] = nearPlane;
+	header.depthParameters[3] = farPlane;
+	header.tileParameters[0] = (float)std::max(view.viewportWidth, 1) / TILES_X;
+	header.tileParameters[1] = (float)std::max(view.viewportHeight, 1) / TILES_Y;
+	header.tileParameters[2] = (float)view.viewportX;
+	header.tileParameters[3] = (float)view.viewportY;
+	memcpy(&m_clusterData[0], &header, sizeof(header));
+
+	// the lights only change when they are set, the storage buffer can not be empty
+	if (m_bLightsDirty)
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_lightBuffer);
+		if (m_lights.empty())
+		{
+			glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(CLUSTER_LIGHT), NULL, GL_STATIC_DRAW);
+		}
+		else
+		{
+			glBufferData(GL_SHADER_STORAGE_BUFFER, m_lights.size() * sizeof(CLUSTER_LIGHT), m_lights.data(), GL_STATIC_DRAW);
+		}
+		m_bLightsDirty = false;
+	}
+
+	GLsizeiptr clusterSize = m_clusterData.size() * sizeof(uint32_t);
+	GLsizeiptr indexSize = m_lightIndices.size() * sizeof(uint32_t);
+	GLintptr clusterOffset = 0;
+	GLintptr indexOffset = 0;
+
+	if ((NULL != pDynamicBuffer) &&
+		(pDynamicBuffer->Upload(m_clusterData.data(), clusterSize, pDynamicBuffer->GetBindingAlignment(), clusterOffset)) &&
+		(pDynamicBuffer->Upload(m_lightIndices.data(), indexSize, pDynamicBuffer->GetBindingAlignment(), indexOffset)))
+	{
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, CLUSTER_BLOCK_BINDING, pDynamicBuffer->GetBuffer(), clusterOffset, clusterSize);
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, LIGHT_INDEX_BLOCK_BINDING, pDynamicBuffer->GetBuffer(), indexOffset, indexSize);
+	}
+	else
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_clusterBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, clusterSize, m_clusterData.data(), GL_STREAM_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_lightIndexBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, indexSize, m_lightIndices.data(), GL_STREAM_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_BLOCK_BINDING, m_clusterBuffer);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, LIGHT_INDEX_BLOCK_BINDING, m_lightIndexBuffer);
+	}
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, CLUSTER_LIGHT_BLOCK_BINDING, m_lightBuffer);
+}
+
+/***********************************************************
+ *  GetShaderSource()
+ *
+ *  This method is used for getting the fragment shader code
+ *  of the cluster lookup, which declares the three storage
+ *  blocks and CalcClusteredLights().  The code is inserted
+ *  ahead of the fragment source, and defines
+ *  SCENE_CLUSTERED_LIGHTS when the driver supports storage
+ *  buffers, so the shader only calls the lookup when it is
+ *  there and bUseClusteredLights is set.
+ ***********************************************************/
+const char* LightClusters::GetShaderSource()
+{
+	return(g_ClusterShaderSource);
+}
+
+/***********************************************************
+ *  IsReady()
+ *
+ *  This method is used for checking whether the storage
+ *  buffers have been created.
+ ***********************************************************/
+bool LightClusters::IsReady() const
+{
+	return(0 != m_clusterBuffer);
+}
+
+/***********************************************************
+ *  GetLightCount()
+ *
+ *  This method is used for getting the number of lights.
+ ***********************************************************/
+int LightClusters::GetLightCount() const
+{
+	return(m_lights.size());
+}
+
+/***********************************************************
+ *  GetLightReferences()
+ *
+ *  This method is used for getting the number of light
+ *  indices written for the last frame, which is how many
+ *  cluster and light pairs the shader can read.
+ ***********************************************************/
+int LightClusters::GetLightReferences() const
+{
+	return(m_lightReferences);
+}
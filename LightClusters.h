@@ -0,0 +1,139 @@
+///////////////////////////////////////////////////////////////////////////////
+// lightclusters.h
+// ============
+// bin the point lights into view space clusters for forward shading
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include "DynamicBuffer.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  LightClusters
+ *
+ *  This class splits the view frustum into a grid of screen
+ *  tiles and exponential depth slices, and every frame bins
+ *  the point lights into the clusters their range reaches.
+ *  The lights, the cluster ranges and the light indices are
+ *  kept in storage buffers, so the fragment shader only has
+ *  to loop over the lights of its own cluster:
+ *
+ *    tile  = (gl_FragCoord.xy - tileParameters.zw) / tileParameters.xy
+ *    slice = log(viewDepth) * depthParameters.x + depthParameters.y
+ *    range = clusters[tile.x + (tile.y + slice * gridSize.y) * gridSize.x]
+ *    light = lights[lightIndices[range.x + i]], i < range.y
+ *
+ *  Each light fades to nothing at its range, so it can be
+ *  left out of every cluster the range does not reach.  The
+ *  GLSL code of this lookup is returned by GetShaderSource()
+ *  and inserted ahead of the fragment shader.
+ ***********************************************************/
+class LightClusters
+{
+public:
+	// constructor
+	LightClusters();
+	// destructor
+	~LightClusters();
+
+	// screen tiles across and down, and depth slices of the grid
+	static const int TILES_X = 16;
+	static const int TILES_Y = 9;
+	static const int DEPTH_SLICES = 24;
+	static const int CLUSTER_COUNT = TILES_X * TILES_Y * DEPTH_SLICES;
+	// the most lights one cluster holds, the nearest are kept
+	static const int MAX_LIGHTS_PER_CLUSTER = 128;
+	// storage block binding points, after the GPU culling blocks
+	static const GLuint CLUSTER_BLOCK_BINDING = 6;
+	static const GLuint LIGHT_INDEX_BLOCK_BINDING = 7;
+	static const GLuint CLUSTER_LIGHT_BLOCK_BINDING = 8;
+
+	// one point light, laid out to match the std430 ClusterLightBlock
+	struct CLUSTER_LIGHT
+	{
+		// world position in xyz and range in w
+		glm::vec4 positionRange;
+		glm::vec4 ambient;
+		glm::vec4 diffuse;
+		glm::vec4 specular;
+	};
+
+	// the start of the std430 ClusterBlock, followed by the
+	// first light index and the light count of every cluster
+	struct CLUSTER_HEADER
+	{
+		uint32_t gridSize[4];
+		// log depth scale and bias that give the slice of a view depth
+		float depthParameters[4];
+		// pixels per tile in xy, and the viewport origin in zw
+		float tileParameters[4];
+	};
+
+	// the frame values the lights are binned with
+	struct CLUSTER_VIEW
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+		int viewportX;
+		int viewportY;
+		int viewportWidth;
+		int viewportHeight;
+	};
+
+private:
+	// storage buffers of the cluster ranges, the light indices and the lights
+	GLuint m_clusterBuffer;
+	GLuint m_lightIndexBuffer;
+	GLuint m_lightBuffer;
+	// the lights and whether they changed since they were uploaded
+	std::vector<CLUSTER_LIGHT> m_lights;
+	bool m_bLightsDirty;
+	// the cluster ranges and light indices of the frame
+	std::vector<uint32_t> m_clusterData;
+	std::vector<uint32_t> m_lightIndices;
+	// the clusters each light reaches, as tile and slice ranges
+	std::vector<int> m_lightBins;
+	// number of light indices written for the last frame
+	int m_lightReferences;
+
+	// find the tiles and slices the range of a light reaches
+	bool FindLightBins(
+		const CLUSTER_LIGHT& light,
+		const CLUSTER_VIEW& view,
+		float nearPlane,
+		float sliceScale,
+		float sliceBias,
+		int bins[6]) const;
+
+public:
+	// create the storage buffers
+	void Initialize();
+	// free the storage buffers
+	void Destroy();
+
+	// set the point lights that are binned every frame
+	void SetLights(const std::vector<CLUSTER_LIGHT>& lights);
+	// bin the lights into the clusters of the view and upload them,
+	// into the dynamic buffer when one is passed in and has room
+	void Update(const CLUSTER_VIEW& view, DynamicBuffer* pDynamicBuffer = NULL);
+
+	// get the fragment shader code of the storage blocks and the cluster lookup
+	static const char* GetShaderSource();
+
+	// check whether the storage buffers have been created
+	bool IsReady() const;
+	// get the number of lights
+	int GetLightCount() const;
+	// get the number of light indices written for the last frame
+	int GetLightReferences() const;
+};
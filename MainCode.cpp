@@ -1,186 +1,861 @@
-///////////////////////////////////////////////////////////////////////////////
-// maincode.cpp
-// ============
-// gets called when application is launched - initializes GLEW, GLFW
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include <iostream>         // error handling and output
-#include <cstdlib>          // EXIT_FAILURE
-
-#include <GL/glew.h>        // GLEW library
-#include "GLFW/glfw3.h"     // GLFW library
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>
-
-#include "SceneManager.h"
-#include "ViewManager.h"
-#include "ShapeMeshes.h"
-#include "ShaderManager.h"
-
-// Namespace for declaring global variables
-namespace
-{
-	// Macro for window title
-	const char* const WINDOW_TITLE = "Max's Project 7-1 CS-330"; 
-
-	// Main GLFW window
-	GLFWwindow* g_Window = nullptr;
-
-	// scene manager object for managing the 3D scene prepare and render
-	SceneManager* g_SceneManager = nullptr;
-	// shader manager object for dynamic interaction with the shader code
-	ShaderManager* g_ShaderManager = nullptr;
-	// view manager object for managing the 3D view setup and projection to 2D
-	ViewManager* g_ViewManager = nullptr;
-}
-
-// Function declarations - all functions that are called manually
-// need to be pre-declared at the beginning of the source code.
-bool InitializeGLFW();
-bool InitializeGLEW();
-
-
-/***********************************************************
- *  main(int, char*)
- *
- *  This function gets called after the application has been
- *  launched.
- ***********************************************************/
-int main(int argc, char* argv[])
-{
-	// if GLFW fails initialization, then terminate the application
-	if (InitializeGLFW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// try to create a new shader manager object
-	g_ShaderManager = new ShaderManager();
-	// try to create a new view manager object
-	g_ViewManager = new ViewManager(
-		g_ShaderManager);
-
-	// try to create the main display window
-	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
-
-	// if GLEW fails initialization, then terminate the application
-	if (InitializeGLEW() == false)
-	{
-		return(EXIT_FAILURE);
-	}
-
-	// load the shader code from the external GLSL files
-	g_ShaderManager->LoadShaders(
-		"shaders/vertexShader.glsl",
-		"shaders/fragmentShader.glsl");
-	g_ShaderManager->use();
-
-	// try to create a new scene manager object and prepare the 3D scene
-	g_SceneManager = new SceneManager(g_ShaderManager);
-	g_SceneManager->PrepareScene();
-
-	// loop will keep running until the application is closed 
-	// or until an error has occurred
-	while (!glfwWindowShouldClose(g_Window))
-	{
-		// Enable z-depth
-		glEnable(GL_DEPTH_TEST);
-
-		// Clear the frame and z buffers
-		glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-		glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-
-		// convert from 3D object space to 2D view
-		g_ViewManager->PrepareSceneView();
-
-		// refresh the 3D scene
-		g_SceneManager->RenderScene();
-
-
-		// Flips the the back buffer with the front buffer every frame.
-		glfwSwapBuffers(g_Window);
-
-		// query the latest GLFW events
-		glfwPollEvents();
-	}
-
-	// clear the allocated manager objects from memory
-	if (NULL != g_SceneManager)
-	{
-		delete g_SceneManager;
-		g_SceneManager = NULL;
-	}
-	if (NULL != g_ViewManager)
-	{
-		delete g_ViewManager;
-		g_ViewManager = NULL;
-	}
-	if (NULL != g_ShaderManager)
-	{
-		delete g_ShaderManager;
-		g_ShaderManager = NULL;
-	}
-
-	// Terminates the program successfully
-	exit(EXIT_SUCCESS); 
-}
-
-/***********************************************************
- *	InitializeGLFW()
- * 
- *  This function is used to initialize the GLFW library.   
- ***********************************************************/
-bool InitializeGLFW()
-{
-	// GLFW: initialize and configure library
-	// --------------------------------------
-	glfwInit();
-
-#ifdef __APPLE__
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
-	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
-#else
-	// set the version of OpenGL and profile to use
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
-	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
-	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
-#endif
-	// GLFW: end -------------------------------
-
-	return(true);
-}
-
-/***********************************************************
- *	InitializeGLEW()
- *
- *  This function is used to initialize the GLEW library.
- ***********************************************************/
-bool InitializeGLEW()
-{
-	// GLEW: initialize
-	// -----------------------------------------
-	GLenum GLEWInitResult = GLEW_OK;
-
-	// try to initialize the GLEW library
-	GLEWInitResult = glewInit();
-	if (GLEW_OK != GLEWInitResult)
-	{
-		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
-		return false;
-	}
-	// GLEW: end -------------------------------
-
-	// Displays a successful OpenGL initialization message
-	std::cout << "INFO: OpenGL Successfully Initialized\n";
-	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
-
-	return(true);
+///////////////////////////////////////////////////////////////////////////////
+// maincode.cpp
+// ============
+// gets called when application is launched - initializes GLEW, GLFW
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include <iostream>         // error handling and output
+#include <cstdlib>          // EXIT_FAILURE
+#include <cstring>          // command line parsing
+#include <cstdio>           // window title formatting
+#include <algorithm>        // std::min
+
+#include <GL/glew.h>        // GLEW library
+#include "GLFW/glfw3.h"     // GLFW library
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include "SceneManager.h"
+#include "ViewManager.h"
+#include "ShapeMeshes.h"
+#include "ShaderManager.h"
+#include "ShaderCache.h"
+#include "UniformCache.h"
+#include "FrameProfiler.h"
+#include "BenchmarkRunner.h"
+#include "RegressionSuite.h"
+#include "RenderTarget.h"
+#include "ResolutionController.h"
+#include "FramePacer.h"
+#include "LightClusters.h"
+
+// Namespace for declaring global variables
+namespace
+{
+	// Macro for window title
+	const char* const WINDOW_TITLE = "Max's Project 7-1 CS-330"; 
+
+	// Main GLFW window
+	GLFWwindow* g_Window = nullptr;
+
+	// scene manager object for managing the 3D scene prepare and render
+	SceneManager* g_SceneManager = nullptr;
+	// shader manager object for dynamic interaction with the shader code
+	ShaderManager* g_ShaderManager = nullptr;
+	// shader program built from cached binaries and reloaded when edited
+	ShaderCache* g_ShaderCache = nullptr;
+	// cached uniform locations and uniform buffers of the shader
+	UniformCache* g_UniformCache = nullptr;
+	// view manager object for managing the 3D view setup and projection to 2D
+	ViewManager* g_ViewManager = nullptr;
+	// profiler object for measuring the CPU and GPU time of the frame
+	FrameProfiler* g_FrameProfiler = nullptr;
+	// offscreen frame buffer the scene is rendered into at a scaled resolution
+	RenderTarget* g_RenderTarget = nullptr;
+	// controller that scales the resolution to the GPU time of the scene
+	ResolutionController* g_ResolutionController = nullptr;
+	// pacer that waits for the next frame, or sleeps while nothing changes
+	FramePacer* g_FramePacer = nullptr;
+
+	// file the profiler trace is written to
+	const char* const PROFILER_TRACE_FILE = "frame_trace.json";
+	// number of frames between window title updates
+	const int PROFILER_TITLE_FRAMES = 60;
+	// seconds between checks for edited shader files, which is
+	// also the longest the loop sleeps while nothing changes
+	const double SHADER_WATCH_INTERVAL = 0.5;
+	// frames rendered after the last change, for the frames the
+	// pipelining and the streaming still show one frame late
+	const int REDRAW_TRAILING_FRAMES = 2;
+	// source files of the scene shader program
+	const char* const VERTEX_SHADER_FILE = "shaders/vertexShader.glsl";
+	const char* const FRAGMENT_SHADER_FILE = "shaders/fragmentShader.glsl";
+
+	// true when running the offscreen benchmark instead of the interactive view
+	bool g_bBenchmark = false;
+	// number of frames rendered along the benchmark camera path
+	int g_BenchmarkFrames = 1000;
+	// number of frames rendered before the benchmark is recorded
+	const int BENCHMARK_WARMUP_FRAMES = 60;
+	// base name of the benchmark result files
+	const char* g_BenchmarkOutput = "benchmark";
+	// true when running the regression suite instead of the interactive view
+	bool g_bRegression = false;
+	// results of an earlier regression run to compare with, or NULL
+	const char* g_RegressionBaseline = NULL;
+	// part a regression case may be slower than its baseline
+	double g_RegressionTolerance = 0.15;
+	// compiled scene file to load, or NULL for the default
+	const char* g_SceneFile = NULL;
+	// megabytes of texture memory a streamed scene can use, or 0 for the default
+	int g_StreamingBudget = 0;
+	// scale of the window resolution the scene is rendered at, the
+	// largest scale when the resolution is dynamic
+	float g_RenderScale = 1.0f;
+	// true when the scale follows the GPU time of the scene
+	bool g_bDynamicResolution = true;
+	// GPU time the scene should fit in, which leaves room for the
+	// upscale and the rest of a 60 fps frame
+	double g_SceneGpuBudget = 14.0;
+	// smallest scale the dynamic resolution goes down to
+	const float DYNAMIC_RESOLUTION_MIN_SCALE = 0.5f;
+	// how the buffer swaps wait for the display refresh
+	FramePacer::VSYNC_MODE g_VsyncMode = FramePacer::VSYNC_ON;
+	// most frames rendered per second, or 0 for no cap
+	double g_FrameCap = 0.0;
+	// true when frames are only rendered when something changed
+	bool g_bRenderOnDemand = true;
+}
+
+// Function declarations - all functions that are called manually
+// need to be pre-declared at the beginning of the source code.
+bool InitializeGLFW();
+bool InitializeGLEW();
+bool ParseCommandLine(int argc, char* argv[]);
+void RenderFrame();
+void RunBenchmark();
+bool RunRegressionSuite();
+void ProcessProfilerKeys();
+void ProcessPicking();
+void LoadSceneShaders();
+bool ProcessShaderReload();
+
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function gets called after the application has been
+ *  launched.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	// if the command line is not valid, then terminate the application
+	if (ParseCommandLine(argc, argv) == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// if GLFW fails initialization, then terminate the application
+	if (InitializeGLFW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// the benchmarks render offscreen, so their window stays hidden
+	if (g_bBenchmark || g_bRegression)
+	{
+		glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+	}
+
+	// try to create a new shader manager object
+	g_ShaderManager = new ShaderManager();
+	// try to create a new uniform cache object
+	g_UniformCache = new UniformCache();
+	// try to create a new view manager object
+	g_ViewManager = new ViewManager(
+		g_ShaderManager,
+		g_UniformCache);
+
+	// try to create the main display window
+	g_Window = g_ViewManager->CreateDisplayWindow(WINDOW_TITLE);
+
+	// if GLEW fails initialization, then terminate the application
+	if (InitializeGLEW() == false)
+	{
+		return(EXIT_FAILURE);
+	}
+
+	// load the shader code from the external GLSL files
+	LoadSceneShaders();
+	// resolve the shader uniform locations once, up front
+	g_UniformCache->LoadUniforms();
+
+	// try to create a new profiler object for timing the frames
+	g_FrameProfiler = new FrameProfiler();
+	g_FrameProfiler->Initialize();
+
+	// the scene is rendered at a scale of the window resolution, and
+	// the benchmark keeps the scale fixed so its runs can be compared
+	g_RenderTarget = new RenderTarget();
+	g_RenderTarget->SetMaxScale(g_RenderScale);
+	g_ResolutionController = new ResolutionController();
+	g_ResolutionController->SetScaleRange(
+		std::min(DYNAMIC_RESOLUTION_MIN_SCALE, g_RenderTarget->GetMaxScale()),
+		g_RenderTarget->GetMaxScale());
+	g_ResolutionController->SetTargetTime(g_SceneGpuBudget);
+	g_ResolutionController->SetEnabled(g_bDynamicResolution && (!g_bBenchmark));
+
+	// the interactive view waits for the display and for input,
+	// the benchmark sets its own swap interval
+	g_FramePacer = new FramePacer();
+	g_FramePacer->SetVsyncMode(g_VsyncMode);
+	g_FramePacer->SetFrameCap(g_FrameCap);
+	g_FramePacer->SetRenderOnDemand(g_bRenderOnDemand);
+	g_FramePacer->SetIdleTimeout(SHADER_WATCH_INTERVAL);
+
+	// try to create a new scene manager object and prepare the 3D scene
+	g_SceneManager = new SceneManager(g_ShaderManager, g_UniformCache);
+	g_SceneManager->SetFrameProfiler(g_FrameProfiler);
+	if (NULL != g_SceneFile)
+	{
+		g_SceneManager->SetSceneFile(g_SceneFile);
+	}
+	if (g_StreamingBudget > 0)
+	{
+		g_SceneManager->SetStreamingBudget((size_t)g_StreamingBudget * 1024 * 1024);
+	}
+	g_SceneManager->PrepareScene();
+
+	int exitCode = EXIT_SUCCESS;
+	if (g_bBenchmark)
+	{
+		RunBenchmark();
+	}
+	else if (g_bRegression)
+	{
+		if (RunRegressionSuite() == false)
+		{
+			exitCode = EXIT_FAILURE;
+		}
+	}
+
+	int frameCount = 0;
+	int trailingFrames = REDRAW_TRAILING_FRAMES;
+	bool bChanging = true;
+	double shaderWatchTime = glfwGetTime() + SHADER_WATCH_INTERVAL;
+	InputQueue* pInputQueue = g_ViewManager->GetInputQueue();
+
+	// loop will keep running until the application is closed 
+	// or until an error has occurred
+	while ((!g_bBenchmark) && (!g_bRegression) && (!glfwWindowShouldClose(g_Window)))
+	{
+		// receive the events of the next frame, sleeping while
+		// nothing changes when the frames are rendered on demand
+		g_FramePacer->WaitForNextFrame(bChanging || (trailingFrames > 0));
+		ProcessProfilerKeys();
+
+		// rebuild the shaders once their files are saved
+		bool bShadersReloaded = false;
+		if (glfwGetTime() >= shaderWatchTime)
+		{
+			bShadersReloaded = ProcessShaderReload();
+			shaderWatchTime = glfwGetTime() + SHADER_WATCH_INTERVAL;
+		}
+
+		// a frame is rendered when there was input, the camera is
+		// moving or the scene is changing, and for a few frames
+		// after that
+		bChanging = g_ViewManager->IsCameraMoving() || g_SceneManager->IsSceneChanging();
+		bool bRedraw = (!g_FramePacer->IsRenderOnDemand()) || bChanging || bShadersReloaded ||
+			(pInputQueue->GetEventCount() > 0);
+		if (bRedraw)
+		{
+			trailingFrames = REDRAW_TRAILING_FRAMES;
+		}
+		else if (trailingFrames > 0)
+		{
+			trailingFrames--;
+			bRedraw = true;
+		}
+
+		if (bRedraw)
+		{
+			// draw the 3D scene and the profiler overlay
+			RenderFrame();
+			ProcessPicking();
+
+			// show the frame timings in the window title
+			frameCount++;
+			if ((frameCount % PROFILER_TITLE_FRAMES) == 0)
+			{
+				char scaleText[32];
+				snprintf(scaleText, sizeof(scaleText), " - scale %.2f - ", g_ResolutionController->GetScale());
+				std::string title = std::string(WINDOW_TITLE) + scaleText + g_FrameProfiler->GetSummary();
+				glfwSetWindowTitle(g_Window, title.c_str());
+			}
+		}
+
+		// the events of this frame have all been handled
+		pInputQueue->Clear();
+	}
+
+	// clear the allocated manager objects from memory
+	if (NULL != g_SceneManager)
+	{
+		delete g_SceneManager;
+		g_SceneManager = NULL;
+	}
+	if (NULL != g_ViewManager)
+	{
+		delete g_ViewManager;
+		g_ViewManager = NULL;
+	}
+	if (NULL != g_RenderTarget)
+	{
+		delete g_RenderTarget;
+		g_RenderTarget = NULL;
+	}
+	if (NULL != g_ResolutionController)
+	{
+		delete g_ResolutionController;
+		g_ResolutionController = NULL;
+	}
+	if (NULL != g_FramePacer)
+	{
+		delete g_FramePacer;
+		g_FramePacer = NULL;
+	}
+	if (NULL != g_FrameProfiler)
+	{
+		delete g_FrameProfiler;
+		g_FrameProfiler = NULL;
+	}
+	if (NULL != g_UniformCache)
+	{
+		delete g_UniformCache;
+		g_UniformCache = NULL;
+	}
+	if (NULL != g_ShaderCache)
+	{
+		delete g_ShaderCache;
+		g_ShaderCache = NULL;
+	}
+	if (NULL != g_ShaderManager)
+	{
+		delete g_ShaderManager;
+		g_ShaderManager = NULL;
+	}
+
+	// Terminates the program, failing when the regression suite
+	// found a case slower than its threshold
+	exit(exitCode); 
+}
+
+/***********************************************************
+ *	InitializeGLFW()
+ * 
+ *  This function is used to initialize the GLFW library.   
+ ***********************************************************/
+bool InitializeGLFW()
+{
+	// GLFW: initialize and configure library
+	// --------------------------------------
+	glfwInit();
+
+#ifdef __APPLE__
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
+	glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
+#else
+	// set the version of OpenGL and profile to use
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 4);
+	glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 6);
+	glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
+#endif
+	// GLFW: end -------------------------------
+
+	return(true);
+}
+
+/***********************************************************
+ *	InitializeGLEW()
+ *
+ *  This function is used to initialize the GLEW library.
+ ***********************************************************/
+bool InitializeGLEW()
+{
+	// GLEW: initialize
+	// -----------------------------------------
+	GLenum GLEWInitResult = GLEW_OK;
+
+	// try to initialize the GLEW library
+	GLEWInitResult = glewInit();
+	if (GLEW_OK != GLEWInitResult)
+	{
+		std::cerr << glewGetErrorString(GLEWInitResult) << std::endl;
+		return false;
+	}
+	// GLEW: end -------------------------------
+
+	// Displays a successful OpenGL initialization message
+	std::cout << "INFO: OpenGL Successfully Initialized\n";
+	std::cout << "INFO: OpenGL Version: " << glGetString(GL_VERSION) << "\n" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *	ParseCommandLine()
+ *
+ *  This function is used to read the command line options.
+ *
+ *    --benchmark [frames]      render the benchmark camera path
+ *    --benchmark-output name   base name of the result files
+ *    --regression [baseline]   run the regression suite, and
+ *                              compare with an earlier result
+ *    --regression-tolerance fraction
+ *                              part a case may be slower than
+ *                              its baseline
+ *    --scene file              compiled scene file to load
+ *    --stream-budget megabytes texture memory of a streamed scene
+ *    --render-scale scale      scale of the window resolution
+ *    --gpu-budget ms           GPU time of the scene for the
+ *                              dynamic resolution
+ *    --fixed-resolution        keep the render scale fixed
+ *    --vsync on|off|adaptive   wait for the display refresh
+ *    --frame-cap fps           most frames rendered per second
+ *    --continuous              render every frame, not only
+ *                              when something changed
+ ***********************************************************/
+bool ParseCommandLine(int argc, char* argv[])
+{
+	for (int i = 1; i < argc; i++)
+	{
+		if (strcmp(argv[i], "--benchmark") == 0)
+		{
+			g_bBenchmark = true;
+
+			// the number of frames is optional
+			if ((i + 1 < argc) && (atoi(argv[i + 1]) > 0))
+			{
+				g_BenchmarkFrames = atoi(argv[++i]);
+			}
+		}
+		else if ((strcmp(argv[i], "--benchmark-output") == 0) && (i + 1 < argc))
+		{
+			g_BenchmarkOutput = argv[++i];
+		}
+		else if (strcmp(argv[i], "--regression") == 0)
+		{
+			g_bRegression = true;
+
+			// the baseline file is optional
+			if ((i + 1 < argc) && (strncmp(argv[i + 1], "--", 2) != 0))
+			{
+				g_RegressionBaseline = argv[++i];
+			}
+		}
+		else if ((strcmp(argv[i], "--regression-tolerance") == 0) && (i + 1 < argc) && (atof(argv[i + 1]) >= 0.0))
+		{
+			g_RegressionTolerance = atof(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--scene") == 0) && (i + 1 < argc))
+		{
+			g_SceneFile = argv[++i];
+		}
+		else if ((strcmp(argv[i], "--stream-budget") == 0) && (i + 1 < argc) && (atoi(argv[i + 1]) > 0))
+		{
+			g_StreamingBudget = atoi(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--render-scale") == 0) && (i + 1 < argc) && (atof(argv[i + 1]) > 0.0))
+		{
+			g_RenderScale = (float)atof(argv[++i]);
+		}
+		else if ((strcmp(argv[i], "--gpu-budget") == 0) && (i + 1 < argc) && (atof(argv[i + 1]) > 0.0))
+		{
+			g_SceneGpuBudget = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--fixed-resolution") == 0)
+		{
+			g_bDynamicResolution = false;
+		}
+		else if ((strcmp(argv[i], "--vsync") == 0) && (i + 1 < argc) &&
+			((strcmp(argv[i + 1], "on") == 0) || (strcmp(argv[i + 1], "off") == 0) || (strcmp(argv[i + 1], "adaptive") == 0)))
+		{
+			i++;
+			if (strcmp(argv[i], "off") == 0)
+			{
+				g_VsyncMode = FramePacer::VSYNC_OFF;
+			}
+			else if (strcmp(argv[i], "adaptive") == 0)
+			{
+				g_VsyncMode = FramePacer::VSYNC_ADAPTIVE;
+			}
+			else
+			{
+				g_VsyncMode = FramePacer::VSYNC_ON;
+			}
+		}
+		else if ((strcmp(argv[i], "--frame-cap") == 0) && (i + 1 < argc) && (atof(argv[i + 1]) > 0.0))
+		{
+			g_FrameCap = atof(argv[++i]);
+		}
+		else if (strcmp(argv[i], "--continuous") == 0)
+		{
+			g_bRenderOnDemand = false;
+		}
+		else
+		{
+			std::cout << "Unknown option:" << argv[i] << std::endl;
+			std::cout << "Usage: " << argv[0] << " [--benchmark [frames]] [--benchmark-output name]"
+				<< " [--regression [baseline]] [--regression-tolerance fraction] [--scene file] [--stream-budget megabytes]"
+				<< " [--render-scale scale] [--gpu-budget ms] [--fixed-resolution]"
+				<< " [--vsync on|off|adaptive] [--frame-cap fps] [--continuous]" << std::endl;
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *	RenderFrame()
+ *
+ *  This function is used to render one frame of the scene,
+ *  with every phase of the frame measured by the profiler.
+ *  The scene is rendered at the scale picked from the GPU
+ *  time of an earlier frame, and upscaled to the window
+ *  before the overlay is drawn at the full resolution.
+ ***********************************************************/
+void RenderFrame()
+{
+	int scope = -1;
+	int framebufferWidth = 0;
+	int framebufferHeight = 0;
+	double sceneGpuTime = 0.0;
+
+	g_FrameProfiler->BeginFrame();
+	glfwGetFramebufferSize(g_Window, &framebufferWidth, &framebufferHeight);
+
+	// the times of the frame read back just now pick the scale
+	if (g_FrameProfiler->GetResolvedGpuTime("RenderScene", sceneGpuTime))
+	{
+		g_ResolutionController->Update(sceneGpuTime);
+	}
+	g_RenderTarget->Begin(framebufferWidth, framebufferHeight, g_ResolutionController->GetScale());
+
+	// Enable z-depth
+	glEnable(GL_DEPTH_TEST);
+
+	// Clear the frame and z buffers
+	scope = g_FrameProfiler->BeginScope("Clear");
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	g_FrameProfiler->EndScope(scope);
+
+	// convert from 3D object space to 2D view
+	scope = g_FrameProfiler->BeginScope("PrepareSceneView");
+	g_ViewManager->PrepareSceneView();
+	int viewCount = std::min(g_ViewManager->GetViewCount(), (int)SceneManager::MAX_VIEWS);
+	g_SceneManager->SetViewCount(viewCount);
+	for (int i = 0; i < viewCount; i++)
+	{
+		// the parts of the window are placed in the pixels of the
+		// render target, so the views follow the render scale
+		const glm::vec4& rect = g_ViewManager->GetViewRect(i);
+		int x = (int)(rect.x * g_RenderTarget->GetWidth() + 0.5f);
+		int y = (int)(rect.y * g_RenderTarget->GetHeight() + 0.5f);
+		int width = (int)((rect.x + rect.z) * g_RenderTarget->GetWidth() + 0.5f) - x;
+		int height = (int)((rect.y + rect.w) * g_RenderTarget->GetHeight() + 0.5f) - y;
+
+		g_SceneManager->SetViewParameters(
+			i,
+			g_ViewManager->GetViewMatrix(i),
+			g_ViewManager->GetProjectionMatrix(i),
+			g_ViewManager->GetViewPosition(i));
+		g_SceneManager->SetViewport(i, x, y, width, height);
+	}
+	g_FrameProfiler->EndScope(scope);
+
+	// refresh the 3D scene
+	scope = g_FrameProfiler->BeginScope("RenderScene");
+	g_SceneManager->RenderScene();
+	g_FrameProfiler->EndScope(scope);
+
+	// stretch the scaled scene over the window
+	scope = g_FrameProfiler->BeginScope("Upscale");
+	g_RenderTarget->End();
+	g_FrameProfiler->EndScope(scope);
+
+	// draw the profiler bars over the scene when shown
+	g_FrameProfiler->DrawOverlay(framebufferWidth, framebufferHeight);
+
+	// Flips the the back buffer with the front buffer every frame.
+	scope = g_FrameProfiler->BeginScope("SwapBuffers");
+	glfwSwapBuffers(g_Window);
+	g_FrameProfiler->EndScope(scope);
+
+	g_FrameProfiler->EndFrame();
+}
+
+/***********************************************************
+ *	RunBenchmark()
+ *
+ *  This function is used to render the benchmark camera path
+ *  into an offscreen frame buffer with vsync turned off, and
+ *  to write the recorded frame times and counts to files.
+ *  The textures are loaded and a few frames are rendered
+ *  before recording starts, so every run measures the same
+ *  frames with the same state.
+ ***********************************************************/
+void RunBenchmark()
+{
+	BenchmarkRunner benchmark(g_SceneManager, g_ViewManager, g_UniformCache, g_FrameProfiler);
+	int framebufferWidth = 0;
+	int framebufferHeight = 0;
+
+	// do not wait for the display refresh between frames
+	glfwSwapInterval(0);
+
+	glfwGetFramebufferSize(g_Window, &framebufferWidth, &framebufferHeight);
+	if (benchmark.CreateFramebuffer(framebufferWidth, framebufferHeight) == false)
+	{
+		return;
+	}
+
+	std::cout << "INFO: Benchmark " << g_BenchmarkFrames << " frames at "
+		<< framebufferWidth << "x" << framebufferHeight << std::endl;
+
+	// warm up at the start of the camera path until all the textures are loaded
+	int warmupFrames = 0;
+	benchmark.BeginRun(g_BenchmarkFrames);
+	while ((g_SceneManager->IsLoadingTextures() || (warmupFrames < BENCHMARK_WARMUP_FRAMES)) &&
+		(!glfwWindowShouldClose(g_Window)))
+	{
+		benchmark.BeginFrame(0);
+		RenderFrame();
+		benchmark.EndFrame();
+		glfwPollEvents();
+		g_ViewManager->GetInputQueue()->Clear();
+		warmupFrames++;
+	}
+
+	// record the camera path
+	benchmark.BeginRun(g_BenchmarkFrames);
+	for (int frame = 0; (frame < g_BenchmarkFrames) && (!glfwWindowShouldClose(g_Window)); frame++)
+	{
+		benchmark.BeginFrame(frame);
+		RenderFrame();
+		benchmark.EndFrame();
+		glfwPollEvents();
+		g_ViewManager->GetInputQueue()->Clear();
+	}
+	glFinish();
+
+	benchmark.WriteResults(g_BenchmarkOutput);
+	g_FrameProfiler->ExportChromeTrace((std::string(g_BenchmarkOutput) + "_trace.json").c_str());
+}
+
+/***********************************************************
+ *	RunRegressionSuite()
+ *
+ *  This function is used to time the scene pipeline parts
+ *  with vsync turned off, and to write the results to a JSON
+ *  file next to the benchmark files.  When a baseline is
+ *  passed in, the results are compared with it, and false
+ *  is returned when a case is slower than its threshold.
+ ***********************************************************/
+bool RunRegressionSuite()
+{
+	RegressionSuite regressionSuite(g_ShaderManager, g_UniformCache, g_ViewManager);
+
+	// do not wait for the display refresh between frames
+	glfwSwapInterval(0);
+
+	regressionSuite.SetTolerance(g_RegressionTolerance);
+	if ((NULL != g_RegressionBaseline) &&
+		(regressionSuite.LoadBaseline(g_RegressionBaseline) == false))
+	{
+		return(false);
+	}
+
+	regressionSuite.Run();
+	regressionSuite.WriteResults((std::string(g_BenchmarkOutput) + "_regression.json").c_str());
+
+	int regressions = regressionSuite.GetRegressionCount();
+	if (regressions > 0)
+	{
+		std::cout << "Regressions found:" << regressions << std::endl;
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *	LoadSceneShaders()
+ *
+ *  This function is used to build the scene shader program
+ *  and use it.  The program binary cached by an earlier
+ *  launch is loaded when the sources and driver still match,
+ *  otherwise the sources are compiled and cached.  The
+ *  number of point lights is passed to the shaders as a
+ *  compile time define.  When the program can not be built
+ *  here, the shader manager loads the shaders instead.
+ ***********************************************************/
+void LoadSceneShaders()
+{
+	std::vector<std::string> defines;
+
+	defines.push_back("SCENE_POINT_LIGHT_COUNT " + std::to_string(UniformCache::MAX_POINT_LIGHTS));
+
+	g_ShaderCache = new ShaderCache();
+	// the uniform blocks go ahead of both stages, and the cluster
+	// lookup of the clustered lights and the crossfade dither of
+	// the levels of detail ahead of the fragment code
+	GLuint programID = g_ShaderCache->LoadProgram(
+		VERTEX_SHADER_FILE,
+		FRAGMENT_SHADER_FILE,
+		defines,
+		UniformCache::GetShaderSource() + LightClusters::GetShaderSource() + SceneManager::GetLodFadeSource(),
+		UniformCache::GetShaderSource());
+
+	if (0 != programID)
+	{
+		glUseProgram(programID);
+	}
+	else
+	{
+		g_ShaderManager->LoadShaders(VERTEX_SHADER_FILE, FRAGMENT_SHADER_FILE);
+		g_ShaderManager->use();
+	}
+}
+
+/***********************************************************
+ *	ProcessShaderReload()
+ *
+ *  This function is used to rebuild the scene shader program
+ *  when one of its source files was saved, and to set the
+ *  scene up on the new program.  A program that does not
+ *  compile leaves the current one in use.  True is returned
+ *  when the new program is in use, so the frame is drawn
+ *  with it.
+ ***********************************************************/
+bool ProcessShaderReload()
+{
+	if ((NULL == g_ShaderCache) || (!g_ShaderCache->HaveSourcesChanged()))
+	{
+		return(false);
+	}
+
+	GLuint programID = g_ShaderCache->ReloadProgram();
+	if (0 == programID)
+	{
+		return(false);
+	}
+
+	glUseProgram(programID);
+	g_SceneManager->RestoreShaderState();
+
+	return(true);
+}
+
+/***********************************************************
+ *	ProcessPicking()
+ *
+ *  This function is used to pick the scene object that the
+ *  camera is looking at when the mouse has been clicked.
+ ***********************************************************/
+void ProcessPicking()
+{
+	glm::vec3 origin;
+	glm::vec3 direction;
+	float distance = 0.0f;
+
+	if (!g_ViewManager->GetPickRay(origin, direction))
+	{
+		return;
+	}
+
+	int objectIndex = g_SceneManager->PickObject(origin, direction, distance);
+	if (objectIndex >= 0)
+	{
+		std::cout << "Picked object " << objectIndex << " ("
+			<< g_SceneManager->GetObjectGroupName(objectIndex)
+			<< ") at distance " << distance << std::endl;
+	}
+	else
+	{
+		std::cout << "No object picked" << std::endl;
+	}
+}
+
+/***********************************************************
+ *	ProcessProfilerKeys()
+ *
+ *  This function is used to handle the profiler keys.  F1
+ *  shows or hides the profiler overlay, F2 writes the
+ *  recorded frames to a Chrome trace file, F3 turns the
+ *  measuring of every object group on or off, F4 turns
+ *  the frustum culling on or off, F5 turns the indirect
+ *  multi-draws on or off, F6 turns the compute shader
+ *  culling on or off, F7 turns the clustered lighting on
+ *  or off, F8 turns the shadows on or off, F9 turns the
+ *  pipelining of the frame preparation on or off for
+ *  comparing frame times, F10 turns the dynamic resolution
+ *  on or off and F11 switches between rendering on demand
+ *  and rendering every frame.  The keys are read from the
+ *  queued events, so they act once when pressed, not every
+ *  frame they are held down.
+ ***********************************************************/
+void ProcessProfilerKeys()
+{
+	static bool bProfileGroups = false;
+	static bool bFrustumCulling = true;
+	static bool bIndirectDraws = true;
+	static bool bGpuCulling = true;
+	static bool bClusteredLighting = true;
+	static bool bShadows = true;
+	static bool bFramePipelining = false;
+
+	const InputQueue* pInputQueue = g_ViewManager->GetInputQueue();
+
+	if (pInputQueue->WasKeyPressed(GLFW_KEY_F1))
+	{
+		g_FrameProfiler->ToggleOverlay();
+	}
+	if (pInputQueue->WasKeyPressed(GLFW_KEY_F2))
+	{
+		g_FrameProfiler->ExportChromeTrace(PROFILER_TRACE_FILE);
+	}
+	if (pInputQueue->WasKeyPressed(GLFW_KEY_F3))
+	{
+		bProfileGroups = !bProfileGroups;
+		g_SceneManager->SetGroupProfiling(bProfileGroups);
+	}
+	if (pInputQueue->WasKeyPressed(GLFW_KEY_F4))
+	{
+		bFrustumCulling = !bFrustumCulling;
+		g_SceneManager->SetFrustumCulling(bFrustumCulling);
+	}
+	if (pInputQueue->WasKeyPressed(GLFW_KEY_F5))
+	{
+		bIndirectDraws = !bIndirectDraws;
+		g_SceneManager->SetIndirectDraws(bIndirectDraws);
+	}
+	if (pInputQueue->WasKeyPressed(GLFW_KEY_F6))
+	{
+		bGpuCulling = !bGpuCulling;
+		g_SceneManager->SetGpuCulling(bGpuCulling);
+	}
+	if (pInputQueue->WasKeyPressed(GLFW_KEY_F7))
+	{
+		bClusteredLighting = !bClusteredLighting;
+		g_SceneManager->SetClusteredLighting(bClusteredLighting);
+	}
+	if (pInputQueue->WasKeyPressed(GLFW_KEY_F8))
+	{
+		bShadows = !bShadows;
+		g_SceneManager->SetShadows(bShadows);
+	}
+	if (pInputQueue->WasKeyPressed(GLFW_KEY_F9))
+	{
+		bFramePipelining = !bFramePipelining;
+		g_SceneManager->SetFramePipelining(bFramePipelining);
+	}
+	if (pInputQueue->WasKeyPressed(GLFW_KEY_F10))
+	{
+		g_ResolutionController->SetEnabled(!g_ResolutionController->IsEnabled());
+	}
+	if (pInputQueue->WasKeyPressed(GLFW_KEY_F11))
+	{
+		g_FramePacer->SetRenderOnDemand(!g_FramePacer->IsRenderOnDemand());
+	}
 }
\ No newline at end of file
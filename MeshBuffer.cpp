@@ -0,0 +1,812 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshbuffer.cpp
+// ============
+// pack the basic and imported meshes into shared vertex and index buffers
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshBuffer.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <unordered_map>
+
+// declaration of global variables and defines
+namespace
+{
+	// passes the attributes of the basic meshes straight through
+	// to the transform feedback outputs
+	const char* g_CaptureVertexShader =
+		"#version 330 core\n"
+		"layout (location = 0) in vec3 inVertexPosition;\n"
+		"layout (location = 1) in vec3 inVertexNormal;\n"
+		"layout (location = 2) in vec2 inTextureCoordinate;\n"
+		"out vec3 capturedPosition;\n"
+		"out vec3 capturedNormal;\n"
+		"out vec2 capturedTexCoord;\n"
+		"void main()\n"
+		"{\n"
+		"	capturedPosition = inVertexPosition;\n"
+		"	capturedNormal = inVertexNormal;\n"
+		"	capturedTexCoord = inTextureCoordinate;\n"
+		"	gl_Position = vec4(inVertexPosition, 1.0);\n"
+		"}\n";
+
+	// cells along the longest side of a mesh that the vertices of
+	// each coarser level of detail are merged into
+	const int g_LodGridSizes[MeshBuffer::LOD_COUNT - 1] = { 16, 8 };
+
+	// the outputs in the same order as the PACKED_VERTEX fields
+	const char* g_CaptureVaryings[3] =
+	{
+		"capturedPosition",
+		"capturedNormal",
+		"capturedTexCoord"
+	};
+
+	/***********************************************************
+	 *  VertexHash
+	 *
+	 *  This structure hashes the bytes of a quantized vertex,
+	 *  so captured vertices that quantize the same can be
+	 *  welded into one.
+	 ***********************************************************/
+	struct VertexHash
+	{
+		size_t operator()(const MESH_FILE_VERTEX& vertex) const
+		{
+			const unsigned char* bytes = (const unsigned char*)&vertex;
+			size_t hash = 2166136261u;
+
+			for (size_t i = 0; i < sizeof(MESH_FILE_VERTEX); i++)
+			{
+				hash = (hash ^ bytes[i]) * 16777619u;
+			}
+
+			return(hash);
+		}
+	};
+
+	/***********************************************************
+	 *  VertexEqual
+	 *
+	 *  This structure compares the bytes of two quantized
+	 *  vertices.
+	 ***********************************************************/
+	struct VertexEqual
+	{
+		bool operator()(const MESH_FILE_VERTEX& a, const MESH_FILE_VERTEX& b) const
+		{
+			return(0 == memcmp(&a, &b, sizeof(MESH_FILE_VERTEX)));
+		}
+	};
+
+	/***********************************************************
+	 *  WeldVertices()
+	 *
+	 *  This function is used for quantizing a triangle list and
+	 *  welding the vertices that quantize the same, appending
+	 *  the vertices and indices to the shared arrays.  The
+	 *  indices start from zero at the base vertex of the range.
+	 ***********************************************************/
+	void WeldVertices(
+		const MeshBuffer::PACKED_VERTEX* pTriangles,
+		GLuint vertexCount,
+		std::vector<MESH_FILE_VERTEX>& vertices,
+		std::vector<GLuint>& indices,
+		MeshBuffer::MESH_RANGE& range)
+	{
+		std::unordered_map<MESH_FILE_VERTEX, GLuint, VertexHash, VertexEqual> welded;
+
+		range.firstIndex = indices.size();
+		range.indexCount = vertexCount;
+		range.baseVertex = vertices.size();
+
+		for (GLuint i = 0; i < vertexCount; i++)
+		{
+			const MeshBuffer::PACKED_VERTEX& capturedVertex = pTriangles[i];
+			MESH_FILE_VERTEX vertex = MeshFile::QuantizeVertex(capturedVertex.position, capturedVertex.normal, capturedVertex.texCoord);
+			GLuint index = vertices.size() - range.baseVertex;
+
+			std::unordered_map<MESH_FILE_VERTEX, GLuint, VertexHash, VertexEqual>::iterator found = welded.find(vertex);
+			if (found != welded.end())
+			{
+				index = found->second;
+			}
+			else
+			{
+				welded[vertex] = index;
+				vertices.push_back(vertex);
+			}
+
+			indices.push_back(index);
+		}
+	}
+
+	/***********************************************************
+	 *  DecimateTriangles()
+	 *
+	 *  This function is used for building a coarser level of
+	 *  detail of a triangle list by vertex clustering.  The
+	 *  bounds of the mesh are split into a grid of the passed in
+	 *  number of cells along their longest side, and the
+	 *  vertices of a cell that face about the same way and sit
+	 *  on the same part of the texture are merged into their
+	 *  average.  Triangles with two corners in one cluster are
+	 *  dropped.  Keeping the facing and the texture apart keeps
+	 *  the hard edges and texture seams of the mesh.
+	 ***********************************************************/
+	void DecimateTriangles(
+		const MeshBuffer::PACKED_VERTEX* pTriangles,
+		GLuint vertexCount,
+		int gridSize,
+		std::vector<MeshBuffer::PACKED_VERTEX>& decimated)
+	{
+		std::unordered_map<uint64_t, int> cellClusters;
+		std::vector<MeshBuffer::PACKED_VERTEX> clusters;
+		std::vector<int> clusterCounts;
+		std::vector<int> vertexClusters(vertexCount);
+		glm::vec3 boundsMin(FLT_MAX);
+		glm::vec3 boundsMax(-FLT_MAX);
+
+		decimated.clear();
+
+		for (GLuint i = 0; i < vertexCount; i++)
+		{
+			const glm::vec3& position = pTriangles[i].position;
+
+			boundsMin = glm::vec3(std::min(boundsMin.x, position.x), std::min(boundsMin.y, position.y), std::min(boundsMin.z, position.z));
+			boundsMax = glm::vec3(std::max(boundsMax.x, position.x), std::max(boundsMax.y, position.y), std::max(boundsMax.z, position.z));
+		}
+
+		glm::vec3 extent = boundsMax - boundsMin;
+		float cellSize = std::max(std::max(extent.x, extent.y), extent.z) / gridSize;
+		if (!(cellSize > 0.0f))
+		{
+			return;
+		}
+
+		// sum up the vertices of every cluster
+		for (GLuint i = 0; i < vertexCount; i++)
+		{
+			const MeshBuffer::PACKED_VERTEX& vertex = pTriangles[i];
+			uint64_t cellX = std::min((int)((vertex.position.x - boundsMin.x) / cellSize), gridSize - 1);
+			uint64_t cellY = std::min((int)((vertex.position.y - boundsMin.y) / cellSize), gridSize - 1);
+			uint64_t cellZ = std::min((int)((vertex.position.z - boundsMin.z) / cellSize), gridSize - 1);
+			// each normal axis rounded to -1, 0 or 1
+			uint64_t facing =
+				(int)floorf(vertex.normal.x + 1.5f) +
+				((int)floorf(vertex.normal.y + 1.5f) * 3) +
+				((int)floorf(vertex.normal.z + 1.5f) * 9);
+			uint64_t texelU = (int)floorf(vertex.texCoord.x * gridSize) & 0x3ff;
+			uint64_t texelV = (int)floorf(vertex.texCoord.y * gridSize) & 0x3ff;
+			uint64_t key = cellX | (cellY << 10) | (cellZ << 20) | (facing << 30) | (texelU << 35) | (texelV << 45);
+
+			std::unordered_map<uint64_t, int>::iterator found = cellClusters.find(key);
+			if (found == cellClusters.end())
+			{
+				found = cellClusters.insert(std::make_pair(key, (int)clusters.size())).first;
+				clusters.push_back(vertex);
+				clusterCounts.push_back(1);
+			}
+			else
+			{
+				MeshBuffer::PACKED_VERTEX& cluster = clusters[found->second];
+
+				cluster.position += vertex.position;
+				cluster.normal += vertex.normal;
+				cluster.texCoord += vertex.texCoord;
+				clusterCounts[found->second]++;
+			}
+			vertexClusters[i] = found->second;
+		}
+
+		// every cluster becomes the average of its vertices
+		for (int i = 0; i < clusters.size(); i++)
+		{
+			MeshBuffer::PACKED_VERTEX& cluster = clusters[i];
+			float weight = 1.0f / clusterCounts[i];
+
+			cluster.position *= weight;
+			cluster.texCoord *= weight;
+			if (glm::length(cluster.normal) > 0.0f)
+			{
+				cluster.normal = glm::normalize(cluster.normal);
+			}
+		}
+
+		for (GLuint i = 0; i + 2 < vertexCount; i += 3)
+		{
+			int a = vertexClusters[i];
+			int b = vertexClusters[i + 1];
+			int c = vertexClusters[i + 2];
+
+			if ((a == b) || (b == c) || (a == c))
+			{
+				continue;
+			}
+
+			decimated.push_back(clusters[a]);
+			decimated.push_back(clusters[b]);
+			decimated.push_back(clusters[c]);
+		}
+	}
+}
+
+/***********************************************************
+ *  MeshBuffer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshBuffer::MeshBuffer()
+{
+	m_captureProgram = 0;
+	m_captureBuffer = 0;
+	m_writtenQuery = 0;
+	m_generatedQuery = 0;
+	m_previousProgram = 0;
+	m_capturedVertices = 0;
+	m_vertexArray = 0;
+	m_vertexBuffer = 0;
+	m_indexBuffer = 0;
+	m_vertexCount = 0;
+	m_indexCount = 0;
+}
+
+/***********************************************************
+ *  ~MeshBuffer()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MeshBuffer::~MeshBuffer()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking whether the driver can
+ *  draw many meshes from the shared buffers with one call,
+ *  which needs indirect multi-draws with a base instance.
+ ***********************************************************/
+bool MeshBuffer::IsSupported()
+{
+	return((GLEW_ARB_multi_draw_indirect) && (GLEW_ARB_base_instance));
+}
+
+/***********************************************************
+ *  CreateCaptureProgram()
+ *
+ *  This method is used for compiling and linking the vertex
+ *  only program that writes the attributes of every mesh
+ *  vertex into the capture buffer.
+ ***********************************************************/
+GLuint MeshBuffer::CreateCaptureProgram()
+{
+	GLuint shader = glCreateShader(GL_VERTEX_SHADER);
+	GLuint program = 0;
+	GLint success = 0;
+
+	glShaderSource(shader, 1, &g_CaptureVertexShader, NULL);
+	glCompileShader(shader);
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &success);
+	if (!success)
+	{
+		std::cout << "Could not compile the mesh capture shader" << std::endl;
+		glDeleteShader(shader);
+		return(0);
+	}
+
+	program = glCreateProgram();
+	glAttachShader(program, shader);
+	glTransformFeedbackVaryings(program, 3, g_CaptureVaryings, GL_INTERLEAVED_ATTRIBS);
+	glLinkProgram(program);
+	glDeleteShader(shader);
+
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		std::cout << "Could not link the mesh capture shader" << std::endl;
+		glDeleteProgram(program);
+		return(0);
+	}
+
+	return(program);
+}
+
+/***********************************************************
+ *  BeginCapture()
+ *
+ *  This method is used for getting ready to capture the
+ *  vertices of the passed in number of meshes.  Rasterizing
+ *  is turned off so the meshes drawn while capturing never
+ *  reach the screen.
+ ***********************************************************/
+bool MeshBuffer::BeginCapture(int meshCount)
+{
+	Destroy();
+
+	m_captureProgram = CreateCaptureProgram();
+	if (0 == m_captureProgram)
+	{
+		return(false);
+	}
+
+	glGenBuffers(1, &m_captureBuffer);
+	glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, m_captureBuffer);
+	glBufferData(GL_TRANSFORM_FEEDBACK_BUFFER, MAX_CAPTURE_VERTICES * sizeof(PACKED_VERTEX), NULL, GL_STATIC_READ);
+	glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, 0);
+
+	glGenQueries(1, &m_writtenQuery);
+	glGenQueries(1, &m_generatedQuery);
+
+	m_captureFirst.assign(meshCount, 0);
+	m_captureCount.assign(meshCount, 0);
+	m_capturedVertices = 0;
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &m_previousProgram);
+	glUseProgram(m_captureProgram);
+	glEnable(GL_RASTERIZER_DISCARD);
+
+	return(true);
+}
+
+/***********************************************************
+ *  BeginMesh()
+ *
+ *  This method is used for starting to capture the vertices
+ *  of a mesh into the capture buffer, right after the
+ *  vertices of the previously captured mesh.
+ ***********************************************************/
+void MeshBuffer::BeginMesh(int mesh)
+{
+	GLsizeiptr offset = m_capturedVertices * sizeof(PACKED_VERTEX);
+	GLsizeiptr remaining = (MAX_CAPTURE_VERTICES - m_capturedVertices) * sizeof(PACKED_VERTEX);
+
+	m_captureFirst[mesh] = m_capturedVertices;
+
+	glBindBufferRange(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_captureBuffer, offset, remaining);
+	glBeginQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN, m_writtenQuery);
+	glBeginQuery(GL_PRIMITIVES_GENERATED, m_generatedQuery);
+	glBeginTransformFeedback(GL_TRIANGLES);
+}
+
+/***********************************************************
+ *  EndMesh()
+ *
+ *  This method is used for stopping the capture of a mesh.
+ *  A mesh that did not fit into the capture buffer, or that
+ *  is not drawn as triangles, is left out of the shared
+ *  buffers and keeps being drawn from its own buffers.
+ ***********************************************************/
+void MeshBuffer::EndMesh(int mesh)
+{
+	GLuint written = 0;
+	GLuint generated = 0;
+
+	glEndTransformFeedback();
+	glEndQuery(GL_PRIMITIVES_GENERATED);
+	glEndQuery(GL_TRANSFORM_FEEDBACK_PRIMITIVES_WRITTEN);
+
+	// this only happens once while loading, so waiting is fine
+	glGetQueryObjectuiv(m_writtenQuery, GL_QUERY_RESULT, &written);
+	glGetQueryObjectuiv(m_generatedQuery, GL_QUERY_RESULT, &generated);
+
+	if ((written == 0) || (written != generated))
+	{
+		std::cout << "Mesh " << mesh << " is not drawn from the shared mesh buffer" << std::endl;
+		return;
+	}
+
+	m_captureCount[mesh] = written * 3;
+	m_capturedVertices += written * 3;
+}
+
+/***********************************************************
+ *  AddMeshFile()
+ *
+ *  This method is used for adding an imported mesh to the
+ *  shared buffers while capturing.  Its vertices and indices
+ *  are copied from the mapped file when the capture ends,
+ *  so the file has to stay open until then.  The returned
+ *  mesh index follows the indices of the captured meshes.
+ ***********************************************************/
+int MeshBuffer::AddMeshFile(const MeshFile* pMeshFile)
+{
+	m_meshFiles.push_back(pMeshFile);
+
+	return(m_captureCount.size() + m_meshFiles.size() - 1);
+}
+
+/***********************************************************
+ *  EndCapture()
+ *
+ *  This method is used for finishing the capture, reading
+ *  the captured vertices back and packing them into the
+ *  shared buffers.  The capture program and buffer are only
+ *  needed while loading and are freed afterwards.
+ ***********************************************************/
+bool MeshBuffer::EndCapture()
+{
+	std::vector<PACKED_VERTEX> captured(m_capturedVertices);
+
+	glDisable(GL_RASTERIZER_DISCARD);
+	glUseProgram(m_previousProgram);
+	glBindBufferBase(GL_TRANSFORM_FEEDBACK_BUFFER, 0, 0);
+
+	if (m_capturedVertices > 0)
+	{
+		glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, m_captureBuffer);
+		glGetBufferSubData(GL_TRANSFORM_FEEDBACK_BUFFER, 0, m_capturedVertices * sizeof(PACKED_VERTEX), captured.data());
+		glBindBuffer(GL_TRANSFORM_FEEDBACK_BUFFER, 0);
+	}
+
+	glDeleteQueries(1, &m_writtenQuery);
+	glDeleteQueries(1, &m_generatedQuery);
+	glDeleteBuffers(1, &m_captureBuffer);
+	glDeleteProgram(m_captureProgram);
+	m_writtenQuery = 0;
+	m_generatedQuery = 0;
+	m_captureBuffer = 0;
+	m_captureProgram = 0;
+
+	if ((m_capturedVertices == 0) && (m_meshFiles.empty()))
+	{
+		return(false);
+	}
+
+	BuildSharedBuffers(captured);
+	m_meshFiles.clear();
+
+	std::cout << "Packed the meshes into a shared buffer of " << m_vertexCount
+		<< " vertices and " << m_indexCount << " indices" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  BuildSharedBuffers()
+ *
+ *  This method is used for quantizing and welding the
+ *  captured vertices of every mesh back into indexed
+ *  triangles and uploading them into the shared vertex and
+ *  index buffers, followed by the imported meshes, which
+ *  are copied from their mapped files as they are.  The
+ *  indices of each mesh start from zero and are moved to the
+ *  vertices of the mesh with the base vertex of its draw
+ *  command.
+ *
+ *  The coarser levels of detail of every captured mesh are
+ *  decimated from its captured triangles and packed with the
+ *  captured meshes, but their ranges come after the imported
+ *  meshes, so the mesh indices of the imported meshes stay
+ *  the same.  A level is only kept when it has at most three
+ *  quarters of the triangles of the level before it, the
+ *  missing levels draw the coarsest level that was kept.
+ ***********************************************************/
+void MeshBuffer::BuildSharedBuffers(const std::vector<PACKED_VERTEX>& captured)
+{
+	std::vector<MESH_FILE_VERTEX> vertices;
+	std::vector<GLuint> indices;
+	std::vector<MESH_RANGE> lodRanges;
+	std::vector<PACKED_VERTEX> decimated;
+	GLintptr vertexOffset = 0;
+	GLintptr indexOffset = 0;
+	int meshCount = m_captureCount.size() + m_meshFiles.size();
+
+	m_meshRanges.resize(meshCount);
+	m_lodCounts.assign(meshCount, 1);
+	m_lodMeshes.resize(meshCount * LOD_COUNT);
+	for (int mesh = 0; mesh < meshCount; mesh++)
+	{
+		for (int lod = 0; lod < LOD_COUNT; lod++)
+		{
+			m_lodMeshes[(mesh * LOD_COUNT) + lod] = mesh;
+		}
+	}
+
+	for (int mesh = 0; mesh < m_captureCount.size(); mesh++)
+	{
+		if (m_captureCount[mesh] == 0)
+		{
+			m_meshRanges[mesh].firstIndex = indices.size();
+			m_meshRanges[mesh].indexCount = 0;
+			m_meshRanges[mesh].baseVertex = vertices.size();
+			continue;
+		}
+
+		const PACKED_VERTEX* pTriangles = &captured[m_captureFirst[mesh]];
+		size_t levelVertices = m_captureCount[mesh];
+
+		WeldVertices(pTriangles, m_captureCount[mesh], vertices, indices, m_meshRanges[mesh]);
+
+		for (int lod = 1; lod < LOD_COUNT; lod++)
+		{
+			MESH_RANGE range;
+
+			DecimateTriangles(pTriangles, m_captureCount[mesh], g_LodGridSizes[lod - 1], decimated);
+			if ((decimated.empty()) || ((decimated.size() * 4) > (levelVertices * 3)))
+			{
+				break;
+			}
+
+			WeldVertices(decimated.data(), decimated.size(), vertices, indices, range);
+			levelVertices = decimated.size();
+
+			// this level and the ones after it draw the new range
+			for (int level = lod; level < LOD_COUNT; level++)
+			{
+				m_lodMeshes[(mesh * LOD_COUNT) + level] = meshCount + lodRanges.size();
+			}
+			m_lodCounts[mesh] = lod + 1;
+			lodRanges.push_back(range);
+		}
+	}
+
+	m_vertexCount = vertices.size();
+	m_indexCount = indices.size();
+
+	// the imported meshes follow the captured ones
+	for (size_t i = 0; i < m_meshFiles.size(); i++)
+	{
+		MESH_RANGE& range = m_meshRanges[m_captureCount.size() + i];
+
+		range.firstIndex = m_indexCount;
+		range.indexCount = m_meshFiles[i]->GetIndexCount();
+		range.baseVertex = m_vertexCount;
+
+		m_vertexCount += m_meshFiles[i]->GetVertexCount();
+		m_indexCount += m_meshFiles[i]->GetIndexCount();
+	}
+
+	// the levels of detail follow the imported meshes
+	m_meshRanges.insert(m_meshRanges.end(), lodRanges.begin(), lodRanges.end());
+
+	glGenVertexArrays(1, &m_vertexArray);
+	glBindVertexArray(m_vertexArray);
+
+	glGenBuffers(1, &m_vertexBuffer);
+	glBindBuffer(GL_ARRAY_BUFFER, m_vertexBuffer);
+	glBufferData(GL_ARRAY_BUFFER, m_vertexCount * sizeof(MESH_FILE_VERTEX), NULL, GL_STATIC_DRAW);
+
+	glGenBuffers(1, &m_indexBuffer);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, m_indexBuffer);
+	glBufferData(GL_ELEMENT_ARRAY_BUFFER, m_indexCount * sizeof(GLuint), NULL, GL_STATIC_DRAW);
+
+	if (!vertices.empty())
+	{
+		glBufferSubData(GL_ARRAY_BUFFER, 0, vertices.size() * sizeof(MESH_FILE_VERTEX), vertices.data());
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, 0, indices.size() * sizeof(GLuint), indices.data());
+		vertexOffset = vertices.size() * sizeof(MESH_FILE_VERTEX);
+		indexOffset = indices.size() * sizeof(GLuint);
+	}
+	for (size_t i = 0; i < m_meshFiles.size(); i++)
+	{
+		GLsizeiptr vertexBytes = m_meshFiles[i]->GetVertexCount() * sizeof(MESH_FILE_VERTEX);
+		GLsizeiptr indexBytes = m_meshFiles[i]->GetIndexCount() * sizeof(GLuint);
+
+		glBufferSubData(GL_ARRAY_BUFFER, vertexOffset, vertexBytes, m_meshFiles[i]->GetVertices());
+		glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexOffset, indexBytes, m_meshFiles[i]->GetIndices());
+		vertexOffset += vertexBytes;
+		indexOffset += indexBytes;
+	}
+
+	// the same attribute locations as the basic meshes, and the
+	// shaders read the quantized attributes as floats
+	glEnableVertexAttribArray(0);
+	glVertexAttribPointer(0, 3, GL_HALF_FLOAT, GL_FALSE, sizeof(MESH_FILE_VERTEX), (void*)offsetof(MESH_FILE_VERTEX, position));
+	glEnableVertexAttribArray(1);
+	glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, sizeof(MESH_FILE_VERTEX), (void*)offsetof(MESH_FILE_VERTEX, normal));
+	glEnableVertexAttribArray(2);
+	glVertexAttribPointer(2, 2, GL_HALF_FLOAT, GL_FALSE, sizeof(MESH_FILE_VERTEX), (void*)offsetof(MESH_FILE_VERTEX, texCoord));
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the shared buffers and
+ *  anything left over from an unfinished capture.
+ ***********************************************************/
+void MeshBuffer::Destroy()
+{
+	if (0 != m_captureProgram)
+	{
+		glDeleteProgram(m_captureProgram);
+		m_captureProgram = 0;
+	}
+	if (0 != m_captureBuffer)
+	{
+		glDeleteBuffers(1, &m_captureBuffer);
+		m_captureBuffer = 0;
+	}
+	if (0 != m_writtenQuery)
+	{
+		glDeleteQueries(1, &m_writtenQuery);
+		m_writtenQuery = 0;
+	}
+	if (0 != m_generatedQuery)
+	{
+		glDeleteQueries(1, &m_generatedQuery);
+		m_generatedQuery = 0;
+	}
+	if (0 != m_vertexArray)
+	{
+		glDeleteVertexArrays(1, &m_vertexArray);
+		m_vertexArray = 0;
+	}
+	if (0 != m_vertexBuffer)
+	{
+		glDeleteBuffers(1, &m_vertexBuffer);
+		m_vertexBuffer = 0;
+	}
+	if (0 != m_indexBuffer)
+	{
+		glDeleteBuffers(1, &m_indexBuffer);
+		m_indexBuffer = 0;
+	}
+
+	m_meshRanges.clear();
+	m_lodMeshes.clear();
+	m_lodCounts.clear();
+	m_meshFiles.clear();
+	m_vertexCount = 0;
+	m_indexCount = 0;
+}
+
+/***********************************************************
+ *  IsReady()
+ *
+ *  This method is used for checking whether the shared
+ *  buffers hold any meshes to draw from.
+ ***********************************************************/
+bool MeshBuffer::IsReady() const
+{
+	return(0 != m_vertexArray);
+}
+
+/***********************************************************
+ *  HasMesh()
+ *
+ *  This method is used for checking whether a mesh was
+ *  captured into the shared buffers.
+ ***********************************************************/
+bool MeshBuffer::HasMesh(int mesh) const
+{
+	return((mesh >= 0) && (mesh < m_meshRanges.size()) && (m_meshRanges[mesh].indexCount > 0));
+}
+
+/***********************************************************
+ *  GetLodMesh()
+ *
+ *  This method is used for getting the mesh that draws the
+ *  passed in level of detail of a mesh.  Level 0 is the mesh
+ *  itself, and a mesh without coarser levels, or one that is
+ *  not in the shared buffers, is returned for every level.
+ ***********************************************************/
+int MeshBuffer::GetLodMesh(int mesh, int lod) const
+{
+	if ((mesh < 0) || (mesh >= m_lodCounts.size()))
+	{
+		return(mesh);
+	}
+
+	lod = std::min(std::max(lod, 0), LOD_COUNT - 1);
+
+	return(m_lodMeshes[(mesh * LOD_COUNT) + lod]);
+}
+
+/***********************************************************
+ *  GetLodCount()
+ *
+ *  This method is used for getting the number of distinct
+ *  levels of detail of a mesh, including the full mesh.
+ ***********************************************************/
+int MeshBuffer::GetLodCount(int mesh) const
+{
+	if ((mesh < 0) || (mesh >= m_lodCounts.size()))
+	{
+		return(1);
+	}
+
+	return(m_lodCounts[mesh]);
+}
+
+/***********************************************************
+ *  MakeCommand()
+ *
+ *  This method is used for building the indirect command
+ *  that draws instances of a mesh from the shared buffers.
+ *  The base instance is where the first instance of the
+ *  command is found in the instance buffer.
+ ***********************************************************/
+MeshBuffer::DRAW_COMMAND MeshBuffer::MakeCommand(int mesh, GLuint instanceCount, GLuint baseInstance) const
+{
+	const MESH_RANGE& range = m_meshRanges[mesh];
+	DRAW_COMMAND command;
+
+	command.count = range.indexCount;
+	command.instanceCount = instanceCount;
+	command.firstIndex = range.firstIndex;
+	command.baseVertex = range.baseVertex;
+	command.baseInstance = baseInstance;
+
+	return(command);
+}
+
+/***********************************************************
+ *  Bind()
+ *
+ *  This method is used for binding the shared vertex array,
+ *  which holds the shared vertex and index buffers.
+ ***********************************************************/
+void MeshBuffer::Bind() const
+{
+	glBindVertexArray(m_vertexArray);
+}
+
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing one mesh from the shared
+ *  buffers with the current shader settings.  It is how the
+ *  imported meshes are drawn outside of the indirect draws,
+ *  since they have no buffers of their own.
+ ***********************************************************/
+void MeshBuffer::DrawMesh(int mesh) const
+{
+	const MESH_RANGE& range = m_meshRanges[mesh];
+
+	glBindVertexArray(m_vertexArray);
+	glDrawElementsBaseVertex(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT,
+		(void*)(range.firstIndex * sizeof(GLuint)), range.baseVertex);
+	glBindVertexArray(0);
+}
+
+/***********************************************************
+ *  DrawInstances()
+ *
+ *  This method is used for drawing several instances of one
+ *  mesh from the shared buffers with one instanced call, while
+ *  the shared vertex array is bound.  The base instance is
+ *  where the first instance is found in the instance buffer,
+ *  the same as for the indirect commands.
+ ***********************************************************/
+void MeshBuffer::DrawInstances(int mesh, GLsizei instanceCount, GLuint baseInstance) const
+{
+	const MESH_RANGE& range = m_meshRanges[mesh];
+
+	glDrawElementsInstancedBaseVertexBaseInstance(GL_TRIANGLES, range.indexCount, GL_UNSIGNED_INT,
+		(void*)(range.firstIndex * sizeof(GLuint)), instanceCount, range.baseVertex, baseInstance);
+}
+
+/***********************************************************
+ *  GetVertexCount()
+ *
+ *  This method is used for getting the number of vertices
+ *  in the shared vertex buffer.
+ ***********************************************************/
+int MeshBuffer::GetVertexCount() const
+{
+	return(m_vertexCount);
+}
+
+/***********************************************************
+ *  GetIndexCount()
+ *
+ *  This method is used for getting the number of indices in
+ *  the shared index buffer.
+ ***********************************************************/
+int MeshBuffer::GetIndexCount() const
+{
+	return(m_indexCount);
+}
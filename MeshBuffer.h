@@ -0,0 +1,154 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshbuffer.h
+// ============
+// pack the basic and imported meshes into shared vertex and index buffers
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include "MeshFile.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  MeshBuffer
+ *
+ *  This class packs every basic mesh into one shared vertex
+ *  buffer and one shared index buffer behind a single vertex
+ *  array, so any number of meshes can be drawn by one call
+ *  to glMultiDrawElementsIndirect().  The meshes keep their
+ *  own buffers inside ShapeMeshes, so their vertices are
+ *  captured with transform feedback while each mesh is drawn
+ *  once, then welded back into indexed triangles.
+ *
+ *  Every vertex of the shared buffer is quantized to the 16
+ *  byte MESH_FILE_VERTEX layout, half the size of full
+ *  floats, so the meshes imported by the MeshCompiler tool
+ *  are uploaded straight from their mapped files.
+ *
+ *  Each captured mesh also gets coarser levels of detail,
+ *  decimated by vertex clustering and packed after the
+ *  imported meshes as meshes of their own, so a far object
+ *  can be drawn with fewer triangles by the same calls.
+ ***********************************************************/
+class MeshBuffer
+{
+public:
+	// constructor
+	MeshBuffer();
+	// destructor
+	~MeshBuffer();
+
+	// the most vertices that can be captured for all of the meshes
+	static const int MAX_CAPTURE_VERTICES = 262144;
+	// levels of detail of a captured mesh, the full mesh being level 0
+	static const int LOD_COUNT = 3;
+
+	// one captured vertex of a basic mesh, in the same
+	// attribute locations as the basic meshes
+	struct PACKED_VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 texCoord;
+	};
+
+	// where a mesh is found inside the shared buffers
+	struct MESH_RANGE
+	{
+		GLuint firstIndex;
+		GLuint indexCount;
+		GLint baseVertex;
+	};
+
+	// one command of a GL_DRAW_INDIRECT_BUFFER, laid out as
+	// glMultiDrawElementsIndirect() reads it
+	struct DRAW_COMMAND
+	{
+		GLuint count;
+		GLuint instanceCount;
+		GLuint firstIndex;
+		GLint baseVertex;
+		GLuint baseInstance;
+	};
+
+private:
+	// program and buffer the mesh vertices are captured with
+	GLuint m_captureProgram;
+	GLuint m_captureBuffer;
+	// queries for the primitives written and generated by a mesh
+	GLuint m_writtenQuery;
+	GLuint m_generatedQuery;
+	// program that was in use before the capture started
+	GLint m_previousProgram;
+	// number of vertices captured so far
+	GLuint m_capturedVertices;
+	// first captured vertex and vertex count of each mesh
+	std::vector<GLuint> m_captureFirst;
+	std::vector<GLuint> m_captureCount;
+	// imported meshes added to the capture, drawn after the basic ones
+	std::vector<const MeshFile*> m_meshFiles;
+	// the shared vertex array and buffers
+	GLuint m_vertexArray;
+	GLuint m_vertexBuffer;
+	GLuint m_indexBuffer;
+	// where each mesh is found inside the shared buffers
+	std::vector<MESH_RANGE> m_meshRanges;
+	// mesh drawn for every level of detail of every mesh, LOD_COUNT
+	// per mesh, and the number of distinct levels of each mesh
+	std::vector<int> m_lodMeshes;
+	std::vector<int> m_lodCounts;
+	// total number of vertices and indices in the shared buffers
+	int m_vertexCount;
+	int m_indexCount;
+
+	// compile and link the program the vertices are captured with
+	GLuint CreateCaptureProgram();
+	// weld the captured vertices and upload the shared buffers
+	void BuildSharedBuffers(const std::vector<PACKED_VERTEX>& captured);
+
+public:
+	// check whether the driver can draw from the shared buffers
+	static bool IsSupported();
+
+	// get ready to capture the passed in number of meshes
+	bool BeginCapture(int meshCount);
+	// start capturing the vertices of a mesh, before it is drawn
+	void BeginMesh(int mesh);
+	// stop capturing the vertices of a mesh, after it is drawn
+	void EndMesh(int mesh);
+	// add an imported mesh to the shared buffers, returning its mesh index
+	int AddMeshFile(const MeshFile* pMeshFile);
+	// pack the captured meshes into the shared buffers
+	bool EndCapture();
+	// free the shared buffers
+	void Destroy();
+
+	// check whether the shared buffers are ready to draw from
+	bool IsReady() const;
+	// check whether a mesh was captured into the shared buffers
+	bool HasMesh(int mesh) const;
+	// get the mesh that draws a level of detail of a mesh
+	int GetLodMesh(int mesh, int lod) const;
+	// get the number of levels of detail of a mesh, 1 when it has none
+	int GetLodCount(int mesh) const;
+	// build the command that draws instances of a mesh
+	DRAW_COMMAND MakeCommand(int mesh, GLuint instanceCount, GLuint baseInstance) const;
+	// bind the shared vertex array for drawing
+	void Bind() const;
+	// draw one mesh from the shared buffers
+	void DrawMesh(int mesh) const;
+	// draw instances of one mesh from the shared buffers with one call
+	void DrawInstances(int mesh, GLsizei instanceCount, GLuint baseInstance) const;
+
+	// get the number of vertices and indices in the shared buffers
+	int GetVertexCount() const;
+	int GetIndexCount() const;
+};
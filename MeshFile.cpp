@@ -0,0 +1,324 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshfile.cpp
+// ============
+// compiled mesh file layout and read-only memory mapping - imported meshes
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshFile.h"
+
+#include <glm/gtc/packing.hpp>
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <iostream>
+
+/***********************************************************
+ *  MeshFile()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+MeshFile::MeshFile()
+{
+	m_pData = NULL;
+	m_size = 0;
+#ifdef _WIN32
+	m_fileHandle = INVALID_HANDLE_VALUE;
+	m_mappingHandle = NULL;
+#else
+	m_fileDescriptor = -1;
+#endif
+}
+
+/***********************************************************
+ *  ~MeshFile()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+MeshFile::~MeshFile()
+{
+	Close();
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for mapping a compiled mesh file
+ *  into memory.  False is returned when the file is missing
+ *  or is not a valid mesh file of this version.
+ ***********************************************************/
+bool MeshFile::Open(const char* filename)
+{
+	Close();
+
+#ifdef _WIN32
+	LARGE_INTEGER fileSize;
+
+	m_fileHandle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (INVALID_HANDLE_VALUE == m_fileHandle)
+	{
+		return(false);
+	}
+	if ((!GetFileSizeEx(m_fileHandle, &fileSize)) || (fileSize.QuadPart < (LONGLONG)sizeof(MESH_FILE_HEADER)))
+	{
+		Close();
+		return(false);
+	}
+
+	m_mappingHandle = CreateFileMappingA(m_fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (NULL == m_mappingHandle)
+	{
+		Close();
+		return(false);
+	}
+
+	m_pData = (const unsigned char*)MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	m_size = (size_t)fileSize.QuadPart;
+#else
+	struct stat fileStatus;
+
+	m_fileDescriptor = open(filename, O_RDONLY);
+	if (m_fileDescriptor < 0)
+	{
+		return(false);
+	}
+	if ((fstat(m_fileDescriptor, &fileStatus) != 0) || (fileStatus.st_size < (off_t)sizeof(MESH_FILE_HEADER)))
+	{
+		Close();
+		return(false);
+	}
+
+	void* pMapping = mmap(NULL, fileStatus.st_size, PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+	if (MAP_FAILED != pMapping)
+	{
+		m_pData = (const unsigned char*)pMapping;
+		m_size = (size_t)fileStatus.st_size;
+	}
+#endif
+
+	if (NULL == m_pData)
+	{
+		std::cout << "Could not map mesh file:" << filename << std::endl;
+		Close();
+		return(false);
+	}
+
+	if (!Validate())
+	{
+		std::cout << "Not a valid mesh file:" << filename << std::endl;
+		Close();
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for unmapping the mesh file, once
+ *  its vertices and indices have been uploaded.
+ ***********************************************************/
+void MeshFile::Close()
+{
+#ifdef _WIN32
+	if (NULL != m_pData)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+	if (NULL != m_mappingHandle)
+	{
+		CloseHandle(m_mappingHandle);
+		m_mappingHandle = NULL;
+	}
+	if (INVALID_HANDLE_VALUE != m_fileHandle)
+	{
+		CloseHandle(m_fileHandle);
+		m_fileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (NULL != m_pData)
+	{
+		munmap((void*)m_pData, m_size);
+	}
+	if (m_fileDescriptor >= 0)
+	{
+		close(m_fileDescriptor);
+		m_fileDescriptor = -1;
+	}
+#endif
+
+	m_pData = NULL;
+	m_size = 0;
+}
+
+/***********************************************************
+ *  IsOpen()
+ *
+ *  This method is used for checking whether a mesh file is
+ *  mapped.
+ ***********************************************************/
+bool MeshFile::IsOpen() const
+{
+	return(NULL != m_pData);
+}
+
+/***********************************************************
+ *  IsSectionValid()
+ *
+ *  This method is used for checking that a section of
+ *  records lies inside the file and starts on a four byte
+ *  boundary, so its records can be read in place.
+ ***********************************************************/
+bool MeshFile::IsSectionValid(const MESH_FILE_SECTION& section, size_t recordSize) const
+{
+	if ((section.offset % 4) != 0)
+	{
+		return(false);
+	}
+
+	return(((uint64_t)section.offset + ((uint64_t)section.count * recordSize)) <= m_size);
+}
+
+/***********************************************************
+ *  Validate()
+ *
+ *  This method is used for checking the header, that every
+ *  section lies inside the file, that the indices make
+ *  whole triangles of vertices in the file, and that every
+ *  meshlet covers whole triangles inside the indices.  An
+ *  index out of range would read past the vertices of the
+ *  mesh in the shared buffer.
+ ***********************************************************/
+bool MeshFile::Validate() const
+{
+	const MESH_FILE_HEADER* pHeader = (const MESH_FILE_HEADER*)m_pData;
+
+	if ((pHeader->magic != MESH_FILE_MAGIC) ||
+		(pHeader->version != MESH_FILE_VERSION) ||
+		(pHeader->fileSize != m_size))
+	{
+		return(false);
+	}
+
+	if ((!IsSectionValid(pHeader->vertices, sizeof(MESH_FILE_VERTEX))) ||
+		(!IsSectionValid(pHeader->indices, sizeof(uint32_t))) ||
+		(!IsSectionValid(pHeader->meshlets, sizeof(MESH_FILE_MESHLET))))
+	{
+		return(false);
+	}
+
+	if ((pHeader->indices.count == 0) || ((pHeader->indices.count % 3) != 0))
+	{
+		return(false);
+	}
+
+	for (int i = 0; i < GetIndexCount(); i++)
+	{
+		if (GetIndices()[i] >= pHeader->vertices.count)
+		{
+			return(false);
+		}
+	}
+	for (int i = 0; i < GetMeshletCount(); i++)
+	{
+		const MESH_FILE_MESHLET& meshlet = GetMeshlets()[i];
+
+		if (((meshlet.firstIndex % 3) != 0) ||
+			((meshlet.indexCount % 3) != 0) ||
+			((uint64_t)meshlet.firstIndex + meshlet.indexCount > pHeader->indices.count))
+		{
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Get*()
+ *
+ *  These methods are used for getting the records of each
+ *  section in place, and how many records there are.
+ ***********************************************************/
+const MESH_FILE_VERTEX* MeshFile::GetVertices() const
+{
+	return((const MESH_FILE_VERTEX*)(m_pData + ((const MESH_FILE_HEADER*)m_pData)->vertices.offset));
+}
+
+int MeshFile::GetVertexCount() const
+{
+	return(((const MESH_FILE_HEADER*)m_pData)->vertices.count);
+}
+
+const uint32_t* MeshFile::GetIndices() const
+{
+	return((const uint32_t*)(m_pData + ((const MESH_FILE_HEADER*)m_pData)->indices.offset));
+}
+
+int MeshFile::GetIndexCount() const
+{
+	return(((const MESH_FILE_HEADER*)m_pData)->indices.count);
+}
+
+const MESH_FILE_MESHLET* MeshFile::GetMeshlets() const
+{
+	return((const MESH_FILE_MESHLET*)(m_pData + ((const MESH_FILE_HEADER*)m_pData)->meshlets.offset));
+}
+
+int MeshFile::GetMeshletCount() const
+{
+	return(((const MESH_FILE_HEADER*)m_pData)->meshlets.count);
+}
+
+glm::vec3 MeshFile::GetBoundsMin() const
+{
+	const MESH_FILE_HEADER* pHeader = (const MESH_FILE_HEADER*)m_pData;
+
+	return(glm::vec3(pHeader->boundsMin[0], pHeader->boundsMin[1], pHeader->boundsMin[2]));
+}
+
+glm::vec3 MeshFile::GetBoundsMax() const
+{
+	const MESH_FILE_HEADER* pHeader = (const MESH_FILE_HEADER*)m_pData;
+
+	return(glm::vec3(pHeader->boundsMax[0], pHeader->boundsMax[1], pHeader->boundsMax[2]));
+}
+
+/***********************************************************
+ *  QuantizeVertex()
+ *
+ *  This method is used for packing the attributes of a
+ *  vertex into the 16 byte shared vertex layout, half of the
+ *  32 bytes of full floats.  The positions and texture
+ *  coordinates are half floats, which keep three decimal
+ *  digits, and the normal is packed to 10 bits an axis.
+ ***********************************************************/
+MESH_FILE_VERTEX MeshFile::QuantizeVertex(
+	const glm::vec3& position,
+	const glm::vec3& normal,
+	const glm::vec2& texCoord)
+{
+	MESH_FILE_VERTEX vertex;
+	float normalLength = glm::length(normal);
+	glm::vec3 unitNormal = (normalLength > 0.0f) ? normal / normalLength : glm::vec3(0.0f, 1.0f, 0.0f);
+
+	vertex.position[0] = glm::packHalf1x16(position.x);
+	vertex.position[1] = glm::packHalf1x16(position.y);
+	vertex.position[2] = glm::packHalf1x16(position.z);
+	vertex.position[3] = glm::packHalf1x16(1.0f);
+	vertex.normal = glm::packSnorm3x10_1x2(glm::vec4(unitNormal, 0.0f));
+	vertex.texCoord[0] = glm::packHalf1x16(texCoord.x);
+	vertex.texCoord[1] = glm::packHalf1x16(texCoord.y);
+
+	return(vertex);
+}
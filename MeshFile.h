@@ -0,0 +1,134 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshfile.h
+// ============
+// compiled mesh file layout and read-only memory mapping - imported meshes
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+
+// "MSH1" in the first four bytes of every compiled mesh file
+static const uint32_t MESH_FILE_MAGIC = 0x3148534D;
+static const uint32_t MESH_FILE_VERSION = 1;
+
+// where an array of records is found in the file
+struct MESH_FILE_SECTION
+{
+	uint32_t offset;
+	uint32_t count;
+};
+
+// the start of every compiled mesh file, every section counts records
+struct MESH_FILE_HEADER
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t fileSize;
+	// bounding box of the vertex positions
+	float boundsMin[3];
+	float boundsMax[3];
+	MESH_FILE_SECTION vertices;
+	MESH_FILE_SECTION indices;
+	MESH_FILE_SECTION meshlets;
+};
+
+// one quantized vertex of 16 bytes, the layout of the shared vertex
+// buffer, read by the vertex attributes without any decoding
+struct MESH_FILE_VERTEX
+{
+	// half float x, y and z, and a half float 1 for w
+	uint16_t position[4];
+	// signed normalized 10:10:10:2, with w unused
+	uint32_t normal;
+	// half float u and v
+	uint16_t texCoord[2];
+};
+
+// a run of at most MAX_MESHLET_TRIANGLES triangles that touch at
+// most MAX_MESHLET_VERTICES vertices, for culling parts of a mesh
+struct MESH_FILE_MESHLET
+{
+	uint32_t firstIndex;
+	uint32_t indexCount;
+	// bounding sphere of the triangles
+	float center[3];
+	float radius;
+	// the triangles all face away from the viewer when the view
+	// direction is within the cone around the axis
+	float coneAxis[3];
+	float coneCutoff;
+};
+
+/***********************************************************
+ *  MeshFile
+ *
+ *  This class maps a mesh file written by the MeshCompiler
+ *  tool into memory.  The vertices are already quantized to
+ *  the layout of the shared vertex buffer and the indices
+ *  are ordered for the vertex cache, so both are uploaded
+ *  straight from the mapped pages without being parsed or
+ *  converted.  The meshlets split the indices into small
+ *  runs with their own bounds.
+ ***********************************************************/
+class MeshFile
+{
+public:
+	// constructor
+	MeshFile();
+	// destructor
+	~MeshFile();
+
+	// the most vertices and triangles of one meshlet
+	static const int MAX_MESHLET_VERTICES = 64;
+	static const int MAX_MESHLET_TRIANGLES = 124;
+
+private:
+	// the mapped file and its size in bytes
+	const unsigned char* m_pData;
+	size_t m_size;
+#ifdef _WIN32
+	// handles of the open file and of its mapping
+	void* m_fileHandle;
+	void* m_mappingHandle;
+#else
+	// descriptor of the open file
+	int m_fileDescriptor;
+#endif
+
+	// check that a section of records lies inside the file
+	bool IsSectionValid(const MESH_FILE_SECTION& section, size_t recordSize) const;
+	// check that the sections and the indices are valid
+	bool Validate() const;
+
+public:
+	// map the compiled mesh file into memory
+	bool Open(const char* filename);
+	// unmap the file
+	void Close();
+	// check whether a mesh file is mapped
+	bool IsOpen() const;
+
+	// get the records of each section and how many there are
+	const MESH_FILE_VERTEX* GetVertices() const;
+	int GetVertexCount() const;
+	const uint32_t* GetIndices() const;
+	int GetIndexCount() const;
+	const MESH_FILE_MESHLET* GetMeshlets() const;
+	int GetMeshletCount() const;
+	// get the bounding box of the vertex positions
+	glm::vec3 GetBoundsMin() const;
+	glm::vec3 GetBoundsMax() const;
+
+	// quantize the attributes of a vertex to the shared vertex layout
+	static MESH_FILE_VERTEX QuantizeVertex(
+		const glm::vec3& position,
+		const glm::vec3& normal,
+		const glm::vec2& texCoord);
+};
@@ -0,0 +1,845 @@
+///////////////////////////////////////////////////////////////////////////////
+// regressionsuite.cpp
+// ============
+// time the scene pipeline components over a range of sizes - scaling, regressions
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RegressionSuite.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <random>
+#include <thread>
+
+// declaration of global variables and defines
+namespace
+{
+	// a run is timed again with more iterations until it takes this long
+	const double g_MinCaseTime = 0.2;
+	// most iterations of a run, and the fastest of this many runs is kept
+	const int g_MaxIterations = 10000000;
+	const int g_Repetitions = 3;
+	// every texture decodes and uploads a whole image, so fewer are timed
+	const int g_MaxTextureIterations = 32;
+	// the basic meshes can not be freed once loaded, so only a few
+	// are loaded, enough to time the generation of the vertices
+	const int g_MaxMeshIterations = 16;
+	// frames of one run of the generated scene, and the frames it is
+	// rendered before it is timed, once its textures are loaded
+	const int g_MaxFrameIterations = 600;
+	const int g_WarmupFrames = 30;
+	// size of the frames in pixels, and the frames of the camera path
+	const int g_FrameWidth = 1280;
+	const int g_FrameHeight = 720;
+	const int g_FramePathLength = 600;
+	// a case may take this much longer than its baseline
+	const double g_DefaultTolerance = 0.15;
+
+	// the mesh generation functions timed by the mesh case
+	struct SHAPE_MESH_LOADER
+	{
+		const char* name;
+		void (ShapeMeshes::*load)();
+	};
+	const SHAPE_MESH_LOADER g_MeshLoaders[] =
+	{
+		{ "LoadPlaneMesh", &ShapeMeshes::LoadPlaneMesh },
+		{ "LoadConeMesh", &ShapeMeshes::LoadConeMesh },
+		{ "LoadCylinderMesh", &ShapeMeshes::LoadCylinderMesh },
+		{ "LoadPrismMesh", &ShapeMeshes::LoadPrismMesh },
+		{ "LoadTorusMesh", &ShapeMeshes::LoadTorusMesh },
+		{ "LoadSphereMesh", &ShapeMeshes::LoadSphereMesh },
+		{ "LoadTaperedCylinderMesh", &ShapeMeshes::LoadTaperedCylinderMesh },
+		{ "LoadPyramid3Mesh", &ShapeMeshes::LoadPyramid3Mesh },
+		{ "LoadBoxMesh", &ShapeMeshes::LoadBoxMesh }
+	};
+	const int g_MeshLoaderCount = sizeof(g_MeshLoaders) / sizeof(g_MeshLoaders[0]);
+
+	// the lookups add their results here, so they are not optimized away
+	volatile int g_ResultSink = 0;
+}
+
+/***********************************************************
+ *  RegressionSuite()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RegressionSuite::RegressionSuite(
+	ShaderManager* pShaderManager,
+	UniformCache* pUniformCache,
+	ViewManager* pViewManager)
+{
+	m_pShaderManager = pShaderManager;
+	m_pUniformCache = pUniformCache;
+	m_pViewManager = pViewManager;
+	m_tolerance = g_DefaultTolerance;
+	m_itemsProcessed = 0.0;
+	m_pLookupScene = NULL;
+	m_seededTextureSlots = 0;
+	m_seededMaterials = 0;
+	m_bCaseFailed = false;
+	m_pFrameScene = NULL;
+	m_frameSceneObjects = 0;
+	m_pFrameRunner = NULL;
+	m_frameIndex = 0;
+
+	AddCase("FindTextureSlot", &RegressionSuite::TimeFindTextureSlot, Range(10, 100000, 10), g_MaxIterations);
+	AddCase("FindMaterial", &RegressionSuite::TimeFindMaterial, Range(10, 100000, 10), g_MaxIterations);
+	AddCase("SetTransformations", &RegressionSuite::TimeSetTransformations, Range(10, 100000, 10), g_MaxIterations);
+	AddCase("CreateGLTexture", &RegressionSuite::TimeCreateGLTexture, Range(64, 2048, 2), g_MaxTextureIterations);
+	AddCase("ShapeMeshes", &RegressionSuite::TimeLoadShapeMesh, DenseRange(0, g_MeshLoaderCount - 1), g_MaxMeshIterations);
+	AddCase("RenderFrame", &RegressionSuite::TimeRenderFrame, Range(10, 100000, 10), g_MaxFrameIterations);
+}
+
+/***********************************************************
+ *  ~RegressionSuite()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RegressionSuite::~RegressionSuite()
+{
+	DestroyFrameScene();
+	if (NULL != m_pLookupScene)
+	{
+		delete m_pLookupScene;
+		m_pLookupScene = NULL;
+	}
+
+	// remove the generated images
+	for (int i = 0; i < m_imageFiles.size(); i++)
+	{
+		remove(m_imageFiles[i].c_str());
+	}
+	m_imageFiles.clear();
+
+	m_pShaderManager = NULL;
+	m_pUniformCache = NULL;
+	m_pViewManager = NULL;
+}
+
+/***********************************************************
+ *  Range()
+ *  DenseRange()
+ *
+ *  These methods are used for getting the sizes a case is
+ *  run at, either growing from the first to the last by the
+ *  multiplier, with the last always included, or every size
+ *  from the first to the last.
+ ***********************************************************/
+std::vector<int> RegressionSuite::Range(int first, int last, int multiplier)
+{
+	std::vector<int> arguments;
+
+	for (long long argument = first; argument < last; argument *= std::max(multiplier, 2))
+	{
+		arguments.push_back((int)argument);
+	}
+	arguments.push_back(last);
+
+	return(arguments);
+}
+
+std::vector<int> RegressionSuite::DenseRange(int first, int last)
+{
+	std::vector<int> arguments;
+
+	for (int argument = first; argument <= last; argument++)
+	{
+		arguments.push_back(argument);
+	}
+
+	return(arguments);
+}
+
+/***********************************************************
+ *  MakeKey()
+ *
+ *  This method is used for getting the key the baseline
+ *  time of a case at one size is kept under.
+ ***********************************************************/
+std::string RegressionSuite::MakeKey(const std::string& name, int argument)
+{
+	return(name + "/" + std::to_string(argument));
+}
+
+/***********************************************************
+ *  AddCase()
+ *
+ *  This method is used for adding a case to the suite, to be
+ *  run at every one of the passed in sizes.
+ ***********************************************************/
+void RegressionSuite::AddCase(const char* name, CASE_FUNCTION function, const std::vector<int>& arguments, int maxIterations)
+{
+	BENCHMARK_CASE benchmarkCase;
+
+	benchmarkCase.name = name;
+	benchmarkCase.function = function;
+	benchmarkCase.arguments = arguments;
+	benchmarkCase.maxIterations = maxIterations;
+	m_cases.push_back(benchmarkCase);
+}
+
+/***********************************************************
+ *  StartTiming()
+ *  StopTiming()
+ *
+ *  These methods are used by the cases for timing only the
+ *  part they measure, StopTiming() returns the seconds since
+ *  StartTiming() was called.
+ ***********************************************************/
+void RegressionSuite::StartTiming()
+{
+	m_startTime = std::chrono::steady_clock::now();
+}
+
+double RegressionSuite::StopTiming() const
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+	return(std::chrono::duration<double>(now - m_startTime).count());
+}
+
+/***********************************************************
+ *  LoadBaseline()
+ *
+ *  This method is used for reading the results of an
+ *  earlier run, written by WriteResults(), which the times
+ *  of this run are compared with.  Every result is on a line
+ *  of its own, so the lines are read one by one.
+ ***********************************************************/
+bool RegressionSuite::LoadBaseline(const char* filename)
+{
+	FILE* file = fopen(filename, "r");
+	char line[1024];
+
+	if (NULL == file)
+	{
+		std::cout << "Could not read regression baseline:" << filename << std::endl;
+		return(false);
+	}
+
+	m_baseline.clear();
+	while (NULL != fgets(line, sizeof(line), file))
+	{
+		char name[128];
+		int argument = 0;
+		const char* timeField = strstr(line, "\"timeNs\": ");
+
+		if ((NULL != timeField) &&
+			(sscanf(line, " { \"name\": \"%127[^\"]\", \"argument\": %d", name, &argument) == 2))
+		{
+			m_baseline[MakeKey(name, argument)] = atof(timeField + strlen("\"timeNs\": "));
+		}
+	}
+	fclose(file);
+
+	std::cout << "Loaded " << m_baseline.size() << " regression baseline results:" << filename << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  SetTolerance()
+ *
+ *  This method is used for setting the part a case may be
+ *  slower than its baseline before it is a regression, like
+ *  0.15 for 15 percent.
+ ***********************************************************/
+void RegressionSuite::SetTolerance(double tolerance)
+{
+	m_tolerance = std::max(tolerance, 0.0);
+}
+
+/***********************************************************
+ *  Run()
+ *
+ *  This method is used for running every case at every one
+ *  of its sizes, printing each result as it is found.
+ ***********************************************************/
+void RegressionSuite::Run()
+{
+	m_results.clear();
+
+	printf("%-40s %16s %12s %16s\n", "Case", "Time (ns)", "Iterations", "Items/s");
+	for (int i = 0; i < m_cases.size(); i++)
+	{
+		for (int j = 0; j < m_cases[i].arguments.size(); j++)
+		{
+			RunCase(m_cases[i], m_cases[i].arguments[j]);
+		}
+	}
+
+	// the last size of the generated scene is not needed anymore
+	DestroyFrameScene();
+}
+
+/***********************************************************
+ *  RunCase()
+ *
+ *  This method is used for running a case at one size.  The
+ *  case is first run once, then with more iterations until
+ *  the run takes long enough to be timed, growing at most
+ *  tenfold at a time.  The fastest of the repetitions is
+ *  kept and compared with the baseline.  A case that can not
+ *  be run at the size is stopped right away and recorded as
+ *  failed, without a time.
+ ***********************************************************/
+void RegressionSuite::RunCase(const BENCHMARK_CASE& benchmarkCase, int argument)
+{
+	CASE_RESULT result;
+
+	result.name = benchmarkCase.name;
+	result.argument = argument;
+	result.iterations = 0;
+	result.time = DBL_MAX;
+	result.itemsPerSecond = 0.0;
+	result.baselineTime = 0.0;
+	result.thresholdTime = 0.0;
+	result.bRegressed = false;
+	result.bFailed = false;
+
+	for (int repetition = 0; (repetition < g_Repetitions) && (!result.bFailed); repetition++)
+	{
+		int iterations = 1;
+		double seconds = 0.0;
+
+		while (true)
+		{
+			m_itemsProcessed = 0.0;
+			m_label.clear();
+			m_bCaseFailed = false;
+			seconds = (this->*benchmarkCase.function)(argument, iterations);
+
+			if (m_bCaseFailed)
+			{
+				result.bFailed = true;
+				break;
+			}
+			if ((seconds >= g_MinCaseTime) || (iterations >= benchmarkCase.maxIterations))
+			{
+				break;
+			}
+
+			// aim a little past the time, so the next run is likely the last
+			double growth = (seconds > 0.0) ? ((g_MinCaseTime * 1.4) / seconds) : 10.0;
+			growth = std::min(std::max(growth, 2.0), 10.0);
+			iterations = (int)std::min(ceil(iterations * growth), (double)benchmarkCase.maxIterations);
+		}
+
+		double time = (seconds * 1.0e9) / iterations;
+		if ((!result.bFailed) && (time < result.time))
+		{
+			result.iterations = iterations;
+			result.time = time;
+			result.itemsPerSecond = (seconds > 0.0) ? (m_itemsProcessed / seconds) : 0.0;
+			result.label = m_label;
+		}
+	}
+
+	std::string caseName = MakeKey(result.name, argument);
+
+	// a failed case has no time to compare, it is counted with the regressions
+	if (result.bFailed)
+	{
+		result.iterations = 0;
+		result.time = 0.0;
+		result.label = m_label;
+		m_results.push_back(result);
+		printf("%-40s %16s\n", caseName.c_str(), "FAILED");
+		return;
+	}
+
+	// a case slower than its baseline by more than the tolerance regressed
+	std::unordered_map<std::string, double>::const_iterator found = m_baseline.find(MakeKey(result.name, argument));
+	result.baselineTime = (found != m_baseline.end()) ? found->second : 0.0;
+	result.thresholdTime = result.baselineTime * (1.0 + m_tolerance);
+	result.bRegressed = (result.baselineTime > 0.0) && (result.time > result.thresholdTime);
+	m_results.push_back(result);
+
+	if (!result.label.empty())
+	{
+		caseName += " " + result.label;
+	}
+	printf("%-40s %16.1f %12d %16.0f%s\n",
+		caseName.c_str(),
+		result.time,
+		result.iterations,
+		result.itemsPerSecond,
+		result.bRegressed ? "  REGRESSED" : "");
+}
+
+/***********************************************************
+ *  WriteResults()
+ *
+ *  This method is used for writing the results to a JSON
+ *  file, with the baseline and threshold of every result
+ *  and whether it regressed.  Every result is written on a
+ *  line of its own, so a copy of the file can be read back
+ *  as the baseline of a later run.  A failed result is
+ *  written without a time, so it is not read back into a
+ *  baseline.
+ ***********************************************************/
+bool RegressionSuite::WriteResults(const char* filename) const
+{
+	FILE* file = fopen(filename, "w");
+
+	if (NULL == file)
+	{
+		std::cout << "Could not write regression file:" << filename << std::endl;
+		return(false);
+	}
+
+	fprintf(file, "{\n");
+	fprintf(file, "\t\"tolerance\": %.4f,\n", m_tolerance);
+	fprintf(file, "\t\"regressions\": %d,\n", GetRegressionCount());
+	fprintf(file, "\t\"results\": [");
+	for (int i = 0; i < m_results.size(); i++)
+	{
+		const CASE_RESULT& result = m_results[i];
+		if (result.bFailed)
+		{
+			fprintf(file, "%s\n\t\t{ \"name\": \"%s\", \"argument\": %d, \"label\": \"%s\", \"failed\": true }",
+				(i > 0) ? "," : "",
+				result.name.c_str(),
+				result.argument,
+				result.label.c_str());
+			continue;
+		}
+		fprintf(file, "%s\n\t\t{ \"name\": \"%s\", \"argument\": %d, \"label\": \"%s\", \"iterations\": %d, \"timeNs\": %.3f, \"itemsPerSecond\": %.1f, \"baselineNs\": %.3f, \"thresholdNs\": %.3f, \"regressed\": %s }",
+			(i > 0) ? "," : "",
+			result.name.c_str(),
+			result.argument,
+			result.label.c_str(),
+			result.iterations,
+			result.time,
+			result.itemsPerSecond,
+			result.baselineTime,
+			result.thresholdTime,
+			result.bRegressed ? "true" : "false");
+	}
+	fprintf(file, "\n\t]\n");
+	fprintf(file, "}\n");
+
+	fclose(file);
+	std::cout << "Wrote regression results:" << filename << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetRegressionCount()
+ *
+ *  This method is used for getting the number of results
+ *  that are slower than their thresholds, counting the cases
+ *  that failed to run as well, so a broken case does not
+ *  pass unnoticed.
+ ***********************************************************/
+int RegressionSuite::GetRegressionCount() const
+{
+	int regressions = 0;
+
+	for (int i = 0; i < m_results.size(); i++)
+	{
+		if ((m_results[i].bRegressed) || (m_results[i].bFailed))
+		{
+			regressions++;
+		}
+	}
+
+	return(regressions);
+}
+
+/***********************************************************
+ *  GetLookupScene()
+ *
+ *  This method is used for getting the scene the lookup,
+ *  transformation and texture cases use.  The scene is not
+ *  prepared, the cases fill in only what they time, but its
+ *  texture loader is started once, since it keeps its
+ *  worker threads and staging buffer.
+ ***********************************************************/
+SceneManager* RegressionSuite::GetLookupScene()
+{
+	if (NULL == m_pLookupScene)
+	{
+		m_pLookupScene = new SceneManager(m_pShaderManager, m_pUniformCache);
+		m_pLookupScene->StartTextureLoading();
+	}
+
+	return(m_pLookupScene);
+}
+
+/***********************************************************
+ *  FillLookupTags()
+ *
+ *  This method is used for making the passed in number of
+ *  tags and shuffling them, so the lookups do not walk the
+ *  table in the order it was filled.
+ ***********************************************************/
+void RegressionSuite::FillLookupTags(const char* prefix, int count)
+{
+	std::mt19937 random(1234);
+
+	m_lookupTags.clear();
+	for (int i = 0; i < count; i++)
+	{
+		m_lookupTags.push_back(std::string(prefix) + std::to_string(i));
+	}
+	std::shuffle(m_lookupTags.begin(), m_lookupTags.end(), random);
+}
+
+/***********************************************************
+ *  WriteTestImage()
+ *
+ *  This method is used for writing an uncompressed TGA
+ *  image of the passed in size, with a pattern that does not
+ *  compress away, for the texture cases to decode.  Each
+ *  size is written once and removed with the suite.
+ ***********************************************************/
+std::string RegressionSuite::WriteTestImage(int size)
+{
+	std::string filename = "regression_texture_" + std::to_string(size) + ".tga";
+
+	if (std::find(m_imageFiles.begin(), m_imageFiles.end(), filename) != m_imageFiles.end())
+	{
+		return(filename);
+	}
+
+	FILE* file = fopen(filename.c_str(), "wb");
+	if (NULL == file)
+	{
+		std::cout << "Could not write regression image:" << filename << std::endl;
+		return(filename);
+	}
+
+	// true color image, 32 bits with 8 alpha bits, rows from the bottom
+	unsigned char header[18] = { 0 };
+	header[2] = 2;
+	header[12] = size & 0xFF;
+	header[13] = (size >> 8) & 0xFF;
+	header[14] = size & 0xFF;
+	header[15] = (size >> 8) & 0xFF;
+	header[16] = 32;
+	header[17] = 8;
+	fwrite(header, 1, sizeof(header), file);
+
+	std::vector<unsigned char> row(size * 4);
+	for (int y = 0; y < size; y++)
+	{
+		for (int x = 0; x < size; x++)
+		{
+			row[x * 4 + 0] = (unsigned char)(x * 7 + y * 3);
+			row[x * 4 + 1] = (unsigned char)(x ^ y);
+			row[x * 4 + 2] = (unsigned char)(y * 5);
+			row[x * 4 + 3] = 255;
+		}
+		fwrite(&row[0], 1, row.size(), file);
+	}
+
+	fclose(file);
+	m_imageFiles.push_back(filename);
+
+	return(filename);
+}
+
+/***********************************************************
+ *  PrepareFrameScene()
+ *
+ *  This method is used for preparing the generated scene of
+ *  the passed in number of objects, and the offscreen frame
+ *  buffer it is rendered into.  The scene is rendered until
+ *  its textures are loaded and a few frames after, so the
+ *  timed frames do not include the loading.  The scene is
+ *  kept while the same number of objects is timed again.
+ ***********************************************************/
+bool RegressionSuite::PrepareFrameScene(int objectCount)
+{
+	if ((NULL != m_pFrameScene) && (m_frameSceneObjects == objectCount))
+	{
+		return(true);
+	}
+	DestroyFrameScene();
+
+	m_pFrameScene = new SceneManager(m_pShaderManager, m_pUniformCache);
+	m_pFrameScene->SetSyntheticScene(objectCount);
+	m_pFrameScene->PrepareScene();
+	m_frameSceneObjects = objectCount;
+
+	m_pFrameRunner = new BenchmarkRunner(m_pFrameScene, m_pViewManager, m_pUniformCache, NULL);
+	if (m_pFrameRunner->CreateFramebuffer(g_FrameWidth, g_FrameHeight) == false)
+	{
+		DestroyFrameScene();
+		return(false);
+	}
+
+	int warmupFrames = 0;
+	m_pFrameRunner->BeginRun(g_FramePathLength);
+	while (m_pFrameScene->IsLoadingTextures() || (warmupFrames < g_WarmupFrames))
+	{
+		RenderSyntheticFrame(0);
+		warmupFrames++;
+	}
+	glFinish();
+
+	m_frameIndex = 0;
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyFrameScene()
+ *
+ *  This method is used for freeing the generated scene and
+ *  the offscreen frame buffer it is rendered into.
+ ***********************************************************/
+void RegressionSuite::DestroyFrameScene()
+{
+	if (NULL != m_pFrameRunner)
+	{
+		delete m_pFrameRunner;
+		m_pFrameRunner = NULL;
+	}
+	if (NULL != m_pFrameScene)
+	{
+		delete m_pFrameScene;
+		m_pFrameScene = NULL;
+	}
+	m_frameSceneObjects = 0;
+}
+
+/***********************************************************
+ *  RenderSyntheticFrame()
+ *
+ *  This method is used for rendering one frame of the
+ *  generated scene into the offscreen frame buffer, with
+ *  the camera at a pose of the benchmark camera path.
+ ***********************************************************/
+void RegressionSuite::RenderSyntheticFrame(int frame)
+{
+	m_pFrameRunner->BeginFrame(frame % g_FramePathLength);
+
+	glEnable(GL_DEPTH_TEST);
+	glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+
+	m_pViewManager->PrepareSceneView();
+	m_pFrameScene->SetViewCount(1);
+	m_pFrameScene->SetViewParameters(
+		0,
+		m_pViewManager->GetViewMatrix(),
+		m_pViewManager->GetProjectionMatrix(),
+		m_pViewManager->GetViewPosition());
+	m_pFrameScene->SetViewport(0, 0, 0, g_FrameWidth, g_FrameHeight);
+	m_pFrameScene->RenderScene();
+
+	m_pFrameRunner->EndFrame();
+}
+
+/***********************************************************
+ *  TimeFindTextureSlot()
+ *
+ *  This method is used for timing the lookup of a texture
+ *  slot by tag, in a table of the passed in number of tags.
+ *  Only the table is filled, no textures are created.
+ ***********************************************************/
+double RegressionSuite::TimeFindTextureSlot(int argument, int iterations)
+{
+	SceneManager* pScene = GetLookupScene();
+	int found = 0;
+
+	if (m_seededTextureSlots != argument)
+	{
+		FillLookupTags("texture", argument);
+		pScene->SeedTextureSlots(m_lookupTags);
+		m_seededTextureSlots = argument;
+	}
+
+	StartTiming();
+	for (int i = 0; i < iterations; i++)
+	{
+		found += pScene->FindTextureSlot(m_lookupTags[i % argument]);
+	}
+	double seconds = StopTiming();
+
+	g_ResultSink += found;
+	m_itemsProcessed = iterations;
+
+	return(seconds);
+}
+
+/***********************************************************
+ *  TimeFindMaterial()
+ *
+ *  This method is used for timing the lookup of a material
+ *  by tag, among the passed in number of materials.
+ ***********************************************************/
+double RegressionSuite::TimeFindMaterial(int argument, int iterations)
+{
+	SceneManager* pScene = GetLookupScene();
+	SceneManager::OBJECT_MATERIAL material;
+	int found = 0;
+
+	if (m_seededMaterials != argument)
+	{
+		std::vector<SceneManager::OBJECT_MATERIAL> materials;
+
+		FillLookupTags("material", argument);
+		for (int i = 0; i < m_lookupTags.size(); i++)
+		{
+			material.diffuseColor = glm::vec3(1.0f);
+			material.specularColor = glm::vec3(0.5f);
+			material.shininess = 32.0f;
+			material.tag = m_lookupTags[i];
+			materials.push_back(material);
+		}
+		pScene->SeedMaterials(materials);
+		m_seededMaterials = argument;
+	}
+
+	StartTiming();
+	for (int i = 0; i < iterations; i++)
+	{
+		found += pScene->FindMaterial(m_lookupTags[i % argument], material) ? 1 : 0;
+	}
+	double seconds = StopTiming();
+
+	g_ResultSink += found;
+	m_itemsProcessed = iterations;
+
+	return(seconds);
+}
+
+/***********************************************************
+ *  TimeSetTransformations()
+ *
+ *  This method is used for timing the passed in number of
+ *  calls to SetTransformations() per iteration, which build
+ *  the model matrix and set it into the shader.
+ ***********************************************************/
+double RegressionSuite::TimeSetTransformations(int argument, int iterations)
+{
+	SceneManager* pScene = GetLookupScene();
+
+	StartTiming();
+	for (int i = 0; i < iterations; i++)
+	{
+		for (int j = 0; j < argument; j++)
+		{
+			float value = (float)(j % 360);
+			pScene->SetTransformations(
+				glm::vec3(1.0f + value * 0.01f),
+				value, value * 0.5f, 0.0f,
+				glm::vec3(value * 0.1f, 0.0f, -value * 0.1f));
+		}
+	}
+	glFinish();
+	double seconds = StopTiming();
+
+	m_itemsProcessed = (double)iterations * argument;
+
+	return(seconds);
+}
+
+/***********************************************************
+ *  TimeCreateGLTexture()
+ *
+ *  This method is used for timing a texture of the passed in
+ *  size going through CreateGLTexture(), from the image
+ *  being decoded in the background to its upload, until
+ *  the scene has no textures loading anymore.  Freeing the
+ *  texture is not timed.
+ ***********************************************************/
+double RegressionSuite::TimeCreateGLTexture(int argument, int iterations)
+{
+	SceneManager* pScene = GetLookupScene();
+	std::string filename = WriteTestImage(argument);
+	double seconds = 0.0;
+
+	for (int i = 0; i < iterations; i++)
+	{
+		StartTiming();
+		pScene->CreateGLTexture(filename.c_str(), "regressionTexture");
+		while (pScene->IsLoadingTextures())
+		{
+			pScene->UpdateGLTextures();
+			std::this_thread::yield();
+		}
+		glFinish();
+		seconds += StopTiming();
+
+		pScene->DestroyGLTextures();
+	}
+
+	m_itemsProcessed = (double)iterations * argument * argument;
+
+	return(seconds);
+}
+
+/***********************************************************
+ *  TimeLoadShapeMesh()
+ *
+ *  This method is used for timing the generation and upload
+ *  of one of the basic meshes, picked by the argument.  A
+ *  fresh ShapeMeshes object loads the mesh every time.
+ ***********************************************************/
+double RegressionSuite::TimeLoadShapeMesh(int argument, int iterations)
+{
+	const SHAPE_MESH_LOADER& loader = g_MeshLoaders[argument];
+	double seconds = 0.0;
+
+	for (int i = 0; i < iterations; i++)
+	{
+		ShapeMeshes* pMeshes = new ShapeMeshes();
+
+		StartTiming();
+		(pMeshes->*loader.load)();
+		glFinish();
+		seconds += StopTiming();
+
+		delete pMeshes;
+	}
+
+	m_label = loader.name;
+	m_itemsProcessed = iterations;
+
+	return(seconds);
+}
+
+/***********************************************************
+ *  TimeRenderFrame()
+ *
+ *  This method is used for timing whole frames of the
+ *  generated scene of the passed in number of objects, from
+ *  preparing the view to the GPU finishing the frames.  The
+ *  camera keeps moving along the benchmark path between the
+ *  runs.
+ ***********************************************************/
+double RegressionSuite::TimeRenderFrame(int argument, int iterations)
+{
+	if (PrepareFrameScene(argument) == false)
+	{
+		m_bCaseFailed = true;
+		return(0.0);
+	}
+
+	m_pFrameRunner->BeginRun(g_FramePathLength);
+
+	StartTiming();
+	for (int i = 0; i < iterations; i++)
+	{
+		RenderSyntheticFrame(m_frameIndex++);
+	}
+	glFinish();
+	double seconds = StopTiming();
+
+	m_itemsProcessed = (double)iterations * argument;
+
+	return(seconds);
+}
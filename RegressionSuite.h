@@ -0,0 +1,167 @@
+///////////////////////////////////////////////////////////////////////////////
+// regressionsuite.h
+// ============
+// time the scene pipeline components over a range of sizes - scaling, regressions
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "BenchmarkRunner.h"
+#include "SceneManager.h"
+#include "ShaderManager.h"
+#include "UniformCache.h"
+#include "ViewManager.h"
+
+#include <chrono>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  RegressionSuite
+ *
+ *  This class times the parts of the scene pipeline that
+ *  were optimized, each at a range of sizes so every one
+ *  gets a scaling curve.  Like Google Benchmark, a case is
+ *  run with more and more iterations until it takes long
+ *  enough to be timed, and the fastest of a few repetitions
+ *  is kept.  The results are written to JSON and compared
+ *  with the results of an earlier run, and a case that got
+ *  slower than its threshold is marked as a regression, as
+ *  is a case that could not be run at all.
+ ***********************************************************/
+class RegressionSuite
+{
+public:
+	// constructor
+	RegressionSuite(
+		ShaderManager* pShaderManager,
+		UniformCache* pUniformCache,
+		ViewManager* pViewManager);
+	// destructor
+	~RegressionSuite();
+
+	// the timing of one case at one size
+	struct CASE_RESULT
+	{
+		std::string name;
+		int argument;
+		// what the argument stands for, when the case names it
+		std::string label;
+		int iterations;
+		// time of one iteration, in nanoseconds
+		double time;
+		// items handled per second, or 0 when the case does not count them
+		double itemsPerSecond;
+		// time of the baseline run, or 0 without one, and the
+		// slowest time that is not a regression
+		double baselineTime;
+		double thresholdTime;
+		bool bRegressed;
+		// true when the case could not be run at this size, it has no time
+		bool bFailed;
+	};
+
+private:
+	// a case runs the passed in number of iterations at one size,
+	// and returns the seconds its timed part took
+	typedef double (RegressionSuite::*CASE_FUNCTION)(int argument, int iterations);
+
+	struct BENCHMARK_CASE
+	{
+		const char* name;
+		CASE_FUNCTION function;
+		// the sizes the case is run at
+		std::vector<int> arguments;
+		// most iterations of one run
+		int maxIterations;
+	};
+
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// pointer to cached shader uniform locations
+	UniformCache* m_pUniformCache;
+	// pointer to the view manager the frames are prepared with
+	ViewManager* m_pViewManager;
+	// the registered cases and the results of the last run
+	std::vector<BENCHMARK_CASE> m_cases;
+	std::vector<CASE_RESULT> m_results;
+	// baseline time of every case and size, by name and argument
+	std::unordered_map<std::string, double> m_baseline;
+	// part a case may be slower than its baseline before it is a regression
+	double m_tolerance;
+	// items handled and the label set by the last run of a case
+	double m_itemsProcessed;
+	std::string m_label;
+	// set by a case that could not be run, so its time is not kept
+	bool m_bCaseFailed;
+	// when the timed part of a case started
+	std::chrono::steady_clock::time_point m_startTime;
+
+	// scene whose lookup tables, textures and uniforms the small cases use
+	SceneManager* m_pLookupScene;
+	// number of texture tags and materials the lookup scene was seeded with
+	int m_seededTextureSlots;
+	int m_seededMaterials;
+	// tags looked up, in a shuffled order
+	std::vector<std::string> m_lookupTags;
+	// image files written for the texture cases
+	std::vector<std::string> m_imageFiles;
+	// generated scene the frames are rendered with, its number of
+	// objects, the offscreen frame buffer and the next camera frame
+	SceneManager* m_pFrameScene;
+	int m_frameSceneObjects;
+	BenchmarkRunner* m_pFrameRunner;
+	int m_frameIndex;
+
+	// get the sizes from first to last, growing by the multiplier
+	static std::vector<int> Range(int first, int last, int multiplier);
+	// get every size from first to last
+	static std::vector<int> DenseRange(int first, int last);
+	// get the key of a case and size in the baseline
+	static std::string MakeKey(const std::string& name, int argument);
+
+	// add a case to the suite
+	void AddCase(const char* name, CASE_FUNCTION function, const std::vector<int>& arguments, int maxIterations);
+	// run a case at one size and record the fastest repetition
+	void RunCase(const BENCHMARK_CASE& benchmarkCase, int argument);
+	// start and stop timing the part of a case that is measured
+	void StartTiming();
+	double StopTiming() const;
+
+	// get the scene the small cases use, created the first time
+	SceneManager* GetLookupScene();
+	// fill the tags of the lookup cases, shuffled
+	void FillLookupTags(const char* prefix, int count);
+	// write an image file of the passed in size for the texture cases
+	std::string WriteTestImage(int size);
+	// prepare the generated scene of the passed in number of objects
+	bool PrepareFrameScene(int objectCount);
+	// free the generated scene and its frame buffer
+	void DestroyFrameScene();
+	// render one frame of the generated scene along the camera path
+	void RenderSyntheticFrame(int frame);
+
+	// the cases
+	double TimeFindTextureSlot(int argument, int iterations);
+	double TimeFindMaterial(int argument, int iterations);
+	double TimeSetTransformations(int argument, int iterations);
+	double TimeCreateGLTexture(int argument, int iterations);
+	double TimeLoadShapeMesh(int argument, int iterations);
+	double TimeRenderFrame(int argument, int iterations);
+
+public:
+	// read the results of an earlier run that the times are compared with
+	bool LoadBaseline(const char* filename);
+	// set the part a case may be slower than its baseline
+	void SetTolerance(double tolerance);
+
+	// run every case at every one of its sizes
+	void Run();
+	// write the results and their thresholds to a JSON file
+	bool WriteResults(const char* filename) const;
+	// get the number of results that failed or are slower than their thresholds
+	int GetRegressionCount() const;
+};
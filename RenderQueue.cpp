@@ -0,0 +1,257 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.cpp
+// ============
+// collect draw packets and sort them by render state - sort keys
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderQueue.h"
+
+#include <algorithm>
+
+// declaration of global variables and defines
+namespace
+{
+	// view distance the depth field covers by default
+	const float g_DefaultMaxDepth = 100.0f;
+
+	/***********************************************************
+	 *  PackField()
+	 *
+	 *  This function is used for clamping a value to the width
+	 *  of a sort key field.
+	 ***********************************************************/
+	uint64_t PackField(int value, int bits)
+	{
+		const int maxValue = (1 << bits) - 1;
+
+		if (value < 0)
+		{
+			value = 0;
+		}
+		if (value > maxValue)
+		{
+			value = maxValue;
+		}
+
+		return((uint64_t)value);
+	}
+
+	/***********************************************************
+	 *  ComparePackets()
+	 *
+	 *  This function is used for ordering draw packets by their
+	 *  keys.  Equal keys keep the order of the draw list, so the
+	 *  submission order is the same every frame.
+	 ***********************************************************/
+	bool ComparePackets(const RenderQueue::DRAW_PACKET& a, const RenderQueue::DRAW_PACKET& b)
+	{
+		if (a.sortKey != b.sortKey)
+		{
+			return(a.sortKey < b.sortKey);
+		}
+		return(a.instanceIndex < b.instanceIndex);
+	}
+}
+
+/***********************************************************
+ *  RenderQueue()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderQueue::RenderQueue()
+{
+	m_maxDepth = g_DefaultMaxDepth;
+}
+
+/***********************************************************
+ *  ~RenderQueue()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RenderQueue::~RenderQueue()
+{
+	m_packets.clear();
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all of the draw packets
+ *  while keeping the allocated memory for the next frame.
+ ***********************************************************/
+void RenderQueue::Clear()
+{
+	m_packets.clear();
+}
+
+/***********************************************************
+ *  SetDepthRange()
+ *
+ *  This method is used for setting the farthest view
+ *  distance that the depth field of the sort key covers,
+ *  which is normally the far plane of the projection.
+ ***********************************************************/
+void RenderQueue::SetDepthRange(float maxDepth)
+{
+	if (maxDepth > 0.0f)
+	{
+		m_maxDepth = maxDepth;
+	}
+}
+
+/***********************************************************
+ *  AddPacket()
+ *
+ *  This method is used for adding a draw packet to the queue.
+ ***********************************************************/
+void RenderQueue::AddPacket(uint64_t sortKey, int batchIndex, int instanceIndex)
+{
+	DRAW_PACKET packet;
+
+	packet.sortKey = sortKey;
+	packet.batchIndex = batchIndex;
+	packet.instanceIndex = instanceIndex;
+	packet.lod = 0;
+	packet.lodFade = 0.0f;
+
+	m_packets.push_back(packet);
+}
+
+/***********************************************************
+ *  Sort()
+ *
+ *  This method is used for sorting the draw packets by their
+ *  keys, so draws that share state end up next to each other.
+ ***********************************************************/
+void RenderQueue::Sort()
+{
+	SortPackets(m_packets);
+}
+
+/***********************************************************
+ *  MergePackets()
+ *
+ *  This method is used for merging packets that are already
+ *  sorted into the sorted queue.  Merging the sorted parts of
+ *  a frame gives the same order as sorting them together,
+ *  since equal keys are ordered by instance.
+ ***********************************************************/
+void RenderQueue::MergePackets(const std::vector<DRAW_PACKET>& packets)
+{
+	size_t sortedCount = m_packets.size();
+
+	m_packets.insert(m_packets.end(), packets.begin(), packets.end());
+	std::inplace_merge(m_packets.begin(), m_packets.begin() + sortedCount, m_packets.end(), ComparePackets);
+}
+
+/***********************************************************
+ *  SortPackets()
+ *
+ *  This method is used for sorting draw packets outside of a
+ *  queue the same way as Sort(), so parts of a frame can be
+ *  sorted on their own threads.
+ ***********************************************************/
+void RenderQueue::SortPackets(std::vector<DRAW_PACKET>& packets)
+{
+	std::sort(packets.begin(), packets.end(), ComparePackets);
+}
+
+/***********************************************************
+ *  MakeSortKey()
+ *
+ *  This method is used for building the sort key of a draw.
+ *  The fields that are the most expensive to change are put
+ *  in the highest bits, and the view depth in the lowest bits
+ *  orders draws of the same state front to back, so hidden
+ *  fragments fail the depth test early.
+ ***********************************************************/
+uint64_t RenderQueue::MakeSortKey(
+	int pass,
+	int group,
+	int program,
+	int textureSlot,
+	int materialIndex,
+	int mesh,
+	float viewDepth) const
+{
+	uint64_t sortKey = 0;
+
+	sortKey = PackField(pass, PASS_BITS);
+	sortKey = (sortKey << GROUP_BITS) | PackField(group, GROUP_BITS);
+	sortKey = (sortKey << PROGRAM_BITS) | PackField(program, PROGRAM_BITS);
+	sortKey = (sortKey << TEXTURE_BITS) | PackField(textureSlot + 1, TEXTURE_BITS);
+	sortKey = (sortKey << MATERIAL_BITS) | PackField(materialIndex + 1, MATERIAL_BITS);
+	sortKey = (sortKey << MESH_BITS) | PackField(mesh, MESH_BITS);
+	sortKey = (sortKey << DEPTH_BITS) | PackField(QuantizeDepth(viewDepth), DEPTH_BITS);
+
+	return(sortKey);
+}
+
+/***********************************************************
+ *  MakeBackToFrontKey()
+ *
+ *  This method is used for building the sort key of a draw
+ *  that has to be ordered back to front, like a transparent
+ *  object blended over the scene.  The inverted depth is put
+ *  right below the pass, so the farthest draw comes first
+ *  and the render state does not change the order.
+ ***********************************************************/
+uint64_t RenderQueue::MakeBackToFrontKey(int pass, float viewDepth) const
+{
+	const int maxDepth = (1 << DEPTH_BITS) - 1;
+	const int stateBits = GROUP_BITS + PROGRAM_BITS + TEXTURE_BITS + MATERIAL_BITS + MESH_BITS;
+	uint64_t sortKey = 0;
+
+	sortKey = PackField(pass, PASS_BITS);
+	sortKey = (sortKey << DEPTH_BITS) | PackField(maxDepth - QuantizeDepth(viewDepth), DEPTH_BITS);
+	sortKey = sortKey << stateBits;
+
+	return(sortKey);
+}
+
+/***********************************************************
+ *  QuantizeDepth()
+ *
+ *  This method is used for converting a view depth into an
+ *  integer that fits the depth field of the sort key.
+ ***********************************************************/
+int RenderQueue::QuantizeDepth(float viewDepth) const
+{
+	const int maxDepth = (1 << DEPTH_BITS) - 1;
+	float depth = viewDepth / m_maxDepth;
+
+	if (depth < 0.0f)
+	{
+		depth = 0.0f;
+	}
+	if (depth > 1.0f)
+	{
+		depth = 1.0f;
+	}
+
+	return((int)(depth * maxDepth));
+}
+
+/***********************************************************
+ *  GetPacketCount()
+ *
+ *  This method is used for getting the number of draw
+ *  packets in the queue.
+ ***********************************************************/
+int RenderQueue::GetPacketCount() const
+{
+	return(m_packets.size());
+}
+
+/***********************************************************
+ *  GetPacket()
+ *
+ *  This method is used for getting the draw packet at the
+ *  passed in position of the sorted queue.
+ ***********************************************************/
+const RenderQueue::DRAW_PACKET& RenderQueue::GetPacket(int index) const
+{
+	return(m_packets[index]);
+}
@@ -0,0 +1,116 @@
+///////////////////////////////////////////////////////////////////////////////
+// renderqueue.h
+// ============
+// collect draw packets and sort them by render state - sort keys
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+/***********************************************************
+ *  RenderQueue
+ *
+ *  This class collects the draw packets of a frame, each with
+ *  a 64 bit sort key, and sorts them so that draws sharing
+ *  the same render state are submitted next to each other.
+ *  The fields of the key, from the most to least significant
+ *  bits, are:
+ *
+ *    pass     (4 bits)   render pass, opaque before transparent
+ *    group    (8 bits)   object group, only when profiling groups
+ *    program  (4 bits)   shader program, the costliest state change
+ *    texture  (12 bits)  texture slot + 1, 0 for solid colors
+ *    material (12 bits)  material index + 1, 0 for no material
+ *    mesh     (8 bits)   basic mesh type, then imported meshes
+ *    depth    (16 bits)  quantized view depth, front to back
+ *
+ *  The scene is drawn with one shader program for now, so
+ *  every draw passes program 0.  The field is kept so a
+ *  second program sorts above the textures without moving
+ *  the other fields.
+ *
+ *  Transparent draws have to be ordered back to front no
+ *  matter their state, so their key only holds the pass and
+ *  the inverted view depth right below it.
+ ***********************************************************/
+class RenderQueue
+{
+public:
+	// constructor
+	RenderQueue();
+	// destructor
+	~RenderQueue();
+
+	// one draw in the queue
+	struct DRAW_PACKET
+	{
+		uint64_t sortKey;
+		// instance batch and instance the packet draws
+		int batchIndex;
+		int instanceIndex;
+		// level of detail of the mesh, and how far the level is
+		// dithered in or out of a crossfade, 0 when it is not
+		int lod;
+		float lodFade;
+	};
+
+	// the render passes, in the order they are drawn
+	enum RENDER_PASS
+	{
+		RENDER_PASS_OPAQUE = 0,
+		RENDER_PASS_TRANSPARENT
+	};
+
+	// the field widths of the sort key
+	static const int PASS_BITS = 4;
+	static const int GROUP_BITS = 8;
+	static const int PROGRAM_BITS = 4;
+	static const int TEXTURE_BITS = 12;
+	static const int MATERIAL_BITS = 12;
+	static const int MESH_BITS = 8;
+	static const int DEPTH_BITS = 16;
+
+private:
+	// the draw packets of the frame
+	std::vector<DRAW_PACKET> m_packets;
+	// farthest view distance that still gets its own depth value
+	float m_maxDepth;
+
+	// quantize a view depth to the width of the depth field
+	int QuantizeDepth(float viewDepth) const;
+
+public:
+	// remove all of the draw packets
+	void Clear();
+	// set the farthest view distance the depth field covers
+	void SetDepthRange(float maxDepth);
+	// add a draw packet to the queue
+	void AddPacket(uint64_t sortKey, int batchIndex, int instanceIndex);
+	// sort the draw packets by their keys
+	void Sort();
+	// merge already sorted packets into the sorted queue
+	void MergePackets(const std::vector<DRAW_PACKET>& packets);
+	// sort packets that are not in a queue the same way
+	static void SortPackets(std::vector<DRAW_PACKET>& packets);
+
+	// build the sort key of a draw from its render state
+	uint64_t MakeSortKey(
+		int pass,
+		int group,
+		int program,
+		int textureSlot,
+		int materialIndex,
+		int mesh,
+		float viewDepth) const;
+	// build the sort key of a draw that is ordered back to front
+	uint64_t MakeBackToFrontKey(int pass, float viewDepth) const;
+
+	// get the number of draw packets in the queue
+	int GetPacketCount() const;
+	// get the draw packet at the passed in position
+	const DRAW_PACKET& GetPacket(int index) const;
+};
@@ -0,0 +1,256 @@
+///////////////////////////////////////////////////////////////////////////////
+// rendertarget.cpp
+// ============
+// render the scene offscreen at a scaled resolution and upscale it to the window
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "RenderTarget.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+/***********************************************************
+ *  RenderTarget()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+RenderTarget::RenderTarget()
+{
+	m_framebuffer = 0;
+	m_colorBuffer = 0;
+	m_depthBuffer = 0;
+	m_allocatedWidth = 0;
+	m_allocatedHeight = 0;
+	m_maxScale = 1.0f;
+	m_windowWidth = 0;
+	m_windowHeight = 0;
+	m_width = 0;
+	m_height = 0;
+	m_previousFramebuffer = 0;
+	m_bOffscreen = false;
+}
+
+/***********************************************************
+ *  ~RenderTarget()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+RenderTarget::~RenderTarget()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  SetMaxScale()
+ *
+ *  This method is used for setting the largest scale of the
+ *  window resolution the scene is rendered at.  Scales above
+ *  1 render more pixels than the window and filter them down.
+ ***********************************************************/
+void RenderTarget::SetMaxScale(float maxScale)
+{
+	m_maxScale = std::min(std::max(maxScale, MIN_SCALE), MAX_SCALE);
+}
+
+/***********************************************************
+ *  GetMaxScale()
+ *
+ *  This method is used for getting the largest scale of the
+ *  window resolution the scene is rendered at.
+ ***********************************************************/
+float RenderTarget::GetMaxScale() const
+{
+	return(m_maxScale);
+}
+
+/***********************************************************
+ *  CreateFramebuffer()
+ *
+ *  This method is used for allocating the color and depth
+ *  attachments of the offscreen frame buffer.
+ ***********************************************************/
+bool RenderTarget::CreateFramebuffer(int width, int height)
+{
+	DestroyFramebuffer();
+
+	glGenRenderbuffers(1, &m_colorBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_colorBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+
+	glGenRenderbuffers(1, &m_depthBuffer);
+	glBindRenderbuffer(GL_RENDERBUFFER, m_depthBuffer);
+	glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+	glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, m_colorBuffer);
+	glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, m_depthBuffer);
+
+	GLenum status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_previousFramebuffer);
+
+	if (GL_FRAMEBUFFER_COMPLETE != status)
+	{
+		std::cout << "Render target frame buffer is not complete:" << status << std::endl;
+		DestroyFramebuffer();
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyFramebuffer()
+ *
+ *  This method is used for freeing the offscreen frame
+ *  buffer and its attachments.
+ ***********************************************************/
+void RenderTarget::DestroyFramebuffer()
+{
+	if (0 != m_framebuffer)
+	{
+		glDeleteFramebuffers(1, &m_framebuffer);
+		m_framebuffer = 0;
+	}
+	if (0 != m_colorBuffer)
+	{
+		glDeleteRenderbuffers(1, &m_colorBuffer);
+		m_colorBuffer = 0;
+	}
+	if (0 != m_depthBuffer)
+	{
+		glDeleteRenderbuffers(1, &m_depthBuffer);
+		m_depthBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  Begin()
+ *
+ *  This method is used for binding the frame buffer that
+ *  the scene is rendered into at the passed in scale of the
+ *  window, and setting the viewport to the scaled size.  The
+ *  attachments are reallocated when the window was resized.
+ *  False is returned when the frame is rendered straight
+ *  into the window, at a scale of 1 or when the attachments
+ *  could not be allocated.
+ ***********************************************************/
+bool RenderTarget::Begin(int windowWidth, int windowHeight, float scale)
+{
+	scale = std::min(std::max(scale, MIN_SCALE), m_maxScale);
+
+	m_windowWidth = windowWidth;
+	m_windowHeight = windowHeight;
+	m_width = windowWidth;
+	m_height = windowHeight;
+	m_bOffscreen = false;
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousFramebuffer);
+
+	// a minimized window has nothing to render into
+	if ((windowWidth <= 0) || (windowHeight <= 0))
+	{
+		return(false);
+	}
+
+	int width = std::max((int)((windowWidth * scale) + 0.5f), 1);
+	int height = std::max((int)((windowHeight * scale) + 0.5f), 1);
+	if ((width == windowWidth) && (height == windowHeight))
+	{
+		glViewport(0, 0, windowWidth, windowHeight);
+		return(false);
+	}
+
+	// the allocation is only tried again once the window size changes
+	int allocatedWidth = (int)ceilf(windowWidth * m_maxScale);
+	int allocatedHeight = (int)ceilf(windowHeight * m_maxScale);
+	if ((allocatedWidth != m_allocatedWidth) || (allocatedHeight != m_allocatedHeight))
+	{
+		m_allocatedWidth = allocatedWidth;
+		m_allocatedHeight = allocatedHeight;
+		CreateFramebuffer(allocatedWidth, allocatedHeight);
+	}
+	if (0 == m_framebuffer)
+	{
+		glViewport(0, 0, windowWidth, windowHeight);
+		return(false);
+	}
+
+	m_width = std::min(width, m_allocatedWidth);
+	m_height = std::min(height, m_allocatedHeight);
+	m_bOffscreen = true;
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glViewport(0, 0, m_width, m_height);
+
+	return(true);
+}
+
+/***********************************************************
+ *  End()
+ *
+ *  This method is used for blitting the rendered part of
+ *  the offscreen frame buffer over the whole previous frame
+ *  buffer with linear filtering, and binding it again.  The
+ *  depth is not needed after the frame, so the driver is
+ *  told it does not have to keep it.
+ ***********************************************************/
+void RenderTarget::End()
+{
+	if (!m_bOffscreen)
+	{
+		return;
+	}
+
+	if (GLEW_ARB_invalidate_subdata)
+	{
+		const GLenum attachment = GL_DEPTH_STENCIL_ATTACHMENT;
+		glInvalidateFramebuffer(GL_FRAMEBUFFER, 1, &attachment);
+	}
+
+	glBindFramebuffer(GL_READ_FRAMEBUFFER, m_framebuffer);
+	glBindFramebuffer(GL_DRAW_FRAMEBUFFER, m_previousFramebuffer);
+	glBlitFramebuffer(
+		0, 0, m_width, m_height,
+		0, 0, m_windowWidth, m_windowHeight,
+		GL_COLOR_BUFFER_BIT, GL_LINEAR);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_previousFramebuffer);
+	glViewport(0, 0, m_windowWidth, m_windowHeight);
+	m_bOffscreen = false;
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the offscreen frame
+ *  buffer, it is allocated again by the next frame that
+ *  needs it.
+ ***********************************************************/
+void RenderTarget::Destroy()
+{
+	DestroyFramebuffer();
+	m_allocatedWidth = 0;
+	m_allocatedHeight = 0;
+}
+
+/***********************************************************
+ *  GetWidth()
+ *  GetHeight()
+ *
+ *  These methods are used for getting the size the scene is
+ *  being rendered at, which is the window size when it is
+ *  rendered straight into the window.
+ ***********************************************************/
+int RenderTarget::GetWidth() const
+{
+	return(m_width);
+}
+
+int RenderTarget::GetHeight() const
+{
+	return(m_height);
+}
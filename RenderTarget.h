@@ -0,0 +1,79 @@
+///////////////////////////////////////////////////////////////////////////////
+// rendertarget.h
+// ============
+// render the scene offscreen at a scaled resolution and upscale it to the window
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+/***********************************************************
+ *  RenderTarget
+ *
+ *  This class renders the scene into an offscreen frame
+ *  buffer at a scale of the window resolution, then blits
+ *  it with linear filtering onto the frame buffer that was
+ *  bound before, which is the window or the benchmark frame
+ *  buffer.  The attachments are sized for the largest scale
+ *  and only reallocated when the window is resized, so the
+ *  scale can change every frame by rendering into a smaller
+ *  part of them.  At a scale of 1 the scene is rendered
+ *  straight into the window and nothing is copied.
+ ***********************************************************/
+class RenderTarget
+{
+public:
+	// constructor
+	RenderTarget();
+	// destructor
+	~RenderTarget();
+
+	// the range of scales the scene can be rendered at
+	static constexpr float MIN_SCALE = 0.25f;
+	static constexpr float MAX_SCALE = 2.0f;
+
+private:
+	// offscreen frame buffer and its attachments
+	GLuint m_framebuffer;
+	GLuint m_colorBuffer;
+	GLuint m_depthBuffer;
+	// size the attachments were allocated with
+	int m_allocatedWidth;
+	int m_allocatedHeight;
+	// largest scale the attachments are allocated for
+	float m_maxScale;
+	// size of the window and of the scaled frame being rendered
+	int m_windowWidth;
+	int m_windowHeight;
+	int m_width;
+	int m_height;
+	// frame buffer that was bound when the frame started
+	GLint m_previousFramebuffer;
+	// true while the frame is rendered offscreen
+	bool m_bOffscreen;
+
+	// allocate the attachments for the passed in size
+	bool CreateFramebuffer(int width, int height);
+	// free the offscreen frame buffer and its attachments
+	void DestroyFramebuffer();
+
+public:
+	// set the largest scale of the window resolution that is rendered at
+	void SetMaxScale(float maxScale);
+	// get the largest scale of the window resolution
+	float GetMaxScale() const;
+
+	// bind the frame buffer the scene is rendered into at the passed in scale
+	bool Begin(int windowWidth, int windowHeight, float scale);
+	// upscale the rendered frame onto the previous frame buffer
+	void End();
+	// free the offscreen frame buffer
+	void Destroy();
+
+	// get the size the scene is being rendered at
+	int GetWidth() const;
+	int GetHeight() const;
+};
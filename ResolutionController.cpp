@@ -0,0 +1,193 @@
+///////////////////////////////////////////////////////////////////////////////
+// resolutioncontroller.cpp
+// ============
+// adjust the render scale to keep the GPU time of the frame within a budget
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ResolutionController.h"
+
+#include <algorithm>
+#include <cmath>
+
+// declaration of global variables and defines
+namespace
+{
+	// frames after a change whose times were still measured at the
+	// old scale, a little more than the frames the profiler delays
+	const int g_SettleFrames = 6;
+	// frames measured at a scale before it is changed again
+	const int g_MeasureFrames = 10;
+	// a frame this far over the target drops the scale right away
+	const double g_SpikeFactor = 1.5;
+	// the scale only grows while the frames stay below this part
+	// of the target, so the grown scale still fits
+	const double g_GrowFactor = 0.8;
+	// a dropped scale aims a little below the target, since not all
+	// of the GPU time shrinks with the pixels
+	const float g_DropMargin = 0.97f;
+	// the largest step the scale grows by at once
+	const float g_GrowStep = 0.05f;
+	// smaller changes are not made, so the image does not shimmer
+	const float g_MinChange = 0.02f;
+}
+
+/***********************************************************
+ *  ResolutionController()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ResolutionController::ResolutionController()
+{
+	m_bEnabled = false;
+	m_targetTime = 1000.0 / 60.0;
+	m_minScale = 0.5f;
+	m_maxScale = 1.0f;
+	m_scale = 1.0f;
+	m_framesSinceChange = 0;
+	m_timeSum = 0.0;
+	m_timeCount = 0;
+}
+
+/***********************************************************
+ *  ~ResolutionController()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ResolutionController::~ResolutionController()
+{
+}
+
+/***********************************************************
+ *  SetEnabled()
+ *
+ *  This method is used for turning the adjusting of the
+ *  scale on or off.  When it is off the scene is rendered at
+ *  the largest scale of the range.
+ ***********************************************************/
+void ResolutionController::SetEnabled(bool bEnabled)
+{
+	m_bEnabled = bEnabled;
+	ChangeScale(m_maxScale);
+}
+
+/***********************************************************
+ *  IsEnabled()
+ *
+ *  This method is used for checking whether the scale is
+ *  adjusted to the GPU time of the frames.
+ ***********************************************************/
+bool ResolutionController::IsEnabled() const
+{
+	return(m_bEnabled);
+}
+
+/***********************************************************
+ *  SetTargetTime()
+ *
+ *  This method is used for setting the GPU time in
+ *  milliseconds that the frames should fit in.
+ ***********************************************************/
+void ResolutionController::SetTargetTime(double targetTime)
+{
+	m_targetTime = std::max(targetTime, 1.0);
+}
+
+/***********************************************************
+ *  SetScaleRange()
+ *
+ *  This method is used for setting the range the scale is
+ *  kept in, starting again from the largest scale.
+ ***********************************************************/
+void ResolutionController::SetScaleRange(float minScale, float maxScale)
+{
+	m_minScale = std::min(minScale, maxScale);
+	m_maxScale = maxScale;
+	ChangeScale(m_maxScale);
+}
+
+/***********************************************************
+ *  ChangeScale()
+ *
+ *  This method is used for changing the scale and starting
+ *  to measure the frames rendered at it.
+ ***********************************************************/
+void ResolutionController::ChangeScale(float scale)
+{
+	m_scale = std::min(std::max(scale, m_minScale), m_maxScale);
+	m_framesSinceChange = 0;
+	m_timeSum = 0.0;
+	m_timeCount = 0;
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for passing in the GPU time of a
+ *  measured frame, in milliseconds, and getting the scale
+ *  the next frame is rendered at.  A negative time means the
+ *  frame could not be measured and is skipped.
+ ***********************************************************/
+float ResolutionController::Update(double gpuTime)
+{
+	if ((!m_bEnabled) || (gpuTime < 0.0))
+	{
+		return(m_scale);
+	}
+
+	// the first frames after a change were rendered at the old scale
+	m_framesSinceChange++;
+	if (m_framesSinceChange <= g_SettleFrames)
+	{
+		return(m_scale);
+	}
+
+	m_timeSum += gpuTime;
+	m_timeCount++;
+
+	bool bSpike = (gpuTime > m_targetTime * g_SpikeFactor);
+	if ((!bSpike) && (m_timeCount < g_MeasureFrames))
+	{
+		return(m_scale);
+	}
+
+	// the time grows with the pixels, the square of the scale
+	double meanTime = bSpike ? gpuTime : (m_timeSum / m_timeCount);
+	float fitScale = m_scale * (float)sqrt(m_targetTime / std::max(meanTime, 0.001));
+	float scale = m_scale;
+
+	if (meanTime > m_targetTime)
+	{
+		scale = fitScale * g_DropMargin;
+	}
+	else if (meanTime < m_targetTime * g_GrowFactor)
+	{
+		scale = std::min(fitScale, m_scale + g_GrowStep);
+	}
+
+	scale = std::min(std::max(scale, m_minScale), m_maxScale);
+	if (fabsf(scale - m_scale) >= g_MinChange)
+	{
+		ChangeScale(scale);
+	}
+	else
+	{
+		// keep measuring at the same scale
+		m_timeSum = 0.0;
+		m_timeCount = 0;
+	}
+
+	return(m_scale);
+}
+
+/***********************************************************
+ *  GetScale()
+ *
+ *  This method is used for getting the scale the scene is
+ *  rendered at.
+ ***********************************************************/
+float ResolutionController::GetScale() const
+{
+	return(m_scale);
+}
@@ -0,0 +1,64 @@
+///////////////////////////////////////////////////////////////////////////////
+// resolutioncontroller.h
+// ============
+// adjust the render scale to keep the GPU time of the frame within a budget
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+/***********************************************************
+ *  ResolutionController
+ *
+ *  This class picks the scale the scene is rendered at from
+ *  the measured GPU time of the frames.  The GPU time of
+ *  the scene grows with the number of pixels, so the square
+ *  of the scale, and the scale that fits the target time is
+ *  found from the mean time of a few frames.  The scale
+ *  drops as soon as the frames take too long, so frames are
+ *  not missed, and grows back in small steps only while
+ *  there is room to spare, so it does not swing back and
+ *  forth.  The GPU times are read back a few frames late,
+ *  so the frames right after a change are not measured.
+ ***********************************************************/
+class ResolutionController
+{
+public:
+	// constructor
+	ResolutionController();
+	// destructor
+	~ResolutionController();
+
+private:
+	// true when the scale follows the measured times
+	bool m_bEnabled;
+	// GPU time the frames should fit in, in milliseconds
+	double m_targetTime;
+	// the range the scale is kept in, and the current scale
+	float m_minScale;
+	float m_maxScale;
+	float m_scale;
+	// frames since the scale last changed
+	int m_framesSinceChange;
+	// sum and count of the times measured at the current scale
+	double m_timeSum;
+	int m_timeCount;
+
+	// change the scale and start measuring it
+	void ChangeScale(float scale);
+
+public:
+	// turn the adjusting of the scale on or off
+	void SetEnabled(bool bEnabled);
+	bool IsEnabled() const;
+	// set the GPU time the frames should fit in, in milliseconds
+	void SetTargetTime(double targetTime);
+	// set the range the scale is kept in
+	void SetScaleRange(float minScale, float maxScale);
+
+	// pass in the GPU time of a measured frame and get the scale to render at
+	float Update(double gpuTime);
+	// get the scale to render at
+	float GetScale() const;
+};
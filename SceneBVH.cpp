@@ -0,0 +1,820 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebvh.cpp
+// ============
+// bounding volume hierarchy over the scene objects - culling, picking, ranges
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneBVH.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+/***********************************************************
+ *  SceneBVH()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneBVH::SceneBVH()
+{
+}
+
+/***********************************************************
+ *  ~SceneBVH()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneBVH::~SceneBVH()
+{
+	Clear();
+}
+
+/***********************************************************
+ *  SurfaceArea()
+ *
+ *  This method is used for getting the surface area of a
+ *  box, which the split cost is measured in.
+ ***********************************************************/
+float SceneBVH::SurfaceArea(const Frustum::BOUNDING_BOX& box)
+{
+	glm::vec3 size = box.max - box.min;
+
+	if ((size.x < 0.0f) || (size.y < 0.0f) || (size.z < 0.0f))
+	{
+		return(0.0f);
+	}
+
+	return(2.0f * ((size.x * size.y) + (size.y * size.z) + (size.z * size.x)));
+}
+
+/***********************************************************
+ *  EmptyBox()
+ *
+ *  This method is used for getting a box that holds nothing,
+ *  so growing it by any box gives that box.
+ ***********************************************************/
+Frustum::BOUNDING_BOX SceneBVH::EmptyBox()
+{
+	Frustum::BOUNDING_BOX box;
+
+	box.min = glm::vec3(FLT_MAX);
+	box.max = glm::vec3(-FLT_MAX);
+
+	return(box);
+}
+
+/***********************************************************
+ *  GrowBox()
+ *
+ *  This method is used for growing a box to hold another box.
+ ***********************************************************/
+void SceneBVH::GrowBox(Frustum::BOUNDING_BOX& box, const Frustum::BOUNDING_BOX& other)
+{
+	box.min = glm::min(box.min, other.min);
+	box.max = glm::max(box.max, other.max);
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all of the nodes.
+ ***********************************************************/
+void SceneBVH::Clear()
+{
+	m_nodes.clear();
+	m_items.clear();
+	m_itemBounds.clear();
+	m_centers.clear();
+	m_parents.clear();
+	m_itemLeaves.clear();
+}
+
+/***********************************************************
+ *  Build()
+ *
+ *  This method is used for building the hierarchy over the
+ *  passed in item bounds.  The index of each box in the list
+ *  is the item index that the queries return.
+ ***********************************************************/
+void SceneBVH::Build(const std::vector<Frustum::BOUNDING_BOX>& bounds)
+{
+	Clear();
+
+	if (bounds.size() == 0)
+	{
+		return;
+	}
+
+	m_itemBounds = bounds;
+	m_items.resize(bounds.size());
+	m_centers.resize(bounds.size());
+	for (int i = 0; i < bounds.size(); i++)
+	{
+		m_items[i] = i;
+		m_centers[i] = (bounds[i].min + bounds[i].max) * 0.5f;
+	}
+
+	// a binary tree with leaves of at least one item has fewer
+	// than twice as many nodes as items
+	m_nodes.reserve(bounds.size() * 2);
+
+	BVH_NODE root;
+	root.first = 0;
+	root.count = bounds.size();
+	m_nodes.push_back(root);
+
+	BuildNode(0);
+	LinkNodes();
+
+	m_centers.clear();
+}
+
+/***********************************************************
+ *  LinkNodes()
+ *
+ *  This method is used for finding the parent of every node
+ *  and the leaf of every item once the tree is built, so
+ *  the nodes above a moved item can be found without
+ *  walking the tree.
+ ***********************************************************/
+void SceneBVH::LinkNodes()
+{
+	m_parents.assign(m_nodes.size(), -1);
+	m_itemLeaves.assign(m_itemBounds.size(), -1);
+
+	for (int i = 0; i < m_nodes.size(); i++)
+	{
+		const BVH_NODE& node = m_nodes[i];
+
+		if (node.count > 0)
+		{
+			for (int j = node.first; j < node.first + node.count; j++)
+			{
+				m_itemLeaves[m_items[j]] = i;
+			}
+		}
+		else
+		{
+			m_parents[node.first] = i;
+			m_parents[node.first + 1] = i;
+		}
+	}
+}
+
+/***********************************************************
+ *  BuildNode()
+ *
+ *  This method is used for splitting the items of a node in
+ *  two.  The item centers are sorted into bins along each
+ *  axis, and the bin boundary with the lowest surface area
+ *  cost is used for the split.  The node is kept as a leaf
+ *  when no split costs less than testing all of its items,
+ *  and the items are split in half when their centers are
+ *  all in the same place.
+ ***********************************************************/
+void SceneBVH::BuildNode(int nodeIndex)
+{
+	int first = m_nodes[nodeIndex].first;
+	int count = m_nodes[nodeIndex].count;
+	Frustum::BOUNDING_BOX nodeBounds = EmptyBox();
+	Frustum::BOUNDING_BOX centerBounds = EmptyBox();
+
+	for (int i = first; i < first + count; i++)
+	{
+		Frustum::BOUNDING_BOX center;
+		center.min = m_centers[m_items[i]];
+		center.max = center.min;
+
+		GrowBox(nodeBounds, m_itemBounds[m_items[i]]);
+		GrowBox(centerBounds, center);
+	}
+	m_nodes[nodeIndex].bounds = nodeBounds;
+
+	if (count <= MAX_LEAF_ITEMS)
+	{
+		return;
+	}
+
+	// find the cheapest split over the bins of every axis
+	float bestCost = FLT_MAX;
+	int bestAxis = -1;
+	int bestSplit = 0;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float extent = centerBounds.max[axis] - centerBounds.min[axis];
+		Frustum::BOUNDING_BOX binBounds[SPLIT_BINS];
+		int binCounts[SPLIT_BINS];
+		float rightArea[SPLIT_BINS];
+		int rightCount[SPLIT_BINS];
+
+		if (extent <= 0.0f)
+		{
+			continue;
+		}
+
+		for (int bin = 0; bin < SPLIT_BINS; bin++)
+		{
+			binBounds[bin] = EmptyBox();
+			binCounts[bin] = 0;
+		}
+
+		for (int i = first; i < first + count; i++)
+		{
+			float offset = (m_centers[m_items[i]][axis] - centerBounds.min[axis]) / extent;
+			int bin = std::min((int)(offset * SPLIT_BINS), SPLIT_BINS - 1);
+
+			GrowBox(binBounds[bin], m_itemBounds[m_items[i]]);
+			binCounts[bin]++;
+		}
+
+		// sweep from the right to get the cost of every right side
+		Frustum::BOUNDING_BOX box = EmptyBox();
+		int total = 0;
+		for (int bin = SPLIT_BINS - 1; bin > 0; bin--)
+		{
+			GrowBox(box, binBounds[bin]);
+			total += binCounts[bin];
+			rightArea[bin] = SurfaceArea(box);
+			rightCount[bin] = total;
+		}
+
+		// sweep from the left, splitting in front of each bin
+		box = EmptyBox();
+		total = 0;
+		for (int bin = 1; bin < SPLIT_BINS; bin++)
+		{
+			GrowBox(box, binBounds[bin - 1]);
+			total += binCounts[bin - 1];
+
+			if ((total == 0) || (rightCount[bin] == 0))
+			{
+				continue;
+			}
+
+			float cost = (total * SurfaceArea(box)) + (rightCount[bin] * rightArea[bin]);
+			if (cost < bestCost)
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = bin;
+			}
+		}
+	}
+
+	int middle = first + (count / 2);
+
+	if (bestAxis >= 0)
+	{
+		// keep the node as a leaf when splitting does not pay off,
+		// unless the leaf would get too large to test quickly
+		float leafCost = count * SurfaceArea(nodeBounds);
+		if ((bestCost >= leafCost) && (count <= MAX_LEAF_ITEMS * 4))
+		{
+			return;
+		}
+
+		float extent = centerBounds.max[bestAxis] - centerBounds.min[bestAxis];
+		float minimum = centerBounds.min[bestAxis];
+		const std::vector<glm::vec3>& centers = m_centers;
+
+		std::vector<int>::iterator split = std::partition(
+			m_items.begin() + first,
+			m_items.begin() + first + count,
+			[&](int item)
+			{
+				float offset = (centers[item][bestAxis] - minimum) / extent;
+				return(std::min((int)(offset * SPLIT_BINS), SPLIT_BINS - 1) < bestSplit);
+			});
+		middle = split - m_items.begin();
+	}
+
+	// the children are added next to each other at the end
+	int leftChild = m_nodes.size();
+	BVH_NODE left;
+	BVH_NODE right;
+
+	left.first = first;
+	left.count = middle - first;
+	right.first = middle;
+	right.count = count - left.count;
+	m_nodes.push_back(left);
+	m_nodes.push_back(right);
+
+	m_nodes[nodeIndex].first = leftChild;
+	m_nodes[nodeIndex].count = 0;
+
+	BuildNode(leftChild);
+	BuildNode(leftChild + 1);
+}
+
+/***********************************************************
+ *  Refit()
+ *
+ *  This method is used for updating the node bounds after
+ *  items have moved, without changing the tree.  Children
+ *  are always stored after their parent, so walking the
+ *  nodes backwards updates every child before its parent.
+ *  The tree gets less efficient when items move far, so it
+ *  should be rebuilt from time to time after large moves.
+ ***********************************************************/
+void SceneBVH::Refit(const std::vector<Frustum::BOUNDING_BOX>& bounds)
+{
+	if (bounds.size() != m_itemBounds.size())
+	{
+		Build(bounds);
+		return;
+	}
+
+	m_itemBounds = bounds;
+
+	for (int i = m_nodes.size() - 1; i >= 0; i--)
+	{
+		FitNode(i);
+	}
+}
+
+/***********************************************************
+ *  RefitItems()
+ *
+ *  This method is used for updating the node bounds after
+ *  only the passed in items have moved.  The leaf of each
+ *  item and the nodes above it are refit, up to the first
+ *  node whose bounds stay the same, so a few moved items
+ *  cost a few paths instead of the whole tree.  When most
+ *  of the items moved, the whole tree is refit instead.
+ ***********************************************************/
+void SceneBVH::RefitItems(const std::vector<int>& items, const std::vector<Frustum::BOUNDING_BOX>& bounds)
+{
+	if ((bounds.size() != m_itemBounds.size()) || (items.size() * 4 > m_itemBounds.size()))
+	{
+		Refit(bounds);
+		return;
+	}
+
+	for (int i = 0; i < items.size(); i++)
+	{
+		if ((items[i] >= 0) && (items[i] < m_itemBounds.size()))
+		{
+			m_itemBounds[items[i]] = bounds[items[i]];
+		}
+	}
+
+	for (int i = 0; i < items.size(); i++)
+	{
+		if ((items[i] < 0) || (items[i] >= m_itemLeaves.size()))
+		{
+			continue;
+		}
+
+		for (int nodeIndex = m_itemLeaves[items[i]]; nodeIndex >= 0; nodeIndex = m_parents[nodeIndex])
+		{
+			Frustum::BOUNDING_BOX previous = m_nodes[nodeIndex].bounds;
+
+			FitNode(nodeIndex);
+
+			// the nodes above are only changed by a changed child
+			if ((m_nodes[nodeIndex].bounds.min == previous.min) &&
+				(m_nodes[nodeIndex].bounds.max == previous.max))
+			{
+				break;
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  FitNode()
+ *
+ *  This method is used for recomputing the bounds of a node
+ *  around its items when it is a leaf, or its two children.
+ ***********************************************************/
+void SceneBVH::FitNode(int nodeIndex)
+{
+	BVH_NODE& node = m_nodes[nodeIndex];
+	Frustum::BOUNDING_BOX box = EmptyBox();
+
+	if (node.count > 0)
+	{
+		for (int j = node.first; j < node.first + node.count; j++)
+		{
+			GrowBox(box, m_itemBounds[m_items[j]]);
+		}
+	}
+	else
+	{
+		GrowBox(box, m_nodes[node.first].bounds);
+		GrowBox(box, m_nodes[node.first + 1].bounds);
+	}
+
+	node.bounds = box;
+}
+
+/***********************************************************
+ *  CollectItems()
+ *
+ *  This method is used for adding every item below a node to
+ *  the results.  Leaves hold ranges of the item list and the
+ *  leaves below a node are in one range, so the range is
+ *  found from the first and last leaf.
+ ***********************************************************/
+void SceneBVH::CollectItems(int nodeIndex, std::vector<int>& items) const
+{
+	int firstNode = nodeIndex;
+	int lastNode = nodeIndex;
+
+	while (m_nodes[firstNode].count == 0)
+	{
+		firstNode = m_nodes[firstNode].first;
+	}
+	while (m_nodes[lastNode].count == 0)
+	{
+		lastNode = m_nodes[lastNode].first + 1;
+	}
+
+	int firstItem = m_nodes[firstNode].first;
+	int lastItem = m_nodes[lastNode].first + m_nodes[lastNode].count;
+
+	items.insert(items.end(), m_items.begin() + firstItem, m_items.begin() + lastItem);
+}
+
+/***********************************************************
+ *  QueryFrustum()
+ *
+ *  This method is used for getting the items whose bounds
+ *  may be inside the frustum.  Nodes outside the frustum are
+ *  skipped with all of their items, and nodes fully inside
+ *  add all of their items without testing them.
+ ***********************************************************/
+void SceneBVH::QueryFrustum(const Frustum& frustum, std::vector<int>& items) const
+{
+	int stack[QUERY_STACK_SIZE];
+	int stackSize = 0;
+
+	if (m_nodes.size() == 0)
+	{
+		return;
+	}
+
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		const BVH_NODE& node = m_nodes[stack[--stackSize]];
+		Frustum::BOX_CLASS boxClass = frustum.ClassifyBox(node.bounds);
+
+		if (Frustum::BOX_OUTSIDE == boxClass)
+		{
+			continue;
+		}
+
+		if (Frustum::BOX_INSIDE == boxClass)
+		{
+			CollectItems(&node - &m_nodes[0], items);
+		}
+		else if (node.count > 0)
+		{
+			for (int i = node.first; i < node.first + node.count; i++)
+			{
+				if (frustum.IsBoxVisible(m_itemBounds[m_items[i]]))
+				{
+					items.push_back(m_items[i]);
+				}
+			}
+		}
+		else if (stackSize + 2 <= QUERY_STACK_SIZE)
+		{
+			stack[stackSize++] = node.first;
+			stack[stackSize++] = node.first + 1;
+		}
+		else
+		{
+			// the tree is deeper than the stack, keep every item
+			CollectItems(&node - &m_nodes[0], items);
+		}
+	}
+}
+
+/***********************************************************
+ *  QueryFrusta()
+ *
+ *  This method is used for getting the items whose bounds
+ *  may be inside each of the frusta, into the list of each
+ *  frustum, like the views of a frame that see the same
+ *  part of the scene.  The tree is walked once for all of
+ *  them, and every node carries the frusta it still has to
+ *  be tested against.  A node outside or fully inside of a
+ *  frustum is not tested against it any further, and the
+ *  items of a node inside of several frusta are collected
+ *  once and copied to the lists of the others.
+ ***********************************************************/
+void SceneBVH::QueryFrusta(const Frustum* frusta, int frustumCount, std::vector<int>* const* items) const
+{
+	int stack[QUERY_STACK_SIZE];
+	unsigned int stackMasks[QUERY_STACK_SIZE];
+	int stackSize = 0;
+
+	if ((m_nodes.size() == 0) || (frustumCount <= 0))
+	{
+		return;
+	}
+	frustumCount = std::min(frustumCount, (int)MAX_QUERY_FRUSTA);
+
+	stack[stackSize] = 0;
+	stackMasks[stackSize] = (frustumCount < 32) ? ((1u << frustumCount) - 1) : 0xFFFFFFFFu;
+	stackSize++;
+	while (stackSize > 0)
+	{
+		stackSize--;
+		int nodeIndex = stack[stackSize];
+		unsigned int testMask = stackMasks[stackSize];
+		unsigned int insideMask = 0;
+		const BVH_NODE& node = m_nodes[nodeIndex];
+
+		for (int f = 0; f < frustumCount; f++)
+		{
+			unsigned int bit = 1u << f;
+			if (0 == (testMask & bit))
+			{
+				continue;
+			}
+
+			Frustum::BOX_CLASS boxClass = frusta[f].ClassifyBox(node.bounds);
+			if (Frustum::BOX_OUTSIDE == boxClass)
+			{
+				testMask &= ~bit;
+			}
+			else if (Frustum::BOX_INSIDE == boxClass)
+			{
+				testMask &= ~bit;
+				insideMask |= bit;
+			}
+		}
+
+		// the frusta the node is fully inside of get all of its items
+		if (0 != insideMask)
+		{
+			int source = -1;
+			size_t first = 0;
+			for (int f = 0; f < frustumCount; f++)
+			{
+				if (0 == (insideMask & (1u << f)))
+				{
+					continue;
+				}
+
+				if (source < 0)
+				{
+					source = f;
+					first = items[f]->size();
+					CollectItems(nodeIndex, *items[f]);
+				}
+				else
+				{
+					const std::vector<int>& collected = *items[source];
+					items[f]->insert(items[f]->end(), collected.begin() + first, collected.end());
+				}
+			}
+		}
+
+		if (0 == testMask)
+		{
+			continue;
+		}
+
+		if (node.count > 0)
+		{
+			for (int i = node.first; i < node.first + node.count; i++)
+			{
+				const Frustum::BOUNDING_BOX& bounds = m_itemBounds[m_items[i]];
+				for (int f = 0; f < frustumCount; f++)
+				{
+					if ((0 != (testMask & (1u << f))) && frusta[f].IsBoxVisible(bounds))
+					{
+						items[f]->push_back(m_items[i]);
+					}
+				}
+			}
+		}
+		else if (stackSize + 2 <= QUERY_STACK_SIZE)
+		{
+			stack[stackSize] = node.first;
+			stackMasks[stackSize] = testMask;
+			stackSize++;
+			stack[stackSize] = node.first + 1;
+			stackMasks[stackSize] = testMask;
+			stackSize++;
+		}
+		else
+		{
+			// the tree is deeper than the stack, keep every item
+			for (int f = 0; f < frustumCount; f++)
+			{
+				if (0 != (testMask & (1u << f)))
+				{
+					CollectItems(nodeIndex, *items[f]);
+				}
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  QuerySphere()
+ *
+ *  This method is used for getting the items whose bounds
+ *  touch a sphere, like the objects in range of a light.
+ ***********************************************************/
+void SceneBVH::QuerySphere(const glm::vec3& center, float radius, std::vector<int>& items) const
+{
+	int stack[QUERY_STACK_SIZE];
+	int stackSize = 0;
+	float radiusSquared = radius * radius;
+
+	if (m_nodes.size() == 0)
+	{
+		return;
+	}
+
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		const BVH_NODE& node = m_nodes[stack[--stackSize]];
+		glm::vec3 nearest = glm::min(glm::max(center, node.bounds.min), node.bounds.max);
+		glm::vec3 offset = nearest - center;
+
+		if (glm::dot(offset, offset) > radiusSquared)
+		{
+			continue;
+		}
+
+		if (node.count > 0)
+		{
+			for (int i = node.first; i < node.first + node.count; i++)
+			{
+				const Frustum::BOUNDING_BOX& box = m_itemBounds[m_items[i]];
+				nearest = glm::min(glm::max(center, box.min), box.max);
+				offset = nearest - center;
+
+				if (glm::dot(offset, offset) <= radiusSquared)
+				{
+					items.push_back(m_items[i]);
+				}
+			}
+		}
+		else if (stackSize + 2 <= QUERY_STACK_SIZE)
+		{
+			stack[stackSize++] = node.first;
+			stack[stackSize++] = node.first + 1;
+		}
+		else
+		{
+			CollectItems(&node - &m_nodes[0], items);
+		}
+	}
+}
+
+/***********************************************************
+ *  IntersectRayBox()
+ *
+ *  This method is used for getting the distance along a ray
+ *  to where it enters a box, using the slab test.  A ray that
+ *  starts inside the box hits it at a distance of 0, and -1
+ *  is returned when the box is missed.
+ ***********************************************************/
+float SceneBVH::IntersectRayBox(
+	const Frustum::BOUNDING_BOX& box,
+	const glm::vec3& origin,
+	const glm::vec3& inverseDirection,
+	float maxDistance)
+{
+	float nearDistance = 0.0f;
+	float farDistance = maxDistance;
+
+	for (int axis = 0; axis < 3; axis++)
+	{
+		float t0 = (box.min[axis] - origin[axis]) * inverseDirection[axis];
+		float t1 = (box.max[axis] - origin[axis]) * inverseDirection[axis];
+
+		if (t0 > t1)
+		{
+			std::swap(t0, t1);
+		}
+
+		nearDistance = std::max(nearDistance, t0);
+		farDistance = std::min(farDistance, t1);
+
+		if (nearDistance > farDistance)
+		{
+			return(-1.0f);
+		}
+	}
+
+	return(nearDistance);
+}
+
+/***********************************************************
+ *  Raycast()
+ *
+ *  This method is used for getting the nearest item whose
+ *  bounds are hit by a ray.  The nearer child of each node is
+ *  visited first, and nodes farther away than the nearest
+ *  hit so far are skipped.  When the tree is deeper than the
+ *  stack, every item of a child that does not fit is tested
+ *  directly instead.
+ ***********************************************************/
+bool SceneBVH::Raycast(
+	const glm::vec3& origin,
+	const glm::vec3& direction,
+	float maxDistance,
+	int& item,
+	float& distance) const
+{
+	int stack[QUERY_STACK_SIZE];
+	int stackSize = 0;
+	glm::vec3 inverseDirection;
+	std::vector<int> subtreeItems;
+
+	item = -1;
+	distance = maxDistance;
+
+	if (m_nodes.size() == 0)
+	{
+		return(false);
+	}
+
+	// a zero direction gives an infinite inverse, which the slab test handles
+	for (int axis = 0; axis < 3; axis++)
+	{
+		inverseDirection[axis] = (direction[axis] != 0.0f) ? 1.0f / direction[axis] : FLT_MAX;
+	}
+
+	if (IntersectRayBox(m_nodes[0].bounds, origin, inverseDirection, distance) < 0.0f)
+	{
+		return(false);
+	}
+
+	stack[stackSize++] = 0;
+	while (stackSize > 0)
+	{
+		const BVH_NODE& node = m_nodes[stack[--stackSize]];
+
+		if (node.count > 0)
+		{
+			for (int i = node.first; i < node.first + node.count; i++)
+			{
+				float hit = IntersectRayBox(m_itemBounds[m_items[i]], origin, inverseDirection, distance);
+				if ((hit >= 0.0f) && ((item < 0) || (hit < distance)))
+				{
+					item = m_items[i];
+					distance = hit;
+				}
+			}
+			continue;
+		}
+
+		float leftHit = IntersectRayBox(m_nodes[node.first].bounds, origin, inverseDirection, distance);
+		float rightHit = IntersectRayBox(m_nodes[node.first + 1].bounds, origin, inverseDirection, distance);
+		int nearChild = node.first;
+		int farChild = node.first + 1;
+
+		if ((rightHit >= 0.0f) && ((leftHit < 0.0f) || (rightHit < leftHit)))
+		{
+			std::swap(nearChild, farChild);
+			std::swap(leftHit, rightHit);
+		}
+
+		// push the far child first so the near child is visited first
+		int children[2] = { farChild, nearChild };
+		float childHits[2] = { rightHit, leftHit };
+		for (int c = 0; c < 2; c++)
+		{
+			if (childHits[c] < 0.0f)
+			{
+				continue;
+			}
+
+			if (stackSize < QUERY_STACK_SIZE)
+			{
+				stack[stackSize++] = children[c];
+				continue;
+			}
+
+			// the tree is deeper than the stack, test every item of the child
+			subtreeItems.clear();
+			CollectItems(children[c], subtreeItems);
+			for (int i = 0; i < subtreeItems.size(); i++)
+			{
+				float hit = IntersectRayBox(m_itemBounds[subtreeItems[i]], origin, inverseDirection, distance);
+				if ((hit >= 0.0f) && ((item < 0) || (hit < distance)))
+				{
+					item = subtreeItems[i];
+					distance = hit;
+				}
+			}
+		}
+	}
+
+	return(item >= 0);
+}
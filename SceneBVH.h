@@ -0,0 +1,110 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenebvh.h
+// ============
+// bounding volume hierarchy over the scene objects - culling, picking, ranges
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Frustum.h"
+
+#include <vector>
+
+/***********************************************************
+ *  SceneBVH
+ *
+ *  This class builds a bounding volume hierarchy over the
+ *  world bounds of the scene objects, splitting the objects
+ *  with the surface area heuristic.  It answers frustum,
+ *  sphere and ray queries without walking every object,
+ *  and can be refit in place when objects move.
+ ***********************************************************/
+class SceneBVH
+{
+public:
+	// constructor
+	SceneBVH();
+	// destructor
+	~SceneBVH();
+
+private:
+	// the most items kept in one leaf node
+	static const int MAX_LEAF_ITEMS = 4;
+	// the number of bins the split positions are chosen from
+	static const int SPLIT_BINS = 12;
+	// the deepest the queries walk down the tree
+	static const int QUERY_STACK_SIZE = 64;
+	// the most frusta one query walks the tree for together
+	static const int MAX_QUERY_FRUSTA = 32;
+
+	// one node of the hierarchy, the two children of an inner
+	// node are stored next to each other
+	struct BVH_NODE
+	{
+		Frustum::BOUNDING_BOX bounds;
+		// first child for inner nodes, first item for leaf nodes
+		int first;
+		// number of items for leaf nodes, 0 for inner nodes
+		int count;
+	};
+
+	// the nodes of the hierarchy, the root is the first node
+	std::vector<BVH_NODE> m_nodes;
+	// the item indices, ordered so every leaf holds a range
+	std::vector<int> m_items;
+	// the bounds of every item, by item index
+	std::vector<Frustum::BOUNDING_BOX> m_itemBounds;
+	// the item centers, only used while building
+	std::vector<glm::vec3> m_centers;
+	// the parent of every node, -1 for the root, and the leaf of every item
+	std::vector<int> m_parents;
+	std::vector<int> m_itemLeaves;
+
+	// split the items of a node into two children
+	void BuildNode(int nodeIndex);
+	// add every item below a node to the results
+	void CollectItems(int nodeIndex, std::vector<int>& items) const;
+	// link the nodes to their parents and the items to their leaves
+	void LinkNodes();
+	// recompute the bounds of a node from its items or children
+	void FitNode(int nodeIndex);
+
+	// get the surface area of a box
+	static float SurfaceArea(const Frustum::BOUNDING_BOX& box);
+	// get a box that holds nothing
+	static Frustum::BOUNDING_BOX EmptyBox();
+	// grow a box to hold another box
+	static void GrowBox(Frustum::BOUNDING_BOX& box, const Frustum::BOUNDING_BOX& other);
+	// get the distance along a ray to a box, or -1 when it is missed
+	static float IntersectRayBox(
+		const Frustum::BOUNDING_BOX& box,
+		const glm::vec3& origin,
+		const glm::vec3& inverseDirection,
+		float maxDistance);
+
+public:
+	// build the hierarchy over the passed in item bounds
+	void Build(const std::vector<Frustum::BOUNDING_BOX>& bounds);
+	// update the node bounds after items moved, keeping the tree
+	void Refit(const std::vector<Frustum::BOUNDING_BOX>& bounds);
+	// update only the nodes above the passed in moved items
+	void RefitItems(const std::vector<int>& items, const std::vector<Frustum::BOUNDING_BOX>& bounds);
+	// remove all of the nodes
+	void Clear();
+
+	// get the items whose bounds may be inside the frustum
+	void QueryFrustum(const Frustum& frustum, std::vector<int>& items) const;
+	// get the items that may be inside each of the frusta, walking the tree once
+	void QueryFrusta(const Frustum* frusta, int frustumCount, std::vector<int>* const* items) const;
+	// get the items whose bounds touch the sphere
+	void QuerySphere(const glm::vec3& center, float radius, std::vector<int>& items) const;
+	// get the nearest item whose bounds are hit by the ray
+	bool Raycast(
+		const glm::vec3& origin,
+		const glm::vec3& direction,
+		float maxDistance,
+		int& item,
+		float& distance) const;
+};
@@ -0,0 +1,372 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.cpp
+// ============
+// compiled scene file layout and read-only memory mapping - scene data
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneFile.h"
+
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <iostream>
+
+/***********************************************************
+ *  SceneFile()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneFile::SceneFile()
+{
+	m_pData = NULL;
+	m_size = 0;
+#ifdef _WIN32
+	m_fileHandle = INVALID_HANDLE_VALUE;
+	m_mappingHandle = NULL;
+#else
+	m_fileDescriptor = -1;
+#endif
+}
+
+/***********************************************************
+ *  ~SceneFile()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneFile::~SceneFile()
+{
+	Close();
+}
+
+/***********************************************************
+ *  Open()
+ *
+ *  This method is used for mapping a compiled scene file
+ *  into memory.  The pages are only read from disk when the
+ *  records are first used, and stay shared with the file
+ *  cache.  False is returned when the file is missing or is
+ *  not a valid scene file of this version.
+ ***********************************************************/
+bool SceneFile::Open(const char* filename)
+{
+	Close();
+
+#ifdef _WIN32
+	LARGE_INTEGER fileSize;
+
+	m_fileHandle = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (INVALID_HANDLE_VALUE == m_fileHandle)
+	{
+		return(false);
+	}
+	if ((!GetFileSizeEx(m_fileHandle, &fileSize)) || (fileSize.QuadPart < (LONGLONG)sizeof(SCENE_FILE_HEADER)))
+	{
+		Close();
+		return(false);
+	}
+
+	m_mappingHandle = CreateFileMappingA(m_fileHandle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (NULL == m_mappingHandle)
+	{
+		Close();
+		return(false);
+	}
+
+	m_pData = (const unsigned char*)MapViewOfFile(m_mappingHandle, FILE_MAP_READ, 0, 0, 0);
+	m_size = (size_t)fileSize.QuadPart;
+#else
+	struct stat fileStatus;
+
+	m_fileDescriptor = open(filename, O_RDONLY);
+	if (m_fileDescriptor < 0)
+	{
+		return(false);
+	}
+	if ((fstat(m_fileDescriptor, &fileStatus) != 0) || (fileStatus.st_size < (off_t)sizeof(SCENE_FILE_HEADER)))
+	{
+		Close();
+		return(false);
+	}
+
+	void* pMapping = mmap(NULL, fileStatus.st_size, PROT_READ, MAP_PRIVATE, m_fileDescriptor, 0);
+	if (MAP_FAILED != pMapping)
+	{
+		m_pData = (const unsigned char*)pMapping;
+		m_size = (size_t)fileStatus.st_size;
+	}
+#endif
+
+	if (NULL == m_pData)
+	{
+		std::cout << "Could not map scene file:" << filename << std::endl;
+		Close();
+		return(false);
+	}
+
+	if (!Validate())
+	{
+		std::cout << "Not a valid scene file:" << filename << std::endl;
+		Close();
+		return(false);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Close()
+ *
+ *  This method is used for unmapping the scene file.  The
+ *  strings of the file, such as the group names, can not be
+ *  used after it is closed.
+ ***********************************************************/
+void SceneFile::Close()
+{
+#ifdef _WIN32
+	if (NULL != m_pData)
+	{
+		UnmapViewOfFile(m_pData);
+	}
+	if (NULL != m_mappingHandle)
+	{
+		CloseHandle(m_mappingHandle);
+		m_mappingHandle = NULL;
+	}
+	if (INVALID_HANDLE_VALUE != m_fileHandle)
+	{
+		CloseHandle(m_fileHandle);
+		m_fileHandle = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (NULL != m_pData)
+	{
+		munmap((void*)m_pData, m_size);
+	}
+	if (m_fileDescriptor >= 0)
+	{
+		close(m_fileDescriptor);
+		m_fileDescriptor = -1;
+	}
+#endif
+
+	m_pData = NULL;
+	m_size = 0;
+}
+
+/***********************************************************
+ *  IsOpen()
+ *
+ *  This method is used for checking whether a scene file is
+ *  mapped.
+ ***********************************************************/
+bool SceneFile::IsOpen() const
+{
+	return(NULL != m_pData);
+}
+
+/***********************************************************
+ *  IsSectionValid()
+ *
+ *  This method is used for checking that a section of
+ *  records lies inside the file and starts on a four byte
+ *  boundary, so its records can be read in place.
+ ***********************************************************/
+bool SceneFile::IsSectionValid(const SCENE_FILE_SECTION& section, size_t recordSize) const
+{
+	if ((section.offset % 4) != 0)
+	{
+		return(false);
+	}
+
+	return(((uint64_t)section.offset + ((uint64_t)section.count * recordSize)) <= m_size);
+}
+
+/***********************************************************
+ *  Validate()
+ *
+ *  This method is used for checking the header, that every
+ *  section lies inside the file, that the strings section
+ *  ends its last string, and that every index and string
+ *  offset in the records is in range.  This only reads the
+ *  records once and does not depend on the scene content.
+ ***********************************************************/
+bool SceneFile::Validate() const
+{
+	const SCENE_FILE_HEADER* pHeader = (const SCENE_FILE_HEADER*)m_pData;
+
+	if ((pHeader->magic != SCENE_FILE_MAGIC) ||
+		(pHeader->version != SCENE_FILE_VERSION) ||
+		(pHeader->fileSize != m_size))
+	{
+		return(false);
+	}
+
+	if ((!IsSectionValid(pHeader->textures, sizeof(SCENE_FILE_TEXTURE))) ||
+		(!IsSectionValid(pHeader->meshes, sizeof(SCENE_FILE_MESH))) ||
+		(!IsSectionValid(pHeader->materials, sizeof(SCENE_FILE_MATERIAL))) ||
+		(!IsSectionValid(pHeader->lights, sizeof(SCENE_FILE_LIGHT))) ||
+		(!IsSectionValid(pHeader->groups, sizeof(SCENE_FILE_GROUP))) ||
+		(!IsSectionValid(pHeader->nodes, sizeof(SCENE_FILE_NODE))) ||
+		(!IsSectionValid(pHeader->objects, sizeof(SCENE_FILE_OBJECT))) ||
+		(!IsSectionValid(pHeader->strings, 1)))
+	{
+		return(false);
+	}
+
+	// every string has to end inside the strings section
+	if ((pHeader->strings.count == 0) ||
+		(m_pData[pHeader->strings.offset + pHeader->strings.count - 1] != '\0'))
+	{
+		return(false);
+	}
+
+	for (int i = 0; i < GetTextureCount(); i++)
+	{
+		if ((GetTextures()[i].file >= pHeader->strings.count) ||
+			(GetTextures()[i].tag >= pHeader->strings.count))
+		{
+			return(false);
+		}
+	}
+	for (int i = 0; i < GetMeshCount(); i++)
+	{
+		if ((GetMeshes()[i].file >= pHeader->strings.count) ||
+			(GetMeshes()[i].tag >= pHeader->strings.count))
+		{
+			return(false);
+		}
+	}
+	for (int i = 0; i < GetMaterialCount(); i++)
+	{
+		if (GetMaterials()[i].tag >= pHeader->strings.count)
+		{
+			return(false);
+		}
+	}
+	for (int i = 0; i < GetGroupCount(); i++)
+	{
+		if (GetGroups()[i].name >= pHeader->strings.count)
+		{
+			return(false);
+		}
+	}
+	// a node can only be placed relative to a node before it
+	for (int i = 0; i < GetNodeCount(); i++)
+	{
+		if (GetNodes()[i].parent >= i)
+		{
+			return(false);
+		}
+	}
+	for (int i = 0; i < GetObjectCount(); i++)
+	{
+		const SCENE_FILE_OBJECT& object = GetObjects()[i];
+
+		if ((object.meshFile >= GetMeshCount()) ||
+			(object.texture >= GetTextureCount()) ||
+			(object.material >= GetMaterialCount()) ||
+			(object.group >= (uint32_t)GetGroupCount()) ||
+			(object.node >= GetNodeCount()))
+		{
+			return(false);
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  Get*()
+ *
+ *  These methods are used for getting the records of each
+ *  section in place, and how many records there are.
+ ***********************************************************/
+const SCENE_FILE_TEXTURE* SceneFile::GetTextures() const
+{
+	return((const SCENE_FILE_TEXTURE*)(m_pData + ((const SCENE_FILE_HEADER*)m_pData)->textures.offset));
+}
+
+int SceneFile::GetTextureCount() const
+{
+	return(((const SCENE_FILE_HEADER*)m_pData)->textures.count);
+}
+
+const SCENE_FILE_MESH* SceneFile::GetMeshes() const
+{
+	return((const SCENE_FILE_MESH*)(m_pData + ((const SCENE_FILE_HEADER*)m_pData)->meshes.offset));
+}
+
+int SceneFile::GetMeshCount() const
+{
+	return(((const SCENE_FILE_HEADER*)m_pData)->meshes.count);
+}
+
+const SCENE_FILE_MATERIAL* SceneFile::GetMaterials() const
+{
+	return((const SCENE_FILE_MATERIAL*)(m_pData + ((const SCENE_FILE_HEADER*)m_pData)->materials.offset));
+}
+
+int SceneFile::GetMaterialCount() const
+{
+	return(((const SCENE_FILE_HEADER*)m_pData)->materials.count);
+}
+
+const SCENE_FILE_LIGHT* SceneFile::GetLights() const
+{
+	return((const SCENE_FILE_LIGHT*)(m_pData + ((const SCENE_FILE_HEADER*)m_pData)->lights.offset));
+}
+
+int SceneFile::GetLightCount() const
+{
+	return(((const SCENE_FILE_HEADER*)m_pData)->lights.count);
+}
+
+const SCENE_FILE_GROUP* SceneFile::GetGroups() const
+{
+	return((const SCENE_FILE_GROUP*)(m_pData + ((const SCENE_FILE_HEADER*)m_pData)->groups.offset));
+}
+
+int SceneFile::GetGroupCount() const
+{
+	return(((const SCENE_FILE_HEADER*)m_pData)->groups.count);
+}
+
+const SCENE_FILE_NODE* SceneFile::GetNodes() const
+{
+	return((const SCENE_FILE_NODE*)(m_pData + ((const SCENE_FILE_HEADER*)m_pData)->nodes.offset));
+}
+
+int SceneFile::GetNodeCount() const
+{
+	return(((const SCENE_FILE_HEADER*)m_pData)->nodes.count);
+}
+
+const SCENE_FILE_OBJECT* SceneFile::GetObjects() const
+{
+	return((const SCENE_FILE_OBJECT*)(m_pData + ((const SCENE_FILE_HEADER*)m_pData)->objects.offset));
+}
+
+int SceneFile::GetObjectCount() const
+{
+	return(((const SCENE_FILE_HEADER*)m_pData)->objects.count);
+}
+
+/***********************************************************
+ *  GetString()
+ *
+ *  This method is used for getting a string of the strings
+ *  section by its offset from the start of the section.
+ ***********************************************************/
+const char* SceneFile::GetString(uint32_t offset) const
+{
+	return((const char*)(m_pData + ((const SCENE_FILE_HEADER*)m_pData)->strings.offset + offset));
+}
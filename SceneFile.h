@@ -0,0 +1,186 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenefile.h
+// ============
+// compiled scene file layout and read-only memory mapping - scene data
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// "SCN1" in the first four bytes of every compiled scene file
+static const uint32_t SCENE_FILE_MAGIC = 0x314E4353;
+static const uint32_t SCENE_FILE_VERSION = 4;
+
+// the kinds of lights in a scene file
+enum SCENE_FILE_LIGHT_TYPE
+{
+	SCENE_LIGHT_DIRECTIONAL = 0,
+	SCENE_LIGHT_POINT,
+	SCENE_LIGHT_SPOT
+};
+
+// where an array of records is found in the file
+struct SCENE_FILE_SECTION
+{
+	uint32_t offset;
+	uint32_t count;
+};
+
+// the start of every compiled scene file, the strings section
+// counts bytes and every other section counts records
+struct SCENE_FILE_HEADER
+{
+	uint32_t magic;
+	uint32_t version;
+	uint32_t fileSize;
+	SCENE_FILE_SECTION textures;
+	SCENE_FILE_SECTION meshes;
+	SCENE_FILE_SECTION materials;
+	SCENE_FILE_SECTION lights;
+	SCENE_FILE_SECTION groups;
+	SCENE_FILE_SECTION nodes;
+	SCENE_FILE_SECTION objects;
+	SCENE_FILE_SECTION strings;
+};
+
+// an image file and the tag the objects use it by, both are
+// offsets into the strings section
+struct SCENE_FILE_TEXTURE
+{
+	uint32_t file;
+	uint32_t tag;
+};
+
+// a mesh file written by the MeshCompiler tool and the tag the
+// objects use it by, both are offsets into the strings section
+struct SCENE_FILE_MESH
+{
+	uint32_t file;
+	uint32_t tag;
+};
+
+struct SCENE_FILE_MATERIAL
+{
+	float diffuseColor[3];
+	float specularColor[3];
+	float shininess;
+	uint32_t tag;
+};
+
+// one light, the fields the light type does not use are zero
+struct SCENE_FILE_LIGHT
+{
+	uint32_t type;
+	float position[4];
+	float direction[4];
+	float ambient[4];
+	float diffuse[4];
+	float specular[4];
+	float cutOff;
+	float outerCutOff;
+	// distance a point light fades out at, or 0 for the default
+	float range;
+};
+
+// the name of an object group, an offset into the strings section
+struct SCENE_FILE_GROUP
+{
+	uint32_t name;
+};
+
+// a transform node that objects and other nodes are placed
+// relative to, a parent is always before its children
+struct SCENE_FILE_NODE
+{
+	// parent node index, or -1 for a root node
+	int32_t parent;
+	float local[16];
+};
+
+// one object with its transformation already combined, the
+// mesh is a SceneManager::MESH_TYPE value and the mesh file,
+// texture, material, group and node are indices into their
+// sections
+struct SCENE_FILE_OBJECT
+{
+	uint32_t mesh;
+	// imported mesh index, or -1 when drawn with the basic mesh
+	int32_t meshFile;
+	// texture index, or -1 when drawn with the color
+	int32_t texture;
+	// material index, or -1 to keep the current material
+	int32_t material;
+	uint32_t group;
+	// node the model matrix is relative to, or -1 for the world
+	int32_t node;
+	float model[16];
+	float color[4];
+	float uvScale[2];
+};
+
+/***********************************************************
+ *  SceneFile
+ *
+ *  This class maps a compiled scene file into memory and
+ *  gives read-only access to its records in place.  The file
+ *  holds no pointers, only offsets from its start, so after
+ *  the sections are checked to be inside the file nothing
+ *  has to be parsed or copied before the scene is built.
+ ***********************************************************/
+class SceneFile
+{
+public:
+	// constructor
+	SceneFile();
+	// destructor
+	~SceneFile();
+
+private:
+	// the mapped file and its size in bytes
+	const unsigned char* m_pData;
+	size_t m_size;
+#ifdef _WIN32
+	// handles of the open file and of its mapping
+	void* m_fileHandle;
+	void* m_mappingHandle;
+#else
+	// descriptor of the open file
+	int m_fileDescriptor;
+#endif
+
+	// check that a section of records lies inside the file
+	bool IsSectionValid(const SCENE_FILE_SECTION& section, size_t recordSize) const;
+	// check that the sections and the indices between them are valid
+	bool Validate() const;
+
+public:
+	// map the compiled scene file into memory
+	bool Open(const char* filename);
+	// unmap the file
+	void Close();
+	// check whether a scene file is mapped
+	bool IsOpen() const;
+
+	// get the records of each section and how many there are
+	const SCENE_FILE_TEXTURE* GetTextures() const;
+	int GetTextureCount() const;
+	const SCENE_FILE_MESH* GetMeshes() const;
+	int GetMeshCount() const;
+	const SCENE_FILE_MATERIAL* GetMaterials() const;
+	int GetMaterialCount() const;
+	const SCENE_FILE_LIGHT* GetLights() const;
+	int GetLightCount() const;
+	const SCENE_FILE_GROUP* GetGroups() const;
+	int GetGroupCount() const;
+	const SCENE_FILE_NODE* GetNodes() const;
+	int GetNodeCount() const;
+	const SCENE_FILE_OBJECT* GetObjects() const;
+	int GetObjectCount() const;
+
+	// get a string of the strings section by its offset
+	const char* GetString(uint32_t offset) const;
+};
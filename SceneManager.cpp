@@ -1,715 +1,4683 @@
-///////////////////////////////////////////////////////////////////////////////
-// scenemanager.cpp
-// ============
-// manage the preparing and rendering of 3D scenes - textures, materials, lighting
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "SceneManager.h"
-
-#ifndef STB_IMAGE_IMPLEMENTATION
-#define STB_IMAGE_IMPLEMENTATION
-#include "stb_image.h"
-#endif
-
-#include <glm/gtx/transform.hpp>
-
-// declaration of global variables and defines
-namespace
-{
-	const char* g_ModelName = "model";
-	const char* g_ColorValueName = "objectColor";
-	const char* g_TextureValueName = "objectTexture";
-	const char* g_UseTextureName = "bUseTexture";
-	const char* g_UseLightingName = "bUseLighting";
-}
-
-/***********************************************************
- *  SceneManager()
- *
- *  The constructor for the class
- ***********************************************************/
-SceneManager::SceneManager(ShaderManager* pShaderManager)
-{
-	m_pShaderManager = pShaderManager;
-	// create the shape meshes object
-	m_basicMeshes = new ShapeMeshes();
-
-	// initialize the texture collection
-	for (int i = 0; i < 16; i++)
-	{
-		m_textureIDs[i].tag = "/0";
-		m_textureIDs[i].ID = -1;
-	}
-	m_loadedTextures = 0;
-}
-
-/***********************************************************
- *  ~SceneManager()
- *
- *  The destructor for the class
- ***********************************************************/
-SceneManager::~SceneManager()
-{
-	// free the allocated objects
-	m_pShaderManager = NULL;
-	if (NULL != m_basicMeshes)
-	{
-		delete m_basicMeshes;
-		m_basicMeshes = NULL;
-	}
-
-	// free the allocated OpenGL textures
-	DestroyGLTextures();
-}
-
-/***********************************************************
- *  CreateGLTexture()
- *
- *  This method is used for loading textures from image files,
- *  configuring the texture mapping parameters in OpenGL,
- *  generating the mipmaps, and loading the read texture into
- *  the next available texture slot in memory.
- ***********************************************************/
-bool SceneManager::CreateGLTexture(const char* filename, std::string tag)
-{
-	int width = 0;
-	int height = 0;
-	int colorChannels = 0;
-	GLuint textureID = 0;
-
-	// indicate to always flip images vertically when loaded
-	stbi_set_flip_vertically_on_load(true);
-
-	// try to parse the image data from the specified image file
-	unsigned char* image = stbi_load(
-		filename,
-		&width,
-		&height,
-		&colorChannels,
-		0);
-
-	// if the image was successfully read from the image file
-	if (image)
-	{
-		std::cout << "Successfully loaded image:" << filename << ", width:" << width << ", height:" << height << ", channels:" << colorChannels << std::endl;
-
-		glGenTextures(1, &textureID);
-		glBindTexture(GL_TEXTURE_2D, textureID);
-
-		// set the texture wrapping parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
-		// set texture filtering parameters
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-
-		// if the loaded image is in RGB format
-		if (colorChannels == 3)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB8, width, height, 0, GL_RGB, GL_UNSIGNED_BYTE, image);
-		// if the loaded image is in RGBA format - it supports transparency
-		else if (colorChannels == 4)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, image);
-		else
-		{
-			std::cout << "Not implemented to handle image with " << colorChannels << " channels" << std::endl;
-			return false;
-		}
-
-		// generate the texture mipmaps for mapping textures to lower resolutions
-		glGenerateMipmap(GL_TEXTURE_2D);
-
-		// free the image data from local memory
-		stbi_image_free(image);
-		glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
-
-		// register the loaded texture and associate it with the special tag string
-		m_textureIDs[m_loadedTextures].ID = textureID;
-		m_textureIDs[m_loadedTextures].tag = tag;
-		m_loadedTextures++;
-
-		return true;
-	}
-
-	std::cout << "Could not load image:" << filename << std::endl;
-
-	// Error loading the image
-	return false;
-}
-
-/***********************************************************
- *  BindGLTextures()
- *
- *  This method is used for binding the loaded textures to
- *  OpenGL texture memory slots.  There are up to 16 slots.
- ***********************************************************/
-void SceneManager::BindGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		// bind textures on corresponding texture units
-		glActiveTexture(GL_TEXTURE0 + i);
-		glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  DestroyGLTextures()
- *
- *  This method is used for freeing the memory in all the
- *  used texture memory slots.
- ***********************************************************/
-void SceneManager::DestroyGLTextures()
-{
-	for (int i = 0; i < m_loadedTextures; i++)
-	{
-		glGenTextures(1, &m_textureIDs[i].ID);
-	}
-}
-
-/***********************************************************
- *  FindTextureID()
- *
- *  This method is used for getting an ID for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureID(std::string tag)
-{
-	int textureID = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureID = m_textureIDs[index].ID;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureID);
-}
-
-/***********************************************************
- *  FindTextureSlot()
- *
- *  This method is used for getting a slot index for the previously
- *  loaded texture bitmap associated with the passed in tag.
- ***********************************************************/
-int SceneManager::FindTextureSlot(std::string tag)
-{
-	int textureSlot = -1;
-	int index = 0;
-	bool bFound = false;
-
-	while ((index < m_loadedTextures) && (bFound == false))
-	{
-		if (m_textureIDs[index].tag.compare(tag) == 0)
-		{
-			textureSlot = index;
-			bFound = true;
-		}
-		else
-			index++;
-	}
-
-	return(textureSlot);
-}
-
-/***********************************************************
- *  FindMaterial()
- *
- *  This method is used for getting a material from the previously
- *  defined materials list that is associated with the passed in tag.
- ***********************************************************/
-bool SceneManager::FindMaterial(std::string tag, OBJECT_MATERIAL& material)
-{
-	if (m_objectMaterials.size() == 0)
-	{
-		return(false);
-	}
-
-	int index = 0;
-	bool bFound = false;
-	while ((index < m_objectMaterials.size()) && (bFound == false))
-	{
-		if (m_objectMaterials[index].tag.compare(tag) == 0)
-		{
-			bFound = true;
-			material.diffuseColor = m_objectMaterials[index].diffuseColor;
-			material.specularColor = m_objectMaterials[index].specularColor;
-			material.shininess = m_objectMaterials[index].shininess;
-		}
-		else
-		{
-			index++;
-		}
-	}
-
-	return(true);
-}
-
-/***********************************************************
- *  SetTransformations()
- *
- *  This method is used for setting the transform buffer
- *  using the passed in transformation values.
- ***********************************************************/
-void SceneManager::SetTransformations(
-	glm::vec3 scaleXYZ,
-	float XrotationDegrees,
-	float YrotationDegrees,
-	float ZrotationDegrees,
-	glm::vec3 positionXYZ)
-{
-	// variables for this method
-	glm::mat4 modelView;
-	glm::mat4 scale;
-	glm::mat4 rotationX;
-	glm::mat4 rotationY;
-	glm::mat4 rotationZ;
-	glm::mat4 translation;
-
-	// set the scale value in the transform buffer
-	scale = glm::scale(scaleXYZ);
-	// set the rotation values in the transform buffer
-	rotationX = glm::rotate(glm::radians(XrotationDegrees), glm::vec3(1.0f, 0.0f, 0.0f));
-	rotationY = glm::rotate(glm::radians(YrotationDegrees), glm::vec3(0.0f, 1.0f, 0.0f));
-	rotationZ = glm::rotate(glm::radians(ZrotationDegrees), glm::vec3(0.0f, 0.0f, 1.0f));
-	// set the translation value in the transform buffer
-	translation = glm::translate(positionXYZ);
-
-	modelView = translation * rotationZ * rotationY * rotationX * scale;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setMat4Value(g_ModelName, modelView);
-	}
-}
-
-/***********************************************************
- *  SetShaderColor()
- *
- *  This method is used for setting the passed in color
- *  into the shader for the next draw command
- ***********************************************************/
-void SceneManager::SetShaderColor(
-	float redColorValue,
-	float greenColorValue,
-	float blueColorValue,
-	float alphaValue)
-{
-	// variables for this method
-	glm::vec4 currentColor;
-
-	currentColor.r = redColorValue;
-	currentColor.g = greenColorValue;
-	currentColor.b = blueColorValue;
-	currentColor.a = alphaValue;
-
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, false);
-		m_pShaderManager->setVec4Value(g_ColorValueName, currentColor);
-	}
-}
-
-/***********************************************************
- *  SetShaderTexture()
- *
- *  This method is used for setting the texture data
- *  associated with the passed in ID into the shader.
- ***********************************************************/
-void SceneManager::SetShaderTexture(
-	std::string textureTag)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setIntValue(g_UseTextureName, true);
-
-		int textureID = -1;
-		textureID = FindTextureSlot(textureTag);
-		m_pShaderManager->setSampler2DValue(g_TextureValueName, textureID);
-	}
-}
-
-/***********************************************************
- *  SetTextureUVScale()
- *
- *  This method is used for setting the texture UV scale
- *  values into the shader.
- ***********************************************************/
-void SceneManager::SetTextureUVScale(float u, float v)
-{
-	if (NULL != m_pShaderManager)
-	{
-		m_pShaderManager->setVec2Value("UVscale", glm::vec2(u, v));
-	}
-}
-
-/***********************************************************
- *  SetShaderMaterial()
- *
- *  This method is used for passing the material values
- *  into the shader.
- ***********************************************************/
-void SceneManager::SetShaderMaterial(
-	std::string materialTag)
-{
-	if (m_objectMaterials.size() > 0)
-	{
-		OBJECT_MATERIAL material;
-		bool bReturn = false;
-
-		bReturn = FindMaterial(materialTag, material);
-		if (bReturn == true)
-		{
-			m_pShaderManager->setVec3Value("material.diffuseColor", material.diffuseColor);
-			m_pShaderManager->setVec3Value("material.specularColor", material.specularColor);
-			m_pShaderManager->setFloatValue("material.shininess", material.shininess);
-		}
-	}
-}
-
-
-//-------------------------------------------------------------------------------------------------------------------MODIFY CODE BELOW-------------------------------------------
-// _________________________________________________________ADDED CODE BY STUDENT - MAX _______________________________________________________THIS IS HERE FOR DETECTABILITY-----
-
-
- /***********************************************************
-  *  DefineObjectMaterials()
-  *
-  *  This method is used for configuring the various material
-  *  settings for all of the objects within the 3D scene.
-  ***********************************************************/
-void SceneManager::DefineObjectMaterials()
-{
-	/*** STUDENTS - add the code BELOW for defining object materials. ***/
-	/*** There is no limit to the number of object materials that can ***/
-	/*** be defined. Refer to the code in the OpenGL Sample for help  ***/
-	OBJECT_MATERIAL whiteMat;
-	whiteMat.diffuseColor = glm::vec3(1.0f, 1.0f, 1.0f);
-	whiteMat.specularColor = glm::vec3(0.4f, 0.4f, 0.4f);
-	whiteMat.shininess = 32.0f;
-	whiteMat.tag = "default";
-
-	m_objectMaterials.push_back(whiteMat);
-
-}
-
-/***********************************************************
- *  SetupSceneLights()
- *
- *  This method is called to add and configure the light
- *  sources for the 3D scene.  There are up to 4 light sources.
- ***********************************************************/
-void SceneManager::SetupSceneLights()
-{
-	// Enable lighting
-	m_pShaderManager->setBoolValue(g_UseLightingName, true);
-
-	// Disable unused lights first
-	m_pShaderManager->setBoolValue("spotLight.bActive", false);
-	for (int i = 0; i < 4; ++i)
-		m_pShaderManager->setBoolValue(("pointLights[" + std::to_string(i) + "].bActive").c_str(), false);
-
-	// Bright directional light to simulate daylight from the kitchen window
-	m_pShaderManager->setVec3Value("directionalLight.direction", glm::vec3(-0.3f, -1.0f, -0.3f));
-	m_pShaderManager->setVec3Value("directionalLight.ambient", glm::vec3(0.2f, 0.2f, 0.2f));    // was 0.4
-	m_pShaderManager->setVec3Value("directionalLight.diffuse", glm::vec3(0.5f, 0.5f, 0.5f));    // was 0.9
-	m_pShaderManager->setVec3Value("directionalLight.specular", glm::vec3(0.7f, 0.7f, 0.7f));   // was 1.0
-	m_pShaderManager->setBoolValue("directionalLight.bActive", true);
-
-	// Warm overhead point light to soften the shadows, pancakes must look stacked
-	m_pShaderManager->setVec3Value("pointLights[0].position", glm::vec3(0.0f, 5.0f, 1.0f));
-	m_pShaderManager->setVec3Value("pointLights[0].ambient", glm::vec3(0.1f, 0.09f, 0.08f));    // was 0.2
-	m_pShaderManager->setVec3Value("pointLights[0].diffuse", glm::vec3(0.6f, 0.5f, 0.4f));      // was 0.8
-	m_pShaderManager->setVec3Value("pointLights[0].specular", glm::vec3(0.4f, 0.3f, 0.2f));     // was 0.9
-	m_pShaderManager->setBoolValue("pointLights[0].bActive", true);
-
-}
-
-
-/***********************************************************
- *  LoadSceneTextures()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene
- *  rendering
- ***********************************************************/
-void SceneManager::LoadSceneTextures()
-{
-	bool bReturn = false;
-
-
-
-	bReturn = CreateGLTexture(
-		"textures/marble.png",
-		"marbleFloor");
-
-	bReturn = CreateGLTexture(
-		"textures/berry.jpg",
-		"berry");
-
-	bReturn = CreateGLTexture(
-		"textures/pancake_face.jpg",
-		"pancakeFace");
-
-	bReturn = CreateGLTexture(
-		"textures/brickWall.png",
-		"brick");
-
-	//Bind to GPU
-	BindGLTextures();
-
-}
-
-/***********************************************************
- *  PrepareScene()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void SceneManager::PrepareScene()
-{
-
-	//Call textures for loading
-	LoadSceneTextures();
-	// define the materials for objects in the scene
-	DefineObjectMaterials();
-	// add and define the light sources for the scene
-	SetupSceneLights();
-
-	// only one instance of a particular mesh needs to be
-	// loaded in memory no matter how many times it is drawn
-	// in the rendered 3D scene
-
-	m_basicMeshes->LoadPlaneMesh();
-	m_basicMeshes->LoadConeMesh();
-	m_basicMeshes->LoadCylinderMesh();
-	m_basicMeshes->LoadPrismMesh();
-	m_basicMeshes->LoadTorusMesh();
-	m_basicMeshes->LoadSphereMesh();
-	m_basicMeshes->LoadTaperedCylinderMesh();
-	m_basicMeshes->LoadPyramid3Mesh();
-
-}
-
-/***********************************************************
- *  RenderScene()
- *
- *  This method is used for rendering the 3D scene by 
- *  transforming and drawing the basic 3D shapes
- ***********************************************************/
-void SceneManager::RenderScene()
-{
-	// declare the variables for the transformations
-	glm::vec3 scaleXYZ;
-	float XrotationDegrees = 0.0f;
-	float YrotationDegrees = 0.0f;
-	float ZrotationDegrees = 0.0f;
-	glm::vec3 positionXYZ;
-
-	/*** Set needed transformations before drawing the basic mesh.  ***/
-	/*** This same ordering of code should be used for transforming ***/
-	/*** and drawing all the basic 3D shapes.						***/
-	/******************************************************************/
-	// set the XYZ scale for the mesh
-	scaleXYZ = glm::vec3(20.0f, 1.0f, 10.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 0.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 0.0f, 0.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("marbleFloor");
-
-	//Marble counter is tiled
-	SetTextureUVScale(5.0f, 5.0f);
-	SetShaderMaterial("default");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	//Start construction of backwall item
-	scaleXYZ = glm::vec3(20.0f, 1.0f, 10.0f);
-
-	// set the XYZ rotation for the mesh
-	XrotationDegrees = 90.0f;
-	YrotationDegrees = 0.0f;
-	ZrotationDegrees = 0.0f;
-
-	// set the XYZ position for the mesh
-	positionXYZ = glm::vec3(0.0f, 5.0f, -8.0f);
-
-	// set the transformations into memory to be used on the drawn meshes
-	SetTransformations(
-		scaleXYZ,
-		XrotationDegrees,
-		YrotationDegrees,
-		ZrotationDegrees,
-		positionXYZ);
-
-	SetShaderTexture("brick");
-
-	//Brick wall scaling
-	SetTextureUVScale(2.0f, 2.0f);
-	//Set material required for shading
-	SetShaderMaterial("default");
-
-	// draw the mesh with transformation values
-	m_basicMeshes->DrawPlaneMesh();
-
-	/****************************************************************/
-
-
-	// ======================= PLATE BASE ==================================
-
-	glm::vec3 plateScale = glm::vec3(7.0f, 0.2f, 7.0f); // Wide and thin
-	glm::vec3 platePosition = glm::vec3(0.0f, 0.1f, 0.0f); // Just above floor
-	SetTransformations(plateScale, 0.0f, 0.0f, 0.0f, platePosition);
-	// Optional: Use a white glossy ceramic color
-	SetShaderColor(0.90f, 0.90f, 0.90f, 1.0f); // near-white
-	//Set material required for shading
-	SetShaderMaterial("default");
-	m_basicMeshes->DrawTaperedCylinderMesh(); // Plate body
-
-	// Function to create stack of pancake objects - Makes a pancake with a cylindermesh, then adds torus to end to make the pancake shaped properly
-	for (int i = 0; i < 6; ++i) { // Number of pancakes = i
-		float yHeight = 0.3f + (i * 0.35f);  //Height by the number of pancakes
-		glm::vec3 scaleXYZ = glm::vec3(5.0f, 0.3f, 5.0f); // XYZ Scale to make all pancakes wide and flat
-		glm::vec3 positionXYZ = glm::vec3(0.0f, yHeight, 0.0f);
-
-		SetTransformations(scaleXYZ, 0.0f, 0.0f, 0.0f, positionXYZ); //No XYZ rotationdegress needed
-
-		//SetShaderColor(0.76f, 0.48f, 0.28f, 1);  // light brown pancake
-		SetShaderTexture("pancakeFace");
-		SetTextureUVScale(1.0f, 1.0f);
-		
-			//Set material required for shading
-		SetShaderMaterial("default");
-		m_basicMeshes->DrawCylinderMesh(); //Draws the Cylinder to the values, above then continues to the torus shape below
-
-		glm::vec3 ringScale = glm::vec3(4.4f, 4.4f, 0.9f);  // Scaled all the same, wife and flat with slight curve on the depth for thickness
-		glm::vec3 ringPosition = glm::vec3(0.0f, yHeight, 0.0f);  // Applied with the number of pancakes, on each pancake
-		XrotationDegrees = 90.0f; //Applied to lay down torus flat
-		YrotationDegrees = 0.0f;
-		ZrotationDegrees = 0.0f;
-
-		SetTransformations(ringScale, 
-			XrotationDegrees,
-			YrotationDegrees,
-			ZrotationDegrees, 
-			ringPosition);
-
-		//SetShaderColor(0.76f, 0.52f, 0.28f, 1);  // slightly lighter tint of brown to resemble pancake coloring
-		SetShaderTexture("pancakeFace");
-		//Set material required for shading
-		SetShaderMaterial("default");
-		SetTextureUVScale(1.0f, yHeight);
-
-		m_basicMeshes->DrawTorusMesh(); //Draws the torus and continues loop to next pancake
-
-	}
-
-	// ====================== ORANGE JUICE (Tapered Cylinder) ========================
-
-	glm::vec3 glassScale = glm::vec3(1.2f, 2.8f, 1.2f); // tall and narrow
-	glm::vec3 glassPosition = glm::vec3(8.0f, 3.0f, 0.0f); // just to the right of pancakes
-	SetTransformations(glassScale, 180.0f, 0.0f, 0.0f, glassPosition);
-
-	// Set glassy color (light blue-gray) and lower specular shine
-	SetShaderColor(1.0f, 0.65f, 0.0f, 1.0f); // true orange, semi-transparent
-	SetShaderMaterial("default");
-	m_basicMeshes->DrawTaperedCylinderMesh();
-
-
-	// ====================== GLASS BASE (Tapered Cylinder) ========================
-
-	glm::vec3 juiceScale = glm::vec3(1.4f, 3.0f, 1.4f); // slightly smaller than glass
-	glm::vec3 juicePosition = glm::vec3(8.0f, 3.25f, 0.0f); // inside the cup
-	SetTransformations(juiceScale, 180.0f, 0.0f, 0.0f, juicePosition);
-
-	// Set orange color (can also use a texture if you want)
-	SetShaderColor(0.9f, 0.9f, 1.0f, 0.2f);  // light bluish glass with high transparency
-	SetShaderMaterial("glass"); // use basic speculars
-	m_basicMeshes->DrawTaperedCylinderMesh();
-
-	// ---------------------BERRIES ----------------------------------BERRIES -----------------------------------BERRIES ----------------------------
-	
-	// ====================== EMPTY CLEAR BOTTLE ========================
-	SetShaderColor(0.9f, 0.9f, 1.0f, 0.2f);  // light bluish glass with high transparency
-	SetShaderMaterial("glass"); // use basic speculars
-
-	// ---- Bottom Half Sphere (base of bottle) ----
-	SetTransformations(
-		glm::vec3(0.9f, 0.3f, 0.9f),
-		0.0f, 0.0f, 180.0f,
-		glm::vec3(6.0f, 0.9f, -1.8f));  // shifted back near the glass
-	m_basicMeshes->DrawHalfSphereMesh();
-
-	// ---- Main Cylinder (body of bottle) ----
-	SetTransformations(
-		glm::vec3(0.9f, 4.0f, 0.9f),
-		0.0f, 0.0f, 0.0f,
-		glm::vec3(6.0f, 0.9f, -1.8f));
-	m_basicMeshes->DrawCylinderMesh();
-
-	// ---- Rounded Top Half Sphere ----
-	SetTransformations(
-		glm::vec3(0.905f, 0.9f, 0.905f),
-		0.0f, -6.0f, 0.0f,
-		glm::vec3(6.0f, 4.9f, -1.8f));
-	m_basicMeshes->DrawHalfSphereMesh();
-
-	// ---- Top Neck Cylinder ----
-	SetTransformations(
-		glm::vec3(0.3f, 2.0f, 0.3f),
-		0.0f, 0.0f, 0.0f,
-		glm::vec3(6.0f, 5.6f, -1.8f));
-	m_basicMeshes->DrawCylinderMesh();
-
-	// ---- Cap Ring (Torus) ----
-	SetTransformations(
-		glm::vec3(0.32f, 0.32f, 1.5f),
-		90.0f, 0.0f, 0.0f,
-		glm::vec3(6.0f, 7.4f, -1.8f));
-	m_basicMeshes->DrawTorusMesh();
-
-	// ---- Bottle Rim (Torus) ----
-	SetTransformations(
-		glm::vec3(0.28f, 0.28f, 0.4f),
-		90.0f, 0.0f, 0.0f,
-		glm::vec3(6.0f, 7.6f, -1.8f));
-	m_basicMeshes->DrawTorusMesh();
-
-	//==========================Syrup==============================
-
-	SetShaderColor(0.35f, 0.15f, 0.05f, 1.0f); // Molasses colored Or syrup
-	SetShaderMaterial("default");
-
-	// ---- Bottom Half Sphere (base of bottle) ----
-	SetTransformations(
-		glm::vec3(.91f, 2.7f, .91f),
-		0.0f, 0.0f, 180.0f,
-		glm::vec3(6.0f, 2.9f, -1.8f));  // shifted back near the glass cup
-	m_basicMeshes->DrawCylinderMesh();
-
-}
+///////////////////////////////////////////////////////////////////////////////
+// scenemanager.cpp
+// ============
+// manage the preparing and rendering of 3D scenes - textures, materials, lighting
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneManager.h"
+
+#ifndef STB_IMAGE_IMPLEMENTATION
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+#endif
+
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
+
+// declaration of global variables and defines
+namespace
+{
+	// compiled scene file that is loaded when it exists
+	const char* g_DefaultSceneFile = "scenes/kitchen.scene";
+	// range of the point lights that do not set one, which
+	// reaches across the whole kitchen
+	const float g_DefaultLightRange = 40.0f;
+	// starting size of each frame region of the dynamic buffer,
+	// it grows when a frame needs more
+	const GLsizeiptr g_DynamicRegionSize = 2 * 1024 * 1024;
+	// how far the mesh bounds are grown, so a mesh is never
+	// culled while part of it is still on screen
+	const float g_MeshBoundsPadding = 0.05f;
+	// projected radius in pixels below which each coarser level
+	// of detail of a mesh is drawn
+	const float g_LodScreenRadii[MeshBuffer::LOD_COUNT - 1] = { 64.0f, 24.0f };
+	// part of the radius of a level on either side of it where
+	// the two levels are crossfaded
+	const float g_LodFadeBand = 0.15f;
+
+	// the fragment shader code that dithers the two levels of
+	// detail of a crossfade, the level fading in keeps a growing
+	// part of a 4x4 ordered dither and the level fading out keeps
+	// the rest, so together they cover every pixel once
+	const char* const g_LodFadeShaderSource = R"(
+#define SCENE_LOD_FADE 1
+
+// dither of the draws that set their values as uniforms
+uniform float lodFade;
+
+bool IsLodFadeDiscarded(float fade)
+{
+	const float bayer[16] = float[16](
+		0.0, 8.0, 2.0, 10.0,
+		12.0, 4.0, 14.0, 6.0,
+		3.0, 11.0, 1.0, 9.0,
+		15.0, 7.0, 13.0, 5.0);
+	ivec2 pixel = ivec2(gl_FragCoord.xy) & 3;
+	float threshold = (bayer[(pixel.y * 4) + pixel.x] + 0.5) / 16.0;
+
+	// a level fading in has a positive fade, one fading out a negative one
+	if (fade > 0.0)
+	{
+		return(threshold >= fade);
+	}
+	if (fade < 0.0)
+	{
+		return(threshold < -fade);
+	}
+
+	return(false);
+}
+)";
+}
+
+/***********************************************************
+ *  SceneManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+SceneManager::SceneManager(ShaderManager* pShaderManager, UniformCache* pUniformCache)
+{
+	m_pShaderManager = pShaderManager;
+	m_pUniformCache = pUniformCache;
+	// create the shape meshes object
+	m_basicMeshes = new ShapeMeshes();
+
+	// initialize the texture collection
+	m_overflowTextureUnit = -1;
+	m_overflowTexture = -1;
+	m_pTextureLoader = new TextureLoader();
+	m_bTexturesPending = false;
+
+	m_objectGroups.push_back("Scene");
+	m_currentGroup = 0;
+	m_pFrameProfiler = NULL;
+	m_bProfileGroups = false;
+	m_renderStatistics = RENDER_STATISTICS();
+	ResetRenderState();
+
+	m_bFrustumCulling = true;
+	for (int i = 0; i < MAX_VIEWS; i++)
+	{
+		m_sceneViews[i].view = glm::mat4(1.0f);
+		m_sceneViews[i].projection = glm::mat4(1.0f);
+		m_sceneViews[i].viewPosition = glm::vec3(0.0f);
+		m_sceneViews[i].viewportX = 0;
+		m_sceneViews[i].viewportY = 0;
+		m_sceneViews[i].viewportWidth = 0;
+		m_sceneViews[i].viewportHeight = 0;
+	}
+	m_viewCount = 1;
+	m_frameView = m_sceneViews[0];
+	m_minScreenRadius = 1.0f;
+	m_bBoundsDirty = false;
+	DefineMeshBounds();
+
+	m_bIndirectSupported = false;
+	m_bIndirectDraws = true;
+	m_bDrawBlockSupported = false;
+	m_bLodFadeSupported = false;
+	m_instanceBuffer = 0;
+	m_materialBuffer = 0;
+	m_commandBuffer = 0;
+	m_bGpuCullingSupported = false;
+	m_bGpuCulling = true;
+	m_sceneFileName = g_DefaultSceneFile;
+	m_syntheticObjectCount = 0;
+	m_bStreaming = false;
+	m_bResidencyDirty = false;
+	m_residentTextureBytes = 0;
+	m_bClusteredLightingSupported = false;
+	m_bClusteredLighting = true;
+	m_sceneLights = UniformCache::LIGHT_BLOCK();
+	m_bShadowsSupported = false;
+	m_bShadows = true;
+	m_shadowTextureUnit = -1;
+	m_dynamicInstanceCount = 0;
+
+	// prepare the frames on every core, the context thread
+	// joins the workers while it waits on them
+	m_pJobSystem = new JobSystem();
+	m_pJobSystem->StartWorkers(std::max((int)std::thread::hardware_concurrency() - 1, 0));
+	m_prepareFrame = 0;
+	m_submitFrame = 0;
+	m_submitView = 0;
+	m_bFramePipelining = false;
+	for (int i = 0; i < 2; i++)
+	{
+		m_frameCommands[i].viewCount = 0;
+		m_frameCommands[i].bPrepared = false;
+	}
+}
+
+/***********************************************************
+ *  ~SceneManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+SceneManager::~SceneManager()
+{
+	// free the allocated objects
+	m_pShaderManager = NULL;
+	m_pUniformCache = NULL;
+	m_pFrameProfiler = NULL;
+	if (NULL != m_basicMeshes)
+	{
+		delete m_basicMeshes;
+		m_basicMeshes = NULL;
+	}
+
+	// finish the frame jobs before anything they read is freed
+	if (NULL != m_pJobSystem)
+	{
+		delete m_pJobSystem;
+		m_pJobSystem = NULL;
+	}
+
+	// stop the texture loading before freeing the textures
+	if (NULL != m_pTextureLoader)
+	{
+		delete m_pTextureLoader;
+		m_pTextureLoader = NULL;
+	}
+
+	// free the allocated OpenGL textures
+	DestroyGLTextures();
+
+	// free the shared mesh buffer and the indirect draw buffers
+	CloseMeshFiles();
+	DestroyIndirectBuffers();
+	m_dynamicBuffer.Destroy();
+	m_gpuCulling.Destroy();
+	m_meshBuffer.Destroy();
+	m_lightClusters.Destroy();
+	m_shadowMaps.Destroy();
+}
+
+/***********************************************************
+ *  CreateGLTexture()
+ *
+ *  This method is used for loading textures from image files,
+ *  configuring the texture mapping parameters in OpenGL, and
+ *  registering the texture in the next available texture
+ *  slot in memory.  The texture starts out as a one pixel
+ *  placeholder while the image file is decoded on a worker
+ *  thread, and the real image replaces it once it has been
+ *  uploaded by UpdateGLTextures().  False is returned when
+ *  the image file can not be opened, and nothing is
+ *  registered for the tag then.
+ ***********************************************************/
+bool SceneManager::CreateGLTexture(const char* filename, const std::string& tag)
+{
+	// only the file is checked here, it is decoded in the background
+	if (!m_pTextureLoader->IsImageAvailable(filename))
+	{
+		std::cout << "Could not load image:" << filename << std::endl;
+		return(false);
+	}
+
+	// register the texture and associate it with the special tag string
+	TEXTURE_INFO texture;
+	texture.tag = tag;
+	texture.ID = CreatePlaceholderTexture();
+	texture.width = 1;
+	texture.height = 1;
+	texture.internalFormat = GL_RGBA8;
+	texture.mipLevels = 1;
+	texture.unit = -1;
+	texture.arrayIndex = -1;
+	texture.layer = -1;
+	texture.filename = filename;
+	texture.streamReferences = 0;
+	texture.bLoading = false;
+	texture.bLoaded = false;
+	texture.bytes = 0;
+
+	m_textureSlots[tag] = m_textureIDs.size();
+	m_textureIDs.push_back(texture);
+
+	// decode the image file in the background, a streamed
+	// texture waits until a cell that uses it is loaded
+	if (!m_bStreaming)
+	{
+		QueueGLTexture(m_textureSlots[tag]);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CreatePlaceholderTexture()
+ *
+ *  This method is used for creating a one pixel texture with
+ *  the mapping parameters of the scene textures, which is
+ *  shown until the real image is uploaded into it.
+ ***********************************************************/
+GLuint SceneManager::CreatePlaceholderTexture()
+{
+	// neutral gray shown until the real image is uploaded
+	const unsigned char placeholder[4] = { 128, 128, 128, 255 };
+	GLuint textureID = 0;
+
+	glGenTextures(1, &textureID);
+	glBindTexture(GL_TEXTURE_2D, textureID);
+
+	// set the texture wrapping parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	// set texture filtering parameters
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, placeholder);
+	glBindTexture(GL_TEXTURE_2D, 0); // Unbind the texture
+
+	return(textureID);
+}
+
+/***********************************************************
+ *  QueueGLTexture()
+ *
+ *  This method is used for queueing the image file of the
+ *  texture at the passed in slot to be decoded on a worker
+ *  thread.  It is uploaded by UpdateGLTextures().
+ ***********************************************************/
+void SceneManager::QueueGLTexture(int textureSlot)
+{
+	TEXTURE_INFO& texture = m_textureIDs[textureSlot];
+
+	m_pTextureLoader->QueueImage(texture.filename, textureSlot);
+	texture.bLoading = true;
+	m_bTexturesPending = true;
+}
+
+/***********************************************************
+ *  ReleaseGLTexture()
+ *
+ *  This method is used for freeing the GPU memory of a
+ *  streamed texture that no loaded cell uses anymore.  The
+ *  texture is replaced by a new placeholder in the same slot
+ *  and on the same texture unit, so it can be loaded again.
+ ***********************************************************/
+void SceneManager::ReleaseGLTexture(int textureSlot)
+{
+	TEXTURE_INFO& texture = m_textureIDs[textureSlot];
+
+	// streamed textures are never packed into arrays
+	if (texture.arrayIndex >= 0)
+	{
+		return;
+	}
+
+	glDeleteTextures(1, &texture.ID);
+	texture.ID = CreatePlaceholderTexture();
+	texture.width = 1;
+	texture.height = 1;
+	texture.internalFormat = GL_RGBA8;
+	texture.mipLevels = 1;
+	texture.bLoaded = false;
+
+	if (texture.unit >= 0)
+	{
+		glActiveTexture(GL_TEXTURE0 + texture.unit);
+		glBindTexture(GL_TEXTURE_2D, texture.ID);
+	}
+	// the deleted texture may still be the one on the overflow unit
+	if (m_overflowTexture == textureSlot)
+	{
+		m_overflowTexture = -1;
+	}
+
+	m_residentTextureBytes -= texture.bytes;
+	texture.bytes = 0;
+}
+
+/***********************************************************
+ *  UpdateGLTextures()
+ *
+ *  This method is used for uploading the images that have
+ *  finished decoding into their textures.  The uploads are
+ *  spread over frames by a byte budget, and once every image
+ *  has arrived the textures are bound again so they can be
+ *  packed into texture arrays.
+ ***********************************************************/
+void SceneManager::UpdateGLTextures()
+{
+	// bytes of decoded pixels uploaded per frame, at least one image is always uploaded
+	const int uploadBudget = 16 * 1024 * 1024;
+	int uploadedBytes = 0;
+	TextureLoader::DECODED_IMAGE image;
+
+	if (m_bTexturesPending == false)
+	{
+		return;
+	}
+
+	while ((uploadedBytes < uploadBudget) && (m_pTextureLoader->PopDecodedImage(image)))
+	{
+		TEXTURE_INFO& texture = m_textureIDs[image.slot];
+		int imageBytes = image.bCompressed ? image.compressedData.size() : image.width * image.height * image.colorChannels;
+
+		texture.bLoading = false;
+
+		// the cells that wanted a streamed texture may have been
+		// evicted while its image was being decoded
+		if (m_bStreaming && (texture.streamReferences == 0))
+		{
+			m_pTextureLoader->DiscardImage(image);
+			continue;
+		}
+
+		if (m_pTextureLoader->UploadImage(image, texture.ID))
+		{
+			texture.width = image.width;
+			texture.height = image.height;
+			texture.internalFormat = image.internalFormat;
+			texture.mipLevels = image.mipLevels;
+			// uncompressed images are expanded to four channels with a mipmap chain
+			texture.bytes = image.bCompressed ? imageBytes : ((size_t)image.width * image.height * 4 * 4) / 3;
+			m_residentTextureBytes += texture.bytes;
+		}
+		// an image that failed to load is not tried again
+		texture.bLoaded = true;
+
+		uploadedBytes += imageBytes;
+	}
+
+	if (m_pTextureLoader->IsIdle())
+	{
+		m_bTexturesPending = false;
+
+		// the workers stay up for the cells that are streamed in later
+		if (!m_bStreaming)
+		{
+			m_pTextureLoader->StopWorkers();
+			m_pTextureLoader->DestroyStagingBuffer();
+
+			BindGLTextures();
+		}
+	}
+}
+
+/***********************************************************
+ *  BuildTextureArrays()
+ *
+ *  This method is used for packing the loaded textures into
+ *  the layers of array textures.  Textures with the same size
+ *  and format share one array, so switching between them
+ *  only changes the layer index instead of the bound texture.
+ ***********************************************************/
+void SceneManager::BuildTextureArrays()
+{
+	// assign every loaded texture to an array with the same size and format
+	for (int i = 0; i < m_textureIDs.size(); i++)
+	{
+		TEXTURE_INFO& texture = m_textureIDs[i];
+		int arrayIndex = -1;
+		int index = 0;
+
+		while ((index < m_textureArrays.size()) && (arrayIndex < 0))
+		{
+			if ((m_textureArrays[index].width == texture.width) &&
+				(m_textureArrays[index].height == texture.height) &&
+				(m_textureArrays[index].internalFormat == texture.internalFormat) &&
+				(m_textureArrays[index].mipLevels == texture.mipLevels))
+			{
+				arrayIndex = index;
+			}
+			else
+				index++;
+		}
+
+		if (arrayIndex < 0)
+		{
+			TEXTURE_ARRAY_INFO textureArray;
+			textureArray.ID = 0;
+			textureArray.width = texture.width;
+			textureArray.height = texture.height;
+			textureArray.internalFormat = texture.internalFormat;
+			textureArray.mipLevels = texture.mipLevels;
+			textureArray.layers = 0;
+			textureArray.unit = -1;
+
+			arrayIndex = m_textureArrays.size();
+			m_textureArrays.push_back(textureArray);
+		}
+
+		texture.arrayIndex = arrayIndex;
+		texture.layer = m_textureArrays[arrayIndex].layers;
+		m_textureArrays[arrayIndex].layers++;
+	}
+
+	// allocate the array textures with the mipmap levels of their textures
+	for (int i = 0; i < m_textureArrays.size(); i++)
+	{
+		TEXTURE_ARRAY_INFO& textureArray = m_textureArrays[i];
+
+		glGenTextures(1, &textureArray.ID);
+		glBindTexture(GL_TEXTURE_2D_ARRAY, textureArray.ID);
+		glTexStorage3D(
+			GL_TEXTURE_2D_ARRAY,
+			textureArray.mipLevels,
+			textureArray.internalFormat,
+			textureArray.width,
+			textureArray.height,
+			textureArray.layers);
+
+		// use the same wrapping and filtering as the separate textures
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_S, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_WRAP_T, GL_REPEAT);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+		glTexParameteri(GL_TEXTURE_2D_ARRAY, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	}
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+
+	// copy every mipmap level of the textures into their layers on the GPU,
+	// then free the separate textures
+	for (int i = 0; i < m_textureIDs.size(); i++)
+	{
+		TEXTURE_INFO& texture = m_textureIDs[i];
+		const TEXTURE_ARRAY_INFO& textureArray = m_textureArrays[texture.arrayIndex];
+		int levelWidth = texture.width;
+		int levelHeight = texture.height;
+
+		for (int level = 0; level < texture.mipLevels; level++)
+		{
+			glCopyImageSubData(
+				texture.ID, GL_TEXTURE_2D, level, 0, 0, 0,
+				textureArray.ID, GL_TEXTURE_2D_ARRAY, level, 0, 0, texture.layer,
+				levelWidth, levelHeight, 1);
+
+			levelWidth = std::max(levelWidth / 2, 1);
+			levelHeight = std::max(levelHeight / 2, 1);
+		}
+
+		glDeleteTextures(1, &texture.ID);
+		texture.ID = textureArray.ID;
+	}
+
+	std::cout << "Packed " << m_textureIDs.size() << " textures into " << m_textureArrays.size() << " texture arrays" << std::endl;
+}
+
+/***********************************************************
+ *  BindGLTextures()
+ *
+ *  This method is used for binding the loaded textures to
+ *  OpenGL texture memory slots.  When the shader samples from
+ *  an array texture, the textures are packed into arrays and
+ *  only the arrays need to be bound.  Otherwise each texture
+ *  gets its own slot, up to the number of texture units, and
+ *  any textures beyond that are bound on demand.
+ ***********************************************************/
+void SceneManager::BindGLTextures()
+{
+	GLint maxTextureUnits = 0;
+
+	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &maxTextureUnits);
+
+	// array textures need immutable storage and GPU image copies, and
+	// can only be built once every texture has its final size, so the
+	// textures of a streamed scene are kept apart
+	if ((m_bTexturesPending == false) &&
+		(m_bStreaming == false) &&
+		(NULL != m_pUniformCache) &&
+		(m_pUniformCache->HasUniform(UniformCache::UNIFORM_OBJECT_TEXTURE_ARRAY)) &&
+		(GLEW_ARB_texture_storage) && (GLEW_ARB_copy_image))
+	{
+		BuildTextureArrays();
+	}
+
+	if (m_textureArrays.size() > 0)
+	{
+		// unit 0 is left to the 2D texture sampler, since two different
+		// sampler types can not read from the same texture unit
+		for (int i = 0; i < m_textureArrays.size(); i++)
+		{
+			m_textureArrays[i].unit = i + 1;
+			glActiveTexture(GL_TEXTURE0 + m_textureArrays[i].unit);
+			glBindTexture(GL_TEXTURE_2D_ARRAY, m_textureArrays[i].ID);
+		}
+		return;
+	}
+
+	// the last units are kept for the shadow maps, and the one
+	// before them for the textures bound on demand
+	m_overflowTextureUnit = maxTextureUnits - 1 - ShadowMaps::TEXTURE_UNIT_COUNT;
+	for (int i = 0; i < m_textureIDs.size(); i++)
+	{
+		if (i < m_overflowTextureUnit)
+		{
+			// bind textures on corresponding texture units
+			m_textureIDs[i].unit = i;
+			glActiveTexture(GL_TEXTURE0 + i);
+			glBindTexture(GL_TEXTURE_2D, m_textureIDs[i].ID);
+		}
+	}
+}
+
+/***********************************************************
+ *  DestroyGLTextures()
+ *
+ *  This method is used for freeing the memory in all the
+ *  used texture memory slots.
+ ***********************************************************/
+void SceneManager::DestroyGLTextures()
+{
+	for (int i = 0; i < m_textureIDs.size(); i++)
+	{
+		// packed textures are freed with their array
+		if (m_textureIDs[i].arrayIndex < 0)
+		{
+			glDeleteTextures(1, &m_textureIDs[i].ID);
+		}
+	}
+	for (int i = 0; i < m_textureArrays.size(); i++)
+	{
+		glDeleteTextures(1, &m_textureArrays[i].ID);
+	}
+
+	m_textureIDs.clear();
+	m_textureArrays.clear();
+	m_textureSlots.clear();
+}
+
+/***********************************************************
+ *  FindTextureID()
+ *
+ *  This method is used for getting an ID for the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureID(const std::string& tag)
+{
+	int textureSlot = FindTextureSlot(tag);
+
+	if (textureSlot < 0)
+	{
+		return(-1);
+	}
+
+	return(m_textureIDs[textureSlot].ID);
+}
+
+/***********************************************************
+ *  FindTextureSlot()
+ *
+ *  This method is used for getting a slot index for the previously
+ *  loaded texture bitmap associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindTextureSlot(const std::string& tag)
+{
+	std::unordered_map<std::string, int>::const_iterator found = m_textureSlots.find(tag);
+
+	if (found == m_textureSlots.end())
+	{
+		return(-1);
+	}
+
+	return(found->second);
+}
+
+/***********************************************************
+ *  RegisterMaterials()
+ *
+ *  This method is used for registering the index of every
+ *  defined material by its tag, so materials can be found
+ *  without scanning the materials list.
+ ***********************************************************/
+void SceneManager::RegisterMaterials()
+{
+	m_materialIndices.clear();
+
+	for (int i = 0; i < m_objectMaterials.size(); i++)
+	{
+		// the first material defined with a tag is the one used
+		if (m_materialIndices.count(m_objectMaterials[i].tag) > 0)
+		{
+			std::cout << "Material tag defined more than once:" << m_objectMaterials[i].tag << std::endl;
+		}
+		else
+		{
+			m_materialIndices[m_objectMaterials[i].tag] = i;
+		}
+	}
+}
+
+/***********************************************************
+ *  FindMaterial()
+ *
+ *  This method is used for getting a material from the previously
+ *  defined materials list that is associated with the passed in tag.
+ *  False is returned when no material has been defined with the tag.
+ ***********************************************************/
+bool SceneManager::FindMaterial(const std::string& tag, OBJECT_MATERIAL& material)
+{
+	int materialIndex = FindMaterialIndex(tag);
+
+	if (materialIndex < 0)
+	{
+		return(false);
+	}
+
+	material.diffuseColor = m_objectMaterials[materialIndex].diffuseColor;
+	material.specularColor = m_objectMaterials[materialIndex].specularColor;
+	material.shininess = m_objectMaterials[materialIndex].shininess;
+
+	return(true);
+}
+
+/***********************************************************
+ *  FindMaterialIndex()
+ *
+ *  This method is used for getting the index of a previously
+ *  defined material that is associated with the passed in tag.
+ ***********************************************************/
+int SceneManager::FindMaterialIndex(const std::string& tag)
+{
+	std::unordered_map<std::string, int>::const_iterator found = m_materialIndices.find(tag);
+
+	if (found == m_materialIndices.end())
+	{
+		return(-1);
+	}
+
+	return(found->second);
+}
+
+/***********************************************************
+ *  SeedTextureSlots()
+ *
+ *  This method is used for filling the texture slot table
+ *  with the passed in tags, the slot of each being its
+ *  position in the list.  No textures are created, so the
+ *  slots are only good for looking the tags up, as the
+ *  regression benchmarks do.
+ ***********************************************************/
+void SceneManager::SeedTextureSlots(const std::vector<std::string>& tags)
+{
+	m_textureSlots.clear();
+
+	for (int i = 0; i < tags.size(); i++)
+	{
+		m_textureSlots[tags[i]] = i;
+	}
+}
+
+/***********************************************************
+ *  SeedMaterials()
+ *
+ *  This method is used for replacing the defined materials
+ *  with the passed in ones and registering them by tag, so
+ *  they can be looked up without defining a whole scene.
+ ***********************************************************/
+void SceneManager::SeedMaterials(const std::vector<OBJECT_MATERIAL>& materials)
+{
+	m_objectMaterials = materials;
+	RegisterMaterials();
+}
+
+/***********************************************************
+ *  BuildModelMatrix()
+ *
+ *  This method is used for calculating the model matrix
+ *  from the passed in transformation values.  The matrix is
+ *  translation * rotationZ * rotationY * rotationX * scale,
+ *  written out in closed form instead of multiplying five
+ *  matrices together.
+ ***********************************************************/
+glm::mat4 SceneManager::BuildModelMatrix(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	return(TransformBatch::ComposeTransform(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ));
+}
+
+/***********************************************************
+ *  SetTransformations()
+ *
+ *  This method is used for setting the transform buffer
+ *  using the passed in transformation values.
+ ***********************************************************/
+void SceneManager::SetTransformations(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	glm::mat4 modelView = BuildModelMatrix(
+		scaleXYZ,
+		XrotationDegrees,
+		YrotationDegrees,
+		ZrotationDegrees,
+		positionXYZ);
+
+	if (NULL != m_pUniformCache)
+	{
+		m_pUniformCache->setMat4Value(UniformCache::UNIFORM_MODEL, modelView);
+	}
+}
+
+/***********************************************************
+ *  SetShaderColor()
+ *
+ *  This method is used for setting the passed in color
+ *  into the shader for the next draw command
+ ***********************************************************/
+void SceneManager::SetShaderColor(
+	float redColorValue,
+	float greenColorValue,
+	float blueColorValue,
+	float alphaValue)
+{
+	// variables for this method
+	glm::vec4 currentColor;
+
+	currentColor.r = redColorValue;
+	currentColor.g = greenColorValue;
+	currentColor.b = blueColorValue;
+	currentColor.a = alphaValue;
+
+	if (NULL != m_pUniformCache)
+	{
+		m_pUniformCache->setIntValue(UniformCache::UNIFORM_USE_TEXTURE, false);
+		m_pUniformCache->setVec4Value(UniformCache::UNIFORM_OBJECT_COLOR, currentColor);
+	}
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the texture data
+ *  associated with the passed in ID into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	const std::string& textureTag)
+{
+	int textureSlot = FindTextureSlot(textureTag);
+
+	if (textureSlot >= 0)
+	{
+		SetShaderTexture(textureSlot);
+	}
+}
+
+/***********************************************************
+ *  SetShaderTexture()
+ *
+ *  This method is used for setting the data of the loaded
+ *  texture at the passed in slot into the shader.  Only the
+ *  values that differ from the last set texture are set, so
+ *  switching between layers of the same array texture only
+ *  changes the layer.
+ ***********************************************************/
+void SceneManager::SetShaderTexture(
+	int textureSlot)
+{
+	if ((NULL == m_pUniformCache) || (m_renderState.textureSlot == textureSlot))
+	{
+		return;
+	}
+
+	const TEXTURE_INFO& texture = m_textureIDs[textureSlot];
+
+	m_renderStatistics.textureChanges++;
+	m_renderState.textureSlot = textureSlot;
+
+	if (m_renderState.bUseTexture != 1)
+	{
+		m_pUniformCache->setIntValue(UniformCache::UNIFORM_USE_TEXTURE, true);
+		m_renderState.bUseTexture = 1;
+	}
+
+	if (texture.arrayIndex >= 0)
+	{
+		int unit = m_textureArrays[texture.arrayIndex].unit;
+
+		if (m_renderState.arrayUnit != unit)
+		{
+			m_pUniformCache->setSampler2DValue(UniformCache::UNIFORM_OBJECT_TEXTURE_ARRAY, unit);
+			m_renderState.arrayUnit = unit;
+		}
+		if (m_renderState.textureLayer != texture.layer)
+		{
+			m_pUniformCache->setIntValue(UniformCache::UNIFORM_OBJECT_TEXTURE_LAYER, texture.layer);
+			m_renderState.textureLayer = texture.layer;
+		}
+	}
+	else
+	{
+		int unit = texture.unit;
+
+		// rebind the overflow unit only when a different texture is needed
+		if (unit < 0)
+		{
+			if (m_overflowTexture != textureSlot)
+			{
+				glActiveTexture(GL_TEXTURE0 + m_overflowTextureUnit);
+				glBindTexture(GL_TEXTURE_2D, texture.ID);
+				m_overflowTexture = textureSlot;
+				m_renderStatistics.textureBinds++;
+			}
+			unit = m_overflowTextureUnit;
+		}
+
+		if (m_renderState.textureUnit != unit)
+		{
+			m_pUniformCache->setSampler2DValue(UniformCache::UNIFORM_OBJECT_TEXTURE, unit);
+			m_renderState.textureUnit = unit;
+		}
+	}
+}
+/***********************************************************
+ *  SetTextureUVScale()
+ *
+ *  This method is used for setting the texture UV scale
+ *  values into the shader.
+ ***********************************************************/
+void SceneManager::SetTextureUVScale(float u, float v)
+{
+	if (NULL != m_pUniformCache)
+	{
+		m_pUniformCache->setVec2Value(UniformCache::UNIFORM_UV_SCALE, glm::vec2(u, v));
+	}
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for passing the material values
+ *  into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(
+	const std::string& materialTag)
+{
+	if (m_objectMaterials.size() > 0)
+	{
+		OBJECT_MATERIAL material;
+		bool bReturn = false;
+
+		bReturn = FindMaterial(materialTag, material);
+		if (bReturn == true)
+		{
+			m_pUniformCache->setVec3Value(UniformCache::UNIFORM_MATERIAL_DIFFUSE_COLOR, material.diffuseColor);
+			m_pUniformCache->setVec3Value(UniformCache::UNIFORM_MATERIAL_SPECULAR_COLOR, material.specularColor);
+			m_pUniformCache->setFloatValue(UniformCache::UNIFORM_MATERIAL_SHININESS, material.shininess);
+		}
+	}
+}
+
+
+/***********************************************************
+ *  AddTexturedObject()
+ *
+ *  This method is used for adding a textured object to the
+ *  retained draw list.  The model matrix, texture slot and
+ *  material index are resolved once here instead of every
+ *  time the scene is rendered.
+ ***********************************************************/
+void SceneManager::AddTexturedObject(
+	MESH_TYPE mesh,
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ,
+	const std::string& textureTag,
+	glm::vec2 uvScale,
+	const std::string& materialTag)
+{
+	SCENE_OBJECT object;
+
+	object.mesh = mesh;
+	object.model = AddObjectNode(
+		BuildModelMatrix(
+			scaleXYZ,
+			XrotationDegrees,
+			YrotationDegrees,
+			ZrotationDegrees,
+			positionXYZ),
+		m_openNodes.empty() ? -1 : m_openNodes.back());
+	object.textureSlot = FindTextureSlot(textureTag);
+	object.materialIndex = FindMaterialIndex(materialTag);
+	object.color = glm::vec4(1.0f, 1.0f, 1.0f, 1.0f);
+
+	if (object.textureSlot < 0)
+	{
+		std::cout << "Could not find texture:" << textureTag << std::endl;
+	}
+	if (object.materialIndex < 0)
+	{
+		std::cout << "Could not find material:" << materialTag << std::endl;
+	}
+	object.uvScale = uvScale;
+	object.group = m_currentGroup;
+
+	m_sceneObjects.push_back(object);
+}
+
+/***********************************************************
+ *  AddColoredObject()
+ *
+ *  This method is used for adding a solid colored object to
+ *  the retained draw list.
+ ***********************************************************/
+void SceneManager::AddColoredObject(
+	MESH_TYPE mesh,
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ,
+	glm::vec4 color,
+	const std::string& materialTag)
+{
+	SCENE_OBJECT object;
+
+	object.mesh = mesh;
+	object.model = AddObjectNode(
+		BuildModelMatrix(
+			scaleXYZ,
+			XrotationDegrees,
+			YrotationDegrees,
+			ZrotationDegrees,
+			positionXYZ),
+		m_openNodes.empty() ? -1 : m_openNodes.back());
+	object.textureSlot = -1;
+	object.materialIndex = FindMaterialIndex(materialTag);
+	object.color = color;
+	object.uvScale = glm::vec2(1.0f, 1.0f);
+	object.group = m_currentGroup;
+
+	if (object.materialIndex < 0)
+	{
+		std::cout << "Could not find material:" << materialTag << std::endl;
+	}
+
+	m_sceneObjects.push_back(object);
+}
+
+/***********************************************************
+ *  DefineMeshBounds()
+ *
+ *  This method is used for defining the local bounding box
+ *  of each basic mesh.  The plane lies flat in XZ, the round
+ *  meshes stand on the XZ plane with a radius of 1 and a
+ *  height of 1, and the torus lies in the XY plane.  The
+ *  boxes are padded a little, so a mesh is never culled
+ *  while part of it is still on screen.  The bounds of the
+ *  imported meshes are added after these.
+ ***********************************************************/
+void SceneManager::DefineMeshBounds()
+{
+	const glm::vec3 extents[MESH_COUNT][2] =
+	{
+		// MESH_PLANE
+		{ glm::vec3(-1.0f, 0.0f, -1.0f), glm::vec3(1.0f, 0.0f, 1.0f) },
+		// MESH_CONE
+		{ glm::vec3(-1.0f, 0.0f, -1.0f), glm::vec3(1.0f, 1.0f, 1.0f) },
+		// MESH_CYLINDER
+		{ glm::vec3(-1.0f, 0.0f, -1.0f), glm::vec3(1.0f, 1.0f, 1.0f) },
+		// MESH_PRISM
+		{ glm::vec3(-1.0f, -1.0f, -1.0f), glm::vec3(1.0f, 1.0f, 1.0f) },
+		// MESH_TORUS
+		{ glm::vec3(-1.2f, -1.2f, -0.3f), glm::vec3(1.2f, 1.2f, 0.3f) },
+		// MESH_SPHERE
+		{ glm::vec3(-1.0f, -1.0f, -1.0f), glm::vec3(1.0f, 1.0f, 1.0f) },
+		// MESH_HALF_SPHERE
+		{ glm::vec3(-1.0f, -1.0f, -1.0f), glm::vec3(1.0f, 1.0f, 1.0f) },
+		// MESH_TAPERED_CYLINDER
+		{ glm::vec3(-1.0f, 0.0f, -1.0f), glm::vec3(1.0f, 1.0f, 1.0f) },
+		// MESH_PYRAMID3
+		{ glm::vec3(-1.0f, -1.0f, -1.0f), glm::vec3(1.0f, 1.0f, 1.0f) }
+	};
+
+	m_meshBounds.resize(MESH_COUNT);
+	for (int i = 0; i < MESH_COUNT; i++)
+	{
+		m_meshBounds[i].min = extents[i][0] - glm::vec3(g_MeshBoundsPadding);
+		m_meshBounds[i].max = extents[i][1] + glm::vec3(g_MeshBoundsPadding);
+	}
+}
+
+/***********************************************************
+ *  BeginObjectGroup()
+ *
+ *  This method is used for starting the named group that the
+ *  objects added next belong to.  Objects are only batched
+ *  with objects of the same group, so every group can be
+ *  measured on its own when the scene is rendered.  The
+ *  name must stay valid while the scene is rendered.
+ ***********************************************************/
+void SceneManager::BeginObjectGroup(const char* group)
+{
+	for (int i = 0; i < m_objectGroups.size(); i++)
+	{
+		if (strcmp(m_objectGroups[i], group) == 0)
+		{
+			m_currentGroup = i;
+			return;
+		}
+	}
+
+	m_currentGroup = m_objectGroups.size();
+	m_objectGroups.push_back(group);
+}
+
+/***********************************************************
+ *  BeginObjectNode()
+ *
+ *  This method is used for starting a transform node below
+ *  the node that is open, and placing the objects added next
+ *  relative to it, so a compound prop can be moved as one.
+ *  The transformation values are the same as for an object.
+ *  The index of the new node is returned.
+ ***********************************************************/
+int SceneManager::BeginObjectNode(
+	glm::vec3 scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	glm::vec3 positionXYZ)
+{
+	int nodeIndex = m_transformHierarchy.AddNode(
+		m_openNodes.empty() ? -1 : m_openNodes.back(),
+		BuildModelMatrix(
+			scaleXYZ,
+			XrotationDegrees,
+			YrotationDegrees,
+			ZrotationDegrees,
+			positionXYZ));
+
+	m_openNodes.push_back(nodeIndex);
+
+	return(nodeIndex);
+}
+
+/***********************************************************
+ *  EndObjectNode()
+ *
+ *  This method is used for ending the transform node that
+ *  was started last, so the objects added next are placed
+ *  relative to the node that was open before it.
+ ***********************************************************/
+void SceneManager::EndObjectNode()
+{
+	if (!m_openNodes.empty())
+	{
+		m_openNodes.pop_back();
+	}
+}
+
+/***********************************************************
+ *  AddObjectNode()
+ *
+ *  This method is used for adding the transform node of the
+ *  scene object that is added next, below the passed in
+ *  parent node or as a root node for -1.  The world matrix
+ *  of the object is returned.
+ ***********************************************************/
+glm::mat4 SceneManager::AddObjectNode(const glm::mat4& local, int parentNode)
+{
+	int nodeIndex = m_transformHierarchy.AddNode(parentNode, local, m_sceneObjects.size());
+
+	m_objectNodes.push_back(nodeIndex);
+
+	return(m_transformHierarchy.GetNode(nodeIndex).world);
+}
+
+/***********************************************************
+ *  DrawMesh()
+ *
+ *  This method is used for drawing the basic mesh of the
+ *  passed in type, or an imported mesh, which is only found
+ *  in the shared mesh buffer.
+ ***********************************************************/
+void SceneManager::DrawMesh(int mesh)
+{
+	m_renderStatistics.drawCalls++;
+
+	switch (mesh)
+	{
+	case MESH_PLANE:
+		m_basicMeshes->DrawPlaneMesh();
+		break;
+	case MESH_CONE:
+		m_basicMeshes->DrawConeMesh();
+		break;
+	case MESH_CYLINDER:
+		m_basicMeshes->DrawCylinderMesh();
+		break;
+	case MESH_PRISM:
+		m_basicMeshes->DrawPrismMesh();
+		break;
+	case MESH_TORUS:
+		m_basicMeshes->DrawTorusMesh();
+		break;
+	case MESH_SPHERE:
+		m_basicMeshes->DrawSphereMesh();
+		break;
+	case MESH_HALF_SPHERE:
+		m_basicMeshes->DrawHalfSphereMesh();
+		break;
+	case MESH_TAPERED_CYLINDER:
+		m_basicMeshes->DrawTaperedCylinderMesh();
+		break;
+	case MESH_PYRAMID3:
+		m_basicMeshes->DrawPyramid3Mesh();
+		break;
+	default:
+		if (m_meshBuffer.HasMesh(mesh))
+		{
+			m_meshBuffer.DrawMesh(mesh);
+		}
+		break;
+	}
+}
+
+/***********************************************************
+ *  SetShaderMaterial()
+ *
+ *  This method is used for passing the values of the
+ *  material at the passed in index into the shader.
+ ***********************************************************/
+void SceneManager::SetShaderMaterial(int materialIndex)
+{
+	if ((materialIndex >= 0) && (materialIndex < m_objectMaterials.size()))
+	{
+		const OBJECT_MATERIAL& material = m_objectMaterials[materialIndex];
+		m_renderStatistics.materialChanges++;
+		m_pUniformCache->setVec3Value(UniformCache::UNIFORM_MATERIAL_DIFFUSE_COLOR, material.diffuseColor);
+		m_pUniformCache->setVec3Value(UniformCache::UNIFORM_MATERIAL_SPECULAR_COLOR, material.specularColor);
+		m_pUniformCache->setFloatValue(UniformCache::UNIFORM_MATERIAL_SHININESS, material.shininess);
+	}
+}
+
+/***********************************************************
+ *  BuildInstanceBatches()
+ *
+ *  This method is used for grouping the retained draw list
+ *  into instance batches.  Objects of the same group that use
+ *  the same mesh and the same texture or color are collected
+ *  into one batch, and their model matrix, UV scale and material are
+ *  packed contiguously into the per-instance data array.
+ ***********************************************************/
+void SceneManager::BuildInstanceBatches()
+{
+	// the objects belonging to each batch, in draw list order
+	std::vector<std::vector<int>> batchObjects;
+
+	m_instanceBatches.clear();
+	m_instanceData.clear();
+	m_instanceBounds.clear();
+	m_instanceBatchIndices.clear();
+	m_instanceObjectIndices.clear();
+	m_objectInstanceIndices.assign(m_sceneObjects.size(), -1);
+	// the instances of a streamed scene are hidden until their cell is loaded
+	m_instanceResident.assign(m_sceneObjects.size(), !m_bStreaming);
+	m_instanceDynamic.assign(m_sceneObjects.size(), false);
+	m_instanceMoved.assign(m_sceneObjects.size(), false);
+	m_movedInstances.clear();
+	m_dynamicInstanceCount = 0;
+
+	for (int i = 0; i < m_sceneObjects.size(); i++)
+	{
+		const SCENE_OBJECT& object = m_sceneObjects[i];
+		int batchIndex = -1;
+		int index = 0;
+
+		// find a batch with the same mesh and the same texture or color
+		while ((index < m_instanceBatches.size()) && (batchIndex < 0))
+		{
+			const INSTANCE_BATCH& batch = m_instanceBatches[index];
+			if ((batch.group == object.group) &&
+				(batch.mesh == object.mesh) &&
+				(batch.textureSlot == object.textureSlot) &&
+				((object.textureSlot >= 0) || (batch.color == object.color)))
+			{
+				batchIndex = index;
+			}
+			else
+				index++;
+		}
+
+		if (batchIndex < 0)
+		{
+			INSTANCE_BATCH batch;
+			batch.mesh = object.mesh;
+			batch.textureSlot = object.textureSlot;
+			batch.color = object.color;
+			batch.group = object.group;
+			batch.bTransparent = (object.textureSlot < 0) && (object.color.a < 1.0f);
+			batch.firstInstance = 0;
+			batch.instanceCount = 0;
+
+			batchIndex = m_instanceBatches.size();
+			m_instanceBatches.push_back(batch);
+			batchObjects.push_back(std::vector<int>());
+		}
+
+		batchObjects[batchIndex].push_back(i);
+	}
+
+	// pack the instances of every batch next to each other
+	for (int i = 0; i < m_instanceBatches.size(); i++)
+	{
+		m_instanceBatches[i].firstInstance = m_instanceData.size();
+		m_instanceBatches[i].instanceCount = batchObjects[i].size();
+
+		for (int j = 0; j < batchObjects[i].size(); j++)
+		{
+			int objectIndex = batchObjects[i][j];
+			const SCENE_OBJECT& object = m_sceneObjects[objectIndex];
+			INSTANCE_DATA instance;
+
+			instance.model = object.model;
+			instance.uvScale = object.uvScale;
+			instance.materialIndex = object.materialIndex;
+			instance.padding = 0;
+
+			m_instanceData.push_back(instance);
+			m_instanceBounds.push_back(Frustum::TransformBox(m_meshBounds[object.mesh], object.model));
+			m_instanceBatchIndices.push_back(i);
+			m_instanceObjectIndices.push_back(objectIndex);
+			m_objectInstanceIndices[objectIndex] = m_instanceData.size() - 1;
+		}
+	}
+
+	// index the instance bounds for the culling and picking queries
+	m_sceneBVH.Build(m_instanceBounds);
+	m_bBoundsDirty = false;
+}
+
+/***********************************************************
+ *  SetBatchColor()
+ *
+ *  This method is used for setting the solid color of an
+ *  untextured batch into the shader.  Texturing is only
+ *  turned off and the color only set when they change.
+ ***********************************************************/
+void SceneManager::SetBatchColor(const glm::vec4& color)
+{
+	if (m_renderState.bUseTexture != 0)
+	{
+		m_pUniformCache->setIntValue(UniformCache::UNIFORM_USE_TEXTURE, false);
+		m_renderState.bUseTexture = 0;
+		m_renderState.textureSlot = -1;
+	}
+
+	if (m_renderState.color != color)
+	{
+		m_pUniformCache->setVec4Value(UniformCache::UNIFORM_OBJECT_COLOR, color);
+		m_renderState.color = color;
+	}
+}
+
+/***********************************************************
+ *  ResetRenderState()
+ *
+ *  This method is used for forgetting the shader values set
+ *  while rendering the previous frame, so the first draw of
+ *  the frame sets all of its values again.
+ ***********************************************************/
+void SceneManager::ResetRenderState()
+{
+	m_renderState.textureSlot = -1;
+	m_renderState.bUseTexture = -1;
+	m_renderState.textureUnit = -1;
+	m_renderState.arrayUnit = -1;
+	m_renderState.textureLayer = -1;
+	m_renderState.color = glm::vec4(-1.0f);
+	m_renderState.materialIndex = -1;
+	m_renderState.uvScale = glm::vec2(-1.0f);
+	m_renderState.bUseInstanceBuffer = -1;
+	m_renderState.bUseDrawBlock = -1;
+	// no draw is ever dithered with this fade
+	m_renderState.lodFade = -2.0f;
+}
+
+/***********************************************************
+ *  GetScreenRadius()
+ *
+ *  This method is used for getting the radius in pixels that
+ *  an instance covers on screen.  The bounding sphere around
+ *  the instance bounds is projected with the vertical scale
+ *  of the projection, which comes from the camera zoom for
+ *  the perspective view, divided by the view depth.  The
+ *  orthographic view does not shrink objects with distance.
+ *  The projection is the one of the view the command list
+ *  is prepared for.
+ ***********************************************************/
+float SceneManager::GetScreenRadius(const SCENE_VIEW& sceneView, int instanceIndex, float viewDepth) const
+{
+	const Frustum::BOUNDING_BOX& bounds = m_instanceBounds[instanceIndex];
+	float radius = glm::length(bounds.max - bounds.min) * 0.5f;
+	float pixelScale = sceneView.projection[1][1] * sceneView.viewportHeight * 0.5f;
+
+	// a perspective projection has no translation in w
+	if (sceneView.projection[3][3] != 0.0f)
+	{
+		return(radius * pixelScale);
+	}
+
+	// the camera is inside or right next to the object
+	if (viewDepth <= radius)
+	{
+		return(FLT_MAX);
+	}
+
+	return((radius * pixelScale) / viewDepth);
+}
+
+/***********************************************************
+ *  SelectLod()
+ *
+ *  This method is used for picking the level of detail that
+ *  a mesh is drawn with at the passed in screen radius.  The
+ *  next coarser level is drawn below the radius of a level,
+ *  and around that radius is a band where the two levels are
+ *  crossfaded, the blend growing from 0 at the top of the
+ *  band to 1 at its bottom.  When the shader can not dither
+ *  the levels, there is no band and they switch at once.
+ ***********************************************************/
+void SceneManager::SelectLod(int mesh, float screenRadius, int& lod, float& blend) const
+{
+	float fadeBand = m_bLodFadeSupported ? g_LodFadeBand : 0.0f;
+
+	lod = 0;
+	blend = 0.0f;
+
+	for (int level = 0; level + 1 < m_meshBuffer.GetLodCount(mesh); level++)
+	{
+		float upper = g_LodScreenRadii[level] * (1.0f + fadeBand);
+		float lower = g_LodScreenRadii[level] * (1.0f - fadeBand);
+
+		if (screenRadius >= upper)
+		{
+			break;
+		}
+		if (screenRadius > lower)
+		{
+			blend = (upper - screenRadius) / (upper - lower);
+			break;
+		}
+
+		lod = level + 1;
+	}
+}
+
+/***********************************************************
+ *  GetLodFadeSource()
+ *
+ *  This method is used for getting the fragment shader code
+ *  of the crossfade dither, which declares the lodFade
+ *  uniform and IsLodFadeDiscarded().  The shader passes it
+ *  the lodFade of the instance, of the draw record or of the
+ *  uniform, whichever it reads its values from, and discards
+ *  the fragment when it returns true.  The crossfade is only
+ *  used when the shader reads the lodFade uniform.
+ ***********************************************************/
+const char* SceneManager::GetLodFadeSource()
+{
+	return(g_LodFadeShaderSource);
+}
+
+/***********************************************************
+ *  BeginFrameCommands()
+ *
+ *  This method is used for keeping the views of the frame
+ *  and how its instances are culled in a command list, and
+ *  for starting the job that prepares the list.  The list
+ *  only reads the scene while it is prepared, so nothing may
+ *  move or stream in until WaitForFrameCommands() returns.
+ ***********************************************************/
+void SceneManager::BeginFrameCommands(FRAME_COMMANDS& commands)
+{
+	for (int i = 0; i < m_viewCount; i++)
+	{
+		commands.views[i].sceneView = m_sceneViews[i];
+	}
+	commands.viewCount = m_viewCount;
+	commands.bIndirect = IsDrawingIndirect();
+	commands.bInstanced = IsDrawingInstanced();
+	commands.bGpuCulling = IsCullingOnGpu();
+	commands.bProfileGroups = m_bProfileGroups;
+	commands.bPrepared = false;
+
+	m_pJobSystem->Run(commands.jobs, [this, &commands] { PrepareFrameCommands(commands); });
+}
+
+/***********************************************************
+ *  PrepareFrameCommands()
+ *
+ *  This method is used for filling the render queue of
+ *  every view of a command list with a draw packet for each
+ *  of its visible instances and sorting it.  The visible
+ *  instances are split into ranges that are keyed and
+ *  sorted as jobs of their own, and the sorted ranges are
+ *  then merged into the queue, which gives the same order as
+ *  sorting the whole queue at once.
+ *
+ *  Objects whose bounds are outside the view frustum are
+ *  left out of the queue, found through the bounding volume
+ *  hierarchy.  The views are culled together, so the tree
+ *  is walked once for all of them and the parts of the
+ *  scene that several views see are only visited once.  A
+ *  view with the same camera as an earlier one reuses its
+ *  draws.  While the compute shader culls the opaque
+ *  instances, only the few instances it leaves out are
+ *  tested and queued.
+ ***********************************************************/
+void SceneManager::PrepareFrameCommands(FRAME_COMMANDS& commands)
+{
+	// smallest number of instances keyed by one job
+	const int minRangeSize = 256;
+	Frustum frusta[MAX_VIEWS];
+	std::vector<int>* visibleLists[MAX_VIEWS];
+	int cullViews[MAX_VIEWS];
+	int cullCount = 0;
+
+	commands.culledObjects = 0;
+	commands.detailCulledObjects = 0;
+
+	for (int v = 0; v < commands.viewCount; v++)
+	{
+		VIEW_COMMANDS& viewCommands = commands.views[v];
+		const SCENE_VIEW& sceneView = viewCommands.sceneView;
+
+		viewCommands.renderQueue.Clear();
+		viewCommands.visibleInstances.clear();
+		viewCommands.culledObjects = 0;
+		viewCommands.detailCulledObjects = 0;
+
+		// a view that sees the scene the same as an earlier view,
+		// down to the detail culling, draws the same packets
+		viewCommands.sharedView = -1;
+		for (int u = 0; u < v; u++)
+		{
+			const SCENE_VIEW& other = commands.views[u].sceneView;
+			if ((other.view == sceneView.view) &&
+				(other.projection == sceneView.projection) &&
+				(other.viewportHeight == sceneView.viewportHeight))
+			{
+				viewCommands.sharedView = u;
+				break;
+			}
+		}
+
+		if (viewCommands.sharedView < 0)
+		{
+			frusta[cullCount] = sceneView.frustum;
+			visibleLists[cullCount] = &viewCommands.visibleInstances;
+			cullViews[cullCount] = v;
+			cullCount++;
+		}
+	}
+
+	// only the instances inside the view frusta are queued
+	if (commands.bGpuCulling)
+	{
+		// the compute shader culls all but these few instances
+		for (int i = 0; i < m_cpuCullInstances.size(); i++)
+		{
+			int instanceIndex = m_cpuCullInstances[i];
+			for (int c = 0; c < cullCount; c++)
+			{
+				if ((!m_bFrustumCulling) || (frusta[c].IsBoxVisible(m_instanceBounds[instanceIndex])))
+				{
+					visibleLists[c]->push_back(instanceIndex);
+				}
+			}
+		}
+		for (int c = 0; c < cullCount; c++)
+		{
+			commands.views[cullViews[c]].culledObjects = m_cpuCullInstances.size() - visibleLists[c]->size();
+		}
+	}
+	else if (m_bFrustumCulling)
+	{
+		m_sceneBVH.QueryFrusta(frusta, cullCount, visibleLists);
+		for (int c = 0; c < cullCount; c++)
+		{
+			commands.views[cullViews[c]].culledObjects = m_instanceData.size() - visibleLists[c]->size();
+		}
+	}
+	else
+	{
+		for (int c = 0; c < cullCount; c++)
+		{
+			for (int i = 0; i < m_instanceData.size(); i++)
+			{
+				visibleLists[c]->push_back(i);
+			}
+		}
+	}
+
+	// key and sort the ranges of the visible instances of all of
+	// the views across the workers
+	JobSystem::JOB_GROUP rangeJobs;
+	for (int c = 0; c < cullCount; c++)
+	{
+		VIEW_COMMANDS& viewCommands = commands.views[cullViews[c]];
+		int visibleCount = viewCommands.visibleInstances.size();
+		int ranges = std::max((visibleCount + minRangeSize - 1) / minRangeSize, 1);
+
+		ranges = std::min(ranges, m_pJobSystem->GetThreadCount());
+		int rangeSize = (visibleCount + ranges - 1) / ranges;
+
+		viewCommands.rangePackets.resize(ranges);
+		viewCommands.rangeDetailCulled.assign(ranges, 0);
+
+		for (int range = 0; range < ranges; range++)
+		{
+			int first = range * rangeSize;
+			int count = std::max(std::min(rangeSize, visibleCount - first), 0);
+
+			m_pJobSystem->Run(rangeJobs, [this, &commands, &viewCommands, range, first, count] {
+				BuildRangePackets(commands, viewCommands, range, first, count);
+			});
+		}
+	}
+	m_pJobSystem->Wait(rangeJobs);
+
+	for (int v = 0; v < commands.viewCount; v++)
+	{
+		VIEW_COMMANDS& viewCommands = commands.views[v];
+
+		if (viewCommands.sharedView >= 0)
+		{
+			viewCommands.culledObjects = commands.views[viewCommands.sharedView].culledObjects;
+			viewCommands.detailCulledObjects = commands.views[viewCommands.sharedView].detailCulledObjects;
+		}
+		else
+		{
+			for (int range = 0; range < viewCommands.rangePackets.size(); range++)
+			{
+				viewCommands.renderQueue.MergePackets(viewCommands.rangePackets[range]);
+				viewCommands.detailCulledObjects += viewCommands.rangeDetailCulled[range];
+			}
+		}
+
+		commands.culledObjects += viewCommands.culledObjects;
+		commands.detailCulledObjects += viewCommands.detailCulledObjects;
+	}
+
+	commands.bPrepared = true;
+}
+
+/***********************************************************
+ *  BuildRangePackets()
+ *
+ *  This method is used for adding a draw packet for every
+ *  instance of one range of the visible instances of a view
+ *  to the packets of the range, and sorting them.  The sort key
+ *  puts draws with the same texture next to each other, then
+ *  draws with the same material and mesh, and orders the
+ *  draws of the same state front to back.  While the object
+ *  groups are profiled, the group is added to the top of the
+ *  key so each group is drawn in one run.  Objects that
+ *  would cover less than about a pixel on screen are left
+ *  out, and the others are drawn with the level of detail
+ *  their screen radius picks, as two packets while the two
+ *  levels are crossfaded.  Transparent draws are put after all of the opaque
+ *  draws and ordered back to front, so each one blends over
+ *  what is behind it.  When the frame is drawn with indirect
+ *  multi-draws, the texture and material are values of each
+ *  instance, so the key only keeps the array texture and the
+ *  mesh together.  When the batches are drawn instanced, the
+ *  material is a value of each instance as well, so the batch
+ *  takes its place in the key and the visible instances of a
+ *  batch follow each other, to be drawn by one call.
+ ***********************************************************/
+void SceneManager::BuildRangePackets(const FRAME_COMMANDS& commands, VIEW_COMMANDS& viewCommands, int range, int first, int count)
+{
+	const RenderQueue& renderQueue = viewCommands.renderQueue;
+	const SCENE_VIEW& sceneView = viewCommands.sceneView;
+	std::vector<RenderQueue::DRAW_PACKET>& packets = viewCommands.rangePackets[range];
+	int detailCulled = 0;
+
+	packets.clear();
+	for (int i = first; i < first + count; i++)
+	{
+		int instanceIndex = viewCommands.visibleInstances[i];
+		int batchIndex = m_instanceBatchIndices[instanceIndex];
+		const INSTANCE_BATCH& batch = m_instanceBatches[batchIndex];
+		const INSTANCE_DATA& instance = m_instanceData[instanceIndex];
+		RenderQueue::DRAW_PACKET packet;
+
+		// skip the objects of the cells that are not streamed in
+		if (!m_instanceResident[instanceIndex])
+		{
+			continue;
+		}
+
+		// distance in front of the camera along the view direction
+		float viewDepth = -(sceneView.view * instance.model[3]).z;
+		int lod = 0;
+		float lodBlend = 0.0f;
+
+		// skip the objects too small on screen to add any detail,
+		// and pick the level of detail of the others
+		if ((sceneView.viewportHeight > 0) &&
+			((m_minScreenRadius > 0.0f) || (m_meshBuffer.GetLodCount(batch.mesh) > 1)))
+		{
+			float screenRadius = GetScreenRadius(sceneView, instanceIndex, viewDepth);
+
+			if (screenRadius < m_minScreenRadius)
+			{
+				detailCulled++;
+				continue;
+			}
+
+			SelectLod(batch.mesh, screenRadius, lod, lodBlend);
+		}
+
+		// inside the crossfade band of a level the next level is
+		// queued as well, and dithered into the pixels the level
+		// fading out leaves
+		int lastLod = (lodBlend > 0.0f) ? lod + 1 : lod;
+		// every draw of the scene uses the one scene shader program
+		int program = 0;
+		for (int level = lod; level <= lastLod; level++)
+		{
+			int lodMesh = m_meshBuffer.GetLodMesh(batch.mesh, level);
+
+			if (batch.bTransparent)
+			{
+				packet.sortKey = renderQueue.MakeBackToFrontKey(
+					RenderQueue::RENDER_PASS_TRANSPARENT,
+					viewDepth);
+			}
+			else if (commands.bIndirect)
+			{
+				int arrayIndex = GetIndirectArrayIndex(batch);
+
+				// the batches that can not be drawn indirectly are
+				// kept apart from the array textures
+				if (arrayIndex < -1)
+				{
+					arrayIndex = m_textureArrays.size() + batch.textureSlot;
+				}
+
+				packet.sortKey = renderQueue.MakeSortKey(
+					RenderQueue::RENDER_PASS_OPAQUE,
+					0,
+					program,
+					arrayIndex,
+					-1,
+					lodMesh,
+					viewDepth);
+			}
+			else if ((commands.bInstanced) && (GetIndirectArrayIndex(batch) >= -1))
+			{
+				packet.sortKey = renderQueue.MakeSortKey(
+					RenderQueue::RENDER_PASS_OPAQUE,
+					commands.bProfileGroups ? batch.group : 0,
+					program,
+					batch.textureSlot,
+					batchIndex,
+					lodMesh,
+					viewDepth);
+			}
+			else
+			{
+				packet.sortKey = renderQueue.MakeSortKey(
+					RenderQueue::RENDER_PASS_OPAQUE,
+					commands.bProfileGroups ? batch.group : 0,
+					program,
+					batch.textureSlot,
+					instance.materialIndex,
+					lodMesh,
+					viewDepth);
+			}
+
+			packet.batchIndex = batchIndex;
+			packet.instanceIndex = instanceIndex;
+			packet.lod = level;
+			packet.lodFade = (level == lod) ? -lodBlend : lodBlend;
+			packets.push_back(packet);
+		}
+	}
+
+	RenderQueue::SortPackets(packets);
+	viewCommands.rangeDetailCulled[range] = detailCulled;
+}
+
+/***********************************************************
+ *  WaitForFrameCommands()
+ *
+ *  This method is used for waiting until a command list is
+ *  prepared, running its jobs on the context thread as well
+ *  when the workers have not taken them yet.
+ ***********************************************************/
+void SceneManager::WaitForFrameCommands(FRAME_COMMANDS& commands)
+{
+	if (commands.jobs.pending == 0)
+	{
+		return;
+	}
+
+	int scope = -1;
+	if (NULL != m_pFrameProfiler)
+	{
+		scope = m_pFrameProfiler->BeginScope("WaitForCommands");
+	}
+
+	m_pJobSystem->Wait(commands.jobs);
+
+	if (NULL != m_pFrameProfiler)
+	{
+		m_pFrameProfiler->EndScope(scope);
+	}
+}
+
+/***********************************************************
+ *  SetFrameCameras()
+ *
+ *  This method is used for setting the cameras of the views
+ *  a command list was prepared with into the slots of the
+ *  camera block, so a list prepared during the last frame
+ *  is drawn the same as it was culled.
+ ***********************************************************/
+void SceneManager::SetFrameCameras(const FRAME_COMMANDS& commands)
+{
+	for (int i = 0; i < commands.viewCount; i++)
+	{
+		const SCENE_VIEW& sceneView = commands.views[i].sceneView;
+		UniformCache::CAMERA_BLOCK camera;
+
+		camera.view = sceneView.view;
+		camera.projection = sceneView.projection;
+		camera.viewPosition = glm::vec4(sceneView.viewPosition, 1.0f);
+		m_pUniformCache->SetCameraData(camera, i);
+	}
+}
+
+/***********************************************************
+ *  SetFrameView()
+ *
+ *  This method is used for making a view a command list was
+ *  prepared with the view being rendered, for the lights,
+ *  shadows and culling of the context thread, and for
+ *  picking the render queue that is submitted for it.
+ ***********************************************************/
+void SceneManager::SetFrameView(const FRAME_COMMANDS& commands, int viewIndex)
+{
+	const VIEW_COMMANDS& viewCommands = commands.views[viewIndex];
+
+	m_frameView = viewCommands.sceneView;
+	m_submitView = (viewCommands.sharedView >= 0) ? viewCommands.sharedView : viewIndex;
+}
+
+/***********************************************************
+ *  SubmitRenderQueue()
+ *
+ *  This method is used for drawing the sorted packets of the
+ *  render queue, with the pass and object group scopes around
+ *  them.  When the shader reads the values of each draw from
+ *  the instance buffer, the packets of a batch that follow
+ *  each other are drawn as the instances of one call from
+ *  the shared mesh buffer, and their instances are uploaded
+ *  at once before the first draw.  The other packets are
+ *  drawn one by one, each from the buffers of its own mesh.
+ ***********************************************************/
+void SceneManager::SubmitRenderQueue()
+{
+	const RenderQueue& renderQueue = m_frameCommands[m_submitFrame].views[m_submitView].renderQueue;
+	bool bInstanced = IsDrawingInstanced();
+	int currentBatch = -1;
+	int currentGroup = -1;
+	int currentPass = -1;
+	int groupScope = -1;
+	int passScope = -1;
+	int drawInstance = 0;
+
+	// the instances of the batches that are drawn instanced, in draw order
+	m_drawInstances.clear();
+	if (bInstanced)
+	{
+		for (int i = 0; i < renderQueue.GetPacketCount(); i++)
+		{
+			const RenderQueue::DRAW_PACKET& packet = renderQueue.GetPacket(i);
+
+			if (GetIndirectArrayIndex(m_instanceBatches[packet.batchIndex]) >= -1)
+			{
+				m_drawInstances.push_back(GetGpuInstance(packet.instanceIndex));
+				m_drawInstances.back().lodFade = packet.lodFade;
+			}
+		}
+		UploadDrawInstances();
+	}
+
+	for (int i = 0; i < renderQueue.GetPacketCount(); i++)
+	{
+		const RenderQueue::DRAW_PACKET& packet = renderQueue.GetPacket(i);
+		const INSTANCE_BATCH& batch = m_instanceBatches[packet.batchIndex];
+		int pass = batch.bTransparent ? RenderQueue::RENDER_PASS_TRANSPARENT : RenderQueue::RENDER_PASS_OPAQUE;
+
+		// the packets of a pass are next to each other, so the
+		// pass state is only set when the pass changes
+		if (pass != currentPass)
+		{
+			if (NULL != m_pFrameProfiler)
+			{
+				m_pFrameProfiler->EndScope(groupScope);
+				m_pFrameProfiler->EndScope(passScope);
+				passScope = m_pFrameProfiler->BeginScope(
+					(pass == RenderQueue::RENDER_PASS_TRANSPARENT) ? "Transparent" : "Opaque");
+				groupScope = -1;
+			}
+
+			SetRenderPassState(pass);
+			currentPass = pass;
+			currentGroup = -1;
+		}
+
+		// the draws of a group are next to each other while the
+		// groups are profiled, so a new scope is only started
+		// when the group changes
+		if ((m_bProfileGroups) && (NULL != m_pFrameProfiler) && (batch.group != currentGroup))
+		{
+			m_pFrameProfiler->EndScope(groupScope);
+			groupScope = m_pFrameProfiler->BeginScope(m_objectGroups[batch.group]);
+			currentGroup = batch.group;
+		}
+
+		if (packet.batchIndex != currentBatch)
+		{
+			m_renderStatistics.batches++;
+			currentBatch = packet.batchIndex;
+		}
+
+		int arrayIndex = bInstanced ? GetIndirectArrayIndex(batch) : -2;
+		if (arrayIndex < -1)
+		{
+			DrawPacket(packet);
+			continue;
+		}
+
+		// the packets of a batch share the pass and the group, so a
+		// run of them with the same level of detail is drawn by one call
+		int runEnd = i + 1;
+		while ((runEnd < renderQueue.GetPacketCount()) &&
+			(renderQueue.GetPacket(runEnd).batchIndex == packet.batchIndex) &&
+			(renderQueue.GetPacket(runEnd).lod == packet.lod))
+		{
+			runEnd++;
+		}
+
+		DrawInstances(m_meshBuffer.GetLodMesh(batch.mesh, packet.lod), arrayIndex, drawInstance, runEnd - i);
+		drawInstance += runEnd - i;
+		i = runEnd - 1;
+	}
+
+	if (NULL != m_pFrameProfiler)
+	{
+		m_pFrameProfiler->EndScope(groupScope);
+		m_pFrameProfiler->EndScope(passScope);
+	}
+
+	if (bInstanced)
+	{
+		glBindVertexArray(0);
+	}
+
+	// restore the blending and depth writes set up with the window,
+	// the depth buffer can not be cleared while depth writes are off
+	glEnable(GL_BLEND);
+	glDepthMask(GL_TRUE);
+}
+
+/***********************************************************
+ *  DrawPacket()
+ *
+ *  This method is used for drawing one sorted packet from
+ *  the mesh's own buffers.  Only the model matrix is set for
+ *  every draw, all the other values are only set into the
+ *  shader when they differ from the values of the previous
+ *  draw.
+ ***********************************************************/
+void SceneManager::DrawPacket(const RenderQueue::DRAW_PACKET& packet)
+{
+	const INSTANCE_BATCH& batch = m_instanceBatches[packet.batchIndex];
+	const INSTANCE_DATA& instance = m_instanceData[packet.instanceIndex];
+
+	SetInstanceBufferMode(false);
+
+	if (batch.textureSlot >= 0)
+	{
+		SetShaderTexture(batch.textureSlot);
+	}
+	else
+	{
+		SetBatchColor(batch.color);
+	}
+
+	// the uniforms are only set when the values can not go into a draw record
+	if (!BindDrawRecord(instance, packet.lodFade))
+	{
+		SetDrawBlockMode(false);
+		SetLodFade(packet.lodFade);
+
+		if ((batch.textureSlot >= 0) && (instance.uvScale != m_renderState.uvScale))
+		{
+			m_pUniformCache->setVec2Value(UniformCache::UNIFORM_UV_SCALE, instance.uvScale);
+			m_renderState.uvScale = instance.uvScale;
+		}
+
+		if ((instance.materialIndex >= 0) && (instance.materialIndex != m_renderState.materialIndex))
+		{
+			SetShaderMaterial(instance.materialIndex);
+			m_renderState.materialIndex = instance.materialIndex;
+		}
+
+		m_pUniformCache->setMat4Value(UniformCache::UNIFORM_MODEL, instance.model);
+	}
+
+	// the coarser levels are only found in the shared buffers
+	DrawMesh(m_meshBuffer.GetLodMesh(batch.mesh, packet.lod));
+}
+
+/***********************************************************
+ *  SetInstanceBufferMode()
+ *
+ *  This method is used for switching the shader between
+ *  reading the values of each draw from the instance buffer
+ *  and reading them from the uniforms.
+ ***********************************************************/
+void SceneManager::SetInstanceBufferMode(bool bUseInstanceBuffer)
+{
+	if ((m_pUniformCache->HasUniform(UniformCache::UNIFORM_USE_INSTANCE_BUFFER)) &&
+		(m_renderState.bUseInstanceBuffer != (int)bUseInstanceBuffer))
+	{
+		m_pUniformCache->setBoolValue(UniformCache::UNIFORM_USE_INSTANCE_BUFFER, bUseInstanceBuffer);
+		m_renderState.bUseInstanceBuffer = bUseInstanceBuffer;
+	}
+
+	// the instances carry their own values, the draw records are not read
+	if (bUseInstanceBuffer)
+	{
+		SetDrawBlockMode(false);
+	}
+}
+
+/***********************************************************
+ *  SetDrawBlockMode()
+ *
+ *  This method is used for switching the shader between
+ *  reading the model matrix, UV scale and material of a
+ *  draw from the bound draw record and reading them from
+ *  the uniforms.
+ ***********************************************************/
+void SceneManager::SetDrawBlockMode(bool bUseDrawBlock)
+{
+	if ((m_bDrawBlockSupported) &&
+		(m_renderState.bUseDrawBlock != (int)bUseDrawBlock))
+	{
+		m_pUniformCache->setBoolValue(UniformCache::UNIFORM_USE_DRAW_BLOCK, bUseDrawBlock);
+		m_renderState.bUseDrawBlock = bUseDrawBlock;
+	}
+}
+
+/***********************************************************
+ *  SetLodFade()
+ *
+ *  This method is used for setting the crossfade dither of
+ *  the next draw into the lodFade uniform, when the shader
+ *  reads it and it differs from the previous draw.
+ ***********************************************************/
+void SceneManager::SetLodFade(float lodFade)
+{
+	if ((m_bLodFadeSupported) && (m_renderState.lodFade != lodFade))
+	{
+		m_pUniformCache->setFloatValue(UniformCache::UNIFORM_LOD_FADE, lodFade);
+		m_renderState.lodFade = lodFade;
+	}
+}
+
+/***********************************************************
+ *  BindDrawRecord()
+ *
+ *  This method is used for writing the model matrix, UV
+ *  scale, crossfade dither and material of a draw into a
+ *  record allocated from the frame's region of the dynamic
+ *  buffer, and binding the record to the DrawBlock by its
+ *  offset.  One range bind replaces the separate uniform
+ *  calls of every value.  A draw without a material leaves
+ *  the shader on the material uniforms.  False is returned
+ *  when the shader has no DrawBlock or the region is full,
+ *  and the values have to be set as uniforms instead.
+ ***********************************************************/
+bool SceneManager::BindDrawRecord(const INSTANCE_DATA& instance, float lodFade)
+{
+	GPU_DRAW_RECORD* pRecord = NULL;
+	GLintptr recordOffset = 0;
+
+	if (!m_bDrawBlockSupported)
+	{
+		return(false);
+	}
+
+	pRecord = (GPU_DRAW_RECORD*)m_dynamicBuffer.Allocate(
+		sizeof(GPU_DRAW_RECORD), m_dynamicBuffer.GetBindingAlignment(), recordOffset);
+	if (NULL == pRecord)
+	{
+		return(false);
+	}
+
+	pRecord->model = instance.model;
+	pRecord->uvScale = instance.uvScale;
+	pRecord->bUseMaterial = 0;
+	pRecord->lodFade = lodFade;
+	if ((instance.materialIndex >= 0) && (instance.materialIndex < m_objectMaterials.size()))
+	{
+		const OBJECT_MATERIAL& material = m_objectMaterials[instance.materialIndex];
+
+		pRecord->diffuseColor = glm::vec4(material.diffuseColor, 1.0f);
+		pRecord->specularColor = glm::vec4(material.specularColor, material.shininess);
+		pRecord->bUseMaterial = 1;
+	}
+
+	SetDrawBlockMode(true);
+	glBindBufferRange(GL_UNIFORM_BUFFER, DRAW_BLOCK_BINDING, m_dynamicBuffer.GetBuffer(), recordOffset, sizeof(GPU_DRAW_RECORD));
+
+	return(true);
+}
+
+/***********************************************************
+ *  FindDrawBlock()
+ *
+ *  This method is used for checking whether the draws drawn
+ *  one by one can bind their values as draw records, which
+ *  needs the persistently mapped dynamic buffer and a shader
+ *  that declares the DrawBlock uniform block and the switch
+ *  between it and the uniforms.  The block is attached to
+ *  its binding point when it is found.
+ ***********************************************************/
+bool SceneManager::FindDrawBlock()
+{
+	return((m_dynamicBuffer.IsReady()) &&
+		(m_pUniformCache->HasUniform(UniformCache::UNIFORM_USE_DRAW_BLOCK)) &&
+		(m_pUniformCache->BindUniformBlock("DrawBlock", DRAW_BLOCK_BINDING)));
+}
+
+/***********************************************************
+ *  GetGpuInstance()
+ *
+ *  This method is used for getting the values of an instance
+ *  the way the instance buffer holds them, with the color
+ *  and texture layer of its batch.
+ ***********************************************************/
+SceneManager::GPU_INSTANCE SceneManager::GetGpuInstance(int instanceIndex) const
+{
+	const INSTANCE_BATCH& batch = m_instanceBatches[m_instanceBatchIndices[instanceIndex]];
+	const INSTANCE_DATA& instance = m_instanceData[instanceIndex];
+	GPU_INSTANCE gpuInstance;
+
+	gpuInstance.model = instance.model;
+	gpuInstance.color = batch.color;
+	gpuInstance.uvScale = instance.uvScale;
+	gpuInstance.materialIndex = instance.materialIndex;
+	gpuInstance.textureLayer = (batch.textureSlot >= 0) ? m_textureIDs[batch.textureSlot].layer : -1;
+	gpuInstance.lodFade = 0.0f;
+	gpuInstance.padding[0] = 0;
+	gpuInstance.padding[1] = 0;
+	gpuInstance.padding[2] = 0;
+
+	return(gpuInstance);
+}
+
+/***********************************************************
+ *  UploadDrawInstances()
+ *
+ *  This method is used for writing the instances of the
+ *  frame's draws into the dynamic buffer and binding them by
+ *  their offset, or uploading them into the instance buffer
+ *  when the dynamic buffer is full or unsupported.
+ ***********************************************************/
+void SceneManager::UploadDrawInstances()
+{
+	GLsizeiptr instanceSize = m_drawInstances.size() * sizeof(GPU_INSTANCE);
+	GLintptr instanceOffset = 0;
+
+	if (m_drawInstances.empty())
+	{
+		return;
+	}
+
+	if (m_dynamicBuffer.Upload(m_drawInstances.data(), instanceSize, m_dynamicBuffer.GetBindingAlignment(), instanceOffset))
+	{
+		glBindBufferRange(GL_SHADER_STORAGE_BUFFER, INSTANCE_BLOCK_BINDING, m_dynamicBuffer.GetBuffer(), instanceOffset, instanceSize);
+	}
+	else
+	{
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_instanceBuffer);
+		glBufferData(GL_SHADER_STORAGE_BUFFER, instanceSize, m_drawInstances.data(), GL_STREAM_DRAW);
+		glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+		glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_BLOCK_BINDING, m_instanceBuffer);
+	}
+}
+
+/***********************************************************
+ *  SetArrayTexture()
+ *
+ *  This method is used for pointing the array texture
+ *  sampler at the unit of the passed in array texture, only
+ *  when it is not pointed there already.
+ ***********************************************************/
+void SceneManager::SetArrayTexture(int arrayIndex)
+{
+	int unit = m_textureArrays[arrayIndex].unit;
+
+	if (m_renderState.arrayUnit != unit)
+	{
+		m_renderStatistics.textureChanges++;
+		m_pUniformCache->setSampler2DValue(UniformCache::UNIFORM_OBJECT_TEXTURE_ARRAY, unit);
+		m_renderState.arrayUnit = unit;
+	}
+}
+
+/***********************************************************
+ *  DrawInstances()
+ *
+ *  This method is used for drawing a run of instances of one
+ *  batch, found next to each other in the instance buffer,
+ *  with one instanced call of the passed in mesh from the
+ *  shared mesh buffer, which is the level of detail of the
+ *  run.  The shader reads the model matrix, UV scale,
+ *  material, color, texture layer and crossfade dither of
+ *  every instance from the buffer.
+ ***********************************************************/
+void SceneManager::DrawInstances(int mesh, int arrayIndex, int firstInstance, int instanceCount)
+{
+	SetInstanceBufferMode(true);
+
+	if (arrayIndex >= 0)
+	{
+		SetArrayTexture(arrayIndex);
+	}
+
+	m_meshBuffer.Bind();
+	m_meshBuffer.DrawInstances(mesh, instanceCount, firstInstance);
+	m_renderStatistics.drawCalls++;
+}
+
+/***********************************************************
+ *  BuildMeshBuffer()
+ *
+ *  This method is used for capturing every loaded basic mesh
+ *  into the shared mesh buffer, by drawing each of them once
+ *  while the capture is running.  The imported meshes are
+ *  added after them, in the order of their mesh indices.
+ ***********************************************************/
+void SceneManager::BuildMeshBuffer()
+{
+	if (!m_meshBuffer.BeginCapture(MESH_COUNT))
+	{
+		return;
+	}
+
+	for (int i = 0; i < MESH_COUNT; i++)
+	{
+		m_meshBuffer.BeginMesh(i);
+		DrawMesh(i);
+		m_meshBuffer.EndMesh(i);
+	}
+	for (int i = 0; i < m_meshFiles.size(); i++)
+	{
+		m_meshBuffer.AddMeshFile(m_meshFiles[i]);
+	}
+
+	m_meshBuffer.EndCapture();
+	m_renderStatistics = RENDER_STATISTICS();
+}
+
+/***********************************************************
+ *  CloseMeshFiles()
+ *
+ *  This method is used for unmapping the mesh files of the
+ *  imported meshes, once they are in the shared mesh buffer.
+ ***********************************************************/
+void SceneManager::CloseMeshFiles()
+{
+	for (int i = 0; i < m_meshFiles.size(); i++)
+	{
+		delete m_meshFiles[i];
+	}
+	m_meshFiles.clear();
+}
+
+/***********************************************************
+ *  CreateIndirectBuffers()
+ *
+ *  This method is used for creating the storage buffers and
+ *  the command buffer of the indirect draws.  The frame is
+ *  only drawn indirectly when the driver supports it, the
+ *  meshes were packed into the shared mesh buffer, and the
+ *  shader can read the values of each draw from the instance
+ *  and material storage blocks.  The shader indexes the
+ *  instances with gl_BaseInstance + gl_InstanceID.
+ ***********************************************************/
+void SceneManager::CreateIndirectBuffers()
+{
+	std::vector<GPU_MATERIAL> materials;
+
+	m_bIndirectSupported = false;
+
+	if ((!GLEW_ARB_shader_storage_buffer_object) ||
+		(!m_meshBuffer.IsReady()) ||
+		(!m_pUniformCache->HasUniform(UniformCache::UNIFORM_USE_INSTANCE_BUFFER)) ||
+		(!m_pUniformCache->BindStorageBlock("InstanceBlock", INSTANCE_BLOCK_BINDING)) ||
+		(!m_pUniformCache->BindStorageBlock("MaterialBlock", MATERIAL_BLOCK_BINDING)))
+	{
+		return;
+	}
+
+	for (int i = 0; i < m_objectMaterials.size(); i++)
+	{
+		const OBJECT_MATERIAL& material = m_objectMaterials[i];
+		GPU_MATERIAL gpuMaterial;
+
+		gpuMaterial.diffuseColor = glm::vec4(material.diffuseColor, 1.0f);
+		gpuMaterial.specularColor = glm::vec4(material.specularColor, material.shininess);
+		materials.push_back(gpuMaterial);
+	}
+	// the storage buffer can not be empty
+	if (materials.empty())
+	{
+		materials.push_back(GPU_MATERIAL());
+	}
+
+	glGenBuffers(1, &m_materialBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_materialBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, materials.size() * sizeof(GPU_MATERIAL), materials.data(), GL_STATIC_DRAW);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, MATERIAL_BLOCK_BINDING, m_materialBuffer);
+
+	glGenBuffers(1, &m_instanceBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, m_instanceBuffer);
+	glBufferData(GL_SHADER_STORAGE_BUFFER, sizeof(GPU_INSTANCE), NULL, GL_STREAM_DRAW);
+	glBindBufferBase(GL_SHADER_STORAGE_BUFFER, INSTANCE_BLOCK_BINDING, m_instanceBuffer);
+	glBindBuffer(GL_SHADER_STORAGE_BUFFER, 0);
+
+	glGenBuffers(1, &m_commandBuffer);
+
+	m_bIndirectSupported = true;
+	std::cout << "Drawing the scene with indirect multi-draws" << std::endl;
+}
+
+/***********************************************************
+ *  DestroyIndirectBuffers()
+ *
+ *  This method is used for freeing the storage buffers and
+ *  the command buffer of the indirect draws.
+ ***********************************************************/
+void SceneManager::DestroyIndirectBuffers()
+{
+	if (0 != m_instanceBuffer)
+	{
+		glDeleteBuffers(1, &m_instanceBuffer);
+		m_instanceBuffer = 0;
+	}
+	if (0 != m_materialBuffer)
+	{
+		glDeleteBuffers(1, &m_materialBuffer);
+		m_materialBuffer = 0;
+	}
+	if (0 != m_commandBuffer)
+	{
+		glDeleteBuffers(1, &m_commandBuffer);
+		m_commandBuffer = 0;
+	}
+
+	m_bIndirectSupported = false;
+}
+
+/***********************************************************
+ *  GetIndirectArrayIndex()
+ *
+ *  This method is used for getting the texture array that a
+ *  batch samples when it is drawn indirectly, or -1 when it
+ *  is drawn with its color.  Batches whose texture is not
+ *  packed into an array, or whose mesh is not in the shared
+ *  mesh buffer, get -2 and are drawn one by one instead.
+ ***********************************************************/
+int SceneManager::GetIndirectArrayIndex(const INSTANCE_BATCH& batch) const
+{
+	if (!m_meshBuffer.HasMesh(batch.mesh))
+	{
+		return(-2);
+	}
+	if (batch.textureSlot < 0)
+	{
+		return(-1);
+	}
+	if (m_textureIDs[batch.textureSlot].arrayIndex < 0)
+	{
+		return(-2);
+	}
+
+	return(m_textureIDs[batch.textureSlot].arrayIndex);
+}
+
+/***********************************************************
+ *  SubmitIndirectDraws()
+ *
+ *  This method is used for drawing the sorted packets of the
+ *  render queue with as few calls as possible.  The packets
+ *  are turned into instances of the instance buffer in draw
+ *  order, and packets of the same mesh that follow each
+ *  other become one indirect command.  All of the commands
+ *  of a pass that sample the same array texture are drawn
+ *  by one call to glMultiDrawElementsIndirect().  Packets
+ *  that can not be drawn from the shared buffers are drawn
+ *  one by one in their place in the order.
+ ***********************************************************/
+void SceneManager::SubmitIndirectDraws()
+{
+	const RenderQueue& renderQueue = m_frameCommands[m_submitFrame].views[m_submitView].renderQueue;
+	int currentBatch = -1;
+	int currentPass = -1;
+	int passScope = -1;
+
+	m_drawInstances.clear();
+	m_drawCommands.clear();
+	m_drawSegments.clear();
+
+	for (int i = 0; i < renderQueue.GetPacketCount(); i++)
+	{
+		const RenderQueue::DRAW_PACKET& packet = renderQueue.GetPacket(i);
+		const INSTANCE_BATCH& batch = m_instanceBatches[packet.batchIndex];
+		int pass = batch.bTransparent ? RenderQueue::RENDER_PASS_TRANSPARENT : RenderQueue::RENDER_PASS_OPAQUE;
+		int arrayIndex = GetIndirectArrayIndex(batch);
+		bool bIndirect = (arrayIndex >= -1);
+
+		if (packet.batchIndex != currentBatch)
+		{
+			m_renderStatistics.batches++;
+			currentBatch = packet.batchIndex;
+		}
+
+		// start a new segment when the pass, the way of drawing
+		// or the array texture changes, colored instances can
+		// join the segment of any array texture
+		if ((m_drawSegments.empty()) ||
+			(m_drawSegments.back().pass != pass) ||
+			(m_drawSegments.back().bIndirect != bIndirect) ||
+			((arrayIndex >= 0) && (m_drawSegments.back().arrayIndex >= 0) &&
+			 (m_drawSegments.back().arrayIndex != arrayIndex)))
+		{
+			DRAW_SEGMENT segment;
+			segment.pass = pass;
+			segment.bIndirect = bIndirect;
+			segment.arrayIndex = -1;
+			segment.first = bIndirect ? m_drawCommands.size() : i;
+			segment.count = 0;
+			segment.lastMesh = -1;
+			m_drawSegments.push_back(segment);
+		}
+
+		DRAW_SEGMENT& segment = m_drawSegments.back();
+
+		if (!bIndirect)
+		{
+			segment.count++;
+			continue;
+		}
+
+		if (arrayIndex >= 0)
+		{
+			segment.arrayIndex = arrayIndex;
+		}
+
+		int lodMesh = m_meshBuffer.GetLodMesh(batch.mesh, packet.lod);
+
+		m_drawInstances.push_back(GetGpuInstance(packet.instanceIndex));
+		m_drawInstances.back().lodFade = packet.lodFade;
+
+		// the instances of a command have to be next to each other
+		// in the instance buffer, which they are in draw order
+		if (segment.lastMesh == lodMesh)
+		{
+			m_drawCommands.back().instanceCount++;
+		}
+		else
+		{
+			m_drawCommands.push_back(m_meshBuffer.MakeCommand(lodMesh, 1, m_drawInstances.size() - 1));
+			segment.lastMesh = lodMesh;
+			segment.count++;
+		}
+	}
+
+	// write the instances and commands of the frame into the
+	// dynamic buffer and bind them by their offsets, or upload
+	// them into fresh storage when it is full or unsupported
+	GLintptr commandOffset = 0;
+	if (!m_drawCommands.empty())
+	{
+		GLsizeiptr commandSize = m_drawCommands.size() * sizeof(MeshBuffer::DRAW_COMMAND);
+
+		UploadDrawInstances();
+		if (m_dynamicBuffer.Upload(m_drawCommands.data(), commandSize, sizeof(GLuint), commandOffset))
+		{
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_dynamicBuffer.GetBuffer());
+		}
+		else
+		{
+			commandOffset = 0;
+			glBindBuffer(GL_DRAW_INDIRECT_BUFFER, m_commandBuffer);
+			glBufferData(GL_DRAW_INDIRECT_BUFFER, commandSize, m_drawCommands.data(), GL_STREAM_DRAW);
+		}
+	}
+
+	m_renderStatistics.indirectCommands += m_drawCommands.size();
+
+	for (int i = 0; i < m_drawSegments.size(); i++)
+	{
+		const DRAW_SEGMENT& segment = m_drawSegments[i];
+
+		if (segment.pass != currentPass)
+		{
+			if (NULL != m_pFrameProfiler)
+			{
+				m_pFrameProfiler->EndScope(passScope);
+				passScope = m_pFrameProfiler->BeginScope(
+					(segment.pass == RenderQueue::RENDER_PASS_TRANSPARENT) ? "Transparent" : "Opaque");
+			}
+
+			SetRenderPassState(segment.pass);
+			currentPass = segment.pass;
+		}
+
+		if (!segment.bIndirect)
+		{
+			for (int j = segment.first; j < segment.first + segment.count; j++)
+			{
+				DrawPacket(renderQueue.GetPacket(j));
+			}
+			continue;
+		}
+
+		SetInstanceBufferMode(true);
+
+		if (segment.arrayIndex >= 0)
+		{
+			SetArrayTexture(segment.arrayIndex);
+		}
+
+		// the meshes' own draws bind their own vertex arrays
+		m_meshBuffer.Bind();
+		glMultiDrawElementsIndirect(
+			GL_TRIANGLES,
+			GL_UNSIGNED_INT,
+			(const void*)(commandOffset + segment.first * sizeof(MeshBuffer::DRAW_COMMAND)),
+			segment.count,
+			0);
+		m_renderStatistics.drawCalls++;
+	}
+
+	if (NULL != m_pFrameProfiler)
+	{
+		m_pFrameProfiler->EndScope(passScope);
+	}
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	// restore the blending and depth writes set up with the window,
+	// the depth buffer can not be cleared while depth writes are off
+	glEnable(GL_BLEND);
+	glDepthMask(GL_TRUE);
+}
+
+/***********************************************************
+ *  IsDrawingIndirect()
+ *
+ *  This method is used for checking whether the frame is
+ *  drawn with indirect multi-draws.  The object groups are
+ *  measured one draw at a time, so they never are then.
+ ***********************************************************/
+bool SceneManager::IsDrawingIndirect() const
+{
+	return(m_bIndirectSupported && m_bIndirectDraws && !m_bProfileGroups);
+}
+
+/***********************************************************
+ *  IsDrawingInstanced()
+ *
+ *  This method is used for checking whether the batches of
+ *  the render queue are drawn instanced.  They are whenever
+ *  the shader can read the instance buffer but the frame is
+ *  not drawn with indirect multi-draws, like while the
+ *  object groups are measured.
+ ***********************************************************/
+bool SceneManager::IsDrawingInstanced() const
+{
+	return(m_bIndirectSupported && !IsDrawingIndirect());
+}
+
+/***********************************************************
+ *  BuildGpuCullingLayout()
+ *
+ *  This method is used for splitting the instances between
+ *  the GPU and the CPU culling, and laying out the commands
+ *  of the GPU culled instances.  Only opaque instances that
+ *  can be drawn from the shared mesh buffer are culled on
+ *  the GPU, the transparent instances still have to be
+ *  sorted back to front on the CPU.  The GPU culled instances
+ *  are ordered by array texture and mesh, so each command
+ *  gets one range of the instance buffer, which is sized for
+ *  every instance of the command to be visible at once.  A
+ *  mesh with levels of detail gets a command for each level,
+ *  and every level reserves its range in its own copy of the
+ *  instances, since a crossfaded instance is drawn by two.
+ ***********************************************************/
+void SceneManager::BuildGpuCullingLayout()
+{
+	std::vector<std::pair<int, int>> order;
+	std::vector<MeshBuffer::DRAW_COMMAND> commands;
+	std::vector<GpuCulling::CULL_INSTANCE> instances;
+
+	m_gpuCullInstances.clear();
+	m_gpuCullCommands.clear();
+	m_gpuCullSegments.clear();
+	m_cpuCullInstances.clear();
+	m_instanceCullIndices.assign(m_instanceData.size(), -1);
+
+	for (int i = 0; i < m_instanceData.size(); i++)
+	{
+		const INSTANCE_BATCH& batch = m_instanceBatches[m_instanceBatchIndices[i]];
+		int arrayIndex = GetIndirectArrayIndex(batch);
+
+		if ((batch.bTransparent) || (arrayIndex < -1))
+		{
+			m_cpuCullInstances.push_back(i);
+		}
+		else
+		{
+			order.push_back(std::make_pair(((arrayIndex + 1) * (int)m_meshBounds.size()) + batch.mesh, i));
+		}
+	}
+
+	std::sort(order.begin(), order.end());
+
+	for (int i = 0; i < order.size(); i++)
+	{
+		int instanceIndex = order[i].second;
+		const INSTANCE_BATCH& batch = m_instanceBatches[m_instanceBatchIndices[instanceIndex]];
+		int arrayIndex = GetIndirectArrayIndex(batch);
+
+		// colored instances can join the segment of any array texture
+		if ((m_gpuCullSegments.empty()) ||
+			((arrayIndex >= 0) && (m_gpuCullSegments.back().arrayIndex >= 0) &&
+			 (m_gpuCullSegments.back().arrayIndex != arrayIndex)))
+		{
+			DRAW_SEGMENT segment;
+			segment.pass = RenderQueue::RENDER_PASS_OPAQUE;
+			segment.bIndirect = true;
+			segment.arrayIndex = -1;
+			segment.first = commands.size();
+			segment.count = 0;
+			segment.lastMesh = -1;
+			m_gpuCullSegments.push_back(segment);
+		}
+
+		DRAW_SEGMENT& segment = m_gpuCullSegments.back();
+
+		int levelCount = m_meshBuffer.GetLodCount(batch.mesh);
+
+		if (arrayIndex >= 0)
+		{
+			segment.arrayIndex = arrayIndex;
+		}
+		if (segment.lastMesh != batch.mesh)
+		{
+			for (int lod = 0; lod < levelCount; lod++)
+			{
+				commands.push_back(m_meshBuffer.MakeCommand(
+					m_meshBuffer.GetLodMesh(batch.mesh, lod), 0, (lod * order.size()) + i));
+			}
+			segment.lastMesh = batch.mesh;
+			segment.count += levelCount;
+		}
+
+		// the instance counts reserve the ranges of the commands
+		for (int lod = 0; lod < levelCount; lod++)
+		{
+			commands[commands.size() - levelCount + lod].instanceCount++;
+		}
+		m_instanceCullIndices[instanceIndex] = m_gpuCullInstances.size();
+		m_gpuCullInstances.push_back(instanceIndex);
+		m_gpuCullCommands.push_back(commands.size() - levelCount);
+	}
+
+	GetGpuCullInstances(0, m_gpuCullInstances.size(), instances);
+	m_gpuCulling.SetInstances(instances, commands);
+}
+
+/***********************************************************
+ *  GetGpuCullInstances()
+ *
+ *  This method is used for filling the culling values and
+ *  bounds of the GPU culled instances, in the order of the
+ *  cull buffer.
+ ***********************************************************/
+void SceneManager::GetGpuCullInstances(int first, int count, std::vector<GpuCulling::CULL_INSTANCE>& instances) const
+{
+	instances.resize(count);
+
+	for (int i = first; i < first + count; i++)
+	{
+		int instanceIndex = m_gpuCullInstances[i];
+		const INSTANCE_BATCH& batch = m_instanceBatches[m_instanceBatchIndices[instanceIndex]];
+		const INSTANCE_DATA& instance = m_instanceData[instanceIndex];
+		GpuCulling::CULL_INSTANCE& cullInstance = instances[i - first];
+
+		cullInstance.model = instance.model;
+		cullInstance.color = batch.color;
+		cullInstance.uvScale = instance.uvScale;
+		cullInstance.materialIndex = instance.materialIndex;
+		cullInstance.textureLayer = (batch.textureSlot >= 0) ? m_textureIDs[batch.textureSlot].layer : -1;
+		cullInstance.lodFade = 0.0f;
+		cullInstance.instancePadding[0] = 0;
+		cullInstance.instancePadding[1] = 0;
+		cullInstance.instancePadding[2] = 0;
+		cullInstance.boundsMin = glm::vec4(m_instanceBounds[instanceIndex].min, 1.0f);
+		cullInstance.boundsMax = glm::vec4(m_instanceBounds[instanceIndex].max, 1.0f);
+		// the compute shader skips the instances of the cells that are not streamed in
+		cullInstance.commandIndex = m_instanceResident[instanceIndex] ? m_gpuCullCommands[i] : -1;
+		cullInstance.levelCount = m_meshBuffer.GetLodCount(batch.mesh);
+		cullInstance.padding[0] = 0;
+		cullInstance.padding[1] = 0;
+	}
+}
+
+/***********************************************************
+ *  IsCullingOnGpu()
+ *
+ *  This method is used for checking whether the opaque
+ *  instances of the frame are culled by the compute shader.
+ ***********************************************************/
+bool SceneManager::IsCullingOnGpu() const
+{
+	return(m_bGpuCullingSupported && m_bGpuCulling && IsDrawingIndirect() && m_gpuCulling.IsReady());
+}
+
+/***********************************************************
+ *  DispatchGpuCulling()
+ *
+ *  This method is used for culling the GPU culled instances
+ *  with the same frustum and smallest screen size as the
+ *  CPU culling, and picking their levels of detail with the
+ *  same screen radii and crossfade band.
+ ***********************************************************/
+void SceneManager::DispatchGpuCulling()
+{
+	GpuCulling::CULL_PARAMETERS parameters;
+
+	parameters.pFrustum = &m_frameView.frustum;
+	parameters.bFrustumCulling = m_bFrustumCulling;
+	parameters.view = m_frameView.view;
+	parameters.pixelScale = m_frameView.projection[1][1] * m_frameView.viewportHeight * 0.5f;
+	// a perspective projection has no translation in w
+	parameters.bPerspective = (m_frameView.projection[3][3] == 0.0f);
+	parameters.minScreenRadius = (m_frameView.viewportHeight > 0) ? m_minScreenRadius : 0.0f;
+	// without a viewport every instance keeps its full detail
+	for (int i = 0; i < MeshBuffer::LOD_COUNT - 1; i++)
+	{
+		parameters.lodScreenRadii[i] = (m_frameView.viewportHeight > 0) ? g_LodScreenRadii[i] : 0.0f;
+	}
+	parameters.lodFadeBand = m_bLodFadeSupported ? g_LodFadeBand : 0.0f;
+
+	m_gpuCulling.Dispatch(parameters);
+}
+
+/***********************************************************
+ *  SubmitGpuCulledDraws()
+ *
+ *  This method is used for drawing the commands filled by
+ *  the GPU culling, one multi-draw call for each array
+ *  texture.  The instance counts are only known to the GPU,
+ *  so every command is drawn and the hidden instances are
+ *  simply not part of it.
+ ***********************************************************/
+void SceneManager::SubmitGpuCulledDraws()
+{
+	int passScope = -1;
+
+	if (NULL != m_pFrameProfiler)
+	{
+		passScope = m_pFrameProfiler->BeginScope("GPU Culled");
+	}
+
+	SetRenderPassState(RenderQueue::RENDER_PASS_OPAQUE);
+	SetInstanceBufferMode(true);
+	m_gpuCulling.BindForDrawing();
+	m_meshBuffer.Bind();
+
+	for (int i = 0; i < m_gpuCullSegments.size(); i++)
+	{
+		const DRAW_SEGMENT& segment = m_gpuCullSegments[i];
+
+		if (segment.arrayIndex >= 0)
+		{
+			SetArrayTexture(segment.arrayIndex);
+		}
+
+		glMultiDrawElementsIndirect(
+			GL_TRIANGLES,
+			GL_UNSIGNED_INT,
+			(const void*)(segment.first * sizeof(MeshBuffer::DRAW_COMMAND)),
+			segment.count,
+			0);
+		m_renderStatistics.drawCalls++;
+	}
+
+	m_renderStatistics.indirectCommands += m_gpuCulling.GetCommandCount();
+
+	glBindVertexArray(0);
+	glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+	if (NULL != m_pFrameProfiler)
+	{
+		m_pFrameProfiler->EndScope(passScope);
+	}
+}
+
+/***********************************************************
+ *  BuildStreamingCells()
+ *
+ *  This method is used for splitting the scene objects into
+ *  the cells of the world by their bounds, and for deciding
+ *  whether the world is large enough to be streamed.  It has
+ *  to be called before the textures are created, since the
+ *  textures of a streamed world are not loaded up front.
+ ***********************************************************/
+void SceneManager::BuildStreamingCells()
+{
+	m_worldStreamer.Clear();
+
+	for (int i = 0; i < m_sceneObjects.size(); i++)
+	{
+		const SCENE_OBJECT& object = m_sceneObjects[i];
+
+		m_worldStreamer.AddObject(
+			i,
+			Frustum::TransformBox(m_meshBounds[object.mesh], object.model),
+			object.textureSlot);
+	}
+
+	m_bStreaming = m_worldStreamer.NeedsStreaming();
+}
+
+/***********************************************************
+ *  UpdateStreaming()
+ *
+ *  This method is used for loading and evicting the cells
+ *  around the camera.  Only the choice of cells is made here,
+ *  the texture images are decoded on the loader's worker
+ *  threads and uploaded by UpdateGLTextures() within its
+ *  byte budget, so no frame waits for a cell.  A cell is
+ *  shown once all of its textures have arrived, so its
+ *  objects appear complete instead of with placeholders.
+ ***********************************************************/
+void SceneManager::UpdateStreaming()
+{
+	std::vector<int> cellsToLoad;
+	std::vector<int> cellsToEvict;
+
+	if (!m_bStreaming)
+	{
+		return;
+	}
+
+	m_worldStreamer.Update(m_sceneViews[0].viewPosition, m_residentTextureBytes, cellsToLoad, cellsToEvict);
+
+	// evict first, so textures shared with a loading cell are freed
+	// only when no cell uses them anymore
+	for (int i = 0; i < cellsToEvict.size(); i++)
+	{
+		EvictStreamingCell(cellsToEvict[i]);
+	}
+	for (int i = 0; i < cellsToLoad.size(); i++)
+	{
+		LoadStreamingCell(cellsToLoad[i]);
+	}
+
+	for (int i = 0; i < m_worldStreamer.GetCellCount(); i++)
+	{
+		const WorldStreamer::STREAMING_CELL& cell = m_worldStreamer.GetCell(i);
+		bool bReady = (cell.state == WorldStreamer::CELL_LOADING);
+
+		for (int j = 0; (j < cell.textures.size()) && bReady; j++)
+		{
+			bReady = !m_textureIDs[cell.textures[j]].bLoading;
+		}
+
+		if (bReady)
+		{
+			m_worldStreamer.SetCellResident(i);
+			SetCellResidency(i, true);
+		}
+	}
+}
+
+/***********************************************************
+ *  LoadStreamingCell()
+ *
+ *  This method is used for taking a reference on each of the
+ *  textures of a cell, and for queueing the images of the
+ *  ones that are not loaded yet.
+ ***********************************************************/
+void SceneManager::LoadStreamingCell(int cell)
+{
+	const WorldStreamer::STREAMING_CELL& streamingCell = m_worldStreamer.GetCell(cell);
+
+	for (int i = 0; i < streamingCell.textures.size(); i++)
+	{
+		TEXTURE_INFO& texture = m_textureIDs[streamingCell.textures[i]];
+
+		texture.streamReferences++;
+		if ((!texture.bLoaded) && (!texture.bLoading))
+		{
+			QueueGLTexture(streamingCell.textures[i]);
+		}
+	}
+}
+
+/***********************************************************
+ *  EvictStreamingCell()
+ *
+ *  This method is used for hiding the objects of a cell and
+ *  dropping its references on its textures.  The textures no
+ *  other cell uses are freed, and one that is still being
+ *  decoded is thrown away when it arrives.
+ ***********************************************************/
+void SceneManager::EvictStreamingCell(int cell)
+{
+	const WorldStreamer::STREAMING_CELL& streamingCell = m_worldStreamer.GetCell(cell);
+
+	SetCellResidency(cell, false);
+
+	for (int i = 0; i < streamingCell.textures.size(); i++)
+	{
+		TEXTURE_INFO& texture = m_textureIDs[streamingCell.textures[i]];
+
+		texture.streamReferences--;
+		if ((texture.streamReferences == 0) && (texture.bLoaded))
+		{
+			ReleaseGLTexture(streamingCell.textures[i]);
+		}
+	}
+}
+
+/***********************************************************
+ *  SetCellResidency()
+ *
+ *  This method is used for showing or hiding the instances
+ *  of the objects of a cell.  The batches and the hierarchy
+ *  are kept as they are, so a cell is streamed in or out
+ *  without rebuilding anything.
+ ***********************************************************/
+void SceneManager::SetCellResidency(int cell, bool bResident)
+{
+	const WorldStreamer::STREAMING_CELL& streamingCell = m_worldStreamer.GetCell(cell);
+
+	for (int i = 0; i < streamingCell.objects.size(); i++)
+	{
+		int instanceIndex = m_objectInstanceIndices[streamingCell.objects[i]];
+
+		if (instanceIndex >= 0)
+		{
+			m_instanceResident[instanceIndex] = bResident;
+		}
+	}
+
+	m_bResidencyDirty = true;
+	m_shadowMaps.InvalidateStatic();
+}
+
+/***********************************************************
+ *  AddClusterLight()
+ *
+ *  This method is used for adding a point light to the
+ *  lights that are binned into clusters.  The light fades
+ *  out at its range, which has to be set for every light
+ *  so the clusters it reaches are known.
+ ***********************************************************/
+void SceneManager::AddClusterLight(const UniformCache::POINT_LIGHT_DATA& light, float range)
+{
+	LightClusters::CLUSTER_LIGHT clusterLight;
+
+	clusterLight.positionRange = glm::vec4(glm::vec3(light.position), range);
+	clusterLight.ambient = light.ambient;
+	clusterLight.diffuse = light.diffuse;
+	clusterLight.specular = light.specular;
+
+	m_clusterLights.push_back(clusterLight);
+}
+
+/***********************************************************
+ *  CreateLightClusters()
+ *
+ *  This method is used for creating the light clusters when
+ *  the driver has storage buffers and the shader declares
+ *  the cluster storage blocks.  The shader then reads the
+ *  point lights of each fragment's cluster instead of the
+ *  point lights of the light block.
+ ***********************************************************/
+void SceneManager::CreateLightClusters()
+{
+	if ((!GLEW_ARB_shader_storage_buffer_object) ||
+		(!m_pUniformCache->HasUniform(UniformCache::UNIFORM_USE_CLUSTERED_LIGHTS)) ||
+		(!m_pUniformCache->BindStorageBlock("ClusterBlock", LightClusters::CLUSTER_BLOCK_BINDING)) ||
+		(!m_pUniformCache->BindStorageBlock("LightIndexBlock", LightClusters::LIGHT_INDEX_BLOCK_BINDING)) ||
+		(!m_pUniformCache->BindStorageBlock("ClusterLightBlock", LightClusters::CLUSTER_LIGHT_BLOCK_BINDING)))
+	{
+		return;
+	}
+
+	m_lightClusters.Initialize();
+	m_lightClusters.SetLights(m_clusterLights);
+	m_bClusteredLightingSupported = true;
+	m_pUniformCache->setBoolValue(UniformCache::UNIFORM_USE_CLUSTERED_LIGHTS, m_bClusteredLighting);
+
+	std::cout << "Shading " << m_clusterLights.size() << " point lights with clustered forward lighting" << std::endl;
+}
+
+/***********************************************************
+ *  UpdateLightClusters()
+ *
+ *  This method is used for binning the point lights into
+ *  the clusters of the view being rendered, over the part
+ *  of the render target the view covers.
+ ***********************************************************/
+void SceneManager::UpdateLightClusters()
+{
+	LightClusters::CLUSTER_VIEW view;
+
+	if ((!m_bClusteredLightingSupported) || (!m_bClusteredLighting))
+	{
+		return;
+	}
+
+	view.view = m_frameView.view;
+	view.projection = m_frameView.projection;
+	view.viewportX = m_frameView.viewportX;
+	view.viewportY = m_frameView.viewportY;
+	view.viewportWidth = m_frameView.viewportWidth;
+	view.viewportHeight = m_frameView.viewportHeight;
+
+	m_lightClusters.Update(view, &m_dynamicBuffer);
+}
+
+/***********************************************************
+ *  CreateShadowMaps()
+ *
+ *  This method is used for creating the shadow maps when the
+ *  driver has depth cube map arrays and the shader declares
+ *  the shadow block and samplers.  The point lights of the
+ *  light block are the ones that cast shadows.
+ ***********************************************************/
+void SceneManager::CreateShadowMaps()
+{
+	GLint maxTextureUnits = 0;
+	std::vector<glm::vec4> pointLights;
+
+	if ((!m_pUniformCache->HasUniform(UniformCache::UNIFORM_USE_SHADOWS)) ||
+		(!m_pUniformCache->HasShadowBlock()))
+	{
+		return;
+	}
+
+	// the samplers get their own units even without shadows, since
+	// they would share unit 0 with the 2D texture sampler otherwise
+	glGetIntegerv(GL_MAX_COMBINED_TEXTURE_IMAGE_UNITS, &maxTextureUnits);
+	m_shadowTextureUnit = maxTextureUnits - ShadowMaps::TEXTURE_UNIT_COUNT;
+	m_pUniformCache->setSampler2DValue(UniformCache::UNIFORM_DIRECTIONAL_SHADOW_MAP, m_shadowTextureUnit);
+	m_pUniformCache->setSampler2DValue(UniformCache::UNIFORM_POINT_SHADOW_MAP, m_shadowTextureUnit + 1);
+
+	for (int i = 0; i < UniformCache::MAX_POINT_LIGHTS; i++)
+	{
+		// the light block holds the first of the clustered lights
+		if ((m_sceneLights.pointLights[i].bActive) && (i < m_clusterLights.size()))
+		{
+			pointLights.push_back(m_clusterLights[i].positionRange);
+		}
+	}
+
+	if (!m_shadowMaps.Initialize(pointLights.size()))
+	{
+		m_pUniformCache->setBoolValue(UniformCache::UNIFORM_USE_SHADOWS, false);
+		return;
+	}
+
+	m_shadowMaps.SetLights(
+		m_sceneLights.directionalLight.bActive,
+		glm::vec3(m_sceneLights.directionalLight.direction),
+		pointLights);
+	m_bShadowsSupported = true;
+	m_pUniformCache->setBoolValue(UniformCache::UNIFORM_USE_SHADOWS, m_bShadows);
+}
+
+/***********************************************************
+ *  RestoreShaderState()
+ *
+ *  This method is used for setting up a shader program that
+ *  replaced the one the scene was prepared with, once it is
+ *  in use.  The uniform locations and blocks are resolved
+ *  again, and the lights, storage blocks, samplers and
+ *  switches the scene set when it was prepared are set on
+ *  the new program.  A feature whose block the new program
+ *  no longer declares is turned off.
+ ***********************************************************/
+void SceneManager::RestoreShaderState()
+{
+	if (NULL == m_pUniformCache)
+	{
+		return;
+	}
+
+	m_pUniformCache->LoadUniforms();
+	m_pUniformCache->setBoolValue(UniformCache::UNIFORM_USE_LIGHTING, true);
+	m_pUniformCache->SetLightData(m_sceneLights);
+
+	if ((m_bIndirectSupported) &&
+		((!m_pUniformCache->HasUniform(UniformCache::UNIFORM_USE_INSTANCE_BUFFER)) ||
+		(!m_pUniformCache->BindStorageBlock("InstanceBlock", INSTANCE_BLOCK_BINDING)) ||
+		(!m_pUniformCache->BindStorageBlock("MaterialBlock", MATERIAL_BLOCK_BINDING))))
+	{
+		std::cout << "The reloaded shader can not draw indirectly" << std::endl;
+		m_bIndirectSupported = false;
+	}
+
+	if ((m_bDrawBlockSupported) && (!FindDrawBlock()))
+	{
+		std::cout << "The reloaded shader can not read draw records" << std::endl;
+		m_bDrawBlockSupported = false;
+	}
+
+	// the crossfade only needs the shader, so it follows the reloaded one
+	m_bLodFadeSupported = m_pUniformCache->HasUniform(UniformCache::UNIFORM_LOD_FADE);
+
+	if ((m_bClusteredLightingSupported) &&
+		((!m_pUniformCache->HasUniform(UniformCache::UNIFORM_USE_CLUSTERED_LIGHTS)) ||
+		(!m_pUniformCache->BindStorageBlock("ClusterBlock", LightClusters::CLUSTER_BLOCK_BINDING)) ||
+		(!m_pUniformCache->BindStorageBlock("LightIndexBlock", LightClusters::LIGHT_INDEX_BLOCK_BINDING)) ||
+		(!m_pUniformCache->BindStorageBlock("ClusterLightBlock", LightClusters::CLUSTER_LIGHT_BLOCK_BINDING))))
+	{
+		std::cout << "The reloaded shader can not shade clustered lights" << std::endl;
+		m_bClusteredLightingSupported = false;
+	}
+	if (m_bClusteredLightingSupported)
+	{
+		m_pUniformCache->setBoolValue(UniformCache::UNIFORM_USE_CLUSTERED_LIGHTS, m_bClusteredLighting);
+	}
+
+	if ((m_bShadowsSupported) &&
+		((!m_pUniformCache->HasUniform(UniformCache::UNIFORM_USE_SHADOWS)) ||
+		(!m_pUniformCache->HasShadowBlock())))
+	{
+		std::cout << "The reloaded shader can not sample shadows" << std::endl;
+		m_bShadowsSupported = false;
+	}
+	if (m_bShadowsSupported)
+	{
+		m_pUniformCache->setSampler2DValue(UniformCache::UNIFORM_DIRECTIONAL_SHADOW_MAP, m_shadowTextureUnit);
+		m_pUniformCache->setSampler2DValue(UniformCache::UNIFORM_POINT_SHADOW_MAP, m_shadowTextureUnit + 1);
+		m_pUniformCache->setBoolValue(UniformCache::UNIFORM_USE_SHADOWS, m_bShadows);
+	}
+
+	// the textures, colors and materials are sent again on the next draws
+	ResetRenderState();
+}
+
+/***********************************************************
+ *  RenderShadowMaps()
+ *
+ *  This method is used for rendering the shadow views of
+ *  the frame.  Each view draws the opaque resident casters
+ *  inside its frustum, either the static or the dynamic
+ *  ones, so the static casters are only drawn again when
+ *  their cached maps went stale.  Transparent objects cast
+ *  no shadows.  The maps are then bound and their values
+ *  set into the shader.
+ ***********************************************************/
+void SceneManager::RenderShadowMaps()
+{
+	UniformCache::SHADOW_BLOCK shadows;
+
+	if ((!m_bShadowsSupported) || (!m_bShadows))
+	{
+		return;
+	}
+
+	m_shadowMaps.Update(m_frameView.view, m_frameView.projection, m_dynamicInstanceCount > 0, m_shadowViews);
+
+	if (m_shadowViews.size() > 0)
+	{
+		m_shadowMaps.BeginPass();
+
+		for (int i = 0; i < m_shadowViews.size(); i++)
+		{
+			const ShadowMaps::SHADOW_VIEW& view = m_shadowViews[i];
+
+			m_shadowMaps.BeginView(view);
+
+			m_shadowCasters.clear();
+			m_sceneBVH.QueryFrustum(view.frustum, m_shadowCasters);
+
+			for (int j = 0; j < m_shadowCasters.size(); j++)
+			{
+				int instanceIndex = m_shadowCasters[j];
+				const INSTANCE_BATCH& batch = m_instanceBatches[m_instanceBatchIndices[instanceIndex]];
+
+				if ((!m_instanceResident[instanceIndex]) || (batch.bTransparent))
+				{
+					continue;
+				}
+				if ((ShadowMaps::CASTERS_ALL != view.casters) &&
+					(m_instanceDynamic[instanceIndex] != (ShadowMaps::CASTERS_DYNAMIC == view.casters)))
+				{
+					continue;
+				}
+
+				m_shadowMaps.SetModel(m_instanceData[instanceIndex].model);
+				DrawMesh(batch.mesh);
+			}
+		}
+
+		m_shadowMaps.EndPass();
+		m_renderStatistics.shadowViews = m_shadowViews.size();
+	}
+
+	m_shadowMaps.BindTextures(m_shadowTextureUnit);
+	m_shadowMaps.GetShadowData(shadows);
+	m_pUniformCache->SetShadowData(shadows);
+}
+
+/***********************************************************
+ *  SetRenderPassState()
+ *
+ *  This method is used for setting the blending and depth
+ *  state of a render pass.  Opaque draws write depth with
+ *  blending turned off.  Transparent draws are blended and
+ *  still tested against the depth of the opaque scene, but
+ *  do not write depth, so a transparent object never hides
+ *  another transparent object that is drawn after it.
+ ***********************************************************/
+void SceneManager::SetRenderPassState(int pass)
+{
+	if (RenderQueue::RENDER_PASS_TRANSPARENT == pass)
+	{
+		glEnable(GL_BLEND);
+		glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+		glDepthMask(GL_FALSE);
+	}
+	else
+	{
+		glDisable(GL_BLEND);
+		glDepthMask(GL_TRUE);
+	}
+}
+
+/***********************************************************
+ *  RenderScene()
+ *
+ *  This method is used for rendering the 3D scene.  The
+ *  instances of the batches built in PrepareScene() are
+ *  sorted by render state every frame and then drawn, so
+ *  textures, colors and materials change as few times as
+ *  possible.  The opaque objects are drawn first and the
+ *  transparent objects are blended over them afterwards.
+ *  The instances are culled and sorted into a command list
+ *  on the worker threads, and only the OpenGL calls are
+ *  made on the context thread.  When the scene is rendered
+ *  into several views, the scene is updated and the shadows
+ *  are rendered once for all of them, and each view is then
+ *  drawn into its own part of the render target.
+ ***********************************************************/
+void SceneManager::RenderScene()
+{
+	if (NULL == m_pUniformCache)
+	{
+		return;
+	}
+
+	m_renderStatistics = RENDER_STATISTICS();
+
+	// the dynamic data of this frame goes into the next region,
+	// once the GPU is done with the frame that last used it
+	m_dynamicBuffer.BeginFrame();
+
+	// swap in any textures that finished loading
+	UpdateGLTextures();
+
+	// move the objects of the transform nodes that changed
+	UpdateTransformHierarchy();
+
+	// load and evict the cells around the camera
+	UpdateStreaming();
+
+	// fit the hierarchy and the GPU culled bounds around the
+	// objects that moved, and pass on the cells that were
+	// streamed in or out
+	UpdateMovedInstances();
+
+	// the command list of this frame is culled and sorted on the
+	// workers while the lights and shadows are rendered here
+	FRAME_COMMANDS& prepared = m_frameCommands[m_prepareFrame];
+	FRAME_COMMANDS& previous = m_frameCommands[1 - m_prepareFrame];
+	BeginFrameCommands(prepared);
+
+	// when pipelined, the list prepared during the last frame is
+	// drawn with the views it was culled for, while this frame's
+	// list is still being prepared, as long as both were culled
+	// and keyed the same way for the same number of views
+	bool bSubmitPrevious = m_bFramePipelining && previous.bPrepared &&
+		(previous.viewCount == prepared.viewCount) &&
+		(previous.bIndirect == prepared.bIndirect) &&
+		(previous.bInstanced == prepared.bInstanced) &&
+		(previous.bGpuCulling == prepared.bGpuCulling) &&
+		(previous.bProfileGroups == prepared.bProfileGroups);
+	FRAME_COMMANDS& submitted = bSubmitPrevious ? previous : prepared;
+
+	m_submitFrame = bSubmitPrevious ? (1 - m_prepareFrame) : m_prepareFrame;
+	if (bSubmitPrevious)
+	{
+		SetFrameCameras(previous);
+	}
+
+	ResetRenderState();
+
+	// the shadow maps are fit to the first view and only rendered
+	// once per frame, the other views sample the point shadows only
+	SetFrameView(submitted, 0);
+	RenderShadowMaps();
+
+	// the views are drawn into their parts of the render target,
+	// and the viewport the frame was set up with is put back after
+	GLint viewport[4];
+	glGetIntegerv(GL_VIEWPORT, viewport);
+	for (int i = 0; i < submitted.viewCount; i++)
+	{
+		RenderView(submitted, i);
+	}
+	glViewport(viewport[0], viewport[1], viewport[2], viewport[3]);
+	m_pUniformCache->SelectCamera(0);
+
+	m_renderStatistics.culledObjects = submitted.culledObjects;
+	m_renderStatistics.detailCulledObjects = submitted.detailCulledObjects;
+
+	// the scene can change again once this frame's list is done,
+	// and a submitted list is not drawn a second time
+	WaitForFrameCommands(prepared);
+	if (bSubmitPrevious)
+	{
+		SetFrameCameras(prepared);
+		previous.bPrepared = false;
+	}
+	m_prepareFrame = 1 - m_prepareFrame;
+
+	// every draw that reads this frame's region has been issued
+	m_dynamicBuffer.EndFrame();
+}
+
+/***********************************************************
+ *  RenderView()
+ *
+ *  This method is used for drawing one view of a command
+ *  list with the camera of its slot of the camera block,
+ *  into the part of the render target it covers.  The point
+ *  lights are binned into the clusters of the view, and the
+ *  compute shader culls the opaque instances again for its
+ *  frustum.  Only the first view samples the directional
+ *  shadow cascades, which are fit to its frustum alone.
+ ***********************************************************/
+void SceneManager::RenderView(FRAME_COMMANDS& commands, int viewIndex)
+{
+	SetFrameView(commands, viewIndex);
+	m_pUniformCache->SelectCamera(viewIndex);
+
+	// the cascades do not cover the frusta of the other views, so
+	// these are drawn without directional shadows
+	if ((m_bShadowsSupported) && (m_bShadows) && (commands.viewCount > 1))
+	{
+		UniformCache::SHADOW_BLOCK shadows;
+
+		m_shadowMaps.GetShadowData(shadows);
+		if (viewIndex > 0)
+		{
+			shadows.cascadeCount = 0;
+		}
+		m_pUniformCache->SetShadowData(shadows);
+	}
+
+	if ((m_frameView.viewportWidth > 0) && (m_frameView.viewportHeight > 0))
+	{
+		glViewport(
+			m_frameView.viewportX,
+			m_frameView.viewportY,
+			m_frameView.viewportWidth,
+			m_frameView.viewportHeight);
+	}
+
+	UpdateLightClusters();
+
+	// the opaque instances are culled by the compute shader and
+	// drawn first, the rest still go through the render queue
+	if (IsCullingOnGpu())
+	{
+		// the draws of the last view read the commands and instances
+		// the compute shader writes again for this one
+		if (viewIndex > 0)
+		{
+			glMemoryBarrier(GL_SHADER_STORAGE_BARRIER_BIT | GL_COMMAND_BARRIER_BIT);
+		}
+		DispatchGpuCulling();
+		WaitForFrameCommands(commands);
+		SubmitGpuCulledDraws();
+		SubmitIndirectDraws();
+	}
+	else if (IsDrawingIndirect())
+	{
+		WaitForFrameCommands(commands);
+		SubmitIndirectDraws();
+	}
+	else
+	{
+		WaitForFrameCommands(commands);
+		SubmitRenderQueue();
+	}
+}
+
+/***********************************************************
+ *  SetFrameProfiler()
+ *
+ *  This method is used for setting the profiler that the
+ *  object groups are measured with when rendering.
+ ***********************************************************/
+void SceneManager::SetFrameProfiler(FrameProfiler* pFrameProfiler)
+{
+	m_pFrameProfiler = pFrameProfiler;
+}
+
+/***********************************************************
+ *  SetGroupProfiling()
+ *
+ *  This method is used for keeping the draws of each object
+ *  group together, so the profiler can measure every group
+ *  as its own scope.  This costs some extra state changes,
+ *  so it is off unless the groups are being measured.
+ ***********************************************************/
+void SceneManager::SetGroupProfiling(bool bProfileGroups)
+{
+	m_bProfileGroups = bProfileGroups;
+}
+
+/***********************************************************
+ *  SetViewParameters()
+ *
+ *  This method is used for setting the view and projection
+ *  matrices and the camera position of a view of the frame,
+ *  which are used for culling and for ordering the draws by
+ *  depth.  The camera of the first view also decides which
+ *  cells are streamed in and where the shadows are fit.
+ ***********************************************************/
+void SceneManager::SetViewParameters(
+	int viewIndex,
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	const glm::vec3& viewPosition)
+{
+	if ((viewIndex < 0) || (viewIndex >= MAX_VIEWS))
+	{
+		return;
+	}
+
+	SCENE_VIEW& sceneView = m_sceneViews[viewIndex];
+	sceneView.view = view;
+	sceneView.projection = projection;
+	sceneView.viewPosition = viewPosition;
+
+	sceneView.frustum.SetViewProjection(projection * view);
+}
+
+/***********************************************************
+ *  SetViewCount()
+ *
+ *  This method is used for setting the number of views the
+ *  scene is rendered into each frame, the first views whose
+ *  parameters and viewports are set.
+ ***********************************************************/
+void SceneManager::SetViewCount(int viewCount)
+{
+	m_viewCount = std::min(std::max(viewCount, 1), (int)MAX_VIEWS);
+}
+
+/***********************************************************
+ *  SetObjectTransform()
+ *
+ *  This method is used for moving a scene object after the
+ *  scene has been prepared, to the passed in world matrix.
+ *  The instance and its bounds are updated right away, and
+ *  the hierarchy is refit once before the next frame no
+ *  matter how many objects moved.  The transform node of the
+ *  object is moved along, so it still follows its parent
+ *  node afterwards.
+ ***********************************************************/
+void SceneManager::SetObjectTransform(int objectIndex, const glm::mat4& model)
+{
+	if ((objectIndex < 0) || (objectIndex >= m_objectInstanceIndices.size()))
+	{
+		return;
+	}
+
+	MoveSceneObject(objectIndex, model);
+	m_transformHierarchy.SetWorldTransform(m_objectNodes[objectIndex], model);
+}
+
+/***********************************************************
+ *  MoveSceneObject()
+ *
+ *  This method is used for moving the instance and bounds of
+ *  a scene object to a world matrix.
+ ***********************************************************/
+void SceneManager::MoveSceneObject(int objectIndex, const glm::mat4& model)
+{
+	int instanceIndex = m_objectInstanceIndices[objectIndex];
+	SCENE_OBJECT& object = m_sceneObjects[objectIndex];
+
+	object.model = model;
+	m_instanceData[instanceIndex].model = model;
+	m_instanceBounds[instanceIndex] = Frustum::TransformBox(m_meshBounds[object.mesh], model);
+
+	MarkInstanceMoved(instanceIndex);
+}
+
+/***********************************************************
+ *  MarkInstanceMoved()
+ *
+ *  This method is used for listing a moved instance once,
+ *  so only the moved instances are refit and uploaded before
+ *  the next frame, and for taking it out of the cached
+ *  static shadows for good, so it is drawn over them every
+ *  frame.
+ ***********************************************************/
+void SceneManager::MarkInstanceMoved(int instanceIndex)
+{
+	m_bBoundsDirty = true;
+	if (!m_instanceMoved[instanceIndex])
+	{
+		m_instanceMoved[instanceIndex] = true;
+		m_movedInstances.push_back(instanceIndex);
+	}
+
+	if (!m_instanceDynamic[instanceIndex])
+	{
+		m_instanceDynamic[instanceIndex] = true;
+		m_dynamicInstanceCount++;
+		m_shadowMaps.InvalidateStatic();
+	}
+}
+
+/***********************************************************
+ *  SetObjectTransforms()
+ *
+ *  This method is used for moving many scene objects at
+ *  once, with the transformation values of the passed in
+ *  batch in the same order as the objects.  The matrices
+ *  are composed by the SIMD kernels straight into the
+ *  instances, and the bounds are then updated the same as
+ *  for SetObjectTransform(), with the objects split across
+ *  the worker threads.  Every object may be in the list
+ *  only once.
+ ***********************************************************/
+void SceneManager::SetObjectTransforms(const std::vector<int>& objectIndices, const TransformBatch& transforms)
+{
+	if (transforms.GetCount() < objectIndices.size())
+	{
+		std::cout << "Transform batch is smaller than the objects it moves:" << transforms.GetCount() << std::endl;
+		return;
+	}
+
+	m_transformInstances.resize(objectIndices.size());
+	for (int i = 0; i < objectIndices.size(); i++)
+	{
+		if ((objectIndices[i] < 0) || (objectIndices[i] >= m_objectInstanceIndices.size()))
+		{
+			std::cout << "Transform batch moves an unknown object:" << objectIndices[i] << std::endl;
+			return;
+		}
+		m_transformInstances[i] = m_objectInstanceIndices[objectIndices[i]];
+	}
+
+	// smallest number of objects moved by one job
+	const int minRangeSize = 1024;
+	JobSystem::JOB_GROUP transformJobs;
+
+	m_pJobSystem->ParallelFor(transformJobs, objectIndices.size(), minRangeSize,
+		[this, &objectIndices, &transforms](int first, int count) {
+			// the model matrix is the first member of every instance
+			transforms.Compose(first, count, m_instanceData.data(), sizeof(INSTANCE_DATA), m_transformInstances.data());
+
+			for (int i = first; i < first + count; i++)
+			{
+				int instanceIndex = m_transformInstances[i];
+				SCENE_OBJECT& object = m_sceneObjects[objectIndices[i]];
+
+				object.model = m_instanceData[instanceIndex].model;
+				m_instanceBounds[instanceIndex] = Frustum::TransformBox(m_meshBounds[object.mesh], object.model);
+			}
+		});
+	m_pJobSystem->Wait(transformJobs);
+
+	for (int i = 0; i < m_transformInstances.size(); i++)
+	{
+		MarkInstanceMoved(m_transformInstances[i]);
+		m_transformHierarchy.SetWorldTransform(m_objectNodes[objectIndices[i]], m_instanceData[m_transformInstances[i]].model);
+	}
+}
+
+/***********************************************************
+ *  GetObjectNode()
+ *
+ *  This method is used for getting the transform node that
+ *  a scene object is placed by, or -1 for an unknown object.
+ *  The parent of the node is the node the object was added
+ *  below, such as the node of a compound prop.
+ ***********************************************************/
+int SceneManager::GetObjectNode(int objectIndex) const
+{
+	if ((objectIndex < 0) || (objectIndex >= m_objectNodes.size()))
+	{
+		return(-1);
+	}
+
+	return(m_objectNodes[objectIndex]);
+}
+
+/***********************************************************
+ *  GetNodeParent()
+ *
+ *  This method is used for getting the parent of a transform
+ *  node, or -1 for a root node or an unknown node.
+ ***********************************************************/
+int SceneManager::GetNodeParent(int nodeIndex) const
+{
+	if ((nodeIndex < 0) || (nodeIndex >= m_transformHierarchy.GetNodeCount()))
+	{
+		return(-1);
+	}
+
+	return(m_transformHierarchy.GetNode(nodeIndex).parent);
+}
+
+/***********************************************************
+ *  SetNodeTransform()
+ *
+ *  This method is used for setting the local transform of a
+ *  transform node, relative to its parent.  The node is only
+ *  marked dirty here, and before the next frame the world
+ *  matrices of the node and of every node below it are
+ *  recomputed and their objects are moved, so moving a
+ *  compound prop is one call however many parts it has.
+ ***********************************************************/
+void SceneManager::SetNodeTransform(int nodeIndex, const glm::mat4& local)
+{
+	m_transformHierarchy.SetLocalTransform(nodeIndex, local);
+}
+
+/***********************************************************
+ *  UpdateTransformHierarchy()
+ *
+ *  This method is used for recomputing the world matrices of
+ *  the transform nodes that were marked dirty and the nodes
+ *  below them, and moving their objects.  Nothing is done
+ *  for the nodes that did not change.
+ ***********************************************************/
+void SceneManager::UpdateTransformHierarchy()
+{
+	if (!m_transformHierarchy.HasDirtyNodes())
+	{
+		return;
+	}
+
+	m_transformHierarchy.Update(m_changedNodes);
+	for (int i = 0; i < m_changedNodes.size(); i++)
+	{
+		const TransformHierarchy::TRANSFORM_NODE& node = m_transformHierarchy.GetNode(m_changedNodes[i]);
+
+		if ((node.object >= 0) && (node.object < m_objectInstanceIndices.size()))
+		{
+			MoveSceneObject(node.object, node.world);
+		}
+	}
+}
+
+/***********************************************************
+ *  UpdateMovedInstances()
+ *
+ *  This method is used for refitting the bounding volume
+ *  hierarchy above the instances that moved since the last
+ *  frame, and uploading their culling values to the GPU.
+ *  The moved instances are sorted by their place in the
+ *  cull buffer and uploaded in runs, with small gaps joined
+ *  into one run, so a few moved objects never upload the
+ *  whole buffer.  When cells were streamed in or out every
+ *  instance is uploaded, since their draw commands changed.
+ ***********************************************************/
+void SceneManager::UpdateMovedInstances()
+{
+	// instances between two moved instances that are uploaded
+	// with them rather than starting a new run
+	const int maxUploadGap = 8;
+
+	if (m_bBoundsDirty)
+	{
+		m_sceneBVH.RefitItems(m_movedInstances, m_instanceBounds);
+	}
+
+	if ((m_bResidencyDirty) && (m_bGpuCullingSupported))
+	{
+		GetGpuCullInstances(0, m_gpuCullInstances.size(), m_cullUploads);
+		m_gpuCulling.UpdateInstances(m_cullUploads);
+	}
+	else if ((!m_movedInstances.empty()) && (m_bGpuCullingSupported))
+	{
+		m_movedCullIndices.clear();
+		for (int i = 0; i < m_movedInstances.size(); i++)
+		{
+			if (m_instanceCullIndices[m_movedInstances[i]] >= 0)
+			{
+				m_movedCullIndices.push_back(m_instanceCullIndices[m_movedInstances[i]]);
+			}
+		}
+		std::sort(m_movedCullIndices.begin(), m_movedCullIndices.end());
+
+		for (int i = 0; i < m_movedCullIndices.size(); )
+		{
+			int first = m_movedCullIndices[i];
+			int last = first;
+
+			for (i++; (i < m_movedCullIndices.size()) && (m_movedCullIndices[i] - last <= maxUploadGap); i++)
+			{
+				last = m_movedCullIndices[i];
+			}
+
+			GetGpuCullInstances(first, last - first + 1, m_cullUploads);
+			m_gpuCulling.UpdateInstanceRange(first, m_cullUploads);
+		}
+	}
+
+	for (int i = 0; i < m_movedInstances.size(); i++)
+	{
+		m_instanceMoved[m_movedInstances[i]] = false;
+	}
+	m_movedInstances.clear();
+	m_bBoundsDirty = false;
+	m_bResidencyDirty = false;
+}
+
+/***********************************************************
+ *  PickObject()
+ *
+ *  This method is used for getting the nearest scene object
+ *  whose bounds are hit by a ray, along with the distance to
+ *  the hit.  The objects are picked by their bounding boxes,
+ *  so a ray passing close to a round mesh can still pick it.
+ ***********************************************************/
+int SceneManager::PickObject(const glm::vec3& origin, const glm::vec3& direction, float& distance) const
+{
+	const float maxDistance = 1000.0f;
+	int instanceIndex = -1;
+
+	if (!m_sceneBVH.Raycast(origin, direction, maxDistance, instanceIndex, distance))
+	{
+		return(-1);
+	}
+
+	return(m_instanceObjectIndices[instanceIndex]);
+}
+
+/***********************************************************
+ *  QueryObjectsInRange()
+ *
+ *  This method is used for getting the scene objects whose
+ *  bounds are within range of a point, like the objects that
+ *  a point light reaches.
+ ***********************************************************/
+void SceneManager::QueryObjectsInRange(const glm::vec3& position, float range, std::vector<int>& objects) const
+{
+	std::vector<int> instances;
+
+	m_sceneBVH.QuerySphere(position, range, instances);
+
+	objects.clear();
+	for (int i = 0; i < instances.size(); i++)
+	{
+		objects.push_back(m_instanceObjectIndices[instances[i]]);
+	}
+}
+
+/***********************************************************
+ *  GetObjectGroupName()
+ *
+ *  This method is used for getting the name of the group a
+ *  scene object was added to.
+ ***********************************************************/
+const char* SceneManager::GetObjectGroupName(int objectIndex) const
+{
+	if ((objectIndex < 0) || (objectIndex >= m_sceneObjects.size()))
+	{
+		return("");
+	}
+
+	return(m_objectGroups[m_sceneObjects[objectIndex].group]);
+}
+
+/***********************************************************
+ *  SetViewport()
+ *
+ *  This method is used for setting the part of the render
+ *  target a view is rendered into, in pixels from the lower
+ *  left corner, which the screen size of the objects in the
+ *  view is measured in.
+ ***********************************************************/
+void SceneManager::SetViewport(int viewIndex, int x, int y, int width, int height)
+{
+	if ((viewIndex < 0) || (viewIndex >= MAX_VIEWS))
+	{
+		return;
+	}
+
+	m_sceneViews[viewIndex].viewportX = x;
+	m_sceneViews[viewIndex].viewportY = y;
+	m_sceneViews[viewIndex].viewportWidth = width;
+	m_sceneViews[viewIndex].viewportHeight = height;
+}
+
+/***********************************************************
+ *  SetDetailCulling()
+ *
+ *  This method is used for setting the smallest radius in
+ *  pixels that an object has to cover on screen to be drawn.
+ *  A radius of 0 draws every object no matter its size.
+ ***********************************************************/
+void SceneManager::SetDetailCulling(float minScreenRadius)
+{
+	m_minScreenRadius = minScreenRadius;
+}
+
+/***********************************************************
+ *  SetIndirectDraws()
+ *
+ *  This method is used for turning the indirect multi-draws
+ *  on and off.  They are only used when the driver and the
+ *  shader support them, and the frame is drawn one object at
+ *  a time otherwise.
+ ***********************************************************/
+void SceneManager::SetIndirectDraws(bool bIndirectDraws)
+{
+	m_bIndirectDraws = bIndirectDraws;
+}
+
+/***********************************************************
+ *  SetGpuCulling()
+ *
+ *  This method is used for turning the compute shader
+ *  culling on and off.  It is only used while the frame is
+ *  drawn with indirect multi-draws, and the instances are
+ *  culled on the CPU otherwise.
+ ***********************************************************/
+void SceneManager::SetGpuCulling(bool bGpuCulling)
+{
+	m_bGpuCulling = bGpuCulling;
+}
+
+/***********************************************************
+ *  SetClusteredLighting()
+ *
+ *  This method is used for switching the shader between the
+ *  clustered point lights and the point lights of the light
+ *  block, for comparing the two.
+ ***********************************************************/
+void SceneManager::SetClusteredLighting(bool bClusteredLighting)
+{
+	m_bClusteredLighting = bClusteredLighting;
+
+	if (m_bClusteredLightingSupported)
+	{
+		m_pUniformCache->setBoolValue(UniformCache::UNIFORM_USE_CLUSTERED_LIGHTS, m_bClusteredLighting);
+	}
+}
+
+/***********************************************************
+ *  SetShadows()
+ *
+ *  This method is used for turning the shadows on and off,
+ *  for comparing the frame times with and without them.  The
+ *  cached maps are kept while the shadows are off.
+ ***********************************************************/
+void SceneManager::SetShadows(bool bShadows)
+{
+	m_bShadows = bShadows;
+
+	if (m_bShadowsSupported)
+	{
+		m_pUniformCache->setBoolValue(UniformCache::UNIFORM_USE_SHADOWS, m_bShadows);
+	}
+}
+
+/***********************************************************
+ *  SetFramePipelining()
+ *
+ *  This method is used for drawing the command list that
+ *  was prepared during the last frame while the workers
+ *  prepare the list of this frame, so the preparation of a
+ *  frame overlaps the whole submission of the frame before
+ *  it.  The frame is drawn with the view it was culled for,
+ *  which shows the camera one frame late.  When it is off,
+ *  the list only overlaps the lights and shadows of its own
+ *  frame.
+ ***********************************************************/
+void SceneManager::SetFramePipelining(bool bFramePipelining)
+{
+	m_bFramePipelining = bFramePipelining;
+}
+
+/***********************************************************
+ *  SetStreamingBudget()
+ *
+ *  This method is used for setting the bytes of texture
+ *  memory that the streamed in cells can use.  The farthest
+ *  cells are evicted while the textures use more than this.
+ ***********************************************************/
+void SceneManager::SetStreamingBudget(size_t memoryBudget)
+{
+	m_worldStreamer.SetMemoryBudget(memoryBudget);
+}
+
+/***********************************************************
+ *  IsStreaming()
+ *
+ *  This method is used for checking whether the scene is
+ *  streamed in cells around the camera.
+ ***********************************************************/
+bool SceneManager::IsStreaming() const
+{
+	return(m_bStreaming);
+}
+
+/***********************************************************
+ *  SetFrustumCulling()
+ *
+ *  This method is used for turning the skipping of objects
+ *  outside the view frustum on or off.
+ ***********************************************************/
+void SceneManager::SetFrustumCulling(bool bFrustumCulling)
+{
+	m_bFrustumCulling = bFrustumCulling;
+}
+
+/***********************************************************
+ *  GetRenderStatistics()
+ *
+ *  This method is used for getting the counts of the draw
+ *  calls and state changes of the last rendered frame.
+ ***********************************************************/
+const SceneManager::RENDER_STATISTICS& SceneManager::GetRenderStatistics() const
+{
+	return(m_renderStatistics);
+}
+
+/***********************************************************
+ *  IsLoadingTextures()
+ *
+ *  This method is used for checking whether any textures
+ *  are still showing their placeholder while their images
+ *  are being loaded.
+ ***********************************************************/
+bool SceneManager::IsLoadingTextures() const
+{
+	return(m_bTexturesPending);
+}
+
+/***********************************************************
+ *  IsSceneChanging()
+ *
+ *  This method is used for checking whether the next frame
+ *  can look different from the last one even though the
+ *  view stays the same, because textures are still being
+ *  loaded, streamed cells are still coming in or going out,
+ *  or objects were moved since the last frame.
+ ***********************************************************/
+bool SceneManager::IsSceneChanging() const
+{
+	return(m_bTexturesPending ||
+		m_bBoundsDirty ||
+		m_transformHierarchy.HasDirtyNodes() ||
+		(m_bStreaming && (!m_worldStreamer.IsSettled())));
+}
+
+//-------------------------------------------------------------------------------------------------------------------MODIFY CODE BELOW-------------------------------------------
+// _________________________________________________________ADDED CODE BY STUDENT - MAX _______________________________________________________THIS IS HERE FOR DETECTABILITY-----
+
+
+ /***********************************************************
+  *  DefineObjectMaterials()
+  *
+  *  This method is used for configuring the various material
+  *  settings for all of the objects within the 3D scene.
+  ***********************************************************/
+void SceneManager::DefineObjectMaterials()
+{
+	/*** STUDENTS - add the code BELOW for defining object materials. ***/
+	/*** There is no limit to the number of object materials that can ***/
+	/*** be defined. Refer to the code in the OpenGL Sample for help  ***/
+	OBJECT_MATERIAL whiteMat;
+	whiteMat.diffuseColor = glm::vec3(1.0f, 1.0f, 1.0f);
+	whiteMat.specularColor = glm::vec3(0.4f, 0.4f, 0.4f);
+	whiteMat.shininess = 32.0f;
+	whiteMat.tag = "default";
+
+	m_objectMaterials.push_back(whiteMat);
+
+}
+
+/***********************************************************
+ *  SetupSceneLights()
+ *
+ *  This method is called to add and configure the light
+ *  sources for the 3D scene.  There are up to 4 light sources.
+ ***********************************************************/
+void SceneManager::SetupSceneLights()
+{
+	// all of the lights start zeroed and disabled
+	UniformCache::LIGHT_BLOCK lights = {};
+
+	// Enable lighting
+	m_pUniformCache->setBoolValue(UniformCache::UNIFORM_USE_LIGHTING, true);
+
+	// Bright directional light to simulate daylight from the kitchen window
+	lights.directionalLight.direction = glm::vec4(-0.3f, -1.0f, -0.3f, 0.0f);
+	lights.directionalLight.ambient = glm::vec4(0.2f, 0.2f, 0.2f, 0.0f);    // was 0.4
+	lights.directionalLight.diffuse = glm::vec4(0.5f, 0.5f, 0.5f, 0.0f);    // was 0.9
+	lights.directionalLight.specular = glm::vec4(0.7f, 0.7f, 0.7f, 0.0f);   // was 1.0
+	lights.directionalLight.bActive = true;
+
+	// Warm overhead point light to soften the shadows, pancakes must look stacked
+	lights.pointLights[0].position = glm::vec4(0.0f, 5.0f, 1.0f, 1.0f);
+	lights.pointLights[0].ambient = glm::vec4(0.1f, 0.09f, 0.08f, 0.0f);    // was 0.2
+	lights.pointLights[0].diffuse = glm::vec4(0.6f, 0.5f, 0.4f, 0.0f);      // was 0.8
+	lights.pointLights[0].specular = glm::vec4(0.4f, 0.3f, 0.2f, 0.0f);     // was 0.9
+	lights.pointLights[0].bActive = true;
+	AddClusterLight(lights.pointLights[0], g_DefaultLightRange);
+
+	// upload all of the lights at once
+	m_sceneLights = lights;
+	m_pUniformCache->SetLightData(lights);
+
+}
+
+
+/***********************************************************
+ *  StartTextureLoading()
+ *
+ *  This method is used for starting the worker threads that
+ *  decode the texture images, leaving one core for the
+ *  render loop, and for staging the uploads in persistently
+ *  mapped pixel buffers when supported - any image larger
+ *  than 2048x2048 RGBA is uploaded directly.
+ ***********************************************************/
+void SceneManager::StartTextureLoading()
+{
+	int workerCount = std::max((int)std::thread::hardware_concurrency() - 1, 1);
+	m_pTextureLoader->StartWorkers(workerCount);
+	m_pTextureLoader->CreateStagingBuffer(2048 * 2048 * 4);
+}
+
+/***********************************************************
+ *  LoadSceneTextures()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene
+ *  rendering
+ ***********************************************************/
+void SceneManager::LoadSceneTextures()
+{
+	bool bReturn = false;
+
+	StartTextureLoading();
+
+
+
+	bReturn = CreateGLTexture(
+		"textures/marble.png",
+		"marbleFloor");
+
+	bReturn = CreateGLTexture(
+		"textures/berry.jpg",
+		"berry");
+
+	bReturn = CreateGLTexture(
+		"textures/pancake_face.jpg",
+		"pancakeFace");
+
+	bReturn = CreateGLTexture(
+		"textures/brickWall.png",
+		"brick");
+
+	//Bind to GPU
+	BindGLTextures();
+
+}
+
+/***********************************************************
+ *  PrepareScene()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering
+ ***********************************************************/
+void SceneManager::PrepareScene()
+{
+	// the scene comes from the compiled scene file when there
+	// is one, and is built by the code below otherwise
+	bool bSceneFile = (0 == m_syntheticObjectCount) && LoadSceneFile();
+
+	if (!bSceneFile)
+	{
+		//Call textures for loading
+		LoadSceneTextures();
+		// define the materials for objects in the scene
+		DefineObjectMaterials();
+		RegisterMaterials();
+		// add and define the light sources for the scene
+		SetupSceneLights();
+	}
+
+	// only one instance of a particular mesh needs to be
+	// loaded in memory no matter how many times it is drawn
+	// in the rendered 3D scene
+
+	m_basicMeshes->LoadPlaneMesh();
+	m_basicMeshes->LoadConeMesh();
+	m_basicMeshes->LoadCylinderMesh();
+	m_basicMeshes->LoadPrismMesh();
+	m_basicMeshes->LoadTorusMesh();
+	m_basicMeshes->LoadSphereMesh();
+	m_basicMeshes->LoadTaperedCylinderMesh();
+	m_basicMeshes->LoadPyramid3Mesh();
+
+	// resolve the transformations, textures and materials
+	// for every object once, instead of every frame
+	if (m_syntheticObjectCount > 0)
+	{
+		BuildSyntheticObjects();
+	}
+	else if (!bSceneFile)
+	{
+		BuildSceneObjects();
+	}
+	// group the objects that repeat the same mesh
+	BuildInstanceBatches();
+
+	// the data uploaded every frame is written straight into
+	// mapped memory, when the driver can map persistently
+	m_dynamicBuffer.Create(g_DynamicRegionSize);
+	// the objects drawn one by one bind their values as records
+	// of the same buffer, instead of setting them as uniforms
+	m_bDrawBlockSupported = FindDrawBlock();
+	if (m_bDrawBlockSupported)
+	{
+		m_pUniformCache->setBoolValue(UniformCache::UNIFORM_USE_DRAW_BLOCK, false);
+	}
+	// the levels of detail are dithered into each other when the
+	// shader reads the fade, and switched at once otherwise
+	m_bLodFadeSupported = m_pUniformCache->HasUniform(UniformCache::UNIFORM_LOD_FADE);
+	if (m_bLodFadeSupported)
+	{
+		m_pUniformCache->setFloatValue(UniformCache::UNIFORM_LOD_FADE, 0.0f);
+	}
+
+	// pack the meshes into shared buffers so the whole frame
+	// can be drawn with a few indirect multi-draws, the
+	// imported meshes are only found in the shared buffers
+	if (MeshBuffer::IsSupported() &&
+		((m_pUniformCache->HasUniform(UniformCache::UNIFORM_USE_INSTANCE_BUFFER)) || (!m_meshFiles.empty())))
+	{
+		BuildMeshBuffer();
+		CreateIndirectBuffers();
+	}
+	else if (!m_meshFiles.empty())
+	{
+		std::cout << "Imported meshes can not be drawn without the shared mesh buffer" << std::endl;
+	}
+	CloseMeshFiles();
+
+	// cull the opaque instances of the indirect draws with a
+	// compute shader, the macOS 3.3 context culls on the CPU
+	if (m_bIndirectSupported && GpuCulling::IsSupported() &&
+		m_gpuCulling.Initialize(INSTANCE_BLOCK_BINDING))
+	{
+		BuildGpuCullingLayout();
+		m_bGpuCullingSupported = true;
+	}
+
+	// shade any number of point lights by binning them into
+	// view space clusters, when the shader reads them from there
+	CreateLightClusters();
+
+	// shadow the directional and point lights, when the shader
+	// samples the shadow maps
+	CreateShadowMaps();
+}
+
+/***********************************************************
+ *  BuildSceneObjects()
+ *
+ *  This method is used for building the retained draw list
+ *  by transforming, texturing and coloring the basic 3D
+ *  shapes once, before the scene is rendered
+ ***********************************************************/
+void SceneManager::BuildSceneObjects()
+{
+	// the draw list and its transform nodes are rebuilt from scratch
+	m_sceneObjects.clear();
+	m_transformHierarchy.Clear();
+	m_objectNodes.clear();
+	m_openNodes.clear();
+
+	/*** Set needed transformations before drawing the basic mesh.  ***/
+	/*** This same ordering of code should be used for transforming ***/
+	/*** and drawing all the basic 3D shapes.						***/
+	/******************************************************************/
+	BeginObjectGroup("Counter");
+	//Marble counter is tiled
+	AddTexturedObject(
+		MESH_PLANE,
+		glm::vec3(20.0f, 1.0f, 10.0f),
+		0.0f, 0.0f, 0.0f,
+		glm::vec3(0.0f, 0.0f, 0.0f),
+		"marbleFloor",
+		glm::vec2(5.0f, 5.0f),
+		"default");
+
+	BeginObjectGroup("Wall");
+	//Start construction of backwall item, brick wall scaling
+	AddTexturedObject(
+		MESH_PLANE,
+		glm::vec3(20.0f, 1.0f, 10.0f),
+		90.0f, 0.0f, 0.0f,
+		glm::vec3(0.0f, 5.0f, -8.0f),
+		"brick",
+		glm::vec2(2.0f, 2.0f),
+		"default");
+
+	/****************************************************************/
+
+
+	BeginObjectGroup("Plate");
+	// ======================= PLATE BASE ==================================
+
+	glm::vec3 plateScale = glm::vec3(7.0f, 0.2f, 7.0f); // Wide and thin
+	glm::vec3 platePosition = glm::vec3(0.0f, 0.1f, 0.0f); // Just above floor
+	// Optional: Use a white glossy ceramic color
+	AddColoredObject(
+		MESH_TAPERED_CYLINDER, // Plate body
+		plateScale,
+		0.0f, 0.0f, 0.0f,
+		platePosition,
+		glm::vec4(0.90f, 0.90f, 0.90f, 1.0f), // near-white
+		"default");
+
+	BeginObjectGroup("Pancakes");
+	// Function to create stack of pancake objects - Makes a pancake with a cylindermesh, then adds torus to end to make the pancake shaped properly
+	for (int i = 0; i < 6; ++i) { // Number of pancakes = i
+		float yHeight = 0.3f + (i * 0.35f);  //Height by the number of pancakes
+		glm::vec3 scaleXYZ = glm::vec3(5.0f, 0.3f, 5.0f); // XYZ Scale to make all pancakes wide and flat
+		glm::vec3 positionXYZ = glm::vec3(0.0f, yHeight, 0.0f);
+
+		//Draws the Cylinder to the values, above then continues to the torus shape below
+		AddTexturedObject(
+			MESH_CYLINDER,
+			scaleXYZ,
+			0.0f, 0.0f, 0.0f, //No XYZ rotationdegress needed
+			positionXYZ,
+			"pancakeFace",
+			glm::vec2(1.0f, 1.0f),
+			"default");
+
+		glm::vec3 ringScale = glm::vec3(4.4f, 4.4f, 0.9f);  // Scaled all the same, wife and flat with slight curve on the depth for thickness
+		glm::vec3 ringPosition = glm::vec3(0.0f, yHeight, 0.0f);  // Applied with the number of pancakes, on each pancake
+
+		//Draws the torus and continues loop to next pancake
+		AddTexturedObject(
+			MESH_TORUS,
+			ringScale,
+			90.0f, 0.0f, 0.0f, //Applied to lay down torus flat
+			ringPosition,
+			"pancakeFace",
+			glm::vec2(1.0f, yHeight),
+			"default");
+	}
+
+	BeginObjectGroup("Juice");
+	// ====================== ORANGE JUICE (Tapered Cylinder) ========================
+
+	glm::vec3 glassScale = glm::vec3(1.2f, 2.8f, 1.2f); // tall and narrow
+	glm::vec3 glassPosition = glm::vec3(8.0f, 3.0f, 0.0f); // just to the right of pancakes
+	AddColoredObject(
+		MESH_TAPERED_CYLINDER,
+		glassScale,
+		180.0f, 0.0f, 0.0f,
+		glassPosition,
+		glm::vec4(1.0f, 0.65f, 0.0f, 1.0f), // true orange, semi-transparent
+		"default");
+
+
+	BeginObjectGroup("Glass");
+	// ====================== GLASS BASE (Tapered Cylinder) ========================
+
+	glm::vec3 juiceScale = glm::vec3(1.4f, 3.0f, 1.4f); // slightly smaller than glass
+	glm::vec3 juicePosition = glm::vec3(8.0f, 3.25f, 0.0f); // inside the cup
+	AddColoredObject(
+		MESH_TAPERED_CYLINDER,
+		juiceScale,
+		180.0f, 0.0f, 0.0f,
+		juicePosition,
+		glm::vec4(0.9f, 0.9f, 1.0f, 0.2f),  // light bluish glass with high transparency
+		"glass"); // use basic speculars
+
+	// ---------------------BERRIES ----------------------------------BERRIES -----------------------------------BERRIES ----------------------------
+	
+	BeginObjectGroup("Bottle");
+	// ====================== EMPTY CLEAR BOTTLE ========================
+	glm::vec4 bottleColor = glm::vec4(0.9f, 0.9f, 1.0f, 0.2f);  // light bluish glass with high transparency
+
+	// the parts of the bottle are placed relative to its base,
+	// so the whole bottle moves with one node
+	BeginObjectNode(
+		glm::vec3(1.0f, 1.0f, 1.0f),
+		0.0f, 0.0f, 0.0f,
+		glm::vec3(6.0f, 0.9f, -1.8f));  // shifted back near the glass
+
+	// ---- Bottom Half Sphere (base of bottle) ----
+	AddColoredObject(
+		MESH_HALF_SPHERE,
+		glm::vec3(0.9f, 0.3f, 0.9f),
+		0.0f, 0.0f, 180.0f,
+		glm::vec3(0.0f, 0.0f, 0.0f),
+		bottleColor,
+		"glass"); // use basic speculars
+
+	// ---- Main Cylinder (body of bottle) ----
+	AddColoredObject(
+		MESH_CYLINDER,
+		glm::vec3(0.9f, 4.0f, 0.9f),
+		0.0f, 0.0f, 0.0f,
+		glm::vec3(0.0f, 0.0f, 0.0f),
+		bottleColor,
+		"glass");
+
+	// ---- Rounded Top Half Sphere ----
+	AddColoredObject(
+		MESH_HALF_SPHERE,
+		glm::vec3(0.905f, 0.9f, 0.905f),
+		0.0f, -6.0f, 0.0f,
+		glm::vec3(0.0f, 4.0f, 0.0f),
+		bottleColor,
+		"glass");
+
+	// ---- Top Neck Cylinder ----
+	AddColoredObject(
+		MESH_CYLINDER,
+		glm::vec3(0.3f, 2.0f, 0.3f),
+		0.0f, 0.0f, 0.0f,
+		glm::vec3(0.0f, 4.7f, 0.0f),
+		bottleColor,
+		"glass");
+
+	// ---- Cap Ring (Torus) ----
+	AddColoredObject(
+		MESH_TORUS,
+		glm::vec3(0.32f, 0.32f, 1.5f),
+		90.0f, 0.0f, 0.0f,
+		glm::vec3(0.0f, 6.5f, 0.0f),
+		bottleColor,
+		"glass");
+
+	// ---- Bottle Rim (Torus) ----
+	AddColoredObject(
+		MESH_TORUS,
+		glm::vec3(0.28f, 0.28f, 0.4f),
+		90.0f, 0.0f, 0.0f,
+		glm::vec3(0.0f, 6.7f, 0.0f),
+		bottleColor,
+		"glass");
+
+	EndObjectNode();
+
+	BeginObjectGroup("Syrup");
+	//==========================Syrup==============================
+
+	// ---- Bottom Half Sphere (base of bottle) ----
+	AddColoredObject(
+		MESH_CYLINDER,
+		glm::vec3(.91f, 2.7f, .91f),
+		0.0f, 0.0f, 180.0f,
+		glm::vec3(6.0f, 2.9f, -1.8f),  // shifted back near the glass cup
+		glm::vec4(0.35f, 0.15f, 0.05f, 1.0f), // Molasses colored Or syrup
+		"default");
+
+}
+
+/***********************************************************
+ *  SetSyntheticScene()
+ *
+ *  This method is used for replacing the scene that
+ *  PrepareScene() builds with a grid of generated objects,
+ *  so the frames can be timed at any number of objects.
+ *  The textures, materials and lights of the scene above
+ *  are still used.
+ ***********************************************************/
+void SceneManager::SetSyntheticScene(int objectCount)
+{
+	m_syntheticObjectCount = std::max(objectCount, 0);
+}
+
+/***********************************************************
+ *  BuildSyntheticObjects()
+ *
+ *  This method is used for building the retained draw list
+ *  of the generated objects.  The objects are laid out on a
+ *  square grid around the middle of the scene, cycling
+ *  through the basic meshes, and every other object is
+ *  textured, so the batches, culling and sorting see a mix
+ *  like a real scene.
+ ***********************************************************/
+void SceneManager::BuildSyntheticObjects()
+{
+	// the meshes and textures the objects cycle through
+	const MESH_TYPE meshes[] =
+	{
+		MESH_SPHERE, MESH_CYLINDER, MESH_CONE, MESH_TORUS,
+		MESH_PRISM, MESH_TAPERED_CYLINDER, MESH_PYRAMID3
+	};
+	const char* textures[] = { "marbleFloor", "berry", "pancakeFace", "brick" };
+	const int meshCount = sizeof(meshes) / sizeof(meshes[0]);
+	const int textureCount = sizeof(textures) / sizeof(textures[0]);
+	// distance between the objects of the grid
+	const float spacing = 2.0f;
+
+	m_sceneObjects.clear();
+	m_transformHierarchy.Clear();
+	m_objectNodes.clear();
+	m_openNodes.clear();
+
+	int side = (int)ceil(sqrt((double)m_syntheticObjectCount));
+	float offset = (side - 1) * spacing * 0.5f;
+
+	BeginObjectGroup("Synthetic");
+	for (int i = 0; i < m_syntheticObjectCount; i++)
+	{
+		glm::vec3 position((i % side) * spacing - offset, 0.5f, (i / side) * spacing - offset);
+		MESH_TYPE mesh = meshes[i % meshCount];
+		float rotation = (float)((i * 37) % 360);
+
+		if ((i % 2) == 0)
+		{
+			AddTexturedObject(
+				mesh,
+				glm::vec3(0.5f),
+				0.0f, rotation, 0.0f,
+				position,
+				textures[(i / 2) % textureCount],
+				glm::vec2(1.0f, 1.0f),
+				"default");
+		}
+		else
+		{
+			AddColoredObject(
+				mesh,
+				glm::vec3(0.5f),
+				0.0f, rotation, 0.0f,
+				position,
+				glm::vec4((i % 5) * 0.2f, (i % 3) * 0.3f, 0.8f, 1.0f),
+				"default");
+		}
+	}
+}
+
+/***********************************************************
+ *  SetSceneFile()
+ *
+ *  This method is used for setting the compiled scene file
+ *  that PrepareScene() loads.  When the file does not exist
+ *  the scene built by the code above is used instead.
+ ***********************************************************/
+void SceneManager::SetSceneFile(const char* filename)
+{
+	m_sceneFileName = filename;
+}
+
+/***********************************************************
+ *  LoadSceneFile()
+ *
+ *  This method is used for loading the textures, materials,
+ *  lights and objects of the compiled scene file.  The file
+ *  is mapped into memory and its records are used in place,
+ *  the object transformations are already combined into
+ *  model matrices and every reference is an index, so
+ *  nothing is looked up by name.  The file stays mapped
+ *  because the object group names point into it.
+ ***********************************************************/
+bool SceneManager::LoadSceneFile()
+{
+	// all of the lights start zeroed and disabled
+	UniformCache::LIGHT_BLOCK lights = {};
+	int pointLights = 0;
+	// the textures are slotted in the order of the file, after
+	// the slots of any textures created before
+	int firstTextureSlot = m_textureIDs.size();
+
+	if (!m_sceneFile.Open(m_sceneFileName.c_str()))
+	{
+		return(false);
+	}
+
+	// the materials are indexed in the order of the file
+	for (int i = 0; i < m_sceneFile.GetMaterialCount(); i++)
+	{
+		const SCENE_FILE_MATERIAL& fileMaterial = m_sceneFile.GetMaterials()[i];
+		OBJECT_MATERIAL material;
+
+		material.diffuseColor = glm::vec3(fileMaterial.diffuseColor[0], fileMaterial.diffuseColor[1], fileMaterial.diffuseColor[2]);
+		material.specularColor = glm::vec3(fileMaterial.specularColor[0], fileMaterial.specularColor[1], fileMaterial.specularColor[2]);
+		material.shininess = fileMaterial.shininess;
+		material.tag = m_sceneFile.GetString(fileMaterial.tag);
+		m_objectMaterials.push_back(material);
+	}
+	RegisterMaterials();
+
+	// the first directional and spot lights are used, and as
+	// many point lights as the shader has, every point light
+	// is shaded when the lights are clustered
+	for (int i = 0; i < m_sceneFile.GetLightCount(); i++)
+	{
+		const SCENE_FILE_LIGHT& light = m_sceneFile.GetLights()[i];
+
+		if ((SCENE_LIGHT_DIRECTIONAL == light.type) && (!lights.directionalLight.bActive))
+		{
+			lights.directionalLight.direction = glm::make_vec4(light.direction);
+			lights.directionalLight.ambient = glm::make_vec4(light.ambient);
+			lights.directionalLight.diffuse = glm::make_vec4(light.diffuse);
+			lights.directionalLight.specular = glm::make_vec4(light.specular);
+			lights.directionalLight.bActive = true;
+		}
+		else if (SCENE_LIGHT_POINT == light.type)
+		{
+			UniformCache::POINT_LIGHT_DATA pointLight = {};
+
+			pointLight.position = glm::make_vec4(light.position);
+			pointLight.ambient = glm::make_vec4(light.ambient);
+			pointLight.diffuse = glm::make_vec4(light.diffuse);
+			pointLight.specular = glm::make_vec4(light.specular);
+			pointLight.bActive = true;
+			AddClusterLight(pointLight, (light.range > 0.0f) ? light.range : g_DefaultLightRange);
+
+			if (pointLights < UniformCache::MAX_POINT_LIGHTS)
+			{
+				lights.pointLights[pointLights] = pointLight;
+				pointLights++;
+			}
+		}
+		else if ((SCENE_LIGHT_SPOT == light.type) && (!lights.spotLight.bActive))
+		{
+			lights.spotLight.position = glm::make_vec4(light.position);
+			lights.spotLight.direction = glm::make_vec4(light.direction);
+			lights.spotLight.ambient = glm::make_vec4(light.ambient);
+			lights.spotLight.diffuse = glm::make_vec4(light.diffuse);
+			lights.spotLight.specular = glm::make_vec4(light.specular);
+			lights.spotLight.cutOff = light.cutOff;
+			lights.spotLight.outerCutOff = light.outerCutOff;
+			lights.spotLight.bActive = true;
+		}
+	}
+	m_pUniformCache->setBoolValue(UniformCache::UNIFORM_USE_LIGHTING, true);
+	m_sceneLights = lights;
+	m_pUniformCache->SetLightData(lights);
+
+	m_sceneObjects.clear();
+	m_sceneObjects.reserve(m_sceneFile.GetObjectCount());
+	m_transformHierarchy.Clear();
+	m_objectNodes.clear();
+	m_openNodes.clear();
+
+	// the imported meshes follow the basic meshes, and are kept
+	// mapped until they are copied into the shared mesh buffer
+	CloseMeshFiles();
+	m_meshBounds.resize(MESH_COUNT);
+	std::vector<int> fileMeshes(m_sceneFile.GetMeshCount(), -1);
+	for (int i = 0; i < m_sceneFile.GetMeshCount(); i++)
+	{
+		const char* filename = m_sceneFile.GetString(m_sceneFile.GetMeshes()[i].file);
+		MeshFile* pMeshFile = new MeshFile();
+		Frustum::BOUNDING_BOX bounds;
+
+		if (!pMeshFile->Open(filename))
+		{
+			std::cout << "Could not load mesh file:" << filename << std::endl;
+			delete pMeshFile;
+			continue;
+		}
+
+		bounds.min = pMeshFile->GetBoundsMin() - glm::vec3(g_MeshBoundsPadding);
+		bounds.max = pMeshFile->GetBoundsMax() + glm::vec3(g_MeshBoundsPadding);
+		fileMeshes[i] = m_meshBounds.size();
+		m_meshBounds.push_back(bounds);
+		m_meshFiles.push_back(pMeshFile);
+	}
+
+	// the textures of the file get the next slots, a texture whose
+	// image file does not open gets none and its objects use their color
+	std::vector<int> fileTextures(m_sceneFile.GetTextureCount(), -1);
+	int textureSlot = firstTextureSlot;
+	for (int i = 0; i < m_sceneFile.GetTextureCount(); i++)
+	{
+		const char* filename = m_sceneFile.GetString(m_sceneFile.GetTextures()[i].file);
+
+		if (!m_pTextureLoader->IsImageAvailable(filename))
+		{
+			std::cout << "Could not load image:" << filename << std::endl;
+			continue;
+		}
+		fileTextures[i] = textureSlot++;
+	}
+
+	// the nodes of the file come before the nodes of the objects,
+	// and every parent node is before its children
+	std::vector<int> fileNodes(m_sceneFile.GetNodeCount());
+	for (int i = 0; i < m_sceneFile.GetNodeCount(); i++)
+	{
+		const SCENE_FILE_NODE& fileNode = m_sceneFile.GetNodes()[i];
+
+		fileNodes[i] = m_transformHierarchy.AddNode(
+			(fileNode.parent >= 0) ? fileNodes[fileNode.parent] : -1,
+			glm::make_mat4(fileNode.local));
+	}
+
+	for (int i = 0; i < m_sceneFile.GetObjectCount(); i++)
+	{
+		const SCENE_FILE_OBJECT& fileObject = m_sceneFile.GetObjects()[i];
+		SCENE_OBJECT object;
+
+		if (fileObject.mesh >= MESH_COUNT)
+		{
+			std::cout << "Scene file object has an unknown mesh:" << fileObject.mesh << std::endl;
+			continue;
+		}
+
+		object.mesh = fileObject.mesh;
+		if (fileObject.meshFile >= 0)
+		{
+			// an object of a mesh file that did not open is left out
+			if (fileMeshes[fileObject.meshFile] < 0)
+			{
+				continue;
+			}
+			object.mesh = fileMeshes[fileObject.meshFile];
+		}
+		object.model = AddObjectNode(
+			glm::make_mat4(fileObject.model),
+			(fileObject.node >= 0) ? fileNodes[fileObject.node] : -1);
+		object.textureSlot = (fileObject.texture >= 0) ? fileTextures[fileObject.texture] : -1;
+		object.materialIndex = fileObject.material;
+		object.color = glm::make_vec4(fileObject.color);
+		object.uvScale = glm::make_vec2(fileObject.uvScale);
+
+		// the group names are used in place from the mapped file
+		BeginObjectGroup(m_sceneFile.GetString(m_sceneFile.GetGroups()[fileObject.group].name));
+		object.group = m_currentGroup;
+
+		m_sceneObjects.push_back(object);
+	}
+
+	// a world that reaches past the load radius is streamed in
+	// cells, so its textures are only loaded once a cell needs them
+	BuildStreamingCells();
+
+	StartTextureLoading();
+	for (int i = 0; i < m_sceneFile.GetTextureCount(); i++)
+	{
+		const SCENE_FILE_TEXTURE& texture = m_sceneFile.GetTextures()[i];
+
+		if (fileTextures[i] >= 0)
+		{
+			CreateGLTexture(m_sceneFile.GetString(texture.file), m_sceneFile.GetString(texture.tag));
+		}
+	}
+	BindGLTextures();
+
+	std::cout << "Loaded " << m_sceneObjects.size() << " objects from scene file:" << m_sceneFileName << std::endl;
+	if (m_bStreaming)
+	{
+		std::cout << "Streaming " << m_worldStreamer.GetCellCount() << " cells around the camera" << std::endl;
+	}
+
+	return(true);
+}
@@ -1,112 +1,782 @@
-///////////////////////////////////////////////////////////////////////////////
-// scenemanager.h
-// ============
-// manage the preparing and rendering of 3D scenes - textures, materials, lighting
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "ShapeMeshes.h"
-
-#include <string>
-#include <vector>
-
-/***********************************************************
- *  SceneManager
- *
- *  This class contains the code for preparing and rendering
- *  3D scenes, including the shader settings.
- ***********************************************************/
-class SceneManager
-{
-public:
-	// constructor
-	SceneManager(ShaderManager *pShaderManager);
-	// destructor
-	~SceneManager();
-
-	struct TEXTURE_INFO
-	{
-		std::string tag;
-		uint32_t ID;
-	};
-
-	struct OBJECT_MATERIAL
-	{
-		glm::vec3 diffuseColor;
-		glm::vec3 specularColor;
-		float shininess;
-		std::string tag;
-	};
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// pointer to basic shapes object
-	ShapeMeshes* m_basicMeshes;
-	// total number of loaded textures
-	int m_loadedTextures;
-	// loaded textures info
-	TEXTURE_INFO m_textureIDs[16];
-	// defined object materials
-	std::vector<OBJECT_MATERIAL> m_objectMaterials;
-
-	// load texture images and convert to OpenGL texture data
-	bool CreateGLTexture(const char* filename, std::string tag);
-	// bind loaded OpenGL textures to slots in memory
-	void BindGLTextures();
-	// free the loaded OpenGL textures
-	void DestroyGLTextures();
-	// find a loaded texture by tag
-	int FindTextureID(std::string tag);
-	int FindTextureSlot(std::string tag);
-	// find a defined material by tag
-	bool FindMaterial(std::string tag, OBJECT_MATERIAL& material);
-
-	// set the transformation values 
-	// into the transform buffer
-	void SetTransformations(
-		glm::vec3 scaleXYZ,
-		float XrotationDegrees,
-		float YrotationDegrees,
-		float ZrotationDegrees,
-		glm::vec3 positionXYZ);
-
-	// set the color values into the shader
-	void SetShaderColor(
-		float redColorValue,
-		float greenColorValue,
-		float blueColorValue,
-		float alphaValue);
-
-	// set the texture data into the shader
-	void SetShaderTexture(
-		std::string textureTag);
-
-	// set the UV scale for the texture mapping
-	void SetTextureUVScale(
-		float u, float v);
-
-	// set the object material into the shader
-	void SetShaderMaterial(
-		std::string materialTag);
-
-public:
-
-	// The following methods are for the students to 
-	// customize for their own 3D scene
-	void PrepareScene();
-	void RenderScene();
-	// load all of the needed textures before rendering
-	void LoadSceneTextures();
-	// define all the object materials before rendering
-	void DefineObjectMaterials();
-	// define all the object lighting points before rendering scene
-	void SetupSceneLights();
-	
-
+///////////////////////////////////////////////////////////////////////////////
+// scenemanager.h
+// ============
+// manage the preparing and rendering of 3D scenes - textures, materials, lighting
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "ShapeMeshes.h"
+#include "DynamicBuffer.h"
+#include "FrameProfiler.h"
+#include "GpuCulling.h"
+#include "MeshBuffer.h"
+#include "RenderQueue.h"
+#include "Frustum.h"
+#include "JobSystem.h"
+#include "LightClusters.h"
+#include "SceneBVH.h"
+#include "SceneFile.h"
+#include "ShadowMaps.h"
+#include "TransformBatch.h"
+#include "TransformHierarchy.h"
+#include "TextureLoader.h"
+#include "UniformCache.h"
+#include "WorldStreamer.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  SceneManager
+ *
+ *  This class contains the code for preparing and rendering
+ *  3D scenes, including the shader settings.
+ ***********************************************************/
+class SceneManager
+{
+public:
+	// constructor
+	SceneManager(ShaderManager *pShaderManager, UniformCache *pUniformCache);
+	// destructor
+	~SceneManager();
+
+	// the most views the scene is rendered into in one frame, one
+	// camera block slot each
+	static const int MAX_VIEWS = UniformCache::MAX_CAMERAS;
+
+	struct TEXTURE_INFO
+	{
+		std::string tag;
+		uint32_t ID;
+		int width;
+		int height;
+		GLenum internalFormat;
+		int mipLevels;
+		// texture unit the texture is bound to, or -1 when
+		// it is bound on demand or packed into an array
+		int unit;
+		// texture array and layer the texture is packed into,
+		// or -1 when it is a separate 2D texture
+		int arrayIndex;
+		int layer;
+		// image file, kept so a streamed out texture can be loaded again
+		std::string filename;
+		// streamed in cells that use the texture
+		int streamReferences;
+		// true while the image is being decoded, and once it has been uploaded
+		bool bLoading;
+		bool bLoaded;
+		// estimated size of the uploaded image on the GPU, in bytes
+		size_t bytes;
+	};
+
+	// same sized textures packed into the layers of one array texture
+	struct TEXTURE_ARRAY_INFO
+	{
+		uint32_t ID;
+		int width;
+		int height;
+		GLenum internalFormat;
+		int mipLevels;
+		int layers;
+		int unit;
+	};
+
+	struct OBJECT_MATERIAL
+	{
+		glm::vec3 diffuseColor;
+		glm::vec3 specularColor;
+		float shininess;
+		std::string tag;
+	};
+
+	// the basic meshes that can be referenced by a scene object
+	enum MESH_TYPE
+	{
+		MESH_PLANE,
+		MESH_CONE,
+		MESH_CYLINDER,
+		MESH_PRISM,
+		MESH_TORUS,
+		MESH_SPHERE,
+		MESH_HALF_SPHERE,
+		MESH_TAPERED_CYLINDER,
+		MESH_PYRAMID3,
+		MESH_COUNT
+	};
+
+	// retained draw information for one object in the scene,
+	// resolved once in PrepareScene() and replayed every frame
+	struct SCENE_OBJECT
+	{
+		// basic mesh type, or MESH_COUNT + index of an imported mesh
+		int mesh;
+		glm::mat4 model;
+		// texture slot, or -1 when drawn with a solid color
+		int textureSlot;
+		// material index, or -1 to keep the current material
+		int materialIndex;
+		glm::vec4 color;
+		glm::vec2 uvScale;
+		// index of the object group, used for profiling
+		int group;
+	};
+
+	// per-instance values of an object inside an instance batch,
+	// laid out to match a std430 instance buffer
+	struct INSTANCE_DATA
+	{
+		glm::mat4 model;
+		glm::vec2 uvScale;
+		int materialIndex;
+		int padding;
+	};
+
+	// per-instance values of a draw from the shared mesh buffer,
+	// laid out to match the std430 InstanceBlock storage buffer
+	struct GPU_INSTANCE
+	{
+		glm::mat4 model;
+		glm::vec4 color;
+		glm::vec2 uvScale;
+		// material index, or -1 to use the material uniforms
+		int materialIndex;
+		// array texture layer, or -1 when drawn with the color
+		int textureLayer;
+		// dither of a level of detail crossfade, 0 when not fading
+		float lodFade;
+		int padding[3];
+	};
+
+	// per-object values of a draw from the mesh's own buffers,
+	// laid out to match the std140 DrawBlock uniform block
+	struct GPU_DRAW_RECORD
+	{
+		glm::mat4 model;
+		// material colors, shininess is in specular w
+		glm::vec4 diffuseColor;
+		glm::vec4 specularColor;
+		glm::vec2 uvScale;
+		// 0 to use the material uniforms instead of the colors above
+		int bUseMaterial;
+		// dither of a level of detail crossfade, 0 when not fading
+		float lodFade;
+	};
+
+	// values of a material, laid out to match the std430
+	// MaterialBlock storage buffer, shininess is in specular w
+	struct GPU_MATERIAL
+	{
+		glm::vec4 diffuseColor;
+		glm::vec4 specularColor;
+	};
+
+	// a run of instances that share one mesh and texture or color
+	struct INSTANCE_BATCH
+	{
+		int mesh;
+		int textureSlot;
+		glm::vec4 color;
+		int group;
+		// true when the batch is blended over the opaque scene
+		bool bTransparent;
+		int firstInstance;
+		int instanceCount;
+	};
+
+	// counts of the work done by the last call to RenderScene()
+	struct RENDER_STATISTICS
+	{
+		int drawCalls;
+		int batches;
+		int textureChanges;
+		int textureBinds;
+		int materialChanges;
+		int culledObjects;
+		int detailCulledObjects;
+		int indirectCommands;
+		int shadowViews;
+	};
+
+private:
+	// the regression benchmarks time the private lookups and uploads,
+	// the tables they look up in are filled with the seeding methods
+	friend class RegressionSuite;
+
+	// the shader values last set by the render queue, used for
+	// skipping the uniform updates that would not change anything
+	struct RENDER_STATE
+	{
+		int textureSlot;
+		int bUseTexture;
+		int textureUnit;
+		int arrayUnit;
+		int textureLayer;
+		glm::vec4 color;
+		int materialIndex;
+		glm::vec2 uvScale;
+		int bUseInstanceBuffer;
+		int bUseDrawBlock;
+		float lodFade;
+	};
+
+	// a run of the sorted packets that is drawn one way, either
+	// as indirect commands with one multi-draw call or packet by
+	// packet from the meshes' own buffers
+	struct DRAW_SEGMENT
+	{
+		int pass;
+		bool bIndirect;
+		// array texture the commands sample, or -1 for none
+		int arrayIndex;
+		// first command or packet and how many there are
+		int first;
+		int count;
+		// mesh of the last command, which more instances can join
+		int lastMesh;
+	};
+
+	// the camera of one view of the frame and the part of the
+	// render target it is drawn into
+	struct SCENE_VIEW
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec3 viewPosition;
+		Frustum frustum;
+		// viewport of the view in pixels, a size of 0 for not set
+		int viewportX;
+		int viewportY;
+		int viewportWidth;
+		int viewportHeight;
+	};
+
+	// the sorted draws of one view of a command list
+	struct VIEW_COMMANDS
+	{
+		SCENE_VIEW sceneView;
+		RenderQueue renderQueue;
+		// instances found inside the view frustum
+		std::vector<int> visibleInstances;
+		// sorted packets and detail culled objects of each range of
+		// the visible instances, before they are merged
+		std::vector<std::vector<RenderQueue::DRAW_PACKET>> rangePackets;
+		std::vector<int> rangeDetailCulled;
+		// an earlier view with the same camera whose draws are
+		// drawn again, or -1 when the view has its own
+		int sharedView;
+		int culledObjects;
+		int detailCulledObjects;
+	};
+
+	// the command list of one frame, which is culled and sorted
+	// on the worker threads while the context thread renders,
+	// with the views it was prepared for
+	struct FRAME_COMMANDS
+	{
+		VIEW_COMMANDS views[MAX_VIEWS];
+		int viewCount;
+		// how the instances were culled and keyed
+		bool bIndirect;
+		bool bInstanced;
+		bool bGpuCulling;
+		bool bProfileGroups;
+		// culled objects of all of the views together
+		int culledObjects;
+		int detailCulledObjects;
+		// true once the list is complete and has not been replaced
+		bool bPrepared;
+		// the jobs preparing the list
+		JobSystem::JOB_GROUP jobs;
+	};
+
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// pointer to cached shader uniform locations
+	UniformCache* m_pUniformCache;
+	// pointer to basic shapes object
+	ShapeMeshes* m_basicMeshes;
+	// loaded textures info
+	std::vector<TEXTURE_INFO> m_textureIDs;
+	// array textures the loaded textures are packed into
+	std::vector<TEXTURE_ARRAY_INFO> m_textureArrays;
+	// texture unit used for textures beyond the number of units
+	int m_overflowTextureUnit;
+	// loaded texture currently bound to the overflow unit
+	int m_overflowTexture;
+	// background image decoding for the textures
+	TextureLoader* m_pTextureLoader;
+	// true while textures are still waiting for their images
+	bool m_bTexturesPending;
+	// defined object materials
+	std::vector<OBJECT_MATERIAL> m_objectMaterials;
+	// texture slot and material index registered for each tag
+	std::unordered_map<std::string, int> m_textureSlots;
+	std::unordered_map<std::string, int> m_materialIndices;
+	// retained draw list built in PrepareScene()
+	std::vector<SCENE_OBJECT> m_sceneObjects;
+	// draw list grouped into instance batches
+	std::vector<INSTANCE_BATCH> m_instanceBatches;
+	// per-instance data referenced by the instance batches
+	std::vector<INSTANCE_DATA> m_instanceData;
+	// world space bounds of each instance, in the same order
+	std::vector<Frustum::BOUNDING_BOX> m_instanceBounds;
+	// batch and scene object of each instance, in the same order
+	std::vector<int> m_instanceBatchIndices;
+	std::vector<int> m_instanceObjectIndices;
+	// instance of each scene object, by scene object index
+	std::vector<int> m_objectInstanceIndices;
+	// hierarchy over the instance bounds for culling, picking and ranges
+	SceneBVH m_sceneBVH;
+	// true when instances moved since the hierarchy was last fit
+	bool m_bBoundsDirty;
+	// local space bounds of each basic mesh, then of each imported mesh
+	std::vector<Frustum::BOUNDING_BOX> m_meshBounds;
+	// true when objects outside the view frustum are skipped
+	bool m_bFrustumCulling;
+	// views the scene is rendered into, as set for the next frame
+	SCENE_VIEW m_sceneViews[MAX_VIEWS];
+	int m_viewCount;
+	// objects with a smaller projected radius than this, in pixels, are skipped
+	float m_minScreenRadius;
+	// names of the object groups and the group new objects are added to
+	std::vector<const char*> m_objectGroups;
+	int m_currentGroup;
+	// optional profiler the object groups are measured with
+	FrameProfiler* m_pFrameProfiler;
+	// true when the draws are kept together by object group for profiling
+	bool m_bProfileGroups;
+	// worker threads the command lists and transforms are prepared on
+	JobSystem* m_pJobSystem;
+	// two command lists, so one can be prepared while the other is
+	// submitted, the list being prepared and the list being submitted
+	FRAME_COMMANDS m_frameCommands[2];
+	int m_prepareFrame;
+	int m_submitFrame;
+	// view of the submitted list whose render queue is drawn
+	int m_submitView;
+	// true when the list prepared during the last frame is submitted
+	// while the list of this frame is prepared
+	bool m_bFramePipelining;
+	// shader values last set while submitting the render queue
+	RENDER_STATE m_renderState;
+	// storage block binding points, after the uniform block binding points
+	static const GLuint INSTANCE_BLOCK_BINDING = 2;
+	static const GLuint MATERIAL_BLOCK_BINDING = 3;
+	// uniform block binding point of the draw records, after the
+	// camera, light and shadow blocks
+	static const GLuint DRAW_BLOCK_BINDING = 3;
+	// true when the shader can read the per-object values of the
+	// draws drawn one by one from records of the DrawBlock
+	bool m_bDrawBlockSupported;
+	// true when the shader dithers the levels of detail of a
+	// crossfade, the levels are switched at once otherwise
+	bool m_bLodFadeSupported;
+	// the basic meshes packed into shared buffers for indirect draws
+	MeshBuffer m_meshBuffer;
+	// true when the driver and shader can draw from the shared buffers,
+	// and whether the frame is drawn with indirect multi-draws then
+	bool m_bIndirectSupported;
+	bool m_bIndirectDraws;
+	// storage buffers of the instances and materials, and the command buffer
+	GLuint m_instanceBuffer;
+	GLuint m_materialBuffer;
+	GLuint m_commandBuffer;
+	// persistently mapped ring that the instances, commands and
+	// light clusters of every frame are written into
+	DynamicBuffer m_dynamicBuffer;
+	// instances of the indirect or instanced draws of the frame, and
+	// the commands and segments of the indirect draws
+	std::vector<GPU_INSTANCE> m_drawInstances;
+	std::vector<MeshBuffer::DRAW_COMMAND> m_drawCommands;
+	std::vector<DRAW_SEGMENT> m_drawSegments;
+	// compute shader culling of the opaque indirect instances
+	GpuCulling m_gpuCulling;
+	// true when the compute culling is available, and whether it is used then
+	bool m_bGpuCullingSupported;
+	bool m_bGpuCulling;
+	// instances culled on the GPU, in the order of the cull buffer,
+	// their commands and the segments the commands are drawn in
+	std::vector<int> m_gpuCullInstances;
+	std::vector<int> m_gpuCullCommands;
+	std::vector<DRAW_SEGMENT> m_gpuCullSegments;
+	// instances that are still culled and queued on the CPU
+	std::vector<int> m_cpuCullInstances;
+	// compiled scene file the scene is loaded from, kept mapped
+	// because the group names point into it
+	SceneFile m_sceneFile;
+	std::string m_sceneFileName;
+	// number of generated objects the scene is replaced with, or 0
+	int m_syntheticObjectCount;
+	// mesh files of the imported meshes, mapped until they are
+	// copied into the shared mesh buffer
+	std::vector<MeshFile*> m_meshFiles;
+	// cells of the world that are streamed in around the camera,
+	// and whether the scene is large enough to be streamed
+	WorldStreamer m_worldStreamer;
+	bool m_bStreaming;
+	// true for the instances of the streamed in cells
+	std::vector<bool> m_instanceResident;
+	// true when instances were streamed in or out since the GPU culling was updated
+	bool m_bResidencyDirty;
+	// bytes of the uploaded textures
+	size_t m_residentTextureBytes;
+	// every point light of the scene, binned into view space clusters
+	// when the shader reads its lights from the cluster storage blocks
+	std::vector<LightClusters::CLUSTER_LIGHT> m_clusterLights;
+	LightClusters m_lightClusters;
+	// true when the shader supports the clusters, and whether they are used then
+	bool m_bClusteredLightingSupported;
+	bool m_bClusteredLighting;
+	// lights of the scene, kept for the shadow maps
+	UniformCache::LIGHT_BLOCK m_sceneLights;
+	// cascaded and cube shadow maps of the lights, and whether the
+	// shader samples them and they are drawn then
+	ShadowMaps m_shadowMaps;
+	bool m_bShadowsSupported;
+	bool m_bShadows;
+	// texture unit of the cascades, the point light cube maps use the next
+	int m_shadowTextureUnit;
+	// shadow views rendered this frame and the casters found for one view
+	std::vector<ShadowMaps::SHADOW_VIEW> m_shadowViews;
+	std::vector<int> m_shadowCasters;
+	// true for the instances that have moved since the scene was prepared,
+	// which are drawn over the cached static shadows every frame
+	std::vector<bool> m_instanceDynamic;
+	int m_dynamicInstanceCount;
+	// instances the objects of the last transform batch were composed into
+	std::vector<int> m_transformInstances;
+	// transform nodes the scene objects are placed by, the node of
+	// each scene object, the nodes objects are being added below,
+	// and the nodes that changed in the last update
+	TransformHierarchy m_transformHierarchy;
+	std::vector<int> m_objectNodes;
+	std::vector<int> m_openNodes;
+	std::vector<int> m_changedNodes;
+	// instances that moved since the last frame, each listed once,
+	// so only they are refit and uploaded
+	std::vector<int> m_movedInstances;
+	std::vector<bool> m_instanceMoved;
+	// position of each instance in the GPU cull buffer, or -1
+	std::vector<int> m_instanceCullIndices;
+	// cull buffer positions of the moved instances, and the culling
+	// values of one moved range waiting to be uploaded
+	std::vector<int> m_movedCullIndices;
+	std::vector<GpuCulling::CULL_INSTANCE> m_cullUploads;
+	// view being rendered, for the lights, shadows and GPU culling
+	SCENE_VIEW m_frameView;
+	// work done by the last call to RenderScene()
+	RENDER_STATISTICS m_renderStatistics;
+
+	// start the worker threads that decode the texture images
+	void StartTextureLoading();
+	// load texture images and convert to OpenGL texture data
+	bool CreateGLTexture(const char* filename, const std::string& tag);
+	// create a one pixel texture shown until an image is uploaded
+	GLuint CreatePlaceholderTexture();
+	// queue the image of a texture to be decoded in the background
+	void QueueGLTexture(int textureSlot);
+	// free the image of a texture, leaving the placeholder in its slot
+	void ReleaseGLTexture(int textureSlot);
+	// upload the texture images that finished loading
+	void UpdateGLTextures();
+	// pack same sized textures into array texture layers
+	void BuildTextureArrays();
+	// bind loaded OpenGL textures to slots in memory
+	void BindGLTextures();
+	// free the loaded OpenGL textures
+	void DestroyGLTextures();
+	// find a loaded texture by tag
+	int FindTextureID(const std::string& tag);
+	int FindTextureSlot(const std::string& tag);
+	// register the defined materials by tag
+	void RegisterMaterials();
+	// find a defined material by tag
+	bool FindMaterial(const std::string& tag, OBJECT_MATERIAL& material);
+	int FindMaterialIndex(const std::string& tag);
+
+	// calculate the model matrix from the transformation values
+	glm::mat4 BuildModelMatrix(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// set the transformation values 
+	// into the transform buffer
+	void SetTransformations(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+
+	// set the color values into the shader
+	void SetShaderColor(
+		float redColorValue,
+		float greenColorValue,
+		float blueColorValue,
+		float alphaValue);
+
+	// set the texture data into the shader
+	void SetShaderTexture(
+		const std::string& textureTag);
+	void SetShaderTexture(
+		int textureSlot);
+
+	// set the UV scale for the texture mapping
+	void SetTextureUVScale(
+		float u, float v);
+
+	// set the object material into the shader
+	void SetShaderMaterial(
+		const std::string& materialTag);
+
+	// add a textured object to the retained draw list
+	void AddTexturedObject(
+		MESH_TYPE mesh,
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ,
+		const std::string& textureTag,
+		glm::vec2 uvScale,
+		const std::string& materialTag);
+
+	// add a solid colored object to the retained draw list
+	void AddColoredObject(
+		MESH_TYPE mesh,
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ,
+		glm::vec4 color,
+		const std::string& materialTag);
+
+	// start the object group that the next objects belong to
+	void BeginObjectGroup(const char* group);
+	// start a transform node that the next objects are placed relative to
+	int BeginObjectNode(
+		glm::vec3 scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		glm::vec3 positionXYZ);
+	// go back to the node that was open before the last one was started
+	void EndObjectNode();
+	// add the transform node of the next scene object and get its world matrix
+	glm::mat4 AddObjectNode(const glm::mat4& local, int parentNode);
+
+	// draw the basic or imported mesh of the passed in index
+	void DrawMesh(int mesh);
+	// define the local bounds of the basic meshes
+	void DefineMeshBounds();
+
+	// group the retained draw list into instance batches
+	void BuildInstanceBatches();
+	// set the material at the passed in index into the shader
+	void SetShaderMaterial(int materialIndex);
+	// set the solid color of an untextured batch into the shader
+	void SetBatchColor(const glm::vec4& color);
+	// forget the shader values set by the previous frame
+	void ResetRenderState();
+	// get the radius in pixels that an instance covers on screen
+	float GetScreenRadius(const SCENE_VIEW& sceneView, int instanceIndex, float viewDepth) const;
+	// pick the level of detail of a mesh drawn at a screen radius
+	void SelectLod(int mesh, float screenRadius, int& lod, float& blend) const;
+	// keep the views of the frame and start preparing its command list
+	void BeginFrameCommands(FRAME_COMMANDS& commands);
+	// cull the instances and fill the render queues of a command list
+	void PrepareFrameCommands(FRAME_COMMANDS& commands);
+	// queue the visible instances of one range of a view of a command list
+	void BuildRangePackets(const FRAME_COMMANDS& commands, VIEW_COMMANDS& viewCommands, int range, int first, int count);
+	// wait until a command list is prepared
+	void WaitForFrameCommands(FRAME_COMMANDS& commands);
+	// set the cameras a command list was prepared with into the shader
+	void SetFrameCameras(const FRAME_COMMANDS& commands);
+	// set a view a command list was prepared with as the view being rendered
+	void SetFrameView(const FRAME_COMMANDS& commands, int viewIndex);
+	// draw one view of a command list into its part of the render target
+	void RenderView(FRAME_COMMANDS& commands, int viewIndex);
+	// draw the sorted packets of the render queue
+	void SubmitRenderQueue();
+	// set the blending and depth state of a render pass
+	void SetRenderPassState(int pass);
+	// draw one sorted packet from the mesh's own buffers
+	void DrawPacket(const RenderQueue::DRAW_PACKET& packet);
+	// switch the shader between the instance buffer and the uniforms
+	void SetInstanceBufferMode(bool bUseInstanceBuffer);
+	// switch the shader between the draw records and the uniforms
+	void SetDrawBlockMode(bool bUseDrawBlock);
+	// write the per-object values of a draw into a record and bind it
+	bool BindDrawRecord(const INSTANCE_DATA& instance, float lodFade);
+	// set the crossfade dither of the next draw into the shader
+	void SetLodFade(float lodFade);
+	// check whether the shader reads the DrawBlock and attach it
+	bool FindDrawBlock();
+	// get the values of an instance the way the instance buffer holds them
+	GPU_INSTANCE GetGpuInstance(int instanceIndex) const;
+	// write the instances of the frame's draws into the instance buffer
+	void UploadDrawInstances();
+	// point the array texture sampler at the unit of an array texture
+	void SetArrayTexture(int arrayIndex);
+	// draw a run of instances of one batch with one instanced call
+	void DrawInstances(int mesh, int arrayIndex, int firstInstance, int instanceCount);
+	// check whether the batches are drawn instanced from the instance buffer
+	bool IsDrawingInstanced() const;
+
+	// capture the basic meshes and add the imported meshes to the shared mesh buffer
+	void BuildMeshBuffer();
+	// unmap the mesh files of the imported meshes
+	void CloseMeshFiles();
+	// create the buffers of the indirect draws, if the shader supports them
+	void CreateIndirectBuffers();
+	// free the buffers of the indirect draws
+	void DestroyIndirectBuffers();
+	// get the texture array a batch is drawn with indirectly
+	int GetIndirectArrayIndex(const INSTANCE_BATCH& batch) const;
+	// build the commands of the sorted packets and draw them
+	void SubmitIndirectDraws();
+	// check whether the frame is drawn with indirect multi-draws
+	bool IsDrawingIndirect() const;
+
+	// split the instances between the GPU and the CPU culling
+	void BuildGpuCullingLayout();
+	// fill the culling values and bounds of a range of the GPU culled instances
+	void GetGpuCullInstances(int first, int count, std::vector<GpuCulling::CULL_INSTANCE>& instances) const;
+	// check whether the frame is culled on the GPU
+	bool IsCullingOnGpu() const;
+	// cull the GPU culled instances and fill their commands
+	void DispatchGpuCulling();
+	// draw the commands filled by the GPU culling
+	void SubmitGpuCulledDraws();
+
+	// split the scene objects into the cells of the world
+	void BuildStreamingCells();
+	// load and evict the cells around the camera
+	void UpdateStreaming();
+	// take or drop the textures of a cell
+	void LoadStreamingCell(int cell);
+	void EvictStreamingCell(int cell);
+	// draw or hide the instances of a cell
+	void SetCellResidency(int cell, bool bResident);
+
+	// add a point light to the lights binned into clusters
+	void AddClusterLight(const UniformCache::POINT_LIGHT_DATA& light, float range);
+	// create the light clusters, if the shader supports them
+	void CreateLightClusters();
+	// bin the point lights into the clusters of the frame
+	void UpdateLightClusters();
+
+	// move the instance and bounds of a scene object to a world matrix
+	void MoveSceneObject(int objectIndex, const glm::mat4& model);
+	// list a moved instance for the next frame and draw it over the
+	// cached static shadows from now on
+	void MarkInstanceMoved(int instanceIndex);
+	// move the objects of the transform nodes that changed
+	void UpdateTransformHierarchy();
+	// refit the hierarchy and upload the culling values of the moved instances
+	void UpdateMovedInstances();
+	// create the shadow maps, if the shader samples them
+	void CreateShadowMaps();
+	// render the shadow views of the frame and pass the maps to the shader
+	void RenderShadowMaps();
+
+public:
+	// get the GLSL that dithers the levels of detail of a crossfade
+	static const char* GetLodFadeSource();
+
+	// measure the object groups with the passed in profiler
+	void SetFrameProfiler(FrameProfiler* pFrameProfiler);
+	// keep the draws together by object group so each group can be measured
+	void SetGroupProfiling(bool bProfileGroups);
+	// skip the objects that are outside the view frustum
+	void SetFrustumCulling(bool bFrustumCulling);
+	// draw the frame with indirect multi-draws, when they are supported
+	void SetIndirectDraws(bool bIndirectDraws);
+	// cull the opaque instances with a compute shader, when it is supported
+	void SetGpuCulling(bool bGpuCulling);
+	// shade the point lights by view space cluster, when it is supported
+	void SetClusteredLighting(bool bClusteredLighting);
+	// draw and sample the shadow maps, when they are supported
+	void SetShadows(bool bShadows);
+	// submit the last frame's command list while preparing the next
+	void SetFramePipelining(bool bFramePipelining);
+	// set the bytes of texture memory the streamed in cells can use
+	void SetStreamingBudget(size_t memoryBudget);
+	// check whether the scene is streamed in cells around the camera
+	bool IsStreaming() const;
+	// set the number of views the scene is rendered into each frame
+	void SetViewCount(int viewCount);
+	// set the part of the render target a view is rendered into
+	void SetViewport(int viewIndex, int x, int y, int width, int height);
+	// skip the objects that cover fewer pixels than the passed in radius
+	void SetDetailCulling(float minScreenRadius);
+	// move a scene object, the hierarchy is refit before the next frame
+	void SetObjectTransform(int objectIndex, const glm::mat4& model);
+	// move many scene objects at once from a batch of transformation values
+	void SetObjectTransforms(const std::vector<int>& objectIndices, const TransformBatch& transforms);
+	// get the transform node a scene object is placed by
+	int GetObjectNode(int objectIndex) const;
+	// get the parent of a transform node, or -1 for a root node
+	int GetNodeParent(int nodeIndex) const;
+	// move a transform node and everything below it before the next frame
+	void SetNodeTransform(int nodeIndex, const glm::mat4& local);
+	// get the nearest scene object hit by a ray, or -1 when none is hit
+	int PickObject(const glm::vec3& origin, const glm::vec3& direction, float& distance) const;
+	// get the scene objects whose bounds are within range of a point
+	void QueryObjectsInRange(const glm::vec3& position, float range, std::vector<int>& objects) const;
+	// get the name of the group a scene object was added to
+	const char* GetObjectGroupName(int objectIndex) const;
+	// set up a reloaded shader program the way the scene set up the last one
+	void RestoreShaderState();
+
+	// set the view parameters of a view of the frame before rendering
+	void SetViewParameters(
+		int viewIndex,
+		const glm::mat4& view,
+		const glm::mat4& projection,
+		const glm::vec3& viewPosition);
+	// get the work done by the last call to RenderScene()
+	const RENDER_STATISTICS& GetRenderStatistics() const;
+	// check whether textures are still waiting for their images
+	bool IsLoadingTextures() const;
+	// check whether the next frame can differ even when the view stays the same
+	bool IsSceneChanging() const;
+	// fill the texture slot table with tags that have no textures, for lookups
+	void SeedTextureSlots(const std::vector<std::string>& tags);
+	// replace the defined materials and register them by tag
+	void SeedMaterials(const std::vector<OBJECT_MATERIAL>& materials);
+
+	// The following methods are for the students to 
+	// customize for their own 3D scene
+	void PrepareScene();
+	void RenderScene();
+	// load all of the needed textures before rendering
+	void LoadSceneTextures();
+	// define all the object materials before rendering
+	void DefineObjectMaterials();
+	// define all the object lighting points before rendering scene
+	void SetupSceneLights();
+	// build the retained draw list for all the scene objects
+	void BuildSceneObjects();
+	// set the compiled scene file to load instead of the code above
+	void SetSceneFile(const char* filename);
+	// load the textures, materials, lights and objects of the scene file
+	bool LoadSceneFile();
+	// replace the scene with a grid of generated objects, for timing
+	void SetSyntheticScene(int objectCount);
+	// build the retained draw list of the generated objects
+	void BuildSyntheticObjects();
+	
+
 };
\ No newline at end of file
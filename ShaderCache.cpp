@@ -0,0 +1,508 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadercache.cpp
+// ============
+// build the shader program from cached program binaries and reload it on edits
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShaderCache.h"
+
+#include <sys/stat.h>
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+// declaration of global variables and defines
+namespace
+{
+	// marks a program binary file written by this class
+	const uint32_t g_BinaryMagic = 0x42505343;
+
+	// the start of a cached program binary file, followed by the binary
+	struct PROGRAM_BINARY_HEADER
+	{
+		uint32_t magic;
+		uint32_t format;
+		uint32_t length;
+	};
+
+	// 64-bit FNV-1a hash, one string after another
+	const uint64_t g_HashOffset = 14695981039346656037ULL;
+	const uint64_t g_HashPrime = 1099511628211ULL;
+
+	void HashString(uint64_t& hash, const char* text)
+	{
+		// a missing driver string hashes the same as an empty one
+		for (const char* p = (NULL != text) ? text : ""; *p != '\0'; p++)
+		{
+			hash = (hash ^ (unsigned char)*p) * g_HashPrime;
+		}
+		// keep the end of each string, so "ab"+"c" differs from "a"+"bc"
+		hash = hash * g_HashPrime;
+	}
+}
+
+/***********************************************************
+ *  ShaderCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShaderCache::ShaderCache()
+{
+	m_programID = 0;
+	m_vertexTime = 0;
+	m_fragmentTime = 0;
+	m_bLoadedFromCache = false;
+}
+
+/***********************************************************
+ *  ~ShaderCache()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ShaderCache::~ShaderCache()
+{
+	if (0 != m_programID)
+	{
+		glDeleteProgram(m_programID);
+		m_programID = 0;
+	}
+}
+
+/***********************************************************
+ *  LoadProgram()
+ *
+ *  This method is used for building the shader program from
+ *  the vertex and fragment source files, with the passed in
+ *  compile time defines.  Each define is a name, optionally
+ *  followed by a space and its value.  The fragment prelude
+ *  is code that is inserted after the defines of the
+ *  fragment source, ahead of the code of the file, and the
+ *  vertex prelude is inserted the same way into the vertex
+ *  source.  The
+ *  cached binary is used when there is one for the sources
+ *  and the driver.  Zero is returned when the program does
+ *  not compile.
+ ***********************************************************/
+GLuint ShaderCache::LoadProgram(
+	const char* vertexFile,
+	const char* fragmentFile,
+	const std::vector<std::string>& defines,
+	const std::string& fragmentPrelude,
+	const std::string& vertexPrelude)
+{
+	m_vertexFile = vertexFile;
+	m_fragmentFile = fragmentFile;
+	m_defines = defines;
+	m_fragmentPrelude = fragmentPrelude;
+	m_vertexPrelude = vertexPrelude;
+
+	GLuint programID = BuildProgram();
+	if (0 == programID)
+	{
+		return(0);
+	}
+
+	if (0 != m_programID)
+	{
+		glDeleteProgram(m_programID);
+	}
+	m_programID = programID;
+
+	return(m_programID);
+}
+
+/***********************************************************
+ *  HaveSourcesChanged()
+ *
+ *  This method is used for checking whether either source
+ *  file was saved since the program was last built.
+ ***********************************************************/
+bool ShaderCache::HaveSourcesChanged() const
+{
+	if (m_vertexFile.empty())
+	{
+		return(false);
+	}
+
+	return((GetFileTime(m_vertexFile) != m_vertexTime) ||
+		(GetFileTime(m_fragmentFile) != m_fragmentTime));
+}
+
+/***********************************************************
+ *  ReloadProgram()
+ *
+ *  This method is used for building the program again from
+ *  the source files after they were edited.  The new
+ *  program replaces the current one, which is deleted.
+ *  When it does not compile, zero is returned and the
+ *  current program stays in use until the next save.
+ ***********************************************************/
+GLuint ShaderCache::ReloadProgram()
+{
+	GLuint programID = BuildProgram();
+
+	if (0 == programID)
+	{
+		std::cout << "Keeping the current shader program" << std::endl;
+		return(0);
+	}
+
+	if (0 != m_programID)
+	{
+		glDeleteProgram(m_programID);
+	}
+	m_programID = programID;
+
+	std::cout << "Reloaded the shader program" << std::endl;
+
+	return(m_programID);
+}
+
+/***********************************************************
+ *  BuildProgram()
+ *
+ *  This method is used for building a program from the
+ *  source files, from the cached binary when it is valid,
+ *  or by compiling the sources and caching the binary.  The
+ *  write times of the files are kept even when the build
+ *  fails, so a broken edit is only tried once.
+ ***********************************************************/
+GLuint ShaderCache::BuildProgram()
+{
+	std::string vertexSource;
+	std::string fragmentSource;
+
+	m_vertexTime = GetFileTime(m_vertexFile);
+	m_fragmentTime = GetFileTime(m_fragmentFile);
+	m_bLoadedFromCache = false;
+
+	if ((!ReadSource(m_vertexFile, vertexSource)) || (!ReadSource(m_fragmentFile, fragmentSource)))
+	{
+		return(0);
+	}
+
+	vertexSource = InsertDefines(vertexSource, m_vertexPrelude);
+	fragmentSource = InsertDefines(fragmentSource, m_fragmentPrelude);
+
+	std::string binaryName = GetBinaryName(vertexSource, fragmentSource);
+
+	GLuint programID = LoadBinary(binaryName);
+	if (0 != programID)
+	{
+		m_bLoadedFromCache = true;
+		std::cout << "Loaded the shader program from:" << binaryName << std::endl;
+		return(programID);
+	}
+
+	programID = CompileProgram(vertexSource, fragmentSource);
+	if (0 != programID)
+	{
+		SaveBinary(programID, binaryName);
+	}
+
+	return(programID);
+}
+
+/***********************************************************
+ *  ReadSource()
+ *
+ *  This method is used for reading a whole source file.
+ ***********************************************************/
+bool ShaderCache::ReadSource(const std::string& filename, std::string& source) const
+{
+	std::ifstream file(filename.c_str(), std::ios::binary);
+
+	if (!file)
+	{
+		std::cout << "Could not open shader file:" << filename << std::endl;
+		return(false);
+	}
+
+	std::stringstream contents;
+	contents << file.rdbuf();
+	source = contents.str();
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetFileTime()
+ *
+ *  This method is used for getting the last write time of a
+ *  file, or zero when it can not be found.
+ ***********************************************************/
+time_t ShaderCache::GetFileTime(const std::string& filename) const
+{
+	struct stat fileStatus;
+
+	if (stat(filename.c_str(), &fileStatus) != 0)
+	{
+		return(0);
+	}
+
+	return(fileStatus.st_mtime);
+}
+
+/***********************************************************
+ *  InsertDefines()
+ *
+ *  This method is used for inserting a #define line for
+ *  every compile time define, followed by the passed in
+ *  prelude code, after the #version line of a source, which
+ *  has to stay the first line.  The defines go first when
+ *  there is no #version line.
+ ***********************************************************/
+std::string ShaderCache::InsertDefines(const std::string& source, const std::string& prelude) const
+{
+	std::string defines;
+	size_t insertAt = 0;
+
+	if ((m_defines.empty()) && (prelude.empty()))
+	{
+		return(source);
+	}
+
+	for (int i = 0; i < m_defines.size(); i++)
+	{
+		defines += "#define " + m_defines[i] + "\n";
+	}
+	defines += prelude;
+
+	size_t version = source.find("#version");
+	if (std::string::npos != version)
+	{
+		insertAt = source.find('\n', version);
+		insertAt = (std::string::npos != insertAt) ? insertAt + 1 : source.size();
+	}
+
+	return(source.substr(0, insertAt) + defines + source.substr(insertAt));
+}
+
+/***********************************************************
+ *  GetBinaryName()
+ *
+ *  This method is used for getting the name of the binary
+ *  file cached for the passed in sources.  The sources
+ *  already hold the defines, and the hash also covers the
+ *  driver's vendor, renderer and version, since a binary is
+ *  only valid on the driver that wrote it.  The file is
+ *  kept next to the vertex shader.
+ ***********************************************************/
+std::string ShaderCache::GetBinaryName(const std::string& vertexSource, const std::string& fragmentSource) const
+{
+	uint64_t hash = g_HashOffset;
+	char hashText[17];
+
+	HashString(hash, vertexSource.c_str());
+	HashString(hash, fragmentSource.c_str());
+	HashString(hash, (const char*)glGetString(GL_VENDOR));
+	HashString(hash, (const char*)glGetString(GL_RENDERER));
+	HashString(hash, (const char*)glGetString(GL_VERSION));
+	snprintf(hashText, sizeof(hashText), "%016llx", (unsigned long long)hash);
+
+	size_t separator = m_vertexFile.find_last_of("/\\");
+	std::string directory = (std::string::npos != separator) ? m_vertexFile.substr(0, separator + 1) : "";
+
+	return(directory + "program_" + hashText + ".bin");
+}
+
+/***********************************************************
+ *  LoadBinary()
+ *
+ *  This method is used for linking a program from a cached
+ *  binary.  Zero is returned when the driver can not load
+ *  program binaries, there is no file, or the driver does
+ *  not accept the binary, and the sources are compiled.
+ ***********************************************************/
+GLuint ShaderCache::LoadBinary(const std::string& binaryName) const
+{
+	PROGRAM_BINARY_HEADER header;
+	std::vector<char> binary;
+	GLint linkStatus = GL_FALSE;
+
+	if (!GLEW_ARB_get_program_binary)
+	{
+		return(0);
+	}
+
+	std::ifstream file(binaryName.c_str(), std::ios::binary);
+	if (!file)
+	{
+		return(0);
+	}
+
+	file.read((char*)&header, sizeof(header));
+	if ((!file) || (header.magic != g_BinaryMagic) || (header.length == 0))
+	{
+		return(0);
+	}
+
+	binary.resize(header.length);
+	file.read(binary.data(), header.length);
+	if (!file)
+	{
+		return(0);
+	}
+
+	GLuint programID = glCreateProgram();
+	glProgramBinary(programID, header.format, binary.data(), header.length);
+	glGetProgramiv(programID, GL_LINK_STATUS, &linkStatus);
+
+	// a driver update can reject a binary the same driver wrote
+	if (GL_TRUE != linkStatus)
+	{
+		std::cout << "Cached shader program was rejected by the driver:" << binaryName << std::endl;
+		glDeleteProgram(programID);
+		return(0);
+	}
+
+	return(programID);
+}
+
+/***********************************************************
+ *  SaveBinary()
+ *
+ *  This method is used for saving the binary of a linked
+ *  program, so the next launch can skip compiling it.
+ ***********************************************************/
+void ShaderCache::SaveBinary(GLuint programID, const std::string& binaryName) const
+{
+	PROGRAM_BINARY_HEADER header;
+	GLint length = 0;
+	GLenum format = 0;
+
+	if (!GLEW_ARB_get_program_binary)
+	{
+		return;
+	}
+
+	glGetProgramiv(programID, GL_PROGRAM_BINARY_LENGTH, &length);
+	if (length <= 0)
+	{
+		return;
+	}
+
+	std::vector<char> binary(length);
+	glGetProgramBinary(programID, length, &length, &format, binary.data());
+
+	std::ofstream file(binaryName.c_str(), std::ios::binary);
+	if (!file)
+	{
+		std::cout << "Could not write shader program cache:" << binaryName << std::endl;
+		return;
+	}
+
+	header.magic = g_BinaryMagic;
+	header.format = format;
+	header.length = length;
+	file.write((const char*)&header, sizeof(header));
+	file.write(binary.data(), length);
+}
+
+/***********************************************************
+ *  CompileProgram()
+ *
+ *  This method is used for compiling both shader stages and
+ *  linking them into a program that the driver is asked to
+ *  keep the binary of.  Zero is returned on errors, after
+ *  the info log has been written out.
+ ***********************************************************/
+GLuint ShaderCache::CompileProgram(const std::string& vertexSource, const std::string& fragmentSource) const
+{
+	GLint linkStatus = GL_FALSE;
+
+	GLuint vertexShader = CompileShader(GL_VERTEX_SHADER, vertexSource, m_vertexFile);
+	GLuint fragmentShader = CompileShader(GL_FRAGMENT_SHADER, fragmentSource, m_fragmentFile);
+
+	if ((0 == vertexShader) || (0 == fragmentShader))
+	{
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+		return(0);
+	}
+
+	GLuint programID = glCreateProgram();
+	glAttachShader(programID, vertexShader);
+	glAttachShader(programID, fragmentShader);
+	if (GLEW_ARB_get_program_binary)
+	{
+		glProgramParameteri(programID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+	glLinkProgram(programID);
+
+	// the program keeps the compiled stages it needs
+	glDetachShader(programID, vertexShader);
+	glDetachShader(programID, fragmentShader);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	glGetProgramiv(programID, GL_LINK_STATUS, &linkStatus);
+	if (GL_TRUE != linkStatus)
+	{
+		GLchar infoLog[1024];
+
+		glGetProgramInfoLog(programID, sizeof(infoLog), NULL, infoLog);
+		std::cout << "Could not link shader program:" << std::endl << infoLog << std::endl;
+		glDeleteProgram(programID);
+		return(0);
+	}
+
+	std::cout << "Compiled shader program:" << m_vertexFile << " " << m_fragmentFile << std::endl;
+
+	return(programID);
+}
+
+/***********************************************************
+ *  CompileShader()
+ *
+ *  This method is used for compiling one shader stage.
+ *  Zero is returned when it does not compile.
+ ***********************************************************/
+GLuint ShaderCache::CompileShader(GLenum stage, const std::string& source, const std::string& filename) const
+{
+	const GLchar* pSource = source.c_str();
+	GLint compileStatus = GL_FALSE;
+
+	GLuint shader = glCreateShader(stage);
+	glShaderSource(shader, 1, &pSource, NULL);
+	glCompileShader(shader);
+
+	glGetShaderiv(shader, GL_COMPILE_STATUS, &compileStatus);
+	if (GL_TRUE != compileStatus)
+	{
+		GLchar infoLog[1024];
+
+		glGetShaderInfoLog(shader, sizeof(infoLog), NULL, infoLog);
+		std::cout << "Could not compile shader:" << filename << std::endl << infoLog << std::endl;
+		glDeleteShader(shader);
+		return(0);
+	}
+
+	return(shader);
+}
+
+/***********************************************************
+ *  GetProgram()
+ *
+ *  This method is used for getting the program that was
+ *  built, or zero when none has been.
+ ***********************************************************/
+GLuint ShaderCache::GetProgram() const
+{
+	return(m_programID);
+}
+
+/***********************************************************
+ *  IsLoadedFromCache()
+ *
+ *  This method is used for checking whether the program was
+ *  loaded from a cached binary rather than compiled.
+ ***********************************************************/
+bool ShaderCache::IsLoadedFromCache() const
+{
+	return(m_bLoadedFromCache);
+}
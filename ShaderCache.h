@@ -0,0 +1,102 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadercache.h
+// ============
+// build the shader program from cached program binaries and reload it on edits
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstdint>
+#include <ctime>
+#include <string>
+#include <vector>
+
+/***********************************************************
+ *  ShaderCache
+ *
+ *  This class builds the shader program from the vertex and
+ *  fragment source files.  The linked program binary is
+ *  saved next to the shaders, keyed by a hash of the
+ *  sources, the compile time defines and the driver, so a
+ *  later launch on the same driver loads the binary instead
+ *  of compiling.  Any change of a source, a define or the
+ *  driver makes a new key, and a binary the driver refuses
+ *  is compiled again and replaced.
+ *
+ *  The defines are inserted after the #version line, so one
+ *  pair of source files can be built into permutations that
+ *  leave out the branches they do not need.  Shared code,
+ *  such as the cluster lookup of the clustered lights, can
+ *  be inserted after them as a prelude of the fragment
+ *  source, and the uniform block declarations as a prelude
+ *  of the vertex source.  The source
+ *  files are watched, and when one is saved the program is
+ *  rebuilt, keeping the current program if the new one
+ *  does not compile.
+ ***********************************************************/
+class ShaderCache
+{
+public:
+	// constructor
+	ShaderCache();
+	// destructor
+	~ShaderCache();
+
+private:
+	// the source files and defines the program is built from
+	std::string m_vertexFile;
+	std::string m_fragmentFile;
+	std::vector<std::string> m_defines;
+	// code inserted after the defines of the fragment and vertex sources
+	std::string m_fragmentPrelude;
+	std::string m_vertexPrelude;
+	// the program that is built, or 0 for none
+	GLuint m_programID;
+	// last write times of the source files when they were read
+	time_t m_vertexTime;
+	time_t m_fragmentTime;
+	// true when the last build was loaded from a cached binary
+	bool m_bLoadedFromCache;
+
+	// read a whole source file
+	bool ReadSource(const std::string& filename, std::string& source) const;
+	// get the last write time of a file, or 0 when it is missing
+	time_t GetFileTime(const std::string& filename) const;
+	// insert the defines and a prelude after the #version line of a source
+	std::string InsertDefines(const std::string& source, const std::string& prelude) const;
+	// get the name of the binary cached for the passed in sources
+	std::string GetBinaryName(const std::string& vertexSource, const std::string& fragmentSource) const;
+
+	// link a program from a cached binary, 0 when there is none
+	GLuint LoadBinary(const std::string& binaryName) const;
+	// save the binary of a linked program
+	void SaveBinary(GLuint programID, const std::string& binaryName) const;
+	// compile and link a program from its sources, 0 on errors
+	GLuint CompileProgram(const std::string& vertexSource, const std::string& fragmentSource) const;
+	// compile one shader stage, 0 on errors
+	GLuint CompileShader(GLenum stage, const std::string& source, const std::string& filename) const;
+	// build a program from the source files, 0 on errors
+	GLuint BuildProgram();
+
+public:
+	// build the program from the source files with the passed in defines
+	GLuint LoadProgram(
+		const char* vertexFile,
+		const char* fragmentFile,
+		const std::vector<std::string>& defines,
+		const std::string& fragmentPrelude = "",
+		const std::string& vertexPrelude = "");
+	// check whether a source file was saved since it was read
+	bool HaveSourcesChanged() const;
+	// rebuild the program from the changed sources, 0 when it does not compile
+	GLuint ReloadProgram();
+
+	// get the program that is built
+	GLuint GetProgram() const;
+	// check whether the last build was loaded from a cached binary
+	bool IsLoadedFromCache() const;
+};
@@ -0,0 +1,761 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowmaps.cpp
+// ============
+// render and cache the shadow maps of the directional and point lights
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ShadowMaps.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+
+// declaration of global variables and defines
+namespace
+{
+	// transforms the casters into the light's view and keeps
+	// their world position for the point light distance
+	const char* g_DepthVertexShader =
+		"#version 330 core\n"
+		"layout (location = 0) in vec3 inVertexPosition;\n"
+		"uniform mat4 model;\n"
+		"uniform mat4 viewProjection;\n"
+		"out vec3 worldPosition;\n"
+		"void main()\n"
+		"{\n"
+		"	vec4 world = model * vec4(inVertexPosition, 1.0);\n"
+		"	worldPosition = world.xyz;\n"
+		"	gl_Position = viewProjection * world;\n"
+		"}\n";
+
+	// cube faces store the distance to the light over the far
+	// plane, so all six faces are compared the same way
+	const char* g_DepthFragmentShader =
+		"#version 330 core\n"
+		"in vec3 worldPosition;\n"
+		"uniform vec4 lightPositionFar;\n"
+		"void main()\n"
+		"{\n"
+		"	if (lightPositionFar.w > 0.0)\n"
+		"		gl_FragDepth = length(worldPosition - lightPositionFar.xyz) / lightPositionFar.w;\n"
+		"	else\n"
+		"		gl_FragDepth = gl_FragCoord.z;\n"
+		"}\n";
+
+	// the cascades reach this far from the camera at most
+	const float g_ShadowDistance = 60.0f;
+	// blend between logarithmic and even cascade splits
+	const float g_CascadeSplitLambda = 0.75f;
+	// cascades are fit this much larger than their slice, so the
+	// camera can move a little before a cascade is fit again
+	const float g_CascadeMargin = 0.25f;
+	// casters this far behind a cascade toward the light still shadow it
+	const float g_ShadowCasterDistance = 50.0f;
+	// near plane of the point light cube faces
+	const float g_PointShadowNear = 0.05f;
+	// distance bias of the point light comparison, in units of the range
+	const float g_PointShadowBias = 0.005f;
+	// slope scaled depth offset of the cascade casters
+	const float g_DepthOffsetFactor = 2.0f;
+	const float g_DepthOffsetUnits = 4.0f;
+
+	// look direction and up vector of each cube map face
+	const glm::vec3 g_CubeFaceDirections[6] =
+	{
+		glm::vec3(1.0f, 0.0f, 0.0f),
+		glm::vec3(-1.0f, 0.0f, 0.0f),
+		glm::vec3(0.0f, 1.0f, 0.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, 0.0f, 1.0f),
+		glm::vec3(0.0f, 0.0f, -1.0f)
+	};
+	const glm::vec3 g_CubeFaceUps[6] =
+	{
+		glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, 0.0f, 1.0f),
+		glm::vec3(0.0f, 0.0f, -1.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f),
+		glm::vec3(0.0f, -1.0f, 0.0f)
+	};
+}
+
+/***********************************************************
+ *  ShadowMaps()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ShadowMaps::ShadowMaps()
+{
+	m_depthProgram = 0;
+	m_modelLocation = -1;
+	m_viewProjectionLocation = -1;
+	m_lightPositionFarLocation = -1;
+	m_framebuffer = 0;
+	m_staticCascadeTexture = 0;
+	m_staticPointTexture = 0;
+	m_cascadeTexture = 0;
+	m_pointTexture = 0;
+	m_bCaching = false;
+	m_bDynamicMaps = false;
+	m_lightDirection = glm::vec3(0.0f, -1.0f, 0.0f);
+	m_bDirectional = false;
+	m_pointShadowCapacity = 0;
+	m_previousFramebuffer = 0;
+	m_previousProgram = 0;
+	for (int i = 0; i < 4; i++)
+	{
+		m_previousViewport[i] = 0;
+	}
+	for (int i = 0; i < CASCADE_COUNT; i++)
+	{
+		m_cascades[i] = SHADOW_CASCADE();
+		m_cascades[i].bValid = false;
+		m_cascades[i].bStaticDirty = true;
+	}
+}
+
+/***********************************************************
+ *  ~ShadowMaps()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ShadowMaps::~ShadowMaps()
+{
+	Destroy();
+}
+
+/***********************************************************
+ *  IsSupported()
+ *
+ *  This method is used for checking whether the driver has
+ *  depth cube map arrays for the point light shadows.  The
+ *  OpenGL 3.3 context created on macOS does not, so the
+ *  scene is drawn without shadows there.
+ ***********************************************************/
+bool ShadowMaps::IsSupported()
+{
+	return(GLEW_ARB_texture_cube_map_array);
+}
+
+/***********************************************************
+ *  CreateDepthProgram()
+ *
+ *  This method is used for compiling and linking the depth
+ *  program the casters are drawn with.
+ ***********************************************************/
+GLuint ShadowMaps::CreateDepthProgram()
+{
+	GLuint vertexShader = glCreateShader(GL_VERTEX_SHADER);
+	GLuint fragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+	GLuint program = 0;
+	GLint vertexSuccess = 0;
+	GLint fragmentSuccess = 0;
+	GLint success = 0;
+
+	glShaderSource(vertexShader, 1, &g_DepthVertexShader, NULL);
+	glCompileShader(vertexShader);
+	glGetShaderiv(vertexShader, GL_COMPILE_STATUS, &vertexSuccess);
+	glShaderSource(fragmentShader, 1, &g_DepthFragmentShader, NULL);
+	glCompileShader(fragmentShader);
+	glGetShaderiv(fragmentShader, GL_COMPILE_STATUS, &fragmentSuccess);
+	if ((!vertexSuccess) || (!fragmentSuccess))
+	{
+		std::cout << "Could not compile the shadow depth shaders" << std::endl;
+		glDeleteShader(vertexShader);
+		glDeleteShader(fragmentShader);
+		return(0);
+	}
+
+	program = glCreateProgram();
+	glAttachShader(program, vertexShader);
+	glAttachShader(program, fragmentShader);
+	glLinkProgram(program);
+	glDeleteShader(vertexShader);
+	glDeleteShader(fragmentShader);
+
+	glGetProgramiv(program, GL_LINK_STATUS, &success);
+	if (!success)
+	{
+		std::cout << "Could not link the shadow depth shaders" << std::endl;
+		glDeleteProgram(program);
+		return(0);
+	}
+
+	return(program);
+}
+
+/***********************************************************
+ *  CreateDepthTexture()
+ *
+ *  This method is used for creating a layered depth texture
+ *  that is sampled with hardware comparison, so the shader
+ *  gets filtered shadow values.  The cascades read as fully
+ *  lit outside of their maps.
+ ***********************************************************/
+GLuint ShadowMaps::CreateDepthTexture(GLenum target, int size, int layers)
+{
+	GLuint texture = 0;
+	float borderColor[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+	glGenTextures(1, &texture);
+	glBindTexture(target, texture);
+	glTexImage3D(target, 0, GL_DEPTH_COMPONENT32F, size, size, layers, 0, GL_DEPTH_COMPONENT, GL_FLOAT, NULL);
+
+	glTexParameteri(target, GL_TEXTURE_MAX_LEVEL, 0);
+	glTexParameteri(target, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(target, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexParameteri(target, GL_TEXTURE_COMPARE_MODE, GL_COMPARE_REF_TO_TEXTURE);
+	glTexParameteri(target, GL_TEXTURE_COMPARE_FUNC, GL_LEQUAL);
+	if (GL_TEXTURE_2D_ARRAY == target)
+	{
+		glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_BORDER);
+		glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_BORDER);
+		glTexParameterfv(target, GL_TEXTURE_BORDER_COLOR, borderColor);
+	}
+	else
+	{
+		glTexParameteri(target, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+		glTexParameteri(target, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+		glTexParameteri(target, GL_TEXTURE_WRAP_R, GL_CLAMP_TO_EDGE);
+	}
+	glBindTexture(target, 0);
+
+	return(texture);
+}
+
+/***********************************************************
+ *  Initialize()
+ *
+ *  This method is used for creating the depth program, the
+ *  framebuffer and the maps for the cascades and up to the
+ *  passed in number of point lights.  The second set of
+ *  maps, for the frames with dynamic casters, is only made
+ *  when the static maps can be copied on the GPU; otherwise
+ *  every caster is drawn into the one set every frame.
+ ***********************************************************/
+bool ShadowMaps::Initialize(int pointShadowCount)
+{
+	GLenum status = GL_FRAMEBUFFER_COMPLETE;
+
+	Destroy();
+
+	if (!IsSupported())
+	{
+		return(false);
+	}
+
+	m_depthProgram = CreateDepthProgram();
+	if (0 == m_depthProgram)
+	{
+		return(false);
+	}
+	m_modelLocation = glGetUniformLocation(m_depthProgram, "model");
+	m_viewProjectionLocation = glGetUniformLocation(m_depthProgram, "viewProjection");
+	m_lightPositionFarLocation = glGetUniformLocation(m_depthProgram, "lightPositionFar");
+
+	m_bCaching = GLEW_ARB_copy_image;
+	m_pointShadowCapacity = std::min(std::max(pointShadowCount, 0), (int)MAX_POINT_SHADOWS);
+
+	m_staticCascadeTexture = CreateDepthTexture(GL_TEXTURE_2D_ARRAY, CASCADE_SIZE, CASCADE_COUNT);
+	if (m_bCaching)
+	{
+		m_cascadeTexture = CreateDepthTexture(GL_TEXTURE_2D_ARRAY, CASCADE_SIZE, CASCADE_COUNT);
+	}
+	if (m_pointShadowCapacity > 0)
+	{
+		m_staticPointTexture = CreateDepthTexture(GL_TEXTURE_CUBE_MAP_ARRAY, POINT_SHADOW_SIZE, m_pointShadowCapacity * 6);
+		if (m_bCaching)
+		{
+			m_pointTexture = CreateDepthTexture(GL_TEXTURE_CUBE_MAP_ARRAY, POINT_SHADOW_SIZE, m_pointShadowCapacity * 6);
+		}
+	}
+
+	// the views only write depth, so there is no color buffer
+	glGenFramebuffers(1, &m_framebuffer);
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, m_staticCascadeTexture, 0, 0);
+	glDrawBuffer(GL_NONE);
+	glReadBuffer(GL_NONE);
+	status = glCheckFramebufferStatus(GL_FRAMEBUFFER);
+	glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+	if (GL_FRAMEBUFFER_COMPLETE != status)
+	{
+		std::cout << "Could not create the shadow map framebuffer:" << status << std::endl;
+		Destroy();
+		return(false);
+	}
+
+	std::cout << "Rendering " << CASCADE_COUNT << " shadow cascades and "
+		<< m_pointShadowCapacity << " point light shadows" << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  Destroy()
+ *
+ *  This method is used for freeing the depth program, the
+ *  framebuffer and the maps.
+ ***********************************************************/
+void ShadowMaps::Destroy()
+{
+	GLuint textures[4] = { m_staticCascadeTexture, m_staticPointTexture, m_cascadeTexture, m_pointTexture };
+
+	if (0 != m_depthProgram)
+	{
+		glDeleteProgram(m_depthProgram);
+		m_depthProgram = 0;
+	}
+	if (0 != m_framebuffer)
+	{
+		glDeleteFramebuffers(1, &m_framebuffer);
+		m_framebuffer = 0;
+	}
+	for (int i = 0; i < 4; i++)
+	{
+		if (0 != textures[i])
+		{
+			glDeleteTextures(1, &textures[i]);
+		}
+	}
+
+	m_staticCascadeTexture = 0;
+	m_staticPointTexture = 0;
+	m_cascadeTexture = 0;
+	m_pointTexture = 0;
+	m_pointShadowCapacity = 0;
+	m_bDynamicMaps = false;
+	InvalidateStatic();
+}
+
+/***********************************************************
+ *  SetLights()
+ *
+ *  This method is used for setting the directional light
+ *  and the shadowed point lights, given as their position
+ *  and range.  Only the maps of the lights that changed are
+ *  rendered again, and point lights beyond the ones the
+ *  maps were made for cast no shadows.
+ ***********************************************************/
+void ShadowMaps::SetLights(bool bDirectional, const glm::vec3& direction, const std::vector<glm::vec4>& pointLights)
+{
+	int pointShadowCount = std::min((int)pointLights.size(), m_pointShadowCapacity);
+	glm::vec3 lightDirection = glm::normalize(direction);
+
+	if ((bDirectional != m_bDirectional) || (lightDirection != m_lightDirection))
+	{
+		m_bDirectional = bDirectional;
+		m_lightDirection = lightDirection;
+		for (int i = 0; i < CASCADE_COUNT; i++)
+		{
+			m_cascades[i].bValid = false;
+		}
+	}
+
+	m_pointShadows.resize(pointShadowCount);
+	for (int i = 0; i < pointShadowCount; i++)
+	{
+		glm::vec3 position = glm::vec3(pointLights[i]);
+		float range = pointLights[i].w;
+
+		if ((m_pointShadows[i].position != position) || (m_pointShadows[i].range != range))
+		{
+			m_pointShadows[i].position = position;
+			m_pointShadows[i].range = range;
+			m_pointShadows[i].bStaticDirty = true;
+		}
+	}
+}
+
+/***********************************************************
+ *  InvalidateStatic()
+ *
+ *  This method is used for marking every static map as
+ *  stale, after static objects were added, removed or
+ *  turned into dynamic casters.
+ ***********************************************************/
+void ShadowMaps::InvalidateStatic()
+{
+	for (int i = 0; i < CASCADE_COUNT; i++)
+	{
+		m_cascades[i].bStaticDirty = true;
+	}
+	for (int i = 0; i < m_pointShadows.size(); i++)
+	{
+		m_pointShadows[i].bStaticDirty = true;
+	}
+}
+
+/***********************************************************
+ *  FitCascade()
+ *
+ *  This method is used for fitting a cascade around the
+ *  slice of the view frustum between two view depths.  The
+ *  slice is bounded by a sphere, so the size of the cascade
+ *  does not change as the camera turns, and the cascade is
+ *  made a margin larger than the sphere.  It is only fit
+ *  again once the sphere leaves it, and then its center is
+ *  snapped to whole texels of the map, so the edges of the
+ *  shadows do not crawl as the camera moves.
+ ***********************************************************/
+void ShadowMaps::FitCascade(
+	SHADOW_CASCADE& cascade,
+	const glm::mat4& inverseViewProjection,
+	float nearPlane,
+	float farPlane,
+	float sliceNear,
+	float sliceFar)
+{
+	glm::vec3 corners[8];
+	glm::vec3 center(0.0f);
+	float radius = 0.0f;
+	float nearT = (sliceNear - nearPlane) / (farPlane - nearPlane);
+	float farT = (sliceFar - nearPlane) / (farPlane - nearPlane);
+
+	// the view depth changes evenly along each frustum edge
+	for (int i = 0; i < 4; i++)
+	{
+		glm::vec4 nearCorner = inverseViewProjection * glm::vec4((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, -1.0f, 1.0f);
+		glm::vec4 farCorner = inverseViewProjection * glm::vec4((i & 1) ? 1.0f : -1.0f, (i & 2) ? 1.0f : -1.0f, 1.0f, 1.0f);
+		glm::vec3 edgeStart = glm::vec3(nearCorner) / nearCorner.w;
+		glm::vec3 edgeEnd = glm::vec3(farCorner) / farCorner.w;
+
+		corners[i] = glm::mix(edgeStart, edgeEnd, nearT);
+		corners[i + 4] = glm::mix(edgeStart, edgeEnd, farT);
+		center += corners[i] + corners[i + 4];
+	}
+	center = center / 8.0f;
+	for (int i = 0; i < 8; i++)
+	{
+		radius = std::max(radius, glm::length(corners[i] - center));
+	}
+	// round the radius up so small changes give the same size
+	radius = ceilf(radius * 16.0f) / 16.0f;
+
+	cascade.splitDepth = sliceFar;
+
+	if (cascade.bValid && (radius <= cascade.radius) &&
+		(glm::length(center - cascade.center) + radius <= cascade.radius * (1.0f + g_CascadeMargin)))
+	{
+		return;
+	}
+
+	float extent = radius * (1.0f + g_CascadeMargin);
+	float texelSize = (2.0f * extent) / CASCADE_SIZE;
+	glm::vec3 up = (fabsf(m_lightDirection.y) > 0.99f) ? glm::vec3(0.0f, 0.0f, 1.0f) : glm::vec3(0.0f, 1.0f, 0.0f);
+	glm::mat4 lightRotation = glm::lookAt(glm::vec3(0.0f), m_lightDirection, up);
+	glm::vec4 lightCenter = lightRotation * glm::vec4(center, 1.0f);
+
+	lightCenter.x = floorf(lightCenter.x / texelSize) * texelSize;
+	lightCenter.y = floorf(lightCenter.y / texelSize) * texelSize;
+	center = glm::vec3(glm::inverse(lightRotation) * lightCenter);
+
+	glm::mat4 lightView = glm::lookAt(center - (m_lightDirection * (extent + g_ShadowCasterDistance)), center, up);
+	glm::mat4 lightProjection = glm::ortho(-extent, extent, -extent, extent, 0.0f, (2.0f * extent) + g_ShadowCasterDistance);
+
+	cascade.center = center;
+	cascade.radius = radius;
+	cascade.viewProjection = lightProjection * lightView;
+	cascade.bValid = true;
+	cascade.bStaticDirty = true;
+}
+
+/***********************************************************
+ *  GetCubeFaceMatrix()
+ *
+ *  This method is used for getting the view projection of
+ *  one cube map face of a point light, in the order of the
+ *  cube map layers.
+ ***********************************************************/
+glm::mat4 ShadowMaps::GetCubeFaceMatrix(const POINT_SHADOW& pointShadow, int face)
+{
+	glm::mat4 projection = glm::perspective(glm::radians(90.0f), 1.0f, g_PointShadowNear, pointShadow.range);
+	glm::mat4 view = glm::lookAt(
+		pointShadow.position,
+		pointShadow.position + g_CubeFaceDirections[face],
+		g_CubeFaceUps[face]);
+
+	return(projection * view);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for fitting the cascades to the view
+ *  of the frame and getting the shadow views that have to
+ *  be rendered.  The stale static maps come first.  When
+ *  there are dynamic casters, every map is then copied from
+ *  its static map and the dynamic casters are drawn over it.
+ ***********************************************************/
+void ShadowMaps::Update(
+	const glm::mat4& view,
+	const glm::mat4& projection,
+	bool bDynamicCasters,
+	std::vector<SHADOW_VIEW>& views)
+{
+	SHADOW_VIEW shadowView;
+
+	views.clear();
+	if (!IsReady())
+	{
+		return;
+	}
+
+	m_bDynamicMaps = m_bCaching && bDynamicCasters;
+
+	if (m_bDirectional)
+	{
+		float nearPlane = 0.0f;
+		float farPlane = 0.0f;
+
+		if (projection[2][3] != 0.0f)
+		{
+			nearPlane = projection[3][2] / (projection[2][2] - 1.0f);
+			farPlane = projection[3][2] / (projection[2][2] + 1.0f);
+		}
+		else
+		{
+			nearPlane = (projection[3][2] + 1.0f) / projection[2][2];
+			farPlane = (projection[3][2] - 1.0f) / projection[2][2];
+		}
+
+		glm::mat4 inverseViewProjection = glm::inverse(projection * view);
+		float shadowFar = std::min(farPlane, g_ShadowDistance);
+		float sliceNear = nearPlane;
+
+		for (int i = 0; i < CASCADE_COUNT; i++)
+		{
+			float share = (float)(i + 1) / CASCADE_COUNT;
+			float logSplit = nearPlane * powf(shadowFar / nearPlane, share);
+			float evenSplit = nearPlane + ((shadowFar - nearPlane) * share);
+			float sliceFar = (g_CascadeSplitLambda * logSplit) + ((1.0f - g_CascadeSplitLambda) * evenSplit);
+
+			FitCascade(m_cascades[i], inverseViewProjection, nearPlane, farPlane, sliceNear, sliceFar);
+			sliceNear = sliceFar;
+
+			if ((!m_bCaching) || m_cascades[i].bStaticDirty)
+			{
+				shadowView.viewProjection = m_cascades[i].viewProjection;
+				shadowView.frustum.SetViewProjection(shadowView.viewProjection);
+				shadowView.lightPositionFar = glm::vec4(0.0f);
+				shadowView.texture = m_staticCascadeTexture;
+				shadowView.target = GL_TEXTURE_2D_ARRAY;
+				shadowView.layer = i;
+				shadowView.size = CASCADE_SIZE;
+				shadowView.casters = m_bCaching ? CASTERS_STATIC : CASTERS_ALL;
+				shadowView.staticTexture = 0;
+				views.push_back(shadowView);
+				m_cascades[i].bStaticDirty = false;
+			}
+		}
+	}
+
+	for (int i = 0; i < m_pointShadows.size(); i++)
+	{
+		if (m_bCaching && (!m_pointShadows[i].bStaticDirty))
+		{
+			continue;
+		}
+
+		for (int face = 0; face < 6; face++)
+		{
+			shadowView.viewProjection = GetCubeFaceMatrix(m_pointShadows[i], face);
+			shadowView.frustum.SetViewProjection(shadowView.viewProjection);
+			shadowView.lightPositionFar = glm::vec4(m_pointShadows[i].position, m_pointShadows[i].range);
+			shadowView.texture = m_staticPointTexture;
+			shadowView.target = GL_TEXTURE_CUBE_MAP_ARRAY;
+			shadowView.layer = (i * 6) + face;
+			shadowView.size = POINT_SHADOW_SIZE;
+			shadowView.casters = m_bCaching ? CASTERS_STATIC : CASTERS_ALL;
+			shadowView.staticTexture = 0;
+			views.push_back(shadowView);
+		}
+		m_pointShadows[i].bStaticDirty = false;
+	}
+
+	if (!m_bDynamicMaps)
+	{
+		return;
+	}
+
+	// the dynamic casters go over a copy of every static map
+	for (int i = 0; (m_bDirectional) && (i < CASCADE_COUNT); i++)
+	{
+		shadowView.viewProjection = m_cascades[i].viewProjection;
+		shadowView.frustum.SetViewProjection(shadowView.viewProjection);
+		shadowView.lightPositionFar = glm::vec4(0.0f);
+		shadowView.texture = m_cascadeTexture;
+		shadowView.target = GL_TEXTURE_2D_ARRAY;
+		shadowView.layer = i;
+		shadowView.size = CASCADE_SIZE;
+		shadowView.casters = CASTERS_DYNAMIC;
+		shadowView.staticTexture = m_staticCascadeTexture;
+		views.push_back(shadowView);
+	}
+	for (int i = 0; i < m_pointShadows.size(); i++)
+	{
+		for (int face = 0; face < 6; face++)
+		{
+			shadowView.viewProjection = GetCubeFaceMatrix(m_pointShadows[i], face);
+			shadowView.frustum.SetViewProjection(shadowView.viewProjection);
+			shadowView.lightPositionFar = glm::vec4(m_pointShadows[i].position, m_pointShadows[i].range);
+			shadowView.texture = m_pointTexture;
+			shadowView.target = GL_TEXTURE_CUBE_MAP_ARRAY;
+			shadowView.layer = (i * 6) + face;
+			shadowView.size = POINT_SHADOW_SIZE;
+			shadowView.casters = CASTERS_DYNAMIC;
+			shadowView.staticTexture = m_staticPointTexture;
+			views.push_back(shadowView);
+		}
+	}
+}
+
+/***********************************************************
+ *  BeginPass()
+ *
+ *  This method is used for switching to the depth program
+ *  and the shadow framebuffer before the shadow views are
+ *  rendered.  The framebuffer, viewport and program in use
+ *  are kept to be restored by EndPass().
+ ***********************************************************/
+void ShadowMaps::BeginPass()
+{
+	glGetIntegerv(GL_DRAW_FRAMEBUFFER_BINDING, &m_previousFramebuffer);
+	glGetIntegerv(GL_CURRENT_PROGRAM, &m_previousProgram);
+	glGetIntegerv(GL_VIEWPORT, m_previousViewport);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_framebuffer);
+	glUseProgram(m_depthProgram);
+
+	glEnable(GL_DEPTH_TEST);
+	glDepthMask(GL_TRUE);
+	glDisable(GL_BLEND);
+	// the offset only moves the rasterized depth of the cascades,
+	// the point light distance is biased when it is compared
+	glEnable(GL_POLYGON_OFFSET_FILL);
+	glPolygonOffset(g_DepthOffsetFactor, g_DepthOffsetUnits);
+}
+
+/***********************************************************
+ *  EndPass()
+ *
+ *  This method is used for restoring the framebuffer, the
+ *  viewport and the program that were in use before the
+ *  shadow views were rendered.
+ ***********************************************************/
+void ShadowMaps::EndPass()
+{
+	glDisable(GL_POLYGON_OFFSET_FILL);
+
+	glBindFramebuffer(GL_FRAMEBUFFER, m_previousFramebuffer);
+	glViewport(m_previousViewport[0], m_previousViewport[1], m_previousViewport[2], m_previousViewport[3]);
+	glUseProgram(m_previousProgram);
+}
+
+/***********************************************************
+ *  BeginView()
+ *
+ *  This method is used for attaching the map layer of a
+ *  shadow view, which is cleared for the static casters or
+ *  copied from the static map for the dynamic casters, and
+ *  setting the view into the depth program.
+ ***********************************************************/
+void ShadowMaps::BeginView(const SHADOW_VIEW& view)
+{
+	if (CASTERS_DYNAMIC == view.casters)
+	{
+		glCopyImageSubData(
+			view.staticTexture, view.target, 0, 0, 0, view.layer,
+			view.texture, view.target, 0, 0, 0, view.layer,
+			view.size, view.size, 1);
+	}
+
+	glFramebufferTextureLayer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, view.texture, 0, view.layer);
+	glViewport(0, 0, view.size, view.size);
+
+	if (CASTERS_DYNAMIC != view.casters)
+	{
+		glClear(GL_DEPTH_BUFFER_BIT);
+	}
+
+	glUniformMatrix4fv(m_viewProjectionLocation, 1, GL_FALSE, glm::value_ptr(view.viewProjection));
+	glUniform4fv(m_lightPositionFarLocation, 1, glm::value_ptr(view.lightPositionFar));
+}
+
+/***********************************************************
+ *  SetModel()
+ *
+ *  This method is used for setting the model matrix of the
+ *  next caster into the depth program.
+ ***********************************************************/
+void ShadowMaps::SetModel(const glm::mat4& model)
+{
+	glUniformMatrix4fv(m_modelLocation, 1, GL_FALSE, glm::value_ptr(model));
+}
+
+/***********************************************************
+ *  BindTextures()
+ *
+ *  This method is used for binding the cascades and the
+ *  point light cube maps to the passed in texture unit and
+ *  the one after it.  The frames with dynamic casters read
+ *  the maps they were drawn into, the others read the
+ *  static maps directly.
+ ***********************************************************/
+void ShadowMaps::BindTextures(int firstUnit) const
+{
+	glActiveTexture(GL_TEXTURE0 + firstUnit);
+	glBindTexture(GL_TEXTURE_2D_ARRAY, m_bDynamicMaps ? m_cascadeTexture : m_staticCascadeTexture);
+	glActiveTexture(GL_TEXTURE0 + firstUnit + 1);
+	glBindTexture(GL_TEXTURE_CUBE_MAP_ARRAY, m_bDynamicMaps ? m_pointTexture : m_staticPointTexture);
+	glActiveTexture(GL_TEXTURE0);
+}
+
+/***********************************************************
+ *  GetShadowData()
+ *
+ *  This method is used for getting the values the scene
+ *  shader samples the maps with.  The cascade matrices go
+ *  from world space straight to map texture coordinates.
+ ***********************************************************/
+void ShadowMaps::GetShadowData(UniformCache::SHADOW_BLOCK& shadows) const
+{
+	// maps clip space into texture coordinates and depth
+	const glm::mat4 textureBias(
+		glm::vec4(0.5f, 0.0f, 0.0f, 0.0f),
+		glm::vec4(0.0f, 0.5f, 0.0f, 0.0f),
+		glm::vec4(0.0f, 0.0f, 0.5f, 0.0f),
+		glm::vec4(0.5f, 0.5f, 0.5f, 1.0f));
+
+	shadows = UniformCache::SHADOW_BLOCK();
+
+	shadows.cascadeCount = m_bDirectional ? CASCADE_COUNT : 0;
+	for (int i = 0; i < CASCADE_COUNT; i++)
+	{
+		shadows.cascadeMatrices[i] = textureBias * m_cascades[i].viewProjection;
+		shadows.cascadeSplits[i] = m_cascades[i].splitDepth;
+	}
+	for (int i = 0; i < m_pointShadows.size(); i++)
+	{
+		shadows.pointShadows[i] = glm::vec4(m_pointShadows[i].position, m_pointShadows[i].range);
+	}
+	shadows.pointShadowBias = g_PointShadowBias;
+}
+
+/***********************************************************
+ *  IsReady()
+ *
+ *  This method is used for checking whether the depth
+ *  program, framebuffer and maps have been created.
+ ***********************************************************/
+bool ShadowMaps::IsReady() const
+{
+	return((0 != m_depthProgram) && (0 != m_framebuffer));
+}
@@ -0,0 +1,171 @@
+///////////////////////////////////////////////////////////////////////////////
+// shadowmaps.h
+// ============
+// render and cache the shadow maps of the directional and point lights
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Frustum.h"
+#include "UniformCache.h"
+
+#include <GL/glew.h>
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  ShadowMaps
+ *
+ *  This class keeps the depth maps the scene shader reads
+ *  its shadows from.  The directional light gets a cascade
+ *  of orthographic maps, each fit around a slice of the view
+ *  frustum, and every shadowed point light gets one layer of
+ *  a cube map array that holds the distance to the light.
+ *
+ *  The static casters are rendered into their own maps, and
+ *  those are only rendered again when the lights or static
+ *  objects change, or when the camera moved a cascade past
+ *  its margin.  Objects that have moved are dynamic casters,
+ *  which are drawn every frame over a copy of the static
+ *  maps.  The owner of the casters draws them, this class
+ *  only chooses the views that need rendering and sets up
+ *  the depth pass for each of them.
+ ***********************************************************/
+class ShadowMaps
+{
+public:
+	// constructor
+	ShadowMaps();
+	// destructor
+	~ShadowMaps();
+
+	// number of directional cascades and the size of their maps
+	static const int CASCADE_COUNT = UniformCache::MAX_SHADOW_CASCADES;
+	static const int CASCADE_SIZE = 2048;
+	// the most shadowed point lights and the size of their cube faces
+	static const int MAX_POINT_SHADOWS = UniformCache::MAX_POINT_LIGHTS;
+	static const int POINT_SHADOW_SIZE = 512;
+	// texture units the maps take, starting with the cascades
+	static const int TEXTURE_UNIT_COUNT = 2;
+
+	// the casters drawn into a shadow view
+	enum SHADOW_CASTERS
+	{
+		CASTERS_STATIC = 0,
+		CASTERS_DYNAMIC,
+		CASTERS_ALL
+	};
+
+	// one cascade or cube face that is rendered this frame
+	struct SHADOW_VIEW
+	{
+		glm::mat4 viewProjection;
+		// frustum of the view, for culling the casters
+		Frustum frustum;
+		// light position and far plane of a cube face, w is 0 for a cascade
+		glm::vec4 lightPositionFar;
+		// texture and layer the view renders into
+		GLuint texture;
+		GLenum target;
+		int layer;
+		int size;
+		// static maps are cleared first, dynamic maps start as a copy of the static layer
+		SHADOW_CASTERS casters;
+		GLuint staticTexture;
+	};
+
+private:
+	// a cascade fit around one slice of the view frustum
+	struct SHADOW_CASCADE
+	{
+		glm::vec3 center;
+		float radius;
+		glm::mat4 viewProjection;
+		// view depth where the cascade ends
+		float splitDepth;
+		// true once the cascade has been fit, and when its static map is stale
+		bool bValid;
+		bool bStaticDirty;
+	};
+
+	// one shadowed point light
+	struct POINT_SHADOW
+	{
+		glm::vec3 position;
+		float range;
+		bool bStaticDirty;
+	};
+
+	// depth program that renders the casters
+	GLuint m_depthProgram;
+	GLint m_modelLocation;
+	GLint m_viewProjectionLocation;
+	GLint m_lightPositionFarLocation;
+	// framebuffer the shadow views are rendered through
+	GLuint m_framebuffer;
+	// maps of the static casters, and of every caster for frames with dynamic casters
+	GLuint m_staticCascadeTexture;
+	GLuint m_staticPointTexture;
+	GLuint m_cascadeTexture;
+	GLuint m_pointTexture;
+	// true when the static maps can be copied on the GPU and so can be cached
+	bool m_bCaching;
+	// true when the frame's dynamic casters were drawn into the second maps
+	bool m_bDynamicMaps;
+	// light direction and the cascades of the directional light
+	glm::vec3 m_lightDirection;
+	bool m_bDirectional;
+	SHADOW_CASCADE m_cascades[CASCADE_COUNT];
+	// shadowed point lights and the cube maps made for them
+	std::vector<POINT_SHADOW> m_pointShadows;
+	int m_pointShadowCapacity;
+	// state restored after the depth pass
+	GLint m_previousFramebuffer;
+	GLint m_previousProgram;
+	GLint m_previousViewport[4];
+
+	// compile and link the depth program
+	static GLuint CreateDepthProgram();
+	// create a depth texture with hardware comparison
+	static GLuint CreateDepthTexture(GLenum target, int size, int layers);
+	// fit a cascade around the slice of the view between two depths
+	void FitCascade(SHADOW_CASCADE& cascade, const glm::mat4& inverseViewProjection, float nearPlane, float farPlane, float sliceNear, float sliceFar);
+	// get the view projection of a cube face of a point light
+	static glm::mat4 GetCubeFaceMatrix(const POINT_SHADOW& pointShadow, int face);
+
+public:
+	// check whether the driver has depth cube map arrays
+	static bool IsSupported();
+
+	// create the depth program, framebuffer and maps for up to the passed in point lights
+	bool Initialize(int pointShadowCount);
+	// free the depth program, framebuffer and maps
+	void Destroy();
+
+	// set the directional light, the shadowed point lights as position and range
+	void SetLights(bool bDirectional, const glm::vec3& direction, const std::vector<glm::vec4>& pointLights);
+	// mark the static maps as stale after static objects changed
+	void InvalidateStatic();
+
+	// fit the cascades to the view and get the shadow views to render this frame
+	void Update(const glm::mat4& view, const glm::mat4& projection, bool bDynamicCasters, std::vector<SHADOW_VIEW>& views);
+	// set up the depth pass and restore the previous state afterwards
+	void BeginPass();
+	void EndPass();
+	// attach the map of a shadow view and clear or copy it
+	void BeginView(const SHADOW_VIEW& view);
+	// set the model matrix of the next caster
+	void SetModel(const glm::mat4& model);
+
+	// bind the maps the frame samples, starting at the passed in unit
+	void BindTextures(int firstUnit) const;
+	// get the values the scene shader samples the maps with
+	void GetShadowData(UniformCache::SHADOW_BLOCK& shadows) const;
+	// check whether the maps have been created
+	bool IsReady() const;
+};
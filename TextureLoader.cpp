@@ -0,0 +1,755 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.cpp
+// ============
+// decode texture images on worker threads and stream them to the GPU
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TextureLoader.h"
+
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+// declaration of global variables and defines
+namespace
+{
+	// DDS file magic number and pixel format four character codes
+	const uint32_t g_DDSMagic = 0x20534444;          // "DDS "
+	const uint32_t g_FourCCDXT1 = 0x31545844;        // "DXT1"
+	const uint32_t g_FourCCDXT5 = 0x35545844;        // "DXT5"
+	const uint32_t g_FourCCDX10 = 0x30315844;        // "DX10"
+	// offsets of the DDS header values, counted from the magic number
+	const size_t g_DDSHeightOffset = 12;
+	const size_t g_DDSWidthOffset = 16;
+	const size_t g_DDSMipCountOffset = 28;
+	const size_t g_DDSFourCCOffset = 84;
+	const size_t g_DDSDataOffset = 128;
+	const size_t g_DDSDX10DataOffset = 148;
+	// DXGI formats from the DDS DX10 header
+	const uint32_t g_DXGIFormatBC1 = 71;
+	const uint32_t g_DXGIFormatBC3 = 77;
+	const uint32_t g_DXGIFormatBC7 = 98;
+
+	// KTX2 file identifier and the Vulkan formats of BC1, BC3 and BC7
+	const unsigned char g_KTX2Identifier[12] = { 0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A };
+	const uint32_t g_VkFormatBC1RGB = 131;
+	const uint32_t g_VkFormatBC1RGBA = 133;
+	const uint32_t g_VkFormatBC3 = 137;
+	const uint32_t g_VkFormatBC7 = 145;
+	// size of the KTX2 header and index before the level index
+	const size_t g_KTX2LevelIndexOffset = 80;
+
+	// read a little endian value out of a file in memory
+	template <typename T>
+	T ReadValue(const std::vector<unsigned char>& file, size_t offset)
+	{
+		T value = 0;
+		memcpy(&value, &file[offset], sizeof(T));
+		return(value);
+	}
+
+	// check whether the passed in file name ends with an extension
+	bool HasExtension(const std::string& filename, const std::string& extension)
+	{
+		return((filename.size() >= extension.size()) &&
+			(filename.compare(filename.size() - extension.size(), extension.size(), extension) == 0));
+	}
+
+	// check whether the driver can sample the passed in compressed format
+	bool IsFormatSupported(GLenum format)
+	{
+		if (format == GL_COMPRESSED_RGBA_BPTC_UNORM)
+		{
+			return(GLEW_ARB_texture_compression_bptc);
+		}
+		return(GLEW_EXT_texture_compression_s3tc);
+	}
+}
+
+/***********************************************************
+ *  TextureLoader()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TextureLoader::TextureLoader()
+{
+	m_imagesInFlight = 0;
+	m_bStopWorkers = false;
+	m_stagingBuffer = 0;
+	m_pStagingMemory = NULL;
+	m_stagingRegionSize = 0;
+	for (int i = 0; i < STAGING_REGIONS; i++)
+	{
+		m_stagingFences[i] = NULL;
+	}
+	m_nextStagingRegion = 0;
+}
+
+/***********************************************************
+ *  ~TextureLoader()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TextureLoader::~TextureLoader()
+{
+	StopWorkers();
+	DestroyStagingBuffer();
+
+	// free any images that were never uploaded
+	for (int i = 0; i < m_pendingImages.size(); i++)
+	{
+		stbi_image_free(m_pendingImages[i].pixels);
+	}
+	for (int i = 0; i < m_decodedImages.size(); i++)
+	{
+		stbi_image_free(m_decodedImages[i].pixels);
+	}
+}
+
+/***********************************************************
+ *  StartWorkers()
+ *
+ *  This method is used for starting the worker threads that
+ *  decode the queued image files.
+ ***********************************************************/
+void TextureLoader::StartWorkers(int threadCount)
+{
+	if (m_workers.size() > 0)
+	{
+		return;
+	}
+
+	// indicate to always flip images vertically when loaded, this is
+	// set once here because the flag is shared by all of the workers
+	stbi_set_flip_vertically_on_load(true);
+
+	m_bStopWorkers = false;
+	for (int i = 0; i < threadCount; i++)
+	{
+		m_workers.push_back(std::thread(&TextureLoader::WorkerLoop, this));
+	}
+}
+
+/***********************************************************
+ *  StopWorkers()
+ *
+ *  This method is used for stopping and joining all of the
+ *  worker threads.
+ ***********************************************************/
+void TextureLoader::StopWorkers()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_bStopWorkers = true;
+	}
+	m_workAvailable.notify_all();
+
+	for (int i = 0; i < m_workers.size(); i++)
+	{
+		m_workers[i].join();
+	}
+	m_workers.clear();
+}
+
+/***********************************************************
+ *  WorkerLoop()
+ *
+ *  This method is run by every worker thread.  It takes the
+ *  next queued image file, decodes it, and hands the pixels
+ *  back for uploading.
+ ***********************************************************/
+void TextureLoader::WorkerLoop()
+{
+	while (true)
+	{
+		DECODED_IMAGE image;
+
+		{
+			std::unique_lock<std::mutex> lock(m_mutex);
+			m_workAvailable.wait(lock, [this] { return (m_bStopWorkers || (m_pendingImages.size() > 0)); });
+
+			if (m_bStopWorkers)
+			{
+				return;
+			}
+
+			image = m_pendingImages.front();
+			m_pendingImages.pop_front();
+		}
+
+		std::string compressedFile;
+
+		// use a pre-compressed version of the image with baked mipmaps when
+		// there is one, otherwise parse the image data from the image file
+		if ((FindCompressedFile(image.filename, compressedFile) == false) ||
+			(LoadCompressedImage(compressedFile, image) == false))
+		{
+			image.pixels = stbi_load(
+				image.filename.c_str(),
+				&image.width,
+				&image.height,
+				&image.colorChannels,
+				0);
+
+			image.internalFormat = (image.colorChannels == 4) ? GL_RGBA8 : GL_RGB8;
+			image.mipLevels = FullMipLevels(image.width, image.height);
+		}
+
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_decodedImages.push_back(image);
+	}
+}
+
+/***********************************************************
+ *  CreateStagingBuffer()
+ *
+ *  This method is used for creating the pixel buffer that
+ *  the decoded images are copied into before uploading.  The
+ *  buffer stays mapped for its whole lifetime and is split
+ *  into regions that are reused once the GPU is done with
+ *  them.  False is returned when persistent mapping is not
+ *  supported, and images are then uploaded directly.
+ ***********************************************************/
+bool TextureLoader::CreateStagingBuffer(GLsizeiptr regionSize)
+{
+	GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+	if (!GLEW_ARB_buffer_storage)
+	{
+		return(false);
+	}
+
+	glGenBuffers(1, &m_stagingBuffer);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_stagingBuffer);
+	glBufferStorage(GL_PIXEL_UNPACK_BUFFER, regionSize * STAGING_REGIONS, NULL, flags);
+	m_pStagingMemory = (unsigned char*)glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, regionSize * STAGING_REGIONS, flags);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+
+	if (NULL == m_pStagingMemory)
+	{
+		DestroyStagingBuffer();
+		return(false);
+	}
+
+	m_stagingRegionSize = regionSize;
+
+	return(true);
+}
+
+/***********************************************************
+ *  DestroyStagingBuffer()
+ *
+ *  This method is used for freeing the staging buffer.
+ ***********************************************************/
+void TextureLoader::DestroyStagingBuffer()
+{
+	for (int i = 0; i < STAGING_REGIONS; i++)
+	{
+		if (NULL != m_stagingFences[i])
+		{
+			glDeleteSync(m_stagingFences[i]);
+			m_stagingFences[i] = NULL;
+		}
+	}
+
+	if (0 != m_stagingBuffer)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_stagingBuffer);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		glDeleteBuffers(1, &m_stagingBuffer);
+		m_stagingBuffer = 0;
+	}
+
+	m_pStagingMemory = NULL;
+	m_stagingRegionSize = 0;
+}
+
+/***********************************************************
+ *  FullMipLevels()
+ *
+ *  This method is used for getting the number of mipmap
+ *  levels in a full chain down to one pixel.
+ ***********************************************************/
+int TextureLoader::FullMipLevels(int width, int height)
+{
+	return(1 + (int)std::floor(std::log2((float)std::max(std::max(width, height), 1))));
+}
+
+/***********************************************************
+ *  FindCompressedFile()
+ *
+ *  This method is used for finding a pre-compressed version
+ *  of an image file.  A KTX2 or DDS file is used as is, and
+ *  for any other image a KTX2 or DDS file with the same name
+ *  next to it is used instead when one exists.
+ ***********************************************************/
+bool TextureLoader::FindCompressedFile(const std::string& filename, std::string& compressedFile)
+{
+	if (HasExtension(filename, ".ktx2") || HasExtension(filename, ".dds"))
+	{
+		compressedFile = filename;
+		return(true);
+	}
+
+	size_t extension = filename.find_last_of('.');
+	if (extension == std::string::npos)
+	{
+		return(false);
+	}
+
+	const char* candidates[2] = { ".ktx2", ".dds" };
+	for (int i = 0; i < 2; i++)
+	{
+		std::string candidate = filename.substr(0, extension) + candidates[i];
+		std::ifstream file(candidate.c_str(), std::ios::binary);
+		if (file.good())
+		{
+			compressedFile = candidate;
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  LoadCompressedImage()
+ *
+ *  This method is used for reading a pre-compressed image
+ *  file with all of its mipmap levels.  False is returned
+ *  when the file can not be read, is not BC1, BC3 or BC7, or
+ *  the driver can not sample its format.
+ ***********************************************************/
+bool TextureLoader::LoadCompressedImage(const std::string& filename, DECODED_IMAGE& image)
+{
+	std::ifstream file(filename.c_str(), std::ios::binary);
+	std::vector<unsigned char> contents;
+	bool bParsed = false;
+
+	if (!file.good())
+	{
+		return(false);
+	}
+
+	contents.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+
+	if (HasExtension(filename, ".ktx2"))
+	{
+		bParsed = ParseKTX2(contents, image);
+	}
+	else
+	{
+		bParsed = ParseDDS(contents, image);
+	}
+
+	if ((bParsed == false) || (IsFormatSupported(image.internalFormat) == false))
+	{
+		std::cout << "Could not use compressed image:" << filename << std::endl;
+		image.compressedData.clear();
+		image.levels.clear();
+		return(false);
+	}
+
+	image.filename = filename;
+	image.bCompressed = true;
+	image.mipLevels = image.levels.size();
+	image.colorChannels = 4;
+
+	return(true);
+}
+
+/***********************************************************
+ *  AddCompressedLevels()
+ *
+ *  This method is used for filling in the offset and size of
+ *  every mipmap level of a block compressed image, where the
+ *  levels follow each other from the passed in data offset.
+ ***********************************************************/
+void TextureLoader::AddCompressedLevels(DECODED_IMAGE& image, size_t dataOffset, int levelCount)
+{
+	size_t blockSize = ((image.internalFormat == GL_COMPRESSED_RGB_S3TC_DXT1_EXT) ||
+		(image.internalFormat == GL_COMPRESSED_RGBA_S3TC_DXT1_EXT)) ? 8 : 16;
+	size_t offset = dataOffset;
+	int width = image.width;
+	int height = image.height;
+
+	for (int i = 0; i < levelCount; i++)
+	{
+		COMPRESSED_LEVEL level;
+
+		level.offset = offset;
+		level.size = (size_t)std::max((width + 3) / 4, 1) * std::max((height + 3) / 4, 1) * blockSize;
+		level.width = width;
+		level.height = height;
+
+		// stop at the first level that the file is too short for
+		if (level.offset + level.size > image.compressedData.size())
+		{
+			return;
+		}
+
+		image.levels.push_back(level);
+		offset += level.size;
+		width = std::max(width / 2, 1);
+		height = std::max(height / 2, 1);
+	}
+}
+
+/***********************************************************
+ *  ParseDDS()
+ *
+ *  This method is used for reading the mipmap levels of a
+ *  DDS file with BC1 (DXT1), BC3 (DXT5) or BC7 data.
+ ***********************************************************/
+bool TextureLoader::ParseDDS(const std::vector<unsigned char>& file, DECODED_IMAGE& image)
+{
+	size_t dataOffset = g_DDSDataOffset;
+
+	if ((file.size() < g_DDSDataOffset) || (ReadValue<uint32_t>(file, 0) != g_DDSMagic))
+	{
+		return(false);
+	}
+
+	image.height = ReadValue<uint32_t>(file, g_DDSHeightOffset);
+	image.width = ReadValue<uint32_t>(file, g_DDSWidthOffset);
+	int levelCount = std::max((int)ReadValue<uint32_t>(file, g_DDSMipCountOffset), 1);
+	uint32_t fourCC = ReadValue<uint32_t>(file, g_DDSFourCCOffset);
+
+	if (fourCC == g_FourCCDXT1)
+	{
+		image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+	}
+	else if (fourCC == g_FourCCDXT5)
+	{
+		image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	}
+	else if ((fourCC == g_FourCCDX10) && (file.size() >= g_DDSDX10DataOffset))
+	{
+		uint32_t dxgiFormat = ReadValue<uint32_t>(file, g_DDSDataOffset);
+		dataOffset = g_DDSDX10DataOffset;
+
+		if (dxgiFormat == g_DXGIFormatBC1)
+			image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+		else if (dxgiFormat == g_DXGIFormatBC3)
+			image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+		else if (dxgiFormat == g_DXGIFormatBC7)
+			image.internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+		else
+			return(false);
+	}
+	else
+	{
+		return(false);
+	}
+
+	image.compressedData = file;
+	AddCompressedLevels(image, dataOffset, levelCount);
+
+	return(image.levels.size() > 0);
+}
+
+/***********************************************************
+ *  ParseKTX2()
+ *
+ *  This method is used for reading the mipmap levels of a
+ *  KTX2 file with BC1, BC3 or BC7 data.  Supercompressed
+ *  files are not supported.
+ ***********************************************************/
+bool TextureLoader::ParseKTX2(const std::vector<unsigned char>& file, DECODED_IMAGE& image)
+{
+	if ((file.size() < g_KTX2LevelIndexOffset) || (memcmp(&file[0], g_KTX2Identifier, sizeof(g_KTX2Identifier)) != 0))
+	{
+		return(false);
+	}
+
+	uint32_t vkFormat = ReadValue<uint32_t>(file, 12);
+	image.width = ReadValue<uint32_t>(file, 20);
+	image.height = ReadValue<uint32_t>(file, 24);
+	int levelCount = std::max((int)ReadValue<uint32_t>(file, 40), 1);
+	uint32_t supercompression = ReadValue<uint32_t>(file, 44);
+
+	if (supercompression != 0)
+	{
+		return(false);
+	}
+
+	if (vkFormat == g_VkFormatBC1RGB)
+		image.internalFormat = GL_COMPRESSED_RGB_S3TC_DXT1_EXT;
+	else if (vkFormat == g_VkFormatBC1RGBA)
+		image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT;
+	else if (vkFormat == g_VkFormatBC3)
+		image.internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT;
+	else if (vkFormat == g_VkFormatBC7)
+		image.internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM;
+	else
+		return(false);
+
+	image.compressedData = file;
+
+	// the level index lists every level, largest first
+	for (int i = 0; i < levelCount; i++)
+	{
+		size_t indexOffset = g_KTX2LevelIndexOffset + (i * 24);
+		COMPRESSED_LEVEL level;
+
+		if (indexOffset + 24 > file.size())
+		{
+			break;
+		}
+
+		level.offset = (size_t)ReadValue<uint64_t>(file, indexOffset);
+		level.size = (size_t)ReadValue<uint64_t>(file, indexOffset + 8);
+		level.width = std::max(image.width >> i, 1);
+		level.height = std::max(image.height >> i, 1);
+
+		if (level.offset + level.size > file.size())
+		{
+			break;
+		}
+
+		image.levels.push_back(level);
+	}
+
+	return(image.levels.size() > 0);
+}
+
+/***********************************************************
+ *  IsImageAvailable()
+ *
+ *  This method is used for checking whether an image file
+ *  can be opened, or a pre-compressed version of it is found
+ *  next to it, before it is queued.  Only the file is opened,
+ *  the image is not decoded until a worker picks it up.
+ ***********************************************************/
+bool TextureLoader::IsImageAvailable(const std::string& filename)
+{
+	std::string compressedFile;
+
+	if (std::ifstream(filename.c_str(), std::ios::binary).good())
+	{
+		return(true);
+	}
+
+	return((FindCompressedFile(filename, compressedFile)) &&
+		(std::ifstream(compressedFile.c_str(), std::ios::binary).good()));
+}
+
+/***********************************************************
+ *  QueueImage()
+ *
+ *  This method is used for queueing an image file to be
+ *  decoded by the workers for the passed in texture slot.
+ ***********************************************************/
+void TextureLoader::QueueImage(const std::string& filename, int slot)
+{
+	DECODED_IMAGE image;
+
+	image.filename = filename;
+	image.slot = slot;
+	image.pixels = NULL;
+	image.width = 0;
+	image.height = 0;
+	image.colorChannels = 0;
+	image.internalFormat = 0;
+	image.mipLevels = 0;
+	image.bCompressed = false;
+
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_pendingImages.push_back(image);
+		m_imagesInFlight++;
+	}
+	m_workAvailable.notify_one();
+}
+
+/***********************************************************
+ *  PopDecodedImage()
+ *
+ *  This method is used for getting the next image that the
+ *  workers have finished decoding.
+ ***********************************************************/
+bool TextureLoader::PopDecodedImage(DECODED_IMAGE& image)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	if (m_decodedImages.size() == 0)
+	{
+		return(false);
+	}
+
+	image = m_decodedImages.front();
+	m_decodedImages.pop_front();
+	m_imagesInFlight--;
+
+	return(true);
+}
+
+/***********************************************************
+ *  IsIdle()
+ *
+ *  This method is used for checking whether every queued
+ *  image has been decoded and handed back.
+ ***********************************************************/
+bool TextureLoader::IsIdle()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+
+	return(m_imagesInFlight == 0);
+}
+
+/***********************************************************
+ *  WaitForStagingRegion()
+ *
+ *  This method is used for waiting until the GPU has read
+ *  the previous upload out of a staging region.
+ ***********************************************************/
+void TextureLoader::WaitForStagingRegion(int region)
+{
+	if (NULL == m_stagingFences[region])
+	{
+		return;
+	}
+
+	GLenum waitResult = GL_TIMEOUT_EXPIRED;
+	while ((waitResult != GL_ALREADY_SIGNALED) && (waitResult != GL_CONDITION_SATISFIED) && (waitResult != GL_WAIT_FAILED))
+	{
+		waitResult = glClientWaitSync(m_stagingFences[region], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000);
+	}
+
+	glDeleteSync(m_stagingFences[region]);
+	m_stagingFences[region] = NULL;
+}
+
+/***********************************************************
+ *  UploadImage()
+ *
+ *  This method is used for uploading a decoded image into
+ *  the passed in texture, generating its mipmaps, and then
+ *  freeing the decoded pixels.  Pre-compressed images are
+ *  uploaded level by level with their baked mipmaps.  It
+ *  must be called from the thread that owns the context.
+ ***********************************************************/
+bool TextureLoader::UploadImage(DECODED_IMAGE& image, GLuint textureID)
+{
+	GLenum format = GL_RGB;
+	const unsigned char* source = image.pixels;
+	GLsizeiptr imageSize = 0;
+
+	if (image.bCompressed)
+	{
+		source = &image.compressedData[0];
+		imageSize = image.compressedData.size();
+	}
+	else if (NULL == image.pixels)
+	{
+		std::cout << "Could not load image:" << image.filename << std::endl;
+		return(false);
+	}
+	// if the loaded image is in RGBA format - it supports transparency
+	else if (image.colorChannels == 4)
+	{
+		format = GL_RGBA;
+		imageSize = (GLsizeiptr)image.width * image.height * 4;
+	}
+	else if (image.colorChannels == 3)
+	{
+		imageSize = (GLsizeiptr)image.width * image.height * 3;
+	}
+	else
+	{
+		std::cout << "Not implemented to handle image with " << image.colorChannels << " channels" << std::endl;
+		stbi_image_free(image.pixels);
+		image.pixels = NULL;
+		return(false);
+	}
+
+	std::cout << "Successfully loaded image:" << image.filename << ", width:" << image.width << ", height:" << image.height << ", channels:" << image.colorChannels << std::endl;
+
+	bool bStaged = (NULL != m_pStagingMemory) && (imageSize <= m_stagingRegionSize);
+	int region = m_nextStagingRegion;
+	const unsigned char* pixels = source;
+
+	// copy the pixels into the next free staging region, the texture is then
+	// sourced from the buffer offset instead of from client memory
+	if (bStaged)
+	{
+		WaitForStagingRegion(region);
+		memcpy(m_pStagingMemory + (region * m_stagingRegionSize), source, imageSize);
+
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_stagingBuffer);
+		pixels = (const unsigned char*)(region * m_stagingRegionSize);
+	}
+
+	glBindTexture(GL_TEXTURE_2D, textureID);
+
+	if (image.bCompressed)
+	{
+		for (int i = 0; i < image.levels.size(); i++)
+		{
+			const COMPRESSED_LEVEL& level = image.levels[i];
+			glCompressedTexImage2D(GL_TEXTURE_2D, i, image.internalFormat, level.width, level.height, 0, level.size, pixels + level.offset);
+		}
+		// only the baked mipmap levels exist
+		glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, image.levels.size() - 1);
+	}
+	else
+	{
+		// rows of RGB images are not always padded to four bytes
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+		glTexImage2D(GL_TEXTURE_2D, 0, image.internalFormat, image.width, image.height, 0, format, GL_UNSIGNED_BYTE, pixels);
+		glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+		// generate the texture mipmaps for mapping textures to lower resolutions
+		glGenerateMipmap(GL_TEXTURE_2D);
+	}
+	glBindTexture(GL_TEXTURE_2D, 0);
+
+	if (bStaged)
+	{
+		glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+		m_stagingFences[region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+		m_nextStagingRegion = (region + 1) % STAGING_REGIONS;
+	}
+
+	// free the image data from local memory
+	if (image.bCompressed)
+	{
+		image.compressedData.clear();
+		image.compressedData.shrink_to_fit();
+	}
+	else
+	{
+		stbi_image_free(image.pixels);
+		image.pixels = NULL;
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  DiscardImage()
+ *
+ *  This method is used for freeing a decoded image that is
+ *  no longer needed without uploading it.
+ ***********************************************************/
+void TextureLoader::DiscardImage(DECODED_IMAGE& image)
+{
+	if (image.bCompressed)
+	{
+		image.compressedData.clear();
+		image.compressedData.shrink_to_fit();
+	}
+	else
+	{
+		stbi_image_free(image.pixels);
+		image.pixels = NULL;
+	}
+}
@@ -0,0 +1,126 @@
+///////////////////////////////////////////////////////////////////////////////
+// textureloader.h
+// ============
+// decode texture images on worker threads and stream them to the GPU
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+/***********************************************************
+ *  TextureLoader
+ *
+ *  This class decodes texture image files on a pool of
+ *  worker threads.  The decoded pixels are handed back to
+ *  the thread that owns the OpenGL context, which copies
+ *  them into persistently mapped pixel buffers and uploads
+ *  them from there, so the render loop never waits on file
+ *  reads or image decoding.
+ ***********************************************************/
+class TextureLoader
+{
+public:
+	// constructor
+	TextureLoader();
+	// destructor
+	~TextureLoader();
+
+	// one mipmap level inside the data of a compressed image
+	struct COMPRESSED_LEVEL
+	{
+		size_t offset;
+		size_t size;
+		int width;
+		int height;
+	};
+
+	// an image that has been read and decoded by a worker
+	struct DECODED_IMAGE
+	{
+		std::string filename;
+		int slot;
+		unsigned char* pixels;
+		int width;
+		int height;
+		int colorChannels;
+		// OpenGL format and number of mipmap levels of the texture
+		GLenum internalFormat;
+		int mipLevels;
+		// pre-compressed images keep all of their mipmap levels
+		// in one block of data instead of in the pixels
+		bool bCompressed;
+		std::vector<unsigned char> compressedData;
+		std::vector<COMPRESSED_LEVEL> levels;
+	};
+
+private:
+	// the number of staging regions that can be in flight at once
+	static const int STAGING_REGIONS = 3;
+
+	// worker threads and the images waiting to be decoded
+	std::vector<std::thread> m_workers;
+	std::deque<DECODED_IMAGE> m_pendingImages;
+	// decoded images waiting to be uploaded
+	std::deque<DECODED_IMAGE> m_decodedImages;
+	// number of images queued that have not been handed back yet
+	int m_imagesInFlight;
+	bool m_bStopWorkers;
+	std::mutex m_mutex;
+	std::condition_variable m_workAvailable;
+
+	// persistently mapped pixel buffer used for the uploads
+	GLuint m_stagingBuffer;
+	unsigned char* m_pStagingMemory;
+	GLsizeiptr m_stagingRegionSize;
+	GLsync m_stagingFences[STAGING_REGIONS];
+	int m_nextStagingRegion;
+
+	// decode images until the workers are stopped
+	void WorkerLoop();
+	// find a pre-compressed version of the passed in image file
+	bool FindCompressedFile(const std::string& filename, std::string& compressedFile);
+	// read the mipmap levels of a pre-compressed DDS or KTX2 file
+	bool LoadCompressedImage(const std::string& filename, DECODED_IMAGE& image);
+	bool ParseDDS(const std::vector<unsigned char>& file, DECODED_IMAGE& image);
+	bool ParseKTX2(const std::vector<unsigned char>& file, DECODED_IMAGE& image);
+	// fill in the mipmap levels of a block compressed image
+	void AddCompressedLevels(DECODED_IMAGE& image, size_t dataOffset, int levelCount);
+	// wait until the GPU has finished reading a staging region
+	void WaitForStagingRegion(int region);
+
+public:
+	// start decoding on the passed in number of worker threads
+	void StartWorkers(int threadCount);
+	// stop and join all of the worker threads
+	void StopWorkers();
+	// create the persistently mapped staging buffer, if supported
+	bool CreateStagingBuffer(GLsizeiptr regionSize);
+	// free the staging buffer
+	void DestroyStagingBuffer();
+
+	// check whether an image file, or its pre-compressed version, can be opened
+	bool IsImageAvailable(const std::string& filename);
+	// queue an image file to be decoded for the passed in texture slot
+	void QueueImage(const std::string& filename, int slot);
+	// get the next decoded image, false when none is ready
+	bool PopDecodedImage(DECODED_IMAGE& image);
+	// check whether every queued image has been handed back
+	bool IsIdle();
+
+	// upload a decoded image into the passed in texture and free its pixels
+	bool UploadImage(DECODED_IMAGE& image, GLuint textureID);
+	// free a decoded image that is no longer needed
+	void DiscardImage(DECODED_IMAGE& image);
+	// get the number of mipmap levels of a full chain for the passed in size
+	static int FullMipLevels(int width, int height);
+};
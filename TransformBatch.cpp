@@ -0,0 +1,395 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformbatch.cpp
+// ============
+// compose model matrices for many objects at once with SIMD kernels
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformBatch.h"
+
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TRANSFORM_BATCH_X86
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#elif defined(__aarch64__) || defined(_M_ARM64)
+#define TRANSFORM_BATCH_NEON
+#include <arm_neon.h>
+#endif
+
+#include "TransformLanes.h"
+
+// declaration of global variables and defines
+namespace
+{
+	// names of the kernels in the same order as KERNEL_TYPE
+	const char* g_KernelNames[TransformBatch::KERNEL_COUNT] =
+	{
+		"scalar",
+		"SSE2",
+		"AVX2",
+		"NEON"
+	};
+
+	// one object at a time, also used for the objects left over by the wider kernels
+	struct SCALAR_LANES
+	{
+		typedef float FLOATS;
+		typedef int INTS;
+		typedef bool MASK;
+		static const int WIDTH = 1;
+
+		static FLOATS Load(const float* values) { return(*values); }
+		static void Store(float* values, FLOATS x) { *values = x; }
+		static FLOATS Set(float value) { return(value); }
+		static FLOATS Add(FLOATS a, FLOATS b) { return(a + b); }
+		static FLOATS Sub(FLOATS a, FLOATS b) { return(a - b); }
+		static FLOATS Mul(FLOATS a, FLOATS b) { return(a * b); }
+		static INTS RoundToInt(FLOATS x) { return((int)floorf(x + 0.5f)); }
+		static FLOATS ToFloat(INTS i) { return((float)i); }
+		static INTS AddInt(INTS i, int value) { return(i + value); }
+		static MASK TestBit(INTS i, int bit) { return((i & bit) != 0); }
+		static FLOATS Select(MASK mask, FLOATS a, FLOATS b) { return(mask ? a : b); }
+		static FLOATS NegateIf(MASK mask, FLOATS x) { return(mask ? -x : x); }
+	};
+
+#if defined(TRANSFORM_BATCH_X86)
+	// four objects at a time, every x86 CPU that runs the program has SSE2
+	struct SSE2_LANES
+	{
+		typedef __m128 FLOATS;
+		typedef __m128i INTS;
+		typedef __m128 MASK;
+		static const int WIDTH = 4;
+
+		static FLOATS Load(const float* values) { return(_mm_loadu_ps(values)); }
+		static void Store(float* values, FLOATS x) { _mm_storeu_ps(values, x); }
+		static FLOATS Set(float value) { return(_mm_set1_ps(value)); }
+		static FLOATS Add(FLOATS a, FLOATS b) { return(_mm_add_ps(a, b)); }
+		static FLOATS Sub(FLOATS a, FLOATS b) { return(_mm_sub_ps(a, b)); }
+		static FLOATS Mul(FLOATS a, FLOATS b) { return(_mm_mul_ps(a, b)); }
+		static INTS RoundToInt(FLOATS x) { return(_mm_cvtps_epi32(x)); }
+		static FLOATS ToFloat(INTS i) { return(_mm_cvtepi32_ps(i)); }
+		static INTS AddInt(INTS i, int value) { return(_mm_add_epi32(i, _mm_set1_epi32(value))); }
+		static MASK TestBit(INTS i, int bit)
+		{
+			__m128i bits = _mm_set1_epi32(bit);
+			return(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(i, bits), bits)));
+		}
+		static FLOATS Select(MASK mask, FLOATS a, FLOATS b) { return(_mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b))); }
+		static FLOATS NegateIf(MASK mask, FLOATS x) { return(_mm_xor_ps(x, _mm_and_ps(mask, _mm_set1_ps(-0.0f)))); }
+	};
+#endif
+
+#if defined(TRANSFORM_BATCH_NEON)
+	// four objects at a time, every 64 bit ARM CPU has NEON
+	struct NEON_LANES
+	{
+		typedef float32x4_t FLOATS;
+		typedef int32x4_t INTS;
+		typedef uint32x4_t MASK;
+		static const int WIDTH = 4;
+
+		static FLOATS Load(const float* values) { return(vld1q_f32(values)); }
+		static void Store(float* values, FLOATS x) { vst1q_f32(values, x); }
+		static FLOATS Set(float value) { return(vdupq_n_f32(value)); }
+		static FLOATS Add(FLOATS a, FLOATS b) { return(vaddq_f32(a, b)); }
+		static FLOATS Sub(FLOATS a, FLOATS b) { return(vsubq_f32(a, b)); }
+		static FLOATS Mul(FLOATS a, FLOATS b) { return(vmulq_f32(a, b)); }
+		static INTS RoundToInt(FLOATS x) { return(vcvtnq_s32_f32(x)); }
+		static FLOATS ToFloat(INTS i) { return(vcvtq_f32_s32(i)); }
+		static INTS AddInt(INTS i, int value) { return(vaddq_s32(i, vdupq_n_s32(value))); }
+		static MASK TestBit(INTS i, int bit) { return(vtstq_s32(i, vdupq_n_s32(bit))); }
+		static FLOATS Select(MASK mask, FLOATS a, FLOATS b) { return(vbslq_f32(mask, a, b)); }
+		static FLOATS NegateIf(MASK mask, FLOATS x)
+		{
+			return(vreinterpretq_f32_u32(veorq_u32(vreinterpretq_u32_f32(x), vandq_u32(mask, vdupq_n_u32(0x80000000)))));
+		}
+	};
+#endif
+
+	/***********************************************************
+	 *  DetectAvx2()
+	 *
+	 *  This function is used for checking whether the CPU has
+	 *  AVX2 and the operating system saves the wide registers.
+	 ***********************************************************/
+	bool DetectAvx2()
+	{
+#if defined(TRANSFORM_BATCH_X86) && defined(_MSC_VER)
+		int info[4] = { 0 };
+
+		__cpuid(info, 0);
+		if (info[0] < 7)
+		{
+			return(false);
+		}
+
+		// OSXSAVE and AVX, and the OS saving the SSE and AVX state
+		__cpuid(info, 1);
+		if (((info[2] & (1 << 27)) == 0) || ((info[2] & (1 << 28)) == 0) ||
+			((_xgetbv(0) & 0x6) != 0x6))
+		{
+			return(false);
+		}
+
+		__cpuidex(info, 7, 0);
+		return((info[1] & (1 << 5)) != 0);
+#elif defined(TRANSFORM_BATCH_X86)
+		// this runs while the globals are initialized, before main()
+		__builtin_cpu_init();
+		return(__builtin_cpu_supports("avx2"));
+#else
+		return(false);
+#endif
+	}
+
+	// the widest kernel the CPU runs, found when the program starts
+	const TransformBatch::KERNEL_TYPE g_BestKernel = TransformBatch::GetBestKernel();
+}
+
+/***********************************************************
+ *  TransformBatch()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TransformBatch::TransformBatch()
+{
+}
+
+/***********************************************************
+ *  GetArrays()
+ *
+ *  This method is used for getting the arrays of the
+ *  transformation values the kernels read.
+ ***********************************************************/
+TransformBatch::TRANSFORM_ARRAYS TransformBatch::GetArrays() const
+{
+	TRANSFORM_ARRAYS arrays;
+
+	for (int i = 0; i < 3; i++)
+	{
+		arrays.scale[i] = m_scale[i].data();
+		arrays.rotation[i] = m_rotation[i].data();
+		arrays.position[i] = m_position[i].data();
+	}
+
+	return(arrays);
+}
+
+/***********************************************************
+ *  Resize()
+ *
+ *  This method is used for setting the number of objects.
+ *  Added objects have no rotation, a scale of one and are
+ *  at the origin.
+ ***********************************************************/
+void TransformBatch::Resize(int count)
+{
+	for (int i = 0; i < 3; i++)
+	{
+		m_scale[i].resize(count, 1.0f);
+		m_rotation[i].resize(count, 0.0f);
+		m_position[i].resize(count, 0.0f);
+	}
+}
+
+/***********************************************************
+ *  GetCount()
+ *
+ *  This method is used for getting the number of objects.
+ ***********************************************************/
+int TransformBatch::GetCount() const
+{
+	return(m_scale[0].size());
+}
+
+/***********************************************************
+ *  SetTransform()
+ *
+ *  This method is used for setting the transformation
+ *  values of one object, in the same order they are passed
+ *  to BuildModelMatrix().
+ ***********************************************************/
+void TransformBatch::SetTransform(
+	int index,
+	const glm::vec3& scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	const glm::vec3& positionXYZ)
+{
+	if ((index < 0) || (index >= GetCount()))
+	{
+		return;
+	}
+
+	for (int i = 0; i < 3; i++)
+	{
+		m_scale[i][index] = scaleXYZ[i];
+		m_position[i][index] = positionXYZ[i];
+	}
+	m_rotation[0][index] = XrotationDegrees;
+	m_rotation[1][index] = YrotationDegrees;
+	m_rotation[2][index] = ZrotationDegrees;
+}
+
+/***********************************************************
+ *  Compose()
+ *
+ *  This method is used for composing the model matrices of
+ *  a range of objects.  The matrix of object i is written to
+ *  the record at outputIndices[i], or at i when there are no
+ *  indices, and the records are stride bytes apart.  The
+ *  objects are composed by the passed in kernel, or the
+ *  widest one the CPU runs, and the few left over at the end
+ *  of the range by the scalar kernel.
+ ***********************************************************/
+void TransformBatch::Compose(
+	int first,
+	int count,
+	void* output,
+	size_t stride,
+	const int* outputIndices,
+	KERNEL_TYPE kernel) const
+{
+	TRANSFORM_ARRAYS arrays = GetArrays();
+	unsigned char* records = (unsigned char*)output;
+	int composed = 0;
+
+	if ((NULL == output) || (first < 0) || (count <= 0) || (first + count > GetCount()))
+	{
+		return;
+	}
+
+	if (KERNEL_DEFAULT == kernel)
+	{
+		kernel = g_BestKernel;
+	}
+	else if (!IsKernelSupported(kernel))
+	{
+		kernel = KERNEL_SCALAR;
+	}
+
+	switch (kernel)
+	{
+#if defined(TRANSFORM_BATCH_X86)
+	case KERNEL_AVX2:
+		composed = ComposeAvx2(arrays, first, count, records, stride, outputIndices);
+		// the rest of the range can still fill whole SSE2 groups
+		composed += ComposeTransformLanes<SSE2_LANES>(arrays, first + composed, count - composed, records, stride, outputIndices);
+		break;
+	case KERNEL_SSE2:
+		composed = ComposeTransformLanes<SSE2_LANES>(arrays, first, count, records, stride, outputIndices);
+		break;
+#endif
+#if defined(TRANSFORM_BATCH_NEON)
+	case KERNEL_NEON:
+		composed = ComposeTransformLanes<NEON_LANES>(arrays, first, count, records, stride, outputIndices);
+		break;
+#endif
+	default:
+		break;
+	}
+
+	ComposeTransformLanes<SCALAR_LANES>(arrays, first + composed, count - composed, records, stride, outputIndices);
+}
+
+/***********************************************************
+ *  ComposeTransform()
+ *
+ *  This method is used for composing the model matrix of
+ *  one object with the scalar kernel, for the objects that
+ *  are not kept in a batch.
+ ***********************************************************/
+glm::mat4 TransformBatch::ComposeTransform(
+	const glm::vec3& scaleXYZ,
+	float XrotationDegrees,
+	float YrotationDegrees,
+	float ZrotationDegrees,
+	const glm::vec3& positionXYZ)
+{
+	TRANSFORM_ARRAYS arrays;
+	float rotation[3] = { XrotationDegrees, YrotationDegrees, ZrotationDegrees };
+	glm::mat4 model;
+
+	for (int i = 0; i < 3; i++)
+	{
+		arrays.scale[i] = &scaleXYZ[i];
+		arrays.rotation[i] = &rotation[i];
+		arrays.position[i] = &positionXYZ[i];
+	}
+
+	ComposeTransformLanes<SCALAR_LANES>(arrays, 0, 1, (unsigned char*)&model, sizeof(glm::mat4), NULL);
+
+	return(model);
+}
+
+/***********************************************************
+ *  IsKernelSupported()
+ *
+ *  This method is used for checking whether the CPU runs
+ *  the passed in kernel.
+ ***********************************************************/
+bool TransformBatch::IsKernelSupported(KERNEL_TYPE kernel)
+{
+	switch (kernel)
+	{
+	case KERNEL_SCALAR:
+		return(true);
+#if defined(TRANSFORM_BATCH_X86)
+	case KERNEL_SSE2:
+		return(true);
+	case KERNEL_AVX2:
+		return(DetectAvx2());
+#endif
+#if defined(TRANSFORM_BATCH_NEON)
+	case KERNEL_NEON:
+		return(true);
+#endif
+	default:
+		return(false);
+	}
+}
+
+/***********************************************************
+ *  GetBestKernel()
+ *
+ *  This method is used for getting the widest kernel that
+ *  the CPU runs.
+ ***********************************************************/
+TransformBatch::KERNEL_TYPE TransformBatch::GetBestKernel()
+{
+	if (IsKernelSupported(KERNEL_AVX2))
+	{
+		return(KERNEL_AVX2);
+	}
+	if (IsKernelSupported(KERNEL_NEON))
+	{
+		return(KERNEL_NEON);
+	}
+	if (IsKernelSupported(KERNEL_SSE2))
+	{
+		return(KERNEL_SSE2);
+	}
+	return(KERNEL_SCALAR);
+}
+
+/***********************************************************
+ *  GetKernelName()
+ *
+ *  This method is used for getting the name of a kernel.
+ ***********************************************************/
+const char* TransformBatch::GetKernelName(KERNEL_TYPE kernel)
+{
+	if ((kernel < 0) || (kernel >= KERNEL_COUNT))
+	{
+		return("default");
+	}
+
+	return(g_KernelNames[kernel]);
+}
@@ -0,0 +1,111 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformbatch.h
+// ============
+// compose model matrices for many objects at once with SIMD kernels
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <vector>
+
+/***********************************************************
+ *  TransformBatch
+ *
+ *  This class keeps the scale, rotation and position of
+ *  many objects as separate arrays, and composes their model
+ *  matrices the same way as BuildModelMatrix(), which is
+ *
+ *    translation * rotationZ * rotationY * rotationX * scale
+ *
+ *  but written out in closed form, so no matrices are built
+ *  and multiplied.  Several objects are composed at once
+ *  with the widest SIMD kernel the CPU runs, chosen when the
+ *  program starts.  The matrices are written straight into
+ *  records of any size, such as the instances of the scene,
+ *  as long as the matrix is the first member.
+ ***********************************************************/
+class TransformBatch
+{
+public:
+	// constructor
+	TransformBatch();
+
+	// the kernels the matrices can be composed with
+	enum KERNEL_TYPE
+	{
+		KERNEL_DEFAULT = -1,
+		KERNEL_SCALAR = 0,
+		KERNEL_SSE2,
+		KERNEL_AVX2,
+		KERNEL_NEON,
+		KERNEL_COUNT
+	};
+
+	// the arrays the kernels read, rotations are in degrees
+	struct TRANSFORM_ARRAYS
+	{
+		const float* scale[3];
+		const float* rotation[3];
+		const float* position[3];
+	};
+
+private:
+	// scale, rotation in degrees and position of every object, by axis
+	std::vector<float> m_scale[3];
+	std::vector<float> m_rotation[3];
+	std::vector<float> m_position[3];
+
+	// get the arrays the kernels read
+	TRANSFORM_ARRAYS GetArrays() const;
+	// compose whole groups of eight objects with AVX2, as many as fit
+	static int ComposeAvx2(
+		const TRANSFORM_ARRAYS& arrays,
+		int first,
+		int count,
+		unsigned char* output,
+		size_t stride,
+		const int* outputIndices);
+
+public:
+	// set the number of objects, new objects are not moved, rotated or scaled
+	void Resize(int count);
+	// get the number of objects
+	int GetCount() const;
+	// set the transformation values of an object
+	void SetTransform(
+		int index,
+		const glm::vec3& scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		const glm::vec3& positionXYZ);
+
+	// compose the model matrices of a range of objects into records of stride bytes
+	void Compose(
+		int first,
+		int count,
+		void* output,
+		size_t stride,
+		const int* outputIndices = NULL,
+		KERNEL_TYPE kernel = KERNEL_DEFAULT) const;
+
+	// compose one model matrix with the scalar kernel
+	static glm::mat4 ComposeTransform(
+		const glm::vec3& scaleXYZ,
+		float XrotationDegrees,
+		float YrotationDegrees,
+		float ZrotationDegrees,
+		const glm::vec3& positionXYZ);
+
+	// check whether the CPU runs a kernel, and get the widest one it runs
+	static bool IsKernelSupported(KERNEL_TYPE kernel);
+	static KERNEL_TYPE GetBestKernel();
+	// get the name of a kernel
+	static const char* GetKernelName(KERNEL_TYPE kernel);
+};
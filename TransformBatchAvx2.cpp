@@ -0,0 +1,103 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformbatchavx2.cpp
+// ============
+// the AVX2 kernel of TransformBatch, kept apart so only it uses AVX2 code
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformBatch.h"
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__i386__) || defined(_M_IX86)
+#define TRANSFORM_BATCH_X86
+#include <immintrin.h>
+#endif
+
+#if defined(TRANSFORM_BATCH_X86)
+
+// everything from here on may use AVX2, it is only called once
+// the CPU has been checked for it, and the headers above stay
+// compiled for every CPU
+#if defined(__clang__)
+#pragma clang attribute push (__attribute__((target("avx2"))), apply_to = function)
+#elif defined(__GNUC__)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+#endif
+
+#include "TransformLanes.h"
+
+// declaration of global variables and defines
+namespace
+{
+	// eight objects at a time
+	struct AVX2_LANES
+	{
+		typedef __m256 FLOATS;
+		typedef __m256i INTS;
+		typedef __m256 MASK;
+		static const int WIDTH = 8;
+
+		static FLOATS Load(const float* values) { return(_mm256_loadu_ps(values)); }
+		static void Store(float* values, FLOATS x) { _mm256_storeu_ps(values, x); }
+		static FLOATS Set(float value) { return(_mm256_set1_ps(value)); }
+		static FLOATS Add(FLOATS a, FLOATS b) { return(_mm256_add_ps(a, b)); }
+		static FLOATS Sub(FLOATS a, FLOATS b) { return(_mm256_sub_ps(a, b)); }
+		static FLOATS Mul(FLOATS a, FLOATS b) { return(_mm256_mul_ps(a, b)); }
+		static INTS RoundToInt(FLOATS x) { return(_mm256_cvtps_epi32(x)); }
+		static FLOATS ToFloat(INTS i) { return(_mm256_cvtepi32_ps(i)); }
+		static INTS AddInt(INTS i, int value) { return(_mm256_add_epi32(i, _mm256_set1_epi32(value))); }
+		static MASK TestBit(INTS i, int bit)
+		{
+			__m256i bits = _mm256_set1_epi32(bit);
+			return(_mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(i, bits), bits)));
+		}
+		static FLOATS Select(MASK mask, FLOATS a, FLOATS b) { return(_mm256_blendv_ps(b, a, mask)); }
+		static FLOATS NegateIf(MASK mask, FLOATS x) { return(_mm256_xor_ps(x, _mm256_and_ps(mask, _mm256_set1_ps(-0.0f)))); }
+	};
+}
+
+/***********************************************************
+ *  ComposeAvx2()
+ *
+ *  This method is used for composing the model matrices of
+ *  as many whole groups of eight objects as the range holds.
+ *  The number of objects composed is returned.
+ ***********************************************************/
+int TransformBatch::ComposeAvx2(
+	const TRANSFORM_ARRAYS& arrays,
+	int first,
+	int count,
+	unsigned char* output,
+	size_t stride,
+	const int* outputIndices)
+{
+	return(ComposeTransformLanes<AVX2_LANES>(arrays, first, count, output, stride, outputIndices));
+}
+
+#if defined(__clang__)
+#pragma clang attribute pop
+#elif defined(__GNUC__)
+#pragma GCC pop_options
+#endif
+
+#else
+
+/***********************************************************
+ *  ComposeAvx2()
+ *
+ *  There is no AVX2 on this CPU family, so no objects are
+ *  composed here.
+ ***********************************************************/
+int TransformBatch::ComposeAvx2(
+	const TRANSFORM_ARRAYS& arrays,
+	int first,
+	int count,
+	unsigned char* output,
+	size_t stride,
+	const int* outputIndices)
+{
+	return(0);
+}
+
+#endif
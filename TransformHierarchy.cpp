@@ -0,0 +1,295 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformhierarchy.cpp
+// ============
+// parent and child transform nodes, updated only where they are marked dirty
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformHierarchy.h"
+
+/***********************************************************
+ *  TransformHierarchy()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+TransformHierarchy::TransformHierarchy()
+{
+}
+
+/***********************************************************
+ *  ~TransformHierarchy()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+TransformHierarchy::~TransformHierarchy()
+{
+	Clear();
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all of the nodes.
+ ***********************************************************/
+void TransformHierarchy::Clear()
+{
+	m_nodes.clear();
+	m_dirtyNodes.clear();
+	m_updateStack.clear();
+}
+
+/***********************************************************
+ *  AddNode()
+ *
+ *  This method is used for adding a node below the passed
+ *  in parent, or a root node when the parent is -1.  The
+ *  world transform of the new node is computed right away
+ *  from the pending world transform of the parent, so it is
+ *  current without an update.  The index of the
+ *  new node is returned, or -1 when the parent is unknown.
+ ***********************************************************/
+int TransformHierarchy::AddNode(int parent, const glm::mat4& local, int object)
+{
+	TRANSFORM_NODE node;
+
+	if (parent >= (int)m_nodes.size())
+	{
+		return(-1);
+	}
+
+	node.parent = (parent >= 0) ? parent : -1;
+	node.firstChild = -1;
+	node.nextSibling = -1;
+	node.object = object;
+	node.local = local;
+	node.world = (node.parent >= 0) ? GetPendingWorld(node.parent) * local : local;
+	node.bDirty = false;
+
+	int nodeIndex = m_nodes.size();
+
+	// the new child is linked in front of its siblings
+	if (node.parent >= 0)
+	{
+		node.nextSibling = m_nodes[node.parent].firstChild;
+		m_nodes[node.parent].firstChild = nodeIndex;
+	}
+
+	m_nodes.push_back(node);
+
+	return(nodeIndex);
+}
+
+/***********************************************************
+ *  SetObject()
+ *
+ *  This method is used for tying a scene object to a node,
+ *  so it is reported whenever the node changes.
+ ***********************************************************/
+void TransformHierarchy::SetObject(int nodeIndex, int object)
+{
+	if ((nodeIndex < 0) || (nodeIndex >= m_nodes.size()))
+	{
+		return;
+	}
+
+	m_nodes[nodeIndex].object = object;
+}
+
+/***********************************************************
+ *  SetLocalTransform()
+ *
+ *  This method is used for setting the local transform of a
+ *  node.  The node is only marked dirty, its world transform
+ *  and those of its descendants are recomputed by the next
+ *  call to Update().
+ ***********************************************************/
+void TransformHierarchy::SetLocalTransform(int nodeIndex, const glm::mat4& local)
+{
+	if ((nodeIndex < 0) || (nodeIndex >= m_nodes.size()))
+	{
+		return;
+	}
+
+	TRANSFORM_NODE& node = m_nodes[nodeIndex];
+
+	node.local = local;
+	if (!node.bDirty)
+	{
+		node.bDirty = true;
+		m_dirtyNodes.push_back(nodeIndex);
+	}
+}
+
+/***********************************************************
+ *  SetWorldTransform()
+ *
+ *  This method is used for placing a node in the world
+ *  right away, for an object that was moved directly.  The
+ *  local transform is set to match under the parent, so the
+ *  node still follows its parent when the parent moves
+ *  later, and only the children are marked dirty.  The
+ *  parent may have been moved since the last update, so the
+ *  local transform is taken relative to the world transform
+ *  the parent will have after the update, not its stale one.
+ ***********************************************************/
+void TransformHierarchy::SetWorldTransform(int nodeIndex, const glm::mat4& world)
+{
+	if ((nodeIndex < 0) || (nodeIndex >= m_nodes.size()))
+	{
+		return;
+	}
+
+	TRANSFORM_NODE& node = m_nodes[nodeIndex];
+
+	node.world = world;
+	node.local = (node.parent >= 0) ? glm::inverse(GetPendingWorld(node.parent)) * world : world;
+
+	for (int child = node.firstChild; child >= 0; child = m_nodes[child].nextSibling)
+	{
+		if (!m_nodes[child].bDirty)
+		{
+			m_nodes[child].bDirty = true;
+			m_dirtyNodes.push_back(child);
+		}
+	}
+}
+
+/***********************************************************
+ *  IsAncestorDirty()
+ *
+ *  This method is used for checking whether a node is below
+ *  another dirty node, whose update covers it as well.
+ ***********************************************************/
+bool TransformHierarchy::IsAncestorDirty(int nodeIndex) const
+{
+	for (int parent = m_nodes[nodeIndex].parent; parent >= 0; parent = m_nodes[parent].parent)
+	{
+		if (m_nodes[parent].bDirty)
+		{
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  GetPendingWorld()
+ *
+ *  This method is used for getting the world transform a
+ *  node will have after the next update.  Every node below
+ *  the highest dirty node of its branch is stale, so the
+ *  local transforms from there down to the node are applied
+ *  to the current world transform above it.  The nodes are
+ *  not changed, Update() still recomputes the branch.
+ ***********************************************************/
+glm::mat4 TransformHierarchy::GetPendingWorld(int nodeIndex) const
+{
+	int highestDirty = -1;
+	glm::mat4 world(1.0f);
+
+	for (int node = nodeIndex; node >= 0; node = m_nodes[node].parent)
+	{
+		if (m_nodes[node].bDirty)
+		{
+			highestDirty = node;
+		}
+	}
+
+	if (highestDirty < 0)
+	{
+		return(m_nodes[nodeIndex].world);
+	}
+
+	int above = m_nodes[highestDirty].parent;
+	for (int node = nodeIndex; node != above; node = m_nodes[node].parent)
+	{
+		world = m_nodes[node].local * world;
+	}
+	if (above >= 0)
+	{
+		world = m_nodes[above].world * world;
+	}
+
+	return(world);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for recomputing the world transforms
+ *  of the dirty nodes and of every node below them.  Only
+ *  the highest dirty node of a branch starts an update, so
+ *  every changed node is computed once, after its parent.
+ *  The nodes whose world transforms changed are returned in
+ *  the order they were computed.
+ ***********************************************************/
+void TransformHierarchy::Update(std::vector<int>& changedNodes)
+{
+	changedNodes.clear();
+
+	for (int i = 0; i < m_dirtyNodes.size(); i++)
+	{
+		int dirtyNode = m_dirtyNodes[i];
+
+		// already updated below a dirty ancestor, or waiting for one
+		if ((!m_nodes[dirtyNode].bDirty) || (IsAncestorDirty(dirtyNode)))
+		{
+			continue;
+		}
+
+		m_updateStack.clear();
+		m_updateStack.push_back(dirtyNode);
+		while (!m_updateStack.empty())
+		{
+			int nodeIndex = m_updateStack.back();
+			TRANSFORM_NODE& node = m_nodes[nodeIndex];
+
+			m_updateStack.pop_back();
+			node.world = (node.parent >= 0) ? m_nodes[node.parent].world * node.local : node.local;
+			node.bDirty = false;
+			changedNodes.push_back(nodeIndex);
+
+			for (int child = node.firstChild; child >= 0; child = m_nodes[child].nextSibling)
+			{
+				m_updateStack.push_back(child);
+			}
+		}
+	}
+
+	m_dirtyNodes.clear();
+}
+
+/***********************************************************
+ *  HasDirtyNodes()
+ *
+ *  This method is used for checking whether any node was
+ *  marked dirty since the last update.
+ ***********************************************************/
+bool TransformHierarchy::HasDirtyNodes() const
+{
+	return(!m_dirtyNodes.empty());
+}
+
+/***********************************************************
+ *  GetNodeCount()
+ *
+ *  This method is used for getting the number of nodes.
+ ***********************************************************/
+int TransformHierarchy::GetNodeCount() const
+{
+	return(m_nodes.size());
+}
+
+/***********************************************************
+ *  GetNode()
+ *
+ *  This method is used for getting a node.  Its world
+ *  transform is only current after Update() once it has
+ *  been marked dirty.
+ ***********************************************************/
+const TransformHierarchy::TRANSFORM_NODE& TransformHierarchy::GetNode(int nodeIndex) const
+{
+	return(m_nodes[nodeIndex]);
+}
@@ -0,0 +1,90 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformhierarchy.h
+// ============
+// parent and child transform nodes, updated only where they are marked dirty
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <vector>
+
+/***********************************************************
+ *  TransformHierarchy
+ *
+ *  This class keeps a tree of transform nodes.  Every node
+ *  has a local transform relative to its parent, and its
+ *  world transform is the world transform of the parent
+ *  times its local transform, so a compound object is one
+ *  node whose children are placed relative to it.
+ *
+ *  Changing a local transform only marks the node dirty.
+ *  Update() then recomputes the world transforms of the
+ *  dirty nodes and their descendants, and nothing else, so
+ *  the cost follows the number of moved nodes rather than
+ *  the size of the tree.  A node can be tied to a scene
+ *  object, which is moved to the world transform of the
+ *  node whenever it changes.
+ ***********************************************************/
+class TransformHierarchy
+{
+public:
+	// constructor
+	TransformHierarchy();
+	// destructor
+	~TransformHierarchy();
+
+	// one node of the tree, the children of a node are linked
+	// from its first child through their next siblings
+	struct TRANSFORM_NODE
+	{
+		int parent;
+		int firstChild;
+		int nextSibling;
+		// scene object placed by the node, or -1 for none
+		int object;
+		glm::mat4 local;
+		glm::mat4 world;
+		// true when the world transform has to be recomputed
+		bool bDirty;
+	};
+
+private:
+	// the nodes of the tree, a parent is always before its children
+	std::vector<TRANSFORM_NODE> m_nodes;
+	// nodes marked dirty since the last update
+	std::vector<int> m_dirtyNodes;
+	// nodes waiting to be visited while a subtree is updated
+	std::vector<int> m_updateStack;
+
+	// check whether a node is below another dirty node
+	bool IsAncestorDirty(int nodeIndex) const;
+	// get the world transform a node will have after the next update
+	glm::mat4 GetPendingWorld(int nodeIndex) const;
+
+public:
+	// remove all of the nodes
+	void Clear();
+	// add a node below the parent, or a root node for -1
+	int AddNode(int parent, const glm::mat4& local, int object = -1);
+	// tie a scene object to a node
+	void SetObject(int nodeIndex, int object);
+	// set the local transform of a node and mark it dirty
+	void SetLocalTransform(int nodeIndex, const glm::mat4& local);
+	// place a node in the world right away and mark its children dirty
+	void SetWorldTransform(int nodeIndex, const glm::mat4& world);
+
+	// recompute the dirty subtrees and get the nodes that changed
+	void Update(std::vector<int>& changedNodes);
+	// check whether any node was marked dirty since the last update
+	bool HasDirtyNodes() const;
+
+	// get the number of nodes
+	int GetNodeCount() const;
+	// get a node, its world transform is current after Update()
+	const TRANSFORM_NODE& GetNode(int nodeIndex) const;
+};
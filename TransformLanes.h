@@ -0,0 +1,142 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformlanes.h
+// ============
+// the transform kernel shared by every instruction set of TransformBatch
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "TransformBatch.h"
+
+/***********************************************************
+ *  SinCosLanes()
+ *
+ *  This function is used for getting the sine and cosine
+ *  of every lane at once.  The angle is reduced to within a
+ *  quarter turn in three steps, so large angles keep their
+ *  precision, and the two polynomials then give the values
+ *  of that quadrant, which are swapped and negated for the
+ *  quadrant the angle was in.
+ *
+ *  LANES wraps one instruction set, each kernel source has
+ *  its own so the kernel is compiled once per set.
+ ***********************************************************/
+template <typename LANES>
+inline void SinCosLanes(
+	typename LANES::FLOATS angle,
+	typename LANES::FLOATS& sine,
+	typename LANES::FLOATS& cosine)
+{
+	typedef typename LANES::FLOATS FLOATS;
+	typedef typename LANES::INTS INTS;
+	typedef typename LANES::MASK MASK;
+
+	INTS quadrant = LANES::RoundToInt(LANES::Mul(angle, LANES::Set(0.636619772f)));
+	FLOATS turns = LANES::ToFloat(quadrant);
+	FLOATS x = angle;
+
+	// subtract the quarter turns in parts, with pi/2 split three ways
+	x = LANES::Sub(x, LANES::Mul(turns, LANES::Set(1.5703125f)));
+	x = LANES::Sub(x, LANES::Mul(turns, LANES::Set(4.837512969970703125e-4f)));
+	x = LANES::Sub(x, LANES::Mul(turns, LANES::Set(7.54978995489188216e-8f)));
+
+	FLOATS x2 = LANES::Mul(x, x);
+	FLOATS sinePoly = LANES::Set(-1.9515295891e-4f);
+	sinePoly = LANES::Add(LANES::Mul(sinePoly, x2), LANES::Set(8.3321608736e-3f));
+	sinePoly = LANES::Add(LANES::Mul(sinePoly, x2), LANES::Set(-1.6666654611e-1f));
+	sinePoly = LANES::Add(LANES::Mul(LANES::Mul(sinePoly, x2), x), x);
+
+	FLOATS cosinePoly = LANES::Set(2.443315711809948e-5f);
+	cosinePoly = LANES::Add(LANES::Mul(cosinePoly, x2), LANES::Set(-1.388731625493765e-3f));
+	cosinePoly = LANES::Add(LANES::Mul(cosinePoly, x2), LANES::Set(4.166664568298827e-2f));
+	cosinePoly = LANES::Mul(LANES::Mul(cosinePoly, x2), x2);
+	cosinePoly = LANES::Add(LANES::Sub(cosinePoly, LANES::Mul(x2, LANES::Set(0.5f))), LANES::Set(1.0f));
+
+	// odd quadrants swap the two, and the sign follows the quadrant
+	MASK bSwap = LANES::TestBit(quadrant, 1);
+	MASK bNegateSine = LANES::TestBit(quadrant, 2);
+	MASK bNegateCosine = LANES::TestBit(LANES::AddInt(quadrant, 1), 2);
+
+	sine = LANES::NegateIf(bNegateSine, LANES::Select(bSwap, cosinePoly, sinePoly));
+	cosine = LANES::NegateIf(bNegateCosine, LANES::Select(bSwap, sinePoly, cosinePoly));
+}
+
+/***********************************************************
+ *  ComposeTransformLanes()
+ *
+ *  This function is used for composing the model matrices
+ *  of whole groups of LANES::WIDTH objects, one object per
+ *  lane, and writing every matrix into its record.  The
+ *  number of objects composed is returned, the rest of the
+ *  range is left to a narrower kernel.
+ ***********************************************************/
+template <typename LANES>
+inline int ComposeTransformLanes(
+	const TransformBatch::TRANSFORM_ARRAYS& arrays,
+	int first,
+	int count,
+	unsigned char* output,
+	size_t stride,
+	const int* outputIndices)
+{
+	typedef typename LANES::FLOATS FLOATS;
+
+	const FLOATS degreesToRadians = LANES::Set(0.0174532925f);
+	float lanes[16][LANES::WIDTH];
+	int composed = count - (count % LANES::WIDTH);
+
+	for (int index = first; index < first + composed; index += LANES::WIDTH)
+	{
+		FLOATS sineX, cosineX, sineY, cosineY, sineZ, cosineZ;
+		FLOATS matrix[16];
+
+		SinCosLanes<LANES>(LANES::Mul(LANES::Load(arrays.rotation[0] + index), degreesToRadians), sineX, cosineX);
+		SinCosLanes<LANES>(LANES::Mul(LANES::Load(arrays.rotation[1] + index), degreesToRadians), sineY, cosineY);
+		SinCosLanes<LANES>(LANES::Mul(LANES::Load(arrays.rotation[2] + index), degreesToRadians), sineZ, cosineZ);
+
+		FLOATS scaleX = LANES::Load(arrays.scale[0] + index);
+		FLOATS scaleY = LANES::Load(arrays.scale[1] + index);
+		FLOATS scaleZ = LANES::Load(arrays.scale[2] + index);
+		FLOATS sineYsineX = LANES::Mul(sineY, sineX);
+		FLOATS sineYcosineX = LANES::Mul(sineY, cosineX);
+
+		// the columns of rotationZ * rotationY * rotationX, each scaled by its axis
+		matrix[0] = LANES::Mul(LANES::Mul(cosineY, cosineZ), scaleX);
+		matrix[1] = LANES::Mul(LANES::Mul(cosineY, sineZ), scaleX);
+		matrix[2] = LANES::Mul(LANES::Sub(LANES::Set(0.0f), sineY), scaleX);
+		matrix[3] = LANES::Set(0.0f);
+		matrix[4] = LANES::Mul(LANES::Sub(LANES::Mul(cosineZ, sineYsineX), LANES::Mul(sineZ, cosineX)), scaleY);
+		matrix[5] = LANES::Mul(LANES::Add(LANES::Mul(sineZ, sineYsineX), LANES::Mul(cosineZ, cosineX)), scaleY);
+		matrix[6] = LANES::Mul(LANES::Mul(cosineY, sineX), scaleY);
+		matrix[7] = LANES::Set(0.0f);
+		matrix[8] = LANES::Mul(LANES::Add(LANES::Mul(cosineZ, sineYcosineX), LANES::Mul(sineZ, sineX)), scaleZ);
+		matrix[9] = LANES::Mul(LANES::Sub(LANES::Mul(sineZ, sineYcosineX), LANES::Mul(cosineZ, sineX)), scaleZ);
+		matrix[10] = LANES::Mul(LANES::Mul(cosineY, cosineX), scaleZ);
+		matrix[11] = LANES::Set(0.0f);
+		matrix[12] = LANES::Load(arrays.position[0] + index);
+		matrix[13] = LANES::Load(arrays.position[1] + index);
+		matrix[14] = LANES::Load(arrays.position[2] + index);
+		matrix[15] = LANES::Set(1.0f);
+
+		for (int i = 0; i < 16; i++)
+		{
+			LANES::Store(lanes[i], matrix[i]);
+		}
+
+		// every lane is written to its own record
+		for (int lane = 0; lane < LANES::WIDTH; lane++)
+		{
+			int record = (NULL != outputIndices) ? outputIndices[index + lane] : index + lane;
+			float* destination = (float*)(output + (record * stride));
+
+			for (int i = 0; i < 16; i++)
+			{
+				destination[i] = lanes[i][lane];
+			}
+		}
+	}
+
+	return(composed);
+}
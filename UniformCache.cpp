@@ -0,0 +1,610 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformcache.cpp
+// ============
+// resolve and cache shader uniform locations, manage uniform buffer objects
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "UniformCache.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <algorithm>
+#include <iostream>
+
+// declaration of global variables and defines
+namespace
+{
+	// uniform names in the same order as the UNIFORM_HANDLE values
+	const char* g_UniformNames[UniformCache::UNIFORM_POINT_LIGHTS] =
+	{
+		"model",
+		"view",
+		"projection",
+		"viewPosition",
+		"objectColor",
+		"objectTexture",
+		"objectTextureArray",
+		"objectTextureLayer",
+		"bUseTexture",
+		"bUseLighting",
+		"UVscale",
+		"material.diffuseColor",
+		"material.specularColor",
+		"material.shininess",
+		"bUseInstanceBuffer",
+		"bUseDrawBlock",
+		"lodFade",
+		"bUseClusteredLights",
+		"bUseShadows",
+		"directionalShadowMap",
+		"pointShadowMaps",
+		"directionalLight.direction",
+		"directionalLight.ambient",
+		"directionalLight.diffuse",
+		"directionalLight.specular",
+		"directionalLight.bActive",
+		"spotLight.position",
+		"spotLight.direction",
+		"spotLight.ambient",
+		"spotLight.diffuse",
+		"spotLight.specular",
+		"spotLight.cutOff",
+		"spotLight.outerCutOff",
+		"spotLight.bActive"
+	};
+
+	// point light field names in the same order as POINT_LIGHT_FIELD
+	const char* g_PointLightFieldNames[UniformCache::POINT_LIGHT_FIELD_COUNT] =
+	{
+		"position",
+		"ambient",
+		"diffuse",
+		"specular",
+		"bActive"
+	};
+
+	// names and binding points of the uniform blocks
+	const char* g_CameraBlockName = "CameraBlock";
+	const char* g_LightBlockName = "LightBlock";
+	const char* g_ShadowBlockName = "ShadowBlock";
+	const GLuint g_CameraBlockBinding = 0;
+	const GLuint g_LightBlockBinding = 1;
+	const GLuint g_ShadowBlockBinding = 2;
+}
+
+/***********************************************************
+ *  UniformCache()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+UniformCache::UniformCache()
+{
+	m_programID = 0;
+	m_updateCount = 0;
+	for (int i = 0; i < UNIFORM_COUNT; i++)
+	{
+		m_locations[i] = -1;
+	}
+	m_cameraBuffer = 0;
+	m_lightBuffer = 0;
+	m_shadowBuffer = 0;
+	m_cameraStride = sizeof(CAMERA_BLOCK);
+	m_selectedCamera = 0;
+	for (int i = 0; i < MAX_CAMERAS; i++)
+	{
+		m_cameras[i].view = glm::mat4(1.0f);
+		m_cameras[i].projection = glm::mat4(1.0f);
+		m_cameras[i].viewPosition = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+	}
+}
+
+/***********************************************************
+ *  ~UniformCache()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+UniformCache::~UniformCache()
+{
+	DestroyUniformBuffers();
+}
+
+/***********************************************************
+ *  GetUniformName()
+ *
+ *  This method is used for getting the name of the uniform
+ *  in the shader code that is associated with the handle.
+ ***********************************************************/
+std::string UniformCache::GetUniformName(int handle) const
+{
+	if (handle < UNIFORM_POINT_LIGHTS)
+	{
+		return(g_UniformNames[handle]);
+	}
+
+	int lightIndex = (handle - UNIFORM_POINT_LIGHTS) / POINT_LIGHT_FIELD_COUNT;
+	int field = (handle - UNIFORM_POINT_LIGHTS) % POINT_LIGHT_FIELD_COUNT;
+
+	return("pointLights[" + std::to_string(lightIndex) + "]." + g_PointLightFieldNames[field]);
+}
+
+/***********************************************************
+ *  CreateUniformBuffer()
+ *
+ *  This method is used for creating a uniform buffer object
+ *  for the named uniform block and attaching it to the
+ *  passed in binding point.  Zero is returned when the
+ *  shader does not declare the block, and the values are
+ *  set as uniforms then.
+ ***********************************************************/
+GLuint UniformCache::CreateUniformBuffer(const char* blockName, GLuint bindingPoint, GLsizeiptr size)
+{
+	GLuint blockIndex = glGetUniformBlockIndex(m_programID, blockName);
+	GLuint buffer = 0;
+
+	if (GL_INVALID_INDEX == blockIndex)
+	{
+		std::cout << "The shader does not declare the uniform block:" << blockName << std::endl;
+		return(0);
+	}
+
+	glUniformBlockBinding(m_programID, blockIndex, bindingPoint);
+
+	glGenBuffers(1, &buffer);
+	glBindBuffer(GL_UNIFORM_BUFFER, buffer);
+	glBufferData(GL_UNIFORM_BUFFER, size, NULL, GL_DYNAMIC_DRAW);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+	glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, buffer);
+
+	std::cout << "Using uniform buffer for block:" << blockName << std::endl;
+
+	return(buffer);
+}
+
+/***********************************************************
+ *  IsReadingUniforms()
+ *
+ *  This method is used for checking whether the shader
+ *  reads any of the uniforms from the first to the last of
+ *  the passed in handles.  A shader that still reads the
+ *  uniforms a block replaces only has the block from the
+ *  inserted declarations, so the uniforms are kept.
+ ***********************************************************/
+bool UniformCache::IsReadingUniforms(int firstHandle, int lastHandle) const
+{
+	for (int i = firstHandle; i <= lastHandle; i++)
+	{
+		if (HasUniform(i))
+		{
+			return(true);
+		}
+	}
+
+	return(false);
+}
+
+/***********************************************************
+ *  GetShaderSource()
+ *
+ *  This method is used for getting the GLSL declarations of
+ *  the camera, light and shadow uniform blocks, laid out to
+ *  match the std140 structs.  The blocks have instance
+ *  names, camera, lights and shadows, so they do not clash
+ *  with the uniforms of the same values, and the shader
+ *  checks SCENE_UNIFORM_BLOCKS to read them.
+ ***********************************************************/
+std::string UniformCache::GetShaderSource()
+{
+	std::string pointLightCount = std::to_string(MAX_POINT_LIGHTS);
+	std::string cascadeCount = std::to_string(MAX_SHADOW_CASCADES);
+
+	return(
+		"#define SCENE_UNIFORM_BLOCKS 1\n"
+		"struct SceneDirectionalLight\n"
+		"{\n"
+		"	vec4 direction;\n"
+		"	vec4 ambient;\n"
+		"	vec4 diffuse;\n"
+		"	vec4 specular;\n"
+		"	bool bActive;\n"
+		"};\n"
+		"struct ScenePointLight\n"
+		"{\n"
+		"	vec4 position;\n"
+		"	vec4 ambient;\n"
+		"	vec4 diffuse;\n"
+		"	vec4 specular;\n"
+		"	bool bActive;\n"
+		"};\n"
+		"struct SceneSpotLight\n"
+		"{\n"
+		"	vec4 position;\n"
+		"	vec4 direction;\n"
+		"	vec4 ambient;\n"
+		"	vec4 diffuse;\n"
+		"	vec4 specular;\n"
+		"	float cutOff;\n"
+		"	float outerCutOff;\n"
+		"	bool bActive;\n"
+		"};\n"
+		"layout(std140) uniform " + std::string(g_CameraBlockName) + "\n"
+		"{\n"
+		"	mat4 view;\n"
+		"	mat4 projection;\n"
+		"	vec4 viewPosition;\n"
+		"} camera;\n"
+		"layout(std140) uniform " + std::string(g_LightBlockName) + "\n"
+		"{\n"
+		"	SceneDirectionalLight directionalLight;\n"
+		"	ScenePointLight pointLights[" + pointLightCount + "];\n"
+		"	SceneSpotLight spotLight;\n"
+		"} lights;\n"
+		"layout(std140) uniform " + std::string(g_ShadowBlockName) + "\n"
+		"{\n"
+		"	mat4 cascadeMatrices[" + cascadeCount + "];\n"
+		"	vec4 cascadeSplits;\n"
+		"	vec4 pointShadows[" + pointLightCount + "];\n"
+		"	int cascadeCount;\n"
+		"	float pointShadowBias;\n"
+		"} shadows;\n");
+}
+
+/***********************************************************
+ *  LoadUniforms()
+ *
+ *  This method is used for resolving the locations of all
+ *  of the uniforms in the active shader program.  It must
+ *  be called after the shaders are loaded and in use.
+ ***********************************************************/
+void UniformCache::LoadUniforms()
+{
+	GLint programID = 0;
+
+	DestroyUniformBuffers();
+
+	glGetIntegerv(GL_CURRENT_PROGRAM, &programID);
+	m_programID = programID;
+
+	for (int i = 0; i < UNIFORM_COUNT; i++)
+	{
+		m_locations[i] = glGetUniformLocation(m_programID, GetUniformName(i).c_str());
+	}
+
+	// the camera data of the views is kept side by side, at offsets the
+	// buffer can be bound at, so a view is selected without an upload
+	GLint offsetAlignment = 0;
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &offsetAlignment);
+	offsetAlignment = std::max(offsetAlignment, 1);
+	m_cameraStride = ((sizeof(CAMERA_BLOCK) + offsetAlignment - 1) / offsetAlignment) * offsetAlignment;
+	m_selectedCamera = 0;
+
+	// the blocks are declared ahead of every shader, so a shader
+	// that still reads the uniforms keeps being sent the uniforms
+	if (IsReadingUniforms(UNIFORM_VIEW, UNIFORM_VIEW_POSITION))
+	{
+		std::cout << "The shader reads the uniforms of block:" << g_CameraBlockName << std::endl;
+	}
+	else
+	{
+		m_cameraBuffer = CreateUniformBuffer(g_CameraBlockName, g_CameraBlockBinding, m_cameraStride * MAX_CAMERAS);
+	}
+	if (0 != m_cameraBuffer)
+	{
+		glBindBufferRange(GL_UNIFORM_BUFFER, g_CameraBlockBinding, m_cameraBuffer, 0, sizeof(CAMERA_BLOCK));
+	}
+	if (IsReadingUniforms(UNIFORM_DIRECTIONAL_LIGHT_DIRECTION, UNIFORM_COUNT - 1))
+	{
+		std::cout << "The shader reads the uniforms of block:" << g_LightBlockName << std::endl;
+	}
+	else
+	{
+		m_lightBuffer = CreateUniformBuffer(g_LightBlockName, g_LightBlockBinding, sizeof(LIGHT_BLOCK));
+	}
+	m_shadowBuffer = CreateUniformBuffer(g_ShadowBlockName, g_ShadowBlockBinding, sizeof(SHADOW_BLOCK));
+}
+
+/***********************************************************
+ *  DestroyUniformBuffers()
+ *
+ *  This method is used for freeing the uniform buffer
+ *  objects.
+ ***********************************************************/
+void UniformCache::DestroyUniformBuffers()
+{
+	if (0 != m_cameraBuffer)
+	{
+		glDeleteBuffers(1, &m_cameraBuffer);
+		m_cameraBuffer = 0;
+	}
+	if (0 != m_lightBuffer)
+	{
+		glDeleteBuffers(1, &m_lightBuffer);
+		m_lightBuffer = 0;
+	}
+	if (0 != m_shadowBuffer)
+	{
+		glDeleteBuffers(1, &m_shadowBuffer);
+		m_shadowBuffer = 0;
+	}
+}
+
+/***********************************************************
+ *  PointLightHandle()
+ *
+ *  This method is used for getting the handle of a field of
+ *  one of the point lights.
+ ***********************************************************/
+int UniformCache::PointLightHandle(int lightIndex, POINT_LIGHT_FIELD field)
+{
+	return(UNIFORM_POINT_LIGHTS + (lightIndex * POINT_LIGHT_FIELD_COUNT) + field);
+}
+
+/***********************************************************
+ *  HasUniform()
+ *
+ *  This method is used for checking whether the active
+ *  shader program uses the uniform of the passed in handle.
+ ***********************************************************/
+bool UniformCache::HasUniform(int handle) const
+{
+	return(m_locations[handle] >= 0);
+}
+
+/***********************************************************
+ *  BindStorageBlock()
+ *
+ *  This method is used for attaching the named shader
+ *  storage block of the active shader program to the passed
+ *  in binding point.  False is returned when the shader does
+ *  not declare the block.
+ ***********************************************************/
+bool UniformCache::BindStorageBlock(const char* blockName, GLuint bindingPoint) const
+{
+	GLuint blockIndex = glGetProgramResourceIndex(m_programID, GL_SHADER_STORAGE_BLOCK, blockName);
+
+	if (GL_INVALID_INDEX == blockIndex)
+	{
+		return(false);
+	}
+
+	glShaderStorageBlockBinding(m_programID, blockIndex, bindingPoint);
+
+	std::cout << "Using shader storage buffer for block:" << blockName << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  BindUniformBlock()
+ *
+ *  This method is used for attaching the named uniform block
+ *  of the active shader program to a binding point, for a
+ *  block whose buffer ranges are bound by the caller.  False
+ *  is returned when the shader does not declare the block.
+ ***********************************************************/
+bool UniformCache::BindUniformBlock(const char* blockName, GLuint bindingPoint) const
+{
+	GLuint blockIndex = glGetUniformBlockIndex(m_programID, blockName);
+
+	if (GL_INVALID_INDEX == blockIndex)
+	{
+		std::cout << "The shader does not declare the uniform block:" << blockName << std::endl;
+		return(false);
+	}
+
+	glUniformBlockBinding(m_programID, blockIndex, bindingPoint);
+
+	std::cout << "Using uniform buffer ranges for block:" << blockName << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  HasShadowBlock()
+ *
+ *  This method is used for checking whether the active
+ *  shader program declares the shadow block.  The shadow
+ *  values have no separate uniforms, so the shadows are
+ *  only used when it does.
+ ***********************************************************/
+bool UniformCache::HasShadowBlock() const
+{
+	return(0 != m_shadowBuffer);
+}
+
+/***********************************************************
+ *  GetUpdateCount()
+ *
+ *  This method is used for getting the number of uniform
+ *  and uniform buffer updates made so far, for counting the
+ *  state changes of a frame.
+ ***********************************************************/
+int UniformCache::GetUpdateCount() const
+{
+	return(m_updateCount);
+}
+
+/***********************************************************
+ *  set*Value()
+ *
+ *  These methods are used for setting the uniform values
+ *  through the cached locations.
+ ***********************************************************/
+void UniformCache::setBoolValue(int handle, bool value) const
+{
+	m_updateCount++;
+	glUniform1i(m_locations[handle], (int)value);
+}
+
+void UniformCache::setIntValue(int handle, int value) const
+{
+	m_updateCount++;
+	glUniform1i(m_locations[handle], value);
+}
+
+void UniformCache::setFloatValue(int handle, float value) const
+{
+	m_updateCount++;
+	glUniform1f(m_locations[handle], value);
+}
+
+void UniformCache::setVec2Value(int handle, const glm::vec2& value) const
+{
+	m_updateCount++;
+	glUniform2fv(m_locations[handle], 1, glm::value_ptr(value));
+}
+
+void UniformCache::setVec3Value(int handle, const glm::vec3& value) const
+{
+	m_updateCount++;
+	glUniform3fv(m_locations[handle], 1, glm::value_ptr(value));
+}
+
+void UniformCache::setVec4Value(int handle, const glm::vec4& value) const
+{
+	m_updateCount++;
+	glUniform4fv(m_locations[handle], 1, glm::value_ptr(value));
+}
+
+void UniformCache::setMat4Value(int handle, const glm::mat4& value) const
+{
+	m_updateCount++;
+	glUniformMatrix4fv(m_locations[handle], 1, GL_FALSE, glm::value_ptr(value));
+}
+
+void UniformCache::setSampler2DValue(int handle, int value) const
+{
+	m_updateCount++;
+	glUniform1i(m_locations[handle], value);
+}
+
+/***********************************************************
+ *  SetCameraData()
+ *
+ *  This method is used for setting the per-frame camera
+ *  data of the passed in view into the shader.  When the
+ *  shader declares the camera block, all of the values are
+ *  uploaded at once into the slot of the view.  Otherwise
+ *  they are kept and only set as uniforms while the view is
+ *  selected.
+ ***********************************************************/
+void UniformCache::SetCameraData(const CAMERA_BLOCK& camera, int viewIndex)
+{
+	if ((viewIndex < 0) || (viewIndex >= MAX_CAMERAS))
+	{
+		return;
+	}
+
+	m_cameras[viewIndex] = camera;
+
+	if (0 != m_cameraBuffer)
+	{
+		m_updateCount++;
+		glBindBuffer(GL_UNIFORM_BUFFER, m_cameraBuffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, m_cameraStride * viewIndex, sizeof(CAMERA_BLOCK), &camera);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		return;
+	}
+
+	if (viewIndex == m_selectedCamera)
+	{
+		setMat4Value(UNIFORM_VIEW, camera.view);
+		setMat4Value(UNIFORM_PROJECTION, camera.projection);
+		setVec3Value(UNIFORM_VIEW_POSITION, glm::vec3(camera.viewPosition));
+	}
+}
+
+/***********************************************************
+ *  SelectCamera()
+ *
+ *  This method is used for making the shader use the camera
+ *  data of the passed in view.  With the camera block, only
+ *  the range of the buffer the block reads is moved to the
+ *  slot of the view.
+ ***********************************************************/
+void UniformCache::SelectCamera(int viewIndex)
+{
+	if ((viewIndex < 0) || (viewIndex >= MAX_CAMERAS) || (viewIndex == m_selectedCamera))
+	{
+		return;
+	}
+
+	m_selectedCamera = viewIndex;
+
+	if (0 != m_cameraBuffer)
+	{
+		m_updateCount++;
+		glBindBufferRange(GL_UNIFORM_BUFFER, g_CameraBlockBinding, m_cameraBuffer,
+			m_cameraStride * viewIndex, sizeof(CAMERA_BLOCK));
+		return;
+	}
+
+	const CAMERA_BLOCK& camera = m_cameras[viewIndex];
+	setMat4Value(UNIFORM_VIEW, camera.view);
+	setMat4Value(UNIFORM_PROJECTION, camera.projection);
+	setVec3Value(UNIFORM_VIEW_POSITION, glm::vec3(camera.viewPosition));
+}
+
+/***********************************************************
+ *  SetLightData()
+ *
+ *  This method is used for setting the lighting data into
+ *  the shader.  When the shader declares the light block,
+ *  all of the values are uploaded at once.
+ ***********************************************************/
+void UniformCache::SetLightData(const LIGHT_BLOCK& lights)
+{
+	if (0 != m_lightBuffer)
+	{
+		m_updateCount++;
+		glBindBuffer(GL_UNIFORM_BUFFER, m_lightBuffer);
+		glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(LIGHT_BLOCK), &lights);
+		glBindBuffer(GL_UNIFORM_BUFFER, 0);
+		return;
+	}
+
+	setVec3Value(UNIFORM_DIRECTIONAL_LIGHT_DIRECTION, glm::vec3(lights.directionalLight.direction));
+	setVec3Value(UNIFORM_DIRECTIONAL_LIGHT_AMBIENT, glm::vec3(lights.directionalLight.ambient));
+	setVec3Value(UNIFORM_DIRECTIONAL_LIGHT_DIFFUSE, glm::vec3(lights.directionalLight.diffuse));
+	setVec3Value(UNIFORM_DIRECTIONAL_LIGHT_SPECULAR, glm::vec3(lights.directionalLight.specular));
+	setBoolValue(UNIFORM_DIRECTIONAL_LIGHT_ACTIVE, lights.directionalLight.bActive);
+
+	for (int i = 0; i < MAX_POINT_LIGHTS; i++)
+	{
+		const POINT_LIGHT_DATA& light = lights.pointLights[i];
+		setVec3Value(PointLightHandle(i, POINT_LIGHT_POSITION), glm::vec3(light.position));
+		setVec3Value(PointLightHandle(i, POINT_LIGHT_AMBIENT), glm::vec3(light.ambient));
+		setVec3Value(PointLightHandle(i, POINT_LIGHT_DIFFUSE), glm::vec3(light.diffuse));
+		setVec3Value(PointLightHandle(i, POINT_LIGHT_SPECULAR), glm::vec3(light.specular));
+		setBoolValue(PointLightHandle(i, POINT_LIGHT_ACTIVE), light.bActive);
+	}
+
+	setVec3Value(UNIFORM_SPOT_LIGHT_POSITION, glm::vec3(lights.spotLight.position));
+	setVec3Value(UNIFORM_SPOT_LIGHT_DIRECTION, glm::vec3(lights.spotLight.direction));
+	setVec3Value(UNIFORM_SPOT_LIGHT_AMBIENT, glm::vec3(lights.spotLight.ambient));
+	setVec3Value(UNIFORM_SPOT_LIGHT_DIFFUSE, glm::vec3(lights.spotLight.diffuse));
+	setVec3Value(UNIFORM_SPOT_LIGHT_SPECULAR, glm::vec3(lights.spotLight.specular));
+	setFloatValue(UNIFORM_SPOT_LIGHT_CUTOFF, lights.spotLight.cutOff);
+	setFloatValue(UNIFORM_SPOT_LIGHT_OUTER_CUTOFF, lights.spotLight.outerCutOff);
+	setBoolValue(UNIFORM_SPOT_LIGHT_ACTIVE, lights.spotLight.bActive);
+}
+
+/***********************************************************
+ *  SetShadowData()
+ *
+ *  This method is used for setting the shadow map data into
+ *  the shader, when the shader declares the shadow block.
+ ***********************************************************/
+void UniformCache::SetShadowData(const SHADOW_BLOCK& shadows)
+{
+	if (0 == m_shadowBuffer)
+	{
+		return;
+	}
+
+	m_updateCount++;
+	glBindBuffer(GL_UNIFORM_BUFFER, m_shadowBuffer);
+	glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(SHADOW_BLOCK), &shadows);
+	glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -0,0 +1,230 @@
+///////////////////////////////////////////////////////////////////////////////
+// uniformcache.h
+// ============
+// resolve and cache shader uniform locations, manage uniform buffer objects
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include <GL/glew.h>
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <string>
+
+/***********************************************************
+ *  UniformCache
+ *
+ *  This class resolves the locations of all the uniforms
+ *  used by the scene once, when the shaders are loaded, so
+ *  the render loop only passes integer handles.  The per
+ *  frame camera data and the lighting data are uploaded as
+ *  std140 uniform buffers when the shader declares them.
+ *  The GLSL declarations of the blocks that match the
+ *  structs below are returned by GetShaderSource() and
+ *  inserted ahead of the shader sources.
+ ***********************************************************/
+class UniformCache
+{
+public:
+	// constructor
+	UniformCache();
+	// destructor
+	~UniformCache();
+
+	// the maximum number of point lights in the shader
+	static const int MAX_POINT_LIGHTS = 4;
+	// the number of directional shadow cascades in the shader
+	static const int MAX_SHADOW_CASCADES = 4;
+	// the number of views whose camera data is kept at once
+	static const int MAX_CAMERAS = 4;
+
+	// the fields of each point light in the shader
+	enum POINT_LIGHT_FIELD
+	{
+		POINT_LIGHT_POSITION,
+		POINT_LIGHT_AMBIENT,
+		POINT_LIGHT_DIFFUSE,
+		POINT_LIGHT_SPECULAR,
+		POINT_LIGHT_ACTIVE,
+		POINT_LIGHT_FIELD_COUNT
+	};
+
+	// handles for all of the uniforms used by the scene
+	enum UNIFORM_HANDLE
+	{
+		UNIFORM_MODEL,
+		UNIFORM_VIEW,
+		UNIFORM_PROJECTION,
+		UNIFORM_VIEW_POSITION,
+		UNIFORM_OBJECT_COLOR,
+		UNIFORM_OBJECT_TEXTURE,
+		UNIFORM_OBJECT_TEXTURE_ARRAY,
+		UNIFORM_OBJECT_TEXTURE_LAYER,
+		UNIFORM_USE_TEXTURE,
+		UNIFORM_USE_LIGHTING,
+		UNIFORM_UV_SCALE,
+		UNIFORM_MATERIAL_DIFFUSE_COLOR,
+		UNIFORM_MATERIAL_SPECULAR_COLOR,
+		UNIFORM_MATERIAL_SHININESS,
+		UNIFORM_USE_INSTANCE_BUFFER,
+		UNIFORM_USE_DRAW_BLOCK,
+		UNIFORM_LOD_FADE,
+		UNIFORM_USE_CLUSTERED_LIGHTS,
+		UNIFORM_USE_SHADOWS,
+		UNIFORM_DIRECTIONAL_SHADOW_MAP,
+		UNIFORM_POINT_SHADOW_MAP,
+		UNIFORM_DIRECTIONAL_LIGHT_DIRECTION,
+		UNIFORM_DIRECTIONAL_LIGHT_AMBIENT,
+		UNIFORM_DIRECTIONAL_LIGHT_DIFFUSE,
+		UNIFORM_DIRECTIONAL_LIGHT_SPECULAR,
+		UNIFORM_DIRECTIONAL_LIGHT_ACTIVE,
+		UNIFORM_SPOT_LIGHT_POSITION,
+		UNIFORM_SPOT_LIGHT_DIRECTION,
+		UNIFORM_SPOT_LIGHT_AMBIENT,
+		UNIFORM_SPOT_LIGHT_DIFFUSE,
+		UNIFORM_SPOT_LIGHT_SPECULAR,
+		UNIFORM_SPOT_LIGHT_CUTOFF,
+		UNIFORM_SPOT_LIGHT_OUTER_CUTOFF,
+		UNIFORM_SPOT_LIGHT_ACTIVE,
+		// the point light uniforms follow, POINT_LIGHT_FIELD_COUNT per light
+		UNIFORM_POINT_LIGHTS,
+		UNIFORM_COUNT = UNIFORM_POINT_LIGHTS + (MAX_POINT_LIGHTS * POINT_LIGHT_FIELD_COUNT)
+	};
+
+	// std140 layout of the per-frame camera uniform block
+	struct CAMERA_BLOCK
+	{
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec4 viewPosition;
+	};
+
+	// std140 layout of a directional light
+	struct DIRECTIONAL_LIGHT_DATA
+	{
+		glm::vec4 direction;
+		glm::vec4 ambient;
+		glm::vec4 diffuse;
+		glm::vec4 specular;
+		int bActive;
+		int padding[3];
+	};
+
+	// std140 layout of a point light
+	struct POINT_LIGHT_DATA
+	{
+		glm::vec4 position;
+		glm::vec4 ambient;
+		glm::vec4 diffuse;
+		glm::vec4 specular;
+		int bActive;
+		int padding[3];
+	};
+
+	// std140 layout of a spot light
+	struct SPOT_LIGHT_DATA
+	{
+		glm::vec4 position;
+		glm::vec4 direction;
+		glm::vec4 ambient;
+		glm::vec4 diffuse;
+		glm::vec4 specular;
+		float cutOff;
+		float outerCutOff;
+		int bActive;
+		int padding;
+	};
+
+	// std140 layout of the lighting uniform block
+	struct LIGHT_BLOCK
+	{
+		DIRECTIONAL_LIGHT_DATA directionalLight;
+		POINT_LIGHT_DATA pointLights[MAX_POINT_LIGHTS];
+		SPOT_LIGHT_DATA spotLight;
+	};
+
+	// std140 layout of the shadow uniform block
+	struct SHADOW_BLOCK
+	{
+		// world to shadow map texture space of each cascade
+		glm::mat4 cascadeMatrices[MAX_SHADOW_CASCADES];
+		// view depth where each cascade ends
+		glm::vec4 cascadeSplits;
+		// position and far plane of each shadowed point light, w is 0 for none
+		glm::vec4 pointShadows[MAX_POINT_LIGHTS];
+		int cascadeCount;
+		// subtracted from the point light distance before it is compared
+		float pointShadowBias;
+		int padding[2];
+	};
+
+private:
+	// the shader program the locations were resolved from
+	GLuint m_programID;
+	// the cached uniform locations, indexed by handle
+	GLint m_locations[UNIFORM_COUNT];
+	// uniform buffer objects for the camera and lighting data
+	GLuint m_cameraBuffer;
+	GLuint m_lightBuffer;
+	GLuint m_shadowBuffer;
+	// bytes between the camera data of the views in the camera buffer
+	GLsizeiptr m_cameraStride;
+	// camera data of every view, set as uniforms when there is no camera buffer
+	CAMERA_BLOCK m_cameras[MAX_CAMERAS];
+	// view whose camera data the shader uses
+	int m_selectedCamera;
+	// number of uniform and uniform buffer updates made so far
+	mutable int m_updateCount;
+
+	// get the shader name of the passed in uniform handle
+	std::string GetUniformName(int handle) const;
+	// create a uniform buffer bound to the named block, if the shader declares it
+	GLuint CreateUniformBuffer(const char* blockName, GLuint bindingPoint, GLsizeiptr size);
+	// check whether the shader still reads any uniform of a range of handles
+	bool IsReadingUniforms(int firstHandle, int lastHandle) const;
+
+public:
+	// resolve all of the uniform locations in the active shader program
+	void LoadUniforms();
+	// free the uniform buffer objects
+	void DestroyUniformBuffers();
+
+	// get the handle of a field of one of the point lights
+	static int PointLightHandle(int lightIndex, POINT_LIGHT_FIELD field);
+	// get the GLSL declarations of the camera, light and shadow blocks
+	static std::string GetShaderSource();
+
+	// check whether the shader uses the uniform of the passed in handle
+	bool HasUniform(int handle) const;
+	// attach the named shader storage block to a binding point, if the shader declares it
+	bool BindStorageBlock(const char* blockName, GLuint bindingPoint) const;
+	// attach the named uniform block to a binding point, if the shader declares it
+	bool BindUniformBlock(const char* blockName, GLuint bindingPoint) const;
+	// check whether the shader declares the shadow block
+	bool HasShadowBlock() const;
+	// get the number of uniform and uniform buffer updates made so far
+	int GetUpdateCount() const;
+
+	// set uniform values by handle
+	void setBoolValue(int handle, bool value) const;
+	void setIntValue(int handle, int value) const;
+	void setFloatValue(int handle, float value) const;
+	void setVec2Value(int handle, const glm::vec2& value) const;
+	void setVec3Value(int handle, const glm::vec3& value) const;
+	void setVec4Value(int handle, const glm::vec4& value) const;
+	void setMat4Value(int handle, const glm::mat4& value) const;
+	void setSampler2DValue(int handle, int value) const;
+
+	// set the per-frame camera data of the passed in view into the shader
+	void SetCameraData(const CAMERA_BLOCK& camera, int viewIndex = 0);
+	// make the shader use the camera data of the passed in view
+	void SelectCamera(int viewIndex);
+	// set the lighting data into the shader
+	void SetLightData(const LIGHT_BLOCK& lights);
+	// set the shadow map data into the shader
+	void SetShadowData(const SHADOW_BLOCK& shadows);
+};
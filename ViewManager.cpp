@@ -1,288 +1,676 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.cpp
-// ============
-// manage the viewing of 3D objects within the viewport - camera, projection
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#include "ViewManager.h"
-
-// GLM Math Header inclusions
-#include <glm/glm.hpp>
-#include <glm/gtx/transform.hpp>
-#include <glm/gtc/type_ptr.hpp>    
-
-// declaration of the global variables and defines
-namespace
-{
-	// Variables for window width and height
-	const int WINDOW_WIDTH = 1600;
-	const int WINDOW_HEIGHT = 980;
-	const char* g_ViewName = "view";
-	const char* g_ProjectionName = "projection";
-
-	// camera object used for viewing and interacting with
-	// the 3D scene
-	Camera* g_pCamera = nullptr;
-
-	// these variables are used for mouse movement processing
-	float gLastX = WINDOW_WIDTH / 2.0f;
-	float gLastY = WINDOW_HEIGHT / 2.0f;
-	bool gFirstMouse = true;
-
-	// time between current frame and last frame
-	float gDeltaTime = 0.0f; 
-	float gLastFrame = 0.0f;
-
-	// the following variable is false when orthographic projection
-	// is off and true when it is on
-	bool bOrthographicProjection = false;
-}
-
-/***********************************************************
- *  ViewManager()
- *
- *  The constructor for the class
- ***********************************************************/
-ViewManager::ViewManager(
-	ShaderManager *pShaderManager)
-{
-	// initialize the member variables
-	m_pShaderManager = pShaderManager;
-	m_pWindow = NULL;
-	g_pCamera = new Camera();
-	// default camera view parameters
-	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
-	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
-	g_pCamera->Zoom = 80;
-	g_pCamera->MovementSpeed = 20;
-}
-
-/***********************************************************
- *  ~ViewManager()
- *
- *  The destructor for the class
- ***********************************************************/
-ViewManager::~ViewManager()
-{
-	// free up allocated memory
-	m_pShaderManager = NULL;
-	m_pWindow = NULL;
-	if (NULL != g_pCamera)
-	{
-		delete g_pCamera;
-		g_pCamera = NULL;
-	}
-}
-
-/***********************************************************
- *  CreateDisplayWindow()
- *
- *  This method is used to create the main display window.
- ***********************************************************/
-GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
-{
-	GLFWwindow* window = nullptr;
-
-	// try to create the displayed OpenGL window
-	window = glfwCreateWindow(
-		WINDOW_WIDTH,
-		WINDOW_HEIGHT,
-		windowTitle,
-		NULL, NULL);
-	if (window == NULL)
-	{
-		std::cout << "Failed to create GLFW window" << std::endl;
-		glfwTerminate();
-		return NULL;
-	}
-	glfwMakeContextCurrent(window);
-
-	// tell GLFW to capture all mouse events
-	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
-
-	// Set the viewport dimensions to match the window size
-	glViewport(0, 0, WINDOW_WIDTH, WINDOW_HEIGHT);
-
-	// this callback is used to receive mouse moving events
-	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
-
-	// this callback is used to receive mouse scroller events
-	glfwSetScrollCallback(window, &ViewManager::Mouse_Scroll_Callback);
-
-	// enable blending for supporting tranparent rendering
-	glEnable(GL_BLEND);
-	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-
-	m_pWindow = window;
-
-	return(window);
-}
-
-/***********************************************************
- *  Mouse_Position_Callback()
- *
- *  This method is automatically called from GLFW whenever
- *  the mouse is moved within the active GLFW display window.
- ***********************************************************/
-void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
-{
-	// when the first mouse move event is received, this needs to be recorded so that
-	// all subsequent mouse moves can correctly calculate the X position offset and Y
-	// position offset for proper operation
-	if (gFirstMouse)
-	{
-		gLastX = xMousePos;
-		gLastY = yMousePos;
-		gFirstMouse = false;
-	}
-
-	// EXPERIMENTAL, trying to lock camera while in ortho view mode
-	if (bOrthographicProjection)
-		return;  // Ignore mouse movements in 2D view
-
-	// calculate the X offset and Y offset values for moving the 3D camera accordingly
-	float xOffset = xMousePos - gLastX;
-	float yOffset = gLastY - yMousePos; // reversed since y-coordinates go from bottom to top
-
-	// set the current positions into the last position variables
-	gLastX = xMousePos;
-	gLastY = yMousePos;
-
-	//Modifies the sensitivity of the X/Y mouse positioner.
-	float sensitivity = 0.2f; //less sensitive and reactive
-		xOffset *= sensitivity;
-		yOffset *= sensitivity;
-
-
-	// move the 3D camera according to the calculated offsets
-	g_pCamera->ProcessMouseMovement(xOffset, yOffset);
-}
-
-// Called when mouse wheel is scrolled
-void ViewManager::Mouse_Scroll_Callback(GLFWwindow* window, double xOffset, double yOffset)
-{
-	if (g_pCamera)
-		g_pCamera->ProcessMouseScroll(static_cast<float>(-yOffset));
-}
-
-
-/***********************************************************
- *  ProcessKeyboardEvents()
- *
- *  This method is called to process any keyboard events
- *  that may be waiting in the event queue.
- ***********************************************************/
-void ViewManager::ProcessKeyboardEvents()
-{
-	// close the window if the escape key has been pressed
-	if (glfwGetKey(m_pWindow, GLFW_KEY_ESCAPE) == GLFW_PRESS)
-	{
-		glfwSetWindowShouldClose(m_pWindow, true);
-	}
-
-	// process camera zooming in and out
-	if (glfwGetKey(m_pWindow, GLFW_KEY_W) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_S) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime);
-	}
-
-	// process camera panning left and right
-	if (glfwGetKey(m_pWindow, GLFW_KEY_A) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(LEFT, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_D) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime);
-	}
-
-	// process vertical movement up/down
-	if (glfwGetKey(m_pWindow, GLFW_KEY_Q) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(UP, gDeltaTime);
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_E) == GLFW_PRESS)
-	{
-		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime);
-	}
-
-	// toggle between perspective view and orthographic view projection
-	if (glfwGetKey(m_pWindow, GLFW_KEY_P) == GLFW_PRESS)
-	{
-		bOrthographicProjection = false;
-	}
-	if (glfwGetKey(m_pWindow, GLFW_KEY_O) == GLFW_PRESS)
-	{
-		bOrthographicProjection = true;
-	}
-}
-
-/***********************************************************
- *  PrepareSceneView()
- *
- *  This method is used for preparing the 3D scene by loading
- *  the shapes, textures in memory to support the 3D scene 
- *  rendering
- ***********************************************************/
-void ViewManager::PrepareSceneView()
-{
-	glm::mat4 view;
-	glm::mat4 projection;
-
-	// per-frame timing
-	float currentFrame = glfwGetTime();
-	gDeltaTime = currentFrame - gLastFrame;
-	gLastFrame = currentFrame;
-
-	// process any keyboard events that may be waiting in the 
-	// event queue
-	ProcessKeyboardEvents();
-
-	// get the current view matrix from the camera
-	view = g_pCamera->GetViewMatrix();
-
-	// define the current projection matrix between ortho view and perspective view
-	if (bOrthographicProjection)
-	{
-		// Orthographic: Show front view only in 2D mode
-		float orthoSize = 10.0f;
-		projection = glm::ortho(
-			-orthoSize, orthoSize,     // Left, Right
-			-orthoSize, orthoSize,     // Bottom, Top
-			0.1f, 100.0f                // Near, Far
-		);
-		// Optionally lock camera view
-		g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);  // Straight-on
-		g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
-	}
-	else
-	{
-		// Perspective: angled depth
-		projection = glm::perspective(
-			glm::radians(g_pCamera->Zoom),
-			(GLfloat)WINDOW_WIDTH / (GLfloat)WINDOW_HEIGHT,
-			0.1f, 100.0f
-		);
-	}
-
-	// if the shader manager object is valid
-	if (NULL != m_pShaderManager)
-	{
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ViewName, view);
-		// set the view matrix into the shader for proper rendering
-		m_pShaderManager->setMat4Value(g_ProjectionName, projection);
-		// set the view position of the camera into the shader for proper rendering
-		m_pShaderManager->setVec3Value("viewPosition", g_pCamera->Position);
-	}
-			
-
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.cpp
+// ============
+// manage the viewing of 3D objects within the viewport - camera, projection
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#include "ViewManager.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtx/transform.hpp>
+#include <glm/gtc/type_ptr.hpp>    
+
+#include <algorithm>
+
+// declaration of the global variables and defines
+namespace
+{
+	// Variables for the initial window width and height, the
+	// window can be resized after it is created
+	const int WINDOW_WIDTH = 1600;
+	const int WINDOW_HEIGHT = 980;
+
+	// camera object used for viewing and interacting with
+	// the 3D scene
+	Camera* g_pCamera = nullptr;
+
+	// queue the GLFW callbacks put the keyboard and mouse
+	// events into, handled when the next frame is prepared
+	InputQueue* g_pInputQueue = nullptr;
+
+	// these variables are used for mouse movement processing
+	float gLastX = WINDOW_WIDTH / 2.0f;
+	float gLastY = WINDOW_HEIGHT / 2.0f;
+	bool gFirstMouse = true;
+
+	// true when the mouse was clicked to pick an object
+	bool gPickRequested = false;
+
+	// time between current frame and last frame
+	float gDeltaTime = 0.0f; 
+	float gLastFrame = 0.0f;
+	// the longest time the camera moves for in one frame, since
+	// the frame after an idle pause comes long after the last one
+	const float MAX_FRAME_TIME = 0.1f;
+
+	// the following variable is false when orthographic projection
+	// is off and true when it is on
+	bool bOrthographicProjection = false;
+
+	// half the height the orthographic views show, in world units
+	const float ORTHOGRAPHIC_VIEW_SIZE = 10.0f;
+	// part of the window width the perspective view keeps when the
+	// window is split, the front and top views share the rest
+	const float SPLIT_MAIN_WIDTH = 2.0f / 3.0f;
+}
+
+/***********************************************************
+ *  ViewManager()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+ViewManager::ViewManager(
+	ShaderManager *pShaderManager,
+	UniformCache *pUniformCache)
+{
+	// initialize the member variables
+	m_pShaderManager = pShaderManager;
+	m_pUniformCache = pUniformCache;
+	m_pWindow = NULL;
+	m_bScriptedCamera = false;
+	g_pCamera = new Camera();
+	// default camera view parameters
+	g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);
+	g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+	g_pCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	g_pCamera->Zoom = 80;
+	g_pCamera->MovementSpeed = 20;
+	g_pInputQueue = new InputQueue();
+
+	// the split views look straight at the front of the scene
+	// and straight down on it
+	m_pFrontCamera = new Camera();
+	m_pFrontCamera->Position = glm::vec3(0.0f, 5.0f, 40.0f);
+	m_pFrontCamera->Front = glm::vec3(0.0f, 0.0f, -1.0f);
+	m_pFrontCamera->Up = glm::vec3(0.0f, 1.0f, 0.0f);
+	m_pTopCamera = new Camera();
+	m_pTopCamera->Position = glm::vec3(0.0f, 40.0f, 0.0f);
+	m_pTopCamera->Front = glm::vec3(0.0f, -1.0f, 0.0f);
+	m_pTopCamera->Up = glm::vec3(0.0f, 0.0f, -1.0f);
+
+	for (int i = 0; i < MAX_VIEWS; i++)
+	{
+		m_views[i].pCamera = g_pCamera;
+		m_views[i].rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+		m_views[i].view = glm::mat4(1.0f);
+		m_views[i].projection = glm::mat4(1.0f);
+		m_views[i].viewPosition = glm::vec3(0.0f);
+	}
+	m_layout = LAYOUT_SINGLE;
+	m_viewCount = 1;
+	ArrangeViews();
+}
+
+/***********************************************************
+ *  ~ViewManager()
+ *
+ *  The destructor for the class
+ ***********************************************************/
+ViewManager::~ViewManager()
+{
+	// free up allocated memory
+	m_pShaderManager = NULL;
+	m_pUniformCache = NULL;
+	m_pWindow = NULL;
+	if (NULL != g_pCamera)
+	{
+		delete g_pCamera;
+		g_pCamera = NULL;
+	}
+	if (NULL != g_pInputQueue)
+	{
+		delete g_pInputQueue;
+		g_pInputQueue = NULL;
+	}
+	if (NULL != m_pFrontCamera)
+	{
+		delete m_pFrontCamera;
+		m_pFrontCamera = NULL;
+	}
+	if (NULL != m_pTopCamera)
+	{
+		delete m_pTopCamera;
+		m_pTopCamera = NULL;
+	}
+}
+
+/***********************************************************
+ *  CreateDisplayWindow()
+ *
+ *  This method is used to create the main display window.
+ ***********************************************************/
+GLFWwindow* ViewManager::CreateDisplayWindow(const char* windowTitle)
+{
+	GLFWwindow* window = nullptr;
+
+	// try to create the displayed OpenGL window
+	window = glfwCreateWindow(
+		WINDOW_WIDTH,
+		WINDOW_HEIGHT,
+		windowTitle,
+		NULL, NULL);
+	if (window == NULL)
+	{
+		std::cout << "Failed to create GLFW window" << std::endl;
+		glfwTerminate();
+		return NULL;
+	}
+	glfwMakeContextCurrent(window);
+
+	// tell GLFW to capture all mouse events
+	glfwSetInputMode(window, GLFW_CURSOR, GLFW_CURSOR_DISABLED);
+
+	// Set the viewport dimensions to match the window size, in
+	// pixels, which can differ from the window size on high DPI displays
+	int framebufferWidth = 0;
+	int framebufferHeight = 0;
+	glfwGetFramebufferSize(window, &framebufferWidth, &framebufferHeight);
+	glViewport(0, 0, framebufferWidth, framebufferHeight);
+
+	// this callback is used to receive mouse moving events
+	glfwSetCursorPosCallback(window, &ViewManager::Mouse_Position_Callback);
+
+	// this callback is used to receive mouse scroller events
+	glfwSetScrollCallback(window, &ViewManager::Mouse_Scroll_Callback);
+
+	// this callback is used to receive mouse button events
+	glfwSetMouseButtonCallback(window, &ViewManager::Mouse_Button_Callback);
+
+	// this callback is used to receive keyboard events
+	glfwSetKeyCallback(window, &ViewManager::Key_Callback);
+
+	// these callbacks are used to draw the scene again when the
+	// window is resized or uncovered
+	glfwSetFramebufferSizeCallback(window, &ViewManager::Framebuffer_Size_Callback);
+	glfwSetWindowRefreshCallback(window, &ViewManager::Window_Refresh_Callback);
+
+	// enable blending for supporting tranparent rendering
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+
+	m_pWindow = window;
+
+	return(window);
+}
+
+/***********************************************************
+ *  Mouse_Position_Callback()
+ *
+ *  This method is automatically called from GLFW whenever
+ *  the mouse is moved within the active GLFW display window.
+ *  The move is queued and turns the camera when the next
+ *  frame is prepared.
+ ***********************************************************/
+void ViewManager::Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos)
+{
+	if (NULL != g_pInputQueue)
+	{
+		g_pInputQueue->PushMouseMove(xMousePos, yMousePos);
+	}
+}
+
+/***********************************************************
+ *  ProcessMouseMovement()
+ *
+ *  This method is used for turning the camera by how far the
+ *  mouse moved since its last queued position.
+ ***********************************************************/
+void ViewManager::ProcessMouseMovement(double xMousePos, double yMousePos)
+{
+	// when the first mouse move event is received, this needs to be recorded so that
+	// all subsequent mouse moves can correctly calculate the X position offset and Y
+	// position offset for proper operation
+	if (gFirstMouse)
+	{
+		gLastX = xMousePos;
+		gLastY = yMousePos;
+		gFirstMouse = false;
+	}
+
+	// EXPERIMENTAL, trying to lock camera while in ortho view mode
+	if (bOrthographicProjection)
+		return;  // Ignore mouse movements in 2D view
+
+	// calculate the X offset and Y offset values for moving the 3D camera accordingly
+	float xOffset = xMousePos - gLastX;
+	float yOffset = gLastY - yMousePos; // reversed since y-coordinates go from bottom to top
+
+	// set the current positions into the last position variables
+	gLastX = xMousePos;
+	gLastY = yMousePos;
+
+	//Modifies the sensitivity of the X/Y mouse positioner.
+	float sensitivity = 0.2f; //less sensitive and reactive
+		xOffset *= sensitivity;
+		yOffset *= sensitivity;
+
+
+	// move the 3D camera according to the calculated offsets
+	g_pCamera->ProcessMouseMovement(xOffset, yOffset);
+}
+
+// Called when mouse wheel is scrolled
+void ViewManager::Mouse_Scroll_Callback(GLFWwindow* window, double xOffset, double yOffset)
+{
+	if (g_pInputQueue)
+		g_pInputQueue->PushScroll(xOffset, yOffset);
+}
+
+
+/***********************************************************
+ *  Mouse_Button_Callback()
+ *
+ *  This method is automatically called from GLFW whenever a
+ *  mouse button is pressed or released.  The event is queued
+ *  and a left click asks for the object in the middle of the
+ *  view to be picked when the next frame is prepared.
+ ***********************************************************/
+void ViewManager::Mouse_Button_Callback(GLFWwindow* window, int button, int action, int mods)
+{
+	if (NULL != g_pInputQueue)
+	{
+		g_pInputQueue->PushMouseButton(button, action, mods);
+	}
+}
+
+/***********************************************************
+ *  Key_Callback()
+ *
+ *  This method is automatically called from GLFW whenever a
+ *  key is pressed, repeated or released.  The event is
+ *  queued for the next frame to handle.
+ ***********************************************************/
+void ViewManager::Key_Callback(GLFWwindow* window, int key, int scancode, int action, int mods)
+{
+	if (NULL != g_pInputQueue)
+	{
+		g_pInputQueue->PushKey(key, action, mods);
+	}
+}
+
+/***********************************************************
+ *  Framebuffer_Size_Callback()
+ *  Window_Refresh_Callback()
+ *
+ *  These methods are automatically called from GLFW when
+ *  the window is resized, or when its contents are lost and
+ *  have to be drawn again, so a frame is rendered even when
+ *  nothing in the scene changed.
+ ***********************************************************/
+void ViewManager::Framebuffer_Size_Callback(GLFWwindow* window, int width, int height)
+{
+	if (NULL != g_pInputQueue)
+	{
+		g_pInputQueue->PushRefresh();
+	}
+}
+
+void ViewManager::Window_Refresh_Callback(GLFWwindow* window)
+{
+	if (NULL != g_pInputQueue)
+	{
+		g_pInputQueue->PushRefresh();
+	}
+}
+
+/***********************************************************
+ *  ProcessInputEvents()
+ *
+ *  This method is called to process the keyboard and mouse
+ *  events that were queued since the last frame, in the
+ *  order they were received.  The camera moves for as long
+ *  as its keys are held down.
+ ***********************************************************/
+void ViewManager::ProcessInputEvents()
+{
+	for (int i = 0; i < g_pInputQueue->GetEventCount(); i++)
+	{
+		const InputQueue::INPUT_EVENT& event = g_pInputQueue->GetEvent(i);
+
+		switch (event.type)
+		{
+		case InputQueue::INPUT_KEY:
+			if (GLFW_PRESS != event.action)
+			{
+				break;
+			}
+			// close the window if the escape key has been pressed
+			if (GLFW_KEY_ESCAPE == event.key)
+			{
+				glfwSetWindowShouldClose(m_pWindow, true);
+			}
+			// toggle between perspective view and orthographic view projection
+			else if (GLFW_KEY_P == event.key)
+			{
+				bOrthographicProjection = false;
+			}
+			else if (GLFW_KEY_O == event.key)
+			{
+				bOrthographicProjection = true;
+			}
+			// switch between the single view and the split views
+			else if (GLFW_KEY_V == event.key)
+			{
+				SetViewLayout((VIEW_LAYOUT)((m_layout + 1) % LAYOUT_COUNT));
+			}
+			break;
+		case InputQueue::INPUT_MOUSE_MOVE:
+			ProcessMouseMovement(event.x, event.y);
+			break;
+		case InputQueue::INPUT_SCROLL:
+			g_pCamera->ProcessMouseScroll(static_cast<float>(-event.y));
+			break;
+		case InputQueue::INPUT_MOUSE_BUTTON:
+			if ((GLFW_MOUSE_BUTTON_LEFT == event.key) && (GLFW_PRESS == event.action))
+			{
+				gPickRequested = true;
+			}
+			break;
+		default:
+			break;
+		}
+	}
+
+	// process camera zooming in and out
+	if (g_pInputQueue->IsKeyDown(GLFW_KEY_W))
+	{
+		g_pCamera->ProcessKeyboard(FORWARD, gDeltaTime);
+	}
+	if (g_pInputQueue->IsKeyDown(GLFW_KEY_S))
+	{
+		g_pCamera->ProcessKeyboard(BACKWARD, gDeltaTime);
+	}
+
+	// process camera panning left and right
+	if (g_pInputQueue->IsKeyDown(GLFW_KEY_A))
+	{
+		g_pCamera->ProcessKeyboard(LEFT, gDeltaTime);
+	}
+	if (g_pInputQueue->IsKeyDown(GLFW_KEY_D))
+	{
+		g_pCamera->ProcessKeyboard(RIGHT, gDeltaTime);
+	}
+
+	// process vertical movement up/down
+	if (g_pInputQueue->IsKeyDown(GLFW_KEY_Q))
+	{
+		g_pCamera->ProcessKeyboard(UP, gDeltaTime);
+	}
+	if (g_pInputQueue->IsKeyDown(GLFW_KEY_E))
+	{
+		g_pCamera->ProcessKeyboard(DOWN, gDeltaTime);
+	}
+}
+
+/***********************************************************
+ *  PrepareSceneView()
+ *
+ *  This method is used for preparing the 3D scene by loading
+ *  the shapes, textures in memory to support the 3D scene 
+ *  rendering.  Every view of the layout gets the view and
+ *  projection of its own camera, set into the camera slot
+ *  of the view.
+ ***********************************************************/
+void ViewManager::PrepareSceneView()
+{
+	int framebufferWidth = 0;
+	int framebufferHeight = 0;
+
+	// per-frame timing
+	float currentFrame = glfwGetTime();
+	gDeltaTime = std::min(currentFrame - gLastFrame, MAX_FRAME_TIME);
+	gLastFrame = currentFrame;
+
+	// process the keyboard and mouse events waiting in the input
+	// queue, unless the camera is following a scripted path
+	if (!m_bScriptedCamera)
+	{
+		ProcessInputEvents();
+	}
+
+	glfwGetFramebufferSize(m_pWindow, &framebufferWidth, &framebufferHeight);
+
+	for (int i = 0; i < m_viewCount; i++)
+	{
+		VIEW_INFO& viewInfo = m_views[i];
+		glm::mat4 projection;
+
+		// get the current view matrix from the camera
+		glm::mat4 view = viewInfo.pCamera->GetViewMatrix();
+
+		// the aspect follows the part of the window the view covers
+		// as it is resized, a minimized window keeps the initial aspect
+		GLfloat aspect = ((GLfloat)WINDOW_WIDTH * viewInfo.rect.z) / ((GLfloat)WINDOW_HEIGHT * viewInfo.rect.w);
+		if ((framebufferWidth > 0) && (framebufferHeight > 0))
+		{
+			aspect = ((GLfloat)framebufferWidth * viewInfo.rect.z) / ((GLfloat)framebufferHeight * viewInfo.rect.w);
+		}
+
+		if (i > 0)
+		{
+			// the front and top views show the scene at the same
+			// scale whatever the size of their part of the window
+			projection = glm::ortho(
+				-ORTHOGRAPHIC_VIEW_SIZE * aspect, ORTHOGRAPHIC_VIEW_SIZE * aspect,
+				-ORTHOGRAPHIC_VIEW_SIZE, ORTHOGRAPHIC_VIEW_SIZE,
+				0.1f, 100.0f);
+		}
+		// define the current projection matrix between ortho view and perspective view
+		else if (bOrthographicProjection)
+		{
+			// Orthographic: Show front view only in 2D mode
+			float orthoSize = 10.0f;
+			projection = glm::ortho(
+				-orthoSize, orthoSize,     // Left, Right
+				-orthoSize, orthoSize,     // Bottom, Top
+				0.1f, 100.0f                // Near, Far
+			);
+			// Optionally lock camera view
+			g_pCamera->Position = glm::vec3(0.0f, 5.0f, 12.0f);  // Straight-on
+			g_pCamera->Front = glm::vec3(0.0f, -0.5f, -2.0f);
+		}
+		else
+		{
+			// Perspective: angled depth
+			projection = glm::perspective(
+				glm::radians(g_pCamera->Zoom),
+				aspect,
+				0.1f, 100.0f
+			);
+		}
+
+		// keep the view parameters for culling and sorting the scene
+		viewInfo.view = view;
+		viewInfo.projection = projection;
+		viewInfo.viewPosition = viewInfo.pCamera->Position;
+
+		// if the uniform cache object is valid
+		if (NULL != m_pUniformCache)
+		{
+			UniformCache::CAMERA_BLOCK camera;
+
+			// the view and projection matrices and the view position of the
+			// camera are set into the shader together for proper rendering
+			camera.view = view;
+			camera.projection = projection;
+			camera.viewPosition = glm::vec4(viewInfo.pCamera->Position, 1.0f);
+			m_pUniformCache->SetCameraData(camera, i);
+		}
+	}
+}
+
+/***********************************************************
+ *  ArrangeViews()
+ *
+ *  This method is used for placing the views of the layout
+ *  in the window.  When the window is split, the perspective
+ *  view keeps the left side, and the front view is put
+ *  above the top view on the right side.
+ ***********************************************************/
+void ViewManager::ArrangeViews()
+{
+	m_views[0].pCamera = g_pCamera;
+
+	if (LAYOUT_SPLIT == m_layout)
+	{
+		m_views[0].rect = glm::vec4(0.0f, 0.0f, SPLIT_MAIN_WIDTH, 1.0f);
+		m_views[1].pCamera = m_pFrontCamera;
+		m_views[1].rect = glm::vec4(SPLIT_MAIN_WIDTH, 0.5f, 1.0f - SPLIT_MAIN_WIDTH, 0.5f);
+		m_views[2].pCamera = m_pTopCamera;
+		m_views[2].rect = glm::vec4(SPLIT_MAIN_WIDTH, 0.0f, 1.0f - SPLIT_MAIN_WIDTH, 0.5f);
+		m_viewCount = 3;
+	}
+	else
+	{
+		m_views[0].rect = glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+		m_viewCount = 1;
+	}
+}
+
+/***********************************************************
+ *  SetViewLayout()
+ *
+ *  This method is used for setting how the window is split
+ *  into views, starting with the next prepared frame.
+ ***********************************************************/
+void ViewManager::SetViewLayout(VIEW_LAYOUT layout)
+{
+	m_layout = layout;
+	ArrangeViews();
+}
+
+/***********************************************************
+ *  GetViewLayout()
+ *
+ *  This method is used for getting how the window is split
+ *  into views.
+ ***********************************************************/
+ViewManager::VIEW_LAYOUT ViewManager::GetViewLayout() const
+{
+	return(m_layout);
+}
+
+/***********************************************************
+ *  GetViewCount()
+ *  GetViewRect()
+ *
+ *  These methods are used for getting the views of the
+ *  layout and the part of the window each covers, as the
+ *  lower left corner and size in fractions of the window.
+ ***********************************************************/
+int ViewManager::GetViewCount() const
+{
+	return(m_viewCount);
+}
+
+const glm::vec4& ViewManager::GetViewRect(int viewIndex) const
+{
+	return(m_views[viewIndex].rect);
+}
+
+/***********************************************************
+ *  SetScriptedCamera()
+ *
+ *  This method is used for placing the camera at a pose of
+ *  a scripted path.  Once called, the keyboard no longer
+ *  moves the camera, so the rendered frames only depend on
+ *  the poses that are passed in.
+ ***********************************************************/
+void ViewManager::SetScriptedCamera(const glm::vec3& position, const glm::vec3& front)
+{
+	m_bScriptedCamera = true;
+	bOrthographicProjection = false;
+
+	g_pCamera->Position = position;
+	g_pCamera->Front = front;
+}
+
+/***********************************************************
+ *  GetInputQueue()
+ *
+ *  This method is used for getting the queue the keyboard
+ *  and mouse events are received in.  The main loop handles
+ *  its own keys from it and clears it after every frame.
+ ***********************************************************/
+InputQueue* ViewManager::GetInputQueue() const
+{
+	return(g_pInputQueue);
+}
+
+/***********************************************************
+ *  IsCameraMoving()
+ *
+ *  This method is used for checking whether a key that moves
+ *  the camera is held down, so the frames have to keep being
+ *  rendered even though no new events arrive.
+ ***********************************************************/
+bool ViewManager::IsCameraMoving() const
+{
+	if (m_bScriptedCamera)
+	{
+		return(false);
+	}
+
+	return(g_pInputQueue->IsKeyDown(GLFW_KEY_W) ||
+		g_pInputQueue->IsKeyDown(GLFW_KEY_S) ||
+		g_pInputQueue->IsKeyDown(GLFW_KEY_A) ||
+		g_pInputQueue->IsKeyDown(GLFW_KEY_D) ||
+		g_pInputQueue->IsKeyDown(GLFW_KEY_Q) ||
+		g_pInputQueue->IsKeyDown(GLFW_KEY_E));
+}
+
+/***********************************************************
+ *  GetPickRay()
+ *
+ *  This method is used for getting the ray of a pick that
+ *  was requested with the mouse since the last call.  The
+ *  cursor is captured for steering the camera, so the ray
+ *  goes through the middle of the first view, where the
+ *  camera is looking.  The ray is found by unprojecting the middle of
+ *  the near and far planes, which works for the perspective
+ *  and the orthographic projection.
+ ***********************************************************/
+bool ViewManager::GetPickRay(glm::vec3& origin, glm::vec3& direction) const
+{
+	if (!gPickRequested)
+	{
+		return(false);
+	}
+	gPickRequested = false;
+
+	glm::mat4 inverseViewProjection = glm::inverse(m_views[0].projection * m_views[0].view);
+	glm::vec4 nearPoint = inverseViewProjection * glm::vec4(0.0f, 0.0f, -1.0f, 1.0f);
+	glm::vec4 farPoint = inverseViewProjection * glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+
+	origin = glm::vec3(nearPoint) / nearPoint.w;
+	direction = glm::normalize((glm::vec3(farPoint) / farPoint.w) - origin);
+
+	return(true);
+}
+
+/***********************************************************
+ *  GetViewMatrix()
+ *  GetProjectionMatrix()
+ *  GetViewPosition()
+ *
+ *  These methods are used for getting the view parameters
+ *  of a view of the frame that was last prepared.
+ ***********************************************************/
+const glm::mat4& ViewManager::GetViewMatrix(int viewIndex) const
+{
+	return(m_views[viewIndex].view);
+}
+
+const glm::mat4& ViewManager::GetProjectionMatrix(int viewIndex) const
+{
+	return(m_views[viewIndex].projection);
+}
+
+const glm::vec3& ViewManager::GetViewPosition(int viewIndex) const
+{
+	return(m_views[viewIndex].viewPosition);
 }
\ No newline at end of file
@@ -1,48 +1,140 @@
-///////////////////////////////////////////////////////////////////////////////
-// viewmanager.h
-// ============
-// manage the viewing of 3D objects within the viewport - camera, projection
-//
-//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
-//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
-///////////////////////////////////////////////////////////////////////////////
-
-#pragma once
-
-#include "ShaderManager.h"
-#include "camera.h"
-
-// GLFW library
-#include "GLFW/glfw3.h" 
-
-class ViewManager
-{
-public:
-	// constructor
-	ViewManager(
-		ShaderManager* pShaderManager);
-	// destructor
-	~ViewManager();
-
-	// mouse position callback for mouse interaction with the 3D scene
-	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
-
-	//mouse position callback for mouse interaction with the 3D scene
-	static void Mouse_Scroll_Callback(GLFWwindow* window, double xOffset, double yOffset);
-
-private:
-	// pointer to shader manager object
-	ShaderManager* m_pShaderManager;
-	// active OpenGL display window
-	GLFWwindow* m_pWindow;
-
-	// process keyboard events for interaction with the 3D scene
-	void ProcessKeyboardEvents();
-
-public:
-	// create the initial OpenGL display window
-	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
-	
-	// prepare the conversion from 3D object display to 2D scene display
-	void PrepareSceneView();
+///////////////////////////////////////////////////////////////////////////////
+// viewmanager.h
+// ============
+// manage the viewing of 3D objects within the viewport - camera, projection
+//
+//  AUTHOR: Brian Battersby - SNHU Instructor / Computer Science
+//	Created for CS-330-Computational Graphics and Visualization, Nov. 1st, 2023
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "ShaderManager.h"
+#include "UniformCache.h"
+#include "InputQueue.h"
+#include "camera.h"
+
+// GLFW library
+#include "GLFW/glfw3.h" 
+
+/***********************************************************
+ *  ViewManager
+ *
+ *  This class manages the cameras and the views the window
+ *  is split into.  Every view has its own camera, and the
+ *  views are drawn as viewports of the one render target
+ *  of the frame rather than into targets of their own, so
+ *  they share its resolution scale and there is no post
+ *  processing per view.  The directional shadow cascades
+ *  are fit to the first, perspective view only, so the
+ *  other views are drawn without directional shadows.
+ ***********************************************************/
+class ViewManager
+{
+public:
+	// constructor
+	ViewManager(
+		ShaderManager* pShaderManager,
+		UniformCache* pUniformCache);
+	// destructor
+	~ViewManager();
+
+	// the most views the window is split into, one camera block slot each
+	static const int MAX_VIEWS = UniformCache::MAX_CAMERAS;
+
+	// the ways the window is split into views
+	enum VIEW_LAYOUT
+	{
+		// the perspective view over the whole window
+		LAYOUT_SINGLE = 0,
+		// the perspective view beside orthographic front and top views
+		LAYOUT_SPLIT,
+		LAYOUT_COUNT
+	};
+
+	// mouse position callback for mouse interaction with the 3D scene
+	static void Mouse_Position_Callback(GLFWwindow* window, double xMousePos, double yMousePos);
+
+	//mouse position callback for mouse interaction with the 3D scene
+	static void Mouse_Scroll_Callback(GLFWwindow* window, double xOffset, double yOffset);
+
+	// mouse button callback for picking objects in the 3D scene
+	static void Mouse_Button_Callback(GLFWwindow* window, int button, int action, int mods);
+
+	// keyboard callback for interaction with the 3D scene
+	static void Key_Callback(GLFWwindow* window, int key, int scancode, int action, int mods);
+
+	// window callbacks for drawing the scene again after a resize or when uncovered
+	static void Framebuffer_Size_Callback(GLFWwindow* window, int width, int height);
+	static void Window_Refresh_Callback(GLFWwindow* window);
+
+private:
+	// pointer to shader manager object
+	ShaderManager* m_pShaderManager;
+	// pointer to cached shader uniform locations
+	UniformCache* m_pUniformCache;
+	// active OpenGL display window
+	GLFWwindow* m_pWindow;
+	// true when the camera follows a scripted path instead of the input
+	bool m_bScriptedCamera;
+
+	// the camera of one view and the part of the window it covers
+	struct VIEW_INFO
+	{
+		Camera* pCamera;
+		// lower left corner and size, as fractions of the window
+		glm::vec4 rect;
+		// view parameters of the last prepared frame
+		glm::mat4 view;
+		glm::mat4 projection;
+		glm::vec3 viewPosition;
+	};
+
+	// how the window is split and the views of the layout, the
+	// first view is steered by the input
+	VIEW_LAYOUT m_layout;
+	VIEW_INFO m_views[MAX_VIEWS];
+	int m_viewCount;
+	// cameras of the orthographic front and top views
+	Camera* m_pFrontCamera;
+	Camera* m_pTopCamera;
+
+	// place the views of the layout in the window
+	void ArrangeViews();
+
+	// process the queued keyboard and mouse events for interaction with the 3D scene
+	void ProcessInputEvents();
+	// turn the camera by the mouse moving to the passed in cursor position
+	void ProcessMouseMovement(double xMousePos, double yMousePos);
+
+public:
+	// create the initial OpenGL display window
+	GLFWwindow* CreateDisplayWindow(const char* windowTitle);
+	
+	// prepare the conversion from 3D object display to 2D scene display
+	void PrepareSceneView();
+
+	// place the camera from a scripted path, ignoring the user input
+	void SetScriptedCamera(const glm::vec3& position, const glm::vec3& front);
+
+	// get the queue the keyboard and mouse events are received in
+	InputQueue* GetInputQueue() const;
+	// check whether a key that moves the camera is held down
+	bool IsCameraMoving() const;
+
+	// get the ray of a pick requested with the mouse since the last call
+	bool GetPickRay(glm::vec3& origin, glm::vec3& direction) const;
+
+	// set how the window is split into views
+	void SetViewLayout(VIEW_LAYOUT layout);
+	VIEW_LAYOUT GetViewLayout() const;
+	// get the number of views of the layout
+	int GetViewCount() const;
+	// get the part of the window a view covers, as fractions of its size
+	const glm::vec4& GetViewRect(int viewIndex) const;
+
+	// get the view parameters of a view of the last prepared frame
+	const glm::mat4& GetViewMatrix(int viewIndex = 0) const;
+	const glm::mat4& GetProjectionMatrix(int viewIndex = 0) const;
+	const glm::vec3& GetViewPosition(int viewIndex = 0) const;
 };
\ No newline at end of file
@@ -0,0 +1,331 @@
+///////////////////////////////////////////////////////////////////////////////
+// worldstreamer.cpp
+// ============
+// split the world into cells and choose which cells are streamed in
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#include "WorldStreamer.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+// declaration of global variables and defines
+namespace
+{
+	// cells are evicted this much farther out than they are loaded
+	const float g_UnloadRadiusScale = 1.25f;
+	// the budget limit is lifted once memory falls below this share of it
+	const float g_BudgetRecovery = 0.75f;
+}
+
+/***********************************************************
+ *  WorldStreamer()
+ *
+ *  The constructor for the class
+ ***********************************************************/
+WorldStreamer::WorldStreamer()
+{
+	m_memoryBudget = 512 * 1024 * 1024;
+	SetCellSize(32.0f, 96.0f);
+	Clear();
+}
+
+/***********************************************************
+ *  MakeCellKey()
+ *
+ *  This method is used for combining a grid position into
+ *  one key for looking up its cell.
+ ***********************************************************/
+int64_t WorldStreamer::MakeCellKey(int x, int z)
+{
+	return(((int64_t)x << 32) | (uint32_t)z);
+}
+
+/***********************************************************
+ *  GetCellDistance()
+ *
+ *  This method is used for getting the distance from a
+ *  position to the closest point of the bounds of a cell,
+ *  which is 0 when the position is inside them.
+ ***********************************************************/
+float WorldStreamer::GetCellDistance(const STREAMING_CELL& cell, const glm::vec3& position)
+{
+	glm::vec3 closest = glm::clamp(position, cell.bounds.min, cell.bounds.max);
+
+	return(glm::length(position - closest));
+}
+
+/***********************************************************
+ *  SetCellSize()
+ *
+ *  This method is used for setting the width of the cells
+ *  and the radius they are loaded within.  It only affects
+ *  the objects added after it is called.
+ ***********************************************************/
+void WorldStreamer::SetCellSize(float cellSize, float loadRadius)
+{
+	m_cellSize = std::max(cellSize, 1.0f);
+	m_loadRadius = std::max(loadRadius, 0.0f);
+	m_unloadRadius = m_loadRadius * g_UnloadRadiusScale;
+}
+
+/***********************************************************
+ *  SetMemoryBudget()
+ *
+ *  This method is used for setting the bytes the streamed in
+ *  data can use.  The cell around the camera is never evicted
+ *  for the budget, so one cell may still go over it.
+ ***********************************************************/
+void WorldStreamer::SetMemoryBudget(size_t memoryBudget)
+{
+	m_memoryBudget = memoryBudget;
+}
+
+/***********************************************************
+ *  Clear()
+ *
+ *  This method is used for removing all of the cells.
+ ***********************************************************/
+void WorldStreamer::Clear()
+{
+	m_cells.clear();
+	m_cellIndices.clear();
+	m_worldBounds.min = glm::vec3(FLT_MAX);
+	m_worldBounds.max = glm::vec3(-FLT_MAX);
+	m_objectCount = 0;
+	m_budgetRadius = FLT_MAX;
+	m_bSettled = true;
+}
+
+/***********************************************************
+ *  AddObject()
+ *
+ *  This method is used for adding an object to the cell that
+ *  the center of its bounds falls in, along with the texture
+ *  it uses, or -1 for none.  The bounds of the cell grow to
+ *  hold the whole object.
+ ***********************************************************/
+void WorldStreamer::AddObject(int objectIndex, const Frustum::BOUNDING_BOX& bounds, int textureSlot)
+{
+	glm::vec3 center = (bounds.min + bounds.max) * 0.5f;
+	int x = (int)floorf(center.x / m_cellSize);
+	int z = (int)floorf(center.z / m_cellSize);
+	int64_t key = MakeCellKey(x, z);
+	int cellIndex = -1;
+
+	std::unordered_map<int64_t, int>::const_iterator found = m_cellIndices.find(key);
+	if (found == m_cellIndices.end())
+	{
+		STREAMING_CELL cell;
+		cell.x = x;
+		cell.z = z;
+		cell.bounds = bounds;
+		cell.state = CELL_UNLOADED;
+		cell.distance = FLT_MAX;
+
+		cellIndex = m_cells.size();
+		m_cellIndices[key] = cellIndex;
+		m_cells.push_back(cell);
+	}
+	else
+	{
+		cellIndex = found->second;
+	}
+
+	STREAMING_CELL& cell = m_cells[cellIndex];
+
+	cell.bounds.min = glm::min(cell.bounds.min, bounds.min);
+	cell.bounds.max = glm::max(cell.bounds.max, bounds.max);
+	cell.objects.push_back(objectIndex);
+	if ((textureSlot >= 0) &&
+		(std::find(cell.textures.begin(), cell.textures.end(), textureSlot) == cell.textures.end()))
+	{
+		cell.textures.push_back(textureSlot);
+	}
+
+	m_worldBounds.min = glm::min(m_worldBounds.min, bounds.min);
+	m_worldBounds.max = glm::max(m_worldBounds.max, bounds.max);
+	m_objectCount++;
+}
+
+/***********************************************************
+ *  NeedsStreaming()
+ *
+ *  This method is used for checking whether the world is
+ *  larger than the load radius across, so that some part of
+ *  it would be out of range from wherever the camera is.  A
+ *  smaller world is simply kept in memory as a whole.
+ ***********************************************************/
+bool WorldStreamer::NeedsStreaming() const
+{
+	if ((m_objectCount == 0) || (m_cells.size() < 2))
+	{
+		return(false);
+	}
+
+	glm::vec3 size = m_worldBounds.max - m_worldBounds.min;
+
+	return(std::max(size.x, size.z) > m_loadRadius);
+}
+
+/***********************************************************
+ *  Update()
+ *
+ *  This method is used for choosing the cells to load and
+ *  to evict from the position of the camera and the bytes
+ *  the resident cells use.  The chosen cells are marked as
+ *  loading or unloaded right away, and the caller starts
+ *  and drops their data.
+ ***********************************************************/
+void WorldStreamer::Update(
+	const glm::vec3& position,
+	size_t residentBytes,
+	std::vector<int>& cellsToLoad,
+	std::vector<int>& cellsToEvict)
+{
+	std::vector<std::pair<float, int>> candidates;
+	int cellsInFlight = 0;
+	int farthestCell = -1;
+
+	cellsToLoad.clear();
+	cellsToEvict.clear();
+
+	// lift the budget limit once enough memory has been freed
+	if (residentBytes < (size_t)(m_memoryBudget * g_BudgetRecovery))
+	{
+		m_budgetRadius = FLT_MAX;
+	}
+
+	for (int i = 0; i < m_cells.size(); i++)
+	{
+		STREAMING_CELL& cell = m_cells[i];
+
+		cell.distance = GetCellDistance(cell, position);
+
+		if (cell.state == CELL_UNLOADED)
+		{
+			if ((cell.distance <= m_loadRadius) && (cell.distance < m_budgetRadius))
+			{
+				candidates.push_back(std::make_pair(cell.distance, i));
+			}
+		}
+		else if (cell.distance > m_unloadRadius)
+		{
+			cell.state = CELL_UNLOADED;
+			cellsToEvict.push_back(i);
+		}
+		else
+		{
+			if (cell.state == CELL_LOADING)
+			{
+				cellsInFlight++;
+			}
+			// the cell around the camera is never evicted for the budget
+			if ((cell.state == CELL_RESIDENT) && (cell.distance > 0.0f) &&
+				((farthestCell < 0) || (cell.distance > m_cells[farthestCell].distance)))
+			{
+				farthestCell = i;
+			}
+		}
+	}
+
+	// free one cell at a time, the freed bytes are seen next frame
+	if ((residentBytes > m_memoryBudget) && (farthestCell >= 0))
+	{
+		m_budgetRadius = m_cells[farthestCell].distance;
+		m_cells[farthestCell].state = CELL_UNLOADED;
+		cellsToEvict.push_back(farthestCell);
+		m_bSettled = false;
+		return;
+	}
+
+	// once nothing is loading or left to load, the cells only
+	// change again when the camera moves
+	m_bSettled = (cellsInFlight == 0) && candidates.empty();
+
+	std::sort(candidates.begin(), candidates.end());
+
+	for (int i = 0; i < candidates.size(); i++)
+	{
+		if ((cellsToLoad.size() >= MAX_CELL_LOADS_PER_FRAME) ||
+			(cellsInFlight + cellsToLoad.size() >= MAX_CELLS_IN_FLIGHT))
+		{
+			break;
+		}
+
+		m_cells[candidates[i].second].state = CELL_LOADING;
+		cellsToLoad.push_back(candidates[i].second);
+	}
+}
+
+/***********************************************************
+ *  SetCellResident()
+ *
+ *  This method is used for marking a loading cell as
+ *  resident once all of its data has arrived.
+ ***********************************************************/
+void WorldStreamer::SetCellResident(int cell)
+{
+	if ((cell >= 0) && (cell < m_cells.size()) && (m_cells[cell].state == CELL_LOADING))
+	{
+		m_cells[cell].state = CELL_RESIDENT;
+	}
+}
+
+/***********************************************************
+ *  GetCell()
+ *
+ *  This method is used for getting the cell at the passed
+ *  in index.
+ ***********************************************************/
+const WorldStreamer::STREAMING_CELL& WorldStreamer::GetCell(int cell) const
+{
+	return(m_cells[cell]);
+}
+
+/***********************************************************
+ *  GetCellCount()
+ *
+ *  This method is used for getting the number of cells.
+ ***********************************************************/
+int WorldStreamer::GetCellCount() const
+{
+	return(m_cells.size());
+}
+
+/***********************************************************
+ *  GetResidentCellCount()
+ *
+ *  This method is used for getting the number of cells that
+ *  are resident.
+ ***********************************************************/
+int WorldStreamer::GetResidentCellCount() const
+{
+	int residentCells = 0;
+
+	for (int i = 0; i < m_cells.size(); i++)
+	{
+		if (m_cells[i].state == CELL_RESIDENT)
+		{
+			residentCells++;
+		}
+	}
+	return(residentCells);
+}
+
+/***********************************************************
+ *  IsSettled()
+ *
+ *  This method is used for checking whether the last update
+ *  found every cell within range resident, with nothing
+ *  loading and no memory to free.  Until then the cells
+ *  keep changing from frame to frame even when the camera
+ *  stands still.
+ ***********************************************************/
+bool WorldStreamer::IsSettled() const
+{
+	return(m_bSettled);
+}
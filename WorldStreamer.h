@@ -0,0 +1,123 @@
+///////////////////////////////////////////////////////////////////////////////
+// worldstreamer.h
+// ============
+// split the world into cells and choose which cells are streamed in
+//
+//	Created for CS-330-Computational Graphics and Visualization
+///////////////////////////////////////////////////////////////////////////////
+
+#pragma once
+
+#include "Frustum.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+/***********************************************************
+ *  WorldStreamer
+ *
+ *  This class splits the objects of the world into square
+ *  cells on the XZ plane and decides every frame which cells
+ *  should be streamed in around the camera.  Cells within
+ *  the load radius are requested nearest first, a few per
+ *  frame, and cells past the unload radius are evicted.  The
+ *  unload radius is a little larger than the load radius, so
+ *  a camera moving along a cell border does not load and
+ *  evict the same cell over and over.  When the memory used
+ *  goes over the budget, the farthest cells are evicted and
+ *  no cells that far away are loaded until enough memory has
+ *  been freed.  The loading itself is done by the owner of
+ *  the cells, which reports back once a cell is resident.
+ ***********************************************************/
+class WorldStreamer
+{
+public:
+	// constructor
+	WorldStreamer();
+
+	// the most cells requested in one frame, and the most cells
+	// that can be waiting for their data at once
+	static const int MAX_CELL_LOADS_PER_FRAME = 2;
+	static const int MAX_CELLS_IN_FLIGHT = 4;
+
+	// the streaming progress of a cell
+	enum CELL_STATE
+	{
+		CELL_UNLOADED = 0,
+		CELL_LOADING,
+		CELL_RESIDENT
+	};
+
+	struct STREAMING_CELL
+	{
+		// grid position of the cell
+		int x;
+		int z;
+		// bounds of the objects of the cell, which can reach past the cell
+		Frustum::BOUNDING_BOX bounds;
+		// the objects of the cell and the texture slots they use
+		std::vector<int> objects;
+		std::vector<int> textures;
+		CELL_STATE state;
+		// distance from the camera to the bounds, as of the last update
+		float distance;
+	};
+
+private:
+	// width of the cells and the distances cells are loaded and evicted at
+	float m_cellSize;
+	float m_loadRadius;
+	float m_unloadRadius;
+	// bytes the streamed in data can use, and the distance past
+	// which nothing is loaded while memory is being freed
+	size_t m_memoryBudget;
+	float m_budgetRadius;
+	// every cell that has objects, and the cells by grid position
+	std::vector<STREAMING_CELL> m_cells;
+	std::unordered_map<int64_t, int> m_cellIndices;
+	// bounds of every object that was added
+	Frustum::BOUNDING_BOX m_worldBounds;
+	int m_objectCount;
+	// true when the last update found every cell in range resident
+	bool m_bSettled;
+
+	// get the key of a grid position
+	static int64_t MakeCellKey(int x, int z);
+	// get the distance from a position to the bounds of a cell
+	static float GetCellDistance(const STREAMING_CELL& cell, const glm::vec3& position);
+
+public:
+	// set the width of the cells and the radius they are loaded within
+	void SetCellSize(float cellSize, float loadRadius);
+	// set the bytes the streamed in data can use
+	void SetMemoryBudget(size_t memoryBudget);
+	// remove all of the cells
+	void Clear();
+
+	// add an object to the cell its bounds are centered in
+	void AddObject(int objectIndex, const Frustum::BOUNDING_BOX& bounds, int textureSlot);
+	// check whether the world reaches past the load radius
+	bool NeedsStreaming() const;
+
+	// choose the cells to load and to evict around the camera
+	void Update(
+		const glm::vec3& position,
+		size_t residentBytes,
+		std::vector<int>& cellsToLoad,
+		std::vector<int>& cellsToEvict);
+	// mark a loading cell as resident once its data has arrived
+	void SetCellResident(int cell);
+
+	// get a cell and the number of cells
+	const STREAMING_CELL& GetCell(int cell) const;
+	int GetCellCount() const;
+	// get the number of cells that are resident
+	int GetResidentCellCount() const;
+	// check whether every cell in range was resident as of the last update
+	bool IsSettled() const;
+};
@@ -0,0 +1,811 @@
+///////////////////////////////////////////////////////////////////////////////
+// meshcompiler.cpp
+// ============
+// command line tool - import an OBJ model and compile it into a mesh file
+//
+//	Created for CS-330-Computational Graphics and Visualization
+//
+//  Usage: MeshCompiler models/teapot.obj [models/teapot.mesh]
+//
+//  Build it together with ../MeshFile.cpp, which holds the vertex
+//  quantization the application reads back.
+//
+//  The OBJ positions, texture coordinates and normals are welded into
+//  indexed triangles, and faces with more than three corners are split into
+//  fans.  Vertices without a normal in the file get the average normal of
+//  the faces around them.  The triangles are then optimized offline, so
+//  the application can upload them as they are:
+//
+//    - reordered for the post transform vertex cache, so most vertices
+//      of a triangle were just transformed for the triangles before it
+//    - split into meshlets of at most 64 vertices and 124 triangles, each
+//      with a bounding sphere and a cone of the directions it faces
+//    - meshlets facing out from the center of the model are moved first,
+//      so they cover the inner ones and less of the model is overdrawn
+//    - the vertices renumbered in the order the indices first use them,
+//      so the vertex fetch reads the vertex buffer front to back
+//    - each vertex quantized to 16 bytes, half float positions and
+//      texture coordinates and a 10:10:10:2 normal
+//
+//  The output name defaults to the input name with a .mesh extension.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "MeshFile.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// declaration of global variables and defines
+namespace
+{
+	// size of the simulated vertex cache the triangles are ordered for
+	const int g_VertexCacheSize = 32;
+	// size of the first in first out cache the ordering is measured with
+	const int g_MeasureCacheSize = 16;
+
+	// one corner of an OBJ face, as indices into the position, texture
+	// coordinate and normal lists, -1 when it is not given
+	struct OBJ_CORNER
+	{
+		int position;
+		int texCoord;
+		int normal;
+
+		bool operator<(const OBJ_CORNER& other) const
+		{
+			if (position != other.position)
+			{
+				return(position < other.position);
+			}
+			if (texCoord != other.texCoord)
+			{
+				return(texCoord < other.texCoord);
+			}
+			return(normal < other.normal);
+		}
+	};
+
+	// one welded vertex with full float attributes
+	struct IMPORT_VERTEX
+	{
+		glm::vec3 position;
+		glm::vec3 normal;
+		glm::vec2 texCoord;
+	};
+
+	// the model while it is being compiled
+	struct IMPORT_MESH
+	{
+		std::vector<IMPORT_VERTEX> vertices;
+		std::vector<uint32_t> indices;
+		std::vector<MESH_FILE_MESHLET> meshlets;
+	};
+
+	// the state of one vertex while the triangles are ordered
+	struct CACHE_VERTEX
+	{
+		// position in the simulated cache, -1 when it is not cached
+		int cachePosition;
+		// number of triangles not ordered yet that use it
+		int remaining;
+		float score;
+		// first of its triangles in the adjacency list
+		int firstTriangle;
+		int triangleCount;
+	};
+}
+
+/***********************************************************
+ *  ParseCorner()
+ *
+ *  This function is used for parsing one corner of a face,
+ *  written as v, v/vt, v//vn or v/vt/vn.  The indices count
+ *  from one, or back from the end of the lists read so far
+ *  when they are negative.
+ ***********************************************************/
+bool ParseCorner(const char* pText, int positionCount, int texCoordCount, int normalCount, OBJ_CORNER& corner)
+{
+	int counts[3] = { positionCount, texCoordCount, normalCount };
+	int values[3] = { -1, -1, -1 };
+	const char* pCurrent = pText;
+
+	for (int i = 0; i < 3; i++)
+	{
+		if ((*pCurrent != '/') && (*pCurrent != '\0'))
+		{
+			char* pEnd = NULL;
+			long value = strtol(pCurrent, &pEnd, 10);
+
+			if ((pEnd == pCurrent) || (value == 0))
+			{
+				return(false);
+			}
+			values[i] = (value > 0) ? (int)(value - 1) : (int)(counts[i] + value);
+			if ((values[i] < 0) || (values[i] >= counts[i]))
+			{
+				return(false);
+			}
+			pCurrent = pEnd;
+		}
+		if (*pCurrent != '/')
+		{
+			break;
+		}
+		pCurrent++;
+	}
+
+	if (values[0] < 0)
+	{
+		return(false);
+	}
+
+	corner.position = values[0];
+	corner.texCoord = values[1];
+	corner.normal = values[2];
+
+	return(true);
+}
+
+/***********************************************************
+ *  LoadObj()
+ *
+ *  This function is used for reading an OBJ file into
+ *  welded indexed triangles.  Corners that share all of
+ *  their indices become one vertex.  Lines other than
+ *  positions, texture coordinates, normals and faces are
+ *  ignored.
+ ***********************************************************/
+bool LoadObj(const std::string& inputName, IMPORT_MESH& mesh)
+{
+	FILE* file = fopen(inputName.c_str(), "rb");
+	std::vector<glm::vec3> positions;
+	std::vector<glm::vec2> texCoords;
+	std::vector<glm::vec3> normals;
+	std::map<OBJ_CORNER, uint32_t> welded;
+	std::vector<bool> hasNormal;
+	char line[1024];
+	int lineNumber = 0;
+
+	if (NULL == file)
+	{
+		std::cout << "Could not open model:" << inputName << std::endl;
+		return(false);
+	}
+
+	while (NULL != fgets(line, sizeof(line), file))
+	{
+		float x = 0.0f;
+		float y = 0.0f;
+		float z = 0.0f;
+
+		lineNumber++;
+
+		if ((line[0] == 'v') && (line[1] == ' '))
+		{
+			sscanf(line + 2, "%f %f %f", &x, &y, &z);
+			positions.push_back(glm::vec3(x, y, z));
+		}
+		else if ((line[0] == 'v') && (line[1] == 't') && (line[2] == ' '))
+		{
+			sscanf(line + 3, "%f %f", &x, &y);
+			texCoords.push_back(glm::vec2(x, y));
+		}
+		else if ((line[0] == 'v') && (line[1] == 'n') && (line[2] == ' '))
+		{
+			sscanf(line + 3, "%f %f %f", &x, &y, &z);
+			normals.push_back(glm::vec3(x, y, z));
+		}
+		else if ((line[0] == 'f') && (line[1] == ' '))
+		{
+			std::vector<uint32_t> face;
+			char* pToken = strtok(line + 2, " \t\r\n");
+
+			while (NULL != pToken)
+			{
+				OBJ_CORNER corner;
+
+				if (!ParseCorner(pToken, positions.size(), texCoords.size(), normals.size(), corner))
+				{
+					std::cout << inputName << " line " << lineNumber << ": invalid face corner " << pToken << std::endl;
+					fclose(file);
+					return(false);
+				}
+
+				std::map<OBJ_CORNER, uint32_t>::iterator found = welded.find(corner);
+				if (found != welded.end())
+				{
+					face.push_back(found->second);
+				}
+				else
+				{
+					IMPORT_VERTEX vertex;
+
+					vertex.position = positions[corner.position];
+					vertex.texCoord = (corner.texCoord >= 0) ? texCoords[corner.texCoord] : glm::vec2(0.0f);
+					vertex.normal = (corner.normal >= 0) ? normals[corner.normal] : glm::vec3(0.0f);
+
+					welded[corner] = mesh.vertices.size();
+					face.push_back(mesh.vertices.size());
+					mesh.vertices.push_back(vertex);
+					hasNormal.push_back(corner.normal >= 0);
+				}
+
+				pToken = strtok(NULL, " \t\r\n");
+			}
+
+			// faces with more corners are split into a fan
+			for (size_t i = 2; i < face.size(); i++)
+			{
+				mesh.indices.push_back(face[0]);
+				mesh.indices.push_back(face[i - 1]);
+				mesh.indices.push_back(face[i]);
+			}
+		}
+	}
+	fclose(file);
+
+	if (mesh.indices.empty())
+	{
+		std::cout << inputName << " has no faces" << std::endl;
+		return(false);
+	}
+
+	// the vertices without a normal get the average of their faces
+	for (size_t i = 0; i < mesh.indices.size(); i += 3)
+	{
+		IMPORT_VERTEX* pCorners[3] =
+		{
+			&mesh.vertices[mesh.indices[i]],
+			&mesh.vertices[mesh.indices[i + 1]],
+			&mesh.vertices[mesh.indices[i + 2]]
+		};
+		glm::vec3 faceNormal = glm::cross(
+			pCorners[1]->position - pCorners[0]->position,
+			pCorners[2]->position - pCorners[0]->position);
+
+		for (int j = 0; j < 3; j++)
+		{
+			if (!hasNormal[mesh.indices[i + j]])
+			{
+				pCorners[j]->normal += faceNormal;
+			}
+		}
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  ScoreVertex()
+ *
+ *  This function is used for scoring how much drawing one
+ *  of the triangles of a vertex next is worth.  Vertices
+ *  near the front of the cache score high, and so do
+ *  vertices with few triangles left, so they are finished
+ *  before their triangles are stranded.
+ ***********************************************************/
+float ScoreVertex(const CACHE_VERTEX& vertex)
+{
+	float score = 0.0f;
+
+	if (vertex.remaining == 0)
+	{
+		return(-1.0f);
+	}
+
+	if (vertex.cachePosition >= 0)
+	{
+		// the last triangle's vertices score the same, so the
+		// order of its corners does not matter
+		if (vertex.cachePosition < 3)
+		{
+			score = 0.75f;
+		}
+		else
+		{
+			float scale = 1.0f / (g_VertexCacheSize - 3);
+			score = powf(1.0f - ((vertex.cachePosition - 3) * scale), 1.5f);
+		}
+	}
+
+	score += 2.0f / sqrtf((float)vertex.remaining);
+
+	return(score);
+}
+
+/***********************************************************
+ *  OptimizeVertexCache()
+ *
+ *  This function is used for reordering the triangles for
+ *  the post transform vertex cache.  The triangle with the
+ *  best score among those of the cached vertices is drawn
+ *  next, and the cache is simulated as it is drawn.  When
+ *  no cached vertex has triangles left, the next triangle is
+ *  the first one not drawn yet.
+ ***********************************************************/
+void OptimizeVertexCache(std::vector<uint32_t>& indices, int vertexCount)
+{
+	int triangleCount = indices.size() / 3;
+	std::vector<CACHE_VERTEX> vertices(vertexCount);
+	std::vector<int> adjacency(indices.size());
+	std::vector<float> triangleScores(triangleCount, 0.0f);
+	std::vector<bool> bDrawn(triangleCount, false);
+	std::vector<uint32_t> ordered;
+	std::vector<int> cache;
+	int nextUndrawn = 0;
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		vertices[i].cachePosition = -1;
+		vertices[i].remaining = 0;
+		vertices[i].firstTriangle = 0;
+		vertices[i].triangleCount = 0;
+	}
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		vertices[indices[i]].remaining++;
+	}
+
+	// the triangles of every vertex, one after the other
+	int first = 0;
+	for (int i = 0; i < vertexCount; i++)
+	{
+		vertices[i].firstTriangle = first;
+		first += vertices[i].remaining;
+	}
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		CACHE_VERTEX& vertex = vertices[indices[i]];
+		adjacency[vertex.firstTriangle + vertex.triangleCount] = i / 3;
+		vertex.triangleCount++;
+	}
+
+	for (int i = 0; i < vertexCount; i++)
+	{
+		vertices[i].score = ScoreVertex(vertices[i]);
+	}
+	for (int i = 0; i < triangleCount; i++)
+	{
+		triangleScores[i] = vertices[indices[i * 3]].score +
+			vertices[indices[i * 3 + 1]].score +
+			vertices[indices[i * 3 + 2]].score;
+	}
+
+	ordered.reserve(indices.size());
+	int bestTriangle = -1;
+
+	while (ordered.size() < indices.size())
+	{
+		if (bestTriangle < 0)
+		{
+			while (bDrawn[nextUndrawn])
+			{
+				nextUndrawn++;
+			}
+			bestTriangle = nextUndrawn;
+		}
+
+		// draw the triangle and move its vertices to the front
+		bDrawn[bestTriangle] = true;
+		for (int j = 0; j < 3; j++)
+		{
+			uint32_t index = indices[bestTriangle * 3 + j];
+			std::vector<int>::iterator found = std::find(cache.begin(), cache.end(), (int)index);
+
+			ordered.push_back(index);
+			vertices[index].remaining--;
+			if (found != cache.end())
+			{
+				cache.erase(found);
+			}
+			cache.insert(cache.begin(), index);
+		}
+
+		// rescore the cached vertices, and the pushed out ones
+		for (size_t j = 0; j < cache.size(); j++)
+		{
+			CACHE_VERTEX& vertex = vertices[cache[j]];
+			vertex.cachePosition = (j < g_VertexCacheSize) ? (int)j : -1;
+			vertex.score = ScoreVertex(vertex);
+		}
+
+		// the best triangle is looked for among the cached ones
+		float bestScore = -1.0f;
+		bestTriangle = -1;
+		for (size_t j = 0; j < cache.size(); j++)
+		{
+			const CACHE_VERTEX& vertex = vertices[cache[j]];
+
+			for (int k = 0; k < vertex.triangleCount; k++)
+			{
+				int triangle = adjacency[vertex.firstTriangle + k];
+
+				if (bDrawn[triangle])
+				{
+					continue;
+				}
+
+				triangleScores[triangle] = vertices[indices[triangle * 3]].score +
+					vertices[indices[triangle * 3 + 1]].score +
+					vertices[indices[triangle * 3 + 2]].score;
+				if (triangleScores[triangle] > bestScore)
+				{
+					bestScore = triangleScores[triangle];
+					bestTriangle = triangle;
+				}
+			}
+		}
+
+		if (cache.size() > g_VertexCacheSize)
+		{
+			cache.resize(g_VertexCacheSize);
+		}
+	}
+
+	indices = ordered;
+}
+
+/***********************************************************
+ *  MeasureCacheMisses()
+ *
+ *  This function is used for measuring the average number
+ *  of vertices transformed for each triangle, with a small
+ *  first in first out cache.  It is 3 for no reuse at all
+ *  and tends to 0.5 for an ideal order of a large grid.
+ ***********************************************************/
+float MeasureCacheMisses(const std::vector<uint32_t>& indices, int vertexCount)
+{
+	std::vector<int> cachedAt(vertexCount, -1);
+	int misses = 0;
+
+	for (size_t i = 0; i < indices.size(); i++)
+	{
+		if ((cachedAt[indices[i]] < 0) || (misses - cachedAt[indices[i]] >= g_MeasureCacheSize))
+		{
+			cachedAt[indices[i]] = misses;
+			misses++;
+		}
+	}
+
+	return((float)misses / (indices.size() / 3));
+}
+
+/***********************************************************
+ *  FinishMeshlet()
+ *
+ *  This function is used for computing the bounding sphere
+ *  and the normal cone of a meshlet from its triangles.
+ *  The cone cutoff is the sine of the widest angle between
+ *  a triangle and the axis, and 1 when the triangles face
+ *  too many ways for the meshlet to ever be culled.
+ ***********************************************************/
+void FinishMeshlet(const IMPORT_MESH& mesh, MESH_FILE_MESHLET& meshlet)
+{
+	glm::vec3 boundsMin(1e30f);
+	glm::vec3 boundsMax(-1e30f);
+	glm::vec3 axis(0.0f);
+	float radius = 0.0f;
+	float minimumDot = 1.0f;
+
+	for (uint32_t i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.indexCount; i++)
+	{
+		boundsMin = glm::min(boundsMin, mesh.vertices[mesh.indices[i]].position);
+		boundsMax = glm::max(boundsMax, mesh.vertices[mesh.indices[i]].position);
+	}
+	glm::vec3 center = (boundsMin + boundsMax) * 0.5f;
+
+	std::vector<glm::vec3> faceNormals;
+	for (uint32_t i = meshlet.firstIndex; i < meshlet.firstIndex + meshlet.indexCount; i += 3)
+	{
+		const glm::vec3& p0 = mesh.vertices[mesh.indices[i]].position;
+		const glm::vec3& p1 = mesh.vertices[mesh.indices[i + 1]].position;
+		const glm::vec3& p2 = mesh.vertices[mesh.indices[i + 2]].position;
+		glm::vec3 faceNormal = glm::cross(p1 - p0, p2 - p0);
+		float length = glm::length(faceNormal);
+
+		for (int j = 0; j < 3; j++)
+		{
+			radius = std::max(radius, glm::length(mesh.vertices[mesh.indices[i + j]].position - center));
+		}
+		if (length > 0.0f)
+		{
+			faceNormals.push_back(faceNormal / length);
+			axis += faceNormal / length;
+		}
+	}
+
+	float axisLength = glm::length(axis);
+	if (axisLength > 0.0f)
+	{
+		axis /= axisLength;
+		for (size_t i = 0; i < faceNormals.size(); i++)
+		{
+			minimumDot = std::min(minimumDot, glm::dot(axis, faceNormals[i]));
+		}
+	}
+	else
+	{
+		minimumDot = -1.0f;
+	}
+
+	meshlet.center[0] = center.x;
+	meshlet.center[1] = center.y;
+	meshlet.center[2] = center.z;
+	meshlet.radius = radius;
+	meshlet.coneAxis[0] = axis.x;
+	meshlet.coneAxis[1] = axis.y;
+	meshlet.coneAxis[2] = axis.z;
+	meshlet.coneCutoff = (minimumDot <= 0.0f) ? 1.0f : sqrtf(1.0f - (minimumDot * minimumDot));
+}
+
+/***********************************************************
+ *  BuildMeshlets()
+ *
+ *  This function is used for splitting the ordered
+ *  triangles into meshlets.  The triangles are taken in the
+ *  vertex cache order, which already keeps neighbors
+ *  together, and a new meshlet is started whenever the next
+ *  triangle would pass the vertex or triangle limit.
+ ***********************************************************/
+void BuildMeshlets(IMPORT_MESH& mesh)
+{
+	std::vector<int> usedBy(mesh.vertices.size(), -1);
+	MESH_FILE_MESHLET meshlet = {};
+	int meshletVertices = 0;
+
+	mesh.meshlets.clear();
+
+	for (uint32_t i = 0; i < mesh.indices.size(); i += 3)
+	{
+		int newVertices = 0;
+		for (int j = 0; j < 3; j++)
+		{
+			if (usedBy[mesh.indices[i + j]] != (int)mesh.meshlets.size())
+			{
+				newVertices++;
+			}
+		}
+
+		if ((meshlet.indexCount > 0) &&
+			((meshletVertices + newVertices > MeshFile::MAX_MESHLET_VERTICES) ||
+			(meshlet.indexCount / 3 >= MeshFile::MAX_MESHLET_TRIANGLES)))
+		{
+			FinishMeshlet(mesh, meshlet);
+			mesh.meshlets.push_back(meshlet);
+			meshlet.firstIndex = i;
+			meshlet.indexCount = 0;
+			meshletVertices = 0;
+		}
+
+		for (int j = 0; j < 3; j++)
+		{
+			if (usedBy[mesh.indices[i + j]] != (int)mesh.meshlets.size())
+			{
+				usedBy[mesh.indices[i + j]] = mesh.meshlets.size();
+				meshletVertices++;
+			}
+		}
+		meshlet.indexCount += 3;
+	}
+
+	FinishMeshlet(mesh, meshlet);
+	mesh.meshlets.push_back(meshlet);
+}
+
+/***********************************************************
+ *  SortMeshletsForOverdraw()
+ *
+ *  This function is used for moving the meshlets that face
+ *  out from the center of the model to the front of the
+ *  indices.  Drawn first, they fill the depth buffer before
+ *  the meshlets behind them, whose fragments then fail the
+ *  depth test instead of being shaded and overwritten.  The
+ *  order inside each meshlet keeps its vertex cache order.
+ ***********************************************************/
+void SortMeshletsForOverdraw(IMPORT_MESH& mesh)
+{
+	std::vector<std::pair<float, int> > order;
+	std::vector<MESH_FILE_MESHLET> meshlets;
+	std::vector<uint32_t> indices;
+	glm::vec3 modelCenter(0.0f);
+
+	for (size_t i = 0; i < mesh.meshlets.size(); i++)
+	{
+		modelCenter += glm::vec3(mesh.meshlets[i].center[0], mesh.meshlets[i].center[1], mesh.meshlets[i].center[2]);
+	}
+	modelCenter /= (float)mesh.meshlets.size();
+
+	for (size_t i = 0; i < mesh.meshlets.size(); i++)
+	{
+		const MESH_FILE_MESHLET& meshlet = mesh.meshlets[i];
+		glm::vec3 outward = glm::vec3(meshlet.center[0], meshlet.center[1], meshlet.center[2]) - modelCenter;
+		float length = glm::length(outward);
+		float facing = 0.0f;
+
+		if (length > 0.0f)
+		{
+			facing = glm::dot(outward / length, glm::vec3(meshlet.coneAxis[0], meshlet.coneAxis[1], meshlet.coneAxis[2]));
+		}
+		order.push_back(std::make_pair(-facing, (int)i));
+	}
+	std::stable_sort(order.begin(), order.end());
+
+	for (size_t i = 0; i < order.size(); i++)
+	{
+		MESH_FILE_MESHLET meshlet = mesh.meshlets[order[i].second];
+		uint32_t firstIndex = indices.size();
+
+		indices.insert(indices.end(),
+			mesh.indices.begin() + meshlet.firstIndex,
+			mesh.indices.begin() + meshlet.firstIndex + meshlet.indexCount);
+		meshlet.firstIndex = firstIndex;
+		meshlets.push_back(meshlet);
+	}
+
+	mesh.indices = indices;
+	mesh.meshlets = meshlets;
+}
+
+/***********************************************************
+ *  OptimizeVertexFetch()
+ *
+ *  This function is used for renumbering the vertices in
+ *  the order the final indices first use them, so the
+ *  vertices of neighboring triangles are neighbors in
+ *  memory too.  Vertices no triangle uses are dropped.
+ ***********************************************************/
+void OptimizeVertexFetch(IMPORT_MESH& mesh)
+{
+	std::vector<uint32_t> remap(mesh.vertices.size(), 0xFFFFFFFF);
+	std::vector<IMPORT_VERTEX> vertices;
+
+	for (size_t i = 0; i < mesh.indices.size(); i++)
+	{
+		uint32_t& index = mesh.indices[i];
+
+		if (remap[index] == 0xFFFFFFFF)
+		{
+			remap[index] = vertices.size();
+			vertices.push_back(mesh.vertices[index]);
+		}
+		index = remap[index];
+	}
+
+	mesh.vertices = vertices;
+}
+
+/***********************************************************
+ *  WriteSection()
+ *
+ *  This function is used for writing the records of one
+ *  section at the current end of the file, padded to four
+ *  bytes, and filling in where they are.
+ ***********************************************************/
+void WriteSection(FILE* file, const void* pRecords, size_t recordSize, size_t count, MESH_FILE_SECTION& section)
+{
+	const unsigned char padding[4] = { 0, 0, 0, 0 };
+	long offset = ftell(file);
+
+	section.offset = (uint32_t)offset;
+	section.count = (uint32_t)count;
+
+	if (count > 0)
+	{
+		fwrite(pRecords, recordSize, count, file);
+	}
+	if (((recordSize * count) % 4) != 0)
+	{
+		fwrite(padding, 1, 4 - ((recordSize * count) % 4), file);
+	}
+}
+
+/***********************************************************
+ *  CompileMesh()
+ *
+ *  This function is used for importing one OBJ model,
+ *  optimizing it and writing it into a mesh file.
+ ***********************************************************/
+bool CompileMesh(const std::string& inputName, const std::string& outputName)
+{
+	IMPORT_MESH mesh;
+	std::vector<MESH_FILE_VERTEX> quantized;
+	MESH_FILE_HEADER header = {};
+	glm::vec3 boundsMin(1e30f);
+	glm::vec3 boundsMax(-1e30f);
+	FILE* file = NULL;
+
+	if (!LoadObj(inputName, mesh))
+	{
+		std::cout << "Could not import model:" << inputName << std::endl;
+		return(false);
+	}
+
+	float missesBefore = MeasureCacheMisses(mesh.indices, mesh.vertices.size());
+	OptimizeVertexCache(mesh.indices, mesh.vertices.size());
+	float missesAfter = MeasureCacheMisses(mesh.indices, mesh.vertices.size());
+	BuildMeshlets(mesh);
+	SortMeshletsForOverdraw(mesh);
+	OptimizeVertexFetch(mesh);
+
+	quantized.reserve(mesh.vertices.size());
+	for (size_t i = 0; i < mesh.vertices.size(); i++)
+	{
+		const IMPORT_VERTEX& vertex = mesh.vertices[i];
+
+		quantized.push_back(MeshFile::QuantizeVertex(vertex.position, vertex.normal, vertex.texCoord));
+		boundsMin = glm::min(boundsMin, vertex.position);
+		boundsMax = glm::max(boundsMax, vertex.position);
+	}
+
+	file = fopen(outputName.c_str(), "wb");
+	if (NULL == file)
+	{
+		std::cout << "Could not write file:" << outputName << std::endl;
+		return(false);
+	}
+
+	// the header is written again once the sections are placed
+	fwrite(&header, sizeof(header), 1, file);
+	WriteSection(file, quantized.data(), sizeof(MESH_FILE_VERTEX), quantized.size(), header.vertices);
+	WriteSection(file, mesh.indices.data(), sizeof(uint32_t), mesh.indices.size(), header.indices);
+	WriteSection(file, mesh.meshlets.data(), sizeof(MESH_FILE_MESHLET), mesh.meshlets.size(), header.meshlets);
+
+	header.magic = MESH_FILE_MAGIC;
+	header.version = MESH_FILE_VERSION;
+	header.fileSize = (uint32_t)ftell(file);
+	for (int i = 0; i < 3; i++)
+	{
+		header.boundsMin[i] = boundsMin[i];
+		header.boundsMax[i] = boundsMax[i];
+	}
+	fseek(file, 0, SEEK_SET);
+	fwrite(&header, sizeof(header), 1, file);
+	fclose(file);
+
+	std::cout << "Wrote " << outputName << ", vertices:" << quantized.size()
+		<< ", triangles:" << mesh.indices.size() / 3 << ", meshlets:" << mesh.meshlets.size()
+		<< ", vertices per triangle:" << missesBefore << " -> " << missesAfter
+		<< ", bytes:" << header.fileSize << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function gets called after the tool has been
+ *  launched with the model to compile.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	std::string inputName;
+	std::string outputName;
+
+	if ((argc < 2) || (argc > 3))
+	{
+		std::cout << "Usage: " << argv[0] << " model.obj [model.mesh]" << std::endl;
+		return(1);
+	}
+
+	inputName = argv[1];
+	if (argc == 3)
+	{
+		outputName = argv[2];
+	}
+	else
+	{
+		outputName = inputName.substr(0, inputName.find_last_of('.')) + ".mesh";
+	}
+
+	return(CompileMesh(inputName, outputName) ? 0 : 1);
+}
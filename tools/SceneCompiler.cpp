@@ -0,0 +1,988 @@
+///////////////////////////////////////////////////////////////////////////////
+// scenecompiler.cpp
+// ============
+// command line tool - compile a JSON scene description into a scene file
+//
+//	Created for CS-330-Computational Graphics and Visualization
+//
+//  Usage: SceneCompiler scenes/kitchen.json [scenes/kitchen.scene]
+//
+//  The JSON file lists the textures, meshes, materials, lights and objects
+//  of the scene.  Every object names its mesh, its texture or color, its
+//  material and its group, along with a scale, rotations in degrees and a
+//  position:
+//
+//    { "group": "Plate", "mesh": "taperedCylinder",
+//      "scale": [7, 0.2, 7], "rotation": [0, 0, 0], "position": [0, 0.1, 0],
+//      "color": [0.9, 0.9, 0.9, 1], "material": "default" }
+//
+//  A mesh is one of the basic meshes, or the tag of a mesh file written by
+//  the MeshCompiler tool and listed with the meshes of the scene:
+//
+//    "meshes": [ { "tag": "teapot", "file": "models/teapot.mesh" } ]
+//
+//  An item with "children" instead of a mesh is a node.  Its scale, rotation
+//  and position place the children, which may be nodes again, and the
+//  children take its group unless they name their own:
+//
+//    { "group": "Bottle", "position": [6, 0.9, -1.8], "children": [
+//      { "mesh": "cylinder", "scale": [0.9, 4, 0.9], "position": [0, 0, 0],
+//        "color": [0.9, 0.9, 1, 0.2], "material": "glass" } ] }
+//
+//  The compiled file holds flat records with the names resolved to indices
+//  and the transformations combined into model matrices relative to their
+//  node, the same way as SceneManager::BuildModelMatrix(), so the
+//  application can map the file and build the scene without parsing
+//  anything.  The output name defaults
+//  to the input name with a .scene extension.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "SceneFile.h"
+
+// GLM Math Header inclusions
+#include <glm/glm.hpp>
+#include <glm/gtc/type_ptr.hpp>
+#include <glm/gtx/transform.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+// declaration of global variables and defines
+namespace
+{
+	// mesh names in the same order as SceneManager::MESH_TYPE
+	const char* g_MeshNames[] =
+	{
+		"plane",
+		"cone",
+		"cylinder",
+		"prism",
+		"torus",
+		"sphere",
+		"halfSphere",
+		"taperedCylinder",
+		"pyramid3"
+	};
+	const int g_MeshCount = sizeof(g_MeshNames) / sizeof(g_MeshNames[0]);
+
+	// the kinds of JSON values
+	enum JSON_TYPE
+	{
+		JSON_NULL,
+		JSON_BOOL,
+		JSON_NUMBER,
+		JSON_STRING,
+		JSON_ARRAY,
+		JSON_OBJECT
+	};
+
+	// one parsed JSON value, with its members when it is an
+	// object and its items when it is an array
+	struct JSON_VALUE
+	{
+		JSON_TYPE type;
+		bool boolean;
+		double number;
+		std::string text;
+		std::vector<JSON_VALUE> items;
+		std::vector<std::pair<std::string, JSON_VALUE>> members;
+	};
+
+	// the text being parsed and the line the parser is on
+	struct JSON_PARSER
+	{
+		const char* pText;
+		int line;
+		std::string error;
+	};
+
+	// the records and strings of the scene file being compiled
+	struct SCENE_OUTPUT
+	{
+		std::vector<SCENE_FILE_TEXTURE> textures;
+		std::vector<SCENE_FILE_MESH> meshes;
+		std::vector<SCENE_FILE_MATERIAL> materials;
+		std::vector<SCENE_FILE_LIGHT> lights;
+		std::vector<SCENE_FILE_GROUP> groups;
+		std::vector<SCENE_FILE_NODE> nodes;
+		std::vector<SCENE_FILE_OBJECT> objects;
+		std::vector<char> strings;
+		// indices of the tags and group names
+		std::map<std::string, int> textureIndices;
+		std::map<std::string, int> meshIndices;
+		std::map<std::string, int> materialIndices;
+		std::map<std::string, int> groupIndices;
+	};
+}
+
+bool ParseValue(JSON_PARSER& parser, JSON_VALUE& value);
+bool CompileObjectList(const JSON_VALUE& objects, int parentNode, const std::string& parentGroup, SCENE_OUTPUT& output);
+
+/***********************************************************
+ *  SkipWhitespace()
+ *
+ *  This function is used for moving the parser past spaces,
+ *  tabs and line breaks, counting the lines for the error
+ *  messages.
+ ***********************************************************/
+void SkipWhitespace(JSON_PARSER& parser)
+{
+	while ((*parser.pText == ' ') || (*parser.pText == '\t') ||
+		(*parser.pText == '\r') || (*parser.pText == '\n'))
+	{
+		if (*parser.pText == '\n')
+		{
+			parser.line++;
+		}
+		parser.pText++;
+	}
+}
+
+/***********************************************************
+ *  SetError()
+ *
+ *  This function is used for recording what went wrong and
+ *  on which line, the first error is kept.
+ ***********************************************************/
+bool SetError(JSON_PARSER& parser, const std::string& message)
+{
+	if (parser.error.empty())
+	{
+		parser.error = "line " + std::to_string(parser.line) + ": " + message;
+	}
+	return(false);
+}
+
+/***********************************************************
+ *  ParseString()
+ *
+ *  This function is used for parsing a quoted string.  The
+ *  common escapes are supported, unicode escapes are kept
+ *  as a question mark since no scene name needs them.
+ ***********************************************************/
+bool ParseString(JSON_PARSER& parser, std::string& text)
+{
+	if (*parser.pText != '"')
+	{
+		return(SetError(parser, "expected a string"));
+	}
+	parser.pText++;
+
+	while (*parser.pText != '"')
+	{
+		char c = *parser.pText++;
+
+		if ((c == '\0') || (c == '\n'))
+		{
+			return(SetError(parser, "unterminated string"));
+		}
+		if (c == '\\')
+		{
+			c = *parser.pText++;
+			switch (c)
+			{
+			case 'n':
+				c = '\n';
+				break;
+			case 't':
+				c = '\t';
+				break;
+			case 'r':
+				c = '\r';
+				break;
+			case 'b':
+				c = '\b';
+				break;
+			case 'f':
+				c = '\f';
+				break;
+			case 'u':
+				for (int i = 0; (i < 4) && (*parser.pText != '\0'); i++)
+				{
+					parser.pText++;
+				}
+				c = '?';
+				break;
+			case '"':
+			case '\\':
+			case '/':
+				break;
+			default:
+				return(SetError(parser, "unknown escape in string"));
+			}
+		}
+		text.push_back(c);
+	}
+	parser.pText++;
+
+	return(true);
+}
+
+/***********************************************************
+ *  ParseValue()
+ *
+ *  This function is used for parsing any JSON value, and
+ *  the members or items inside objects and arrays.
+ ***********************************************************/
+bool ParseValue(JSON_PARSER& parser, JSON_VALUE& value)
+{
+	value.type = JSON_NULL;
+	value.boolean = false;
+	value.number = 0.0;
+
+	SkipWhitespace(parser);
+
+	if (*parser.pText == '{')
+	{
+		value.type = JSON_OBJECT;
+		parser.pText++;
+		SkipWhitespace(parser);
+		if (*parser.pText == '}')
+		{
+			parser.pText++;
+			return(true);
+		}
+
+		while (true)
+		{
+			std::pair<std::string, JSON_VALUE> member;
+
+			SkipWhitespace(parser);
+			if (!ParseString(parser, member.first))
+			{
+				return(false);
+			}
+			SkipWhitespace(parser);
+			if (*parser.pText != ':')
+			{
+				return(SetError(parser, "expected ':' after \"" + member.first + "\""));
+			}
+			parser.pText++;
+			if (!ParseValue(parser, member.second))
+			{
+				return(false);
+			}
+			value.members.push_back(member);
+
+			SkipWhitespace(parser);
+			if (*parser.pText == ',')
+			{
+				parser.pText++;
+			}
+			else if (*parser.pText == '}')
+			{
+				parser.pText++;
+				return(true);
+			}
+			else
+			{
+				return(SetError(parser, "expected ',' or '}'"));
+			}
+		}
+	}
+
+	if (*parser.pText == '[')
+	{
+		value.type = JSON_ARRAY;
+		parser.pText++;
+		SkipWhitespace(parser);
+		if (*parser.pText == ']')
+		{
+			parser.pText++;
+			return(true);
+		}
+
+		while (true)
+		{
+			JSON_VALUE item;
+
+			if (!ParseValue(parser, item))
+			{
+				return(false);
+			}
+			value.items.push_back(item);
+
+			SkipWhitespace(parser);
+			if (*parser.pText == ',')
+			{
+				parser.pText++;
+			}
+			else if (*parser.pText == ']')
+			{
+				parser.pText++;
+				return(true);
+			}
+			else
+			{
+				return(SetError(parser, "expected ',' or ']'"));
+			}
+		}
+	}
+
+	if (*parser.pText == '"')
+	{
+		value.type = JSON_STRING;
+		return(ParseString(parser, value.text));
+	}
+
+	if (strncmp(parser.pText, "true", 4) == 0)
+	{
+		value.type = JSON_BOOL;
+		value.boolean = true;
+		parser.pText += 4;
+		return(true);
+	}
+	if (strncmp(parser.pText, "false", 5) == 0)
+	{
+		value.type = JSON_BOOL;
+		parser.pText += 5;
+		return(true);
+	}
+	if (strncmp(parser.pText, "null", 4) == 0)
+	{
+		parser.pText += 4;
+		return(true);
+	}
+
+	char* pEnd = NULL;
+	value.number = strtod(parser.pText, &pEnd);
+	if (pEnd == parser.pText)
+	{
+		return(SetError(parser, "unexpected character"));
+	}
+	value.type = JSON_NUMBER;
+	parser.pText = pEnd;
+
+	return(true);
+}
+
+/***********************************************************
+ *  FindMember()
+ *
+ *  This function is used for finding a member of a JSON
+ *  object by name, NULL is returned when it is missing.
+ ***********************************************************/
+const JSON_VALUE* FindMember(const JSON_VALUE& object, const char* name)
+{
+	for (int i = 0; i < object.members.size(); i++)
+	{
+		if (object.members[i].first == name)
+		{
+			return(&object.members[i].second);
+		}
+	}
+	return(NULL);
+}
+
+/***********************************************************
+ *  ReadNumbers()
+ *
+ *  This function is used for reading an array member of
+ *  numbers into a float array.  The default values are kept
+ *  when the member is missing, and false is returned when
+ *  it is not an array of the expected length.
+ ***********************************************************/
+bool ReadNumbers(const JSON_VALUE& object, const char* name, float* values, int count)
+{
+	const JSON_VALUE* pMember = FindMember(object, name);
+
+	if (NULL == pMember)
+	{
+		return(true);
+	}
+	if ((pMember->type != JSON_ARRAY) || (pMember->items.size() != count))
+	{
+		std::cout << "\"" << name << "\" needs " << count << " numbers" << std::endl;
+		return(false);
+	}
+
+	for (int i = 0; i < count; i++)
+	{
+		if (pMember->items[i].type != JSON_NUMBER)
+		{
+			std::cout << "\"" << name << "\" needs " << count << " numbers" << std::endl;
+			return(false);
+		}
+		values[i] = (float)pMember->items[i].number;
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  ReadString()
+ *
+ *  This function is used for reading a string member, the
+ *  default is returned when the member is missing.
+ ***********************************************************/
+std::string ReadString(const JSON_VALUE& object, const char* name, const char* defaultValue)
+{
+	const JSON_VALUE* pMember = FindMember(object, name);
+
+	if ((NULL == pMember) || (pMember->type != JSON_STRING))
+	{
+		return(defaultValue);
+	}
+	return(pMember->text);
+}
+
+/***********************************************************
+ *  AddString()
+ *
+ *  This function is used for adding a string to the strings
+ *  section and getting its offset.
+ ***********************************************************/
+uint32_t AddString(SCENE_OUTPUT& output, const std::string& text)
+{
+	uint32_t offset = output.strings.size();
+
+	output.strings.insert(output.strings.end(), text.begin(), text.end());
+	output.strings.push_back('\0');
+
+	return(offset);
+}
+
+/***********************************************************
+ *  CompileTextures()
+ *
+ *  This function is used for compiling the texture list,
+ *  each texture has a file and a tag.
+ ***********************************************************/
+bool CompileTextures(const JSON_VALUE& scene, SCENE_OUTPUT& output)
+{
+	const JSON_VALUE* pTextures = FindMember(scene, "textures");
+
+	if (NULL == pTextures)
+	{
+		return(true);
+	}
+
+	for (int i = 0; i < pTextures->items.size(); i++)
+	{
+		const JSON_VALUE& texture = pTextures->items[i];
+		std::string tag = ReadString(texture, "tag", "");
+		std::string file = ReadString(texture, "file", "");
+		SCENE_FILE_TEXTURE record;
+
+		if (tag.empty() || file.empty())
+		{
+			std::cout << "Texture " << i << " needs a \"tag\" and a \"file\"" << std::endl;
+			return(false);
+		}
+		if (output.textureIndices.count(tag) > 0)
+		{
+			std::cout << "Texture tag defined more than once:" << tag << std::endl;
+			return(false);
+		}
+
+		record.file = AddString(output, file);
+		record.tag = AddString(output, tag);
+		output.textureIndices[tag] = output.textures.size();
+		output.textures.push_back(record);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CompileMeshes()
+ *
+ *  This function is used for compiling the imported mesh
+ *  list, each mesh has a file and a tag.  The tags can not
+ *  hide the names of the basic meshes.
+ ***********************************************************/
+bool CompileMeshes(const JSON_VALUE& scene, SCENE_OUTPUT& output)
+{
+	const JSON_VALUE* pMeshes = FindMember(scene, "meshes");
+
+	if (NULL == pMeshes)
+	{
+		return(true);
+	}
+
+	for (int i = 0; i < pMeshes->items.size(); i++)
+	{
+		const JSON_VALUE& mesh = pMeshes->items[i];
+		std::string tag = ReadString(mesh, "tag", "");
+		std::string file = ReadString(mesh, "file", "");
+		SCENE_FILE_MESH record;
+
+		if (tag.empty() || file.empty())
+		{
+			std::cout << "Mesh " << i << " needs a \"tag\" and a \"file\"" << std::endl;
+			return(false);
+		}
+		for (int j = 0; j < g_MeshCount; j++)
+		{
+			if (tag == g_MeshNames[j])
+			{
+				std::cout << "Mesh tag is the name of a basic mesh:" << tag << std::endl;
+				return(false);
+			}
+		}
+		if (output.meshIndices.count(tag) > 0)
+		{
+			std::cout << "Mesh tag defined more than once:" << tag << std::endl;
+			return(false);
+		}
+
+		record.file = AddString(output, file);
+		record.tag = AddString(output, tag);
+		output.meshIndices[tag] = output.meshes.size();
+		output.meshes.push_back(record);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CompileMaterials()
+ *
+ *  This function is used for compiling the material list.
+ ***********************************************************/
+bool CompileMaterials(const JSON_VALUE& scene, SCENE_OUTPUT& output)
+{
+	const JSON_VALUE* pMaterials = FindMember(scene, "materials");
+
+	if (NULL == pMaterials)
+	{
+		return(true);
+	}
+
+	for (int i = 0; i < pMaterials->items.size(); i++)
+	{
+		const JSON_VALUE& material = pMaterials->items[i];
+		std::string tag = ReadString(material, "tag", "");
+		SCENE_FILE_MATERIAL record = {};
+		float shininess[1] = { 32.0f };
+
+		if (tag.empty())
+		{
+			std::cout << "Material " << i << " needs a \"tag\"" << std::endl;
+			return(false);
+		}
+		if (output.materialIndices.count(tag) > 0)
+		{
+			std::cout << "Material tag defined more than once:" << tag << std::endl;
+			return(false);
+		}
+
+		record.diffuseColor[0] = record.diffuseColor[1] = record.diffuseColor[2] = 1.0f;
+		if ((!ReadNumbers(material, "diffuse", record.diffuseColor, 3)) ||
+			(!ReadNumbers(material, "specular", record.specularColor, 3)))
+		{
+			return(false);
+		}
+
+		const JSON_VALUE* pShininess = FindMember(material, "shininess");
+		if ((NULL != pShininess) && (pShininess->type == JSON_NUMBER))
+		{
+			shininess[0] = (float)pShininess->number;
+		}
+		record.shininess = shininess[0];
+		record.tag = AddString(output, tag);
+
+		output.materialIndices[tag] = output.materials.size();
+		output.materials.push_back(record);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CompileLights()
+ *
+ *  This function is used for compiling the light list, each
+ *  light has a type of directional, point or spot.
+ ***********************************************************/
+bool CompileLights(const JSON_VALUE& scene, SCENE_OUTPUT& output)
+{
+	const JSON_VALUE* pLights = FindMember(scene, "lights");
+
+	if (NULL == pLights)
+	{
+		return(true);
+	}
+
+	for (int i = 0; i < pLights->items.size(); i++)
+	{
+		const JSON_VALUE& light = pLights->items[i];
+		std::string type = ReadString(light, "type", "");
+		SCENE_FILE_LIGHT record = {};
+
+		if (type == "directional")
+		{
+			record.type = SCENE_LIGHT_DIRECTIONAL;
+		}
+		else if (type == "point")
+		{
+			record.type = SCENE_LIGHT_POINT;
+		}
+		else if (type == "spot")
+		{
+			record.type = SCENE_LIGHT_SPOT;
+		}
+		else
+		{
+			std::cout << "Light " << i << " has an unknown type:" << type << std::endl;
+			return(false);
+		}
+
+		// positions are points and directions are vectors
+		record.position[3] = 1.0f;
+		if ((!ReadNumbers(light, "position", record.position, 3)) ||
+			(!ReadNumbers(light, "direction", record.direction, 3)) ||
+			(!ReadNumbers(light, "ambient", record.ambient, 3)) ||
+			(!ReadNumbers(light, "diffuse", record.diffuse, 3)) ||
+			(!ReadNumbers(light, "specular", record.specular, 3)) ||
+			(!ReadNumbers(light, "cutOff", &record.cutOff, 1)) ||
+			(!ReadNumbers(light, "outerCutOff", &record.outerCutOff, 1)) ||
+			(!ReadNumbers(light, "range", &record.range, 1)))
+		{
+			return(false);
+		}
+
+		output.lights.push_back(record);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  ComposeModel()
+ *
+ *  This function is used for combining the scale, the
+ *  rotations and the position of an object or a node into
+ *  one matrix, the same way as SceneManager::BuildModelMatrix().
+ ***********************************************************/
+glm::mat4 ComposeModel(const float scale[3], const float rotation[3], const float position[3])
+{
+	return(
+		glm::translate(glm::vec3(position[0], position[1], position[2])) *
+		glm::rotate(glm::radians(rotation[2]), glm::vec3(0.0f, 0.0f, 1.0f)) *
+		glm::rotate(glm::radians(rotation[1]), glm::vec3(0.0f, 1.0f, 0.0f)) *
+		glm::rotate(glm::radians(rotation[0]), glm::vec3(1.0f, 0.0f, 0.0f)) *
+		glm::scale(glm::vec3(scale[0], scale[1], scale[2])));
+}
+
+/***********************************************************
+ *  CompileNode()
+ *
+ *  This function is used for compiling a node of the object
+ *  list, which has a scale, rotations and a position like an
+ *  object but no mesh, and a list of children that are
+ *  placed relative to it.  The children are in the group of
+ *  the node unless they name their own.
+ ***********************************************************/
+bool CompileNode(const JSON_VALUE& node, int parentNode, const std::string& parentGroup, SCENE_OUTPUT& output)
+{
+	float scale[3] = { 1.0f, 1.0f, 1.0f };
+	float rotation[3] = { 0.0f, 0.0f, 0.0f };
+	float position[3] = { 0.0f, 0.0f, 0.0f };
+	SCENE_FILE_NODE record = {};
+	const JSON_VALUE* pChildren = FindMember(node, "children");
+
+	if (pChildren->type != JSON_ARRAY)
+	{
+		std::cout << "The children of node " << output.nodes.size() << " are not an array" << std::endl;
+		return(false);
+	}
+	if ((!ReadNumbers(node, "scale", scale, 3)) ||
+		(!ReadNumbers(node, "rotation", rotation, 3)) ||
+		(!ReadNumbers(node, "position", position, 3)))
+	{
+		std::cout << "in node " << output.nodes.size() << std::endl;
+		return(false);
+	}
+
+	record.parent = parentNode;
+	glm::mat4 local = ComposeModel(scale, rotation, position);
+	memcpy(record.local, glm::value_ptr(local), sizeof(record.local));
+
+	int nodeIndex = output.nodes.size();
+	output.nodes.push_back(record);
+
+	return(CompileObjectList(*pChildren, nodeIndex, ReadString(node, "group", parentGroup.c_str()), output));
+}
+
+/***********************************************************
+ *  CompileObjectList()
+ *
+ *  This function is used for compiling a list of objects
+ *  and nodes placed relative to the passed in node, or to
+ *  the world for -1.  The names of the meshes, textures,
+ *  materials and groups are resolved to indices, and the
+ *  scale, the rotations and the position are combined into
+ *  the model matrix, relative to the node.
+ ***********************************************************/
+bool CompileObjectList(const JSON_VALUE& objects, int parentNode, const std::string& parentGroup, SCENE_OUTPUT& output)
+{
+	for (int i = 0; i < objects.items.size(); i++)
+	{
+		const JSON_VALUE& object = objects.items[i];
+
+		// an item with children is a node, not an object
+		if (NULL != FindMember(object, "children"))
+		{
+			if (!CompileNode(object, parentNode, parentGroup, output))
+			{
+				return(false);
+			}
+			continue;
+		}
+
+		std::string mesh = ReadString(object, "mesh", "");
+		std::string texture = ReadString(object, "texture", "");
+		std::string material = ReadString(object, "material", "");
+		std::string group = ReadString(object, "group", parentGroup.c_str());
+		float scale[3] = { 1.0f, 1.0f, 1.0f };
+		float rotation[3] = { 0.0f, 0.0f, 0.0f };
+		float position[3] = { 0.0f, 0.0f, 0.0f };
+		SCENE_FILE_OBJECT record = {};
+		int objectNumber = output.objects.size();
+
+		record.mesh = g_MeshCount;
+		record.meshFile = -1;
+		for (int j = 0; j < g_MeshCount; j++)
+		{
+			if (mesh == g_MeshNames[j])
+			{
+				record.mesh = j;
+			}
+		}
+		if ((record.mesh == g_MeshCount) && (output.meshIndices.count(mesh) > 0))
+		{
+			record.mesh = 0;
+			record.meshFile = output.meshIndices[mesh];
+		}
+		if (record.mesh == g_MeshCount)
+		{
+			std::cout << "Object " << objectNumber << " has an unknown mesh:" << mesh << std::endl;
+			return(false);
+		}
+
+		record.color[0] = record.color[1] = record.color[2] = record.color[3] = 1.0f;
+		record.uvScale[0] = record.uvScale[1] = 1.0f;
+		if ((!ReadNumbers(object, "scale", scale, 3)) ||
+			(!ReadNumbers(object, "rotation", rotation, 3)) ||
+			(!ReadNumbers(object, "position", position, 3)) ||
+			(!ReadNumbers(object, "color", record.color, 4)) ||
+			(!ReadNumbers(object, "uvScale", record.uvScale, 2)))
+		{
+			std::cout << "in object " << objectNumber << std::endl;
+			return(false);
+		}
+
+		record.texture = -1;
+		if (!texture.empty())
+		{
+			if (output.textureIndices.count(texture) == 0)
+			{
+				std::cout << "Object " << objectNumber << " uses an unknown texture:" << texture << std::endl;
+				return(false);
+			}
+			record.texture = output.textureIndices[texture];
+		}
+
+		// an unknown material keeps the current one, the same as
+		// when the scene is built in code
+		record.material = -1;
+		if (!material.empty())
+		{
+			if (output.materialIndices.count(material) == 0)
+			{
+				std::cout << "Object " << objectNumber << " uses an unknown material:" << material << std::endl;
+			}
+			else
+			{
+				record.material = output.materialIndices[material];
+			}
+		}
+
+		if (output.groupIndices.count(group) == 0)
+		{
+			SCENE_FILE_GROUP groupRecord;
+			groupRecord.name = AddString(output, group);
+			output.groupIndices[group] = output.groups.size();
+			output.groups.push_back(groupRecord);
+		}
+		record.group = output.groupIndices[group];
+
+		record.node = parentNode;
+		glm::mat4 model = ComposeModel(scale, rotation, position);
+		memcpy(record.model, glm::value_ptr(model), sizeof(record.model));
+
+		output.objects.push_back(record);
+	}
+
+	return(true);
+}
+
+/***********************************************************
+ *  CompileObjects()
+ *
+ *  This function is used for compiling the object list of
+ *  the scene, with its nodes.
+ ***********************************************************/
+bool CompileObjects(const JSON_VALUE& scene, SCENE_OUTPUT& output)
+{
+	const JSON_VALUE* pObjects = FindMember(scene, "objects");
+
+	if (NULL == pObjects)
+	{
+		return(true);
+	}
+
+	return(CompileObjectList(*pObjects, -1, "Scene", output));
+}
+
+/***********************************************************
+ *  WriteSection()
+ *
+ *  This function is used for writing the records of one
+ *  section at the current end of the file, padded to four
+ *  bytes, and filling in where they are.
+ ***********************************************************/
+void WriteSection(FILE* file, const void* pRecords, size_t recordSize, size_t count, SCENE_FILE_SECTION& section)
+{
+	const unsigned char padding[4] = { 0, 0, 0, 0 };
+	long offset = ftell(file);
+
+	section.offset = (uint32_t)offset;
+	section.count = (uint32_t)count;
+
+	if (count > 0)
+	{
+		fwrite(pRecords, recordSize, count, file);
+	}
+	if (((recordSize * count) % 4) != 0)
+	{
+		fwrite(padding, 1, 4 - ((recordSize * count) % 4), file);
+	}
+}
+
+/***********************************************************
+ *  CompileScene()
+ *
+ *  This function is used for compiling one JSON scene file
+ *  into a scene file.
+ ***********************************************************/
+bool CompileScene(const std::string& inputName, const std::string& outputName)
+{
+	FILE* file = fopen(inputName.c_str(), "rb");
+	std::string text;
+	JSON_VALUE scene;
+	JSON_PARSER parser;
+	SCENE_OUTPUT output;
+	SCENE_FILE_HEADER header = {};
+	char buffer[4096];
+	size_t bytes = 0;
+
+	if (NULL == file)
+	{
+		std::cout << "Could not open scene description:" << inputName << std::endl;
+		return(false);
+	}
+	while ((bytes = fread(buffer, 1, sizeof(buffer), file)) > 0)
+	{
+		text.append(buffer, bytes);
+	}
+	fclose(file);
+
+	parser.pText = text.c_str();
+	parser.line = 1;
+	if (!ParseValue(parser, scene))
+	{
+		std::cout << inputName << " " << parser.error << std::endl;
+		return(false);
+	}
+	if (scene.type != JSON_OBJECT)
+	{
+		std::cout << inputName << " has to hold one JSON object" << std::endl;
+		return(false);
+	}
+
+	if ((!CompileTextures(scene, output)) ||
+		(!CompileMeshes(scene, output)) ||
+		(!CompileMaterials(scene, output)) ||
+		(!CompileLights(scene, output)) ||
+		(!CompileObjects(scene, output)))
+	{
+		std::cout << "Could not compile scene description:" << inputName << std::endl;
+		return(false);
+	}
+
+	// the strings section always ends a string
+	if (output.strings.empty())
+	{
+		output.strings.push_back('\0');
+	}
+
+	file = fopen(outputName.c_str(), "wb");
+	if (NULL == file)
+	{
+		std::cout << "Could not write file:" << outputName << std::endl;
+		return(false);
+	}
+
+	// the header is written again once the sections are placed
+	fwrite(&header, sizeof(header), 1, file);
+	WriteSection(file, output.textures.data(), sizeof(SCENE_FILE_TEXTURE), output.textures.size(), header.textures);
+	WriteSection(file, output.meshes.data(), sizeof(SCENE_FILE_MESH), output.meshes.size(), header.meshes);
+	WriteSection(file, output.materials.data(), sizeof(SCENE_FILE_MATERIAL), output.materials.size(), header.materials);
+	WriteSection(file, output.lights.data(), sizeof(SCENE_FILE_LIGHT), output.lights.size(), header.lights);
+	WriteSection(file, output.groups.data(), sizeof(SCENE_FILE_GROUP), output.groups.size(), header.groups);
+	WriteSection(file, output.nodes.data(), sizeof(SCENE_FILE_NODE), output.nodes.size(), header.nodes);
+	WriteSection(file, output.objects.data(), sizeof(SCENE_FILE_OBJECT), output.objects.size(), header.objects);
+	WriteSection(file, output.strings.data(), 1, output.strings.size(), header.strings);
+
+	header.magic = SCENE_FILE_MAGIC;
+	header.version = SCENE_FILE_VERSION;
+	header.fileSize = (uint32_t)ftell(file);
+	fseek(file, 0, SEEK_SET);
+	fwrite(&header, sizeof(header), 1, file);
+	fclose(file);
+
+	std::cout << "Wrote " << outputName << ", textures:" << output.textures.size()
+		<< ", meshes:" << output.meshes.size() << ", materials:" << output.materials.size() << ", lights:" << output.lights.size()
+		<< ", groups:" << output.groups.size() << ", nodes:" << output.nodes.size()
+		<< ", objects:" << output.objects.size()
+		<< ", bytes:" << header.fileSize << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function gets called after the tool has been
+ *  launched with the scene description to compile.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	std::string inputName;
+	std::string outputName;
+
+	if ((argc < 2) || (argc > 3))
+	{
+		std::cout << "Usage: " << argv[0] << " scene.json [scene.scene]" << std::endl;
+		return(1);
+	}
+
+	inputName = argv[1];
+	if (argc == 3)
+	{
+		outputName = argv[2];
+	}
+	else
+	{
+		outputName = inputName.substr(0, inputName.find_last_of('.')) + ".scene";
+	}
+
+	return(CompileScene(inputName, outputName) ? 0 : 1);
+}
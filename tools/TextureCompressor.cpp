@@ -0,0 +1,444 @@
+///////////////////////////////////////////////////////////////////////////////
+// texturecompressor.cpp
+// ============
+// command line tool - convert texture images into block compressed DDS files
+//
+//	Created for CS-330-Computational Graphics and Visualization
+//
+//  Usage: TextureCompressor [--bc1 | --bc3] textures/marble.png ...
+//
+//  Every input image is written next to itself as a .dds file with a full
+//  chain of mipmaps.  Images with an alpha channel are written as BC3 (DXT5)
+//  and all others as BC1 (DXT1), unless a format is forced.  The images
+//  are flipped vertically, the same as when the application loads them, so
+//  the application can upload the compressed blocks without converting them.
+///////////////////////////////////////////////////////////////////////////////
+
+#define STB_IMAGE_IMPLEMENTATION
+#include "stb_image.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// declaration of global variables and defines
+namespace
+{
+	// DDS header flags and four character codes
+	const uint32_t g_DDSMagic = 0x20534444;          // "DDS "
+	const uint32_t g_FourCCDXT1 = 0x31545844;        // "DXT1"
+	const uint32_t g_FourCCDXT5 = 0x35545844;        // "DXT5"
+	const uint32_t g_DDSHeaderFlags = 0x1 | 0x2 | 0x4 | 0x1000 | 0x20000 | 0x80000;
+	const uint32_t g_DDSPixelFormatFourCC = 0x4;
+	const uint32_t g_DDSCaps = 0x1000 | 0x8 | 0x400000;
+
+	// the block compressed formats that can be written
+	enum BLOCK_FORMAT
+	{
+		FORMAT_AUTO,
+		FORMAT_BC1,
+		FORMAT_BC3
+	};
+
+	// one mipmap level of RGBA pixels
+	struct IMAGE_LEVEL
+	{
+		int width;
+		int height;
+		std::vector<unsigned char> pixels;
+	};
+}
+
+/***********************************************************
+ *  PackColor565()
+ *
+ *  This function is used for packing an RGB color into the
+ *  16 bit endpoint format of a BC1 block.
+ ***********************************************************/
+uint16_t PackColor565(const int color[3])
+{
+	return((uint16_t)(((color[0] * 31 + 127) / 255) << 11) |
+		(uint16_t)(((color[1] * 63 + 127) / 255) << 5) |
+		(uint16_t)((color[2] * 31 + 127) / 255));
+}
+
+/***********************************************************
+ *  UnpackColor565()
+ *
+ *  This function is used for expanding a 16 bit endpoint
+ *  back to an 8 bit per channel RGB color.
+ ***********************************************************/
+void UnpackColor565(uint16_t packed, int color[3])
+{
+	color[0] = ((packed >> 11) & 31) * 255 / 31;
+	color[1] = ((packed >> 5) & 63) * 255 / 63;
+	color[2] = (packed & 31) * 255 / 31;
+}
+
+/***********************************************************
+ *  EncodeColorBlock()
+ *
+ *  This function is used for encoding the colors of a 4x4
+ *  block of RGBA pixels into an 8 byte BC1 block.  The
+ *  endpoints are the corners of the colors' bounding box,
+ *  inset slightly, and each pixel picks the closest of the
+ *  four palette colors.
+ ***********************************************************/
+void EncodeColorBlock(const unsigned char block[64], unsigned char output[8])
+{
+	int minColor[3] = { 255, 255, 255 };
+	int maxColor[3] = { 0, 0, 0 };
+
+	for (int i = 0; i < 16; i++)
+	{
+		for (int c = 0; c < 3; c++)
+		{
+			minColor[c] = std::min(minColor[c], (int)block[i * 4 + c]);
+			maxColor[c] = std::max(maxColor[c], (int)block[i * 4 + c]);
+		}
+	}
+
+	// inset the bounding box to reduce the error of the endpoints
+	for (int c = 0; c < 3; c++)
+	{
+		int inset = (maxColor[c] - minColor[c]) / 16;
+		minColor[c] = std::min(minColor[c] + inset, 255);
+		maxColor[c] = std::max(maxColor[c] - inset, 0);
+	}
+
+	uint16_t color0 = PackColor565(maxColor);
+	uint16_t color1 = PackColor565(minColor);
+
+	// the first endpoint must be larger to select the four color mode
+	if (color0 < color1)
+	{
+		std::swap(color0, color1);
+	}
+
+	int palette[4][3];
+	UnpackColor565(color0, palette[0]);
+	UnpackColor565(color1, palette[1]);
+	for (int c = 0; c < 3; c++)
+	{
+		palette[2][c] = (2 * palette[0][c] + palette[1][c]) / 3;
+		palette[3][c] = (palette[0][c] + 2 * palette[1][c]) / 3;
+	}
+
+	uint32_t indices = 0;
+	if (color0 != color1)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			int bestIndex = 0;
+			int bestDistance = 0x7FFFFFFF;
+
+			for (int p = 0; p < 4; p++)
+			{
+				int distance = 0;
+				for (int c = 0; c < 3; c++)
+				{
+					int delta = (int)block[i * 4 + c] - palette[p][c];
+					distance += delta * delta;
+				}
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = p;
+				}
+			}
+
+			indices |= (uint32_t)bestIndex << (i * 2);
+		}
+	}
+
+	output[0] = color0 & 0xFF;
+	output[1] = color0 >> 8;
+	output[2] = color1 & 0xFF;
+	output[3] = color1 >> 8;
+	memcpy(&output[4], &indices, 4);
+}
+
+/***********************************************************
+ *  EncodeAlphaBlock()
+ *
+ *  This function is used for encoding the alpha values of a
+ *  4x4 block of RGBA pixels into the 8 byte alpha block of
+ *  a BC3 block, using the eight value interpolation mode.
+ ***********************************************************/
+void EncodeAlphaBlock(const unsigned char block[64], unsigned char output[8])
+{
+	int minAlpha = 255;
+	int maxAlpha = 0;
+
+	for (int i = 0; i < 16; i++)
+	{
+		minAlpha = std::min(minAlpha, (int)block[i * 4 + 3]);
+		maxAlpha = std::max(maxAlpha, (int)block[i * 4 + 3]);
+	}
+
+	// palette index 0 and 1 are the endpoints, 2 to 7 are interpolated
+	int palette[8];
+	palette[0] = maxAlpha;
+	palette[1] = minAlpha;
+	for (int p = 1; p < 7; p++)
+	{
+		palette[p + 1] = ((7 - p) * maxAlpha + p * minAlpha) / 7;
+	}
+
+	uint64_t indices = 0;
+	if (maxAlpha != minAlpha)
+	{
+		for (int i = 0; i < 16; i++)
+		{
+			int bestIndex = 0;
+			int bestDistance = 256;
+
+			for (int p = 0; p < 8; p++)
+			{
+				int distance = std::abs((int)block[i * 4 + 3] - palette[p]);
+				if (distance < bestDistance)
+				{
+					bestDistance = distance;
+					bestIndex = p;
+				}
+			}
+
+			indices |= (uint64_t)bestIndex << (i * 3);
+		}
+	}
+
+	output[0] = (unsigned char)maxAlpha;
+	output[1] = (unsigned char)minAlpha;
+	for (int i = 0; i < 6; i++)
+	{
+		output[2 + i] = (unsigned char)((indices >> (i * 8)) & 0xFF);
+	}
+}
+
+/***********************************************************
+ *  CompressLevel()
+ *
+ *  This function is used for compressing one mipmap level
+ *  into BC1 or BC3 blocks.  Pixels past the right and top
+ *  edges repeat the edge pixels.
+ ***********************************************************/
+void CompressLevel(const IMAGE_LEVEL& level, BLOCK_FORMAT format, std::vector<unsigned char>& output)
+{
+	int blocksWide = std::max((level.width + 3) / 4, 1);
+	int blocksHigh = std::max((level.height + 3) / 4, 1);
+
+	for (int by = 0; by < blocksHigh; by++)
+	{
+		for (int bx = 0; bx < blocksWide; bx++)
+		{
+			unsigned char block[64];
+			unsigned char encoded[16];
+
+			for (int y = 0; y < 4; y++)
+			{
+				for (int x = 0; x < 4; x++)
+				{
+					int px = std::min(bx * 4 + x, level.width - 1);
+					int py = std::min(by * 4 + y, level.height - 1);
+					memcpy(&block[(y * 4 + x) * 4], &level.pixels[(py * level.width + px) * 4], 4);
+				}
+			}
+
+			if (format == FORMAT_BC3)
+			{
+				EncodeAlphaBlock(block, encoded);
+				EncodeColorBlock(block, encoded + 8);
+				output.insert(output.end(), encoded, encoded + 16);
+			}
+			else
+			{
+				EncodeColorBlock(block, encoded);
+				output.insert(output.end(), encoded, encoded + 8);
+			}
+		}
+	}
+}
+
+/***********************************************************
+ *  DownsampleLevel()
+ *
+ *  This function is used for building the next mipmap level
+ *  by averaging each 2x2 group of pixels.
+ ***********************************************************/
+IMAGE_LEVEL DownsampleLevel(const IMAGE_LEVEL& level)
+{
+	IMAGE_LEVEL next;
+
+	next.width = std::max(level.width / 2, 1);
+	next.height = std::max(level.height / 2, 1);
+	next.pixels.resize((size_t)next.width * next.height * 4);
+
+	for (int y = 0; y < next.height; y++)
+	{
+		for (int x = 0; x < next.width; x++)
+		{
+			int x0 = std::min(x * 2, level.width - 1);
+			int x1 = std::min(x * 2 + 1, level.width - 1);
+			int y0 = std::min(y * 2, level.height - 1);
+			int y1 = std::min(y * 2 + 1, level.height - 1);
+
+			for (int c = 0; c < 4; c++)
+			{
+				int sum = level.pixels[(y0 * level.width + x0) * 4 + c] +
+					level.pixels[(y0 * level.width + x1) * 4 + c] +
+					level.pixels[(y1 * level.width + x0) * 4 + c] +
+					level.pixels[(y1 * level.width + x1) * 4 + c];
+				next.pixels[(y * next.width + x) * 4 + c] = (unsigned char)((sum + 2) / 4);
+			}
+		}
+	}
+
+	return(next);
+}
+
+/***********************************************************
+ *  WriteValue()
+ *
+ *  This function is used for writing a 32 bit little endian
+ *  value into the output file.
+ ***********************************************************/
+void WriteValue(FILE* file, uint32_t value)
+{
+	fwrite(&value, sizeof(value), 1, file);
+}
+
+/***********************************************************
+ *  CompressImage()
+ *
+ *  This function is used for converting one image file into
+ *  a DDS file with a full chain of compressed mipmaps.
+ ***********************************************************/
+bool CompressImage(const std::string& filename, BLOCK_FORMAT format)
+{
+	int width = 0;
+	int height = 0;
+	int colorChannels = 0;
+
+	// flip the same way as the application does when it loads images
+	stbi_set_flip_vertically_on_load(true);
+	unsigned char* image = stbi_load(filename.c_str(), &width, &height, &colorChannels, 4);
+	if (NULL == image)
+	{
+		std::cout << "Could not load image:" << filename << std::endl;
+		return(false);
+	}
+
+	if (format == FORMAT_AUTO)
+	{
+		format = (colorChannels == 4) ? FORMAT_BC3 : FORMAT_BC1;
+	}
+
+	IMAGE_LEVEL level;
+	level.width = width;
+	level.height = height;
+	level.pixels.assign(image, image + ((size_t)width * height * 4));
+	stbi_image_free(image);
+
+	// compress every level down to one pixel
+	std::vector<unsigned char> data;
+	uint32_t mipLevels = 0;
+	size_t firstLevelSize = 0;
+	while (true)
+	{
+		CompressLevel(level, format, data);
+		if (mipLevels == 0)
+		{
+			firstLevelSize = data.size();
+		}
+		mipLevels++;
+
+		if ((level.width == 1) && (level.height == 1))
+		{
+			break;
+		}
+		level = DownsampleLevel(level);
+	}
+
+	std::string outputName = filename.substr(0, filename.find_last_of('.')) + ".dds";
+	FILE* file = fopen(outputName.c_str(), "wb");
+	if (NULL == file)
+	{
+		std::cout << "Could not write file:" << outputName << std::endl;
+		return(false);
+	}
+
+	// DDS header
+	WriteValue(file, g_DDSMagic);
+	WriteValue(file, 124);
+	WriteValue(file, g_DDSHeaderFlags);
+	WriteValue(file, height);
+	WriteValue(file, width);
+	WriteValue(file, (uint32_t)firstLevelSize);
+	WriteValue(file, 0);
+	WriteValue(file, mipLevels);
+	for (int i = 0; i < 11; i++)
+	{
+		WriteValue(file, 0);
+	}
+	// pixel format
+	WriteValue(file, 32);
+	WriteValue(file, g_DDSPixelFormatFourCC);
+	WriteValue(file, (format == FORMAT_BC3) ? g_FourCCDXT5 : g_FourCCDXT1);
+	for (int i = 0; i < 5; i++)
+	{
+		WriteValue(file, 0);
+	}
+	// capabilities
+	WriteValue(file, g_DDSCaps);
+	for (int i = 0; i < 4; i++)
+	{
+		WriteValue(file, 0);
+	}
+
+	fwrite(&data[0], 1, data.size(), file);
+	fclose(file);
+
+	std::cout << "Wrote " << outputName << ", width:" << width << ", height:" << height
+		<< ", mipmaps:" << mipLevels << ", format:" << ((format == FORMAT_BC3) ? "BC3" : "BC1") << std::endl;
+
+	return(true);
+}
+
+/***********************************************************
+ *  main(int, char*)
+ *
+ *  This function gets called after the tool has been
+ *  launched with the list of images to convert.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	BLOCK_FORMAT format = FORMAT_AUTO;
+	int converted = 0;
+	int failed = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		std::string argument = argv[i];
+
+		if (argument == "--bc1")
+			format = FORMAT_BC1;
+		else if (argument == "--bc3")
+			format = FORMAT_BC3;
+		else if (CompressImage(argument, format))
+			converted++;
+		else
+			failed++;
+	}
+
+	if ((converted == 0) && (failed == 0))
+	{
+		std::cout << "Usage: TextureCompressor [--bc1 | --bc3] image ..." << std::endl;
+		return(EXIT_FAILURE);
+	}
+
+	return((failed == 0) ? EXIT_SUCCESS : EXIT_FAILURE);
+}
@@ -0,0 +1,179 @@
+///////////////////////////////////////////////////////////////////////////////
+// transformbenchmark.cpp
+// ============
+// command line tool - time the model matrix kernels against the glm matrices
+//
+//	Created for CS-330-Computational Graphics and Visualization
+//
+//  Usage: TransformBenchmark [objects] [iterations]
+//
+//  Random transformation values are composed into instance records by the
+//  five glm matrices BuildModelMatrix() used to multiply, and then by every
+//  TransformBatch kernel the CPU runs.  The best time of the iterations is
+//  reported for each, along with the largest difference from the glm
+//  matrices.  Build it together with TransformBatch.cpp and
+//  TransformBatchAvx2.cpp.
+///////////////////////////////////////////////////////////////////////////////
+
+#include "TransformBatch.h"
+
+#include <glm/gtx/transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+// declaration of global variables and defines
+namespace
+{
+	// objects and iterations timed when none are passed in
+	const int g_DefaultObjects = 100000;
+	const int g_DefaultIterations = 50;
+
+	// the values of one object, the same as passed to BuildModelMatrix()
+	struct OBJECT_TRANSFORM
+	{
+		glm::vec3 scale;
+		glm::vec3 rotation;
+		glm::vec3 position;
+	};
+
+	// an instance record with the model matrix first, like the scene instances
+	struct INSTANCE_RECORD
+	{
+		glm::mat4 model;
+		glm::vec2 uvScale;
+		int materialIndex;
+		int padding;
+	};
+}
+
+/***********************************************************
+ *  ComposeWithGlm()
+ *
+ *  This function is used for composing the model matrices
+ *  the way BuildModelMatrix() used to, with five matrices
+ *  and four full multiplies per object.
+ ***********************************************************/
+void ComposeWithGlm(const std::vector<OBJECT_TRANSFORM>& transforms, std::vector<INSTANCE_RECORD>& records)
+{
+	for (int i = 0; i < transforms.size(); i++)
+	{
+		const OBJECT_TRANSFORM& transform = transforms[i];
+		glm::mat4 scale = glm::scale(transform.scale);
+		glm::mat4 rotationX = glm::rotate(glm::radians(transform.rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
+		glm::mat4 rotationY = glm::rotate(glm::radians(transform.rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
+		glm::mat4 rotationZ = glm::rotate(glm::radians(transform.rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
+		glm::mat4 translation = glm::translate(transform.position);
+
+		records[i].model = translation * rotationZ * rotationY * rotationX * scale;
+	}
+}
+
+/***********************************************************
+ *  GetLargestDifference()
+ *
+ *  This function is used for getting the largest difference
+ *  between any two matching elements of the model matrices.
+ ***********************************************************/
+float GetLargestDifference(const std::vector<INSTANCE_RECORD>& a, const std::vector<INSTANCE_RECORD>& b)
+{
+	float difference = 0.0f;
+
+	for (int i = 0; i < a.size(); i++)
+	{
+		for (int column = 0; column < 4; column++)
+		{
+			for (int row = 0; row < 4; row++)
+			{
+				difference = std::max(difference, fabsf(a[i].model[column][row] - b[i].model[column][row]));
+			}
+		}
+	}
+
+	return(difference);
+}
+
+/***********************************************************
+ *  main()
+ *
+ *  This function is used for timing the glm matrices and
+ *  every kernel the CPU runs over the same objects.
+ ***********************************************************/
+int main(int argc, char* argv[])
+{
+	int objects = (argc > 1) ? atoi(argv[1]) : g_DefaultObjects;
+	int iterations = (argc > 2) ? atoi(argv[2]) : g_DefaultIterations;
+	std::mt19937 generator(330);
+	std::uniform_real_distribution<float> scales(0.1f, 4.0f);
+	std::uniform_real_distribution<float> angles(-360.0f, 360.0f);
+	std::uniform_real_distribution<float> positions(-100.0f, 100.0f);
+	std::vector<OBJECT_TRANSFORM> transforms;
+	TransformBatch batch;
+
+	if ((objects <= 0) || (iterations <= 0))
+	{
+		printf("Usage: TransformBenchmark [objects] [iterations]\n");
+		return(1);
+	}
+
+	transforms.resize(objects);
+	batch.Resize(objects);
+	for (int i = 0; i < objects; i++)
+	{
+		OBJECT_TRANSFORM& transform = transforms[i];
+
+		transform.scale = glm::vec3(scales(generator), scales(generator), scales(generator));
+		transform.rotation = glm::vec3(angles(generator), angles(generator), angles(generator));
+		transform.position = glm::vec3(positions(generator), positions(generator), positions(generator));
+		batch.SetTransform(i, transform.scale, transform.rotation.x, transform.rotation.y, transform.rotation.z, transform.position);
+	}
+
+	std::vector<INSTANCE_RECORD> expected(objects);
+	std::vector<INSTANCE_RECORD> records(objects);
+
+	printf("Composing %d model matrices, best of %d iterations\n", objects, iterations);
+
+	// the glm matrices first, which every kernel is compared with
+	double glmTime = 1.0e30;
+	for (int iteration = 0; iteration < iterations; iteration++)
+	{
+		std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+		ComposeWithGlm(transforms, expected);
+		std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+		glmTime = std::min(glmTime, elapsed.count());
+	}
+	printf("%-8s %9.3f ms %7.2f ns per object\n", "glm", glmTime, (glmTime * 1.0e6) / objects);
+
+	for (int kernel = 0; kernel < TransformBatch::KERNEL_COUNT; kernel++)
+	{
+		TransformBatch::KERNEL_TYPE kernelType = (TransformBatch::KERNEL_TYPE)kernel;
+		double kernelTime = 1.0e30;
+
+		if (!TransformBatch::IsKernelSupported(kernelType))
+		{
+			continue;
+		}
+
+		for (int iteration = 0; iteration < iterations; iteration++)
+		{
+			std::chrono::high_resolution_clock::time_point start = std::chrono::high_resolution_clock::now();
+			batch.Compose(0, objects, records.data(), sizeof(INSTANCE_RECORD), NULL, kernelType);
+			std::chrono::duration<double, std::milli> elapsed = std::chrono::high_resolution_clock::now() - start;
+			kernelTime = std::min(kernelTime, elapsed.count());
+		}
+
+		printf("%-8s %9.3f ms %7.2f ns per object %6.2fx  largest difference %g\n",
+			TransformBatch::GetKernelName(kernelType),
+			kernelTime,
+			(kernelTime * 1.0e6) / objects,
+			glmTime / kernelTime,
+			GetLargestDifference(expected, records));
+	}
+
+	return(0);
+}